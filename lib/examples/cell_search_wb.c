@@ -0,0 +1,249 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srslte/srslte.h"
+
+#include "srslte/common/crash_handler.h"
+
+#ifndef DISABLE_RF
+#include "srslte/phy/rf/rf.h"
+#endif
+
+#define MHZ 1000000
+#define MAX_EARFCN 1000
+
+int    band         = -1;
+int    earfcn_start = -1, earfcn_end = -1;
+double center_freq  = 0;
+double srate        = 15.36e6;
+int    capture_ms   = 40;
+int    nof_threads  = 2;
+char*  input_file   = NULL;
+float  rf_gain      = 70.0;
+char*  rf_dev       = "";
+char*  rf_args      = "";
+
+void usage(char* prog)
+{
+  printf("Usage: %s [adgilnrsev] -b band -f center_freq\n", prog);
+  printf("\t-i input file (complex float samples) [Default use RF]\n");
+#ifndef DISABLE_RF
+  printf("\t-d RF device [Default %s]\n", strlen(rf_dev) ? rf_dev : "auto");
+  printf("\t-a RF args [Default %s]\n", rf_args);
+  printf("\t-g RF gain [Default %.2f dB]\n", rf_gain);
+#endif
+  printf("\t-r capture sampling rate, a multiple of 1.92 MHz [Default %.2f MHz]\n", srate / MHZ);
+  printf("\t-l capture length [Default %d ms]\n", capture_ms);
+  printf("\t-n number of search threads [Default %d]\n", nof_threads);
+  printf("\t-s earfcn_start [Default All]\n");
+  printf("\t-e earfcn_end [Default All]\n");
+  printf("\t-v [set srslte_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "adgilnrsebfv")) != -1) {
+    switch (opt) {
+      case 'i':
+        input_file = argv[optind];
+        break;
+      case 'd':
+        rf_dev = argv[optind];
+        break;
+      case 'a':
+        rf_args = argv[optind];
+        break;
+      case 'g':
+        rf_gain = strtof(argv[optind], NULL);
+        break;
+      case 'r':
+        srate = strtod(argv[optind], NULL);
+        break;
+      case 'l':
+        capture_ms = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_threads = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        earfcn_start = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'e':
+        earfcn_end = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'b':
+        band = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'f':
+        center_freq = strtod(argv[optind], NULL);
+        break;
+      case 'v':
+        srslte_verbose++;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (band == -1 || center_freq == 0 || capture_ms <= 0 || nof_threads <= 0) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+static int capture(cf_t* buffer, uint32_t nof_samples)
+{
+  if (input_file) {
+    srslte_filesource_t fsrc;
+    if (srslte_filesource_init(&fsrc, input_file, SRSLTE_COMPLEX_FLOAT_BIN)) {
+      ERROR("Error opening file %s\n", input_file);
+      return SRSLTE_ERROR;
+    }
+    int n = srslte_filesource_read(&fsrc, buffer, nof_samples);
+    srslte_filesource_free(&fsrc);
+    if (n < (int)nof_samples) {
+      ERROR("File %s has %d samples, %d are needed\n", input_file, n, nof_samples);
+      return SRSLTE_ERROR;
+    }
+    return SRSLTE_SUCCESS;
+  }
+
+#ifndef DISABLE_RF
+  srslte_rf_t rf;
+  printf("Opening RF device...\n");
+  if (srslte_rf_open_devname(&rf, rf_dev, rf_args, 1)) {
+    ERROR("Error opening rf\n");
+    return SRSLTE_ERROR;
+  }
+  srslte_rf_set_rx_gain(&rf, rf_gain);
+  srslte_rf_set_rx_srate(&rf, srate);
+  srslte_rf_set_rx_freq(&rf, 0, center_freq);
+  srslte_rf_start_rx_stream(&rf, false);
+
+  int      ret = SRSLTE_SUCCESS;
+  uint32_t n   = 0;
+  while (n < nof_samples) {
+    int r = srslte_rf_recv(&rf, &buffer[n], nof_samples - n, true);
+    if (r <= 0) {
+      ERROR("Error receiving samples\n");
+      ret = SRSLTE_ERROR;
+      break;
+    }
+    n += r;
+  }
+  srslte_rf_stop_rx_stream(&rf);
+  srslte_rf_close(&rf);
+  return ret;
+#else
+  ERROR("Compiled without RF support, use -i\n");
+  return SRSLTE_ERROR;
+#endif
+}
+
+int main(int argc, char** argv)
+{
+  srslte_ue_cellsearch_wb_t        cs;
+  srslte_earfcn_t                  channels[MAX_EARFCN];
+  double                           offset[MAX_EARFCN];
+  int                              earfcn[MAX_EARFCN];
+  srslte_ue_cellsearch_wb_result_t found_cells[3 * MAX_EARFCN];
+  uint32_t                         nof_channels = 0;
+
+  srslte_debug_handle_crash(argc, argv);
+
+  parse_args(argc, argv);
+
+  // Keep the carriers whose 1.08 MHz synchronization band fits in the capture
+  int nof_freqs = srslte_band_get_fd_band(band, channels, earfcn_start, earfcn_end, MAX_EARFCN);
+  if (nof_freqs < 0) {
+    ERROR("Error getting EARFCN list\n");
+    exit(-1);
+  }
+  for (int i = 0; i < nof_freqs; i++) {
+    double f = channels[i].fd * MHZ - center_freq;
+    if (fabs(f) + 0.75e6 <= srate / 2) {
+      earfcn[nof_channels] = channels[i].id;
+      offset[nof_channels] = f;
+      nof_channels++;
+    }
+  }
+  if (nof_channels == 0) {
+    ERROR("No EARFCN of band %d within %.2f MHz of %.2f MHz\n", band, srate / 2 / MHZ, center_freq / MHZ);
+    exit(-1);
+  }
+
+  uint32_t nof_samples = (uint32_t)(srate / 1000) * capture_ms;
+  cf_t*    buffer      = srslte_vec_cf_malloc(nof_samples);
+  if (!buffer) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  if (srslte_ue_cellsearch_wb_init(&cs, srate, offset, nof_channels, nof_samples, nof_threads)) {
+    ERROR("Error initiating wideband cell search\n");
+    exit(-1);
+  }
+
+  if (capture(buffer, nof_samples)) {
+    exit(-1);
+  }
+
+  printf("Searching %d EARFCNs in %d ms at %.2f MHz with %d threads...\n",
+         nof_channels,
+         capture_ms,
+         center_freq / MHZ,
+         nof_threads);
+
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  int n = srslte_ue_cellsearch_wb_scan(&cs, buffer, nof_samples, found_cells, 3 * MAX_EARFCN);
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  if (n < 0) {
+    ERROR("Error searching cells\n");
+    exit(-1);
+  }
+
+  for (int i = 0; i < n; i++) {
+    srslte_ue_cellsearch_wb_result_t* r = &found_cells[i];
+    printf("Found CELL EARFCN=%d, %.1f MHz, PHYID=%d, %s CP, PSR=%.1f, peak=%.1f dB\n",
+           earfcn[r->channel],
+           (center_freq + offset[r->channel]) / MHZ,
+           r->cell.cell_id,
+           srslte_cp_string(r->cell.cp),
+           r->cell.psr,
+           srslte_convert_power_to_dB(r->cell.peak));
+  }
+  printf("Found %d cells in %.1f ms\n", n, t[0].tv_sec * 1e3 + t[0].tv_usec / 1e3);
+
+  srslte_ue_cellsearch_wb_free(&cs);
+  free(buffer);
+
+  exit(0);
+}
@@ -28,10 +28,12 @@
 #include <cstring>
 #include <limits>
 #include <map>
+#include <new>
 #include <sstream>
 #include <stdarg.h> /* va_list, va_start, va_arg, va_end */
 #include <stdint.h>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace asn1 {
@@ -136,6 +138,125 @@ public:
   SRSASN_CODE align_bytes_zero();
 };
 
+/************************
+    arena allocation
+************************/
+
+/**
+ * Monotonic allocator for decoded message trees. Allocations are carved out of large blocks and are never freed
+ * individually, reset() releases all of them at once and keeps the blocks for the next message.
+ * The arena must outlive every object allocated from it.
+ */
+class arena
+{
+public:
+  explicit arena(uint32_t block_size_ = ASN_16K) : block_size(block_size_) {}
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+  ~arena();
+
+  void*    allocate(size_t sz, size_t align);
+  void     reset();
+  size_t   nof_bytes_used() const { return bytes_used; }
+  uint32_t nof_blocks() const { return blocks.size(); }
+
+private:
+  struct block_t {
+    uint8_t* data;
+    size_t   size;
+  };
+  const uint32_t       block_size;
+  std::vector<block_t> blocks;
+  uint32_t             block_idx  = 0;
+  size_t               block_pos  = 0;
+  size_t               bytes_used = 0;
+};
+
+//! Arena that dyn_array, ext_array and copy_ptr allocations of the calling thread are taken from, or nullptr
+arena* get_thread_arena();
+
+/**
+ * Binds an arena to the calling thread for the lifetime of this object, e.g. around a PDU unpack. Copies made after
+ * the scope ends go back to the heap.
+ */
+class arena_scope
+{
+public:
+  explicit arena_scope(arena& a);
+  arena_scope(const arena_scope&) = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+  ~arena_scope();
+
+private:
+  arena* prev_arena;
+};
+
+namespace detail {
+
+// Every allocation carries a header saying if it came from an arena, so the release path does not depend on the
+// arena still being bound
+struct alloc_header_t {
+  arena*   owner;
+  uint32_t count;
+};
+
+template <class T>
+struct alloc_layout {
+  static const size_t align  = alignof(T) > alignof(alloc_header_t) ? alignof(T) : alignof(alloc_header_t);
+  static const size_t offset = ceil_frac(sizeof(alloc_header_t), align) * align;
+};
+
+template <class T>
+T* alloc_raw(uint32_t count)
+{
+  arena*   a     = get_thread_arena();
+  size_t   bytes = alloc_layout<T>::offset + (size_t)count * sizeof(T);
+  uint8_t* mem   = static_cast<uint8_t*>(a != nullptr ? a->allocate(bytes, alloc_layout<T>::align)
+                                                    : ::operator new(bytes));
+  new (mem) alloc_header_t{a, count};
+  return reinterpret_cast<T*>(mem + alloc_layout<T>::offset);
+}
+
+//! Replacement for new T[count]
+template <class T>
+T* new_array(uint32_t count)
+{
+  T* ptr = alloc_raw<T>(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    new (&ptr[i]) T;
+  }
+  return ptr;
+}
+
+//! Replacement for new T(args...)
+template <class T, class... Args>
+T* new_object(Args&&... args)
+{
+  T* ptr = alloc_raw<T>(1);
+  new (ptr) T(std::forward<Args>(args)...);
+  return ptr;
+}
+
+//! Replacement for delete/delete[] of pointers returned by new_array/new_object. Arena memory is not released here
+template <class T>
+void delete_array(T* ptr)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+  auto* hdr = reinterpret_cast<alloc_header_t*>(reinterpret_cast<uint8_t*>(ptr) - alloc_layout<T>::offset);
+  if (not std::is_trivially_destructible<T>::value) {
+    for (uint32_t i = 0; i < hdr->count; ++i) {
+      ptr[i].~T();
+    }
+  }
+  if (hdr->owner == nullptr) {
+    ::operator delete(hdr);
+  }
+}
+
+} // namespace detail
+
 /*********************
   function helpers
 *********************/
@@ -148,21 +269,16 @@ public:
   using const_iterator = const T*;
 
   dyn_array() = default;
-  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = new T[size_]; }
+  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = detail::new_array<T>(size_); }
   dyn_array(const dyn_array<T>& other) : dyn_array(&other[0], other.size_) {}
   dyn_array(const T* ptr, uint32_t nof_items)
   {
     size_ = nof_items;
     cap_  = nof_items;
-    data_ = new T[cap_];
+    data_ = detail::new_array<T>(cap_);
     std::copy(ptr, ptr + size_, data_);
   }
-  ~dyn_array()
-  {
-    if (data_ != NULL) {
-      delete[] data_;
-    }
-  }
+  ~dyn_array() { detail::delete_array(data_); }
   uint32_t      size() const { return size_; }
   uint32_t      capacity() const { return cap_; }
   T&            operator[](uint32_t idx) { return data_[idx]; }
@@ -188,7 +304,7 @@ public:
     T* old_data = data_;
     cap_        = new_size > new_cap ? new_size : new_cap;
     if (cap_ > 0) {
-      data_ = new T[cap_];
+      data_ = detail::new_array<T>(cap_);
       if (old_data != NULL) {
         std::copy(&old_data[0], &old_data[size_], data_);
       }
@@ -196,9 +312,7 @@ public:
       data_ = NULL;
     }
     size_ = new_size;
-    if (old_data != NULL) {
-      delete[] old_data;
-    }
+    detail::delete_array(old_data);
   }
   bool operator==(const dyn_array<T>& other) const
   {
@@ -297,7 +411,7 @@ public:
   ~ext_array()
   {
     if (not is_in_small_buffer()) {
-      delete[] head;
+      detail::delete_array(head);
     }
   }
   ext_array<T, Nthres>& operator=(const ext_array<T, Nthres>& other)
@@ -337,11 +451,11 @@ public:
     }
     T*       old_data = head;
     uint32_t newcap   = new_size + 5;
-    head              = new T[newcap];
-    std::copy(&small_buffer.data[0], &small_buffer.data[size_], head);
+    head              = detail::new_array<T>(newcap);
+    std::copy(&old_data[0], &old_data[size_], head);
     size_ = new_size;
     if (old_data != &small_buffer.data[0]) {
-      delete[] old_data;
+      detail::delete_array(old_data);
     }
     small_buffer.cap_ = newcap;
   }
@@ -642,9 +756,7 @@ SRSASN_CODE fixed_octstring<N, aligned>::pack(bit_ref& bref) const
   if (aligned and N > 2) {
     bref.align_bytes_zero();
   }
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.pack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.pack_bytes(octets_.data(), size()));
   return SRSASN_SUCCESS;
 }
 
@@ -654,9 +766,7 @@ SRSASN_CODE fixed_octstring<N, aligned>::unpack(cbit_ref& bref)
   if (aligned and N > 2) {
     bref.align_bytes();
   }
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.unpack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.unpack_bytes(octets_.data(), size()));
   return SRSASN_SUCCESS;
 }
 
@@ -1016,14 +1126,14 @@ class copy_ptr
 {
 public:
   explicit copy_ptr(T* ptr_ = nullptr) :
-    ptr(ptr_) {} // it takes hold of the pointer (including destruction). You should use make_copy_ptr() in most cases
-  // instead of this ctor
-  copy_ptr(const copy_ptr<T>& other) { ptr = (other.ptr == nullptr) ? nullptr : new T(*other.ptr); }
+    ptr(ptr_) {} // it takes hold of a pointer returned by release() (including destruction). You should use
+  // make_copy_ptr() in most cases instead of this ctor
+  copy_ptr(const copy_ptr<T>& other) { ptr = (other.ptr == nullptr) ? nullptr : detail::new_object<T>(*other.ptr); }
   ~copy_ptr() { destroy_(); }
   copy_ptr<T>& operator=(const copy_ptr<T>& other)
   {
     if (this != &other) {
-      reset((other.ptr == nullptr) ? nullptr : new T(*other.ptr));
+      reset((other.ptr == nullptr) ? nullptr : detail::new_object<T>(*other.ptr));
     }
     return *this;
   }
@@ -1048,7 +1158,7 @@ public:
   void set_present(bool flag = true)
   {
     if (flag) {
-      reset(new T());
+      reset(detail::new_object<T>());
     } else {
       reset();
     }
@@ -1056,19 +1166,14 @@ public:
   bool is_present() const { return get() != nullptr; }
 
 private:
-  void destroy_()
-  {
-    if (ptr != NULL) {
-      delete ptr;
-    }
-  }
+  void destroy_() { detail::delete_array(ptr); }
   T* ptr;
 };
 
 template <class T>
 copy_ptr<T> make_copy_ptr(const T& t)
 {
-  return copy_ptr<T>(new T(t));
+  return copy_ptr<T>(detail::new_object<T>(t));
 }
 
 /*********************
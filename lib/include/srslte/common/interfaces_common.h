@@ -58,6 +58,7 @@ typedef struct {
   std::string device_args;
   std::string time_adv_nsamples;
   std::string continuous_tx;
+  float       srate_hz; // Front-end sampling rate, scaled by powers of two and resampled to the PHY rate (0 disables)
 
   std::array<rf_args_band_t, SRSLTE_MAX_CARRIERS> ch_rx_bands;
   std::array<rf_args_band_t, SRSLTE_MAX_CARRIERS> ch_tx_bands;
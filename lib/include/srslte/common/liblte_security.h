@@ -282,6 +282,69 @@ LIBLTE_ERROR_ENUM liblte_security_decryption_eea3(uint8* key,
                                                   uint32 msg_len,
                                                   uint8* out);
 
+/*********************************************************************
+    Name: liblte_security_aes_key_alloc
+
+    Description: Expands an AES-128 key once, together with its CMAC
+                 subkeys, so EEA2 and EIA2 do not redo the key
+                 schedule for every PDU.
+
+    Document Reference: 33.401 v13.1.0 Annex B.1.3 and B.2.3
+                        RFC4493
+*********************************************************************/
+// Defines
+#define LIBLTE_SECURITY_MAX_LANES 8
+// Enums
+// Structs
+typedef struct LIBLTE_SECURITY_AES_KEY_STRUCT LIBLTE_SECURITY_AES_KEY_STRUCT;
+// Functions
+LIBLTE_SECURITY_AES_KEY_STRUCT* liblte_security_aes_key_alloc(uint8* key);
+void                            liblte_security_aes_key_free(LIBLTE_SECURITY_AES_KEY_STRUCT* aes_key);
+
+/*********************************************************************
+    Name: liblte_security_encryption_eea2_multi
+
+    Description: 128-bit encryption algorithm EEA2 on a batch of
+                 messages with cached key schedules. The keystream
+                 blocks of all messages are generated
+                 LIBLTE_SECURITY_MAX_LANES at a time. msg_len is in
+                 bits.
+
+    Document Reference: 33.401 v13.1.0 Annex B.1.3
+*********************************************************************/
+// Defines
+// Enums
+// Structs
+typedef struct {
+  LIBLTE_SECURITY_AES_KEY_STRUCT* key;
+  uint32                          count;
+  uint8                           bearer;
+  uint8                           direction;
+  uint8*                          msg;
+  uint32                          msg_len;
+  uint8*                          out;
+} LIBLTE_SECURITY_PDU_STRUCT;
+// Functions
+LIBLTE_ERROR_ENUM liblte_security_encryption_eea2_multi(LIBLTE_SECURITY_PDU_STRUCT* pdus, uint32 nof_pdus);
+
+/*********************************************************************
+    Name: liblte_security_128_eia2_multi
+
+    Description: 128-bit integrity algorithm EIA2 on a batch of
+                 messages with cached key schedules. The CMAC chains
+                 of up to LIBLTE_SECURITY_MAX_LANES messages are
+                 computed at the same time. msg_len is in bytes and
+                 the 4 byte MAC is written in out.
+
+    Document Reference: 33.401 v10.0.0 Annex B.2.3
+                        RFC4493
+*********************************************************************/
+// Defines
+// Enums
+// Structs
+// Functions
+LIBLTE_ERROR_ENUM liblte_security_128_eia2_multi(LIBLTE_SECURITY_PDU_STRUCT* pdus, uint32 nof_pdus);
+
 /*********************************************************************
     Name: liblte_security_milenage_f1
 
@@ -347,4 +410,33 @@ liblte_security_milenage_f2345(uint8* k, uint8* op, uint8* rand, uint8* res, uin
 // Functions
 LIBLTE_ERROR_ENUM liblte_security_milenage_f5_star(uint8* k, uint8* op, uint8* rand, uint8* ak);
 
+/*********************************************************************
+    Name: liblte_security_milenage_multi
+
+    Description: Milenage security functions F1, F2, F3, F4 and F5
+                 on a batch of authentication vectors with cached
+                 key schedules. The five AES blocks of each vector
+                 are computed LIBLTE_SECURITY_MAX_LANES vectors at a
+                 time.
+
+    Document Reference: 35.206 v10.0.0 Annex 3
+*********************************************************************/
+// Defines
+// Enums
+// Structs
+typedef struct {
+  LIBLTE_SECURITY_AES_KEY_STRUCT* key;
+  uint8*                          op_c;
+  uint8*                          rand;
+  uint8*                          sqn;
+  uint8*                          amf;
+  uint8*                          mac_a;
+  uint8*                          res;
+  uint8*                          ck;
+  uint8*                          ik;
+  uint8*                          ak;
+} LIBLTE_SECURITY_MILENAGE_STRUCT;
+// Functions
+LIBLTE_ERROR_ENUM liblte_security_milenage_multi(LIBLTE_SECURITY_MILENAGE_STRUCT* vecs, uint32 nof_vecs);
+
 #endif // SRSLTE_LIBLTE_SECURITY_H
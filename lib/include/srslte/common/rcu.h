@@ -0,0 +1,91 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_RCU_H
+#define SRSLTE_RCU_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace srslte {
+
+/**
+ * Epoch-based read-copy-update.
+ * Readers wrap their accesses to RCU-protected data in a read-side critical section, which only publishes the current
+ * global epoch in a slot owned by the calling thread, so readers never block nor write to shared cache lines.
+ * Writers publish new versions of the data with atomic pointer stores and hand the versions they unlinked to an
+ * rcu_reclaimer, which deletes them once every reader that could still reference them has left its critical section.
+ * Critical sections may be nested, and must not wait for writers.
+ */
+void rcu_read_lock();
+void rcu_read_unlock();
+
+class rcu_read_guard
+{
+public:
+  rcu_read_guard() { rcu_read_lock(); }
+  rcu_read_guard(const rcu_read_guard&) = delete;
+  rcu_read_guard(rcu_read_guard&&)      = delete;
+  rcu_read_guard& operator=(const rcu_read_guard&) = delete;
+  rcu_read_guard& operator=(rcu_read_guard&&) = delete;
+  ~rcu_read_guard() { rcu_read_unlock(); }
+};
+
+class rcu_reclaimer
+{
+public:
+  rcu_reclaimer() = default;
+  rcu_reclaimer(const rcu_reclaimer&) = delete;
+  rcu_reclaimer& operator=(const rcu_reclaimer&) = delete;
+  ~rcu_reclaimer() { synchronize(); }
+
+  /// Defers the deletion of an object that is no longer reachable by new readers
+  template <typename T>
+  void retire(T* ptr)
+  {
+    retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+  }
+  void retire(void* ptr, void (*deleter)(void*));
+
+  /// Deletes the retired objects no reader can reference anymore. Returns the number of objects still pending
+  size_t reclaim();
+
+  /// Waits for the readers to leave and deletes all the retired objects. Must be called outside critical sections
+  void synchronize();
+
+  size_t nof_pending() const;
+
+private:
+  struct retired_t {
+    void* ptr;
+    void (*deleter)(void*);
+    uint64_t epoch;
+  };
+
+  mutable std::mutex     mutex;
+  std::vector<retired_t> retired;
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_RCU_H
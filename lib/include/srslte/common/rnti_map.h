@@ -0,0 +1,346 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_RNTI_MAP_H
+#define SRSLTE_RNTI_MAP_H
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace srslte {
+
+/**
+ * Associative container for per-UE state indexed by RNTI.
+ * The RNTIs are kept in an open-addressing hash table with linear probing, indexed directly by the RNTI least
+ * significant bits, as the RNTIs are allocated mostly sequentially. The elements live in a slab of fixed-size chunks,
+ * so their addresses remain stable across insertions, erasures and rehashes.
+ * The interface follows std::map, with the following differences:
+ * - the iteration order is unspecified
+ * - insertions may invalidate iterators, but never pointers or references to the elements
+ * - erasures only invalidate the iterators to the erased elements
+ */
+template <typename T>
+class rnti_map
+{
+public:
+  using key_type    = uint16_t;
+  using mapped_type = T;
+  using value_type  = std::pair<const uint16_t, T>;
+  using size_type   = size_t;
+
+private:
+  static const uint32_t empty_key    = 0x10000u;
+  static const uint32_t deleted_key  = 0x10001u;
+  static const size_t   min_capacity = 16;
+  static const size_t   chunk_size   = 64;
+
+  using node_storage_t = typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type;
+
+  template <bool Const>
+  class iter_impl
+  {
+    using map_t = typename std::conditional<Const, const rnti_map<T>, rnti_map<T> >::type;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = typename std::conditional<Const, const rnti_map::value_type, rnti_map::value_type>::type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = value_type*;
+    using reference         = value_type&;
+
+    iter_impl() = default;
+    iter_impl(map_t* map_, size_t idx_) : map(map_), idx(idx_) { skip_free_slots(); }
+    template <bool C = Const, typename std::enable_if<C, int>::type = 0>
+    iter_impl(const iter_impl<false>& other) : map(other.map), idx(other.idx)
+    {
+    }
+
+    reference operator*() const { return *map->nodes[idx]; }
+    pointer   operator->() const { return map->nodes[idx]; }
+
+    iter_impl& operator++()
+    {
+      ++idx;
+      skip_free_slots();
+      return *this;
+    }
+    iter_impl operator++(int)
+    {
+      iter_impl prev = *this;
+      ++(*this);
+      return prev;
+    }
+
+    bool operator==(const iter_impl& other) const { return idx == other.idx and map == other.map; }
+    bool operator!=(const iter_impl& other) const { return not(*this == other); }
+
+  private:
+    friend class rnti_map<T>;
+    template <bool>
+    friend class iter_impl;
+
+    void skip_free_slots()
+    {
+      while (idx < map->keys.size() and map->keys[idx] >= empty_key) {
+        ++idx;
+      }
+    }
+
+    map_t* map = nullptr;
+    size_t idx = 0;
+  };
+
+public:
+  using iterator       = iter_impl<false>;
+  using const_iterator = iter_impl<true>;
+
+  rnti_map()                = default;
+  rnti_map(const rnti_map&) = delete;
+  rnti_map(rnti_map&& other) noexcept { *this = std::move(other); }
+  rnti_map& operator=(const rnti_map&) = delete;
+  rnti_map& operator=(rnti_map&& other) noexcept
+  {
+    clear();
+    keys.swap(other.keys);
+    nodes.swap(other.nodes);
+    chunks.swap(other.chunks);
+    free_nodes.swap(other.free_nodes);
+    std::swap(nof_elems, other.nof_elems);
+    std::swap(nof_deleted, other.nof_deleted);
+    return *this;
+  }
+  ~rnti_map() { clear(); }
+
+  iterator       begin() { return iterator{this, 0}; }
+  iterator       end() { return iterator{this, keys.size()}; }
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, keys.size()}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  size_t size() const { return nof_elems; }
+  bool   empty() const { return nof_elems == 0; }
+  size_t capacity() const { return keys.size(); }
+
+  iterator       find(uint16_t rnti) { return iterator{this, find_slot(rnti)}; }
+  const_iterator find(uint16_t rnti) const { return const_iterator{this, find_slot(rnti)}; }
+  size_t         count(uint16_t rnti) const { return find_slot(rnti) < keys.size() ? 1 : 0; }
+
+  T& at(uint16_t rnti)
+  {
+    size_t idx = find_slot(rnti);
+    if (idx >= keys.size()) {
+      throw std::out_of_range("rnti_map::at");
+    }
+    return nodes[idx]->second;
+  }
+  const T& at(uint16_t rnti) const
+  {
+    size_t idx = find_slot(rnti);
+    if (idx >= keys.size()) {
+      throw std::out_of_range("rnti_map::at");
+    }
+    return nodes[idx]->second;
+  }
+
+  T& operator[](uint16_t rnti) { return emplace(rnti).first->second; }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(uint16_t rnti, Args&&... args)
+  {
+    size_t idx = find_slot(rnti);
+    if (idx < keys.size()) {
+      return std::make_pair(iterator{this, idx}, false);
+    }
+    value_type* node = alloc_node();
+    new (node) value_type(std::piecewise_construct, std::forward_as_tuple(rnti), std::forward_as_tuple(std::forward<Args>(args)...));
+    idx        = insert_slot(rnti);
+    nodes[idx] = node;
+    nof_elems++;
+    return std::make_pair(iterator{this, idx}, true);
+  }
+
+  template <typename Pair>
+  std::pair<iterator, bool> insert(Pair&& p)
+  {
+    return emplace(p.first, std::forward<Pair>(p).second);
+  }
+
+  size_t erase(uint16_t rnti)
+  {
+    size_t idx = find_slot(rnti);
+    if (idx >= keys.size()) {
+      return 0;
+    }
+    erase_slot(idx);
+    return 1;
+  }
+  iterator erase(const_iterator it)
+  {
+    erase_slot(it.idx);
+    return iterator{this, it.idx + 1};
+  }
+  iterator erase(iterator it) { return erase(const_iterator{it}); }
+
+  void clear()
+  {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i] < empty_key) {
+        free_node(nodes[i]);
+      }
+      keys[i]  = empty_key;
+      nodes[i] = nullptr;
+    }
+    nof_elems   = 0;
+    nof_deleted = 0;
+  }
+
+  /// Preallocate table and element storage for the given number of UEs
+  void reserve(size_t nof_ues)
+  {
+    if ((nof_ues + nof_deleted) * 4 > capacity() * 3) {
+      rehash(nof_ues);
+    }
+    while (free_nodes.size() + nof_elems < nof_ues) {
+      alloc_chunk();
+    }
+  }
+
+private:
+  size_t mask() const { return keys.size() - 1; }
+
+  size_t find_slot(uint16_t rnti) const
+  {
+    if (keys.empty()) {
+      return 0;
+    }
+    for (size_t idx = rnti & mask();; idx = (idx + 1) & mask()) {
+      if (keys[idx] == rnti) {
+        return idx;
+      }
+      if (keys[idx] == empty_key) {
+        return keys.size();
+      }
+    }
+  }
+
+  // Assumes the RNTI is not present in the table
+  size_t insert_slot(uint16_t rnti)
+  {
+    if ((nof_elems + nof_deleted + 1) * 4 > capacity() * 3) {
+      rehash(nof_elems + 1);
+    }
+    size_t idx = rnti & mask();
+    while (keys[idx] < empty_key) {
+      idx = (idx + 1) & mask();
+    }
+    if (keys[idx] == deleted_key) {
+      nof_deleted--;
+    }
+    keys[idx] = rnti;
+    return idx;
+  }
+
+  void erase_slot(size_t idx)
+  {
+    free_node(nodes[idx]);
+    nodes[idx] = nullptr;
+    // An erased slot only becomes empty if it does not break a probing sequence
+    if (keys[(idx + 1) & mask()] == empty_key) {
+      keys[idx] = empty_key;
+    } else {
+      keys[idx] = deleted_key;
+      nof_deleted++;
+    }
+    nof_elems--;
+  }
+
+  // Resize the table to hold at least nof_ues with a load factor <= 0.5, dropping all deleted slots
+  void rehash(size_t nof_ues)
+  {
+    size_t new_cap = min_capacity;
+    while (new_cap < 2 * nof_ues) {
+      new_cap *= 2;
+    }
+    std::vector<uint32_t>    old_keys(new_cap, empty_key);
+    std::vector<value_type*> old_nodes(new_cap, nullptr);
+    keys.swap(old_keys);
+    nodes.swap(old_nodes);
+    nof_deleted = 0;
+    for (size_t i = 0; i < old_keys.size(); ++i) {
+      if (old_keys[i] < empty_key) {
+        size_t idx = old_keys[i] & mask();
+        while (keys[idx] != empty_key) {
+          idx = (idx + 1) & mask();
+        }
+        keys[idx]  = old_keys[i];
+        nodes[idx] = old_nodes[i];
+      }
+    }
+  }
+
+  void alloc_chunk()
+  {
+    chunks.emplace_back(new node_storage_t[chunk_size]);
+    node_storage_t* chunk = chunks.back().get();
+    for (size_t i = chunk_size; i > 0; --i) {
+      free_nodes.push_back(reinterpret_cast<value_type*>(&chunk[i - 1]));
+    }
+  }
+
+  value_type* alloc_node()
+  {
+    if (free_nodes.empty()) {
+      alloc_chunk();
+    }
+    value_type* node = free_nodes.back();
+    free_nodes.pop_back();
+    return node;
+  }
+
+  void free_node(value_type* node)
+  {
+    node->~value_type();
+    free_nodes.push_back(node);
+  }
+
+  std::vector<uint32_t>                           keys;
+  std::vector<value_type*>                        nodes;
+  std::vector<std::unique_ptr<node_storage_t[]> > chunks;
+  std::vector<value_type*>                        free_nodes;
+  size_t                                          nof_elems   = 0;
+  size_t                                          nof_deleted = 0;
+};
+
+template <typename T>
+const uint32_t rnti_map<T>::empty_key;
+template <typename T>
+const uint32_t rnti_map<T>::deleted_key;
+
+} // namespace srslte
+
+#endif // SRSLTE_RNTI_MAP_H
@@ -27,6 +27,9 @@
  *****************************************************************************/
 
 #include "srslte/common/common.h"
+#include <array>
+
+struct LIBLTE_SECURITY_AES_KEY_STRUCT;
 
 namespace srslte {
 
@@ -162,6 +165,57 @@ uint8_t security_128_eea3(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+/******************************************************************************
+ * Cached AES key schedules and multi-buffer EEA2/EIA2
+ *****************************************************************************/
+// AES-128 key expanded once, with its CMAC subkeys. Not copyable, it owns the expanded key.
+class security_aes_key
+{
+public:
+  security_aes_key() = default;
+  ~security_aes_key();
+  security_aes_key(const security_aes_key&) = delete;
+  security_aes_key& operator=(const security_aes_key&) = delete;
+
+  void                            set_key(uint8_t* key);
+  void                            reset();
+  bool                            is_set() const { return aes_key != nullptr; }
+  LIBLTE_SECURITY_AES_KEY_STRUCT* get() const { return aes_key; }
+
+private:
+  LIBLTE_SECURITY_AES_KEY_STRUCT* aes_key = nullptr;
+};
+
+struct security_pdu_t {
+  const security_aes_key* key;
+  uint32_t                count;
+  uint8_t                 bearer;
+  uint8_t                 direction;
+  uint8_t*                msg;
+  uint32_t                msg_len; ///< Message length in bytes
+  uint8_t*                out;     ///< Ciphered message or 4 byte MAC
+};
+
+uint8_t security_128_eia2(const security_aes_key& key,
+                          uint32_t                count,
+                          uint32_t                bearer,
+                          uint8_t                 direction,
+                          uint8_t*                msg,
+                          uint32_t                msg_len,
+                          uint8_t*                mac);
+
+uint8_t security_128_eea2(const security_aes_key& key,
+                          uint32_t                count,
+                          uint8_t                 bearer,
+                          uint8_t                 direction,
+                          uint8_t*                msg,
+                          uint32_t                msg_len,
+                          uint8_t*                msg_out);
+
+uint8_t security_128_eia2_multi(security_pdu_t* pdus, uint32_t nof_pdus);
+
+uint8_t security_128_eea2_multi(security_pdu_t* pdus, uint32_t nof_pdus);
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
@@ -176,5 +230,20 @@ security_milenage_f2345(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_t* res, ui
 
 uint8_t security_milenage_f5_star(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_t* ak);
 
+struct security_milenage_t {
+  const security_aes_key* key; ///< Schedule of K
+  uint8_t*                opc;
+  uint8_t*                rand;
+  uint8_t*                sqn;
+  uint8_t*                amf;
+  uint8_t*                mac_a; ///< 8 bytes
+  uint8_t*                res;   ///< 8 bytes
+  uint8_t*                ck;
+  uint8_t*                ik;
+  uint8_t*                ak; ///< 6 bytes
+};
+
+uint8_t security_milenage_multi(security_milenage_t* vecs, uint32_t nof_vecs);
+
 } // namespace srslte
 #endif // SRSLTE_SECURITY_H
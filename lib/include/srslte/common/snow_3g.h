@@ -21,6 +21,41 @@ typedef unsigned char      u8;
 typedef unsigned int       u32;
 typedef unsigned long long u64;
 
+/* SNOW 3G state, owned by the caller so the algorithm is reentrant.
+ * LFSR registers S0 to S15 and FSM registers R1 to R3.
+ * See section 3.
+ */
+typedef struct {
+  u32 LFSR_S0;
+  u32 LFSR_S1;
+  u32 LFSR_S2;
+  u32 LFSR_S3;
+  u32 LFSR_S4;
+  u32 LFSR_S5;
+  u32 LFSR_S6;
+  u32 LFSR_S7;
+  u32 LFSR_S8;
+  u32 LFSR_S9;
+  u32 LFSR_S10;
+  u32 LFSR_S11;
+  u32 LFSR_S12;
+  u32 LFSR_S13;
+  u32 LFSR_S14;
+  u32 LFSR_S15;
+  u32 FSM_R1;
+  u32 FSM_R2;
+  u32 FSM_R3;
+} snow3g_state_t;
+
+/* The functions MUL alpha and DIV alpha.
+ * Input c: 8-bit input.
+ * Output : 32-bit output.
+ * See sections 3.4.2 and 3.4.3.
+ */
+
+u32 MULalpha(u8 c);
+u32 DIValpha(u8 c);
+
 /* Initialization.
  * Input k[4]: Four 32-bit words making up 128-bit key.
  * Input IV[4]: Four 32-bit words making 128-bit initialization variable.
@@ -28,7 +63,7 @@ typedef unsigned long long u64;
  * See Section 4.1.
  */
 
-void snow3g_initialize(u32 k[4], u32 IV[4]);
+void snow3g_initialize(snow3g_state_t* state, u32 k[4], u32 IV[4]);
 
 /* Generation of Keystream.
  * input n: number of 32-bit words of keystream.
@@ -38,7 +73,7 @@ void snow3g_initialize(u32 k[4], u32 IV[4]);
  * See section 4.2.
  */
 
-void snow3g_generate_keystream(u32 n, u32* z);
+void snow3g_generate_keystream(snow3g_state_t* state, u32 n, u32* z);
 
 /* f8.
  * Input key: 128 bit Confidentiality Key.
@@ -63,10 +98,10 @@ void snow3g_f8(u8* key, u32 count, u32 bearer, u32 dir, u8* data, u32 length);
  * Input dir:1 bit, direction of transmission (in the LSB).
  * Input data: length number of bits, input bit stream.
  * Input length: 64 bit Length, i.e., the number of bits to be MAC'd.
- * Output : 32 bit block used as MAC
+ * Output MAC_I: 32 bit block used as MAC
  * Generates 32-bit MAC using UIA2 algorithm as defined in Section 4.
  */
 
-u8* snow3g_f9(u8* key, u32 count, u32 fresh, u32 dir, u8* data, u64 length);
+void snow3g_f9(u8* key, u32 count, u32 fresh, u32 dir, u8* data, u64 length, u8* MAC_I);
 
 #endif // SRSLTE_SNOW_3G_H
\ No newline at end of file
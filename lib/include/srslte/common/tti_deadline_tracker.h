@@ -0,0 +1,102 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_TTI_DEADLINE_TRACKER_H
+#define SRSLTE_TTI_DEADLINE_TRACKER_H
+
+#include "srslte/common/common.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace srslte {
+
+// Latency percentiles of one processing stage, in microseconds
+struct rt_stage_metrics_t {
+  float p50_us;
+  float p99_us;
+  float max_us;
+};
+
+// Real-time metrics of the PHY subframe processing chain
+struct rt_metrics_t {
+  rt_stage_metrics_t wait; ///< From RX completion to worker start
+  rt_stage_metrics_t proc; ///< From worker start to worker end
+  rt_stage_metrics_t tx;   ///< From RX completion to TX hand-off to the radio
+  uint32_t           nof_tti;
+  uint32_t           nof_late; ///< Number of TTIs whose TX hand-off exceeded the deadline
+};
+
+/**
+ * Per-TTI real-time deadline tracker. The RX thread and the PHY workers timestamp each TTI at the following points:
+ * RX completion, worker start, worker end and TX hand-off to the radio. The stage latencies are accumulated in
+ * histograms of atomic counters, so that all the timestamping methods are lock-free and can be called concurrently from
+ * any PHY thread. The metrics are computed and the histograms reset on every call to get_metrics().
+ */
+class tti_deadline_tracker
+{
+public:
+  explicit tti_deadline_tracker(std::chrono::microseconds deadline_ = std::chrono::microseconds{3000});
+
+  void set_deadline(std::chrono::microseconds deadline_) { deadline_us = deadline_.count(); }
+
+  void rx_done(uint32_t tti);
+  void worker_start(uint32_t tti);
+  void worker_end(uint32_t tti);
+  void tx_handoff(uint32_t tti);
+
+  void get_metrics(rt_metrics_t* m);
+
+private:
+  // Histogram with fixed width bins, the last bin accumulates all values exceeding the histogram range
+  class histogram
+  {
+  public:
+    static const uint32_t bin_width_us = 10;
+    static const uint32_t nof_bins     = 1024;
+
+    void push(int64_t value_us);
+    void pop_metrics(rt_stage_metrics_t* m, uint32_t* count);
+
+  private:
+    std::array<std::atomic<uint32_t>, nof_bins> bins   = {};
+    std::atomic<int64_t>                        max_us = {0};
+  };
+
+  struct tti_stamps_t {
+    std::atomic<int64_t> rx    = {0};
+    std::atomic<int64_t> start = {0};
+  };
+
+  static int64_t now_us()
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  std::atomic<int64_t>                deadline_us;
+  std::array<tti_stamps_t, TTIMOD_SZ> stamps = {};
+  histogram                           wait_hist, proc_hist, tx_hist;
+  std::atomic<uint32_t>               nof_late = {0};
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_TTI_DEADLINE_TRACKER_H
@@ -183,6 +183,14 @@ public:
   virtual int  get_ul_sched(uint32_t tti, ul_sched_list_t& ul_sched_res)                = 0;
   virtual void set_sched_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)               = 0;
 
+  /**
+   * PHY callback for informing MAC that the processing of a TTI is over. The PHY no longer uses the data and
+   * softbuffer pointers of the grants scheduled for it, nor of the grants of any earlier TTI.
+   *
+   * @param tti_rx the TTI whose processing is over
+   */
+  virtual void tti_done(uint32_t tti_rx) = 0;
+
   // Radio-Link status
   virtual void rl_failure(uint16_t rnti) = 0;
   virtual void rl_ok(uint16_t rnti)      = 0;
@@ -529,7 +537,8 @@ typedef struct {
 } s1ap_args_t;
 
 typedef struct {
-  uint32_t                      nof_prb; ///< Needed to dimension MAC softbuffers for all cells
+  uint32_t                      nof_prb;            ///< Needed to dimension MAC softbuffers for all cells
+  bool                          pusch_8bit_decoder; ///< Rx softbuffers store 8-bit LLRs for the 8-bit PUSCH decoder
   sched_interface::sched_args_t sched;
   int                           link_failure_nof_err;
 } mac_args_t;
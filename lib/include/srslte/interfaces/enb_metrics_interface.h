@@ -30,6 +30,7 @@
 #include "srsenb/hdr/stack/upper/common_enb.h"
 #include "srsenb/hdr/stack/upper/s1ap_metrics.h"
 #include "srslte/common/metrics_hub.h"
+#include "srslte/common/tti_deadline_tracker.h"
 #include "srslte/radio/radio_metrics.h"
 #include "srslte/upper/rlc_metrics.h"
 #include "srsue/hdr/stack/upper/gw_metrics.h"
@@ -37,14 +38,16 @@
 namespace srsenb {
 
 struct stack_metrics_t {
-  mac_metrics_t  mac[ENB_METRICS_MAX_USERS];
-  rrc_metrics_t  rrc;
-  s1ap_metrics_t s1ap;
+  mac_metrics_t       mac[ENB_METRICS_MAX_USERS];
+  mac_sched_metrics_t mac_sched;
+  rrc_metrics_t       rrc;
+  s1ap_metrics_t      s1ap;
 };
 
 typedef struct {
   srslte::rf_metrics_t rf;
   phy_metrics_t        phy[ENB_METRICS_MAX_USERS];
+  srslte::rt_metrics_t phy_rt;
   stack_metrics_t      stack;
   bool                 running;
 } enb_metrics_t;
@@ -74,12 +74,22 @@ public:
                                                struct sctp_sndrcvinfo enb_sri)               = 0;
 };
 
+typedef struct {
+  uint64_t imsi;
+  bool     valid; // false when the IMSI is unknown to the HSS
+  uint8_t  k_asme[32];
+  uint8_t  autn[16];
+  uint8_t  rand[16];
+  uint8_t  xres[16];
+} hss_auth_vector_t;
+
 class hss_interface_nas // NAS -> HSS
 {
 public:
   virtual bool gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres) = 0;
+  virtual void gen_auth_info_answer_multi(hss_auth_vector_t* vectors, uint32_t nof_vectors)                      = 0;
   virtual bool gen_update_loc_answer(uint64_t imsi, uint8_t* qci)                                                = 0;
-  virtual bool resync_sqn(uint64_t imsi, uint8_t* auts)                                                          = 0;
+  virtual bool resync_sqn(uint64_t imsi, uint8_t* rand, uint8_t* auts)                                           = 0;
 };
 
 class mme_interface_nas // NAS -> MME
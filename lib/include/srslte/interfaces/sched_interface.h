@@ -44,7 +44,7 @@ public:
   const static int MAX_RAR_LIST        = 8;
   const static int MAX_BC_LIST         = 8;
   const static int MAX_RLC_PDU_LIST    = 8;
-  const static int MAX_PHICH_LIST      = 8;
+  const static int MAX_PHICH_LIST      = MAX_DATA_LIST; ///< one per PUSCH of the previous HARQ round
 
   typedef struct {
     uint32_t len;
@@ -52,13 +52,16 @@ public:
   } cell_cfg_sib_t;
 
   struct sched_args_t {
-    int      pdsch_mcs            = -1;
-    int      pdsch_max_mcs        = 28;
-    int      pusch_mcs            = -1;
-    int      pusch_max_mcs        = 28;
-    uint32_t min_nof_ctrl_symbols = 1;
-    uint32_t max_nof_ctrl_symbols = 3;
-    int      max_aggr_level       = 3;
+    int      pdsch_mcs              = -1;
+    int      pdsch_max_mcs          = 28;
+    int      pusch_mcs              = -1;
+    int      pusch_max_mcs          = 28;
+    uint32_t min_nof_ctrl_symbols   = 1;
+    uint32_t max_nof_ctrl_symbols   = 3;
+    int      max_aggr_level         = 3;
+    uint32_t pdcch_max_search_nodes = 0; ///< Budget of the bounded PDCCH allocator (0 uses the full alloc tree)
+    uint32_t max_sched_time_us      = 0; ///< Time budget of the data allocation of a carrier per TTI (0 disables it)
+    uint32_t nof_sched_workers      = 0; ///< Threads allocating carriers in parallel (0 schedules carriers serially)
   };
 
   struct cell_cfg_t {
@@ -59,9 +59,9 @@ typedef struct SRSLTE_API {
 typedef struct {
   srslte_cell_t cell;
 
-  srslte_refsignal_ul_t             dmrs_signal;
-  srslte_refsignal_ul_dmrs_pregen_t dmrs_pregen;
-  bool                              dmrs_signal_configured;
+  srslte_refsignal_ul_t              dmrs_signal;
+  srslte_refsignal_ul_dmrs_pregen_t* dmrs_pregen; // Shared with the other estimators of the same cell
+  bool                               dmrs_signal_configured;
 
   cf_t* pilot_estimates;
   cf_t* pilot_estimates_tmp[4];
@@ -100,6 +100,17 @@ SRSLTE_API int srslte_chest_ul_estimate_pusch(srslte_chest_ul_t*     q,
                                               cf_t*                  input,
                                               srslte_chest_ul_res_t* res);
 
+/* Estimates the channel of several PUSCH grants of the same subframe in a single pass over the DMRS symbols. The
+ * estimates of all the grants are written to the resource grid ce, which every res[i].ce is set to. Returns
+ * SRSLTE_ERROR_INVALID_INPUTS if the grants overlap or hop, they must be estimated one by one then. */
+SRSLTE_API int srslte_chest_ul_estimate_pusch_multi(srslte_chest_ul_t*     q,
+                                                    srslte_ul_sf_cfg_t*    sf,
+                                                    srslte_pusch_cfg_t*    cfg,
+                                                    cf_t*                  input,
+                                                    cf_t*                  ce,
+                                                    srslte_chest_ul_res_t* res,
+                                                    uint32_t               nof_grants);
+
 SRSLTE_API int srslte_chest_ul_estimate_pucch(srslte_chest_ul_t*     q,
                                               srslte_ul_sf_cfg_t*    sf,
                                               srslte_pucch_cfg_t*    cfg,
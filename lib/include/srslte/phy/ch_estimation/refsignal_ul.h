@@ -114,6 +114,13 @@ SRSLTE_API int srslte_refsignal_dmrs_pusch_pregen(srslte_refsignal_ul_t*
 SRSLTE_API void srslte_refsignal_dmrs_pusch_pregen_free(srslte_refsignal_ul_t*             q,
                                                         srslte_refsignal_ul_dmrs_pregen_t* pregen);
 
+/* Returns the pregenerated PUSCH DMRS of the cell of q and the given common configuration. They are generated by the
+ * first caller and shared by all the callers with the same cell and configuration, until all of them release them */
+SRSLTE_API srslte_refsignal_ul_dmrs_pregen_t*
+srslte_refsignal_dmrs_pusch_pregen_acquire(srslte_refsignal_ul_t* q, srslte_refsignal_dmrs_pusch_cfg_t* cfg);
+
+SRSLTE_API void srslte_refsignal_dmrs_pusch_pregen_release(srslte_refsignal_ul_dmrs_pregen_t* pregen);
+
 SRSLTE_API int srslte_refsignal_dmrs_pusch_pregen_put(srslte_refsignal_ul_t*             q,
                                                       srslte_ul_sf_cfg_t*                sf_cfg,
                                                       srslte_refsignal_ul_dmrs_pregen_t* pregen,
@@ -26,8 +26,11 @@
 #include "fading.h"
 #include "hst.h"
 #include "rlf.h"
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <srslte/common/log_filter.h>
+#include <srslte/common/thread_pool.h>
 #include <string>
 
 namespace srslte {
@@ -64,6 +67,9 @@ public:
     bool     rlf_enable   = false;
     uint32_t rlf_t_on_ms  = 10000;
     uint32_t rlf_t_off_ms = 2000;
+
+    // Multi-carrier options
+    uint32_t nof_workers = 0; // Threads processing the channels in parallel, 0 processes them serially
   } args_t;
 
   channel(const args_t& channel_args, uint32_t _nof_channels);
@@ -72,19 +78,34 @@ public:
   void set_srate(uint32_t srate);
   void run(cf_t* in[SRSLTE_MAX_CHANNELS], cf_t* out[SRSLTE_MAX_CHANNELS], uint32_t len, const srslte_timestamp_t& t);
 
+  //! Emulated samples per second of processing time, accumulated over all channels
+  double get_samples_per_second() const;
+
 private:
-  float                    hst_init_phase              = 0.0f;
-  srslte_channel_fading_t* fading[SRSLTE_MAX_CHANNELS] = {};
-  srslte_channel_delay_t*  delay[SRSLTE_MAX_CHANNELS]  = {};
-  srslte_channel_awgn_t*   awgn                        = nullptr;
-  srslte_channel_hst_t*    hst                         = nullptr;
-  srslte_channel_rlf_t*    rlf                         = nullptr;
-  cf_t*                    buffer_in                   = nullptr;
-  cf_t*                    buffer_out                  = nullptr;
-  log_filter*              log_h                       = nullptr;
-  uint32_t                 nof_channels                = 0;
-  uint32_t                 current_srate               = 0;
-  args_t                   args                        = {};
+  void run_channel(uint32_t i, const cf_t* in, cf_t* out, uint32_t len, const srslte_timestamp_t& t);
+
+  float                    hst_init_phase                  = 0.0f;
+  srslte_channel_fading_t* fading[SRSLTE_MAX_CHANNELS]     = {};
+  srslte_channel_delay_t*  delay[SRSLTE_MAX_CHANNELS]      = {};
+  srslte_channel_awgn_t*   awgn[SRSLTE_MAX_CHANNELS]       = {};
+  srslte_channel_hst_t*    hst[SRSLTE_MAX_CHANNELS]        = {};
+  srslte_channel_rlf_t*    rlf                             = nullptr;
+  cf_t*                    buffer_in[SRSLTE_MAX_CHANNELS]  = {};
+  cf_t*                    buffer_out[SRSLTE_MAX_CHANNELS] = {};
+  log_filter*              log_h                           = nullptr;
+  uint32_t                 nof_channels                    = 0;
+  uint32_t                 current_srate                   = 0;
+  args_t                   args                            = {};
+
+  // Parallel processing of the channels
+  std::unique_ptr<task_thread_pool> workers;
+  std::mutex                        workers_mutex;
+  std::condition_variable           workers_cvar;
+  uint32_t                          workers_pending = 0;
+
+  // Throughput measurement
+  uint64_t nof_processed_samples = 0;
+  double   processing_time_s     = 0.0;
 };
 
 typedef std::unique_ptr<channel> channel_ptr;
@@ -27,6 +27,7 @@
 
 #define SRSLTE_CHANNEL_FADING_MAXTAPS 9
 #define SRSLTE_CHANNEL_FADING_NTERMS 16
+#define SRSLTE_CHANNEL_FADING_TRAJ_RESYNC 1024
 
 typedef enum {
   srslte_channel_fading_model_none = 0,
@@ -49,7 +50,15 @@ typedef struct {
   float coeff_alpha[SRSLTE_CHANNEL_FADING_MAXTAPS][SRSLTE_CHANNEL_FADING_NTERMS]; // Angle of arrival
   float coeff_a[SRSLTE_CHANNEL_FADING_MAXTAPS][SRSLTE_CHANNEL_FADING_NTERMS];     // Random phase
   float coeff_b[SRSLTE_CHANNEL_FADING_MAXTAPS][SRSLTE_CHANNEL_FADING_NTERMS];     // Random phase
-  cf_t* h_tap[SRSLTE_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain
+  cf_t* h_tap[SRSLTE_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain, FFT shifted
+
+  // Doppler trajectory, one phasor per tap and Jakes term, advanced one N/2 segment at a time
+  double   traj_w[SRSLTE_CHANNEL_FADING_MAXTAPS * SRSLTE_CHANNEL_FADING_NTERMS];    // Angular speed, pi * F_d * cos(alpha)
+  cf_t     traj_step[SRSLTE_CHANNEL_FADING_MAXTAPS * SRSLTE_CHANNEL_FADING_NTERMS]; // Rotation for one N/2 segment
+  cf_t     traj_a[SRSLTE_CHANNEL_FADING_MAXTAPS * SRSLTE_CHANNEL_FADING_NTERMS];    // Real part phasors
+  cf_t     traj_b[SRSLTE_CHANNEL_FADING_MAXTAPS * SRSLTE_CHANNEL_FADING_NTERMS];    // Imaginary part phasors
+  double   traj_time;  // Time of the current phasors
+  uint32_t traj_count; // Segments since the trajectory was last evaluated from scratch, 0 if not evaluated
 
   // Utils
   srslte_dft_plan_t fft;             // DFT to frequency domain
@@ -57,7 +66,6 @@ typedef struct {
   cf_t*             temp;            // Temporal buffer, length fft_size
   cf_t*             h_freq;          // Channel frequency response, length fft_size
   cf_t*             y_freq;          // Intermediate frequency domain buffer
-  float             sin_table[1024]; // Table of sinus values
 
   // State variables
   cf_t* state; // To save impulse response of the filter
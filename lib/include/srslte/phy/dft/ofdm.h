@@ -114,6 +114,10 @@ SRSLTE_API void srslte_ofdm_tx_free(srslte_ofdm_t* q);
 
 SRSLTE_API void srslte_ofdm_tx_sf(srslte_ofdm_t* q);
 
+/* Transforms a single OFDM symbol of nof_re subcarriers into cp_len + symbol_sz samples. The frequency shift is not
+ * applied */
+SRSLTE_API void srslte_ofdm_tx_symbol(srslte_ofdm_t* q, const cf_t* input, cf_t* output, uint32_t cp_len);
+
 SRSLTE_API int srslte_ofdm_set_freq_shift(srslte_ofdm_t* q, float freq_shift);
 
 SRSLTE_API void srslte_ofdm_set_normalize(srslte_ofdm_t* q, bool normalize_enable);
@@ -59,6 +59,8 @@
 
 #include "srslte/config.h"
 
+#define SRSLTE_ENB_DL_NOF_CFI 3
+
 typedef struct SRSLTE_API {
   srslte_cell_t cell;
 
@@ -84,6 +86,20 @@ typedef struct SRSLTE_API {
   float sss_signal0[SRSLTE_SSS_LEN];
   float sss_signal5[SRSLTE_SSS_LEN];
 
+  // Static content of the normal FDD subframes (synchronization, reference signals and PCFICH) per subframe index,
+  // CFI, port and symbol. NULL rows are empty. Rows other than the first symbol are shared by all the CFI.
+  cf_t*    tmpl_buffer;
+  cf_t*    tmpl_re[SRSLTE_NOF_SF_X_FRAME][SRSLTE_ENB_DL_NOF_CFI][SRSLTE_MAX_PORTS][SRSLTE_CP_NORM_SF_NSYMB];
+  uint32_t tmpl_nof_rows;
+
+  // Time-domain version of the template rows, reused for the symbols that only carry static content
+  bool     ifft_cache;
+  cf_t*    tmpl_td_buffer;
+  uint32_t tmpl_td_stride;
+
+  // Symbols written by any channel after the template was copied
+  uint32_t dirty_symbols;
+
 } srslte_enb_dl_t;
 
 typedef struct {
@@ -99,6 +115,9 @@ SRSLTE_API void srslte_enb_dl_free(srslte_enb_dl_t* q);
 
 SRSLTE_API int srslte_enb_dl_set_cell(srslte_enb_dl_t* q, srslte_cell_t cell);
 
+/* Enables reusing the cached time-domain symbols of the subframe templates for the symbols that carry no channel */
+SRSLTE_API int srslte_enb_dl_set_ifft_cache(srslte_enb_dl_t* q, bool enable);
+
 SRSLTE_API int srslte_enb_dl_add_rnti(srslte_enb_dl_t* q, uint16_t rnti);
 
 SRSLTE_API void srslte_enb_dl_rem_rnti(srslte_enb_dl_t* q, uint16_t rnti);
@@ -86,4 +86,18 @@ SRSLTE_API int srslte_enb_ul_get_pusch(srslte_enb_ul_t*    q,
                                        srslte_pusch_cfg_t* cfg,
                                        srslte_pusch_res_t* res);
 
+/* Estimates the channel of all the PUSCH grants of the subframe at once, chest_res[i].ce is set to the shared
+ * estimates grid. The grants are then decoded one by one with srslte_enb_ul_decode_pusch() */
+SRSLTE_API int srslte_enb_ul_estimate_pusch_multi(srslte_enb_ul_t*       q,
+                                                  srslte_ul_sf_cfg_t*    ul_sf,
+                                                  srslte_pusch_cfg_t*    cfg,
+                                                  srslte_chest_ul_res_t* chest_res,
+                                                  uint32_t               nof_grants);
+
+SRSLTE_API int srslte_enb_ul_decode_pusch(srslte_enb_ul_t*       q,
+                                          srslte_ul_sf_cfg_t*    ul_sf,
+                                          srslte_pusch_cfg_t*    cfg,
+                                          srslte_chest_ul_res_t* chest_res,
+                                          srslte_pusch_res_t*    res);
+
 #endif // SRSLTE_ENB_UL_H
@@ -33,40 +33,90 @@
 
 #include "srslte/config.h"
 #include "srslte/phy/common/phy_common.h"
+#include <pthread.h>
 
 typedef struct SRSLTE_API {
-  uint32_t  max_cb;
-  int16_t** buffer_f;
-  uint8_t** data;
-  bool*     cb_crc;
-  bool      tb_crc;
+  uint32_t nof_buffers;  ///< Code block buffers allocated by the pool
+  uint32_t nof_in_use;   ///< Code block buffers currently borrowed by softbuffers
+  uint32_t max_in_use;   ///< Peak of borrowed code block buffers
+  uint64_t nof_borrows;  ///< Code block buffers handed out since the pool was created
+  uint64_t nof_failures; ///< Code block buffers that could not be handed out because the pool was exhausted
+  uint64_t nof_bytes;    ///< Memory allocated by the pool
+} srslte_softbuffer_pool_metrics_t;
+
+/*
+ * Pool of code block buffers shared by many softbuffers. A pooled softbuffer only holds code block buffers while a
+ * transport block is in flight, that is from srslte_softbuffer_*_reset_tbs() until srslte_softbuffer_*_release().
+ */
+typedef struct SRSLTE_API {
+  void*                            free_list;
+  uint32_t                         soft_nbytes;
+  uint32_t                         data_nbytes;
+  uint32_t                         max_buffers;
+  bool                             llr_is_8bit;
+  pthread_mutex_t                  mutex;
+  srslte_softbuffer_pool_metrics_t metrics;
+} srslte_softbuffer_pool_t;
+
+typedef struct SRSLTE_API {
+  uint32_t                  max_cb;
+  int16_t**                 buffer_f;
+  uint8_t**                 data;
+  bool*                     cb_crc;
+  bool                      tb_crc;
+  srslte_softbuffer_pool_t* pool;
 } srslte_softbuffer_rx_t;
 
 typedef struct SRSLTE_API {
-  uint32_t  max_cb;
-  uint8_t** buffer_b;
+  uint32_t                  max_cb;
+  uint8_t**                 buffer_b;
+  srslte_softbuffer_pool_t* pool;
 } srslte_softbuffer_tx_t;
 
 #define SOFTBUFFER_SIZE 18600
 
+/* Rx pools store SOFTBUFFER_SIZE LLRs per code block, of 8 bits if llr_is_8bit is set or of 16 bits otherwise. A
+ * max_buffers of 0 lets the pool grow on demand. All the softbuffers must be released before the pool is freed. */
+SRSLTE_API int srslte_softbuffer_pool_init_rx(srslte_softbuffer_pool_t* pool, bool llr_is_8bit, uint32_t max_buffers);
+
+SRSLTE_API int srslte_softbuffer_pool_init_tx(srslte_softbuffer_pool_t* pool, uint32_t max_buffers);
+
+SRSLTE_API void srslte_softbuffer_pool_get_metrics(srslte_softbuffer_pool_t*         pool,
+                                                   srslte_softbuffer_pool_metrics_t* metrics);
+
+SRSLTE_API void srslte_softbuffer_pool_free(srslte_softbuffer_pool_t* pool);
+
 SRSLTE_API int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb);
 
+/* Pooled softbuffers borrow their code block buffers in reset_tbs()/reset_cb() and give them back in release().
+ * A full reset() releases them too, as no transport block is in flight. */
+SRSLTE_API int
+srslte_softbuffer_rx_init_pool(srslte_softbuffer_rx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool);
+
 SRSLTE_API void srslte_softbuffer_rx_reset(srslte_softbuffer_rx_t* p);
 
 SRSLTE_API void srslte_softbuffer_rx_reset_tbs(srslte_softbuffer_rx_t* q, uint32_t tbs);
 
 SRSLTE_API void srslte_softbuffer_rx_reset_cb(srslte_softbuffer_rx_t* q, uint32_t nof_cb);
 
+SRSLTE_API void srslte_softbuffer_rx_release(srslte_softbuffer_rx_t* q);
+
 SRSLTE_API void srslte_softbuffer_rx_free(srslte_softbuffer_rx_t* p);
 
 SRSLTE_API int srslte_softbuffer_tx_init(srslte_softbuffer_tx_t* q, uint32_t nof_prb);
 
+/* Pooled Tx softbuffers are not zeroed on reset, the rate matcher rewrites the circular buffer on every rv=0 */
+SRSLTE_API int
+srslte_softbuffer_tx_init_pool(srslte_softbuffer_tx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool);
+
 SRSLTE_API void srslte_softbuffer_tx_reset(srslte_softbuffer_tx_t* p);
 
 SRSLTE_API void srslte_softbuffer_tx_reset_tbs(srslte_softbuffer_tx_t* q, uint32_t tbs);
 
 SRSLTE_API void srslte_softbuffer_tx_reset_cb(srslte_softbuffer_tx_t* q, uint32_t nof_cb);
 
+SRSLTE_API void srslte_softbuffer_tx_release(srslte_softbuffer_tx_t* q);
+
 SRSLTE_API void srslte_softbuffer_tx_free(srslte_softbuffer_tx_t* p);
 
 #endif // SRSLTE_SOFTBUFFER_H
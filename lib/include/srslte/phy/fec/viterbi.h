@@ -36,6 +36,9 @@
 
 typedef enum { SRSLTE_VITERBI_27 = 0, SRSLTE_VITERBI_29, SRSLTE_VITERBI_37, SRSLTE_VITERBI_39 } srslte_viterbi_type_t;
 
+/* Maximum number of frames decoded in parallel by srslte_viterbi_decode_f_multi() */
+#define SRSLTE_VITERBI_MAX_LANES 16
+
 typedef struct SRSLTE_API {
   void*    ptr;
   uint32_t R;
@@ -52,6 +55,8 @@ typedef struct SRSLTE_API {
   uint16_t* tmp_s;
   uint8_t*  symbols_uc;
   uint16_t* symbols_us;
+  void*     ptr_multi;
+  uint16_t* symbols_multi;
 } srslte_viterbi_t;
 
 SRSLTE_API int srslte_viterbi_init(srslte_viterbi_t*     q,
@@ -68,6 +73,12 @@ SRSLTE_API void srslte_viterbi_free(srslte_viterbi_t* q);
 
 SRSLTE_API int srslte_viterbi_decode_f(srslte_viterbi_t* q, float* symbols, uint8_t* data, uint32_t frame_length);
 
+SRSLTE_API int srslte_viterbi_decode_f_multi(srslte_viterbi_t* q,
+                                             float*            symbols[],
+                                             uint8_t*          data[],
+                                             uint32_t          nof_frames,
+                                             uint32_t          frame_length);
+
 SRSLTE_API int srslte_viterbi_decode_s(srslte_viterbi_t* q, int16_t* symbols, uint8_t* data, uint32_t frame_length);
 
 SRSLTE_API int srslte_viterbi_decode_us(srslte_viterbi_t* q, uint16_t* symbols, uint8_t* data, uint32_t frame_length);
@@ -47,6 +47,19 @@
 
 typedef enum SRSLTE_API { SEARCH_UE, SEARCH_COMMON } srslte_pdcch_search_mode_t;
 
+/* Maximum number of candidates kept decoded per subframe, enough for all the common and UE-specific search space
+ * candidates with a few DCI sizes */
+#define SRSLTE_PDCCH_MAX_DECODED 128
+
+/* A candidate location decoded for a given DCI size */
+typedef struct SRSLTE_API {
+  srslte_dci_location_t location;
+  uint32_t              nof_bits;
+  uint16_t              crc;
+  bool                  pending;
+  uint8_t               payload[SRSLTE_DCI_MAX_BITS + 16];
+} srslte_pdcch_decoded_t;
+
 /* PDCCH object */
 typedef struct SRSLTE_API {
   srslte_cell_t cell;
@@ -67,6 +80,12 @@ typedef struct SRSLTE_API {
   float    rm_f[3 * (SRSLTE_DCI_MAX_BITS + 16)];
   float*   llr;
 
+  /* batch decoding: candidates decoded since the last srslte_pdcch_extract_llr() and viterbi lane buffers */
+  srslte_pdcch_decoded_t decoded[SRSLTE_PDCCH_MAX_DECODED];
+  uint32_t               nof_decoded;
+  float*                 rm_f_multi[SRSLTE_VITERBI_MAX_LANES];
+  uint8_t*               data_multi[SRSLTE_VITERBI_MAX_LANES];
+
   /* tx & rx objects */
   srslte_modem_table_t mod;
   srslte_sequence_t    seq[SRSLTE_NOF_SF_X_FRAME];
@@ -104,6 +123,12 @@ SRSLTE_API int srslte_pdcch_extract_llr(srslte_pdcch_t*        q,
 SRSLTE_API int
 srslte_pdcch_decode_msg(srslte_pdcch_t* q, srslte_dl_sf_cfg_t* sf, srslte_dci_cfg_t* dci_cfg, srslte_dci_msg_t* msg);
 
+SRSLTE_API int srslte_pdcch_decode_msg_batch(srslte_pdcch_t*     q,
+                                             srslte_dl_sf_cfg_t* sf,
+                                             srslte_dci_cfg_t*   dci_cfg,
+                                             srslte_dci_msg_t*   msgs,
+                                             uint32_t            nof_msgs);
+
 SRSLTE_API int
 srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t E, uint32_t nof_bits, uint16_t* crc);
 
@@ -113,7 +138,9 @@ srslte_pdcch_dci_encode(srslte_pdcch_t* q, uint8_t* data, uint8_t* e, uint32_t n
 SRSLTE_API void
 srslte_pdcch_dci_encode_conv(srslte_pdcch_t* q, uint8_t* data, uint32_t nof_bits, uint8_t* coded_data, uint16_t rnti);
 
-/* Function for generation of UE-specific search space DCI locations */
+/* Functions for generation of UE-specific search space DCI locations. They all look the hashing variable Yk of the
+ * RNTI and subframe up in a table shared by the whole process, which computes the Yk of 256 consecutive RNTIs the
+ * first time one of them is searched. The candidates of each CFI are then derived from Yk and the number of CCEs. */
 SRSLTE_API uint32_t srslte_pdcch_ue_locations(srslte_pdcch_t*        q,
                                               srslte_dl_sf_cfg_t*    sf,
                                               srslte_dci_location_t* locations,
@@ -133,6 +160,12 @@ SRSLTE_API uint32_t srslte_pdcch_ue_locations_ncce_L(uint32_t               nof_
                                                      uint16_t               rnti,
                                                      int                    L);
 
+/* Returns the UE-specific search space hashing variable Yk (36.213 9.1.1) */
+SRSLTE_API uint32_t srslte_pdcch_ue_yk(uint16_t rnti, uint32_t sf_idx);
+
+/* Returns the memory used by the shared Yk table */
+SRSLTE_API uint32_t srslte_pdcch_ue_yk_table_nbytes();
+
 /* Function for generation of common search space DCI locations */
 SRSLTE_API uint32_t srslte_pdcch_common_locations(srslte_pdcch_t*        q,
                                                   srslte_dci_location_t* locations,
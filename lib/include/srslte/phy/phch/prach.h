@@ -76,8 +76,8 @@ typedef struct SRSLTE_API {
   cf_t*  ifft_in;
   cf_t*  ifft_out;
   cf_t*  prach_bins;
-  cf_t*  corr_spec;
-  float* corr;
+  cf_t*  corr_spec; // Correlation spectra of all root sequences, one after another
+  float* corr;      // Power delay profiles of all root sequences, one after another
 
   // PRACH IFFT
   srslte_dft_plan_t fft;
@@ -85,7 +85,8 @@ typedef struct SRSLTE_API {
 
   // ZC-sequence FFT and IFFT
   srslte_dft_plan_t zc_fft;
-  srslte_dft_plan_t zc_ifft;
+  srslte_dft_plan_t zc_ifft;           // Batched (guru) IFFT over the corr_spec of all root sequences
+  uint32_t          zc_ifft_nof_roots; // Number of root sequences zc_ifft is planned for
 
   cf_t* signal_fft;
   float detect_factor;
@@ -71,6 +71,13 @@ typedef struct SRSLTE_API {
 
   srslte_uci_cqi_pusch_t uci_cqi;
 
+  /* Reference encoder with one bit per byte, the DL-SCH output is unpacked while it is enabled */
+  bool     tx_bit_per_byte;
+  uint8_t* tx_tb_bits;
+  uint8_t* tx_cb_bits;
+  uint8_t* tx_coded_bits;
+  uint8_t* tx_w_buff;
+
 } srslte_sch_t;
 
 SRSLTE_API int srslte_sch_init(srslte_sch_t* q);
@@ -81,6 +88,8 @@ SRSLTE_API void srslte_sch_set_max_noi(srslte_sch_t* q, uint32_t max_iterations)
 
 SRSLTE_API float srslte_sch_last_noi(srslte_sch_t* q);
 
+SRSLTE_API int srslte_sch_set_tx_bit_per_byte(srslte_sch_t* q, bool enable);
+
 SRSLTE_API int srslte_dlsch_encode(srslte_sch_t* q, srslte_pdsch_cfg_t* cfg, uint8_t* data, uint8_t* e_bits);
 
 SRSLTE_API int srslte_dlsch_encode2(srslte_sch_t*       q,
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/******************************************************************************
+ *  File:         channelizer.h
+ *
+ *  Description:  Bank of decimating band-pass filters extracting narrowband
+ *                channels at arbitrary frequency offsets of a wideband
+ *                capture. Every channel uses the polyphase decomposition of
+ *                a common low-pass prototype so that only the decimated
+ *                outputs are computed, and is brought down to baseband after
+ *                filtering.
+ *
+ *  Reference:    Multirate Signal Processing for Communication Systems
+ *                fredric j. harris
+ *****************************************************************************/
+
+#ifndef SRSLTE_CHANNELIZER_H
+#define SRSLTE_CHANNELIZER_H
+
+#include <stdint.h>
+
+#include "srslte/config.h"
+
+#define SRSLTE_CHANNELIZER_TAPS_PER_PHASE 16
+
+typedef struct SRSLTE_API {
+  uint32_t decimation;
+  uint32_t nof_taps;
+  uint32_t nof_channels;
+  uint32_t max_input_len;
+
+  cf_t**   taps;     // Time-reversed band-pass filters, one per channel
+  cf_t*    rotation; // Phase increment of each channel between two outputs
+  cf_t*    phasor;   // Current down-conversion phase of each channel
+  cf_t*    buffer;   // Filter history followed by the input being processed
+  uint32_t phase;    // Input samples to skip before the next output
+} srslte_channelizer_t;
+
+/* Creates the filters for nof_channels channels centered at offset_hz[] from the center of the wideband signal.
+ * The wideband sampling rate must be an integer multiple of the channel sampling rate. The passband is set to
+ * cutoff_hz at each side of the channel center.
+ */
+SRSLTE_API int srslte_channelizer_init(srslte_channelizer_t* q,
+                                       double                srate_hz,
+                                       double                channel_srate_hz,
+                                       double                cutoff_hz,
+                                       const double*         offset_hz,
+                                       uint32_t              nof_channels,
+                                       uint32_t              max_input_len);
+
+SRSLTE_API void srslte_channelizer_free(srslte_channelizer_t* q);
+
+/* Resets the filter history and the down-conversion phase */
+SRSLTE_API void srslte_channelizer_reset(srslte_channelizer_t* q);
+
+/* Filters and decimates nof_samples wideband samples into every channel. The samples of consecutive calls are
+ * processed as a continuous stream. Returns the number of samples written in each output buffer, which must fit
+ * nof_samples / decimation + 1 samples, or a negative value on error.
+ */
+SRSLTE_API int
+srslte_channelizer_execute(srslte_channelizer_t* q, const cf_t* input, uint32_t nof_samples, cf_t** output);
+
+#endif // SRSLTE_CHANNELIZER_H
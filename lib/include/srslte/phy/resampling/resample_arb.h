@@ -42,17 +42,42 @@
 #define SRSLTE_RESAMPLE_ARB_N 32 // Polyphase filter rows
 #define SRSLTE_RESAMPLE_ARB_M 8  // Polyphase filter columns
 
+#define SRSLTE_RESAMPLE_ARB_MAX_PERIOD 256 // Longest period (numerator) of a rational rate with precomputed phases
+
 typedef struct SRSLTE_API {
-  float rate; // Resample rate
-  float step; // Step increment through filter
-  float acc;  // Index into filter
-  bool  interpolate;
-  cf_t  reg[SRSLTE_RESAMPLE_ARB_M]; // Our window of samples
+  float    rate;   // Resample rate
+  double   step;   // Step increment through filter
+  double   acc;    // Index into filter
+  uint32_t offset; // Input samples to skip before the next output
+  bool     interpolate;
+  cf_t     reg[SRSLTE_RESAMPLE_ARB_M]; // Last input samples of the previous block
+
+  // Filter rows, or the filter of each output of the period for rational rates, with every tap repeated for the real
+  // and imaginary parts of the input
+  float* taps;
+
+  // Rational rate L/D: the outputs repeat the same filters and input advances every L outputs
+  uint32_t  period; // L, zero for arbitrary rates
+  uint32_t  phase;  // Index of the next output within the period
+  uint32_t* advance;
 
 } srslte_resample_arb_t;
 
-SRSLTE_API void srslte_resample_arb_init(srslte_resample_arb_t* q, float rate, bool interpolate);
+SRSLTE_API int srslte_resample_arb_init(srslte_resample_arb_t* q, float rate, bool interpolate);
+
+SRSLTE_API void srslte_resample_arb_free(srslte_resample_arb_t* q);
 
+/* Clears the filter history and rewinds the output phase, the next call to compute starts a new stream */
+SRSLTE_API void srslte_resample_arb_reset(srslte_resample_arb_t* q);
+
+/* Resamples a block of a stream, the filter history and output phase carry over to the next call. Returns the number
+ * of output samples, which is at most ceil(n_in * rate) + 1.
+ */
 SRSLTE_API int srslte_resample_arb_compute(srslte_resample_arb_t* q, cf_t* input, cf_t* output, int n_in);
 
+/* Number of input samples the next call to compute needs to return exactly nof_output samples, rate must not exceed
+ * one.
+ */
+SRSLTE_API uint32_t srslte_resample_arb_nof_input(const srslte_resample_arb_t* q, uint32_t nof_output);
+
 #endif // SRSLTE_RESAMPLE_ARB_
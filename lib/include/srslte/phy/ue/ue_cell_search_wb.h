@@ -0,0 +1,105 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+/******************************************************************************
+ *  File:         ue_cell_search_wb.h
+ *
+ *  Description:  Wideband cell search. A single capture spanning several
+ *                carriers is split by a channelizer into one 1.92 MHz stream
+ *                per candidate carrier and the PSS/SSS search of
+ *                ue_cell_search runs on every stream, in parallel threads.
+ *
+ *                The capture can come from any source (RF, file or ZMQ), the
+ *                object does not control the radio.
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSLTE_UE_CELL_SEARCH_WB_H
+#define SRSLTE_UE_CELL_SEARCH_WB_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "srslte/config.h"
+#include "srslte/phy/resampling/channelizer.h"
+#include "srslte/phy/ue/ue_cell_search.h"
+
+typedef struct SRSLTE_API {
+  uint32_t                      channel; // Index of the channel in the list given at initialization
+  uint32_t                      N_id_2;
+  srslte_ue_cellsearch_result_t cell;
+} srslte_ue_cellsearch_wb_result_t;
+
+typedef struct SRSLTE_API {
+  srslte_ue_cellsearch_t cs;
+  const cf_t*            buffer;
+  uint32_t               nof_samples;
+  uint32_t               read_idx;
+  pthread_t              thread;
+  void*                  parent;
+} srslte_ue_cellsearch_wb_worker_t;
+
+typedef struct SRSLTE_API {
+  srslte_channelizer_t channelizer;
+  uint32_t             decimation;
+  uint32_t             max_samples;
+  uint32_t             max_frames;
+
+  uint32_t nof_channels;
+  cf_t**   channel_buffer;
+  uint32_t nof_channel_samples;
+
+  uint32_t                          nof_workers;
+  srslte_ue_cellsearch_wb_worker_t* workers;
+
+  // Scan state shared by the workers
+  pthread_mutex_t                mutex;
+  uint32_t                       next_channel;
+  int                            error;
+  bool*                          found;
+  srslte_ue_cellsearch_result_t* found_cells; // 3 per channel, one for each N_id_2
+} srslte_ue_cellsearch_wb_t;
+
+/* Prepares the search of nof_channels carriers centered at offset_hz[] from the center frequency of a capture
+ * sampled at srate_hz, which must be a multiple of SRSLTE_CS_SAMP_FREQ. max_samples is the longest capture that
+ * will be scanned and nof_threads the number of channels searched at the same time.
+ */
+SRSLTE_API int srslte_ue_cellsearch_wb_init(srslte_ue_cellsearch_wb_t* q,
+                                            double                     srate_hz,
+                                            const double*              offset_hz,
+                                            uint32_t                   nof_channels,
+                                            uint32_t                   max_samples,
+                                            uint32_t                   nof_threads);
+
+SRSLTE_API void srslte_ue_cellsearch_wb_free(srslte_ue_cellsearch_wb_t* q);
+
+/* Searches the cells of all the channels in the capture. Stores up to max_cells results ordered by channel and
+ * N_id_2 and returns the number of found cells or a negative number on error.
+ */
+SRSLTE_API int srslte_ue_cellsearch_wb_scan(srslte_ue_cellsearch_wb_t*        q,
+                                            const cf_t*                       samples,
+                                            uint32_t                          nof_samples,
+                                            srslte_ue_cellsearch_wb_result_t* found_cells,
+                                            uint32_t                          max_cells);
+
+#endif // SRSLTE_UE_CELL_SEARCH_WB_H
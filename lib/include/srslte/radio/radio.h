@@ -228,6 +228,19 @@ private:
   std::vector<double> cur_tx_freqs = {};
   std::vector<double> cur_rx_freqs = {};
 
+  // Optional resampling between the PHY sampling rate and the front-end rate, which is args.srate_hz scaled by a power
+  // of two to the closest rate that is not below the PHY rate. The last RX buffer takes the output of the channels
+  // the PHY does not read.
+  double                base_srate                                   = 0.0;
+  bool                  rx_resample                                  = false;
+  bool                  tx_resample                                  = false;
+  srslte_resample_arb_t rx_resamplers[SRSLTE_MAX_CHANNELS]           = {};
+  srslte_resample_arb_t tx_resamplers[SRSLTE_MAX_CHANNELS]           = {};
+  cf_t*                 rx_resample_buffers[SRSLTE_MAX_CHANNELS + 1] = {};
+  cf_t*                 tx_resample_buffers[SRSLTE_MAX_CHANNELS]     = {};
+  uint32_t              rx_resample_len                              = 0;
+  uint32_t              tx_resample_len                              = 0;
+
   constexpr static double tx_max_gap_zeros = 4e-3; ///< Maximum transmission gap to fill with zeros, otherwise the burst
                                                    ///< shall be stopped
 
@@ -347,6 +360,10 @@ private:
   void set_tx_adv(int nsamples);
   void set_tx_adv_neg(bool tx_adv_is_neg);
   bool config_rf_channels(const rf_args_t& args);
+
+  double get_device_srate(double srate);
+  bool   set_resamplers(srslte_resample_arb_t* resamplers, float rate);
+  void   free_resamplers();
 };
 
 } // namespace srslte
@@ -52,6 +52,7 @@ extern "C" {
 #include "srslte/phy/ch_estimation/refsignal_ul.h"
 #include "srslte/phy/ch_estimation/wiener_dl.h"
 
+#include "srslte/phy/resampling/channelizer.h"
 #include "srslte/phy/resampling/decim.h"
 #include "srslte/phy/resampling/interp.h"
 #include "srslte/phy/resampling/resample_arb.h"
@@ -106,6 +107,7 @@ extern "C" {
 #include "srslte/phy/phch/uci.h"
 
 #include "srslte/phy/ue/ue_cell_search.h"
+#include "srslte/phy/ue/ue_cell_search_wb.h"
 #include "srslte/phy/ue/ue_dl.h"
 #include "srslte/phy/ue/ue_mib.h"
 #include "srslte/phy/ue/ue_sync.h"
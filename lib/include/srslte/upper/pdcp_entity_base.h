@@ -148,6 +148,8 @@ protected:
                        pdcp_discard_timer_t::infinity};
 
   srslte::as_security_config_t sec_cfg = {};
+  srslte::security_aes_key     k_enc_aes; // Cached EEA2 key schedule
+  srslte::security_aes_key     k_int_aes; // Cached EIA2 key schedule and CMAC subkeys
 
   // Security functions
   void integrity_generate(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
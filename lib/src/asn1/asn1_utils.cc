@@ -21,6 +21,7 @@
 
 #include "srslte/asn1/asn1_utils.h"
 #include "srslte/common/logmap.h"
+#include <algorithm>
 #include <cmath>
 #include <stdio.h>
 
@@ -102,6 +103,66 @@ void log_error_code(SRSASN_CODE code, const char* filename, int line)
   }
 }
 
+/************************
+    arena allocation
+************************/
+
+static thread_local arena* thread_arena = nullptr;
+
+arena::~arena()
+{
+  for (auto& b : blocks) {
+    ::operator delete(b.data);
+  }
+}
+
+void* arena::allocate(size_t sz, size_t align)
+{
+  while (block_idx < blocks.size()) {
+    block_t& b   = blocks[block_idx];
+    size_t   pos = ceil_frac(block_pos, align) * align;
+    if (pos + sz <= b.size) {
+      block_pos = pos + sz;
+      bytes_used += sz;
+      return b.data + pos;
+    }
+    // blocks kept from a previous reset() are reused in order
+    block_idx++;
+    block_pos = 0;
+  }
+  // operator new returns memory aligned for any fundamental type, so the first allocation of a block is aligned
+  block_t b;
+  b.size = std::max(sz, (size_t)block_size);
+  b.data = static_cast<uint8_t*>(::operator new(b.size));
+  blocks.push_back(b);
+  block_idx = blocks.size() - 1;
+  block_pos = sz;
+  bytes_used += sz;
+  return b.data;
+}
+
+void arena::reset()
+{
+  block_idx  = 0;
+  block_pos  = 0;
+  bytes_used = 0;
+}
+
+arena* get_thread_arena()
+{
+  return thread_arena;
+}
+
+arena_scope::arena_scope(arena& a) : prev_arena(thread_arena)
+{
+  thread_arena = &a;
+}
+
+arena_scope::~arena_scope()
+{
+  thread_arena = prev_arena;
+}
+
 /*********************
        bit_ref
 *********************/
@@ -138,31 +199,41 @@ SRSASN_CODE bit_ref::pack(uint32_t val, uint32_t n_bits)
     log_error("This method only supports packing up to 32 bits\n");
     return SRSASN_ERROR_ENCODE_FAIL;
   }
-  uint32_t mask;
-  while (n_bits > 0) {
-    if (ptr >= max_ptr) {
-      log_error("Buffer size limit was achieved\n");
-      return SRSASN_ERROR_ENCODE_FAIL;
-    }
-    mask             = ((1u << n_bits) - 1u);
-    val              = val & mask;
-    uint8_t keepmask = ((uint8_t)-1) - (uint8_t)((1u << (8u - offset)) - 1u);
-    if ((uint32_t)(8 - offset) > n_bits) {
-      auto bit = static_cast<uint8_t>(val << (8u - offset - n_bits));
-      *ptr     = ((*ptr) & keepmask) + bit;
-      offset += n_bits;
-      n_bits = 0;
-    } else {
-      auto bit = static_cast<uint8_t>(val >> (n_bits - 8u + offset));
-      *ptr     = (*ptr & keepmask) + bit;
-      n_bits -= (8 - offset);
-      offset = 0;
-      ptr++;
-    }
+  if (n_bits == 0) {
+    return SRSASN_SUCCESS;
+  }
+  uint32_t n_total = offset + n_bits;
+  uint32_t n_bytes = (n_total + 7u) / 8u;
+  if (ptr + n_bytes > max_ptr) {
+    log_error("Buffer size limit was achieved\n");
+    return SRSASN_ERROR_ENCODE_FAIL;
   }
+  // Merge the kept bits of the current byte and the new bits in a 64-bit word, MSB first
+  uint64_t keepmask = (uint64_t)(uint8_t)(0xFFu << (8u - offset));
+  uint64_t word     = ((*ptr & keepmask) << 56u) | ((uint64_t)(val & ((1u << n_bits) - 1u)) << (64u - n_total));
+  for (uint32_t i = 0; i < n_bytes; ++i) {
+    ptr[i] = static_cast<uint8_t>(word >> (56u - 8u * i));
+  }
+  ptr += n_total / 8u;
+  offset = n_total % 8u;
   return SRSASN_SUCCESS;
 }
 
+template <typename Ptr>
+static uint64_t read_bits(Ptr& ptr, uint8_t& offset, uint32_t n_bits)
+{
+  // n_bits <= 56, so offset + n_bits fits in the 64-bit word
+  uint32_t n_total = offset + n_bits;
+  uint32_t n_bytes = (n_total + 7u) / 8u;
+  uint64_t word    = 0;
+  for (uint32_t i = 0; i < n_bytes; ++i) {
+    word |= (uint64_t)ptr[i] << (56u - 8u * i);
+  }
+  ptr += n_total / 8u;
+  offset = n_total % 8u;
+  return (word << (n_total - n_bits)) >> (64u - n_bits);
+}
+
 template <typename T, typename Ptr>
 SRSASN_CODE unpack_bits(T& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_ptr, uint32_t n_bits)
 {
@@ -171,23 +242,18 @@ SRSASN_CODE unpack_bits(T& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_pt
     return SRSASN_ERROR_DECODE_FAIL;
   }
   val = 0;
-  while (n_bits > 0) {
-    if (ptr >= max_ptr) {
-      log_error("Buffer size limit was achieved\n");
-      return SRSASN_ERROR_DECODE_FAIL;
-    }
-    if ((uint32_t)(8 - offset) > n_bits) {
-      uint8_t mask = (uint8_t)(1u << (8u - offset)) - (uint8_t)(1u << (8u - offset - n_bits));
-      val += ((uint32_t)((*ptr) & mask)) >> (8u - offset - n_bits);
-      offset += n_bits;
-      n_bits = 0;
-    } else {
-      auto mask = static_cast<uint8_t>((1u << (8u - offset)) - 1u);
-      val += ((uint32_t)((*ptr) & mask)) << (n_bits - 8 + offset);
-      n_bits -= 8 - offset;
-      offset = 0;
-      ptr++;
-    }
+  if (n_bits == 0) {
+    return SRSASN_SUCCESS;
+  }
+  if (ptr + (offset + n_bits + 7u) / 8u > max_ptr) {
+    log_error("Buffer size limit was achieved\n");
+    return SRSASN_ERROR_DECODE_FAIL;
+  }
+  if (n_bits <= 56) {
+    val = static_cast<T>(read_bits(ptr, offset, n_bits));
+  } else {
+    uint64_t msb = read_bits(ptr, offset, n_bits - 32);
+    val          = static_cast<T>((msb << 32u) | read_bits(ptr, offset, 32));
   }
   return SRSASN_SUCCESS;
 }
@@ -234,19 +300,21 @@ SRSASN_CODE bit_ref_impl<Ptr>::unpack_bytes(uint8_t* buf, uint32_t n_bytes)
   if (n_bytes == 0) {
     return SRSASN_SUCCESS;
   }
-  if (ptr + n_bytes >= max_ptr) {
+  if (ptr + n_bytes + (offset ? 1 : 0) > max_ptr) {
     log_error("Buffer size limit was achieved\n");
     return SRSASN_ERROR_DECODE_FAIL;
   }
   if (offset == 0) {
     // Aligned case
     memcpy(buf, ptr, n_bytes);
-    ptr += n_bytes;
   } else {
+    // Each output octet straddles two input octets
+    uint32_t rshift = 8u - offset;
     for (uint32_t i = 0; i < n_bytes; ++i) {
-      HANDLE_CODE(unpack(buf[i], 8));
+      buf[i] = static_cast<uint8_t>((ptr[i] << offset) | (ptr[i + 1] >> rshift));
     }
   }
+  ptr += n_bytes;
   return SRSASN_SUCCESS;
 }
 
@@ -297,19 +365,24 @@ SRSASN_CODE bit_ref::pack_bytes(const uint8_t* buf, uint32_t n_bytes)
   if (n_bytes == 0) {
     return SRSASN_SUCCESS;
   }
-  if (ptr + n_bytes >= max_ptr) {
+  if (ptr + n_bytes + (offset ? 1 : 0) > max_ptr) {
     log_error("Buffer size limit was achieved\n");
     return SRSASN_ERROR_ENCODE_FAIL;
   }
   if (offset == 0) {
     // Aligned case
     memcpy(ptr, buf, n_bytes);
-    ptr += n_bytes;
   } else {
+    // Each input octet is split across two output octets, the trailing bits of the last one are zeroed
+    uint32_t rshift = 8u - offset;
+    uint8_t  carry  = static_cast<uint8_t>(*ptr & (0xFFu << rshift));
     for (uint32_t i = 0; i < n_bytes; ++i) {
-      pack(buf[i], 8);
+      ptr[i] = static_cast<uint8_t>(carry | (buf[i] >> offset));
+      carry  = static_cast<uint8_t>(buf[i] << rshift);
     }
+    ptr[n_bytes] = carry;
   }
+  ptr += n_bytes;
   return SRSASN_SUCCESS;
 }
 
@@ -1000,9 +1073,7 @@ template <bool Al>
 SRSASN_CODE unbounded_octstring<Al>::pack(bit_ref& bref) const
 {
   HANDLE_CODE(pack_length(bref, size(), aligned));
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.pack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.pack_bytes(octets_.data(), size()));
   return SRSASN_SUCCESS;
 }
 
@@ -1012,9 +1083,7 @@ SRSASN_CODE unbounded_octstring<Al>::unpack(cbit_ref& bref)
   uint32_t len;
   HANDLE_CODE(unpack_length(len, bref, aligned));
   resize(len);
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.unpack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.unpack_bytes(octets_.data(), size()));
   return SRSASN_SUCCESS;
 }
 
@@ -1097,8 +1166,13 @@ SRSASN_CODE pack_bitfield(bit_ref& bref, const uint8_t* buf, uint32_t nbits, uin
   uint32_t n_octs = ceil_frac(nbits, 8u);
   uint32_t offset = ((nbits - 1) % 8) + 1;
   HANDLE_CODE(bref.pack(buf[n_octs - 1], offset));
-  for (uint32_t i = 1; i < n_octs; ++i) {
-    HANDLE_CODE(bref.pack(buf[n_octs - 1 - i], 8));
+  // the remaining octets are stored in reverse order, pack them in chunks
+  uint8_t chunk[64];
+  for (uint32_t i = 1; i < n_octs;) {
+    uint32_t n = std::min(n_octs - i, (uint32_t)sizeof(chunk));
+    std::reverse_copy(buf + n_octs - i - n, buf + n_octs - i, chunk);
+    HANDLE_CODE(bref.pack_bytes(chunk, n));
+    i += n;
   }
   return SRSASN_SUCCESS;
 }
@@ -1165,9 +1239,9 @@ SRSASN_CODE unpack_bitfield(uint8_t* buf, cbit_ref& bref, uint32_t n, uint32_t l
   uint32_t n_octs = ceil_frac(n, 8u);
   uint32_t offset = ((n - 1) % 8) + 1;
   HANDLE_CODE(bref.unpack(buf[n_octs - 1], offset));
-  for (uint32_t i = 1; i < n_octs; ++i) {
-    HANDLE_CODE(bref.unpack(buf[n_octs - 1 - i], 8));
-  }
+  // the remaining octets are stored in reverse order
+  HANDLE_CODE(bref.unpack_bytes(buf, n_octs - 1));
+  std::reverse(buf, buf + n_octs - 1);
   return SRSASN_SUCCESS;
 }
 
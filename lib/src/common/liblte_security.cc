@@ -37,8 +37,13 @@
 #include "srslte/common/liblte_security.h"
 #include "math.h"
 #include "srslte/common/liblte_ssl.h"
+#include "srslte/common/snow_3g.h"
 #include "srslte/common/zuc.h"
 
+#ifdef __AES__
+#include <wmmintrin.h>
+#endif // __AES__
+
 /*******************************************************************************
                               DEFINES
 *******************************************************************************/
@@ -60,6 +65,16 @@ typedef struct {
   uint32* fsm;
 } S3G_STATE;
 
+struct LIBLTE_SECURITY_AES_KEY_STRUCT {
+#ifdef __AES__
+  __m128i rk[11];
+#else
+  aes_context ctx;
+#endif // __AES__
+  uint8 k1[16];
+  uint8 k2[16];
+};
+
 /*******************************************************************************
                               GLOBAL VARIABLES
 *******************************************************************************/
@@ -1068,6 +1083,315 @@ LIBLTE_ERROR_ENUM liblte_security_decryption_eea2(uint8* key,
   return liblte_security_encryption_eea2(key, count, bearer, direction, ct, ct_len, out);
 }
 
+/*********************************************************************
+    Name: liblte_security_aes_key_alloc
+
+    Description: Expands an AES-128 key once, together with its CMAC
+                 subkeys.
+
+    Document Reference: 33.401 v13.1.0 Annex B.1.3 and B.2.3
+                        RFC4493
+*********************************************************************/
+#ifdef __AES__
+static inline __m128i aesni_key_expansion(__m128i key, __m128i assist)
+{
+  assist = _mm_shuffle_epi32(assist, 0xff);
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key    = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+
+#define AESNI_KEY_EXPANSION(rk, i, rcon) rk[i] = aesni_key_expansion(rk[i - 1], _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+#endif // __AES__
+
+// Encrypts one block per lane, every lane with its own key
+static void aes_encrypt_lanes(LIBLTE_SECURITY_AES_KEY_STRUCT* const* keys, uint8 blk[][16], uint32 nof_lanes)
+{
+#ifdef __AES__
+  __m128i s[LIBLTE_SECURITY_MAX_LANES];
+  uint32  i;
+  uint32  r;
+
+  for (i = 0; i < nof_lanes; i++) {
+    s[i] = _mm_xor_si128(_mm_loadu_si128((__m128i*)blk[i]), keys[i]->rk[0]);
+  }
+  // Interleave the lanes so the AES rounds of different blocks overlap in the pipeline
+  for (r = 1; r < 10; r++) {
+    for (i = 0; i < nof_lanes; i++) {
+      s[i] = _mm_aesenc_si128(s[i], keys[i]->rk[r]);
+    }
+  }
+  for (i = 0; i < nof_lanes; i++) {
+    _mm_storeu_si128((__m128i*)blk[i], _mm_aesenclast_si128(s[i], keys[i]->rk[10]));
+  }
+#else
+  uint8  tmp[16];
+  uint32 i;
+
+  for (i = 0; i < nof_lanes; i++) {
+    aes_crypt_ecb(&keys[i]->ctx, AES_ENCRYPT, blk[i], tmp);
+    memcpy(blk[i], tmp, 16);
+  }
+#endif // __AES__
+}
+
+static void cmac_subkey(uint8* in, uint8* out)
+{
+  uint32 i;
+
+  for (i = 0; i < 15; i++) {
+    out[i] = (in[i] << 1) | ((in[i + 1] >> 7) & 0x01);
+  }
+  out[15] = in[15] << 1;
+  if (in[0] & 0x80) {
+    out[15] ^= 0x87;
+  }
+}
+
+LIBLTE_SECURITY_AES_KEY_STRUCT* liblte_security_aes_key_alloc(uint8* key)
+{
+  LIBLTE_SECURITY_AES_KEY_STRUCT* aes_key = NULL;
+  uint8                           L[1][16];
+
+  if (key != NULL) {
+    aes_key = (LIBLTE_SECURITY_AES_KEY_STRUCT*)calloc(1, sizeof(LIBLTE_SECURITY_AES_KEY_STRUCT));
+  }
+
+  if (aes_key != NULL) {
+#ifdef __AES__
+    aes_key->rk[0] = _mm_loadu_si128((__m128i*)key);
+    AESNI_KEY_EXPANSION(aes_key->rk, 1, 0x01);
+    AESNI_KEY_EXPANSION(aes_key->rk, 2, 0x02);
+    AESNI_KEY_EXPANSION(aes_key->rk, 3, 0x04);
+    AESNI_KEY_EXPANSION(aes_key->rk, 4, 0x08);
+    AESNI_KEY_EXPANSION(aes_key->rk, 5, 0x10);
+    AESNI_KEY_EXPANSION(aes_key->rk, 6, 0x20);
+    AESNI_KEY_EXPANSION(aes_key->rk, 7, 0x40);
+    AESNI_KEY_EXPANSION(aes_key->rk, 8, 0x80);
+    AESNI_KEY_EXPANSION(aes_key->rk, 9, 0x1b);
+    AESNI_KEY_EXPANSION(aes_key->rk, 10, 0x36);
+#else
+    if (aes_setkey_enc(&aes_key->ctx, key, 128) != 0) {
+      free(aes_key);
+      return NULL;
+    }
+#endif // __AES__
+
+    // Subkeys K1 and K2 from L = AES(K, 0)
+    memset(L[0], 0, 16);
+    aes_encrypt_lanes(&aes_key, L, 1);
+    cmac_subkey(L[0], aes_key->k1);
+    cmac_subkey(aes_key->k1, aes_key->k2);
+  }
+
+  return aes_key;
+}
+
+void liblte_security_aes_key_free(LIBLTE_SECURITY_AES_KEY_STRUCT* aes_key)
+{
+  if (aes_key != NULL) {
+    free(aes_key);
+  }
+}
+
+/*********************************************************************
+    Name: liblte_security_encryption_eea2_multi
+
+    Description: 128-bit encryption algorithm EEA2 on a batch of
+                 messages with cached key schedules.
+
+    Document Reference: 33.401 v13.1.0 Annex B.1.3
+*********************************************************************/
+static void eea2_lanes(LIBLTE_SECURITY_AES_KEY_STRUCT* const* keys,
+                       uint8                                  blk[][16],
+                       uint8* const*                          in,
+                       uint8* const*                          out,
+                       const uint32*                          len,
+                       uint32                                 nof_lanes)
+{
+  uint32 i;
+  uint32 j;
+
+  aes_encrypt_lanes(keys, blk, nof_lanes);
+  for (i = 0; i < nof_lanes; i++) {
+    for (j = 0; j < len[i]; j++) {
+      out[i][j] = in[i][j] ^ blk[i][j];
+    }
+  }
+}
+
+LIBLTE_ERROR_ENUM liblte_security_encryption_eea2_multi(LIBLTE_SECURITY_PDU_STRUCT* pdus, uint32 nof_pdus)
+{
+  LIBLTE_SECURITY_AES_KEY_STRUCT* keys[LIBLTE_SECURITY_MAX_LANES];
+  uint8                           blk[LIBLTE_SECURITY_MAX_LANES][16];
+  uint8*                          in[LIBLTE_SECURITY_MAX_LANES];
+  uint8*                          out[LIBLTE_SECURITY_MAX_LANES];
+  uint32                          len[LIBLTE_SECURITY_MAX_LANES];
+  uint32                          nof_lanes = 0;
+  uint32                          nof_bytes;
+  uint32                          i;
+  uint64                          j;
+  uint32                          k;
+
+  if (pdus == NULL) {
+    return LIBLTE_ERROR_INVALID_INPUTS;
+  }
+  for (i = 0; i < nof_pdus; i++) {
+    if (pdus[i].key == NULL || pdus[i].msg == NULL || pdus[i].out == NULL) {
+      return LIBLTE_ERROR_INVALID_INPUTS;
+    }
+  }
+
+  // Every keystream block is independent, fill the lanes with the blocks of all messages
+  for (i = 0; i < nof_pdus; i++) {
+    nof_bytes = (pdus[i].msg_len + 7) / 8;
+    for (j = 0; 16 * j < nof_bytes; j++) {
+      // Counter block, the nonce leaves the 64 least significant bits for the block counter
+      memset(blk[nof_lanes], 0, 16);
+      blk[nof_lanes][0] = (pdus[i].count >> 24) & 0xFF;
+      blk[nof_lanes][1] = (pdus[i].count >> 16) & 0xFF;
+      blk[nof_lanes][2] = (pdus[i].count >> 8) & 0xFF;
+      blk[nof_lanes][3] = (pdus[i].count) & 0xFF;
+      blk[nof_lanes][4] = ((pdus[i].bearer & 0x1F) << 3) | ((pdus[i].direction & 0x01) << 2);
+      for (k = 0; k < 8; k++) {
+        blk[nof_lanes][15 - k] = (j >> (8 * k)) & 0xFF;
+      }
+
+      keys[nof_lanes] = pdus[i].key;
+      in[nof_lanes]   = &pdus[i].msg[16 * j];
+      out[nof_lanes]  = &pdus[i].out[16 * j];
+      len[nof_lanes]  = (nof_bytes - 16 * j < 16) ? (nof_bytes - 16 * j) : 16;
+      nof_lanes++;
+
+      if (nof_lanes == LIBLTE_SECURITY_MAX_LANES) {
+        eea2_lanes(keys, blk, in, out, len, nof_lanes);
+        nof_lanes = 0;
+      }
+    }
+  }
+  if (nof_lanes > 0) {
+    eea2_lanes(keys, blk, in, out, len, nof_lanes);
+  }
+
+  // Zero tailing bits
+  for (i = 0; i < nof_pdus; i++) {
+    if (pdus[i].msg_len > 0) {
+      zero_tailing_bits(pdus[i].out, pdus[i].msg_len);
+    }
+  }
+
+  return LIBLTE_SUCCESS;
+}
+
+/*********************************************************************
+    Name: liblte_security_128_eia2_multi
+
+    Description: 128-bit integrity algorithm EIA2 on a batch of
+                 messages with cached key schedules.
+
+    Document Reference: 33.401 v10.0.0 Annex B.2.3
+                        RFC4493
+*********************************************************************/
+// XORs the block b of M = COUNT | BEARER | DIRECTION | 0 | message into blk, padding and subkey included
+static void eia2_block(const LIBLTE_SECURITY_PDU_STRUCT* pdu, uint32 b, uint32 nof_blocks, uint8* blk)
+{
+  uint32 msg_len = pdu->msg_len;
+  uint32 idx;
+  uint32 k;
+  uint8  m;
+
+  if (b > 0 && 16 * (b + 1) <= msg_len + 8) {
+    // Block fully inside the message
+    for (k = 0; k < 16; k++) {
+      blk[k] ^= pdu->msg[16 * b - 8 + k];
+    }
+  } else {
+    for (k = 0; k < 16; k++) {
+      idx = 16 * b + k;
+      if (idx < 4) {
+        m = (pdu->count >> (24 - 8 * idx)) & 0xFF;
+      } else if (idx == 4) {
+        m = (pdu->bearer << 3) | (pdu->direction << 2);
+      } else if (idx < 8) {
+        m = 0x00;
+      } else if (idx - 8 < msg_len) {
+        m = pdu->msg[idx - 8];
+      } else {
+        m = (idx - 8 == msg_len) ? 0x80 : 0x00;
+      }
+      blk[k] ^= m;
+    }
+  }
+
+  if (b == nof_blocks - 1) {
+    const uint8* subkey = ((msg_len + 8) % 16 == 0) ? pdu->key->k1 : pdu->key->k2;
+    for (k = 0; k < 16; k++) {
+      blk[k] ^= subkey[k];
+    }
+  }
+}
+
+LIBLTE_ERROR_ENUM liblte_security_128_eia2_multi(LIBLTE_SECURITY_PDU_STRUCT* pdus, uint32 nof_pdus)
+{
+  LIBLTE_SECURITY_AES_KEY_STRUCT* keys[LIBLTE_SECURITY_MAX_LANES];
+  uint8                           T[LIBLTE_SECURITY_MAX_LANES][16];
+  uint8                           blk[LIBLTE_SECURITY_MAX_LANES][16];
+  uint32                          nof_blocks[LIBLTE_SECURITY_MAX_LANES];
+  uint32                          lane_idx[LIBLTE_SECURITY_MAX_LANES];
+  uint32                          nof_lanes;
+  uint32                          nof_active;
+  uint32                          max_blocks;
+  uint32                          i;
+  uint32                          l;
+  uint32                          b;
+
+  if (pdus == NULL) {
+    return LIBLTE_ERROR_INVALID_INPUTS;
+  }
+  for (i = 0; i < nof_pdus; i++) {
+    if (pdus[i].key == NULL || pdus[i].msg == NULL || pdus[i].out == NULL) {
+      return LIBLTE_ERROR_INVALID_INPUTS;
+    }
+  }
+
+  // The CMAC chain of each message is sequential, run one message per lane
+  for (i = 0; i < nof_pdus; i += LIBLTE_SECURITY_MAX_LANES) {
+    nof_lanes  = (nof_pdus - i < LIBLTE_SECURITY_MAX_LANES) ? (nof_pdus - i) : LIBLTE_SECURITY_MAX_LANES;
+    max_blocks = 0;
+    for (l = 0; l < nof_lanes; l++) {
+      nof_blocks[l] = (pdus[i + l].msg_len + 8 + 15) / 16;
+      max_blocks    = (nof_blocks[l] > max_blocks) ? nof_blocks[l] : max_blocks;
+      memset(T[l], 0, 16);
+    }
+
+    for (b = 0; b < max_blocks; b++) {
+      nof_active = 0;
+      for (l = 0; l < nof_lanes; l++) {
+        if (b < nof_blocks[l]) {
+          memcpy(blk[nof_active], T[l], 16);
+          eia2_block(&pdus[i + l], b, nof_blocks[l], blk[nof_active]);
+          keys[nof_active]     = pdus[i + l].key;
+          lane_idx[nof_active] = l;
+          nof_active++;
+        }
+      }
+
+      aes_encrypt_lanes(keys, blk, nof_active);
+
+      for (l = 0; l < nof_active; l++) {
+        memcpy(T[lane_idx[l]], blk[l], 16);
+      }
+    }
+
+    for (l = 0; l < nof_lanes; l++) {
+      memcpy(pdus[i + l].out, T[l], 4);
+    }
+  }
+
+  return LIBLTE_SUCCESS;
+}
+
 /*********************************************************************
     Name: liblte_security_encryption_eea1
 
@@ -1421,6 +1745,109 @@ LIBLTE_ERROR_ENUM liblte_security_milenage_f5_star(uint8* k, uint8* op_c, uint8*
   return (err);
 }
 
+/*********************************************************************
+    Name: liblte_security_milenage_multi
+
+    Description: Milenage security functions F1, F2, F3, F4 and F5
+                 on a batch of authentication vectors with cached
+                 key schedules.
+
+    Document Reference: 35.206 v10.0.0 Annex 3
+*********************************************************************/
+static void milenage_lanes(LIBLTE_SECURITY_MILENAGE_STRUCT* vecs, uint32 nof_lanes)
+{
+  // Rotation (in bytes) and constant of OUT2, OUT3 and OUT4
+  static const uint32 rot[3] = {0, 12, 8};
+  static const uint8  c[3]   = {1, 2, 4};
+
+  LIBLTE_SECURITY_AES_KEY_STRUCT* keys[LIBLTE_SECURITY_MAX_LANES];
+  uint8                           temp[LIBLTE_SECURITY_MAX_LANES][16];
+  uint8                           blk[LIBLTE_SECURITY_MAX_LANES][16];
+  uint8                           in1[16];
+  uint32                          i;
+  uint32                          j;
+  uint32                          n;
+
+  // Compute temp
+  for (i = 0; i < nof_lanes; i++) {
+    keys[i] = vecs[i].key;
+    for (j = 0; j < 16; j++) {
+      temp[i][j] = vecs[i].rand[j] ^ vecs[i].op_c[j];
+    }
+  }
+  aes_encrypt_lanes(keys, temp, nof_lanes);
+
+  // Compute out1 for MAC-A
+  for (i = 0; i < nof_lanes; i++) {
+    for (j = 0; j < 6; j++) {
+      in1[j]     = vecs[i].sqn[j];
+      in1[j + 8] = vecs[i].sqn[j];
+    }
+    for (j = 0; j < 2; j++) {
+      in1[j + 6]  = vecs[i].amf[j];
+      in1[j + 14] = vecs[i].amf[j];
+    }
+    for (j = 0; j < 16; j++) {
+      blk[i][(j + 8) % 16] = in1[j] ^ vecs[i].op_c[j];
+    }
+    for (j = 0; j < 16; j++) {
+      blk[i][j] ^= temp[i][j];
+    }
+  }
+  aes_encrypt_lanes(keys, blk, nof_lanes);
+  for (i = 0; i < nof_lanes; i++) {
+    for (j = 0; j < 8; j++) {
+      vecs[i].mac_a[j] = blk[i][j] ^ vecs[i].op_c[j];
+    }
+  }
+
+  // Compute out2 for RES and AK, out3 for CK and out4 for IK
+  for (n = 0; n < 3; n++) {
+    for (i = 0; i < nof_lanes; i++) {
+      for (j = 0; j < 16; j++) {
+        blk[i][(j + rot[n]) % 16] = temp[i][j] ^ vecs[i].op_c[j];
+      }
+      blk[i][15] ^= c[n];
+    }
+    aes_encrypt_lanes(keys, blk, nof_lanes);
+    for (i = 0; i < nof_lanes; i++) {
+      for (j = 0; j < 16; j++) {
+        blk[i][j] ^= vecs[i].op_c[j];
+      }
+      if (n == 0) {
+        memcpy(vecs[i].res, &blk[i][8], 8);
+        memcpy(vecs[i].ak, blk[i], 6);
+      } else if (n == 1) {
+        memcpy(vecs[i].ck, blk[i], 16);
+      } else {
+        memcpy(vecs[i].ik, blk[i], 16);
+      }
+    }
+  }
+}
+
+LIBLTE_ERROR_ENUM liblte_security_milenage_multi(LIBLTE_SECURITY_MILENAGE_STRUCT* vecs, uint32 nof_vecs)
+{
+  uint32 i;
+
+  if (vecs == NULL) {
+    return LIBLTE_ERROR_INVALID_INPUTS;
+  }
+  for (i = 0; i < nof_vecs; i++) {
+    if (vecs[i].key == NULL || vecs[i].op_c == NULL || vecs[i].rand == NULL || vecs[i].sqn == NULL ||
+        vecs[i].amf == NULL || vecs[i].mac_a == NULL || vecs[i].res == NULL || vecs[i].ck == NULL ||
+        vecs[i].ik == NULL || vecs[i].ak == NULL) {
+      return LIBLTE_ERROR_INVALID_INPUTS;
+    }
+  }
+
+  for (i = 0; i < nof_vecs; i += LIBLTE_SECURITY_MAX_LANES) {
+    milenage_lanes(&vecs[i], (nof_vecs - i < LIBLTE_SECURITY_MAX_LANES) ? (nof_vecs - i) : LIBLTE_SECURITY_MAX_LANES);
+  }
+
+  return LIBLTE_SUCCESS;
+}
+
 /*********************************************************************
     Name: liblte_compute_opc
 
@@ -1688,8 +2115,8 @@ uint8 s3g_mul_x_pow(uint8 v, uint8 i, uint8 c)
 *********************************************************************/
 uint32 s3g_mul_alpha(uint8 c)
 {
-  return ((((uint32)s3g_mul_x_pow(c, 23, 0xa9)) << 24) | (((uint32)s3g_mul_x_pow(c, 245, 0xa9)) << 16) |
-          (((uint32)s3g_mul_x_pow(c, 48, 0xa9)) << 8) | (((uint32)s3g_mul_x_pow(c, 239, 0xa9))));
+  // Precomputed, equal to s3g_mul_x_pow(c, 23|245|48|239, 0xa9)
+  return MULalpha(c);
 }
 
 /*********************************************************************
@@ -1703,8 +2130,8 @@ uint32 s3g_mul_alpha(uint8 c)
 *********************************************************************/
 uint32 s3g_div_alpha(uint8 c)
 {
-  return ((((uint32)s3g_mul_x_pow(c, 16, 0xa9)) << 24) | (((uint32)s3g_mul_x_pow(c, 39, 0xa9)) << 16) |
-          (((uint32)s3g_mul_x_pow(c, 6, 0xa9)) << 8) | (((uint32)s3g_mul_x_pow(c, 64, 0xa9))));
+  // Precomputed, equal to s3g_mul_x_pow(c, 16|39|6|64, 0xa9)
+  return DIValpha(c);
 }
 
 /*********************************************************************
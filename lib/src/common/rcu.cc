@@ -0,0 +1,161 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/rcu.h"
+#include <atomic>
+#include <thread>
+
+namespace srslte {
+
+namespace {
+
+const uint32_t max_rcu_readers = 256;
+
+// Epoch announced by a reader thread, zero while it is outside critical sections
+struct alignas(64) reader_slot_t {
+  std::atomic<uint64_t> epoch;
+  std::atomic<bool>     in_use;
+};
+
+reader_slot_t         reader_slots[max_rcu_readers] = {};
+std::atomic<uint64_t> global_epoch{1};
+
+// Slot of the calling thread, claimed on its first critical section and released when the thread exits
+class thread_reader_t
+{
+public:
+  thread_reader_t()
+  {
+    while (slot == nullptr) {
+      for (auto& s : reader_slots) {
+        bool expected = false;
+        if (not s.in_use.load(std::memory_order_relaxed) and s.in_use.compare_exchange_strong(expected, true)) {
+          slot = &s;
+          break;
+        }
+      }
+      if (slot == nullptr) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  ~thread_reader_t()
+  {
+    slot->epoch.store(0, std::memory_order_release);
+    slot->in_use.store(false, std::memory_order_release);
+  }
+
+  reader_slot_t* slot  = nullptr;
+  uint32_t       depth = 0;
+};
+
+thread_reader_t& get_thread_reader()
+{
+  static thread_local thread_reader_t reader;
+  return reader;
+}
+
+// Oldest epoch announced by a reader, or UINT64_MAX if there are no readers
+uint64_t min_reader_epoch()
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  uint64_t min_epoch = UINT64_MAX;
+  for (auto& s : reader_slots) {
+    uint64_t e = s.epoch.load(std::memory_order_acquire);
+    if (e != 0 and e < min_epoch) {
+      min_epoch = e;
+    }
+  }
+  return min_epoch;
+}
+
+} // namespace
+
+void rcu_read_lock()
+{
+  thread_reader_t& reader = get_thread_reader();
+  if (reader.depth++ == 0) {
+    reader.slot->epoch.store(global_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+    // Makes the announced epoch visible to writers before any RCU-protected pointer is read
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+void rcu_read_unlock()
+{
+  thread_reader_t& reader = get_thread_reader();
+  if (--reader.depth == 0) {
+    reader.slot->epoch.store(0, std::memory_order_release);
+  }
+}
+
+void rcu_reclaimer::retire(void* ptr, void (*deleter)(void*))
+{
+  // Readers announcing a later epoch started after the object was unlinked
+  uint64_t epoch = global_epoch.fetch_add(1, std::memory_order_seq_cst);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  retired.push_back({ptr, deleter, epoch});
+}
+
+size_t rcu_reclaimer::reclaim()
+{
+  std::vector<retired_t> expired;
+  size_t                 nof_pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (retired.empty()) {
+      return 0;
+    }
+    uint64_t min_epoch = min_reader_epoch();
+    size_t   n         = 0;
+    for (auto& r : retired) {
+      if (r.epoch < min_epoch) {
+        expired.push_back(r);
+      } else {
+        retired[n++] = r;
+      }
+    }
+    retired.resize(n);
+    nof_pending = n;
+  }
+
+  // Deleters run unlocked, they may retire other objects
+  for (auto& r : expired) {
+    r.deleter(r.ptr);
+  }
+  return nof_pending;
+}
+
+void rcu_reclaimer::synchronize()
+{
+  while (reclaim() > 0) {
+    std::this_thread::yield();
+  }
+}
+
+size_t rcu_reclaimer::nof_pending() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return retired.size();
+}
+
+} // namespace srslte
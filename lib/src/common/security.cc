@@ -22,6 +22,7 @@
 #include "srslte/common/security.h"
 #include "srslte/common/liblte_security.h"
 #include "srslte/common/snow_3g.h"
+#include <algorithm>
 
 #ifdef HAVE_MBEDTLS
 #include "mbedtls/md5.h"
@@ -114,14 +115,9 @@ uint8_t security_128_eia1(uint8_t* key,
                           uint8_t* mac)
 {
   uint32_t msg_len_bits;
-  uint32_t i;
-  uint8_t* m_ptr;
 
   msg_len_bits = msg_len * 8;
-  m_ptr        = snow3g_f9(key, count, bearer << 27, direction, msg, msg_len_bits);
-  for (i = 0; i < 4; i++) {
-    mac[i] = m_ptr[i];
-  }
+  snow3g_f9(key, count, bearer << 27, direction, msg, msg_len_bits, mac);
   return SRSLTE_SUCCESS;
 }
 
@@ -199,6 +195,94 @@ uint8_t security_128_eea3(uint8_t* key,
   return liblte_security_encryption_eea3(key, count, bearer, direction, msg, msg_len * 8, msg_out);
 }
 
+/******************************************************************************
+ * Cached AES key schedules and multi-buffer EEA2/EIA2
+ *****************************************************************************/
+
+security_aes_key::~security_aes_key()
+{
+  reset();
+}
+
+void security_aes_key::set_key(uint8_t* key)
+{
+  reset();
+  aes_key = liblte_security_aes_key_alloc(key);
+}
+
+void security_aes_key::reset()
+{
+  liblte_security_aes_key_free(aes_key);
+  aes_key = nullptr;
+}
+
+// Converts a batch of PDUs to the liblte representation, LIBLTE_SECURITY_MAX_LANES * 4 at a time
+static uint8_t security_run_multi(security_pdu_t* pdus,
+                                  uint32_t        nof_pdus,
+                                  uint32_t        len_scale,
+                                  LIBLTE_ERROR_ENUM (*func)(LIBLTE_SECURITY_PDU_STRUCT*, uint32))
+{
+  const uint32_t             batch_size = LIBLTE_SECURITY_MAX_LANES * 4;
+  LIBLTE_SECURITY_PDU_STRUCT batch[batch_size];
+
+  for (uint32_t i = 0; i < nof_pdus; i += batch_size) {
+    uint32_t n = std::min(batch_size, nof_pdus - i);
+    for (uint32_t j = 0; j < n; j++) {
+      if (pdus[i + j].key == nullptr) {
+        return LIBLTE_ERROR_INVALID_INPUTS;
+      }
+      batch[j].key       = pdus[i + j].key->get();
+      batch[j].count     = pdus[i + j].count;
+      batch[j].bearer    = pdus[i + j].bearer;
+      batch[j].direction = pdus[i + j].direction;
+      batch[j].msg       = pdus[i + j].msg;
+      batch[j].msg_len   = pdus[i + j].msg_len * len_scale;
+      batch[j].out       = pdus[i + j].out;
+    }
+
+    LIBLTE_ERROR_ENUM err = func(batch, n);
+    if (err != LIBLTE_SUCCESS) {
+      return err;
+    }
+  }
+
+  return LIBLTE_SUCCESS;
+}
+
+uint8_t security_128_eia2(const security_aes_key& key,
+                          uint32_t                count,
+                          uint32_t                bearer,
+                          uint8_t                 direction,
+                          uint8_t*                msg,
+                          uint32_t                msg_len,
+                          uint8_t*                mac)
+{
+  security_pdu_t pdu = {&key, count, (uint8_t)bearer, direction, msg, msg_len, mac};
+  return security_128_eia2_multi(&pdu, 1);
+}
+
+uint8_t security_128_eea2(const security_aes_key& key,
+                          uint32_t                count,
+                          uint8_t                 bearer,
+                          uint8_t                 direction,
+                          uint8_t*                msg,
+                          uint32_t                msg_len,
+                          uint8_t*                msg_out)
+{
+  security_pdu_t pdu = {&key, count, bearer, direction, msg, msg_len, msg_out};
+  return security_128_eea2_multi(&pdu, 1);
+}
+
+uint8_t security_128_eia2_multi(security_pdu_t* pdus, uint32_t nof_pdus)
+{
+  return security_run_multi(pdus, nof_pdus, 1, liblte_security_128_eia2_multi);
+}
+
+uint8_t security_128_eea2_multi(security_pdu_t* pdus, uint32_t nof_pdus)
+{
+  return security_run_multi(pdus, nof_pdus, 8, liblte_security_encryption_eea2_multi);
+}
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
@@ -228,4 +312,36 @@ uint8_t security_milenage_f5_star(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_
   return liblte_security_milenage_f5_star(k, op, rand, ak);
 }
 
+uint8_t security_milenage_multi(security_milenage_t* vecs, uint32_t nof_vecs)
+{
+  const uint32_t                  batch_size = LIBLTE_SECURITY_MAX_LANES * 4;
+  LIBLTE_SECURITY_MILENAGE_STRUCT batch[batch_size];
+
+  for (uint32_t i = 0; i < nof_vecs; i += batch_size) {
+    uint32_t n = std::min(batch_size, nof_vecs - i);
+    for (uint32_t j = 0; j < n; j++) {
+      if (vecs[i + j].key == nullptr) {
+        return LIBLTE_ERROR_INVALID_INPUTS;
+      }
+      batch[j].key   = vecs[i + j].key->get();
+      batch[j].op_c  = vecs[i + j].opc;
+      batch[j].rand  = vecs[i + j].rand;
+      batch[j].sqn   = vecs[i + j].sqn;
+      batch[j].amf   = vecs[i + j].amf;
+      batch[j].mac_a = vecs[i + j].mac_a;
+      batch[j].res   = vecs[i + j].res;
+      batch[j].ck    = vecs[i + j].ck;
+      batch[j].ik    = vecs[i + j].ik;
+      batch[j].ak    = vecs[i + j].ak;
+    }
+
+    LIBLTE_ERROR_ENUM err = liblte_security_milenage_multi(batch, n);
+    if (err != LIBLTE_SUCCESS) {
+      return err;
+    }
+  }
+
+  return LIBLTE_SUCCESS;
+}
+
 } // namespace srslte
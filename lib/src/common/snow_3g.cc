@@ -12,31 +12,6 @@
 
 #include "srslte/common/snow_3g.h"
 
-/* LFSR */
-
-u32 LFSR_S0  = 0x00;
-u32 LFSR_S1  = 0x00;
-u32 LFSR_S2  = 0x00;
-u32 LFSR_S3  = 0x00;
-u32 LFSR_S4  = 0x00;
-u32 LFSR_S5  = 0x00;
-u32 LFSR_S6  = 0x00;
-u32 LFSR_S7  = 0x00;
-u32 LFSR_S8  = 0x00;
-u32 LFSR_S9  = 0x00;
-u32 LFSR_S10 = 0x00;
-u32 LFSR_S11 = 0x00;
-u32 LFSR_S12 = 0x00;
-u32 LFSR_S13 = 0x00;
-u32 LFSR_S14 = 0x00;
-u32 LFSR_S15 = 0x00;
-
-/* FSM */
-
-u32 FSM_R1 = 0x00;
-u32 FSM_R2 = 0x00;
-u32 FSM_R3 = 0x00;
-
 /* Rijndael S-box SR */
 
 static u8 snow_3g_SR[256] = {
@@ -73,6 +48,76 @@ static u8 snow_3g_SQ[256] = {
     0xEC, 0x33, 0x12, 0xDE, 0x98, 0x3B, 0xC0, 0x9B, 0x3E, 0x18, 0x10, 0x3A, 0x56, 0xE1, 0x77, 0xC9, 0x1E, 0x9E, 0x95,
     0xA3, 0x90, 0x19, 0xA8, 0x6C, 0x09, 0xD0, 0xF0, 0x86};
 
+/* Tables of the MUL alpha and DIV alpha functions, section 3.4.2 and 3.4.3 */
+
+static const u32 snow_3g_MULalpha[256] = {
+    0x00000000, 0xe19fcf13, 0x6b973726, 0x8a08f835, 0xd6876e4c, 0x3718a15f, 0xbd10596a, 0x5c8f9679,
+    0x05a7dc98, 0xe438138b, 0x6e30ebbe, 0x8faf24ad, 0xd320b2d4, 0x32bf7dc7, 0xb8b785f2, 0x59284ae1,
+    0x0ae71199, 0xeb78de8a, 0x617026bf, 0x80efe9ac, 0xdc607fd5, 0x3dffb0c6, 0xb7f748f3, 0x566887e0,
+    0x0f40cd01, 0xeedf0212, 0x64d7fa27, 0x85483534, 0xd9c7a34d, 0x38586c5e, 0xb250946b, 0x53cf5b78,
+    0x1467229b, 0xf5f8ed88, 0x7ff015bd, 0x9e6fdaae, 0xc2e04cd7, 0x237f83c4, 0xa9777bf1, 0x48e8b4e2,
+    0x11c0fe03, 0xf05f3110, 0x7a57c925, 0x9bc80636, 0xc747904f, 0x26d85f5c, 0xacd0a769, 0x4d4f687a,
+    0x1e803302, 0xff1ffc11, 0x75170424, 0x9488cb37, 0xc8075d4e, 0x2998925d, 0xa3906a68, 0x420fa57b,
+    0x1b27ef9a, 0xfab82089, 0x70b0d8bc, 0x912f17af, 0xcda081d6, 0x2c3f4ec5, 0xa637b6f0, 0x47a879e3,
+    0x28ce449f, 0xc9518b8c, 0x435973b9, 0xa2c6bcaa, 0xfe492ad3, 0x1fd6e5c0, 0x95de1df5, 0x7441d2e6,
+    0x2d699807, 0xccf65714, 0x46feaf21, 0xa7616032, 0xfbeef64b, 0x1a713958, 0x9079c16d, 0x71e60e7e,
+    0x22295506, 0xc3b69a15, 0x49be6220, 0xa821ad33, 0xf4ae3b4a, 0x1531f459, 0x9f390c6c, 0x7ea6c37f,
+    0x278e899e, 0xc611468d, 0x4c19beb8, 0xad8671ab, 0xf109e7d2, 0x109628c1, 0x9a9ed0f4, 0x7b011fe7,
+    0x3ca96604, 0xdd36a917, 0x573e5122, 0xb6a19e31, 0xea2e0848, 0x0bb1c75b, 0x81b93f6e, 0x6026f07d,
+    0x390eba9c, 0xd891758f, 0x52998dba, 0xb30642a9, 0xef89d4d0, 0x0e161bc3, 0x841ee3f6, 0x65812ce5,
+    0x364e779d, 0xd7d1b88e, 0x5dd940bb, 0xbc468fa8, 0xe0c919d1, 0x0156d6c2, 0x8b5e2ef7, 0x6ac1e1e4,
+    0x33e9ab05, 0xd2766416, 0x587e9c23, 0xb9e15330, 0xe56ec549, 0x04f10a5a, 0x8ef9f26f, 0x6f663d7c,
+    0x50358897, 0xb1aa4784, 0x3ba2bfb1, 0xda3d70a2, 0x86b2e6db, 0x672d29c8, 0xed25d1fd, 0x0cba1eee,
+    0x5592540f, 0xb40d9b1c, 0x3e056329, 0xdf9aac3a, 0x83153a43, 0x628af550, 0xe8820d65, 0x091dc276,
+    0x5ad2990e, 0xbb4d561d, 0x3145ae28, 0xd0da613b, 0x8c55f742, 0x6dca3851, 0xe7c2c064, 0x065d0f77,
+    0x5f754596, 0xbeea8a85, 0x34e272b0, 0xd57dbda3, 0x89f22bda, 0x686de4c9, 0xe2651cfc, 0x03fad3ef,
+    0x4452aa0c, 0xa5cd651f, 0x2fc59d2a, 0xce5a5239, 0x92d5c440, 0x734a0b53, 0xf942f366, 0x18dd3c75,
+    0x41f57694, 0xa06ab987, 0x2a6241b2, 0xcbfd8ea1, 0x977218d8, 0x76edd7cb, 0xfce52ffe, 0x1d7ae0ed,
+    0x4eb5bb95, 0xaf2a7486, 0x25228cb3, 0xc4bd43a0, 0x9832d5d9, 0x79ad1aca, 0xf3a5e2ff, 0x123a2dec,
+    0x4b12670d, 0xaa8da81e, 0x2085502b, 0xc11a9f38, 0x9d950941, 0x7c0ac652, 0xf6023e67, 0x179df174,
+    0x78fbcc08, 0x9964031b, 0x136cfb2e, 0xf2f3343d, 0xae7ca244, 0x4fe36d57, 0xc5eb9562, 0x24745a71,
+    0x7d5c1090, 0x9cc3df83, 0x16cb27b6, 0xf754e8a5, 0xabdb7edc, 0x4a44b1cf, 0xc04c49fa, 0x21d386e9,
+    0x721cdd91, 0x93831282, 0x198beab7, 0xf81425a4, 0xa49bb3dd, 0x45047cce, 0xcf0c84fb, 0x2e934be8,
+    0x77bb0109, 0x9624ce1a, 0x1c2c362f, 0xfdb3f93c, 0xa13c6f45, 0x40a3a056, 0xcaab5863, 0x2b349770,
+    0x6c9cee93, 0x8d032180, 0x070bd9b5, 0xe69416a6, 0xba1b80df, 0x5b844fcc, 0xd18cb7f9, 0x301378ea,
+    0x693b320b, 0x88a4fd18, 0x02ac052d, 0xe333ca3e, 0xbfbc5c47, 0x5e239354, 0xd42b6b61, 0x35b4a472,
+    0x667bff0a, 0x87e43019, 0x0decc82c, 0xec73073f, 0xb0fc9146, 0x51635e55, 0xdb6ba660, 0x3af46973,
+    0x63dc2392, 0x8243ec81, 0x084b14b4, 0xe9d4dba7, 0xb55b4dde, 0x54c482cd, 0xdecc7af8, 0x3f53b5eb};
+
+static const u32 snow_3g_DIValpha[256] = {
+    0x00000000, 0x180f40cd, 0x301e8033, 0x2811c0fe, 0x603ca966, 0x7833e9ab, 0x50222955, 0x482d6998,
+    0xc078fbcc, 0xd877bb01, 0xf0667bff, 0xe8693b32, 0xa04452aa, 0xb84b1267, 0x905ad299, 0x88559254,
+    0x29f05f31, 0x31ff1ffc, 0x19eedf02, 0x01e19fcf, 0x49ccf657, 0x51c3b69a, 0x79d27664, 0x61dd36a9,
+    0xe988a4fd, 0xf187e430, 0xd99624ce, 0xc1996403, 0x89b40d9b, 0x91bb4d56, 0xb9aa8da8, 0xa1a5cd65,
+    0x5249be62, 0x4a46feaf, 0x62573e51, 0x7a587e9c, 0x32751704, 0x2a7a57c9, 0x026b9737, 0x1a64d7fa,
+    0x923145ae, 0x8a3e0563, 0xa22fc59d, 0xba208550, 0xf20decc8, 0xea02ac05, 0xc2136cfb, 0xda1c2c36,
+    0x7bb9e153, 0x63b6a19e, 0x4ba76160, 0x53a821ad, 0x1b854835, 0x038a08f8, 0x2b9bc806, 0x339488cb,
+    0xbbc11a9f, 0xa3ce5a52, 0x8bdf9aac, 0x93d0da61, 0xdbfdb3f9, 0xc3f2f334, 0xebe333ca, 0xf3ec7307,
+    0xa492d5c4, 0xbc9d9509, 0x948c55f7, 0x8c83153a, 0xc4ae7ca2, 0xdca13c6f, 0xf4b0fc91, 0xecbfbc5c,
+    0x64ea2e08, 0x7ce56ec5, 0x54f4ae3b, 0x4cfbeef6, 0x04d6876e, 0x1cd9c7a3, 0x34c8075d, 0x2cc74790,
+    0x8d628af5, 0x956dca38, 0xbd7c0ac6, 0xa5734a0b, 0xed5e2393, 0xf551635e, 0xdd40a3a0, 0xc54fe36d,
+    0x4d1a7139, 0x551531f4, 0x7d04f10a, 0x650bb1c7, 0x2d26d85f, 0x35299892, 0x1d38586c, 0x053718a1,
+    0xf6db6ba6, 0xeed42b6b, 0xc6c5eb95, 0xdecaab58, 0x96e7c2c0, 0x8ee8820d, 0xa6f942f3, 0xbef6023e,
+    0x36a3906a, 0x2eacd0a7, 0x06bd1059, 0x1eb25094, 0x569f390c, 0x4e9079c1, 0x6681b93f, 0x7e8ef9f2,
+    0xdf2b3497, 0xc724745a, 0xef35b4a4, 0xf73af469, 0xbf179df1, 0xa718dd3c, 0x8f091dc2, 0x97065d0f,
+    0x1f53cf5b, 0x075c8f96, 0x2f4d4f68, 0x37420fa5, 0x7f6f663d, 0x676026f0, 0x4f71e60e, 0x577ea6c3,
+    0xe18d0321, 0xf98243ec, 0xd1938312, 0xc99cc3df, 0x81b1aa47, 0x99beea8a, 0xb1af2a74, 0xa9a06ab9,
+    0x21f5f8ed, 0x39fab820, 0x11eb78de, 0x09e43813, 0x41c9518b, 0x59c61146, 0x71d7d1b8, 0x69d89175,
+    0xc87d5c10, 0xd0721cdd, 0xf863dc23, 0xe06c9cee, 0xa841f576, 0xb04eb5bb, 0x985f7545, 0x80503588,
+    0x0805a7dc, 0x100ae711, 0x381b27ef, 0x20146722, 0x68390eba, 0x70364e77, 0x58278e89, 0x4028ce44,
+    0xb3c4bd43, 0xabcbfd8e, 0x83da3d70, 0x9bd57dbd, 0xd3f81425, 0xcbf754e8, 0xe3e69416, 0xfbe9d4db,
+    0x73bc468f, 0x6bb30642, 0x43a2c6bc, 0x5bad8671, 0x1380efe9, 0x0b8faf24, 0x239e6fda, 0x3b912f17,
+    0x9a34e272, 0x823ba2bf, 0xaa2a6241, 0xb225228c, 0xfa084b14, 0xe2070bd9, 0xca16cb27, 0xd2198bea,
+    0x5a4c19be, 0x42435973, 0x6a52998d, 0x725dd940, 0x3a70b0d8, 0x227ff015, 0x0a6e30eb, 0x12617026,
+    0x451fd6e5, 0x5d109628, 0x750156d6, 0x6d0e161b, 0x25237f83, 0x3d2c3f4e, 0x153dffb0, 0x0d32bf7d,
+    0x85672d29, 0x9d686de4, 0xb579ad1a, 0xad76edd7, 0xe55b844f, 0xfd54c482, 0xd545047c, 0xcd4a44b1,
+    0x6cef89d4, 0x74e0c919, 0x5cf109e7, 0x44fe492a, 0x0cd320b2, 0x14dc607f, 0x3ccda081, 0x24c2e04c,
+    0xac977218, 0xb49832d5, 0x9c89f22b, 0x8486b2e6, 0xccabdb7e, 0xd4a49bb3, 0xfcb55b4d, 0xe4ba1b80,
+    0x17566887, 0x0f59284a, 0x2748e8b4, 0x3f47a879, 0x776ac1e1, 0x6f65812c, 0x477441d2, 0x5f7b011f,
+    0xd72e934b, 0xcf21d386, 0xe7301378, 0xff3f53b5, 0xb7123a2d, 0xaf1d7ae0, 0x870cba1e, 0x9f03fad3,
+    0x3ea637b6, 0x26a9777b, 0x0eb8b785, 0x16b7f748, 0x5e9a9ed0, 0x4695de1d, 0x6e841ee3, 0x768b5e2e,
+    0xfedecc7a, 0xe6d18cb7, 0xcec04c49, 0xd6cf0c84, 0x9ee2651c, 0x86ed25d1, 0xaefce52f, 0xb6f3a5e2};
+
 /* MULx.
  * Input V: an 8-bit input.
  * Input c: an 8-bit input.
@@ -107,25 +152,23 @@ u8 MULxPOW(u8 V, u8 i, u8 c)
 /* The function MUL alpha.
  * Input c: 8-bit input.
  * Output : 32-bit output.
- * See section 3.4.2 for details.
+ * Looks up the table of MULxPOW(c, 23|245|48|239, 0xa9), see section 3.4.2 for details.
  */
 
 u32 MULalpha(u8 c)
 {
-  return ((((u32)MULxPOW(c, 23, 0xa9)) << 24) | (((u32)MULxPOW(c, 245, 0xa9)) << 16) |
-          (((u32)MULxPOW(c, 48, 0xa9)) << 8) | (((u32)MULxPOW(c, 239, 0xa9))));
+  return snow_3g_MULalpha[c];
 }
 
 /* The function DIV alpha.
  * Input c: 8-bit input.
  * Output : 32-bit output.
- * See section 3.4.3 for details.
+ * Looks up the table of MULxPOW(c, 16|39|6|64, 0xa9), see section 3.4.3 for details.
  */
 
 u32 DIValpha(u8 c)
 {
-  return ((((u32)MULxPOW(c, 16, 0xa9)) << 24) | (((u32)MULxPOW(c, 39, 0xa9)) << 16) |
-          (((u32)MULxPOW(c, 6, 0xa9)) << 8) | (((u32)MULxPOW(c, 64, 0xa9))));
+  return snow_3g_DIValpha[c];
 }
 
 /* The 32x32-bit S-Box S1
@@ -175,26 +218,26 @@ u32 S2(u32 w)
  * See section 3.4.4.
  */
 
-void ClockLFSRInitializationMode(u32 F)
+static inline void ClockLFSRInitializationMode(snow3g_state_t* state, u32 F)
 {
-  u32 v    = (((LFSR_S0 << 8) & 0xffffff00) ^ (MULalpha((u8)((LFSR_S0 >> 24) & 0xff))) ^ (LFSR_S2) ^
-           ((LFSR_S11 >> 8) & 0x00ffffff) ^ (DIValpha((u8)((LFSR_S11)&0xff))) ^ (F));
-  LFSR_S0  = LFSR_S1;
-  LFSR_S1  = LFSR_S2;
-  LFSR_S2  = LFSR_S3;
-  LFSR_S3  = LFSR_S4;
-  LFSR_S4  = LFSR_S5;
-  LFSR_S5  = LFSR_S6;
-  LFSR_S6  = LFSR_S7;
-  LFSR_S7  = LFSR_S8;
-  LFSR_S8  = LFSR_S9;
-  LFSR_S9  = LFSR_S10;
-  LFSR_S10 = LFSR_S11;
-  LFSR_S11 = LFSR_S12;
-  LFSR_S12 = LFSR_S13;
-  LFSR_S13 = LFSR_S14;
-  LFSR_S14 = LFSR_S15;
-  LFSR_S15 = v;
+  u32 v = (((state->LFSR_S0 << 8) & 0xffffff00) ^ (MULalpha((u8)((state->LFSR_S0 >> 24) & 0xff))) ^
+           (state->LFSR_S2) ^ ((state->LFSR_S11 >> 8) & 0x00ffffff) ^ (DIValpha((u8)((state->LFSR_S11)&0xff))) ^ (F));
+  state->LFSR_S0  = state->LFSR_S1;
+  state->LFSR_S1  = state->LFSR_S2;
+  state->LFSR_S2  = state->LFSR_S3;
+  state->LFSR_S3  = state->LFSR_S4;
+  state->LFSR_S4  = state->LFSR_S5;
+  state->LFSR_S5  = state->LFSR_S6;
+  state->LFSR_S6  = state->LFSR_S7;
+  state->LFSR_S7  = state->LFSR_S8;
+  state->LFSR_S8  = state->LFSR_S9;
+  state->LFSR_S9  = state->LFSR_S10;
+  state->LFSR_S10 = state->LFSR_S11;
+  state->LFSR_S11 = state->LFSR_S12;
+  state->LFSR_S12 = state->LFSR_S13;
+  state->LFSR_S13 = state->LFSR_S14;
+  state->LFSR_S14 = state->LFSR_S15;
+  state->LFSR_S15 = v;
 }
 
 /* Clocking LFSR in keystream mode.
@@ -202,26 +245,26 @@ void ClockLFSRInitializationMode(u32 F)
  * See section 3.4.5.
  */
 
-void ClockLFSRKeyStreamMode()
+static inline void ClockLFSRKeyStreamMode(snow3g_state_t* state)
 {
-  u32 v    = (((LFSR_S0 << 8) & 0xffffff00) ^ (MULalpha((u8)((LFSR_S0 >> 24) & 0xff))) ^ (LFSR_S2) ^
-           ((LFSR_S11 >> 8) & 0x00ffffff) ^ (DIValpha((u8)((LFSR_S11)&0xff))));
-  LFSR_S0  = LFSR_S1;
-  LFSR_S1  = LFSR_S2;
-  LFSR_S2  = LFSR_S3;
-  LFSR_S3  = LFSR_S4;
-  LFSR_S4  = LFSR_S5;
-  LFSR_S5  = LFSR_S6;
-  LFSR_S6  = LFSR_S7;
-  LFSR_S7  = LFSR_S8;
-  LFSR_S8  = LFSR_S9;
-  LFSR_S9  = LFSR_S10;
-  LFSR_S10 = LFSR_S11;
-  LFSR_S11 = LFSR_S12;
-  LFSR_S12 = LFSR_S13;
-  LFSR_S13 = LFSR_S14;
-  LFSR_S14 = LFSR_S15;
-  LFSR_S15 = v;
+  u32 v = (((state->LFSR_S0 << 8) & 0xffffff00) ^ (MULalpha((u8)((state->LFSR_S0 >> 24) & 0xff))) ^
+           (state->LFSR_S2) ^ ((state->LFSR_S11 >> 8) & 0x00ffffff) ^ (DIValpha((u8)((state->LFSR_S11)&0xff))));
+  state->LFSR_S0  = state->LFSR_S1;
+  state->LFSR_S1  = state->LFSR_S2;
+  state->LFSR_S2  = state->LFSR_S3;
+  state->LFSR_S3  = state->LFSR_S4;
+  state->LFSR_S4  = state->LFSR_S5;
+  state->LFSR_S5  = state->LFSR_S6;
+  state->LFSR_S6  = state->LFSR_S7;
+  state->LFSR_S7  = state->LFSR_S8;
+  state->LFSR_S8  = state->LFSR_S9;
+  state->LFSR_S9  = state->LFSR_S10;
+  state->LFSR_S10 = state->LFSR_S11;
+  state->LFSR_S11 = state->LFSR_S12;
+  state->LFSR_S12 = state->LFSR_S13;
+  state->LFSR_S13 = state->LFSR_S14;
+  state->LFSR_S14 = state->LFSR_S15;
+  state->LFSR_S15 = v;
 }
 
 /* Clocking FSM.
@@ -230,13 +273,13 @@ void ClockLFSRKeyStreamMode()
  * See Section 3.4.6.
  */
 
-u32 ClockFSM()
+static inline u32 ClockFSM(snow3g_state_t* state)
 {
-  u32 F  = ((LFSR_S15 + FSM_R1) & 0xffffffff) ^ FSM_R2;
-  u32 r  = (FSM_R2 + (FSM_R3 ^ LFSR_S5)) & 0xffffffff;
-  FSM_R3 = S2(FSM_R2);
-  FSM_R2 = S1(FSM_R1);
-  FSM_R1 = r;
+  u32 F         = ((state->LFSR_S15 + state->FSM_R1) & 0xffffffff) ^ state->FSM_R2;
+  u32 r         = (state->FSM_R2 + (state->FSM_R3 ^ state->LFSR_S5)) & 0xffffffff;
+  state->FSM_R3 = S2(state->FSM_R2);
+  state->FSM_R2 = S1(state->FSM_R1);
+  state->FSM_R1 = r;
   return F;
 }
 
@@ -247,32 +290,32 @@ u32 ClockFSM()
  * See Section 4.1.
  */
 
-void snow3g_initialize(u32 k[4], u32 IV[4])
+void snow3g_initialize(snow3g_state_t* state, u32 k[4], u32 IV[4])
 {
-  u8  i    = 0;
-  u32 F    = 0x0;
-  LFSR_S15 = k[3] ^ IV[0];
-  LFSR_S14 = k[2];
-  LFSR_S13 = k[1];
-  LFSR_S12 = k[0] ^ IV[1];
-  LFSR_S11 = k[3] ^ 0xffffffff;
-  LFSR_S10 = k[2] ^ 0xffffffff ^ IV[2];
-  LFSR_S9  = k[1] ^ 0xffffffff ^ IV[3];
-  LFSR_S8  = k[0] ^ 0xffffffff;
-  LFSR_S7  = k[3];
-  LFSR_S6  = k[2];
-  LFSR_S5  = k[1];
-  LFSR_S4  = k[0];
-  LFSR_S3  = k[3] ^ 0xffffffff;
-  LFSR_S2  = k[2] ^ 0xffffffff;
-  LFSR_S1  = k[1] ^ 0xffffffff;
-  LFSR_S0  = k[0] ^ 0xffffffff;
-  FSM_R1   = 0x0;
-  FSM_R2   = 0x0;
-  FSM_R3   = 0x0;
+  u8  i           = 0;
+  u32 F           = 0x0;
+  state->LFSR_S15 = k[3] ^ IV[0];
+  state->LFSR_S14 = k[2];
+  state->LFSR_S13 = k[1];
+  state->LFSR_S12 = k[0] ^ IV[1];
+  state->LFSR_S11 = k[3] ^ 0xffffffff;
+  state->LFSR_S10 = k[2] ^ 0xffffffff ^ IV[2];
+  state->LFSR_S9  = k[1] ^ 0xffffffff ^ IV[3];
+  state->LFSR_S8  = k[0] ^ 0xffffffff;
+  state->LFSR_S7  = k[3];
+  state->LFSR_S6  = k[2];
+  state->LFSR_S5  = k[1];
+  state->LFSR_S4  = k[0];
+  state->LFSR_S3  = k[3] ^ 0xffffffff;
+  state->LFSR_S2  = k[2] ^ 0xffffffff;
+  state->LFSR_S1  = k[1] ^ 0xffffffff;
+  state->LFSR_S0  = k[0] ^ 0xffffffff;
+  state->FSM_R1   = 0x0;
+  state->FSM_R2   = 0x0;
+  state->FSM_R3   = 0x0;
   for (i = 0; i < 32; i++) {
-    F = ClockFSM();
-    ClockLFSRInitializationMode(F);
+    F = ClockFSM(state);
+    ClockLFSRInitializationMode(state, F);
   }
 }
 
@@ -284,18 +327,18 @@ void snow3g_initialize(u32 k[4], u32 IV[4])
  * See section 4.2.
  */
 
-void snow3g_generate_keystream(u32 n, u32* ks)
+void snow3g_generate_keystream(snow3g_state_t* state, u32 n, u32* ks)
 {
   u32 t = 0;
   u32 F = 0x0;
-  ClockFSM();               /* Clock FSM once. Discard the output. */
-  ClockLFSRKeyStreamMode(); /* Clock LFSR in keystream mode once. */
+  ClockFSM(state);               /* Clock FSM once. Discard the output. */
+  ClockLFSRKeyStreamMode(state); /* Clock LFSR in keystream mode once. */
   for (t = 0; t < n; t++) {
-    F     = ClockFSM();  /* STEP 1 */
-    ks[t] = F ^ LFSR_S0; /* STEP 2 */
+    F     = ClockFSM(state);    /* STEP 1 */
+    ks[t] = F ^ state->LFSR_S0; /* STEP 2 */
     /* Note that ks[t] corresponds to z_{t+1} in section 4.2
      */
-    ClockLFSRKeyStreamMode(); /* STEP 3 */
+    ClockLFSRKeyStreamMode(state); /* STEP 3 */
   }
 }
 
@@ -315,11 +358,12 @@ void snow3g_generate_keystream(u32 n, u32* ks)
 
 void snow3g_f8(u8* key, u32 count, u32 bearer, u32 dir, u8* data, u32 length)
 {
-  u32  K[4], IV[4];
-  int  n        = (length + 31) / 32;
-  int  i        = 0;
-  int  lastbits = (8 - (length % 8)) % 8;
-  u32* KS;
+  snow3g_state_t state;
+  u32            K[4], IV[4];
+  int            n        = (length + 31) / 32;
+  int            i        = 0;
+  int            lastbits = (8 - (length % 8)) % 8;
+  u32*           KS;
 
   /*Initialisation*/
   /* Load the confidentiality key for SNOW 3G initialization as in section
@@ -335,9 +379,9 @@ void snow3g_f8(u8* key, u32 count, u32 bearer, u32 dir, u8* data, u32 length)
   IV[0] = IV[2];
 
   /* Run SNOW 3G algorithm to generate sequence of key stream bits KS*/
-  snow3g_initialize(K, IV);
+  snow3g_initialize(&state, K, IV);
   KS = (u32*)malloc(4 * n);
-  snow3g_generate_keystream(n, (u32*)KS);
+  snow3g_generate_keystream(&state, n, (u32*)KS);
 
   /* Exclusive-OR the input data with keystream to generate the output bit
   stream */
@@ -409,6 +453,37 @@ u64 MUL64(u64 V, u64 P, u64 c)
   return result;
 }
 
+/* MUL64 table.
+ * Input P: a 64-bit input.
+ * Input c: a 64-bit input.
+ * Output table: P * x^i for i = 0..63.
+ * Since MUL64(V, P, c) is the sum of P * x^i for the bits i set in V, the
+ * table turns every multiplication by the same P into 64 conditional XORs.
+ */
+static void MUL64table(u64 P, u64 c, u64 table[64])
+{
+  int i    = 0;
+  table[0] = P;
+  for (i = 1; i < 64; i++)
+    table[i] = MUL64x(table[i - 1], c);
+}
+
+/* MUL64 with a table.
+ * Input V: a 64-bit input.
+ * Input table: P * x^i for i = 0..63, see MUL64table.
+ * Output : a 64-bit output, equal to MUL64(V, P, c).
+ */
+static inline u64 MUL64tab(u64 V, const u64 table[64])
+{
+  u64 result = 0;
+  int i      = 0;
+
+  for (i = 0; i < 64; i++) {
+    result ^= table[i] & (0 - ((V >> i) & 0x1));
+  }
+  return result;
+}
+
 /* mask8bit.
  * Input n: an integer in 1-7.
  * Output : an 8 bit mask.
@@ -426,19 +501,20 @@ u8 mask8bit(int n)
  * Input dir:1 bit, direction of transmission (in the LSB).
  * Input data: length number of bits, input bit stream.
  * Input length: 64 bit Length, i.e., the number of bits to be MAC'd.
- * Output  : 32 bit block used as MAC
+ * Output MAC_I: 32 bit block used as MAC
  * Generates 32-bit MAC using UIA2 algorithm as defined in Section 4.
  */
-u8* snow3g_f9(u8* key, u32 count, u32 fresh, u32 dir, u8* data, u64 length)
+void snow3g_f9(u8* key, u32 count, u32 fresh, u32 dir, u8* data, u64 length, u8* MAC_I)
 {
-  u32       K[4], IV[4], z[5];
-  u32       i        = 0, D;
-  static u8 MAC_I[4] = {0, 0, 0, 0}; /* static memory for the result */
-  u64       EVAL;
-  u64       V;
-  u64       P;
-  u64       Q;
-  u64       c;
+  snow3g_state_t state;
+  u32            K[4], IV[4], z[5];
+  u32            i = 0, D;
+  u64            EVAL;
+  u64            V;
+  u64            P;
+  u64            Q;
+  u64            c;
+  u64            P_table[64];
 
   u64 M_D_2;
   int rem_bits = 0;
@@ -457,8 +533,8 @@ u8* snow3g_f9(u8* key, u32 count, u32 fresh, u32 dir, u8* data, u64 length)
   z[0] = z[1] = z[2] = z[3] = z[4] = 0;
 
   /* Run SNOW 3G to produce 5 keystream words z_1, z_2, z_3, z_4 and z_5. */
-  snow3g_initialize(K, IV);
-  snow3g_generate_keystream(5, z);
+  snow3g_initialize(&state, K, IV);
+  snow3g_generate_keystream(&state, 5, z);
 
   P = (u64)z[0] << 32 | (u64)z[1];
   Q = (u64)z[2] << 32 | (u64)z[3];
@@ -470,13 +546,14 @@ u8* snow3g_f9(u8* key, u32 count, u32 fresh, u32 dir, u8* data, u64 length)
     D = (length >> 6) + 2;
   EVAL = 0;
   c    = 0x1b;
+  MUL64table(P, c, P_table);
 
   /* for 0 <= i <= D-3 */
   for (i = 0; i < D - 2; i++) {
     V = EVAL ^
         ((u64)data[8 * i] << 56 | (u64)data[8 * i + 1] << 48 | (u64)data[8 * i + 2] << 40 | (u64)data[8 * i + 3] << 32 |
          (u64)data[8 * i + 4] << 24 | (u64)data[8 * i + 5] << 16 | (u64)data[8 * i + 6] << 8 | (u64)data[8 * i + 7]);
-    EVAL = MUL64(V, P, c);
+    EVAL = MUL64tab(V, P_table);
   }
 
   /* for D-2 */
@@ -495,7 +572,7 @@ u8* snow3g_f9(u8* key, u32 count, u32 fresh, u32 dir, u8* data, u64 length)
     M_D_2 |= (u64)(data[8 * (D - 2) + i] & mask8bit(rem_bits)) << (8 * (7 - i));
 
   V    = EVAL ^ M_D_2;
-  EVAL = MUL64(V, P, c);
+  EVAL = MUL64tab(V, P_table);
 
   /* for D-1 */
   EVAL ^= length;
@@ -510,6 +587,4 @@ u8* snow3g_f9(u8* key, u32 count, u32 fresh, u32 dir, u8* data, u64 length)
     MAC_I[i] = (mac32 >> (8*(3-i))) & 0xff;
     */
     MAC_I[i] = ((EVAL >> (56 - (i * 8))) ^ (z[4] >> (24 - (i * 8)))) & 0xff;
-
-  return MAC_I;
 }
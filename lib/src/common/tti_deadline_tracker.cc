@@ -0,0 +1,120 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/tti_deadline_tracker.h"
+
+namespace srslte {
+
+tti_deadline_tracker::tti_deadline_tracker(std::chrono::microseconds deadline_) : deadline_us(deadline_.count()) {}
+
+void tti_deadline_tracker::rx_done(uint32_t tti)
+{
+  tti_stamps_t& s = stamps[TTIMOD(tti)];
+  s.start.store(0, std::memory_order_relaxed);
+  s.rx.store(now_us(), std::memory_order_release);
+}
+
+void tti_deadline_tracker::worker_start(uint32_t tti)
+{
+  tti_stamps_t& s     = stamps[TTIMOD(tti)];
+  int64_t       t_now = now_us();
+  int64_t       t_rx  = s.rx.load(std::memory_order_acquire);
+  s.start.store(t_now, std::memory_order_relaxed);
+  if (t_rx > 0) {
+    wait_hist.push(t_now - t_rx);
+  }
+}
+
+void tti_deadline_tracker::worker_end(uint32_t tti)
+{
+  int64_t t_start = stamps[TTIMOD(tti)].start.load(std::memory_order_relaxed);
+  if (t_start > 0) {
+    proc_hist.push(now_us() - t_start);
+  }
+}
+
+void tti_deadline_tracker::tx_handoff(uint32_t tti)
+{
+  int64_t t_rx = stamps[TTIMOD(tti)].rx.load(std::memory_order_acquire);
+  if (t_rx > 0) {
+    int64_t elapsed = now_us() - t_rx;
+    tx_hist.push(elapsed);
+    if (elapsed > deadline_us.load(std::memory_order_relaxed)) {
+      nof_late.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void tti_deadline_tracker::get_metrics(rt_metrics_t* m)
+{
+  uint32_t count = 0;
+  wait_hist.pop_metrics(&m->wait, &count);
+  proc_hist.pop_metrics(&m->proc, &count);
+  tx_hist.pop_metrics(&m->tx, &count);
+  m->nof_tti  = count;
+  m->nof_late = nof_late.exchange(0, std::memory_order_relaxed);
+}
+
+void tti_deadline_tracker::histogram::push(int64_t value_us)
+{
+  value_us     = SRSLTE_MAX(value_us, 0);
+  uint32_t idx = SRSLTE_MIN(static_cast<uint64_t>(value_us / bin_width_us), nof_bins - 1);
+  bins[idx].fetch_add(1, std::memory_order_relaxed);
+
+  int64_t prev_max = max_us.load(std::memory_order_relaxed);
+  while (value_us > prev_max && not max_us.compare_exchange_weak(prev_max, value_us, std::memory_order_relaxed)) {
+  }
+}
+
+void tti_deadline_tracker::histogram::pop_metrics(rt_stage_metrics_t* m, uint32_t* count)
+{
+  std::array<uint32_t, nof_bins> snapshot;
+  uint32_t                       total = 0;
+  for (uint32_t i = 0; i < nof_bins; i++) {
+    snapshot[i] = bins[i].exchange(0, std::memory_order_relaxed);
+    total += snapshot[i];
+  }
+  m->max_us = static_cast<float>(max_us.exchange(0, std::memory_order_relaxed));
+  m->p50_us = 0;
+  m->p99_us = 0;
+  *count    = total;
+  if (total == 0) {
+    return;
+  }
+
+  // Report the upper edge of the bin where each percentile falls, bounded by the observed maximum
+  uint64_t acc      = 0;
+  bool     p50_done = false;
+  for (uint32_t i = 0; i < nof_bins; i++) {
+    acc += snapshot[i];
+    float bin_edge_us = SRSLTE_MIN(static_cast<float>((i + 1) * bin_width_us), m->max_us);
+    if (not p50_done and acc * 100 >= static_cast<uint64_t>(total) * 50) {
+      m->p50_us = bin_edge_us;
+      p50_done  = true;
+    }
+    if (acc * 100 >= static_cast<uint64_t>(total) * 99) {
+      m->p99_us = bin_edge_us;
+      break;
+    }
+  }
+}
+
+} // namespace srslte
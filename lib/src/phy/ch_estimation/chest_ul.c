@@ -98,11 +98,6 @@ int srslte_chest_ul_init(srslte_chest_ul_t* q, uint32_t max_prb)
     srslte_chest_set_smooth_filter3_coeff(q->smooth_filter, 0.3333);
 
     q->dmrs_signal_configured = false;
-
-    if (srslte_refsignal_dmrs_pusch_pregen_init(&q->dmrs_pregen, max_prb)) {
-      ERROR("Error allocating memory for pregenerated signals\n");
-      goto clean_exit;
-    }
   }
 
   ret = SRSLTE_SUCCESS;
@@ -116,7 +111,9 @@ clean_exit:
 
 void srslte_chest_ul_free(srslte_chest_ul_t* q)
 {
-  srslte_refsignal_dmrs_pusch_pregen_free(&q->dmrs_signal, &q->dmrs_pregen);
+  if (q->dmrs_pregen) {
+    srslte_refsignal_dmrs_pusch_pregen_release(q->dmrs_pregen);
+  }
 
   srslte_refsignal_ul_free(&q->dmrs_signal);
   if (q->tmp_noise) {
@@ -191,8 +188,23 @@ int srslte_chest_ul_set_cell(srslte_chest_ul_t* q, srslte_cell_t cell)
 
 void srslte_chest_ul_pregen(srslte_chest_ul_t* q, srslte_refsignal_dmrs_pusch_cfg_t* cfg)
 {
-  srslte_refsignal_dmrs_pusch_pregen(&q->dmrs_signal, &q->dmrs_pregen, cfg);
-  q->dmrs_signal_configured = true;
+  if (q->dmrs_pregen) {
+    srslte_refsignal_dmrs_pusch_pregen_release(q->dmrs_pregen);
+  }
+  q->dmrs_pregen            = srslte_refsignal_dmrs_pusch_pregen_acquire(&q->dmrs_signal, cfg);
+  q->dmrs_signal_configured = q->dmrs_pregen != NULL;
+}
+
+static float calibrate_noise(srslte_chest_ul_t* q, float power)
+{
+  if (q->smooth_filter_len == 3) {
+    // Calibrated for filter length 3
+    float w = q->smooth_filter[0];
+    float a = 7.419 * w * w + 0.1117 * w - 0.005387;
+    return (power / (a * 0.8));
+  } else {
+    return power;
+  }
 }
 
 /* Uses the difference between the averaged and non-averaged pilot estimates */
@@ -210,14 +222,7 @@ static float estimate_noise_pilots(srslte_chest_ul_t* q, cf_t* ce, uint32_t nref
 
   power /= 2;
 
-  if (q->smooth_filter_len == 3) {
-    // Calibrated for filter length 3
-    float w = q->smooth_filter[0];
-    float a = 7.419 * w * w + 0.1117 * w - 0.005387;
-    return (power / (a * 0.8));
-  } else {
-    return power;
-  }
+  return calibrate_noise(q, power);
 }
 
 // The interpolator currently only supports same frequency allocation for each subframe
@@ -300,7 +305,7 @@ int srslte_chest_ul_estimate_pusch(srslte_chest_ul_t*     q,
 
   /* Use the known DMRS signal to compute Least-squares estimates */
   srslte_vec_prod_conj_ccc(
-      q->pilot_recv_signal, q->dmrs_pregen.r[cfg->grant.n_dmrs][sf->tti % 10][nof_prb], q->pilot_estimates, nrefs_sf);
+      q->pilot_recv_signal, q->dmrs_pregen->r[cfg->grant.n_dmrs][sf->tti % 10][nof_prb], q->pilot_estimates, nrefs_sf);
 
   // Calculate time alignment error
   float ta_err = 0.0f;
@@ -353,6 +358,142 @@ int srslte_chest_ul_estimate_pusch(srslte_chest_ul_t*     q,
   return 0;
 }
 
+/* Smooths the pilot estimates of a whole DMRS symbol as if it was a single allocation. The outputs near the edges of
+ * each allocation mix the estimates of its neighbours, average_pilots_edges() recomputes them afterwards. */
+static void average_pilots_band(srslte_chest_ul_t* q, cf_t* input, cf_t* output)
+{
+  uint32_t nrefs = NOF_REFS_SYM;
+
+  if (q->smooth_filter_len == 3) {
+    // Three vector passes instead of one dot product per pilot
+    srslte_vec_sc_prod_cfc(input, q->smooth_filter[1], output, nrefs);
+    srslte_vec_sc_prod_cfc(input, q->smooth_filter[0], q->pilot_recv_signal, nrefs);
+    srslte_vec_sum_ccc(&output[1], q->pilot_recv_signal, &output[1], nrefs - 1);
+    srslte_vec_sc_prod_cfc(input, q->smooth_filter[2], q->pilot_recv_signal, nrefs);
+    srslte_vec_sum_ccc(output, &q->pilot_recv_signal[1], output, nrefs - 1);
+  } else {
+    srslte_conv_same_cf(input, q->smooth_filter, output, nrefs, q->smooth_filter_len);
+  }
+}
+
+static void average_pilots_edges(srslte_chest_ul_t* q, cf_t* input, cf_t* output, uint32_t nrefs)
+{
+  uint32_t M = q->smooth_filter_len;
+  cf_t     tmp[2 * SRSLTE_CHEST_MAX_SMOOTH_FIL_LEN];
+
+  if (nrefs <= 2 * M) {
+    srslte_conv_same_cf(input, q->smooth_filter, output, nrefs, M);
+  } else {
+    // The first and last M/2 outputs only depend on the first and last M inputs of the allocation
+    srslte_conv_same_cf(input, q->smooth_filter, tmp, 2 * M, M);
+    memcpy(output, tmp, (M / 2) * sizeof(cf_t));
+    srslte_conv_same_cf(&input[nrefs - 2 * M], q->smooth_filter, tmp, 2 * M, M);
+    memcpy(&output[nrefs - M / 2], &tmp[2 * M - M / 2], (M / 2) * sizeof(cf_t));
+  }
+}
+
+int srslte_chest_ul_estimate_pusch_multi(srslte_chest_ul_t*     q,
+                                         srslte_ul_sf_cfg_t*    sf,
+                                         srslte_pusch_cfg_t*    cfg,
+                                         cf_t*                  input,
+                                         cf_t*                  ce,
+                                         srslte_chest_ul_res_t* res,
+                                         uint32_t               nof_grants)
+{
+  if (!q->dmrs_signal_configured) {
+    ERROR("Error must call srslte_chest_ul_set_cfg() before using the UL estimator\n");
+    return SRSLTE_ERROR;
+  }
+
+  uint32_t sf_idx                              = sf->tti % SRSLTE_NOF_SF_X_FRAME;
+  uint32_t no_hopping[SRSLTE_NOF_SLOTS_PER_SF] = {};
+  bool     prb_used[SRSLTE_MAX_PRB]            = {};
+
+  /* Lay the known DMRS of every grant out at its position in the DMRS symbols, the unallocated PRBs are left at zero */
+  srslte_vec_cf_zero(q->pilot_known_signal, NOF_REFS_SF);
+  for (uint32_t g = 0; g < nof_grants; g++) {
+    srslte_pusch_grant_t* grant = &cfg[g].grant;
+    if (!srslte_dft_precoding_valid_prb(grant->L_prb) || grant->n_dmrs >= SRSLTE_NOF_CSHIFT ||
+        grant->n_prb[0] + grant->L_prb > q->cell.nof_prb) {
+      ERROR("Error invalid n_prb=%d, L_prb=%d or n_dmrs=%d\n", grant->n_prb[0], grant->L_prb, grant->n_dmrs);
+      return SRSLTE_ERROR_INVALID_INPUTS;
+    }
+    if (grant->n_prb[1] != grant->n_prb[0] || grant->n_prb_tilde[0] != grant->n_prb[0] ||
+        grant->n_prb_tilde[1] != grant->n_prb[0]) {
+      INFO("Frequency hopping not supported in batched estimation\n");
+      return SRSLTE_ERROR_INVALID_INPUTS;
+    }
+    for (uint32_t n = grant->n_prb[0]; n < grant->n_prb[0] + grant->L_prb; n++) {
+      if (prb_used[n]) {
+        INFO("PUSCH grants overlap in PRB %d, can not be estimated in a batch\n", n);
+        return SRSLTE_ERROR_INVALID_INPUTS;
+      }
+      prb_used[n] = true;
+    }
+    for (uint32_t i = 0; i < SRSLTE_NOF_SLOTS_PER_SF; i++) {
+      memcpy(&q->pilot_known_signal[i * NOF_REFS_SYM + grant->n_prb[0] * SRSLTE_NRE],
+             &q->dmrs_pregen->r[grant->n_dmrs][sf_idx][grant->L_prb][i * grant->L_prb * SRSLTE_NRE],
+             grant->L_prb * SRSLTE_NRE * sizeof(cf_t));
+    }
+  }
+
+  for (uint32_t i = 0; i < SRSLTE_NOF_SLOTS_PER_SF; i++) {
+    cf_t* recv_signal = &input[SRSLTE_REFSIGNAL_UL_L(i, q->cell.cp) * NOF_REFS_SYM];
+    cf_t* estimates   = &q->pilot_estimates[i * NOF_REFS_SYM];
+    cf_t* ce_symbol   = &ce[SRSLTE_REFSIGNAL_UL_L(i, q->cell.cp) * NOF_REFS_SYM];
+
+    /* Least-squares estimates of all the grants in a single pass */
+    srslte_vec_prod_conj_ccc(recv_signal, &q->pilot_known_signal[i * NOF_REFS_SYM], estimates, NOF_REFS_SYM);
+
+    if (q->smooth_filter_len > 0) {
+      average_pilots_band(q, estimates, ce_symbol);
+      for (uint32_t g = 0; g < nof_grants; g++) {
+        uint32_t k = cfg[g].grant.n_prb[0] * SRSLTE_NRE;
+        average_pilots_edges(q, &estimates[k], &ce_symbol[k], cfg[g].grant.L_prb * SRSLTE_NRE);
+      }
+
+      /* Difference between the averaged and non-averaged estimates, for the noise estimation of each grant */
+      srslte_vec_sub_ccc(ce_symbol, estimates, &q->tmp_noise[i * NOF_REFS_SYM], NOF_REFS_SYM);
+    } else {
+      memcpy(ce_symbol, estimates, NOF_REFS_SYM * sizeof(cf_t));
+    }
+  }
+
+  // Copy the estimates of the whole band to the rest of symbols
+  interpolate_pilots(q, ce, NOF_REFS_SYM, no_hopping);
+
+  /* Measurements of each grant */
+  for (uint32_t g = 0; g < nof_grants; g++) {
+    uint32_t k         = cfg[g].grant.n_prb[0] * SRSLTE_NRE;
+    uint32_t nrefs_sym = cfg[g].grant.L_prb * SRSLTE_NRE;
+    float    ta_err    = 0.0f;
+    float    noise     = 0.0f;
+    float    power     = 0.0f;
+    for (uint32_t i = 0; i < SRSLTE_NOF_SLOTS_PER_SF; i++) {
+      if (cfg[g].meas_ta_en) {
+        ta_err += srslte_vec_estimate_frequency(&q->pilot_estimates[i * NOF_REFS_SYM + k], nrefs_sym) /
+                  SRSLTE_NOF_SLOTS_PER_SF;
+      }
+      if (q->smooth_filter_len > 0) {
+        noise += srslte_vec_avg_power_cf(&q->tmp_noise[i * NOF_REFS_SYM + k], nrefs_sym) / SRSLTE_NOF_SLOTS_PER_SF;
+      }
+      power += srslte_vec_avg_power_cf(&input[SRSLTE_RE_IDX(q->cell.nof_prb, SRSLTE_REFSIGNAL_UL_L(i, q->cell.cp), k)],
+                                       nrefs_sym) /
+               SRSLTE_NOF_SLOTS_PER_SF;
+    }
+
+    res[g].ce             = ce;
+    res[g].ta_us          = isnormal(ta_err) ? roundf(ta_err / 15e-3 * 10) / 10 : 0.0f;
+    res[g].noise_estimate = q->smooth_filter_len > 0 ? calibrate_noise(q, noise) : 0.0f;
+    res[g].snr            = res[g].noise_estimate ? power / res[g].noise_estimate : NAN;
+
+    res[g].snr_db             = srslte_convert_power_to_dB(res[g].snr);
+    res[g].noise_estimate_dbm = srslte_convert_power_to_dBm(res[g].noise_estimate);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_chest_ul_estimate_pucch(srslte_chest_ul_t*     q,
                                    srslte_ul_sf_cfg_t*    sf,
                                    srslte_pucch_cfg_t*    cfg,
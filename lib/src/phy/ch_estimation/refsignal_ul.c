@@ -21,6 +21,7 @@
 
 #include <complex.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
@@ -400,12 +401,12 @@ int srslte_refsignal_dmrs_pusch_pregen(srslte_refsignal_ul_t*             q,
   return SRSLTE_SUCCESS;
 }
 
-void srslte_refsignal_dmrs_pusch_pregen_free(srslte_refsignal_ul_t* q, srslte_refsignal_ul_dmrs_pregen_t* pregen)
+static void dmrs_pusch_pregen_free(srslte_refsignal_ul_dmrs_pregen_t* pregen, uint32_t nof_prb)
 {
   for (uint32_t sf_idx = 0; sf_idx < SRSLTE_NOF_SF_X_FRAME; sf_idx++) {
     for (uint32_t cs = 0; cs < SRSLTE_NOF_CSHIFT; cs++) {
       if (pregen->r[cs][sf_idx]) {
-        for (uint32_t n = 0; n <= q->cell.nof_prb; n++) {
+        for (uint32_t n = 0; n <= nof_prb; n++) {
           if (srslte_dft_precoding_valid_prb(n)) {
             if (pregen->r[cs][sf_idx][n]) {
               free(pregen->r[cs][sf_idx][n]);
@@ -418,6 +419,84 @@ void srslte_refsignal_dmrs_pusch_pregen_free(srslte_refsignal_ul_t* q, srslte_re
   }
 }
 
+void srslte_refsignal_dmrs_pusch_pregen_free(srslte_refsignal_ul_t* q, srslte_refsignal_ul_dmrs_pregen_t* pregen)
+{
+  dmrs_pusch_pregen_free(pregen, q->cell.nof_prb);
+}
+
+/* Pregenerated PUSCH DMRS of a cell and common DMRS configuration, shared by all the estimators that use them */
+typedef struct dmrs_pregen_shared_s {
+  srslte_cell_t                     cell;
+  srslte_refsignal_dmrs_pusch_cfg_t cfg;
+  srslte_refsignal_ul_dmrs_pregen_t pregen;
+  uint32_t                          nof_users;
+  struct dmrs_pregen_shared_s*      next;
+} dmrs_pregen_shared_t;
+
+static dmrs_pregen_shared_t* dmrs_pregen_shared_list  = NULL;
+static pthread_mutex_t       dmrs_pregen_shared_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool dmrs_pregen_shared_match(dmrs_pregen_shared_t*              e,
+                                     srslte_cell_t*                     cell,
+                                     srslte_refsignal_dmrs_pusch_cfg_t* cfg)
+{
+  return e->cell.id == cell->id && e->cell.nof_prb == cell->nof_prb && e->cell.cp == cell->cp &&
+         e->cfg.cyclic_shift == cfg->cyclic_shift && e->cfg.delta_ss == cfg->delta_ss &&
+         e->cfg.group_hopping_en == cfg->group_hopping_en && e->cfg.sequence_hopping_en == cfg->sequence_hopping_en;
+}
+
+srslte_refsignal_ul_dmrs_pregen_t* srslte_refsignal_dmrs_pusch_pregen_acquire(srslte_refsignal_ul_t*             q,
+                                                                              srslte_refsignal_dmrs_pusch_cfg_t* cfg)
+{
+  srslte_refsignal_ul_dmrs_pregen_t* pregen = NULL;
+
+  pthread_mutex_lock(&dmrs_pregen_shared_mutex);
+  dmrs_pregen_shared_t* e = dmrs_pregen_shared_list;
+  while (e != NULL && !dmrs_pregen_shared_match(e, &q->cell, cfg)) {
+    e = e->next;
+  }
+  if (e == NULL) {
+    e = calloc(1, sizeof(dmrs_pregen_shared_t));
+    if (e != NULL) {
+      e->cell = q->cell;
+      e->cfg  = *cfg;
+      if (srslte_refsignal_dmrs_pusch_pregen_init(&e->pregen, q->cell.nof_prb) ||
+          srslte_refsignal_dmrs_pusch_pregen(q, &e->pregen, cfg)) {
+        ERROR("Error generating shared PUSCH DMRS\n");
+        dmrs_pusch_pregen_free(&e->pregen, q->cell.nof_prb);
+        free(e);
+        e = NULL;
+      } else {
+        e->next                 = dmrs_pregen_shared_list;
+        dmrs_pregen_shared_list = e;
+      }
+    }
+  }
+  if (e != NULL) {
+    e->nof_users++;
+    pregen = &e->pregen;
+  }
+  pthread_mutex_unlock(&dmrs_pregen_shared_mutex);
+
+  return pregen;
+}
+
+void srslte_refsignal_dmrs_pusch_pregen_release(srslte_refsignal_ul_dmrs_pregen_t* pregen)
+{
+  pthread_mutex_lock(&dmrs_pregen_shared_mutex);
+  dmrs_pregen_shared_t** prev = &dmrs_pregen_shared_list;
+  while (*prev != NULL && &(*prev)->pregen != pregen) {
+    prev = &(*prev)->next;
+  }
+  dmrs_pregen_shared_t* e = *prev;
+  if (e != NULL && --e->nof_users == 0) {
+    *prev = e->next;
+    dmrs_pusch_pregen_free(&e->pregen, e->cell.nof_prb);
+    free(e);
+  }
+  pthread_mutex_unlock(&dmrs_pregen_shared_mutex);
+}
+
 int srslte_refsignal_dmrs_pusch_pregen_put(srslte_refsignal_ul_t*             q,
                                            srslte_ul_sf_cfg_t*                sf_cfg,
                                            srslte_refsignal_ul_dmrs_pregen_t* pregen,
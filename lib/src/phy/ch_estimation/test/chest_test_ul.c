@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <strings.h>
+#include <sys/time.h>
 #include <unistd.h>
 
 #include "srslte/srslte.h"
@@ -80,6 +81,96 @@ void parse_args(int argc, char** argv)
   }
 }
 
+#define MULTI_NOF_REPETITIONS 100
+
+/* Splits the cell in as many grants of 1 to 3 PRB as fit, estimates their channel one by one and in a single batch,
+ * checks that both give the same results and measures the time taken by each
+ */
+static int test_multi(srslte_chest_ul_t* est, cf_t* input, uint32_t num_re)
+{
+  srslte_pusch_cfg_t    cfg[SRSLTE_MAX_PRB];
+  srslte_chest_ul_res_t res_serial[SRSLTE_MAX_PRB];
+  srslte_chest_ul_res_t res_multi[SRSLTE_MAX_PRB];
+  srslte_ul_sf_cfg_t    ul_sf      = {};
+  uint32_t              nof_grants = 0;
+  int                   ret        = SRSLTE_ERROR;
+
+  cf_t* ce_serial = srslte_vec_cf_malloc(num_re);
+  cf_t* ce_multi  = srslte_vec_cf_malloc(num_re);
+  if (!ce_serial || !ce_multi) {
+    perror("srslte_vec_malloc");
+    goto clean_exit;
+  }
+  srslte_vec_cf_zero(ce_serial, num_re);
+  srslte_vec_cf_zero(ce_multi, num_re);
+
+  for (uint32_t n_prb = 0; n_prb < cell.nof_prb; nof_grants++) {
+    uint32_t L_prb = SRSLTE_MIN(1 + nof_grants % 3, cell.nof_prb - n_prb);
+    ZERO_OBJECT(cfg[nof_grants]);
+    cfg[nof_grants].grant.L_prb          = L_prb;
+    cfg[nof_grants].grant.n_prb[0]       = n_prb;
+    cfg[nof_grants].grant.n_prb[1]       = n_prb;
+    cfg[nof_grants].grant.n_prb_tilde[0] = n_prb;
+    cfg[nof_grants].grant.n_prb_tilde[1] = n_prb;
+    cfg[nof_grants].grant.n_dmrs         = nof_grants % SRSLTE_NOF_CSHIFT;
+    cfg[nof_grants].meas_ta_en           = true;
+    res_serial[nof_grants].ce            = ce_serial;
+    n_prb += L_prb;
+  }
+
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  for (int r = 0; r < MULTI_NOF_REPETITIONS; r++) {
+    for (uint32_t g = 0; g < nof_grants; g++) {
+      if (srslte_chest_ul_estimate_pusch(est, &ul_sf, &cfg[g], input, &res_serial[g])) {
+        goto clean_exit;
+      }
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double serial_us = t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+  gettimeofday(&t[1], NULL);
+  for (int r = 0; r < MULTI_NOF_REPETITIONS; r++) {
+    if (srslte_chest_ul_estimate_pusch_multi(est, &ul_sf, cfg, input, ce_multi, res_multi, nof_grants)) {
+      goto clean_exit;
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double multi_us = t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+  for (uint32_t i = 0; i < num_re; i++) {
+    if (cabsf(ce_serial[i] - ce_multi[i]) > 1e-4f * (1.0f + cabsf(ce_serial[i]))) {
+      ERROR("Batched estimate of RE %d does not match\n", i);
+      goto clean_exit;
+    }
+  }
+  for (uint32_t g = 0; g < nof_grants; g++) {
+    if (fabsf(res_serial[g].snr_db - res_multi[g].snr_db) > 0.01f ||
+        fabsf(res_serial[g].ta_us - res_multi[g].ta_us) > 0.01f) {
+      ERROR("Batched SNR or TA of grant %d does not match\n", g);
+      goto clean_exit;
+    }
+  }
+
+  printf("Estimated %d grants: %.1f us one by one, %.1f us batched\n",
+         nof_grants,
+         serial_us / MULTI_NOF_REPETITIONS,
+         multi_us / MULTI_NOF_REPETITIONS);
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  if (ce_serial) {
+    free(ce_serial);
+  }
+  if (ce_multi) {
+    free(ce_multi);
+  }
+  return ret;
+}
+
 int main(int argc, char** argv)
 {
   srslte_chest_ul_t est;
@@ -234,6 +325,10 @@ int main(int argc, char** argv)
     printf("cid=%d\n", cid);
   }
 
+  if (test_multi(&est, input, num_re)) {
+    goto do_exit;
+  }
+
   srslte_chest_ul_free(&est);
 
   if (fmatlab) {
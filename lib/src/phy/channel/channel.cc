@@ -19,6 +19,7 @@
  *
  */
 
+#include <chrono>
 #include <cstdlib>
 #include <srslte/phy/channel/channel.h>
 #include <srslte/srslte.h>
@@ -42,15 +43,15 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels)
   // Copy args
   args = channel_args;
 
-  // Allocate internal buffers
-  buffer_in  = srslte_vec_cf_malloc(buffer_size);
-  buffer_out = srslte_vec_cf_malloc(buffer_size);
-  if (!buffer_out || !buffer_in) {
-    ret = SRSLTE_ERROR;
-  }
-
   nof_channels = _nof_channels;
   for (uint32_t i = 0; i < nof_channels; i++) {
+    // Allocate internal buffers
+    buffer_in[i]  = srslte_vec_cf_malloc(buffer_size);
+    buffer_out[i] = srslte_vec_cf_malloc(buffer_size);
+    if (!buffer_out[i] || !buffer_in[i]) {
+      ret = SRSLTE_ERROR;
+    }
+
     // Create fading channel
     if (channel_args.fading_enable && !channel_args.fading_model.empty() && channel_args.fading_model != "none" &&
         ret == SRSLTE_SUCCESS) {
@@ -72,19 +73,19 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels)
     } else {
       delay[i] = nullptr;
     }
-  }
 
-  // Create AWGN channnel
-  if (channel_args.awgn_enable && ret == SRSLTE_SUCCESS) {
-    awgn = (srslte_channel_awgn_t*)calloc(sizeof(srslte_channel_awgn_t), 1);
-    ret  = srslte_channel_awgn_init(awgn, 1234);
-    srslte_channel_awgn_set_n0(awgn, args.awgn_n0_dBfs);
-  }
+    // Create AWGN channnel, every channel has its own noise generator so they can run in parallel
+    if (channel_args.awgn_enable && ret == SRSLTE_SUCCESS) {
+      awgn[i] = (srslte_channel_awgn_t*)calloc(sizeof(srslte_channel_awgn_t), 1);
+      ret     = srslte_channel_awgn_init(awgn[i], 1234 + i);
+      srslte_channel_awgn_set_n0(awgn[i], args.awgn_n0_dBfs);
+    }
 
-  // Create high speed train
-  if (channel_args.hst_enable && ret == SRSLTE_SUCCESS) {
-    hst = (srslte_channel_hst_t*)calloc(sizeof(srslte_channel_hst_t), 1);
-    srslte_channel_hst_init(hst, channel_args.hst_fd_hz, channel_args.hst_period_s, channel_args.hst_init_time_s);
+    // Create high speed train
+    if (channel_args.hst_enable && ret == SRSLTE_SUCCESS) {
+      hst[i] = (srslte_channel_hst_t*)calloc(sizeof(srslte_channel_hst_t), 1);
+      srslte_channel_hst_init(hst[i], channel_args.hst_fd_hz, channel_args.hst_period_s, channel_args.hst_init_time_s);
+    }
   }
 
   // Create Radio Link Failure simulator
@@ -93,6 +94,12 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels)
     srslte_channel_rlf_init(rlf, channel_args.rlf_t_on_ms, channel_args.rlf_t_off_ms);
   }
 
+  // Create workers for processing the channels in parallel
+  if (channel_args.nof_workers > 0 && nof_channels > 1 && ret == SRSLTE_SUCCESS) {
+    workers = std::unique_ptr<task_thread_pool>(new task_thread_pool(SRSLTE_MIN(channel_args.nof_workers, nof_channels)));
+    workers->start();
+  }
+
   if (ret != SRSLTE_SUCCESS) {
     fprintf(stderr, "Error: Creating channel\n\n");
   }
@@ -100,22 +107,8 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels)
 
 channel::~channel()
 {
-  if (buffer_in) {
-    free(buffer_in);
-  }
-
-  if (buffer_out) {
-    free(buffer_out);
-  }
-
-  if (awgn) {
-    srslte_channel_awgn_free(awgn);
-    free(awgn);
-  }
-
-  if (hst) {
-    srslte_channel_hst_free(hst);
-    free(hst);
+  if (workers) {
+    workers->stop();
   }
 
   if (rlf) {
@@ -124,6 +117,14 @@ channel::~channel()
   }
 
   for (uint32_t i = 0; i < nof_channels; i++) {
+    if (buffer_in[i]) {
+      free(buffer_in[i]);
+    }
+
+    if (buffer_out[i]) {
+      free(buffer_out[i]);
+    }
+
     if (fading[i]) {
       srslte_channel_fading_free(fading[i]);
       free(fading[i]);
@@ -133,6 +134,16 @@ channel::~channel()
       srslte_channel_delay_free(delay[i]);
       free(delay[i]);
     }
+
+    if (awgn[i]) {
+      srslte_channel_awgn_free(awgn[i]);
+      free(awgn[i]);
+    }
+
+    if (hst[i]) {
+      srslte_channel_hst_free(hst[i]);
+      free(hst[i]);
+    }
   }
 }
 
@@ -151,6 +162,40 @@ void channel::set_logger(log_filter* _log_h)
   log_h = _log_h;
 }
 
+void channel::run_channel(uint32_t i, const cf_t* in, cf_t* out, uint32_t len, const srslte_timestamp_t& t)
+{
+  // Copy input buffer
+  srslte_vec_cf_copy(buffer_in[i], in, len);
+
+  if (hst[i]) {
+    srslte_channel_hst_execute(hst[i], buffer_in[i], buffer_out[i], len, &t);
+    srslte_vec_sc_prod_ccc(buffer_out[i], local_cexpf(hst_init_phase), buffer_in[i], len);
+  }
+
+  if (awgn[i]) {
+    srslte_channel_awgn_run_c(awgn[i], buffer_in[i], buffer_out[i], len);
+    srslte_vec_cf_copy(buffer_in[i], buffer_out[i], len);
+  }
+
+  if (fading[i]) {
+    srslte_channel_fading_execute(fading[i], buffer_in[i], buffer_out[i], len, t.full_secs + t.frac_secs);
+    srslte_vec_cf_copy(buffer_in[i], buffer_out[i], len);
+  }
+
+  if (delay[i]) {
+    srslte_channel_delay_execute(delay[i], buffer_in[i], buffer_out[i], len, &t);
+    srslte_vec_cf_copy(buffer_in[i], buffer_out[i], len);
+  }
+
+  if (rlf) {
+    srslte_channel_rlf_execute(rlf, buffer_in[i], buffer_out[i], len, &t);
+    srslte_vec_cf_copy(buffer_in[i], buffer_out[i], len);
+  }
+
+  // Copy output buffer
+  srslte_vec_cf_copy(out, buffer_in[i], len);
+}
+
 void channel::run(cf_t*                     in[SRSLTE_MAX_CHANNELS],
                   cf_t*                     out[SRSLTE_MAX_CHANNELS],
                   uint32_t                  len,
@@ -161,6 +206,8 @@ void channel::run(cf_t*                     in[SRSLTE_MAX_CHANNELS],
     return;
   }
 
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
   // For each channel
   for (uint32_t i = 0; i < nof_channels; i++) {
     // Skip iteration if any buffer is null
@@ -176,41 +223,40 @@ void channel::run(cf_t*                     in[SRSLTE_MAX_CHANNELS],
       continue;
     }
 
-    // Copy input buffer
-    srslte_vec_cf_copy(buffer_in, in[i], len);
-
-    if (hst) {
-      srslte_channel_hst_execute(hst, buffer_in, buffer_out, len, &t);
-      srslte_vec_sc_prod_ccc(buffer_out, local_cexpf(hst_init_phase), buffer_in, len);
-    }
-
-    if (awgn) {
-      srslte_channel_awgn_run_c(awgn, buffer_in, buffer_out, len);
-      srslte_vec_cf_copy(buffer_in, buffer_out, len);
-    }
-
-    if (fading[i]) {
-      srslte_channel_fading_execute(fading[i], buffer_in, buffer_out, len, t.full_secs + t.frac_secs);
-      srslte_vec_cf_copy(buffer_in, buffer_out, len);
+    if (workers) {
+      {
+        std::lock_guard<std::mutex> lock(workers_mutex);
+        workers_pending++;
+      }
+      cf_t* channel_in  = in[i];
+      cf_t* channel_out = out[i];
+      workers->push_task([this, i, channel_in, channel_out, len, t](uint32_t worker_id) {
+        run_channel(i, channel_in, channel_out, len, t);
+
+        std::lock_guard<std::mutex> lock(workers_mutex);
+        workers_pending--;
+        workers_cvar.notify_one();
+      });
+    } else {
+      run_channel(i, in[i], out[i], len, t);
     }
 
-    if (delay[i]) {
-      srslte_channel_delay_execute(delay[i], buffer_in, buffer_out, len, &t);
-      srslte_vec_cf_copy(buffer_in, buffer_out, len);
-    }
+    nof_processed_samples += len;
+  }
 
-    if (rlf) {
-      srslte_channel_rlf_execute(rlf, buffer_in, buffer_out, len, &t);
-      srslte_vec_cf_copy(buffer_in, buffer_out, len);
+  // Wait for all channels to be processed
+  if (workers) {
+    std::unique_lock<std::mutex> lock(workers_mutex);
+    while (workers_pending > 0) {
+      workers_cvar.wait(lock);
     }
-
-    // Copy output buffer
-    srslte_vec_cf_copy(out[i], buffer_in, len);
   }
 
-  if (hst) {
+  processing_time_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (hst[0]) {
     // Increment phase to keep it coherent between frames
-    hst_init_phase += (2 * M_PI * len * hst->fs_hz / hst->srate_hz);
+    hst_init_phase += (2 * M_PI * len * hst[0]->fs_hz / hst[0]->srate_hz);
 
     // Positive Remainder
     while (hst_init_phase > 2 * M_PI) {
@@ -233,14 +279,25 @@ void channel::run(cf_t*                     in[SRSLTE_MAX_CHANNELS],
       str << "delay=" << delay[0]->delay_us << "us; ";
     }
 
-    if (hst) {
-      str << "hst=" << hst->fs_hz << "Hz; ";
+    if (hst[0]) {
+      str << "hst=" << hst[0]->fs_hz << "Hz; ";
     }
 
+    str << "rate=" << get_samples_per_second() / 1e6 << "Msps; ";
+
     log_h->debug("%s\n", str.str().c_str());
   }
 }
 
+double channel::get_samples_per_second() const
+{
+  if (processing_time_s <= 0.0) {
+    return 0.0;
+  }
+
+  return (double)nof_processed_samples / processing_time_s;
+}
+
 void channel::set_srate(uint32_t srate)
 {
   if (current_srate != srate) {
@@ -254,10 +311,10 @@ void channel::set_srate(uint32_t srate)
       if (delay[i]) {
         srslte_channel_delay_update_srate(delay[i], srate);
       }
-    }
 
-    if (hst) {
-      srslte_channel_hst_update_srate(hst, srate);
+      if (hst[i]) {
+        srslte_channel_hst_update_srate(hst[i], srate);
+      }
     }
 
     // Update sampling rate
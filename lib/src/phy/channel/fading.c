@@ -21,7 +21,9 @@
 
 #include "srslte/phy/channel/fading.h"
 #include "srslte/phy/utils/random.h"
+#include "srslte/phy/utils/simd.h"
 #include "srslte/phy/utils/vector.h"
+#include <complex.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -77,110 +79,100 @@ static inline int parse_model(srslte_channel_fading_t* q, const char* str)
   return ret;
 }
 
-#ifdef LV_HAVE_SSE
-#include <immintrin.h>
-static inline __m128 _sine(const float* table, __m128 arg)
+static inline void update_trajectory(srslte_channel_fading_t* q, double time)
 {
-  __m128 ret;
-  int    idx[4];
-  float  sine[4];
-
-  __m128 turns =
-      _mm_round_ps(_mm_mul_ps(arg, _mm_set1_ps(1.0f / (2.0f * (float)M_PI))), (_MM_FROUND_TO_ZERO + _MM_FROUND_NO_EXC));
-  __m128  argmod   = _mm_sub_ps(arg, _mm_mul_ps(turns, _mm_set1_ps(2.0f * (float)M_PI)));
-  __m128  indexps  = _mm_mul_ps(argmod, _mm_set1_ps(1024.0f / (2.0f * (float)M_PI)));
-  __m128i indexi32 = _mm_abs_epi32(_mm_cvtps_epi32(indexps));
-  _mm_store_si128((__m128i*)idx, indexi32);
-
-  for (int i = 0; i < 4; i++) {
-    sine[i] = table[idx[i]];
+  uint32_t nof_terms = nof_taps[q->model] * SRSLTE_CHANNEL_FADING_NTERMS;
+  double   tolerance = 0.5 / q->srate;
+  double   step_time = (q->N / 2) / q->srate;
+
+  if (q->traj_count && fabs(time - q->traj_time) < tolerance) {
+    // Same segment time, nothing to do
+    return;
   }
 
-  ret = _mm_load_ps(sine);
-  return ret;
-}
+  if (q->traj_count && q->traj_count < SRSLTE_CHANNEL_FADING_TRAJ_RESYNC &&
+      fabs(time - q->traj_time - step_time) < tolerance) {
+    // Consecutive segment, rotate every Jakes term by one segment
+    srslte_vec_prod_ccc(q->traj_a, q->traj_step, q->traj_a, nof_terms);
+    srslte_vec_prod_ccc(q->traj_b, q->traj_step, q->traj_b, nof_terms);
+    q->traj_time += step_time;
+    q->traj_count++;
+    return;
+  }
 
-static inline __m128 _cosine(float* table, __m128 arg)
-{
-  arg = _mm_add_ps(arg, _mm_set1_ps((float)M_PI_2));
-  return _sine(table, arg);
+  // Discontinuous time or too many steps since last evaluation, compute the trajectory from scratch
+  for (uint32_t i = 0; i < nof_taps[q->model]; i++) {
+    for (uint32_t j = 0; j < SRSLTE_CHANNEL_FADING_NTERMS; j++) {
+      uint32_t k     = i * SRSLTE_CHANNEL_FADING_NTERMS + j;
+      float    phase = (float)fmod(q->traj_w[k] * time, 2.0 * M_PI);
+      q->traj_a[k]   = cexpf(_Complex_I * (phase + q->coeff_a[i][j]));
+      q->traj_b[k]   = cexpf(_Complex_I * (phase + q->coeff_b[i][j]));
+    }
+  }
+  q->traj_time  = time;
+  q->traj_count = 1;
 }
-#endif /*LV_HAVE_SSE*/
 
-static inline cf_t
-get_doppler_dispersion(srslte_channel_fading_t* q, float t, float F_d, float* alpha, float* a, float* b)
+static inline cf_t get_doppler_dispersion(const cf_t* traj_a, const cf_t* traj_b)
 {
-#ifdef LV_HAVE_SSE
-  const float recN   = 1.0f / sqrtf(SRSLTE_CHANNEL_FADING_NTERMS);
-  cf_t        ret    = 0;
-  __m128      _reacc = _mm_setzero_ps();
-  __m128      _imacc = _mm_setzero_ps();
-  __m128      _arg   = _mm_set1_ps((float)M_PI * F_d);
-  __m128      _t     = _mm_set1_ps(t);
-  __m128      _arg_  = (_mm_mul_ps(_arg, _t));
-
-  for (int i = 0; i < SRSLTE_CHANNEL_FADING_NTERMS; i += 4) {
-    __m128 _alpha = _mm_loadu_ps(&alpha[i]);
-    __m128 _a     = _mm_loadu_ps(&a[i]);
-    __m128 _b     = _mm_loadu_ps(&b[i]);
-    __m128 _arg1  = _mm_mul_ps(_arg_, _cosine(q->sin_table, _alpha));
-    __m128 _re    = _cosine(q->sin_table, _mm_add_ps(_arg1, _a));
-    __m128 _im    = _sine(q->sin_table, _mm_add_ps(_arg1, _b));
-    _reacc        = _mm_add_ps(_reacc, _re);
-    _imacc        = _mm_add_ps(_imacc, _im);
-  }
-
-  __m128 _tmp = _mm_hadd_ps(_reacc, _imacc);
-  _tmp        = _mm_hadd_ps(_tmp, _tmp);
-  float r[4];
-  _mm_store_ps(r, _tmp);
-  __real__ ret = r[0];
-  __imag__ ret = r[1];
-
-  return ret * recN;
-
-#else
   const float recN = 1.0f / sqrtf(SRSLTE_CHANNEL_FADING_NTERMS);
-  cf_t        r    = 0;
+  cf_t        r;
 
-  for (uint32_t i = 0; i < SRSLTE_CHANNEL_FADING_NTERMS; i++) {
-    float arg = (float)M_PI * F_d * cosf(alpha[i]) * t;
-    __real__ r += cosf(arg + a[i]);
-    __imag__ r += sinf(arg + b[i]);
-  }
+  __real__ r = crealf(srslte_vec_acc_cc(traj_a, SRSLTE_CHANNEL_FADING_NTERMS));
+  __imag__ r = cimagf(srslte_vec_acc_cc(traj_b, SRSLTE_CHANNEL_FADING_NTERMS));
 
   return recN * r;
-#endif /*LV_HAVE_SSE*/
 }
 
-static inline void generate_tap(float delay_ns, float power_db, float srate, cf_t* buf, uint32_t N, uint32_t path_delay)
+static inline void
+generate_tap(float delay_ns, float power_db, float srate, cf_t* buf, cf_t* temp, uint32_t N, uint32_t path_delay)
 {
   float amplitude = srslte_convert_dB_to_power(power_db);
   float O         = (delay_ns * 1e-9f * srate + path_delay) / (float)N;
   cf_t  a0        = amplitude / N;
 
-  srslte_vec_gen_sine(a0, -O, buf, N);
+  srslte_vec_gen_sine(a0, -O, temp, N);
+
+  // Store the response FFT shifted, so the taps can be combined without shifting
+  srslte_vec_cf_copy(buf, &temp[N / 2], N / 2);
+  srslte_vec_cf_copy(&buf[N / 2], temp, N / 2);
 }
 
-static inline void generate_taps(srslte_channel_fading_t* q, float time)
+static void generate_taps(srslte_channel_fading_t* q, double time)
 {
-  // Generate taps
-  for (int i = 0; i < nof_taps[q->model]; i++) {
-    // Compute phase for the doppler dispersion
-    cf_t a = get_doppler_dispersion(q, time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
-
-    if (i) {
-      // Copy tap frequency response
-      srslte_vec_sc_prod_ccc(q->h_tap[i], a, q->temp, q->N);
-
-      // Add to frequency response, shifts FFT at same time
-      srslte_vec_sum_ccc(q->h_freq, &q->temp[q->N / 2], q->h_freq, q->N / 2);
-      srslte_vec_sum_ccc(&q->h_freq[q->N / 2], q->temp, &q->h_freq[q->N / 2], q->N / 2);
-    } else {
-      // Copy tap frequency response
-      srslte_vec_sc_prod_ccc(&q->h_tap[i][q->N / 2], a, q->h_freq, q->N / 2);
-      srslte_vec_sc_prod_ccc(&q->h_tap[i][0], a, &q->h_freq[q->N / 2], q->N / 2);
+  uint32_t ntaps = nof_taps[q->model];
+  cf_t     a[SRSLTE_CHANNEL_FADING_MAXTAPS];
+
+  // Advance Doppler trajectory and compute the gain of each tap
+  update_trajectory(q, time);
+  for (uint32_t i = 0; i < ntaps; i++) {
+    a[i] = get_doppler_dispersion(&q->traj_a[i * SRSLTE_CHANNEL_FADING_NTERMS],
+                                  &q->traj_b[i * SRSLTE_CHANNEL_FADING_NTERMS]);
+  }
+
+  // Combine all taps in a single pass, tap responses are already FFT shifted
+  uint32_t k = 0;
+#if SRSLTE_SIMD_CF_SIZE
+  simd_cf_t _a[SRSLTE_CHANNEL_FADING_MAXTAPS];
+  for (uint32_t i = 0; i < ntaps; i++) {
+    _a[i] = srslte_simd_cf_set1(a[i]);
+  }
+
+  for (; k + SRSLTE_SIMD_CF_SIZE < q->N + 1; k += SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t acc = srslte_simd_cf_prod(_a[0], srslte_simd_cfi_load(&q->h_tap[0][k]));
+    for (uint32_t i = 1; i < ntaps; i++) {
+      acc = srslte_simd_cf_add(acc, srslte_simd_cf_prod(_a[i], srslte_simd_cfi_load(&q->h_tap[i][k])));
     }
+    srslte_simd_cfi_store(&q->h_freq[k], acc);
+  }
+#endif /* SRSLTE_SIMD_CF_SIZE */
+
+  for (; k < q->N; k++) {
+    cf_t acc = a[0] * q->h_tap[0][k];
+    for (uint32_t i = 1; i < ntaps; i++) {
+      acc += a[i] * q->h_tap[i][k];
+    }
+    q->h_freq[k] = acc;
   }
   // at this stage, q->h_freq should contain the frequency response
 }
@@ -232,6 +224,13 @@ int srslte_channel_fading_init(srslte_channel_fading_t* q, double srate, const c
     q->path_delay = q->N / 4;
     q->state_len  = 0;
 
+    // Allocate memory
+    q->temp = srslte_vec_cf_malloc(q->N);
+    if (!q->temp) {
+      fprintf(stderr, "Error: allocating h_freq\n");
+      goto clean_exit;
+    }
+
     // Initialise random number
     srslte_random_t* random = srslte_random_init(seed);
 
@@ -242,20 +241,30 @@ int srslte_channel_fading_init(srslte_channel_fading_t* q, double srate, const c
         q->coeff_a[i][j]     = srslte_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
         q->coeff_b[i][j]     = srslte_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
         q->coeff_alpha[i][j] = ((float)M_PI * ((float)i - (float)0.5f)) / (2.0f * nof_taps[q->model]);
+
+        // Doppler trajectory angular speed and its rotation for one N/2 segment
+        uint32_t k      = i * SRSLTE_CHANNEL_FADING_NTERMS + j;
+        q->traj_w[k]    = M_PI * q->doppler * cos(q->coeff_alpha[i][j]);
+        q->traj_step[k] = cexpf(_Complex_I * (float)(q->traj_w[k] * ((q->N / 2) / q->srate)));
       }
 
       // Allocate tap frequency response
       q->h_tap[i] = srslte_vec_cf_malloc(q->N);
+      if (!q->h_tap[i]) {
+        fprintf(stderr, "Error: allocating h_tap\n");
+        goto clean_exit;
+      }
 
       // Generate tap frequency response
-      generate_tap(
-          excess_tap_delay_ns[q->model][i], relative_power_db[q->model][i], q->srate, q->h_tap[i], q->N, q->path_delay);
-    }
-
-    // Generate sine Table
-    for (uint32_t i = 0; i < 1024; i++) {
-      q->sin_table[i] = sinf((float)i * 2.0f * (float)M_PI / 1024);
+      generate_tap(excess_tap_delay_ns[q->model][i],
+                   relative_power_db[q->model][i],
+                   q->srate,
+                   q->h_tap[i],
+                   q->temp,
+                   q->N,
+                   q->path_delay);
     }
+    q->traj_count = 0;
 
     // Free random
     srslte_random_free(random);
@@ -272,13 +281,6 @@ int srslte_channel_fading_init(srslte_channel_fading_t* q, double srate, const c
       goto clean_exit;
     }
 
-    // Allocate memory
-    q->temp = srslte_vec_cf_malloc(q->N);
-    if (!q->temp) {
-      fprintf(stderr, "Error: allocating h_freq\n");
-      goto clean_exit;
-    }
-
     q->h_freq = srslte_vec_cf_malloc(q->N);
     if (!q->h_freq) {
       fprintf(stderr, "Error: allocating h_freq\n");
@@ -346,7 +348,7 @@ double srslte_channel_fading_execute(srslte_channel_fading_t* q,
   if (q) {
     while (counter < nsamples) {
       // Generate taps
-      generate_taps(q, (float)init_time);
+      generate_taps(q, init_time);
 
       // Do not process more than N/2 samples
       uint32_t n = SRSLTE_MIN(q->N / 2, nsamples - counter);
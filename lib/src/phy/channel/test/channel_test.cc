@@ -0,0 +1,142 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/test_common.h"
+#include "srslte/phy/channel/channel.h"
+#include "srslte/phy/utils/vector.h"
+#include <unistd.h>
+
+static uint32_t    nof_channels = 4;
+static uint32_t    nof_workers  = 4;
+static uint32_t    nof_prb      = 100;
+static uint32_t    duration_ms  = 100;
+static std::string model        = "etu70";
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [cwpmt]\n", prog);
+  printf("\t-c Number of channels (antennas or carriers): [Default %d]\n", nof_channels);
+  printf("\t-w Number of workers: [Default %d]\n", nof_workers);
+  printf("\t-p Number of PRB: [Default %d]\n", nof_prb);
+  printf("\t-m Fading model: [Default %s]\n", model.c_str());
+  printf("\t-t Simulation time in ms: [Default %d]\n", duration_ms);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "cwpmt")) != -1) {
+    switch (opt) {
+      case 'c':
+        nof_channels = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'w':
+        nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        model = argv[optind];
+        break;
+      case 't':
+        duration_ms = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  TESTASSERT(nof_channels > 0 && nof_channels <= SRSLTE_MAX_CHANNELS);
+
+  uint32_t sf_len = (uint32_t)SRSLTE_SF_LEN_PRB(nof_prb);
+  uint32_t srate  = sf_len * 1000;
+
+  srslte::channel::args_t args;
+  args.enable        = true;
+  args.awgn_enable   = true;
+  args.awgn_n0_dBfs  = -40.0f;
+  args.fading_enable = true;
+  args.fading_model  = model;
+  args.hst_enable    = true;
+  args.delay_enable  = true;
+
+  // Serial and parallel emulators must produce the same output
+  srslte::channel serial_channel(args, nof_channels);
+  args.nof_workers = nof_workers;
+  srslte::channel parallel_channel(args, nof_channels);
+  serial_channel.set_srate(srate);
+  parallel_channel.set_srate(srate);
+
+  cf_t* buffer_serial[SRSLTE_MAX_CHANNELS]   = {};
+  cf_t* buffer_parallel[SRSLTE_MAX_CHANNELS] = {};
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    buffer_serial[i]   = srslte_vec_cf_malloc(sf_len);
+    buffer_parallel[i] = srslte_vec_cf_malloc(sf_len);
+    TESTASSERT(buffer_serial[i] != nullptr && buffer_parallel[i] != nullptr);
+  }
+
+  int ret = SRSLTE_SUCCESS;
+  for (uint32_t tti = 0; tti < duration_ms && ret == SRSLTE_SUCCESS; tti++) {
+    srslte_timestamp_t ts = {};
+    srslte_timestamp_init(&ts, tti / 1000, (tti % 1000) / 1000.0);
+
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      for (uint32_t j = 0; j < sf_len; j++) {
+        buffer_serial[i][j] = (float)((j + i) % 7) - 3.0f;
+      }
+      srslte_vec_cf_copy(buffer_parallel[i], buffer_serial[i], sf_len);
+    }
+
+    serial_channel.run(buffer_serial, buffer_serial, sf_len, ts);
+    parallel_channel.run(buffer_parallel, buffer_parallel, sf_len, ts);
+
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      if (memcmp(buffer_serial[i], buffer_parallel[i], sizeof(cf_t) * sf_len) != 0) {
+        printf("Error: channel %d mismatch at tti=%d\n", i, tti);
+        ret = SRSLTE_ERROR;
+      }
+    }
+  }
+
+  printf("channels=%d; model=%s; srate=%.2f MHz; serial=%.1f MSps; parallel=%.1f MSps (%d workers)\n",
+         nof_channels,
+         model.c_str(),
+         srate / 1e6,
+         serial_channel.get_samples_per_second() / 1e6,
+         parallel_channel.get_samples_per_second() / 1e6,
+         nof_workers);
+
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    free(buffer_serial[i]);
+    free(buffer_parallel[i]);
+  }
+
+  printf("%s\n", ret == SRSLTE_SUCCESS ? "Ok" : "Error");
+
+  return ret;
+}
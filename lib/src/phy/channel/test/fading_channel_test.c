@@ -37,6 +37,7 @@ static bool enable_gui = false;
 #endif /* ENABLE_GUI */
 
 static srslte_channel_fading_t channel_fading;
+static srslte_channel_fading_t channel_fading_ref;
 
 static char     default_model[] = "epa5";
 static uint32_t duration_ms     = 1000;
@@ -92,6 +93,7 @@ int main(int argc, char** argv)
   int            ret           = SRSLTE_ERROR;
   cf_t*          input_buffer  = NULL;
   cf_t*          output_buffer = NULL;
+  cf_t*          output_ref    = NULL;
   struct timeval t[3]          = {};
   uint64_t       time_usec     = 0;
 
@@ -157,6 +159,12 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
+  // Initialise reference channel, its Doppler trajectory is evaluated from scratch for every segment
+  if (srslte_channel_fading_init(&channel_fading_ref, srate, model, 0x12345678)) {
+    fprintf(stderr, "Error: initialising reference fading channel. model=%s, srate=%d\n", model, srate);
+    goto clean_exit;
+  }
+
   // Allocate buffers
   input_buffer = srslte_vec_cf_malloc(srate / 1000);
   if (!input_buffer) {
@@ -180,6 +188,12 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
+  output_ref = srslte_vec_cf_malloc(srate / 1000);
+  if (!output_ref) {
+    fprintf(stderr, "Error: allocating reference output buffer\n");
+    goto clean_exit;
+  }
+
   printf("-- Starting Fading channel simulator. srate=%.2fMHz; model=%s; duration=%dms\n",
          (double)srate / 1e6,
          model,
@@ -192,6 +206,23 @@ int main(int argc, char** argv)
     get_time_interval(t);
     time_usec += (uint64_t)(t->tv_sec * 1e6 + t->tv_usec);
 
+    // Run reference channel segment by segment
+    for (uint32_t j = 0; j < srate / 1000; j += channel_fading_ref.N / 2) {
+      uint32_t n                    = SRSLTE_MIN(channel_fading_ref.N / 2, srate / 1000 - j);
+      channel_fading_ref.traj_count = 0;
+      srslte_channel_fading_execute(
+          &channel_fading_ref, &input_buffer[j], &output_ref[j], n, (double)i / 1000.0 + (double)j / srate);
+    }
+
+    // Compare against reference
+    float power = srslte_vec_avg_power_cf(output_ref, srate / 1000);
+    srslte_vec_sub_ccc(output_ref, output_buffer, output_ref, srate / 1000);
+    float mse = srslte_vec_avg_power_cf(output_ref, srate / 1000);
+    if (mse > 1e-6f * power + 1e-12f) {
+      fprintf(stderr, "Error: Doppler trajectory mismatch at %d ms, mse=%e, power=%e\n", i, mse, power);
+      goto clean_exit;
+    }
+
 #ifdef ENABLE_GUI
     if (enable_gui) {
       srslte_dft_run_c_zerocopy(&fft, output_buffer, fft_buffer);
@@ -248,6 +279,10 @@ clean_exit:
   if (output_buffer) {
     free(output_buffer);
   }
+  if (output_ref) {
+    free(output_ref);
+  }
   srslte_channel_fading_free(&channel_fading);
+  srslte_channel_fading_free(&channel_fading_ref);
   return ret;
 }
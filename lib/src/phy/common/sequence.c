@@ -24,10 +24,16 @@
 #include "srslte/phy/utils/debug.h"
 #include "srslte/phy/utils/vector.h"
 
+#include <string.h>
+
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 #endif /* LV_HAVE_SSE */
 
+#ifdef HAVE_NEON
+#include <arm_neon.h>
+#endif /* HAVE_NEON */
+
 /**
  * Length of the seed, used for the feedback delay. Do not change.
  */
@@ -127,6 +133,567 @@ static inline uint32_t sequence_gen_LTE_pr_memless_step_x2(uint32_t state)
   return state;
 }
 
+/**
+ * SIMD lane-parallel generation
+ * -----------------------------
+ *
+ * Decimating an m-sequence by a power of two yields a sequence that satisfies the very same recurrence, since over
+ * GF(2) p(x)^(2^k) = p(x^(2^k)). Hence, lane r of a register with N lanes can run the unmodified parallel x1/x2 steps
+ * over the decimated sequence x(N * n + r). One parallel step of all lanes produces SEQUENCE_PAR_BITS * N contiguous
+ * sequence bits, where bit j of lane r is the sequence bit N * j + r of the block.
+ *
+ * This layout maps directly onto the data: for every bit j, lane r masks element N * j + r, so N floats take the mask of
+ * one bit, 2N int16 the masks of two consecutive bits and 4N int8 the masks of four consecutive bits.
+ */
+#ifdef LV_HAVE_AVX2
+#define SEQUENCE_SIMD_LANES (8U)
+typedef __m256i sequence_simd_t;
+typedef __m256i sequence_simd_s_t;
+typedef __m256i sequence_simd_b_t;
+#define SEQUENCE_SIMD_LOADU(PTR) _mm256_loadu_si256((__m256i*)(PTR))
+#define SEQUENCE_SIMD_STOREU(PTR, V) _mm256_storeu_si256((__m256i*)(PTR), V)
+#define SEQUENCE_SIMD_SET1(X) _mm256_set1_epi32(X)
+#define SEQUENCE_SIMD_XOR(A, B) _mm256_xor_si256(A, B)
+#define SEQUENCE_SIMD_AND(A, B) _mm256_and_si256(A, B)
+#define SEQUENCE_SIMD_SRLI(V, N) _mm256_srli_epi32(V, N)
+#define SEQUENCE_SIMD_SLLI(V, N) _mm256_slli_epi32(V, N)
+#define SEQUENCE_SIMD_SRAI(V, N) _mm256_srai_epi32(V, N)
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+#define SEQUENCE_SIMD_LANES (4U)
+typedef __m128i sequence_simd_t;
+typedef __m128i sequence_simd_s_t;
+typedef __m128i sequence_simd_b_t;
+#define SEQUENCE_SIMD_LOADU(PTR) _mm_loadu_si128((__m128i*)(PTR))
+#define SEQUENCE_SIMD_STOREU(PTR, V) _mm_storeu_si128((__m128i*)(PTR), V)
+#define SEQUENCE_SIMD_SET1(X) _mm_set1_epi32(X)
+#define SEQUENCE_SIMD_XOR(A, B) _mm_xor_si128(A, B)
+#define SEQUENCE_SIMD_AND(A, B) _mm_and_si128(A, B)
+#define SEQUENCE_SIMD_SRLI(V, N) _mm_srli_epi32(V, N)
+#define SEQUENCE_SIMD_SLLI(V, N) _mm_slli_epi32(V, N)
+#define SEQUENCE_SIMD_SRAI(V, N) _mm_srai_epi32(V, N)
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+#define SEQUENCE_SIMD_LANES (4U)
+typedef uint32x4_t sequence_simd_t;
+typedef int16x8_t  sequence_simd_s_t;
+typedef int8x16_t  sequence_simd_b_t;
+#define SEQUENCE_SIMD_LOADU(PTR) vld1q_u32((uint32_t*)(PTR))
+#define SEQUENCE_SIMD_STOREU(PTR, V) vst1q_u32((uint32_t*)(PTR), V)
+#define SEQUENCE_SIMD_SET1(X) vdupq_n_u32(X)
+#define SEQUENCE_SIMD_XOR(A, B) veorq_u32(A, B)
+#define SEQUENCE_SIMD_AND(A, B) vandq_u32(A, B)
+#define SEQUENCE_SIMD_SRLI(V, N) vshrq_n_u32(V, N)
+#define SEQUENCE_SIMD_SLLI(V, N) vshlq_n_u32(V, N)
+#define SEQUENCE_SIMD_SRAI(V, N) vreinterpretq_u32_s32(vshrq_n_s32(vreinterpretq_s32_u32(V), N))
+#else /* HAVE_NEON */
+#define SEQUENCE_SIMD_LANES (0U)
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+
+#if SEQUENCE_SIMD_LANES
+
+/**
+ * Number of sequence bits generated by every SIMD parallel step
+ */
+#define SEQUENCE_SIMD_BITS (SEQUENCE_PAR_BITS * SEQUENCE_SIMD_LANES)
+
+/**
+ * Pre-computed lane states after Nc shifts, split in the same way than sequence_x1_init and sequence_x2_init
+ */
+static uint32_t sequence_x1_lane_init[SEQUENCE_SIMD_LANES]                    = {};
+static uint32_t sequence_x2_lane_init[SEQUENCE_SEED_LEN][SEQUENCE_SIMD_LANES] = {};
+
+/**
+ * Splits a scalar state into SEQUENCE_SIMD_LANES decimated lane states
+ * @param state scalar 31 bit state
+ * @param step single bit step function of the sequence
+ * @param lanes output lane states
+ */
+static void sequence_simd_split(uint32_t state, uint32_t (*step)(uint32_t), uint32_t* lanes)
+{
+  for (uint32_t r = 0; r < SEQUENCE_SIMD_LANES; r++) {
+    lanes[r] = 0;
+  }
+
+  for (uint32_t n = 0; n < SEQUENCE_SEED_LEN * SEQUENCE_SIMD_LANES; n++) {
+    lanes[n % SEQUENCE_SIMD_LANES] |= (state & 1U) << (n / SEQUENCE_SIMD_LANES);
+    state = step(state);
+  }
+}
+
+/**
+ * Merges the lane states back into the scalar state of the first sequence bit that has not been generated yet
+ * @param v lane states
+ * @return scalar 31 bit state
+ */
+static inline uint32_t sequence_simd_merge(sequence_simd_t v)
+{
+  uint32_t lanes[SEQUENCE_SIMD_LANES];
+  uint32_t state = 0;
+
+  SEQUENCE_SIMD_STOREU(lanes, v);
+
+  for (uint32_t i = 0; i < SEQUENCE_SEED_LEN; i++) {
+    state |= ((lanes[i % SEQUENCE_SIMD_LANES] >> (i / SEQUENCE_SIMD_LANES)) & 1U) << i;
+  }
+
+  return state;
+}
+
+/**
+ * Loads x1 and x2 lane states for a given seed
+ */
+static inline void sequence_simd_init(uint32_t seed, sequence_simd_t* x1, sequence_simd_t* x2)
+{
+  *x1 = SEQUENCE_SIMD_LOADU(sequence_x1_lane_init);
+  *x2 = SEQUENCE_SIMD_SET1(0);
+
+  for (uint32_t i = 0; i < SEQUENCE_SEED_LEN; i++) {
+    if ((seed >> i) & 1U) {
+      *x2 = SEQUENCE_SIMD_XOR(*x2, SEQUENCE_SIMD_LOADU(sequence_x2_lane_init[i]));
+    }
+  }
+}
+
+/**
+ * Computes one step of the X1 sequence for SEQUENCE_PAR_BITS in every lane
+ */
+static inline sequence_simd_t sequence_simd_step_par_x1(sequence_simd_t state)
+{
+  sequence_simd_t f = SEQUENCE_SIMD_XOR(state, SEQUENCE_SIMD_SRLI(state, 3));
+
+  f = SEQUENCE_SIMD_SLLI(SEQUENCE_SIMD_AND(f, SEQUENCE_SIMD_SET1(SEQUENCE_MASK)),
+                         SEQUENCE_SEED_LEN - SEQUENCE_PAR_BITS);
+
+  return SEQUENCE_SIMD_XOR(SEQUENCE_SIMD_SRLI(state, SEQUENCE_PAR_BITS), f);
+}
+
+/**
+ * Computes one step of the X2 sequence for SEQUENCE_PAR_BITS in every lane
+ */
+static inline sequence_simd_t sequence_simd_step_par_x2(sequence_simd_t state)
+{
+  sequence_simd_t f = SEQUENCE_SIMD_XOR(state, SEQUENCE_SIMD_SRLI(state, 1));
+  f                 = SEQUENCE_SIMD_XOR(f, SEQUENCE_SIMD_SRLI(state, 2));
+  f                 = SEQUENCE_SIMD_XOR(f, SEQUENCE_SIMD_SRLI(state, 3));
+
+  f = SEQUENCE_SIMD_SLLI(SEQUENCE_SIMD_AND(f, SEQUENCE_SIMD_SET1(SEQUENCE_MASK)),
+                         SEQUENCE_SEED_LEN - SEQUENCE_PAR_BITS);
+
+  return SEQUENCE_SIMD_XOR(SEQUENCE_SIMD_SRLI(state, SEQUENCE_PAR_BITS), f);
+}
+
+/**
+ * Expands the LSB of every lane into a 32 bit mask (0 or -1)
+ */
+#define SEQUENCE_SIMD_MASK(C, B) SEQUENCE_SIMD_SRAI(SEQUENCE_SIMD_SLLI(C, 31 - (B)), 31)
+
+/**
+ * Packs the 32 bit masks of two consecutive sequence bits into 2N int16 masks in sequence order
+ */
+static inline sequence_simd_s_t sequence_simd_pack_s(sequence_simd_t m0, sequence_simd_t m1)
+{
+#ifdef LV_HAVE_AVX2
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(m0, m1), 0xD8);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_packs_epi32(m0, m1);
+#else /* LV_HAVE_SSE */
+  return vcombine_s16(vmovn_s32(vreinterpretq_s32_u32(m0)), vmovn_s32(vreinterpretq_s32_u32(m1)));
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+}
+
+/**
+ * Packs the 32 bit masks of four consecutive sequence bits into 4N int8 masks in sequence order
+ */
+static inline sequence_simd_b_t
+sequence_simd_pack_b(sequence_simd_t m0, sequence_simd_t m1, sequence_simd_t m2, sequence_simd_t m3)
+{
+#ifdef LV_HAVE_AVX2
+  __m256i b = _mm256_packs_epi16(_mm256_packs_epi32(m0, m1), _mm256_packs_epi32(m2, m3));
+  return _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_packs_epi32(m2, m3));
+#else /* LV_HAVE_SSE */
+  return vcombine_s8(vmovn_s16(sequence_simd_pack_s(m0, m1)), vmovn_s16(sequence_simd_pack_s(m2, m3)));
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+}
+
+/**
+ * Writes the 4N int8 masks as 4N / 8 bytes of packed bits, MSB first
+ */
+static inline void sequence_simd_b_pack(sequence_simd_b_t m, uint8_t* packed)
+{
+#ifdef LV_HAVE_AVX2
+  const __m256i rev  = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,  // Low lane
+                                       7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8); // High lane
+  uint32_t      bits = (uint32_t)_mm256_movemask_epi8(_mm256_shuffle_epi8(m, rev));
+  memcpy(packed, &bits, sizeof(bits));
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  const __m128i rev  = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  uint16_t      bits = (uint16_t)_mm_movemask_epi8(_mm_shuffle_epi8(m, rev));
+  memcpy(packed, &bits, sizeof(bits));
+#else  /* LV_HAVE_SSE */
+  int8_t mask[4 * SEQUENCE_SIMD_LANES];
+  vst1q_s8(mask, m);
+  for (uint32_t i = 0; i < 4 * SEQUENCE_SIMD_LANES / 8; i++) {
+    packed[i] = 0;
+    for (uint32_t k = 0; k < 8; k++) {
+      packed[i] |= (uint8_t)((mask[8 * i + k] & 1U) << (7U - k));
+    }
+  }
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+}
+
+static inline sequence_simd_s_t sequence_simd_s_loadu(const int16_t* ptr)
+{
+#ifdef HAVE_NEON
+  return vld1q_s16(ptr);
+#else  /* HAVE_NEON */
+  return SEQUENCE_SIMD_LOADU(ptr);
+#endif /* HAVE_NEON */
+}
+
+static inline void sequence_simd_s_storeu(int16_t* ptr, sequence_simd_s_t v)
+{
+#ifdef HAVE_NEON
+  vst1q_s16(ptr, v);
+#else  /* HAVE_NEON */
+  SEQUENCE_SIMD_STOREU(ptr, v);
+#endif /* HAVE_NEON */
+}
+
+/**
+ * Negates the int16 elements selected by the mask, (v ^ m) - m
+ */
+static inline sequence_simd_s_t sequence_simd_s_neg(sequence_simd_s_t v, sequence_simd_s_t m)
+{
+#ifdef LV_HAVE_AVX2
+  return _mm256_sub_epi16(_mm256_xor_si256(v, m), m);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_sub_epi16(_mm_xor_si128(v, m), m);
+#else  /* LV_HAVE_SSE */
+  return vsubq_s16(veorq_s16(v, m), m);
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+}
+
+/**
+ * Converts the int16 masks into +1/-1 values
+ */
+static inline sequence_simd_s_t sequence_simd_s_sign(sequence_simd_s_t m)
+{
+#ifdef LV_HAVE_AVX2
+  return _mm256_or_si256(m, _mm256_set1_epi16(1));
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_or_si128(m, _mm_set1_epi16(1));
+#else  /* LV_HAVE_SSE */
+  return vorrq_s16(m, vdupq_n_s16(1));
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+}
+
+static inline sequence_simd_b_t sequence_simd_b_loadu(const int8_t* ptr)
+{
+#ifdef HAVE_NEON
+  return vld1q_s8(ptr);
+#else  /* HAVE_NEON */
+  return SEQUENCE_SIMD_LOADU(ptr);
+#endif /* HAVE_NEON */
+}
+
+static inline void sequence_simd_b_storeu(int8_t* ptr, sequence_simd_b_t v)
+{
+#ifdef HAVE_NEON
+  vst1q_s8(ptr, v);
+#else  /* HAVE_NEON */
+  SEQUENCE_SIMD_STOREU(ptr, v);
+#endif /* HAVE_NEON */
+}
+
+/**
+ * Negates the int8 elements selected by the mask, (v ^ m) - m
+ */
+static inline sequence_simd_b_t sequence_simd_b_neg(sequence_simd_b_t v, sequence_simd_b_t m)
+{
+#ifdef LV_HAVE_AVX2
+  return _mm256_sub_epi8(_mm256_xor_si256(v, m), m);
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_sub_epi8(_mm_xor_si128(v, m), m);
+#else  /* LV_HAVE_SSE */
+  return vsubq_s8(veorq_s8(v, m), m);
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+}
+
+/**
+ * Converts the int8 masks into +1/-1 values (sign == true) or into 0/1 bits (sign == false)
+ */
+static inline sequence_simd_b_t sequence_simd_b_value(sequence_simd_b_t m, bool sign)
+{
+#ifdef LV_HAVE_AVX2
+  return sign ? _mm256_or_si256(m, _mm256_set1_epi8(1)) : _mm256_and_si256(m, _mm256_set1_epi8(1));
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return sign ? _mm_or_si128(m, _mm_set1_epi8(1)) : _mm_and_si128(m, _mm_set1_epi8(1));
+#else  /* LV_HAVE_SSE */
+  return sign ? vorrq_s8(m, vdupq_n_s8(1)) : vandq_s8(m, vdupq_n_s8(1));
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+}
+
+/**
+ * Generates SEQUENCE_SIMD_BITS sequence bits in all the sequence object representations
+ */
+static inline void sequence_simd_gen_block(sequence_simd_t c, srslte_sequence_t* q, uint32_t offset)
+{
+  const sequence_simd_t sign = SEQUENCE_SIMD_SET1(0x80000000);
+  const sequence_simd_t one  = SEQUENCE_SIMD_SET1(0x3f800000); // +1.0F
+
+  for (uint32_t j = 0; j < SEQUENCE_PAR_BITS; j += 4) {
+    uint32_t n = offset + j * SEQUENCE_SIMD_LANES;
+
+    sequence_simd_t m0 = SEQUENCE_SIMD_MASK(c, 0);
+    sequence_simd_t m1 = SEQUENCE_SIMD_MASK(c, 1);
+    sequence_simd_t m2 = SEQUENCE_SIMD_MASK(c, 2);
+    sequence_simd_t m3 = SEQUENCE_SIMD_MASK(c, 3);
+    c                  = SEQUENCE_SIMD_SRLI(c, 4);
+
+    // Float
+    SEQUENCE_SIMD_STOREU(q->c_float + n, SEQUENCE_SIMD_XOR(one, SEQUENCE_SIMD_AND(m0, sign)));
+    SEQUENCE_SIMD_STOREU(q->c_float + n + SEQUENCE_SIMD_LANES, SEQUENCE_SIMD_XOR(one, SEQUENCE_SIMD_AND(m1, sign)));
+    SEQUENCE_SIMD_STOREU(q->c_float + n + 2 * SEQUENCE_SIMD_LANES,
+                         SEQUENCE_SIMD_XOR(one, SEQUENCE_SIMD_AND(m2, sign)));
+    SEQUENCE_SIMD_STOREU(q->c_float + n + 3 * SEQUENCE_SIMD_LANES,
+                         SEQUENCE_SIMD_XOR(one, SEQUENCE_SIMD_AND(m3, sign)));
+
+    // Short
+    sequence_simd_s_storeu(q->c_short + n, sequence_simd_s_sign(sequence_simd_pack_s(m0, m1)));
+    sequence_simd_s_storeu(q->c_short + n + 2 * SEQUENCE_SIMD_LANES,
+                           sequence_simd_s_sign(sequence_simd_pack_s(m2, m3)));
+
+    // Char, unpacked and packed bits
+    sequence_simd_b_t m = sequence_simd_pack_b(m0, m1, m2, m3);
+    sequence_simd_b_storeu(q->c_char + n, sequence_simd_b_value(m, true));
+    sequence_simd_b_storeu((int8_t*)q->c + n, sequence_simd_b_value(m, false));
+    sequence_simd_b_pack(m, q->c_bytes + n / 8);
+  }
+}
+
+/**
+ * Generates in the sequence object as many SIMD blocks as fit in len
+ * @return the number of generated bits, x1 and x2 are updated to the state of the next bit
+ */
+static inline uint32_t sequence_simd_gen(srslte_sequence_t* q, uint32_t len, uint32_t seed, uint32_t* x1, uint32_t* x2)
+{
+  uint32_t n = 0;
+
+  if (len >= SEQUENCE_SIMD_BITS) {
+    sequence_simd_t v1, v2;
+    sequence_simd_init(seed, &v1, &v2);
+
+    for (; n < len - (SEQUENCE_SIMD_BITS - 1); n += SEQUENCE_SIMD_BITS) {
+      sequence_simd_gen_block(SEQUENCE_SIMD_XOR(v1, v2), q, n);
+
+      v1 = sequence_simd_step_par_x1(v1);
+      v2 = sequence_simd_step_par_x2(v2);
+    }
+
+    *x1 = sequence_simd_merge(v1);
+    *x2 = sequence_simd_merge(v2);
+  }
+
+  return n;
+}
+
+/**
+ * Generates the unpacked sequence bits of as many SIMD blocks as fit in len
+ * @return the number of generated bits, x1 and x2 are updated to the state of the next bit
+ */
+static inline uint32_t sequence_simd_gen_bits(uint8_t* pr, uint32_t len, uint32_t seed, uint32_t* x1, uint32_t* x2)
+{
+  uint32_t n = 0;
+
+  if (len >= SEQUENCE_SIMD_BITS) {
+    sequence_simd_t v1, v2;
+    sequence_simd_init(seed, &v1, &v2);
+
+    for (; n < len - (SEQUENCE_SIMD_BITS - 1); n += SEQUENCE_SIMD_BITS) {
+      sequence_simd_t c = SEQUENCE_SIMD_XOR(v1, v2);
+
+      for (uint32_t j = 0; j < SEQUENCE_PAR_BITS; j += 4) {
+        sequence_simd_b_t m = sequence_simd_pack_b(
+            SEQUENCE_SIMD_MASK(c, 0), SEQUENCE_SIMD_MASK(c, 1), SEQUENCE_SIMD_MASK(c, 2), SEQUENCE_SIMD_MASK(c, 3));
+        sequence_simd_b_storeu((int8_t*)pr + n + j * SEQUENCE_SIMD_LANES, sequence_simd_b_value(m, false));
+        c = SEQUENCE_SIMD_SRLI(c, 4);
+      }
+
+      v1 = sequence_simd_step_par_x1(v1);
+      v2 = sequence_simd_step_par_x2(v2);
+    }
+
+    *x1 = sequence_simd_merge(v1);
+    *x2 = sequence_simd_merge(v2);
+  }
+
+  return n;
+}
+
+/**
+ * Applies the sequence sign to as many SIMD blocks of floats as fit in length
+ * @return the number of processed elements, x1 and x2 are updated to the state of the next element
+ */
+static inline uint32_t
+sequence_simd_apply_f(const float* in, float* out, uint32_t length, uint32_t seed, uint32_t* x1, uint32_t* x2)
+{
+  uint32_t i = 0;
+
+  if (length >= SEQUENCE_SIMD_BITS) {
+    sequence_simd_t v1, v2;
+    sequence_simd_init(seed, &v1, &v2);
+
+    for (; i < length - (SEQUENCE_SIMD_BITS - 1); i += SEQUENCE_SIMD_BITS) {
+      sequence_simd_t c = SEQUENCE_SIMD_XOR(v1, v2);
+
+      for (uint32_t j = 0; j < SEQUENCE_PAR_BITS; j++) {
+        uint32_t n = i + j * SEQUENCE_SIMD_LANES;
+
+        // Move the sequence bit into the float sign and XOR
+        SEQUENCE_SIMD_STOREU(out + n, SEQUENCE_SIMD_XOR(SEQUENCE_SIMD_LOADU(in + n), SEQUENCE_SIMD_SLLI(c, 31)));
+        c = SEQUENCE_SIMD_SRLI(c, 1);
+      }
+
+      v1 = sequence_simd_step_par_x1(v1);
+      v2 = sequence_simd_step_par_x2(v2);
+    }
+
+    *x1 = sequence_simd_merge(v1);
+    *x2 = sequence_simd_merge(v2);
+  }
+
+  return i;
+}
+
+/**
+ * Applies the sequence sign to as many SIMD blocks of int16 as fit in length
+ * @return the number of processed elements, x1 and x2 are updated to the state of the next element
+ */
+static inline uint32_t
+sequence_simd_apply_s(const int16_t* in, int16_t* out, uint32_t length, uint32_t seed, uint32_t* x1, uint32_t* x2)
+{
+  uint32_t i = 0;
+
+  if (length >= SEQUENCE_SIMD_BITS) {
+    sequence_simd_t v1, v2;
+    sequence_simd_init(seed, &v1, &v2);
+
+    for (; i < length - (SEQUENCE_SIMD_BITS - 1); i += SEQUENCE_SIMD_BITS) {
+      sequence_simd_t c = SEQUENCE_SIMD_XOR(v1, v2);
+
+      for (uint32_t j = 0; j < SEQUENCE_PAR_BITS; j += 2) {
+        uint32_t          n = i + j * SEQUENCE_SIMD_LANES;
+        sequence_simd_s_t m = sequence_simd_pack_s(SEQUENCE_SIMD_MASK(c, 0), SEQUENCE_SIMD_MASK(c, 1));
+        sequence_simd_s_storeu(out + n, sequence_simd_s_neg(sequence_simd_s_loadu(in + n), m));
+        c = SEQUENCE_SIMD_SRLI(c, 2);
+      }
+
+      v1 = sequence_simd_step_par_x1(v1);
+      v2 = sequence_simd_step_par_x2(v2);
+    }
+
+    *x1 = sequence_simd_merge(v1);
+    *x2 = sequence_simd_merge(v2);
+  }
+
+  return i;
+}
+
+/**
+ * Applies the sequence sign to as many SIMD blocks of int8 as fit in length
+ * @return the number of processed elements, x1 and x2 are updated to the state of the next element
+ */
+static inline uint32_t
+sequence_simd_apply_c(const int8_t* in, int8_t* out, uint32_t length, uint32_t seed, uint32_t* x1, uint32_t* x2)
+{
+  uint32_t i = 0;
+
+  if (length >= SEQUENCE_SIMD_BITS) {
+    sequence_simd_t v1, v2;
+    sequence_simd_init(seed, &v1, &v2);
+
+    for (; i < length - (SEQUENCE_SIMD_BITS - 1); i += SEQUENCE_SIMD_BITS) {
+      sequence_simd_t c = SEQUENCE_SIMD_XOR(v1, v2);
+
+      for (uint32_t j = 0; j < SEQUENCE_PAR_BITS; j += 4) {
+        uint32_t          n = i + j * SEQUENCE_SIMD_LANES;
+        sequence_simd_b_t m = sequence_simd_pack_b(
+            SEQUENCE_SIMD_MASK(c, 0), SEQUENCE_SIMD_MASK(c, 1), SEQUENCE_SIMD_MASK(c, 2), SEQUENCE_SIMD_MASK(c, 3));
+        sequence_simd_b_storeu(out + n, sequence_simd_b_neg(sequence_simd_b_loadu(in + n), m));
+        c = SEQUENCE_SIMD_SRLI(c, 4);
+      }
+
+      v1 = sequence_simd_step_par_x1(v1);
+      v2 = sequence_simd_step_par_x2(v2);
+    }
+
+    *x1 = sequence_simd_merge(v1);
+    *x2 = sequence_simd_merge(v2);
+  }
+
+  return i;
+}
+
+/**
+ * XORs the sequence to as many SIMD blocks of packed bits as fit in length
+ * @return the number of processed bits, x1 and x2 are updated to the state of the next bit
+ */
+static inline uint32_t
+sequence_simd_apply_packed(const uint8_t* in, uint8_t* out, uint32_t length, uint32_t seed, uint32_t* x1, uint32_t* x2)
+{
+  uint32_t i = 0;
+
+  if (length >= SEQUENCE_SIMD_BITS) {
+    sequence_simd_t v1, v2;
+    sequence_simd_init(seed, &v1, &v2);
+
+    for (; i < length - (SEQUENCE_SIMD_BITS - 1); i += SEQUENCE_SIMD_BITS) {
+      sequence_simd_t c = SEQUENCE_SIMD_XOR(v1, v2);
+      uint8_t         c_packed[SEQUENCE_SIMD_BITS / 8];
+
+      for (uint32_t j = 0; j < SEQUENCE_PAR_BITS; j += 4) {
+        sequence_simd_b_t m = sequence_simd_pack_b(
+            SEQUENCE_SIMD_MASK(c, 0), SEQUENCE_SIMD_MASK(c, 1), SEQUENCE_SIMD_MASK(c, 2), SEQUENCE_SIMD_MASK(c, 3));
+        sequence_simd_b_pack(m, c_packed + j * SEQUENCE_SIMD_LANES / 8);
+        c = SEQUENCE_SIMD_SRLI(c, 4);
+      }
+
+      for (uint32_t k = 0; k < SEQUENCE_SIMD_BITS / 8; k++) {
+        out[i / 8 + k] = in[i / 8 + k] ^ c_packed[k];
+      }
+
+      v1 = sequence_simd_step_par_x1(v1);
+      v2 = sequence_simd_step_par_x2(v2);
+    }
+
+    *x1 = sequence_simd_merge(v1);
+    *x2 = sequence_simd_merge(v2);
+  }
+
+  return i;
+}
+
+#endif /* SEQUENCE_SIMD_LANES */
+
 /**
  * Static precomputed x1 and x2 states after Nc shifts
  * -------------------------------------------------------
@@ -166,6 +733,14 @@ __attribute__((constructor)) __attribute__((unused)) static void srslte_lte_pr_p
       sequence_x2_init[i] = sequence_gen_LTE_pr_memless_step_x2(sequence_x2_init[i]);
     }
   }
+
+#if SEQUENCE_SIMD_LANES
+  // Split the initial states into decimated lanes
+  sequence_simd_split(sequence_x1_init, sequence_gen_LTE_pr_memless_step_x1, sequence_x1_lane_init);
+  for (uint32_t i = 0; i < SEQUENCE_SEED_LEN; i++) {
+    sequence_simd_split(sequence_x2_init[i], sequence_gen_LTE_pr_memless_step_x2, sequence_x2_lane_init[i]);
+  }
+#endif /* SEQUENCE_SIMD_LANES */
 }
 
 static uint32_t sequence_get_x2_init(uint32_t seed)
@@ -181,11 +756,9 @@ static uint32_t sequence_get_x2_init(uint32_t seed)
   return x2;
 }
 
-static void sequence_gen_LTE_pr(uint8_t* pr, uint32_t len, uint32_t seed)
+static void sequence_gen_LTE_pr_state(uint8_t* pr, uint32_t len, uint32_t x1, uint32_t x2)
 {
-  int      n  = 0;
-  uint32_t x1 = sequence_x1_init;           // X1 initial state is fix
-  uint32_t x2 = sequence_get_x2_init(seed); // loads x2 initial state
+  uint32_t n = 0;
 
   // Parallel stage
   if (len >= SEQUENCE_PAR_BITS) {
@@ -215,6 +788,20 @@ static void sequence_gen_LTE_pr(uint8_t* pr, uint32_t len, uint32_t seed)
   }
 }
 
+static void sequence_gen_LTE_pr(uint8_t* pr, uint32_t len, uint32_t seed)
+{
+  uint32_t n  = 0;
+  uint32_t x1 = sequence_x1_init;           // X1 initial state is fix
+  uint32_t x2 = sequence_get_x2_init(seed); // loads x2 initial state
+
+#if SEQUENCE_SIMD_LANES
+  // SIMD stage
+  n = sequence_simd_gen_bits(pr, len, seed, &x1, &x2);
+#endif /* SEQUENCE_SIMD_LANES */
+
+  sequence_gen_LTE_pr_state(pr + n, len - n, x1, x2);
+}
+
 // static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 int srslte_sequence_set_LTE_pr(srslte_sequence_t* q, uint32_t len, uint32_t seed)
 {
@@ -299,14 +886,28 @@ int srslte_sequence_LTE_pr(srslte_sequence_t* q, uint32_t len, uint32_t seed)
   }
   q->cur_len = len;
 
+  uint32_t n = 0;
+
+#if SEQUENCE_SIMD_LANES
+  // Generate all the representations at once for the SIMD stage
+  uint32_t x1 = 0;
+  uint32_t x2 = 0;
+  n           = sequence_simd_gen(q, len, seed, &x1, &x2);
+  if (n) {
+    sequence_gen_LTE_pr_state(q->c + n, len - n, x1, x2);
+  }
+#endif /* SEQUENCE_SIMD_LANES */
+
   // Generate sequence
-  srslte_sequence_set_LTE_pr(q, len, seed);
+  if (n == 0) {
+    srslte_sequence_set_LTE_pr(q, len, seed);
+  }
 
   // Pack PR sequence
-  srslte_bit_pack_vector(q->c, q->c_bytes, len);
+  srslte_bit_pack_vector(q->c + n, q->c_bytes + n / 8, len - n);
 
   // Generate signed type values
-  sequence_generate_signed(q->c, q->c_char, q->c_short, q->c_float, len);
+  sequence_generate_signed(q->c + n, q->c_char + n, q->c_short + n, q->c_float + n, len - n);
 
   return SRSLTE_SUCCESS;
 }
@@ -369,6 +970,11 @@ void srslte_sequence_apply_f(const float* in, float* out, uint32_t length, uint3
 
   uint32_t i = 0;
 
+#if SEQUENCE_SIMD_LANES
+  // SIMD stage
+  i = sequence_simd_apply_f(in, out, length, seed, &x1, &x2);
+#endif /* SEQUENCE_SIMD_LANES */
+
   if (length >= SEQUENCE_PAR_BITS) {
     for (; i < length - (SEQUENCE_PAR_BITS - 1); i += SEQUENCE_PAR_BITS) {
       uint32_t c = (uint32_t)(x1 ^ x2);
@@ -398,7 +1004,7 @@ void srslte_sequence_apply_f(const float* in, float* out, uint32_t length, uint3
       }
 #endif
       for (; j < SEQUENCE_PAR_BITS; j++) {
-        ((uint32_t*)out)[i + j] = ((uint32_t*)in)[i] ^ (((c >> j) & 1U) << 31U);
+        ((uint32_t*)out)[i + j] = ((uint32_t*)in)[i + j] ^ (((c >> j) & 1U) << 31U);
       }
 
       // Step sequences
@@ -424,6 +1030,11 @@ void srslte_sequence_apply_s(const int16_t* in, int16_t* out, uint32_t length, u
 
   uint32_t i = 0;
 
+#if SEQUENCE_SIMD_LANES
+  // SIMD stage
+  i = sequence_simd_apply_s(in, out, length, seed, &x1, &x2);
+#endif /* SEQUENCE_SIMD_LANES */
+
   if (length >= SEQUENCE_PAR_BITS) {
     for (; i < length - (SEQUENCE_PAR_BITS - 1); i += SEQUENCE_PAR_BITS) {
       uint32_t c = (uint32_t)(x1 ^ x2);
@@ -479,6 +1090,11 @@ void srslte_sequence_apply_c(const int8_t* in, int8_t* out, uint32_t length, uin
 
   uint32_t i = 0;
 
+#if SEQUENCE_SIMD_LANES
+  // SIMD stage
+  i = sequence_simd_apply_c(in, out, length, seed, &x1, &x2);
+#endif /* SEQUENCE_SIMD_LANES */
+
   if (length >= SEQUENCE_PAR_BITS) {
     for (; i < length - (SEQUENCE_PAR_BITS - 1); i += SEQUENCE_PAR_BITS) {
       uint32_t c = (uint32_t)(x1 ^ x2);
@@ -530,4 +1146,29 @@ void srslte_sequence_apply_c(const int8_t* in, int8_t* out, uint32_t length, uin
     x1 = sequence_gen_LTE_pr_memless_step_x1(x1);
     x2 = sequence_gen_LTE_pr_memless_step_x2(x2);
   }
-}
\ No newline at end of file
+}
+
+void srslte_sequence_apply_packed(const uint8_t* in, uint8_t* out, uint32_t length, uint32_t seed)
+{
+  uint32_t x1 = sequence_x1_init;           // X1 initial state is fix
+  uint32_t x2 = sequence_get_x2_init(seed); // loads x2 initial state
+
+  uint32_t i = 0;
+
+#if SEQUENCE_SIMD_LANES
+  // SIMD stage
+  i = sequence_simd_apply_packed(in, out, length, seed, &x1, &x2);
+#endif /* SEQUENCE_SIMD_LANES */
+
+  // Single step, MSB first
+  for (; i < length; i++) {
+    if (i % 8 == 0) {
+      out[i / 8] = in[i / 8];
+    }
+    out[i / 8] ^= (uint8_t)(((x1 ^ x2) & 1U) << (7U - i % 8U));
+
+    // Step sequences
+    x1 = sequence_gen_LTE_pr_memless_step_x1(x1);
+    x2 = sequence_gen_LTE_pr_memless_step_x2(x2);
+  }
+}
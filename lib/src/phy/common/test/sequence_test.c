@@ -23,6 +23,8 @@
 #include <srslte/phy/common/sequence.h>
 #include <srslte/phy/utils/bit.h>
 #include <srslte/phy/utils/random.h>
+#include <srslte/phy/utils/vector.h>
+#include <unistd.h>
 
 #define Nc 1600
 #define MAX_SEQ_LEN (256 * 1024)
@@ -34,12 +36,46 @@ static float   c_float[Nc + MAX_SEQ_LEN + 31];
 static int16_t c_short[Nc + MAX_SEQ_LEN + 31];
 static int8_t  c_char[Nc + MAX_SEQ_LEN + 31];
 static uint8_t c_packed[MAX_SEQ_LEN / 8];
+static uint8_t c_packed_xor[MAX_SEQ_LEN / 8];
 
 static float   ones_float[Nc + MAX_SEQ_LEN + 31];
 static int16_t ones_short[Nc + MAX_SEQ_LEN + 31];
 static int8_t  ones_char[Nc + MAX_SEQ_LEN + 31];
 static uint8_t ones_packed[MAX_SEQ_LEN / 8];
 
+static uint32_t repetitions = 1;
+static uint32_t min_length  = 16;
+static uint32_t max_length  = MAX_SEQ_LEN;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [rmM]\n", prog);
+  printf("\t-r Number of repetitions for the benchmark [Default %d]\n", repetitions);
+  printf("\t-m Minimum sequence length [Default %d]\n", min_length);
+  printf("\t-M Maximum sequence length [Default %d]\n", max_length);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "rmM")) != -1) {
+    switch (opt) {
+      case 'r':
+        repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        min_length = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'M':
+        max_length = SRSLTE_MIN((uint32_t)strtol(argv[optind], NULL, 10), MAX_SEQ_LEN);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
 static int test_sequence(srslte_sequence_t* sequence, uint32_t seed, uint32_t length, uint32_t repetitions)
 {
   int            ret                   = SRSLTE_SUCCESS;
@@ -48,6 +84,7 @@ static int test_sequence(srslte_sequence_t* sequence, uint32_t seed, uint32_t le
   uint64_t       interval_xor_float_us = 0;
   uint64_t       interval_xor_short_us = 0;
   uint64_t       interval_xor_char_us  = 0;
+  uint64_t       interval_xor_bit_us   = 0;
 
   gettimeofday(&t[1], NULL);
 
@@ -145,23 +182,43 @@ static int test_sequence(srslte_sequence_t* sequence, uint32_t seed, uint32_t le
     ret = SRSLTE_ERROR;
   }
 
-  printf("%08x; %8d; %8.1f; %8.1f; %8.1f; %8.1f; %8c\n",
+  // Test packed XOR
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < repetitions; r++) {
+    srslte_sequence_apply_packed(ones_packed, c_packed_xor, length, seed);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  interval_xor_bit_us = t->tv_sec * 1000000UL + t->tv_usec;
+
+  for (uint32_t i = 0; i < (length + 7) / 8; i++) {
+    // Bits beyond length shall not be modified
+    uint8_t mask = (i < length / 8) ? UINT8_MAX : (uint8_t)(UINT8_MAX << (8 - length % 8));
+    if ((c_packed_xor[i] ^ ones_packed[i]) != (c_packed[i] & mask)) {
+      ERROR("Unmatched XOR c_packed");
+      ret = SRSLTE_ERROR;
+      break;
+    }
+  }
+
+  printf("%08x; %8d; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8c\n",
          seed,
          length,
          (double)(length * repetitions) / (double)interval_gen_us,
          (double)(length * repetitions) / (double)interval_xor_float_us,
          (double)(length * repetitions) / (double)interval_xor_short_us,
          (double)(length * repetitions) / (double)interval_xor_char_us,
+         (double)(length * repetitions) / (double)interval_xor_bit_us,
          ret == SRSLTE_SUCCESS ? 'y' : 'n');
 
-  return SRSLTE_SUCCESS;
+  return ret;
 }
 
 int main(int argc, char** argv)
 {
-  uint32_t repetitions = 1;
-  uint32_t min_length  = 16;
-  uint32_t max_length  = MAX_SEQ_LEN;
+  int ret = SRSLTE_SUCCESS;
+
+  parse_args(argc, argv);
 
   srslte_sequence_t sequence   = {};
   srslte_random_t   random_gen = srslte_random_init(0);
@@ -182,15 +239,28 @@ int main(int argc, char** argv)
     return SRSLTE_ERROR;
   }
 
-  printf("%8s; %8s; %8s; %8s; %8s; %8s; %8s\n", "seed", "length", "GEN", "XOR PS", "XOR 16", "XOR 8", "Passed");
+  printf("%8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s\n",
+         "seed",
+         "length",
+         "GEN",
+         "XOR PS",
+         "XOR 16",
+         "XOR 8",
+         "XOR BIT",
+         "Passed");
 
   for (uint32_t length = min_length; length <= max_length; length = (length * 5) / 4) {
-    test_sequence(&sequence, (uint32_t)srslte_random_uniform_int_dist(random_gen, 1, INT32_MAX), length, repetitions);
+    if (test_sequence(&sequence,
+                      (uint32_t)srslte_random_uniform_int_dist(random_gen, 1, INT32_MAX),
+                      length,
+                      repetitions) != SRSLTE_SUCCESS) {
+      ret = SRSLTE_ERROR;
+    }
   }
 
   // Free sequence object
   srslte_sequence_free(&sequence);
   srslte_random_free(random_gen);
 
-  return SRSLTE_SUCCESS;
+  return ret;
 }
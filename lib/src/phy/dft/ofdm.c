@@ -559,6 +559,20 @@ void ofdm_tx_slot_mbsfn(srslte_ofdm_t* q, cf_t* input, cf_t* output)
   }
 }
 
+void srslte_ofdm_tx_symbol(srslte_ofdm_t* q, const cf_t* input, cf_t* output, uint32_t cp_len)
+{
+  uint32_t symbol_sz = q->cfg.symbol_sz;
+
+  // The first symbol of the temporal buffer is borrowed, the guru plans expect it zeroed outside the mapped subcarriers
+  srslte_vec_cf_zero(q->tmp, symbol_sz);
+  memcpy(&q->tmp[q->nof_guards], input, q->nof_re * sizeof(cf_t));
+  srslte_dft_run_c(&q->fft_plan, q->tmp, &output[cp_len]);
+  srslte_vec_cf_zero(q->tmp, symbol_sz);
+
+  /* add CP */
+  memcpy(output, &output[symbol_sz], cp_len * sizeof(cf_t));
+}
+
 void srslte_ofdm_set_normalize(srslte_ofdm_t* q, bool normalize_enable)
 {
   srslte_dft_plan_set_norm(&q->fft_plan, normalize_enable);
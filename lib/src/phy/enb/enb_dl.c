@@ -34,6 +34,11 @@
 
 #define SRSLTE_ENB_RF_AMP 0.1
 
+#define ALL_SYMBOLS_DIRTY 0xffffffff
+#define CTRL_SYMBOLS_DIRTY 0xf
+
+static int gen_templates(srslte_enb_dl_t* q);
+
 int srslte_enb_dl_init(srslte_enb_dl_t* q, cf_t* out_buffer[SRSLTE_MAX_PORTS], uint32_t max_prb)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
@@ -145,6 +150,12 @@ void srslte_enb_dl_free(srslte_enb_dl_t* q)
         free(q->sf_symbols[i]);
       }
     }
+    if (q->tmpl_buffer) {
+      free(q->tmpl_buffer);
+    }
+    if (q->tmpl_td_buffer) {
+      free(q->tmpl_td_buffer);
+    }
     bzero(q, sizeof(srslte_enb_dl_t));
   }
 }
@@ -217,6 +228,11 @@ int srslte_enb_dl_set_cell(srslte_enb_dl_t* q, srslte_cell_t cell)
       /* Generate PSS/SSS signals */
       srslte_pss_generate(q->pss_signal, cell.id % 3);
       srslte_sss_generate(q->sss_signal0, q->sss_signal5, cell.id);
+
+      if (gen_templates(q)) {
+        ERROR("Error generating subframe templates\n");
+        return SRSLTE_ERROR;
+      }
     }
     ret = SRSLTE_SUCCESS;
 
@@ -226,6 +242,18 @@ int srslte_enb_dl_set_cell(srslte_enb_dl_t* q, srslte_cell_t cell)
   return ret;
 }
 
+int srslte_enb_dl_set_ifft_cache(srslte_enb_dl_t* q, bool enable)
+{
+  if (q == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  q->ifft_cache = enable;
+  if (q->cell.nof_prb != 0) {
+    return gen_templates(q);
+  }
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_enb_dl_add_rnti(srslte_enb_dl_t* q, uint16_t rnti)
 {
   return srslte_pdsch_set_rnti(&q->pdsch, rnti);
@@ -337,6 +365,9 @@ static void put_mib(srslte_enb_dl_t* q)
   if (sf_idx == 0) {
     srslte_pbch_mib_pack(&q->cell, sfn, bch_payload);
     srslte_pbch_encode(&q->pbch, bch_payload, q->sf_symbols, sfn % 4);
+
+    // The PBCH takes the first 4 symbols of the second slot
+    q->dirty_symbols |= 0xfU << SRSLTE_CP_NSYMB(q->cell.cp);
   }
 }
 
@@ -345,15 +376,164 @@ static void put_pcfich(srslte_enb_dl_t* q)
   srslte_pcfich_encode(&q->pcfich, &q->dl_sf, q->sf_symbols);
 }
 
+static uint32_t nof_symbols_sf(srslte_enb_dl_t* q)
+{
+  return 2 * SRSLTE_CP_NSYMB(q->cell.cp);
+}
+
+static uint32_t symbol_cp_len(srslte_enb_dl_t* q, uint32_t l)
+{
+  uint32_t symbol_sz = (uint32_t)CURRENT_FFTSIZE;
+  uint32_t nsymb     = SRSLTE_CP_NSYMB(q->cell.cp);
+  return SRSLTE_CP_ISNORM(q->cell.cp) ? SRSLTE_CP_LEN_NORM(l % nsymb, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
+}
+
+static bool row_is_zero(const cf_t* row, uint32_t nof_re)
+{
+  for (uint32_t i = 0; i < nof_re; i++) {
+    if (row[i] != 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Builds the static part of every subframe index and CFI with the same functions used for the regular subframes and
+ * keeps its non-empty symbols. The first pass only counts them, the second one stores them.
+ */
+static uint32_t build_templates(srslte_enb_dl_t* q, bool store)
+{
+  uint32_t nof_re   = SRSLTE_NRE * q->cell.nof_prb;
+  uint32_t nof_rows = 0;
+
+  for (uint32_t sf_idx = 0; sf_idx < SRSLTE_NOF_SF_X_FRAME; sf_idx++) {
+    for (uint32_t cfi = 1; cfi <= SRSLTE_ENB_DL_NOF_CFI; cfi++) {
+      ZERO_OBJECT(q->dl_sf);
+      q->dl_sf.tti     = sf_idx;
+      q->dl_sf.cfi     = cfi;
+      q->dl_sf.sf_type = SRSLTE_SF_NORM;
+      clear_sf(q);
+      put_sync(q);
+      put_refs(q);
+      put_pcfich(q);
+
+      for (uint32_t p = 0; p < q->cell.nof_ports; p++) {
+        for (uint32_t l = 0; l < nof_symbols_sf(q); l++) {
+          cf_t** row = &q->tmpl_re[sf_idx][cfi - 1][p][l];
+          if (l > 0 && cfi > 1) {
+            // Only the PCFICH depends on the CFI
+            *row = q->tmpl_re[sf_idx][0][p][l];
+          } else if (row_is_zero(&q->sf_symbols[p][l * nof_re], nof_re)) {
+            *row = NULL;
+          } else {
+            if (store) {
+              *row = &q->tmpl_buffer[nof_rows * nof_re];
+              memcpy(*row, &q->sf_symbols[p][l * nof_re], sizeof(cf_t) * nof_re);
+            }
+            nof_rows++;
+          }
+        }
+      }
+    }
+  }
+  ZERO_OBJECT(q->dl_sf);
+  return nof_rows;
+}
+
+static int gen_templates(srslte_enb_dl_t* q)
+{
+  if (q->tmpl_buffer) {
+    free(q->tmpl_buffer);
+    q->tmpl_buffer = NULL;
+  }
+  if (q->tmpl_td_buffer) {
+    free(q->tmpl_td_buffer);
+    q->tmpl_td_buffer = NULL;
+  }
+  bzero(q->tmpl_re, sizeof(q->tmpl_re));
+  q->tmpl_nof_rows = 0;
+
+  // TDD special subframes carry a variable number of reference signals, leave them to the regular path
+  if (q->cell.frame_type != SRSLTE_FDD) {
+    return SRSLTE_SUCCESS;
+  }
+
+  uint32_t nof_re   = SRSLTE_NRE * q->cell.nof_prb;
+  uint32_t nof_rows = build_templates(q, false);
+
+  q->tmpl_buffer = srslte_vec_cf_malloc(nof_rows * nof_re);
+  if (!q->tmpl_buffer) {
+    perror("malloc");
+    return SRSLTE_ERROR;
+  }
+  q->tmpl_nof_rows = build_templates(q, true);
+
+  if (q->ifft_cache) {
+    uint32_t symbol_sz = (uint32_t)CURRENT_FFTSIZE;
+    q->tmpl_td_stride  = symbol_sz + SRSLTE_CP_LEN_EXT(symbol_sz);
+    q->tmpl_td_buffer  = srslte_vec_cf_malloc(q->tmpl_nof_rows * q->tmpl_td_stride);
+    if (!q->tmpl_td_buffer) {
+      perror("malloc");
+      return SRSLTE_ERROR;
+    }
+
+    // Every row is transformed once, with the cyclic prefix of the symbol it belongs to
+    for (uint32_t sf_idx = 0; sf_idx < SRSLTE_NOF_SF_X_FRAME; sf_idx++) {
+      for (uint32_t cfi = 1; cfi <= SRSLTE_ENB_DL_NOF_CFI; cfi++) {
+        for (uint32_t p = 0; p < q->cell.nof_ports; p++) {
+          for (uint32_t l = 0; l < nof_symbols_sf(q); l++) {
+            cf_t* row = q->tmpl_re[sf_idx][cfi - 1][p][l];
+            if (row && (l == 0 || cfi == 1)) {
+              uint32_t n = (uint32_t)(row - q->tmpl_buffer) / nof_re;
+              srslte_ofdm_tx_symbol(&q->ifft[p], row, &q->tmpl_td_buffer[n * q->tmpl_td_stride], symbol_cp_len(q, l));
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+static bool use_template(srslte_enb_dl_t* q)
+{
+  return q->tmpl_buffer != NULL && q->dl_sf.sf_type == SRSLTE_SF_NORM && !q->dl_sf.tdd_config.configured &&
+         q->dl_sf.cfi >= 1 && q->dl_sf.cfi <= SRSLTE_ENB_DL_NOF_CFI;
+}
+
+static void put_template(srslte_enb_dl_t* q)
+{
+  uint32_t nof_re = SRSLTE_NRE * q->cell.nof_prb;
+  uint32_t sf_idx = q->dl_sf.tti % 10;
+
+  for (uint32_t p = 0; p < q->cell.nof_ports; p++) {
+    for (uint32_t l = 0; l < nof_symbols_sf(q); l++) {
+      cf_t* row = q->tmpl_re[sf_idx][q->dl_sf.cfi - 1][p][l];
+      if (row) {
+        memcpy(&q->sf_symbols[p][l * nof_re], row, sizeof(cf_t) * nof_re);
+      } else {
+        srslte_vec_cf_zero(&q->sf_symbols[p][l * nof_re], nof_re);
+      }
+    }
+  }
+}
+
 void srslte_enb_dl_put_base(srslte_enb_dl_t* q, srslte_dl_sf_cfg_t* dl_sf)
 {
   srslte_ofdm_set_non_mbsfn_region(&q->ifft_mbsfn, dl_sf->non_mbsfn_region);
   q->dl_sf = *dl_sf;
-  clear_sf(q);
-  put_sync(q);
-  put_refs(q);
+  if (use_template(q)) {
+    put_template(q);
+    q->dirty_symbols = 0;
+  } else {
+    clear_sf(q);
+    put_sync(q);
+    put_refs(q);
+    put_pcfich(q);
+    q->dirty_symbols = ALL_SYMBOLS_DIRTY;
+  }
   put_mib(q);
-  put_pcfich(q);
 }
 
 void srslte_enb_dl_put_phich(srslte_enb_dl_t* q, srslte_phich_grant_t* grant, bool ack)
@@ -361,6 +541,7 @@ void srslte_enb_dl_put_phich(srslte_enb_dl_t* q, srslte_phich_grant_t* grant, bo
   srslte_phich_resource_t resource;
   srslte_phich_calc(&q->phich, grant, &resource);
   srslte_phich_encode(&q->phich, &q->dl_sf, resource, ack, q->sf_symbols);
+  q->dirty_symbols |= CTRL_SYMBOLS_DIRTY;
 }
 
 int srslte_enb_dl_put_pdcch_dl(srslte_enb_dl_t* q, srslte_dci_cfg_t* dci_cfg, srslte_dci_dl_t* dci_dl)
@@ -371,6 +552,7 @@ int srslte_enb_dl_put_pdcch_dl(srslte_enb_dl_t* q, srslte_dci_cfg_t* dci_cfg, sr
   if (srslte_dci_msg_pack_pdsch(&q->cell, &q->dl_sf, dci_cfg, dci_dl, &dci_msg)) {
     ERROR("Error packing DL DCI\n");
   }
+  q->dirty_symbols |= CTRL_SYMBOLS_DIRTY;
   if (srslte_pdcch_encode(&q->pdcch, &q->dl_sf, &dci_msg, q->sf_symbols)) {
     ERROR("Error encoding DL DCI message\n");
     return SRSLTE_ERROR;
@@ -387,6 +569,7 @@ int srslte_enb_dl_put_pdcch_ul(srslte_enb_dl_t* q, srslte_dci_cfg_t* dci_cfg, sr
   if (srslte_dci_msg_pack_pusch(&q->cell, &q->dl_sf, dci_cfg, dci_ul, &dci_msg)) {
     ERROR("Error packing UL DCI\n");
   }
+  q->dirty_symbols |= CTRL_SYMBOLS_DIRTY;
   if (srslte_pdcch_encode(&q->pdcch, &q->dl_sf, &dci_msg, q->sf_symbols)) {
     ERROR("Error encoding UL DCI message\n");
     return SRSLTE_ERROR;
@@ -397,14 +580,41 @@ int srslte_enb_dl_put_pdcch_ul(srslte_enb_dl_t* q, srslte_dci_cfg_t* dci_cfg, sr
 
 int srslte_enb_dl_put_pdsch(srslte_enb_dl_t* q, srslte_pdsch_cfg_t* pdsch, uint8_t* data[SRSLTE_MAX_CODEWORDS])
 {
+  q->dirty_symbols = ALL_SYMBOLS_DIRTY;
   return srslte_pdsch_encode(&q->pdsch, &q->dl_sf, pdsch, data, q->sf_symbols);
 }
 
 int srslte_enb_dl_put_pmch(srslte_enb_dl_t* q, srslte_pmch_cfg_t* pmch_cfg, uint8_t* data)
 {
+  q->dirty_symbols = ALL_SYMBOLS_DIRTY;
   return srslte_pmch_encode(&q->pmch, &q->dl_sf, pmch_cfg, data, q->sf_symbols);
 }
 
+/* Transforms only the symbols written after the template was copied, the others are copied from the cached
+ * time-domain template or left empty
+ */
+static void gen_signal_cached(srslte_enb_dl_t* q, uint32_t port)
+{
+  uint32_t nof_re    = SRSLTE_NRE * q->cell.nof_prb;
+  uint32_t symbol_sz = (uint32_t)CURRENT_FFTSIZE;
+  uint32_t sf_idx    = q->dl_sf.tti % 10;
+  cf_t*    output    = q->ifft[port].cfg.out_buffer;
+
+  for (uint32_t l = 0; l < nof_symbols_sf(q); l++) {
+    uint32_t cp_len = symbol_cp_len(q, l);
+    cf_t*    row    = q->tmpl_re[sf_idx][q->dl_sf.cfi - 1][port][l];
+    if (q->dirty_symbols & (1U << l)) {
+      srslte_ofdm_tx_symbol(&q->ifft[port], &q->sf_symbols[port][l * nof_re], output, cp_len);
+    } else if (row) {
+      uint32_t n = (uint32_t)(row - q->tmpl_buffer) / nof_re;
+      memcpy(output, &q->tmpl_td_buffer[n * q->tmpl_td_stride], sizeof(cf_t) * (cp_len + symbol_sz));
+    } else {
+      srslte_vec_cf_zero(output, cp_len + symbol_sz);
+    }
+    output += cp_len + symbol_sz;
+  }
+}
+
 void srslte_enb_dl_gen_signal(srslte_enb_dl_t* q)
 {
   // TODO: PAPR control
@@ -418,7 +628,11 @@ void srslte_enb_dl_gen_signal(srslte_enb_dl_t* q)
                            (uint32_t)SRSLTE_SF_LEN_PRB(q->cell.nof_prb));
   } else {
     for (int i = 0; i < q->cell.nof_ports; i++) {
-      srslte_ofdm_tx_sf(&q->ifft[i]);
+      if (q->tmpl_td_buffer && q->dirty_symbols != ALL_SYMBOLS_DIRTY && !isnormal(q->ifft[i].cfg.freq_shift_f)) {
+        gen_signal_cached(q, (uint32_t)i);
+      } else {
+        srslte_ofdm_tx_sf(&q->ifft[i]);
+      }
       srslte_vec_sc_prod_cfc(q->ifft[i].cfg.out_buffer,
                              norm_factor,
                              q->ifft[i].cfg.out_buffer,
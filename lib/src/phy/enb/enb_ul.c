@@ -268,3 +268,22 @@ int srslte_enb_ul_get_pusch(srslte_enb_ul_t*    q,
 
   return srslte_pusch_decode(&q->pusch, ul_sf, cfg, &q->chest_res, q->sf_symbols, res);
 }
+
+int srslte_enb_ul_estimate_pusch_multi(srslte_enb_ul_t*       q,
+                                       srslte_ul_sf_cfg_t*    ul_sf,
+                                       srslte_pusch_cfg_t*    cfg,
+                                       srslte_chest_ul_res_t* chest_res,
+                                       uint32_t               nof_grants)
+{
+  return srslte_chest_ul_estimate_pusch_multi(
+      &q->chest, ul_sf, cfg, q->sf_symbols, q->chest_res.ce, chest_res, nof_grants);
+}
+
+int srslte_enb_ul_decode_pusch(srslte_enb_ul_t*       q,
+                               srslte_ul_sf_cfg_t*    ul_sf,
+                               srslte_pusch_cfg_t*    cfg,
+                               srslte_chest_ul_res_t* chest_res,
+                               srslte_pusch_res_t*    res)
+{
+  return srslte_pusch_decode(&q->pusch, ul_sf, cfg, chest_res, q->sf_symbols, res);
+}
@@ -102,6 +102,32 @@ static uint16_t deinterleaver_sb[NOF_DEINTER_TABLE_SB_IDX][192][4][18448];
 
 static uint16_t temp_table1[3 * 6176], temp_table2[3 * 6176];
 
+#ifdef LV_HAVE_AVX2
+#define TX_NROWS_MAX ((SRSLTE_TCOD_MAX_LEN_CB + 4 - 1) / NCOLS + 1)
+#define TX_BLOCK_ROWS 32
+#define TX_BLOCK_BYTES (TX_BLOCK_ROWS * NCOLS / 8)
+#define TX_MATRIX_BYTES (((TX_NROWS_MAX - 1) / TX_BLOCK_ROWS + 1) * TX_BLOCK_BYTES)
+
+// Bit offset in the circular buffer of each column read by the sub-block interleavers, for the systematic and the
+// interlaced parity bits
+static uint16_t tx_column_offset[SRSLTE_NOF_TC_CB_SIZES][2][NCOLS];
+
+static void srslte_rm_turbo_gentable_tx_columns(uint16_t offset[2][NCOLS], uint32_t nrows, uint32_t ndummy)
+{
+  uint32_t sys_offset = 0;
+  uint32_t par_offset = nrows * NCOLS - ndummy;
+  for (uint32_t j = 0; j < NCOLS; j++) {
+    uint32_t col = RM_PERM_TC[j];
+    offset[0][j] = sys_offset;
+    offset[1][j] = par_offset;
+
+    // Dummy bits are at the top of the first ndummy columns, and at the bottom of the last second parity column
+    sys_offset += nrows - (col < ndummy);
+    par_offset += 2 * nrows - (col < ndummy) - (col + 1 < ndummy) - (col == NCOLS - 1 && ndummy > 0);
+  }
+}
+#endif /* LV_HAVE_AVX2 */
+
 static void srslte_rm_turbo_gentable_systematic(uint16_t* table_bits, int k0_vec_[4][2], uint32_t nrows, int ndummy)
 {
 
@@ -306,6 +332,10 @@ void srslte_rm_turbo_gentables()
                                   interleaver_parity_bits[cb_idx],
                                   (uint32_t)(srslte_cbsegm_cbsize(cb_idx) + 4) * 2);
 
+#ifdef LV_HAVE_AVX2
+      srslte_rm_turbo_gentable_tx_columns(tx_column_offset[cb_idx], nrows, ndummy);
+#endif /* LV_HAVE_AVX2 */
+
       for (int i = 0; i < 4; i++) {
         srslte_rm_turbo_gentable_receive(deinterleaver[cb_idx][i], in_len, i);
 
@@ -332,6 +362,144 @@ void srslte_rm_turbo_free_tables()
   rm_turbo_tables_generated = false;
 }
 
+#ifdef LV_HAVE_AVX2
+
+// ORs the nof_bits MSBs of word into buf at bit offset, buf_len is the size of buf in bytes
+static inline void rm_turbo_put_bits(uint8_t* buf, uint32_t buf_len, uint32_t offset, uint64_t word, uint32_t nof_bits)
+{
+  uint8_t* ptr = &buf[offset / 8];
+  uint32_t sh  = offset % 8;
+  if (nof_bits < 64) {
+    word &= ~(UINT64_MAX >> nof_bits);
+  }
+  if (offset / 8 + 9 <= buf_len) {
+    uint64_t w;
+    memcpy(&w, ptr, 8);
+    w = __builtin_bswap64(__builtin_bswap64(w) | (word >> sh));
+    memcpy(ptr, &w, 8);
+    if (sh) {
+      ptr[8] |= (uint8_t)(word << (8 - sh));
+    }
+  } else {
+    ptr[0] |= (uint8_t)(word >> (56 + sh));
+    word <<= 8 - sh;
+    for (uint32_t i = 1; i * 8 < sh + nof_bits; i++) {
+      ptr[i] |= (uint8_t)(word >> 56);
+      word <<= 8;
+    }
+  }
+}
+
+/* Transposes 32 rows of the sub-block interleaver matrix, 4 bytes each. Vector l holds byte l of every row, with the
+ * rows in reverse order so that the byte movemask has row 0 in its MSB.
+ */
+static inline void rm_turbo_transpose_block_avx2(const uint8_t* y, __m256i v[4])
+{
+  const __m256i shuffle = _mm256_setr_epi8(
+      12, 8, 4, 0, 13, 9, 5, 1, 14, 10, 6, 2, 15, 11, 7, 3, 12, 8, 4, 0, 13, 9, 5, 1, 14, 10, 6, 2, 15, 11, 7, 3);
+  const __m256i perm = _mm256_setr_epi32(4, 0, 5, 1, 6, 2, 7, 3);
+
+  __m256i b[4];
+  for (int q = 0; q < 4; q++) {
+    b[q] = _mm256_loadu_si256((__m256i*)&y[32 * q]);
+    b[q] = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(b[q], shuffle), perm);
+  }
+  __m256i c0 = _mm256_unpacklo_epi64(b[3], b[2]);
+  __m256i c1 = _mm256_unpackhi_epi64(b[3], b[2]);
+  __m256i d0 = _mm256_unpacklo_epi64(b[1], b[0]);
+  __m256i d1 = _mm256_unpackhi_epi64(b[1], b[0]);
+  v[0]       = _mm256_permute2x128_si256(c0, d0, 0x20);
+  v[1]       = _mm256_permute2x128_si256(c1, d1, 0x20);
+  v[2]       = _mm256_permute2x128_si256(c0, d0, 0x31);
+  v[3]       = _mm256_permute2x128_si256(c1, d1, 0x31);
+}
+
+/* Sub-block interleaving and bit collection (5.1.4.1.1) of a packed code block straight into the circular buffer.
+ * The three streams are written into R x 32 bit matrices, which are read by columns 32 rows at a time with byte
+ * movemasks, and the column words are placed with the precomputed column offsets.
+ */
+static void rm_turbo_tx_interleave_avx2(uint8_t* w_buff, uint8_t* systematic, uint8_t* parity, uint32_t cb_idx)
+{
+  uint8_t y0[TX_MATRIX_BYTES], y1[TX_MATRIX_BYTES], y2[TX_MATRIX_BYTES];
+
+  uint32_t D      = srslte_cbsegm_cbsize(cb_idx) + 4;
+  uint32_t nrows  = (D - 1) / NCOLS + 1;
+  uint32_t ndummy = nrows * NCOLS - D;
+  uint32_t nbytes = ((nrows - 1) / TX_BLOCK_ROWS + 1) * TX_BLOCK_BYTES;
+
+  // The second parity stream is read one bit ahead, its dummy bits wrap to the end of the matrix
+  bzero(y0, nbytes);
+  bzero(y1, nbytes);
+  bzero(y2, nbytes);
+  srslte_bit_copy(y0, ndummy, systematic, 0, D);
+  srslte_bit_copy(y1, ndummy, parity, 0, D);
+  if (ndummy > 0) {
+    srslte_bit_copy(y2, ndummy - 1, parity, D, D);
+  } else {
+    srslte_bit_copy(y2, 0, parity, D + 1, D - 1);
+    srslte_bit_copy(y2, D - 1, parity, D, 1);
+  }
+
+  uint32_t w_len = (3 * D + 7) / 8;
+  bzero(w_buff, w_len);
+
+  for (uint32_t row = 0; row < nrows; row += TX_BLOCK_ROWS) {
+    uint32_t nof_rows = SRSLTE_MIN(TX_BLOCK_ROWS, nrows - row);
+    uint32_t blk      = row * NCOLS / 8;
+
+    __m256i v0[4], v1[4], v2[4], p_lo[4], p_hi[4];
+    rm_turbo_transpose_block_avx2(&y0[blk], v0);
+    rm_turbo_transpose_block_avx2(&y1[blk], v1);
+    rm_turbo_transpose_block_avx2(&y2[blk], v2);
+
+    // Interlaces the rows of both parity streams, the low half has rows 31 to 16 and the high half rows 15 to 0
+    for (uint32_t l = 0; l < 4; l++) {
+      v1[l]   = _mm256_permute4x64_epi64(v1[l], 0xd8);
+      v2[l]   = _mm256_permute4x64_epi64(v2[l], 0xd8);
+      p_lo[l] = _mm256_unpacklo_epi8(v2[l], v1[l]);
+      p_hi[l] = _mm256_unpackhi_epi8(v2[l], v1[l]);
+    }
+
+    for (uint32_t l = 0; l < 4; l++) {
+      for (uint32_t k = 0; k < 8; k++) {
+        uint32_t col = 8 * l + k;
+        uint32_t j   = RM_PERM_TC[col]; // The permutation is its own inverse
+
+        uint32_t s   = (uint32_t)_mm256_movemask_epi8(v0[l]);
+        uint64_t par = ((uint64_t)(uint32_t)_mm256_movemask_epi8(p_hi[l]) << 32) |
+                       (uint32_t)_mm256_movemask_epi8(p_lo[l]);
+
+        // Systematic bits
+        uint32_t lead   = (row == 0) ? (col < ndummy) : 0;
+        uint32_t offset = tx_column_offset[cb_idx][0][j] + row - (row ? (col < ndummy) : 0);
+        rm_turbo_put_bits(w_buff, w_len, offset, (uint64_t)s << (32 + lead), nof_rows - lead);
+
+        // Interlaced parity bits
+        uint32_t par_lead = (col < ndummy) + (col + 1 < ndummy);
+        uint32_t par_len  = 2 * nof_rows;
+        if (col == NCOLS - 1 && ndummy > 0 && row + nof_rows == nrows) {
+          par_len--;
+        }
+        offset = tx_column_offset[cb_idx][1][j] + 2 * row;
+        if (row == 0) {
+          par <<= par_lead;
+          par_len -= par_lead;
+        } else {
+          offset -= par_lead;
+        }
+        rm_turbo_put_bits(w_buff, w_len, offset, par, par_len);
+
+        // Next column bit to the MSB of every byte
+        v0[l]   = _mm256_add_epi8(v0[l], v0[l]);
+        p_lo[l] = _mm256_add_epi8(p_lo[l], p_lo[l]);
+        p_hi[l] = _mm256_add_epi8(p_hi[l], p_hi[l]);
+      }
+    }
+  }
+}
+
+#endif /* LV_HAVE_AVX2 */
+
 /**
  * Rate matching for LTE Turbo Coder
  *
@@ -362,6 +530,9 @@ int srslte_rm_turbo_tx_lut(uint8_t* w_buff,
 
     /* Sub-block interleaver (5.1.4.1.1) and bit collection */
     if (rv_idx == 0) {
+#ifdef LV_HAVE_AVX2
+      rm_turbo_tx_interleave_avx2(w_buff, systematic, parity, cb_idx);
+#else  /* LV_HAVE_AVX2 */
 
       // Systematic bits
       // srslte_bit_interleave(systematic, w_buff, interleaver_systematic_bits[cb_idx], in_len/3);
@@ -370,6 +541,7 @@ int srslte_rm_turbo_tx_lut(uint8_t* w_buff,
       // Parity bits
       // srslte_bit_interleave_w_offset(parity, &w_buff[in_len/24], interleaver_parity_bits[cb_idx], 2*in_len/3, 4);
       srslte_bit_interleaver_run(&bit_interleavers_parity_bits[cb_idx], parity, &w_buff[in_len / 24], 4);
+#endif /* LV_HAVE_AVX2 */
     }
 
     /* Bit selection and transmission 5.1.4.1.2 */
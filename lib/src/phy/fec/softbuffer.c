@@ -38,7 +38,146 @@
 
 #define MAX_PDSCH_RE(cp) (2 * SRSLTE_CP_NSYMB(cp) * 12)
 
-int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb)
+#define SOFTBUFFER_POOL_ALIGN 64
+#define SOFTBUFFER_DATA_NBYTES (6144 / 8)
+
+static int softbuffer_pool_init(srslte_softbuffer_pool_t* pool,
+                                uint32_t                  soft_nbytes,
+                                uint32_t                  data_nbytes,
+                                uint32_t                  max_buffers)
+{
+  if (pool == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(pool, sizeof(srslte_softbuffer_pool_t));
+
+  // Keep the data buffer that follows the soft bits aligned
+  pool->soft_nbytes = (soft_nbytes + SOFTBUFFER_POOL_ALIGN - 1) / SOFTBUFFER_POOL_ALIGN * SOFTBUFFER_POOL_ALIGN;
+  pool->data_nbytes = data_nbytes;
+  pool->max_buffers = max_buffers;
+
+  if (pthread_mutex_init(&pool->mutex, NULL)) {
+    perror("pthread_mutex_init");
+    bzero(pool, sizeof(srslte_softbuffer_pool_t));
+    return SRSLTE_ERROR;
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int srslte_softbuffer_pool_init_rx(srslte_softbuffer_pool_t* pool, bool llr_is_8bit, uint32_t max_buffers)
+{
+  uint32_t soft_nbytes = SOFTBUFFER_SIZE * (llr_is_8bit ? sizeof(int8_t) : sizeof(int16_t));
+  int      ret         = softbuffer_pool_init(pool, soft_nbytes, SOFTBUFFER_DATA_NBYTES, max_buffers);
+  if (ret == SRSLTE_SUCCESS) {
+    pool->llr_is_8bit = llr_is_8bit;
+  }
+  return ret;
+}
+
+int srslte_softbuffer_pool_init_tx(srslte_softbuffer_pool_t* pool, uint32_t max_buffers)
+{
+  return softbuffer_pool_init(pool, SOFTBUFFER_SIZE * sizeof(uint8_t), 0, max_buffers);
+}
+
+void srslte_softbuffer_pool_get_metrics(srslte_softbuffer_pool_t* pool, srslte_softbuffer_pool_metrics_t* metrics)
+{
+  if (pool != NULL && metrics != NULL && pool->soft_nbytes) {
+    pthread_mutex_lock(&pool->mutex);
+    *metrics = pool->metrics;
+    pthread_mutex_unlock(&pool->mutex);
+  }
+}
+
+void srslte_softbuffer_pool_free(srslte_softbuffer_pool_t* pool)
+{
+  if (pool != NULL && pool->soft_nbytes) {
+    if (pool->metrics.nof_in_use) {
+      ERROR("Freeing softbuffer pool with %d buffers in use\n", pool->metrics.nof_in_use);
+    }
+    while (pool->free_list != NULL) {
+      void* buffer    = pool->free_list;
+      pool->free_list = *(void**)buffer;
+      free(buffer);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    bzero(pool, sizeof(srslte_softbuffer_pool_t));
+  }
+}
+
+// Must be called with the pool mutex locked. Returns NULL if the pool is exhausted.
+static void* softbuffer_pool_pop(srslte_softbuffer_pool_t* pool)
+{
+  void* buffer = pool->free_list;
+
+  if (buffer != NULL) {
+    pool->free_list = *(void**)buffer;
+  } else if (pool->max_buffers == 0 || pool->metrics.nof_buffers < pool->max_buffers) {
+    buffer = srslte_vec_malloc(pool->soft_nbytes + pool->data_nbytes);
+    if (buffer != NULL) {
+      pool->metrics.nof_buffers++;
+      pool->metrics.nof_bytes += pool->soft_nbytes + pool->data_nbytes;
+    }
+  }
+
+  if (buffer == NULL) {
+    pool->metrics.nof_failures++;
+    return NULL;
+  }
+
+  pool->metrics.nof_in_use++;
+  pool->metrics.nof_borrows++;
+  pool->metrics.max_in_use = SRSLTE_MAX(pool->metrics.max_in_use, pool->metrics.nof_in_use);
+  return buffer;
+}
+
+// Must be called with the pool mutex locked
+static void softbuffer_pool_push(srslte_softbuffer_pool_t* pool, void* buffer)
+{
+  *(void**)buffer = pool->free_list;
+  pool->free_list = buffer;
+  pool->metrics.nof_in_use--;
+}
+
+// Makes a pooled Rx softbuffer hold code block buffers for its first nof_cb code blocks only
+static void softbuffer_rx_hold(srslte_softbuffer_rx_t* q, uint32_t nof_cb)
+{
+  srslte_softbuffer_pool_t* pool = q->pool;
+
+  pthread_mutex_lock(&pool->mutex);
+  for (uint32_t i = 0; i < q->max_cb; i++) {
+    if (i < nof_cb && q->buffer_f[i] == NULL) {
+      uint8_t* buffer = softbuffer_pool_pop(pool);
+      q->buffer_f[i]  = (int16_t*)buffer;
+      q->data[i]      = buffer ? &buffer[pool->soft_nbytes] : NULL;
+    } else if (i >= nof_cb && q->buffer_f[i] != NULL) {
+      softbuffer_pool_push(pool, q->buffer_f[i]);
+      q->buffer_f[i] = NULL;
+      q->data[i]     = NULL;
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+// Makes a pooled Tx softbuffer hold code block buffers for its first nof_cb code blocks only
+static void softbuffer_tx_hold(srslte_softbuffer_tx_t* q, uint32_t nof_cb)
+{
+  srslte_softbuffer_pool_t* pool = q->pool;
+
+  pthread_mutex_lock(&pool->mutex);
+  for (uint32_t i = 0; i < q->max_cb; i++) {
+    if (i < nof_cb && q->buffer_b[i] == NULL) {
+      q->buffer_b[i] = softbuffer_pool_pop(pool);
+    } else if (i >= nof_cb && q->buffer_b[i] != NULL) {
+      softbuffer_pool_push(pool, q->buffer_b[i]);
+      q->buffer_b[i] = NULL;
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+static int softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
 
@@ -69,18 +208,25 @@ int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb)
       }
       bzero(q->cb_crc, sizeof(bool) * q->max_cb);
 
-      // TODO: Use HARQ buffer limitation based on UE category
-      for (uint32_t i = 0; i < q->max_cb; i++) {
-        q->buffer_f[i] = srslte_vec_i16_malloc(SOFTBUFFER_SIZE);
-        if (!q->buffer_f[i]) {
-          perror("malloc");
-          goto clean_exit;
-        }
+      if (pool != NULL) {
+        // Code block buffers are borrowed from the pool on demand
+        bzero(q->buffer_f, sizeof(int16_t*) * q->max_cb);
+        bzero(q->data, sizeof(uint8_t*) * q->max_cb);
+        q->pool = pool;
+      } else {
+        // TODO: Use HARQ buffer limitation based on UE category
+        for (uint32_t i = 0; i < q->max_cb; i++) {
+          q->buffer_f[i] = srslte_vec_i16_malloc(SOFTBUFFER_SIZE);
+          if (!q->buffer_f[i]) {
+            perror("malloc");
+            goto clean_exit;
+          }
 
-        q->data[i] = srslte_vec_u8_malloc(6144 / 8);
-        if (!q->data[i]) {
-          perror("malloc");
-          goto clean_exit;
+          q->data[i] = srslte_vec_u8_malloc(SOFTBUFFER_DATA_NBYTES);
+          if (!q->data[i]) {
+            perror("malloc");
+            goto clean_exit;
+          }
         }
       }
       // srslte_softbuffer_rx_reset(q);
@@ -96,9 +242,34 @@ clean_exit:
   return ret;
 }
 
+int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb)
+{
+  return softbuffer_rx_init(q, nof_prb, NULL);
+}
+
+int srslte_softbuffer_rx_init_pool(srslte_softbuffer_rx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool)
+{
+  if (pool == NULL || pool->data_nbytes == 0) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  return softbuffer_rx_init(q, nof_prb, pool);
+}
+
+void srslte_softbuffer_rx_release(srslte_softbuffer_rx_t* q)
+{
+  if (q->pool && q->buffer_f) {
+    softbuffer_rx_hold(q, 0);
+  }
+  if (q->cb_crc) {
+    bzero(q->cb_crc, sizeof(bool) * q->max_cb);
+  }
+  q->tb_crc = false;
+}
+
 void srslte_softbuffer_rx_free(srslte_softbuffer_rx_t* q)
 {
   if (q) {
+    srslte_softbuffer_rx_release(q);
     if (q->buffer_f) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->buffer_f[i]) {
@@ -130,6 +301,10 @@ void srslte_softbuffer_rx_reset_tbs(srslte_softbuffer_rx_t* q, uint32_t tbs)
 
 void srslte_softbuffer_rx_reset(srslte_softbuffer_rx_t* q)
 {
+  if (q->pool) {
+    srslte_softbuffer_rx_release(q);
+    return;
+  }
   srslte_softbuffer_rx_reset_cb(q, q->max_cb);
 }
 
@@ -139,12 +314,17 @@ void srslte_softbuffer_rx_reset_cb(srslte_softbuffer_rx_t* q, uint32_t nof_cb)
     if (nof_cb > q->max_cb) {
       nof_cb = q->max_cb;
     }
+    uint32_t soft_nbytes = SOFTBUFFER_SIZE * sizeof(int16_t);
+    if (q->pool) {
+      softbuffer_rx_hold(q, nof_cb);
+      soft_nbytes = q->pool->soft_nbytes;
+    }
     for (uint32_t i = 0; i < nof_cb; i++) {
       if (q->buffer_f[i]) {
-        bzero(q->buffer_f[i], SOFTBUFFER_SIZE * sizeof(int16_t));
+        bzero(q->buffer_f[i], soft_nbytes);
       }
       if (q->data[i]) {
-        bzero(q->data[i], sizeof(uint8_t) * 6144 / 8);
+        bzero(q->data[i], sizeof(uint8_t) * SOFTBUFFER_DATA_NBYTES);
       }
     }
   }
@@ -154,7 +334,7 @@ void srslte_softbuffer_rx_reset_cb(srslte_softbuffer_rx_t* q, uint32_t nof_cb)
   q->tb_crc = false;
 }
 
-int srslte_softbuffer_tx_init(srslte_softbuffer_tx_t* q, uint32_t nof_prb)
+static int softbuffer_tx_init(srslte_softbuffer_tx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
 
@@ -171,12 +351,18 @@ int srslte_softbuffer_tx_init(srslte_softbuffer_tx_t* q, uint32_t nof_prb)
         return SRSLTE_ERROR;
       }
 
-      // TODO: Use HARQ buffer limitation based on UE category
-      for (uint32_t i = 0; i < q->max_cb; i++) {
-        q->buffer_b[i] = srslte_vec_u8_malloc(SOFTBUFFER_SIZE);
-        if (!q->buffer_b[i]) {
-          perror("malloc");
-          return SRSLTE_ERROR;
+      if (pool != NULL) {
+        // Code block buffers are borrowed from the pool on demand
+        bzero(q->buffer_b, sizeof(uint8_t*) * q->max_cb);
+        q->pool = pool;
+      } else {
+        // TODO: Use HARQ buffer limitation based on UE category
+        for (uint32_t i = 0; i < q->max_cb; i++) {
+          q->buffer_b[i] = srslte_vec_u8_malloc(SOFTBUFFER_SIZE);
+          if (!q->buffer_b[i]) {
+            perror("malloc");
+            return SRSLTE_ERROR;
+          }
         }
       }
       srslte_softbuffer_tx_reset(q);
@@ -186,9 +372,30 @@ int srslte_softbuffer_tx_init(srslte_softbuffer_tx_t* q, uint32_t nof_prb)
   return ret;
 }
 
+int srslte_softbuffer_tx_init(srslte_softbuffer_tx_t* q, uint32_t nof_prb)
+{
+  return softbuffer_tx_init(q, nof_prb, NULL);
+}
+
+int srslte_softbuffer_tx_init_pool(srslte_softbuffer_tx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool)
+{
+  if (pool == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  return softbuffer_tx_init(q, nof_prb, pool);
+}
+
+void srslte_softbuffer_tx_release(srslte_softbuffer_tx_t* q)
+{
+  if (q->pool && q->buffer_b) {
+    softbuffer_tx_hold(q, 0);
+  }
+}
+
 void srslte_softbuffer_tx_free(srslte_softbuffer_tx_t* q)
 {
   if (q) {
+    srslte_softbuffer_tx_release(q);
     if (q->buffer_b) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->buffer_b[i]) {
@@ -209,6 +416,10 @@ void srslte_softbuffer_tx_reset_tbs(srslte_softbuffer_tx_t* q, uint32_t tbs)
 
 void srslte_softbuffer_tx_reset(srslte_softbuffer_tx_t* q)
 {
+  if (q->pool) {
+    srslte_softbuffer_tx_release(q);
+    return;
+  }
   srslte_softbuffer_tx_reset_cb(q, q->max_cb);
 }
 
@@ -219,6 +430,10 @@ void srslte_softbuffer_tx_reset_cb(srslte_softbuffer_tx_t* q, uint32_t nof_cb)
     if (nof_cb > q->max_cb) {
       nof_cb = q->max_cb;
     }
+    if (q->pool) {
+      softbuffer_tx_hold(q, nof_cb);
+      return;
+    }
     for (i = 0; i < nof_cb; i++) {
       if (q->buffer_b[i]) {
         bzero(q->buffer_b[i], sizeof(uint8_t) * SOFTBUFFER_SIZE);
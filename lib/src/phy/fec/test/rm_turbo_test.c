@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -38,6 +39,7 @@ uint8_t systematic[6148], parity[2 * 6148];
 uint8_t systematic_bytes[6148 / 8 + 1], parity_bytes[2 * 6148 / 8 + 1];
 
 #define BUFFSZ (6176 * 3)
+#define NOF_REPETITIONS 1000
 
 uint8_t bits[3 * 6144 + 12];
 uint8_t buff_b[BUFFSZ];
@@ -192,6 +194,23 @@ int main(int argc, char** argv)
     }
   }
 
+  // TX rate matching throughput of the largest code block checked, in output bits
+  for (rv_idx = rv_st; rv_idx < rv_end; rv_idx++) {
+    struct timeval t[3];
+    gettimeofday(&t[1], NULL);
+    for (i = 0; i < NOF_REPETITIONS; i++) {
+      srslte_rm_turbo_tx_lut(buff_b, systematic_bytes, parity_bytes, rm_bits2_bytes, end - 1, nof_e_bits, 0, rv_idx);
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    float mean_usec = (float)(t[0].tv_sec * 1e6 + t[0].tv_usec) / NOF_REPETITIONS;
+    printf("TX cb_idx=%3d rv_idx=%d: %.1f Mbps (%.2f usec)\n",
+           end - 1,
+           rv_idx,
+           (float)nof_e_bits / mean_usec,
+           mean_usec);
+  }
+
   srslte_rm_turbo_free_tables();
   free(rm_bits_s);
   free(rm_bits_f);
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/test_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srslte/phy/fec/softbuffer.h"
+#include "srslte/phy/fec/turbodecoder_gen.h"
+#include "srslte/phy/phch/ra.h"
+#include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/vector.h"
+
+#define NOF_HARQ 8
+
+uint32_t nof_prb    = 100;
+uint32_t nof_ues    = 200;
+uint32_t nof_grants = 4;
+uint32_t nof_tti    = 2000;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [pugt]\n", prog);
+  printf("\t-p nof_prb [Default %d]\n", nof_prb);
+  printf("\t-u number of UEs [Default %d]\n", nof_ues);
+  printf("\t-g number of PUSCH grants per TTI [Default %d]\n", nof_grants);
+  printf("\t-t number of TTIs [Default %d]\n", nof_tti);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "pugt")) != -1) {
+    switch (opt) {
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'g':
+        nof_grants = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        nof_tti = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static uint32_t nof_cb(uint32_t tbs)
+{
+  return (tbs + 24) / (SRSLTE_TCOD_MAX_LEN_CB - 24) + 1;
+}
+
+static bool is_zero(const void* buffer, uint32_t nbytes)
+{
+  const uint8_t* b = buffer;
+  for (uint32_t i = 0; i < nbytes; i++) {
+    if (b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int test_pool_rx(bool llr_is_8bit)
+{
+  srslte_softbuffer_pool_t         pool    = {};
+  srslte_softbuffer_pool_metrics_t metrics = {};
+  srslte_softbuffer_rx_t           sb[2]   = {};
+
+  uint32_t max_tbs = srslte_ra_tbs_from_idx(SRSLTE_RA_NOF_TBS_IDX - 1, nof_prb);
+  uint32_t max_cb  = max_tbs / (SRSLTE_TCOD_MAX_LEN_CB - 24) + 1;
+  uint32_t nbytes  = SOFTBUFFER_SIZE * (llr_is_8bit ? 1 : 2);
+
+  // The pool can hold a single TB of the largest size
+  uint32_t max_bufs = max_cb;
+
+  TESTASSERT(srslte_softbuffer_pool_init_rx(&pool, llr_is_8bit, max_bufs) == SRSLTE_SUCCESS);
+  for (uint32_t i = 0; i < 2; i++) {
+    TESTASSERT(srslte_softbuffer_rx_init_pool(&sb[i], nof_prb, &pool) == SRSLTE_SUCCESS);
+    TESTASSERT(sb[i].max_cb == max_cb);
+  }
+
+  // Nothing is allocated until a TB is in flight
+  srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+  TESTASSERT(metrics.nof_buffers == 0 && metrics.nof_bytes == 0);
+
+  // A new TB borrows one buffer per code block, which comes zeroed even if it was used before
+  srslte_softbuffer_rx_reset_tbs(&sb[0], max_tbs);
+  for (uint32_t i = 0; i < max_cb; i++) {
+    TESTASSERT(sb[0].buffer_f[i] != NULL && sb[0].data[i] != NULL);
+    TESTASSERT(is_zero(sb[0].buffer_f[i], nbytes));
+    memset(sb[0].buffer_f[i], 0x55, nbytes);
+    memset(sb[0].data[i], 0x55, 6144 / 8);
+    sb[0].cb_crc[i] = true;
+  }
+  srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+  TESTASSERT(metrics.nof_in_use == max_cb && metrics.nof_buffers == max_cb);
+
+  // A smaller TB gives the extra code block buffers back
+  srslte_softbuffer_rx_reset_tbs(&sb[0], 1000);
+  TESTASSERT(sb[0].buffer_f[0] != NULL && sb[0].buffer_f[1] == NULL && sb[0].data[1] == NULL);
+  TESTASSERT(is_zero(sb[0].buffer_f[0], nbytes) && is_zero(sb[0].data[0], 6144 / 8));
+  TESTASSERT(!sb[0].cb_crc[0]);
+  srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+  TESTASSERT(metrics.nof_in_use == 1);
+
+  // The pool is exhausted before the second softbuffer gets all its code blocks
+  srslte_softbuffer_rx_reset_tbs(&sb[1], max_tbs);
+  srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+  TESTASSERT(metrics.nof_in_use == max_bufs && metrics.nof_buffers == max_bufs);
+  TESTASSERT(metrics.nof_failures == 1 && sb[1].buffer_f[max_cb - 1] == NULL);
+
+  // Releasing gives everything back, a full reset releases too
+  srslte_softbuffer_rx_release(&sb[1]);
+  srslte_softbuffer_rx_reset(&sb[0]);
+  srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+  TESTASSERT(metrics.nof_in_use == 0 && metrics.max_in_use == max_bufs);
+  TESTASSERT(metrics.nof_bytes == max_bufs * ((nbytes + 63) / 64 * 64 + 6144 / 8));
+  for (uint32_t i = 0; i < max_cb; i++) {
+    TESTASSERT(sb[0].buffer_f[i] == NULL && sb[1].buffer_f[i] == NULL);
+  }
+
+  for (uint32_t i = 0; i < 2; i++) {
+    srslte_softbuffer_rx_free(&sb[i]);
+  }
+  srslte_softbuffer_pool_free(&pool);
+  return SRSLTE_SUCCESS;
+}
+
+int test_pool_tx()
+{
+  srslte_softbuffer_pool_t         pool    = {};
+  srslte_softbuffer_pool_metrics_t metrics = {};
+  srslte_softbuffer_tx_t           sb      = {};
+  srslte_softbuffer_rx_t           rx      = {};
+
+  uint32_t max_tbs = srslte_ra_tbs_from_idx(SRSLTE_RA_NOF_TBS_IDX - 1, nof_prb);
+
+  TESTASSERT(srslte_softbuffer_pool_init_tx(&pool, 0) == SRSLTE_SUCCESS);
+  TESTASSERT(srslte_softbuffer_rx_init_pool(&rx, nof_prb, &pool) == SRSLTE_ERROR_INVALID_INPUTS);
+  TESTASSERT(srslte_softbuffer_tx_init_pool(&sb, nof_prb, &pool) == SRSLTE_SUCCESS);
+
+  srslte_softbuffer_tx_reset_tbs(&sb, max_tbs);
+  for (uint32_t i = 0; i < sb.max_cb; i++) {
+    TESTASSERT(sb.buffer_b[i] != NULL);
+  }
+  srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+  TESTASSERT(metrics.nof_in_use == sb.max_cb && metrics.nof_borrows == sb.max_cb);
+
+  // Retransmissions reuse the buffers, the second TB reuses the ones the first gave back
+  srslte_softbuffer_tx_reset_tbs(&sb, max_tbs);
+  srslte_softbuffer_tx_release(&sb);
+  srslte_softbuffer_tx_reset_tbs(&sb, max_tbs);
+  srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+  TESTASSERT(metrics.nof_buffers == sb.max_cb && metrics.nof_borrows == 2 * sb.max_cb);
+
+  srslte_softbuffer_tx_free(&sb);
+  srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+  TESTASSERT(metrics.nof_in_use == 0);
+  srslte_softbuffer_pool_free(&pool);
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Emulates the PUSCH of an eNB with nof_ues connected UEs of which nof_grants get a new TB every TTI, and compares
+ * the memory and the time spent on the Rx softbuffers of per-UE allocation against pooled 16-bit and 8-bit storage
+ */
+int test_throughput(int mode)
+{
+  const char*              mode_str[] = {"per-UE", "pool 16-bit", "pool 8-bit"};
+  srslte_softbuffer_pool_t pool       = {};
+  srslte_softbuffer_rx_t*  sb         = calloc(nof_ues * NOF_HARQ, sizeof(srslte_softbuffer_rx_t));
+  TESTASSERT(sb != NULL);
+
+  if (mode > 0) {
+    TESTASSERT(srslte_softbuffer_pool_init_rx(&pool, mode == 2, 0) == SRSLTE_SUCCESS);
+  }
+  for (uint32_t i = 0; i < nof_ues * NOF_HARQ; i++) {
+    if (mode) {
+      TESTASSERT(srslte_softbuffer_rx_init_pool(&sb[i], nof_prb, &pool) == SRSLTE_SUCCESS);
+    } else {
+      TESTASSERT(srslte_softbuffer_rx_init(&sb[i], nof_prb) == SRSLTE_SUCCESS);
+    }
+  }
+
+  // Highest MCS over an even share of the band
+  uint32_t tbs = srslte_ra_tbs_from_idx(SRSLTE_RA_NOF_TBS_IDX - 1, SRSLTE_MAX(nof_prb / nof_grants, 1));
+
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  for (uint32_t tti = 0; tti < nof_tti; tti++) {
+    for (uint32_t g = 0; g < nof_grants; g++) {
+      uint32_t                ue = (tti * nof_grants + g) % nof_ues;
+      srslte_softbuffer_rx_t* q  = &sb[ue * NOF_HARQ + tti % NOF_HARQ];
+
+      // New transmission, then CRC OK
+      srslte_softbuffer_rx_reset_tbs(q, tbs);
+      if (mode) {
+        srslte_softbuffer_rx_release(q);
+      }
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  uint64_t nof_bytes = 0;
+  if (mode) {
+    srslte_softbuffer_pool_metrics_t metrics = {};
+    srslte_softbuffer_pool_get_metrics(&pool, &metrics);
+    nof_bytes = metrics.nof_bytes;
+  } else {
+    nof_bytes = (uint64_t)nof_ues * NOF_HARQ * sb[0].max_cb * (SOFTBUFFER_SIZE * sizeof(int16_t) + 6144 / 8);
+  }
+
+  double nof_tb = (double)nof_tti * nof_grants;
+  printf("%-12s %d UEs: %8.2f MB of soft buffers, %6.2f us per TB (%d CB)\n",
+         mode_str[mode],
+         nof_ues,
+         nof_bytes / 1e6,
+         (t[0].tv_sec * 1e6 + t[0].tv_usec) / nof_tb,
+         nof_cb(tbs));
+
+  for (uint32_t i = 0; i < nof_ues * NOF_HARQ; i++) {
+    srslte_softbuffer_rx_free(&sb[i]);
+  }
+  free(sb);
+  srslte_softbuffer_pool_free(&pool);
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  TESTASSERT(test_pool_rx(false) == SRSLTE_SUCCESS);
+  TESTASSERT(test_pool_rx(true) == SRSLTE_SUCCESS);
+  TESTASSERT(test_pool_tx() == SRSLTE_SUCCESS);
+
+  for (int mode = 0; mode < 3; mode++) {
+    TESTASSERT(test_throughput(mode) == SRSLTE_SUCCESS);
+  }
+
+  printf("Ok\n");
+  return SRSLTE_SUCCESS;
+}
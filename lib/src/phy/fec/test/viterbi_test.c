@@ -109,11 +109,16 @@ int main(int argc, char** argv)
   uint8_t * data_tx, *data_rx, *symbols;
   float     var[SNR_POINTS], varunc[SNR_POINTS];
   int       snr_points;
-  int       errors_s   = 0;
-  int       errors_us  = 0;
-  int       errors_c   = 0;
-  int       errors_f   = 0;
-  int       errors_sse = 0;
+  int       errors_s       = 0;
+  int       errors_us      = 0;
+  int       errors_c       = 0;
+  int       errors_f       = 0;
+  int       errors_sse     = 0;
+  int       mismatch_multi = 0;
+  float*    llr_multi[SRSLTE_VITERBI_MAX_LANES];
+  uint8_t*  data_multi[SRSLTE_VITERBI_MAX_LANES];
+  uint8_t*  data_ref[SRSLTE_VITERBI_MAX_LANES];
+  uint32_t  nof_multi = 0;
 #ifdef TEST_SSE
   srslte_viterbi_t dec_sse;
 #endif
@@ -186,6 +191,16 @@ int main(int argc, char** argv)
     exit(-1);
   }
 
+  for (int j = 0; j < SRSLTE_VITERBI_MAX_LANES; j++) {
+    llr_multi[j]  = srslte_vec_f_malloc(coded_length);
+    data_multi[j] = srslte_vec_u8_malloc(frame_length);
+    data_ref[j]   = srslte_vec_u8_malloc(frame_length);
+    if (!llr_multi[j] || !data_multi[j] || !data_ref[j]) {
+      perror("malloc");
+      exit(-1);
+    }
+  }
+
   float ebno_inc, esno_db;
   ebno_inc = (SNR_MAX - SNR_MIN) / SNR_POINTS;
   if (ebno_db == 100.0) {
@@ -245,6 +260,19 @@ int main(int argc, char** argv)
 #ifdef TEST_SSE
       VITERBI_TEST(srslte_viterbi_decode_uc, dec_sse, llr_c, errors_sse);
 #endif
+
+      /* Frames decoded in parallel must match the ones decoded one by one */
+      memcpy(llr_multi[nof_multi], llr, coded_length * sizeof(float));
+      memcpy(data_ref[nof_multi], data_rx, frame_length * sizeof(uint8_t));
+      nof_multi++;
+      if (nof_multi == SRSLTE_VITERBI_MAX_LANES || frame_cnt + 1 == nof_frames) {
+        srslte_viterbi_decode_f_multi(&dec, llr_multi, data_multi, nof_multi, frame_length);
+        for (uint32_t j = 0; j < nof_multi; j++) {
+          mismatch_multi += memcmp(data_multi[j], data_ref[j], frame_length) != 0;
+        }
+        nof_multi = 0;
+      }
+
       frame_cnt++;
       printf("     Eb/No: %3.2f %10d/%d   ", SNR_MIN + i * ebno_inc, frame_cnt, nof_frames);
       if (errors_s >= 0)
@@ -288,6 +316,16 @@ int main(int argc, char** argv)
   free(llr_s);
   free(llr_us);
   free(data_rx);
+  for (int j = 0; j < SRSLTE_VITERBI_MAX_LANES; j++) {
+    free(llr_multi[j]);
+    free(data_multi[j]);
+    free(data_ref[j]);
+  }
+
+  if (mismatch_multi) {
+    printf("%d frames decoded in parallel differ from the serial decoder\n", mismatch_multi);
+    exit(-1);
+  }
 
   if (snr_points == 1) {
     int expected_e = get_expected_errors(nof_frames, seed, frame_length, tail_biting, ebno_db);
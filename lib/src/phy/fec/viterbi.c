@@ -39,6 +39,10 @@
 #define DEFAULT_GAIN 100
 
 #define DEFAULT_GAIN_16 1000
+
+/* The single-frame decoder already fills the vectors with the 64 states, so the lane-parallel one only pays off when
+ * most of its lanes are in use */
+#define MULTI_MIN_LANES 12
 #define VITERBI_16
 
 #ifndef LV_HAVE_AVX2
@@ -172,7 +176,11 @@ void free37_avx2_16bit(void* o)
   if (q->tmp_s) {
     free(q->tmp_s);
   }
+  if (q->symbols_multi) {
+    free(q->symbols_multi);
+  }
   delete_viterbi37_avx2_16bit(q->ptr);
+  delete_viterbi37_multi_avx2_16bit(q->ptr_multi);
 }
 
 int decode37_avx2(void* o, uint8_t* symbols, uint8_t* data, uint32_t frame_length)
@@ -464,9 +472,21 @@ int init37_avx2_16bit(srslte_viterbi_t* q, int poly[3], uint32_t framebits, bool
     ERROR("create_viterbi37 failed\n");
     free37(q);
     return -1;
-  } else {
-    return 0;
   }
+
+  // Lane-parallel decoder for srslte_viterbi_decode_f_multi()
+  q->symbols_multi = srslte_vec_u16_malloc(SRSLTE_VITERBI_MAX_LANES * TB_ITER * 3 * (q->framebits + q->K - 1));
+  if (!q->symbols_multi) {
+    perror("malloc");
+    free37_avx2_16bit(q);
+    return -1;
+  }
+  if ((q->ptr_multi = create_viterbi37_multi_avx2_16bit(poly, TB_ITER * framebits)) == NULL) {
+    ERROR("create_viterbi37_multi failed\n");
+    free37_avx2_16bit(q);
+    return -1;
+  }
+  return 0;
 }
 
 #endif
@@ -576,6 +596,88 @@ int srslte_viterbi_decode_f(srslte_viterbi_t* q, float* symbols, uint8_t* data,
   }
 }
 
+/* Decodes nof_frames frames of real-valued symbols, all of frame_length bits. Each frame gives the same result as
+ * srslte_viterbi_decode_f(). When the lane-parallel decoder is available, up to SRSLTE_VITERBI_MAX_LANES frames are
+ * decoded at once (as long as at least MULTI_MIN_LANES of them are left), otherwise they are decoded one by one.
+ */
+int srslte_viterbi_decode_f_multi(srslte_viterbi_t* q,
+                                  float*            symbols[],
+                                  uint8_t*          data[],
+                                  uint32_t          nof_frames,
+                                  uint32_t          frame_length)
+{
+  if (frame_length > q->framebits) {
+    ERROR("Initialized decoder for max frame length %d bits\n", q->framebits);
+    return -1;
+  }
+#ifdef VITERBI_16
+  if (q->ptr_multi != NULL && q->decode_f == NULL) {
+    uint32_t len, nbits, nof_copies;
+    if (q->tail_biting) {
+      len        = 3 * frame_length;
+      nbits      = TB_ITER * frame_length;
+      nof_copies = TB_ITER;
+    } else {
+      len        = 3 * (frame_length + q->K - 1);
+      nbits      = frame_length + q->K - 1;
+      nof_copies = 1;
+    }
+
+    for (uint32_t f = 0; f < nof_frames; f += SRSLTE_VITERBI_MAX_LANES) {
+      uint32_t nof_lanes = SRSLTE_MIN(SRSLTE_VITERBI_MAX_LANES, nof_frames - f);
+      if (nof_lanes < MULTI_MIN_LANES) {
+        for (uint32_t l = 0; l < nof_lanes; l++) {
+          if (srslte_viterbi_decode_f(q, symbols[f + l], data[f + l], frame_length) < 0) {
+            return -1;
+          }
+        }
+        continue;
+      }
+      if (nof_lanes < SRSLTE_VITERBI_MAX_LANES) {
+        memset(q->symbols_multi, 0, SRSLTE_VITERBI_MAX_LANES * nof_copies * len * sizeof(uint16_t));
+      }
+
+      // Quantize each frame as srslte_viterbi_decode_f() does and interleave the frames symbol by symbol
+      for (uint32_t l = 0; l < nof_lanes; l++) {
+        float  max = 1e-9;
+        float* x   = symbols[f + l];
+        for (int i = 0; i < len; i++) {
+          if (fabs(x[i]) > max) {
+            max = fabs(x[i]);
+          }
+        }
+        srslte_vec_quant_fus(x, q->symbols_us, q->gain_quant / max, 32767.5, 65535, len);
+        for (uint32_t c = 0; c < nof_copies; c++) {
+          uint16_t* y = &q->symbols_multi[c * len * SRSLTE_VITERBI_MAX_LANES + l];
+          for (uint32_t i = 0; i < len; i++) {
+            y[i * SRSLTE_VITERBI_MAX_LANES] = q->symbols_us[i];
+          }
+        }
+      }
+
+      uint32_t best_state[SRSLTE_VITERBI_MAX_LANES];
+      update_viterbi37_multi_avx2_16bit(q->ptr_multi, q->symbols_multi, nbits, q->tail_biting ? -1 : 0, best_state);
+      for (uint32_t l = 0; l < nof_lanes; l++) {
+        if (q->tail_biting) {
+          chainback_viterbi37_multi_avx2_16bit(q->ptr_multi, q->tmp, nbits, best_state[l], l);
+          memcpy(data[f + l], &q->tmp[((int)(TB_ITER / 2)) * frame_length], frame_length * sizeof(uint8_t));
+        } else {
+          chainback_viterbi37_multi_avx2_16bit(q->ptr_multi, data[f + l], frame_length, 0, l);
+        }
+      }
+    }
+    return q->framebits;
+  }
+#endif /* VITERBI_16 */
+
+  for (uint32_t f = 0; f < nof_frames; f++) {
+    if (srslte_viterbi_decode_f(q, symbols[f], data[f], frame_length) < 0) {
+      return -1;
+    }
+  }
+  return q->framebits;
+}
+
 /* symbols are int16 */
 int srslte_viterbi_decode_s(srslte_viterbi_t* q, int16_t* symbols, uint8_t* data, uint32_t frame_length)
 {
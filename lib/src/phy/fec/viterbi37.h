@@ -82,4 +82,16 @@ void delete_viterbi37_avx2_16bit(void* p);
 
 int update_viterbi37_blk_avx2_16bit(void* p, uint16_t* syms, uint32_t nbits, uint32_t* best_state);
 
+void* create_viterbi37_multi_avx2_16bit(int polys[3], uint32_t len);
+
+void delete_viterbi37_multi_avx2_16bit(void* p);
+
+void update_viterbi37_multi_avx2_16bit(void*           p,
+                                       const uint16_t* syms,
+                                       uint32_t        nbits,
+                                       int             starting_state,
+                                       uint32_t        best_state[16]);
+
+int chainback_viterbi37_multi_avx2_16bit(void* p, uint8_t* data, uint32_t nbits, uint32_t endstate, uint32_t lane);
+
 #endif /* SRSLTE_VITERBI37_H_ */
@@ -350,4 +350,155 @@ void update_viterbi37_blk_avx2_16bit(void* p, unsigned short* syms, int nbits, u
   vp->dp = d;
 }
 
+/* Lane-parallel instance: each 16-bit lane of the AVX2 registers runs the decoder above on a different frame. All the
+ * frames have the same length. Path metrics are stored per state, 16 lanes per vector, and decisions are stored as
+ * one word per butterfly and bit, with the lanes of state 2i in the low half and those of state 2i+1 in the high half.
+ */
+struct v37_multi {
+  __m256i   metrics1[64];
+  __m256i   metrics2[64];
+  __m256i   branchtab[3][32];
+  uint32_t* decisions;
+  uint32_t  len;
+};
+
+void* create_viterbi37_multi_avx2_16bit(int polys[3], uint32_t len)
+{
+  void*             p;
+  struct v37_multi* vp;
+
+  if (posix_memalign(&p, sizeof(__m256i), sizeof(struct v37_multi)))
+    return NULL;
+  vp = (struct v37_multi*)p;
+
+  for (int state = 0; state < 32; state++) {
+    for (int i = 0; i < 3; i++) {
+      vp->branchtab[i][state] = _mm256_set1_epi16((polys[i] < 0) ^ parity((2 * state) & polys[i]) ? 65535 : 0);
+    }
+  }
+
+  if (posix_memalign(&p, sizeof(__m256i), (len + 6) * 32 * sizeof(uint32_t))) {
+    free(vp);
+    return NULL;
+  }
+  vp->decisions = (uint32_t*)p;
+  vp->len       = len + 6;
+  bzero(vp->decisions, vp->len * 32 * sizeof(uint32_t));
+  return vp;
+}
+
+void delete_viterbi37_multi_avx2_16bit(void* p)
+{
+  struct v37_multi* vp = p;
+
+  if (vp != NULL) {
+    free(vp->decisions);
+    free(vp);
+  }
+}
+
+/* Runs nbits trellis steps over syms, which holds 3 x 16 symbols (one per lane) per step. The metric update is the
+ * same as update_viterbi37_blk_avx2_16bit(), including the lack of normalisation, so every lane gives the same result
+ * as decoding its frame alone.
+ */
+void update_viterbi37_multi_avx2_16bit(void*           p,
+                                       const uint16_t* syms,
+                                       uint32_t        nbits,
+                                       int             starting_state,
+                                       uint32_t        best_state[16])
+{
+  struct v37_multi* vp = p;
+
+  if (p == NULL || nbits + 6 > vp->len)
+    return;
+
+  __m256i*  old_metrics = vp->metrics1;
+  __m256i*  new_metrics = vp->metrics2;
+  uint32_t* d           = vp->decisions;
+
+  for (int i = 0; i < 64; i++) {
+    old_metrics[i] = _mm256_set1_epi16(63);
+  }
+  if (starting_state != -1) {
+    old_metrics[starting_state & 63] = _mm256_setzero_si256();
+  }
+
+  const __m256i max_metric = _mm256_set1_epi16(8191);
+  for (uint32_t n = 0; n < nbits; n++) {
+    __m256i sym0v = _mm256_loadu_si256((__m256i*)&syms[0]);
+    __m256i sym1v = _mm256_loadu_si256((__m256i*)&syms[16]);
+    __m256i sym2v = _mm256_loadu_si256((__m256i*)&syms[32]);
+    syms += 48;
+
+    for (int i = 0; i < 32; i++) {
+      __m256i decision0, decision1, metric, m_metric, m0, m1, m2, m3;
+
+      /* Form branch metrics */
+      m0       = _mm256_avg_epu16(_mm256_xor_si256(vp->branchtab[0][i], sym0v),
+                                  _mm256_xor_si256(vp->branchtab[1][i], sym1v));
+      metric   = _mm256_avg_epu16(_mm256_xor_si256(vp->branchtab[2][i], sym2v), m0);
+      metric   = _mm256_srli_epi16(metric, 3);
+      m_metric = _mm256_sub_epi16(max_metric, metric);
+
+      /* Add branch metrics to path metrics */
+      m0 = _mm256_add_epi16(old_metrics[i], metric);
+      m3 = _mm256_add_epi16(old_metrics[32 + i], metric);
+      m1 = _mm256_add_epi16(old_metrics[32 + i], m_metric);
+      m2 = _mm256_add_epi16(old_metrics[i], m_metric);
+
+      /* Compare and select, using modulo arithmetic */
+      decision0 = _mm256_cmpgt_epi16(_mm256_sub_epi16(m0, m1), _mm256_setzero_si256());
+      decision1 = _mm256_cmpgt_epi16(_mm256_sub_epi16(m2, m3), _mm256_setzero_si256());
+
+      new_metrics[2 * i]     = _mm256_blendv_epi8(m0, m1, decision0);
+      new_metrics[2 * i + 1] = _mm256_blendv_epi8(m2, m3, decision1);
+
+      /* One bit per lane and state */
+      d[i] = (uint32_t)_mm256_movemask_epi8(_mm256_permute4x64_epi64(_mm256_packs_epi16(decision0, decision1), 0xD8));
+    }
+    d += 32;
+
+    /* Swap pointers to old and new metrics */
+    __m256i* tmp = old_metrics;
+    old_metrics  = new_metrics;
+    new_metrics  = tmp;
+  }
+
+  /* Chainback looks past the last step, where the single-frame decoder reads cleared decisions */
+  bzero(d, 6 * 32 * sizeof(uint32_t));
+
+  if (best_state) {
+    for (int lane = 0; lane < 16; lane++) {
+      uint32_t bst       = 0;
+      uint16_t minmetric = UINT16_MAX;
+      for (uint32_t i = 0; i < 64; i++) {
+        uint16_t m = ((uint16_t*)&old_metrics[i])[lane];
+        if (m <= minmetric) {
+          bst       = i;
+          minmetric = m;
+        }
+      }
+      best_state[lane] = bst;
+    }
+  }
+}
+
+int chainback_viterbi37_multi_avx2_16bit(void* p, uint8_t* data, uint32_t nbits, uint32_t endstate, uint32_t lane)
+{
+  struct v37_multi* vp = p;
+
+  if (p == NULL || lane >= 16)
+    return -1;
+
+  const uint32_t* d = vp->decisions + 6 * 32; /* Look past tail */
+
+  endstate %= 64;
+  while (nbits--) {
+    uint32_t k  = (d[nbits * 32 + (endstate >> 1)] >> ((endstate & 1) * 16 + lane)) & 1;
+    endstate    = (endstate >> 1) | (k << 5);
+    data[nbits] = k;
+  }
+  return 0;
+}
+
 #endif
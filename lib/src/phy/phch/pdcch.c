@@ -20,6 +20,7 @@
  */
 
 #include <math.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -92,6 +93,17 @@ static int pdcch_init(srslte_pdcch_t* q, uint32_t max_prb, uint32_t nof_rx_anten
       goto clean;
     }
 
+    for (int i = 0; i < SRSLTE_VITERBI_MAX_LANES; i++) {
+      q->rm_f_multi[i] = srslte_vec_f_malloc(3 * (SRSLTE_DCI_MAX_BITS + 16));
+      if (!q->rm_f_multi[i]) {
+        goto clean;
+      }
+      q->data_multi[i] = srslte_vec_u8_malloc(SRSLTE_DCI_MAX_BITS + 16);
+      if (!q->data_multi[i]) {
+        goto clean;
+      }
+    }
+
     for (int i = 0; i < SRSLTE_MAX_PORTS; i++) {
       q->x[i] = srslte_vec_cf_malloc(q->max_bits / 2);
       if (!q->x[i]) {
@@ -142,6 +154,14 @@ void srslte_pdcch_free(srslte_pdcch_t* q)
   if (q->d) {
     free(q->d);
   }
+  for (int i = 0; i < SRSLTE_VITERBI_MAX_LANES; i++) {
+    if (q->rm_f_multi[i]) {
+      free(q->rm_f_multi[i]);
+    }
+    if (q->data_multi[i]) {
+      free(q->data_multi[i]);
+    }
+  }
   for (int i = 0; i < SRSLTE_MAX_PORTS; i++) {
     if (q->x[i]) {
       free(q->x[i]);
@@ -191,7 +211,8 @@ int srslte_pdcch_set_cell(srslte_pdcch_t* q, srslte_regs_t* regs, srslte_cell_t
     INFO("PDCCH: Cell config PCI=%d, %d ports.\n", q->cell.id, q->cell.nof_ports);
 
     if (q->cell.id != cell.id || q->cell.nof_prb == 0) {
-      q->cell = cell;
+      q->cell        = cell;
+      q->nof_decoded = 0;
 
       for (int i = 0; i < SRSLTE_NOF_SF_X_FRAME; i++) {
         // we need to pregenerate the sequence for the maximum number of bits, which is 8 times
@@ -206,6 +227,75 @@ int srslte_pdcch_set_cell(srslte_pdcch_t* q, srslte_regs_t* regs, srslte_cell_t
   return ret;
 }
 
+#define YK_BLOCK_NOF_RNTI 256
+#define YK_NOF_BLOCKS (65536 / YK_BLOCK_NOF_RNTI)
+
+/* Yk - 1 of every RNTI and subframe, Yk is never 0 for a non-zero RNTI so it fits in 16 bits. A block is filled
+ * completely before it is published and it is never modified afterwards, so looking up a published block only needs
+ * an atomic load of its pointer. The blocks live as long as the process. */
+static uint16_t*       yk_blocks[YK_NOF_BLOCKS];
+static uint32_t        yk_nof_blocks = 0;
+static pthread_mutex_t yk_mutex      = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t compute_yk(uint16_t rnti, uint32_t sf_idx)
+{
+  uint32_t Yk = rnti;
+  for (uint32_t m = 0; m < sf_idx + 1; m++) {
+    Yk = (39827 * Yk) % 65537;
+  }
+  return Yk;
+}
+
+static uint16_t* yk_block_alloc(uint32_t b)
+{
+  uint16_t* block = srslte_vec_malloc(sizeof(uint16_t) * YK_BLOCK_NOF_RNTI * SRSLTE_NOF_SF_X_FRAME);
+  if (block == NULL) {
+    return NULL;
+  }
+  for (uint32_t i = 0; i < YK_BLOCK_NOF_RNTI; i++) {
+    uint32_t Yk = b * YK_BLOCK_NOF_RNTI + i;
+    for (uint32_t sf_idx = 0; sf_idx < SRSLTE_NOF_SF_X_FRAME; sf_idx++) {
+      Yk                                        = (39827 * Yk) % 65537;
+      block[i * SRSLTE_NOF_SF_X_FRAME + sf_idx] = (uint16_t)(Yk - 1);
+    }
+  }
+  return block;
+}
+
+uint32_t srslte_pdcch_ue_yk(uint16_t rnti, uint32_t sf_idx)
+{
+  if (rnti == 0 || sf_idx >= SRSLTE_NOF_SF_X_FRAME) {
+    return compute_yk(rnti, sf_idx);
+  }
+
+  uint32_t  b     = rnti / YK_BLOCK_NOF_RNTI;
+  uint16_t* block = __atomic_load_n(&yk_blocks[b], __ATOMIC_ACQUIRE);
+  if (block == NULL) {
+    pthread_mutex_lock(&yk_mutex);
+    block = yk_blocks[b];
+    if (block == NULL) {
+      block = yk_block_alloc(b);
+      if (block != NULL) {
+        __atomic_store_n(&yk_blocks[b], block, __ATOMIC_RELEASE);
+        yk_nof_blocks++;
+      }
+    }
+    pthread_mutex_unlock(&yk_mutex);
+    if (block == NULL) {
+      return compute_yk(rnti, sf_idx);
+    }
+  }
+  return (uint32_t)block[(rnti % YK_BLOCK_NOF_RNTI) * SRSLTE_NOF_SF_X_FRAME + sf_idx] + 1;
+}
+
+uint32_t srslte_pdcch_ue_yk_table_nbytes()
+{
+  pthread_mutex_lock(&yk_mutex);
+  uint32_t nbytes = sizeof(yk_blocks) + yk_nof_blocks * sizeof(uint16_t) * YK_BLOCK_NOF_RNTI * SRSLTE_NOF_SF_X_FRAME;
+  pthread_mutex_unlock(&yk_mutex);
+  return nbytes;
+}
+
 uint32_t srslte_pdcch_ue_locations(srslte_pdcch_t*        q,
                                    srslte_dl_sf_cfg_t*    sf,
                                    srslte_dci_location_t* c,
@@ -238,15 +328,12 @@ uint32_t srslte_pdcch_ue_locations_ncce_L(uint32_t               nof_cce,
 {
 
   int       l; // this must be int because of the for(;;--) loop
-  uint32_t  i, k, L, m;
+  uint32_t  i, k, L;
   uint32_t  Yk, ncce;
   const int nof_candidates[4] = {6, 6, 2, 2};
 
-  // Compute Yk for this subframe
-  Yk = rnti;
-  for (m = 0; m < sf_idx + 1; m++) {
-    Yk = (39827 * Yk) % 65537;
-  }
+  // Yk for this subframe
+  Yk = srslte_pdcch_ue_yk(rnti, sf_idx);
 
   k = 0;
   // All aggregation levels from 8 to 1
@@ -329,6 +416,15 @@ uint32_t srslte_pdcch_common_locations_ncce(uint32_t nof_cce, srslte_dci_locatio
   return k;
 }
 
+/* XOR between the parity bits following the nof_bits of data and the CRC remainder */
+static uint16_t pdcch_dci_crc(srslte_pdcch_t* q, uint8_t* data, uint32_t nof_bits)
+{
+  uint8_t* x       = &data[nof_bits];
+  uint16_t p_bits  = (uint16_t)srslte_bit_pack(&x, 16);
+  uint16_t crc_res = ((uint16_t)srslte_crc_checksum(&q->crc, data, nof_bits) & 0xffff);
+  return p_bits ^ crc_res;
+}
+
 /** 36.212 5.3.3.2 to 5.3.3.4
  *
  * Returns XOR between parity and remainder bits
@@ -337,10 +433,6 @@ uint32_t srslte_pdcch_common_locations_ncce(uint32_t nof_cce, srslte_dci_locatio
  */
 int srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t E, uint32_t nof_bits, uint16_t* crc)
 {
-
-  uint16_t p_bits, crc_res;
-  uint8_t* x;
-
   if (q != NULL) {
     if (data != NULL && E <= q->max_bits && nof_bits <= SRSLTE_DCI_MAX_BITS) {
       srslte_vec_f_zero(q->rm_f, 3 * (SRSLTE_DCI_MAX_BITS + 16));
@@ -353,12 +445,8 @@ int srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t
       /* viterbi decoder */
       srslte_viterbi_decode_f(&q->decoder, q->rm_f, data, nof_bits + 16);
 
-      x       = &data[nof_bits];
-      p_bits  = (uint16_t)srslte_bit_pack(&x, 16);
-      crc_res = ((uint16_t)srslte_crc_checksum(&q->crc, data, nof_bits) & 0xffff);
-
       if (crc) {
-        *crc = p_bits ^ crc_res;
+        *crc = pdcch_dci_crc(q, data, nof_bits);
       }
 
       return SRSLTE_SUCCESS;
@@ -371,6 +459,71 @@ int srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t
   }
 }
 
+static bool pdcch_location_isvalid(srslte_pdcch_t* q, srslte_dl_sf_cfg_t* sf, srslte_dci_location_t* location)
+{
+  return srslte_dci_location_isvalid(location) &&
+         location->ncce * 72 + PDCCH_FORMAT_NOF_BITS(location->L) <= NOF_CCE(sf->cfi) * 72;
+}
+
+static double pdcch_llr_mean(srslte_pdcch_t* q, srslte_dci_location_t* location)
+{
+  uint32_t e_bits = PDCCH_FORMAT_NOF_BITS(location->L);
+  double   mean   = 0;
+  for (int i = 0; i < e_bits; i++) {
+    mean += fabsf(q->llr[location->ncce * 72 + i]);
+  }
+  return mean / e_bits;
+}
+
+static srslte_pdcch_decoded_t* pdcch_find_decoded(srslte_pdcch_t* q, srslte_dci_location_t* location, uint32_t nof_bits)
+{
+  for (uint32_t i = 0; i < q->nof_decoded; i++) {
+    srslte_pdcch_decoded_t* d = &q->decoded[i];
+    if (d->location.ncce == location->ncce && d->location.L == location->L && d->nof_bits == nof_bits) {
+      return d;
+    }
+  }
+  return NULL;
+}
+
+/* Decodes the pending candidates. Candidates with the same DCI size go through the Viterbi decoder together */
+static int pdcch_decode_pending(srslte_pdcch_t* q)
+{
+  for (uint32_t i = 0; i < q->nof_decoded; i++) {
+    if (!q->decoded[i].pending) {
+      continue;
+    }
+
+    uint32_t                nof_bits  = q->decoded[i].nof_bits;
+    uint32_t                nof_lanes = 0;
+    srslte_pdcch_decoded_t* lanes[SRSLTE_VITERBI_MAX_LANES];
+    for (uint32_t j = i; j < q->nof_decoded && nof_lanes < SRSLTE_VITERBI_MAX_LANES; j++) {
+      srslte_pdcch_decoded_t* d = &q->decoded[j];
+      if (d->pending && d->nof_bits == nof_bits) {
+        /* unrate matching */
+        srslte_vec_f_zero(q->rm_f_multi[nof_lanes], 3 * (SRSLTE_DCI_MAX_BITS + 16));
+        srslte_rm_conv_rx(&q->llr[d->location.ncce * 72],
+                          PDCCH_FORMAT_NOF_BITS(d->location.L),
+                          q->rm_f_multi[nof_lanes],
+                          3 * (nof_bits + 16));
+        lanes[nof_lanes++] = d;
+      }
+    }
+
+    /* viterbi decoder */
+    if (srslte_viterbi_decode_f_multi(&q->decoder, q->rm_f_multi, q->data_multi, nof_lanes, nof_bits + 16) < 0) {
+      return SRSLTE_ERROR;
+    }
+
+    for (uint32_t l = 0; l < nof_lanes; l++) {
+      memcpy(lanes[l]->payload, q->data_multi[l], (nof_bits + 16) * sizeof(uint8_t));
+      lanes[l]->crc     = pdcch_dci_crc(q, lanes[l]->payload, nof_bits);
+      lanes[l]->pending = false;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 /** Tries to decode a DCI message from the LLRs stored in the srslte_pdcch_t structure by the function
  * srslte_pdcch_extract_llr(). This function can be called multiple times.
  * The location to search for is obtained from msg.
@@ -379,46 +532,102 @@ int srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t
  */
 int srslte_pdcch_decode_msg(srslte_pdcch_t* q, srslte_dl_sf_cfg_t* sf, srslte_dci_cfg_t* dci_cfg, srslte_dci_msg_t* msg)
 {
-  int ret = SRSLTE_ERROR_INVALID_INPUTS;
-  if (q != NULL && msg != NULL && srslte_dci_location_isvalid(&msg->location)) {
-    if (msg->location.ncce * 72 + PDCCH_FORMAT_NOF_BITS(msg->location.L) > NOF_CCE(sf->cfi) * 72) {
+  return srslte_pdcch_decode_msg_batch(q, sf, dci_cfg, msg, 1);
+}
+
+/** Same as calling srslte_pdcch_decode_msg() for each of the nof_msgs messages, but all the candidates are decoded at
+ * once: the ones with the same DCI size share the Viterbi decoder lanes, and a location already decoded for the same
+ * DCI size since the last srslte_pdcch_extract_llr() (e.g. Format 0 and 1A, or the UL and DL searches) is not decoded
+ * again.
+ */
+int srslte_pdcch_decode_msg_batch(srslte_pdcch_t*     q,
+                                  srslte_dl_sf_cfg_t* sf,
+                                  srslte_dci_cfg_t*   dci_cfg,
+                                  srslte_dci_msg_t*   msgs,
+                                  uint32_t            nof_msgs)
+{
+  if (q == NULL || sf == NULL || dci_cfg == NULL || msgs == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  int ret = SRSLTE_SUCCESS;
+
+  /* Register the candidates not decoded yet in this subframe */
+  for (uint32_t i = 0; i < nof_msgs; i++) {
+    srslte_dci_msg_t* msg = &msgs[i];
+    if (!srslte_dci_location_isvalid(&msg->location)) {
+      ERROR("Invalid parameters, location=%d,%d\n", msg->location.ncce, msg->location.L);
+      ret = SRSLTE_ERROR_INVALID_INPUTS;
+      continue;
+    }
+    if (!pdcch_location_isvalid(q, sf, &msg->location)) {
       ERROR("Invalid location: nCCE: %d, L: %d, NofCCE: %d\n", msg->location.ncce, msg->location.L, NOF_CCE(sf->cfi));
-    } else {
-      ret = SRSLTE_SUCCESS;
+      ret = SRSLTE_ERROR_INVALID_INPUTS;
+      continue;
+    }
 
-      uint32_t nof_bits = srslte_dci_format_sizeof(&q->cell, sf, dci_cfg, msg->format);
-      uint32_t e_bits   = PDCCH_FORMAT_NOF_BITS(msg->location.L);
+    uint32_t nof_bits = srslte_dci_format_sizeof(&q->cell, sf, dci_cfg, msg->format);
+    if (nof_bits > SRSLTE_DCI_MAX_BITS) {
+      ERROR("Invalid parameters: nof_bits: %d\n", nof_bits);
+      ret = SRSLTE_ERROR_INVALID_INPUTS;
+      continue;
+    }
+    if (q->nof_decoded < SRSLTE_PDCCH_MAX_DECODED && pdcch_find_decoded(q, &msg->location, nof_bits) == NULL &&
+        pdcch_llr_mean(q, &msg->location) > 0.3) {
+      srslte_pdcch_decoded_t* d = &q->decoded[q->nof_decoded++];
+      d->location               = msg->location;
+      d->nof_bits               = nof_bits;
+      d->pending                = true;
+    }
+  }
 
-      double mean = 0;
-      for (int i = 0; i < e_bits; i++) {
-        mean += fabsf(q->llr[msg->location.ncce * 72 + i]);
-      }
-      mean /= e_bits;
-      if (mean > 0.3) {
-        ret = srslte_pdcch_dci_decode(q, &q->llr[msg->location.ncce * 72], msg->payload, e_bits, nof_bits, &msg->rnti);
-        if (ret == SRSLTE_SUCCESS) {
-          msg->nof_bits = nof_bits;
-          // Check format differentiation
-          if (msg->format == SRSLTE_DCI_FORMAT0 || msg->format == SRSLTE_DCI_FORMAT1A) {
-            msg->format = (msg->payload[dci_cfg->cif_enabled ? 3 : 0] == 0) ? SRSLTE_DCI_FORMAT0 : SRSLTE_DCI_FORMAT1A;
-          }
-        } else {
-          ERROR("Error calling pdcch_dci_decode\n");
-        }
-        DEBUG("Decoded DCI: nCCE=%d, L=%d, format=%s, msg_len=%d, mean=%f, crc_rem=0x%x\n",
-              msg->location.ncce,
-              msg->location.L,
-              srslte_dci_format_string(msg->format),
-              nof_bits,
-              mean,
-              msg->rnti);
-      } else {
-        DEBUG(
-            "Skipping DCI:  nCCE=%d, L=%d, msg_len=%d, mean=%f\n", msg->location.ncce, msg->location.L, nof_bits, mean);
+  if (pdcch_decode_pending(q)) {
+    ERROR("Error calling pdcch_dci_decode\n");
+    return SRSLTE_ERROR;
+  }
+
+  /* Copy the results */
+  for (uint32_t i = 0; i < nof_msgs; i++) {
+    srslte_dci_msg_t* msg = &msgs[i];
+    if (!pdcch_location_isvalid(q, sf, &msg->location)) {
+      continue;
+    }
+    uint32_t nof_bits = srslte_dci_format_sizeof(&q->cell, sf, dci_cfg, msg->format);
+    if (nof_bits > SRSLTE_DCI_MAX_BITS) {
+      continue;
+    }
+
+    srslte_pdcch_decoded_t* d = pdcch_find_decoded(q, &msg->location, nof_bits);
+    if (d != NULL) {
+      memcpy(msg->payload, d->payload, SRSLTE_MIN(nof_bits + 16, SRSLTE_DCI_MAX_BITS) * sizeof(uint8_t));
+      msg->rnti = d->crc;
+    } else if (pdcch_llr_mean(q, &msg->location) > 0.3) {
+      /* No room left to keep it decoded */
+      if (srslte_pdcch_dci_decode(q,
+                                  &q->llr[msg->location.ncce * 72],
+                                  msg->payload,
+                                  PDCCH_FORMAT_NOF_BITS(msg->location.L),
+                                  nof_bits,
+                                  &msg->rnti)) {
+        ERROR("Error calling pdcch_dci_decode\n");
+        return SRSLTE_ERROR;
       }
+    } else {
+      DEBUG("Skipping DCI:  nCCE=%d, L=%d, msg_len=%d\n", msg->location.ncce, msg->location.L, nof_bits);
+      continue;
     }
-  } else {
-    ERROR("Invalid parameters, location=%d,%d\n", msg->location.ncce, msg->location.L);
+
+    msg->nof_bits = nof_bits;
+    // Check format differentiation
+    if (msg->format == SRSLTE_DCI_FORMAT0 || msg->format == SRSLTE_DCI_FORMAT1A) {
+      msg->format = (msg->payload[dci_cfg->cif_enabled ? 3 : 0] == 0) ? SRSLTE_DCI_FORMAT0 : SRSLTE_DCI_FORMAT1A;
+    }
+    DEBUG("Decoded DCI: nCCE=%d, L=%d, format=%s, msg_len=%d, crc_rem=0x%x\n",
+          msg->location.ncce,
+          msg->location.L,
+          srslte_dci_format_string(msg->format),
+          nof_bits,
+          msg->rnti);
   }
   return ret;
 }
@@ -444,6 +653,7 @@ int srslte_pdcch_extract_llr(srslte_pdcch_t*        q,
     nof_symbols     = e_bits / 2;
     ret             = SRSLTE_ERROR;
     srslte_vec_f_zero(q->llr, q->max_bits);
+    q->nof_decoded = 0;
 
     DEBUG("Extracting LLRs: E: %d, SF: %d, CFI: %d\n", e_bits, sf->tti % 10, sf->cfi);
 
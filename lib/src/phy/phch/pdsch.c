@@ -1108,12 +1108,19 @@ static int srslte_pdsch_codeword_encode(srslte_pdsch_t*         q,
       return -1;
     }
 
-    /* Bit scrambling */
-    srslte_scrambling_bytes(seq, (uint8_t*)q->e[codeword_idx], cfg->grant.tb[tb_idx].nof_bits);
+    if (q->dl_sch.tx_bit_per_byte) {
+      /* Reference chain, one bit per byte */
+      srslte_scrambling_b_offset(seq, (uint8_t*)q->e[codeword_idx], 0, cfg->grant.tb[tb_idx].nof_bits);
+      srslte_mod_modulate(
+          &q->mod[mcs->mod], (uint8_t*)q->e[codeword_idx], q->d[codeword_idx], cfg->grant.tb[tb_idx].nof_bits);
+    } else {
+      /* Bit scrambling */
+      srslte_scrambling_bytes(seq, (uint8_t*)q->e[codeword_idx], cfg->grant.tb[tb_idx].nof_bits);
 
-    /* Bit mapping */
-    srslte_mod_modulate_bytes(
-        &q->mod[mcs->mod], (uint8_t*)q->e[codeword_idx], q->d[codeword_idx], cfg->grant.tb[tb_idx].nof_bits);
+      /* Bit mapping */
+      srslte_mod_modulate_bytes(
+          &q->mod[mcs->mod], (uint8_t*)q->e[codeword_idx], q->d[codeword_idx], cfg->grant.tb[tb_idx].nof_bits);
+    }
 
   } else {
     return SRSLTE_ERROR_INVALID_INPUTS;
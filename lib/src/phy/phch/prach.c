@@ -349,8 +349,8 @@ int srslte_prach_init(srslte_prach_t* p, uint32_t max_N_ifft_ul)
 
     // Set up containers
     p->prach_bins = srslte_vec_cf_malloc(MAX_N_zc);
-    p->corr_spec  = srslte_vec_cf_malloc(MAX_N_zc);
-    p->corr       = srslte_vec_f_malloc(MAX_N_zc);
+    p->corr_spec  = srslte_vec_cf_malloc(N_SEQS * MAX_N_zc);
+    p->corr       = srslte_vec_f_malloc(N_SEQS * MAX_N_zc);
 
     // Set up ZC FFTS
     if (srslte_dft_plan(&p->zc_fft, MAX_N_zc, SRSLTE_DFT_FORWARD, SRSLTE_DFT_COMPLEX)) {
@@ -359,11 +359,7 @@ int srslte_prach_init(srslte_prach_t* p, uint32_t max_N_ifft_ul)
     srslte_dft_plan_set_mirror(&p->zc_fft, false);
     srslte_dft_plan_set_norm(&p->zc_fft, true);
 
-    if (srslte_dft_plan(&p->zc_ifft, MAX_N_zc, SRSLTE_DFT_BACKWARD, SRSLTE_DFT_COMPLEX)) {
-      return SRSLTE_ERROR;
-    }
-    srslte_dft_plan_set_mirror(&p->zc_ifft, false);
-    srslte_dft_plan_set_norm(&p->zc_ifft, false);
+    // The batched ZC IFFT is planned in set_cell(), once the number of root sequences is known
 
     uint32_t fft_size_alloc = max_N_ifft_ul * DELTA_F / DELTA_F_RA;
 
@@ -459,9 +455,6 @@ int srslte_prach_set_cell_(srslte_prach_t*      p,
       if (srslte_dft_replan(&p->zc_fft, p->N_zc)) {
         return SRSLTE_ERROR;
       }
-      if (srslte_dft_replan(&p->zc_ifft, p->N_zc)) {
-        return SRSLTE_ERROR;
-      }
     }
 
     // Generate our 64 sequences
@@ -471,6 +464,37 @@ int srslte_prach_set_cell_(srslte_prach_t*      p,
     if (p->num_ra_preambles < 4 || p->num_ra_preambles > p->N_roots) {
       p->num_ra_preambles = p->N_roots;
     }
+
+    // Plan a single IFFT for correlating against all the root sequences
+    if (p->zc_ifft.size == 0) {
+      if (srslte_dft_plan_guru_c(&p->zc_ifft,
+                                 p->N_zc,
+                                 SRSLTE_DFT_BACKWARD,
+                                 p->corr_spec,
+                                 p->corr_spec,
+                                 1,
+                                 1,
+                                 p->num_ra_preambles,
+                                 p->N_zc,
+                                 p->N_zc)) {
+        ERROR("Error creating DFT plan\n");
+        return SRSLTE_ERROR;
+      }
+    } else if (p->zc_ifft.size != p->N_zc || p->zc_ifft_nof_roots != p->num_ra_preambles) {
+      if (srslte_dft_replan_guru_c(&p->zc_ifft,
+                                   p->N_zc,
+                                   p->corr_spec,
+                                   p->corr_spec,
+                                   1,
+                                   1,
+                                   p->num_ra_preambles,
+                                   p->N_zc,
+                                   p->N_zc)) {
+        ERROR("Error creating DFT plan\n");
+        return SRSLTE_ERROR;
+      }
+    }
+    p->zc_ifft_nof_roots = p->num_ra_preambles;
     // Generate sequence FFTs
     for (int i = 0; i < N_SEQS; i++) {
       srslte_dft_run(&p->zc_fft, p->seqs[i], p->dft_seqs[i]);
@@ -604,24 +628,30 @@ int srslte_prach_detect_offset(srslte_prach_t* p,
 
     memcpy(p->prach_bins, &p->signal_fft[begin], p->N_zc * sizeof(cf_t));
 
+    // Frequency domain product with every root sequence
     for (int i = 0; i < p->num_ra_preambles; i++) {
       cf_t* root_spec = p->dft_seqs[p->root_seqs_idx[i]];
 
-      srslte_vec_prod_conj_ccc(p->prach_bins, root_spec, p->corr_spec, p->N_zc);
+      srslte_vec_prod_conj_ccc(p->prach_bins, root_spec, &p->corr_spec[i * p->N_zc], p->N_zc);
+    }
 
-      srslte_dft_run(&p->zc_ifft, p->corr_spec, p->corr_spec);
+    // Single batched IFFT and power delay profile for all the root sequences
+    srslte_dft_run_guru_c(&p->zc_ifft);
 
-      srslte_vec_abs_square_cf(p->corr_spec, p->corr, p->N_zc);
+    srslte_vec_abs_square_cf(p->corr_spec, p->corr, p->num_ra_preambles * p->N_zc);
 
-      float corr_ave = srslte_vec_acc_ff(p->corr, p->N_zc) / p->N_zc;
+    uint32_t winsize = 0;
+    if (p->N_cs != 0) {
+      winsize = p->N_cs;
+    } else {
+      winsize = p->N_zc;
+    }
+    uint32_t n_wins = p->N_zc / winsize;
 
-      uint32_t winsize = 0;
-      if (p->N_cs != 0) {
-        winsize = p->N_cs;
-      } else {
-        winsize = p->N_zc;
-      }
-      uint32_t n_wins = p->N_zc / winsize;
+    for (int i = 0; i < p->num_ra_preambles; i++) {
+      float* corr = &p->corr[i * p->N_zc];
+
+      float corr_ave = srslte_vec_acc_ff(corr, p->N_zc) / p->N_zc;
 
       float max_peak = 0;
       for (int j = 0; j < n_wins; j++) {
@@ -632,21 +662,18 @@ int srslte_prach_detect_offset(srslte_prach_t* p,
         }
         start += p->deadzone;
         p->peak_values[j] = 0;
-        for (int k = start; k < end; k++) {
-          if (p->corr[k] > p->peak_values[j]) {
-            p->peak_values[j]  = p->corr[k];
-            p->peak_offsets[j] = k - start;
-            if (p->peak_values[j] > max_peak) {
-              max_peak = p->peak_values[j];
-            }
+        if (end > start) {
+          uint32_t k         = srslte_vec_max_fi(&corr[start], end - start);
+          p->peak_values[j]  = corr[start + k];
+          p->peak_offsets[j] = k;
+          if (p->peak_values[j] > max_peak) {
+            max_peak = p->peak_values[j];
           }
         }
       }
       if (max_peak > p->detect_factor * corr_ave) {
         for (int j = 0; j < n_wins; j++) {
           if (p->peak_values[j] > p->detect_factor * corr_ave) {
-            // printf("saving prach correlation\n");
-            // memcpy(save_corr, p->corr, p->N_zc*sizeof(float));
             if (indices) {
               indices[*n_indices] = (i * n_wins) + j;
             }
@@ -654,15 +681,15 @@ int srslte_prach_detect_offset(srslte_prach_t* p,
               peak_to_avg[*n_indices] = p->peak_values[j] / corr_ave;
             }
             if (t_offsets) {
-              float corr = 1.8;
+              float corr_factor = 1.8;
               if (p->peak_offsets[j] > 30) {
-                corr = 1.9;
+                corr_factor = 1.9;
               }
               if (p->peak_offsets[j] > 250) {
-                corr = 1.91;
+                corr_factor = 1.91;
               }
 
-              t_offsets[*n_indices] = corr * p->peak_offsets[j] / (DELTA_F_RA * p->N_zc);
+              t_offsets[*n_indices] = corr_factor * p->peak_offsets[j] / (DELTA_F_RA * p->N_zc);
             }
             (*n_indices)++;
           }
@@ -126,6 +126,7 @@ uint32_t srslte_sch_find_Ioffset_cqi(float beta)
 }
 
 #define SCH_MAX_G_BITS (SRSLTE_MAX_PRB * 12 * 12 * 12)
+#define SCH_MAX_W_BUFF (3 * 6176)
 
 int srslte_sch_init(srslte_sch_t* q)
 {
@@ -204,6 +205,7 @@ void srslte_sch_free(srslte_sch_t* q)
   if (q->ul_interleaver) {
     free(q->ul_interleaver);
   }
+  srslte_sch_set_tx_bit_per_byte(q, false);
   srslte_tdec_free(&q->decoder);
   srslte_tcod_free(&q->encoder);
   srslte_uci_cqi_free(&q->uci_cqi);
@@ -220,6 +222,43 @@ float srslte_sch_last_noi(srslte_sch_t* q)
   return q->avg_iterations;
 }
 
+/* Selects the reference DL-SCH encoder, which processes one bit per byte and outputs unpacked bits. It is only meant
+ * for checking the packed encoder.
+ */
+int srslte_sch_set_tx_bit_per_byte(srslte_sch_t* q, bool enable)
+{
+  if (enable && !q->tx_bit_per_byte) {
+    q->tx_tb_bits      = srslte_vec_u8_malloc(SRSLTE_MAX_CODEBLOCKS * SRSLTE_TCOD_MAX_LEN_CB);
+    q->tx_cb_bits      = srslte_vec_u8_malloc(SRSLTE_TCOD_MAX_LEN_CB);
+    q->tx_coded_bits   = srslte_vec_u8_malloc(3 * SRSLTE_TCOD_MAX_LEN_CB + 12);
+    q->tx_w_buff       = srslte_vec_u8_malloc(SCH_MAX_W_BUFF);
+    q->tx_bit_per_byte = true;
+    if (!q->tx_tb_bits || !q->tx_cb_bits || !q->tx_coded_bits || !q->tx_w_buff) {
+      srslte_sch_set_tx_bit_per_byte(q, false);
+      return SRSLTE_ERROR;
+    }
+  } else if (!enable && q->tx_bit_per_byte) {
+    if (q->tx_tb_bits) {
+      free(q->tx_tb_bits);
+    }
+    if (q->tx_cb_bits) {
+      free(q->tx_cb_bits);
+    }
+    if (q->tx_coded_bits) {
+      free(q->tx_coded_bits);
+    }
+    if (q->tx_w_buff) {
+      free(q->tx_w_buff);
+    }
+    q->tx_tb_bits      = NULL;
+    q->tx_cb_bits      = NULL;
+    q->tx_coded_bits   = NULL;
+    q->tx_w_buff       = NULL;
+    q->tx_bit_per_byte = false;
+  }
+  return SRSLTE_SUCCESS;
+}
+
 /* Encode a transport block according to 36.212 5.3.2
  *
  */
@@ -249,6 +288,13 @@ static int encode_tb_off(srslte_sch_t*           q,
       return -1;
     }
 
+    for (uint32_t i = 0; i < cb_segm->C; i++) {
+      if (softbuffer->buffer_b[i] == NULL) {
+        ERROR("Error soft buffer for CB %d is not allocated\n", i);
+        return SRSLTE_ERROR;
+      }
+    }
+
     uint32_t Gp = nof_e_bits / Qm;
 
     uint32_t gamma = Gp;
@@ -339,6 +385,62 @@ static int encode_tb_off(srslte_sch_t*           q,
   return ret;
 }
 
+/* Same as encode_tb() one bit per byte, with the bit-wise CRC, turbo coder and rate matching. The data is always
+ * encoded again, so retransmissions do not use the soft buffer.
+ */
+static int encode_tb_bit_per_byte(srslte_sch_t*    q,
+                                  srslte_cbsegm_t* cb_segm,
+                                  uint32_t         Qm,
+                                  uint32_t         rv,
+                                  uint32_t         nof_e_bits,
+                                  uint8_t*         data,
+                                  uint8_t*         e_bits)
+{
+  uint32_t rp = 0, wp = 0;
+
+  if (data == NULL || cb_segm->F) {
+    ERROR("Error the bit per byte encoder needs the data and does not support filler bits\n");
+    return SRSLTE_ERROR;
+  }
+
+  uint32_t Gp    = nof_e_bits / Qm;
+  uint32_t gamma = (cb_segm->C > 0) ? Gp % cb_segm->C : Gp;
+
+  srslte_bit_unpack_vector(data, q->tx_tb_bits, cb_segm->tbs);
+  srslte_crc_attach(&q->crc_tb, q->tx_tb_bits, cb_segm->tbs);
+
+  for (uint32_t i = 0; i < cb_segm->C; i++) {
+    uint32_t cb_len = (i < cb_segm->C2) ? cb_segm->K2 : cb_segm->K1;
+    uint32_t rlen   = (cb_segm->C > 1) ? cb_len - 24 : cb_len;
+    uint32_t n_e;
+    if (i <= cb_segm->C - gamma - 1) {
+      n_e = Qm * (Gp / cb_segm->C);
+    } else {
+      n_e = Qm * ((uint32_t)ceilf((float)Gp / cb_segm->C));
+    }
+
+    memcpy(q->tx_cb_bits, &q->tx_tb_bits[rp], rlen);
+    if (cb_segm->C > 1) {
+      srslte_crc_attach(&q->crc_cb, q->tx_cb_bits, rlen);
+    }
+
+    srslte_tcod_encode(&q->encoder, q->tx_cb_bits, q->tx_coded_bits, cb_len);
+
+    // The circular buffer is only written by the first redundancy version
+    uint8_t* w_buff = q->tx_w_buff;
+    uint32_t in_len = 3 * cb_len + 12;
+    if (srslte_rm_turbo_tx(w_buff, SCH_MAX_W_BUFF, q->tx_coded_bits, in_len, &e_bits[wp], n_e, 0) < 0 ||
+        (rv > 0 && srslte_rm_turbo_tx(w_buff, SCH_MAX_W_BUFF, q->tx_coded_bits, in_len, &e_bits[wp], n_e, rv) < 0)) {
+      ERROR("Error in rate matching\n");
+      return SRSLTE_ERROR;
+    }
+
+    rp += rlen;
+    wp += n_e;
+  }
+  return SRSLTE_SUCCESS;
+}
+
 static int encode_tb(srslte_sch_t*           q,
                      srslte_softbuffer_tx_t* soft_buffer,
                      srslte_cbsegm_t*        cb_segm,
@@ -520,6 +622,13 @@ static int decode_tb(srslte_sch_t*           q,
       return SRSLTE_ERROR_INVALID_INPUTS;
     }
 
+    for (uint32_t i = 0; i < cb_segm->C; i++) {
+      if (softbuffer->buffer_f[i] == NULL) {
+        ERROR("Error soft buffer for CB %d is not allocated\n", i);
+        return SRSLTE_ERROR;
+      }
+    }
+
     bool crc_ok = true;
 
     data[cb_segm->tbs / 8 + 0] = 0;
@@ -633,6 +742,11 @@ int srslte_dlsch_encode2(srslte_sch_t*       q,
 
   uint32_t Qm = srslte_mod_bits_x_symbol(cfg->grant.tb[tb_idx].mod);
 
+  if (q->tx_bit_per_byte) {
+    return encode_tb_bit_per_byte(
+        q, &cb_segm, Qm * Nl, cfg->grant.tb[tb_idx].rv, cfg->grant.tb[tb_idx].nof_bits, data, e_bits);
+  }
+
   return encode_tb(q,
                    cfg->softbuffers.tx[tb_idx],
                    &cb_segm,
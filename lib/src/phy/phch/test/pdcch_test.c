@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 #include <unistd.h>
 
 #include "srslte/srslte.h"
@@ -153,6 +154,132 @@ int test_dci_payload_size()
   return 0;
 }
 
+#define BATCH_NOF_REPETITIONS 100
+#define BATCH_MAX_CANDIDATES (4 * 22)
+
+static double   batch_serial_us   = 0;
+static double   batch_us          = 0;
+static uint32_t batch_nof_decoded = 0;
+
+/* Decodes all the candidates a UE would search in this subframe in a single batch, checks that the result matches the
+ * candidates decoded one by one and measures the decoding rate of both
+ */
+int test_batch_decode(srslte_pdcch_t* q, srslte_dl_sf_cfg_t* sf, srslte_dci_cfg_t* cfg, uint16_t rnti)
+{
+  srslte_dci_location_t     locations[22];
+  srslte_dci_msg_t          batch[BATCH_MAX_CANDIDATES];
+  srslte_dci_msg_t          serial[BATCH_MAX_CANDIDATES];
+  const srslte_dci_format_t formats[] = {SRSLTE_DCI_FORMAT1A, SRSLTE_DCI_FORMAT1, SRSLTE_DCI_FORMAT1C, SRSLTE_DCI_FORMAT2A};
+  uint32_t                  nof_formats    = cell.nof_ports > 1 ? 4 : 3;
+  uint32_t                  nof_candidates = 0;
+
+  uint32_t nof_locations = srslte_pdcch_common_locations(q, locations, 6, sf->cfi);
+  nof_locations += srslte_pdcch_ue_locations(q, sf, &locations[nof_locations], 16, rnti);
+  for (uint32_t f = 0; f < nof_formats; f++) {
+    for (uint32_t l = 0; l < nof_locations; l++) {
+      srslte_dci_msg_t* msg = &batch[nof_candidates++];
+      ZERO_OBJECT(*msg);
+      msg->location = locations[l];
+      msg->format   = formats[f];
+    }
+  }
+
+  // Fill the unused CCEs with noise, so that no candidate is skipped for low energy
+  for (uint32_t i = 0; i < 72 * q->nof_cce[sf->cfi - 1]; i++) {
+    if (q->llr[i] == 0.0f) {
+      q->llr[i] = (rand() & 1) ? 1.0f : -1.0f;
+    }
+  }
+
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  for (int r = 0; r < BATCH_NOF_REPETITIONS; r++) {
+    for (uint32_t i = 0; i < nof_candidates; i++) {
+      uint32_t nof_bits  = srslte_dci_format_sizeof(&q->cell, sf, cfg, batch[i].format);
+      serial[i]          = batch[i];
+      serial[i].nof_bits = nof_bits;
+      if (srslte_pdcch_dci_decode(q,
+                                  &q->llr[serial[i].location.ncce * 72],
+                                  serial[i].payload,
+                                  72 * (1u << serial[i].location.L),
+                                  nof_bits,
+                                  &serial[i].rnti)) {
+        return SRSLTE_ERROR;
+      }
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  batch_serial_us += t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+  gettimeofday(&t[1], NULL);
+  for (int r = 0; r < BATCH_NOF_REPETITIONS; r++) {
+    // Forget the candidates decoded in the previous repetition, as srslte_pdcch_extract_llr() does
+    q->nof_decoded = 0;
+    if (srslte_pdcch_decode_msg_batch(q, sf, cfg, batch, nof_candidates)) {
+      return SRSLTE_ERROR;
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  batch_us += t[0].tv_sec * 1e6 + t[0].tv_usec;
+  batch_nof_decoded += nof_candidates * BATCH_NOF_REPETITIONS;
+
+  for (uint32_t i = 0; i < nof_candidates; i++) {
+    if (batch[i].nof_bits != serial[i].nof_bits || batch[i].rnti != serial[i].rnti ||
+        memcmp(batch[i].payload, serial[i].payload, serial[i].nof_bits) != 0) {
+      ERROR("Batch decoded candidate %d (nCCE=%d, L=%d, %s) does not match\n",
+            i,
+            batch[i].location.ncce,
+            batch[i].location.L,
+            srslte_dci_format_string(serial[i].format));
+      return SRSLTE_ERROR;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
+#define UE_LOCATIONS_NOF_RNTI 1000
+
+/* Checks the shared Yk table against the recursion of 36.213 9.1.1 for a thousand C-RNTIs, and compares its size and
+ * the time taken to derive all their candidates with pregenerating the 3x10 candidate sets of every RNTI
+ */
+int test_ue_locations()
+{
+  srslte_dci_location_t locations[3][SRSLTE_NOF_SF_X_FRAME][16];
+  const uint32_t        nof_cce[3] = {2, 10, 21};
+  uint32_t              nof_locations           = 0;
+
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  for (uint16_t rnti = SRSLTE_CRNTI_START; rnti < SRSLTE_CRNTI_START + UE_LOCATIONS_NOF_RNTI; rnti++) {
+    for (uint32_t sf_idx = 0; sf_idx < SRSLTE_NOF_SF_X_FRAME; sf_idx++) {
+      uint32_t Yk = rnti;
+      for (uint32_t m = 0; m < sf_idx + 1; m++) {
+        Yk = (39827 * Yk) % 65537;
+      }
+      if (srslte_pdcch_ue_yk(rnti, sf_idx) != Yk) {
+        ERROR("Wrong Yk for rnti=0x%x, sf_idx=%d\n", rnti, sf_idx);
+        return SRSLTE_ERROR;
+      }
+      for (uint32_t i = 0; i < 3; i++) {
+        nof_locations += srslte_pdcch_ue_locations_ncce(nof_cce[i], locations[i][sf_idx], 16, sf_idx, rnti);
+      }
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  printf("Generated %d UE-specific candidates of %d RNTIs in %ld us. Yk table: %d bytes, pregenerated candidates: "
+         "%zd bytes\n",
+         nof_locations,
+         UE_LOCATIONS_NOF_RNTI,
+         t[0].tv_sec * 1000000 + t[0].tv_usec,
+         srslte_pdcch_ue_yk_table_nbytes(),
+         UE_LOCATIONS_NOF_RNTI * (sizeof(locations) + sizeof(uint32_t) * 3 * SRSLTE_NOF_SF_X_FRAME));
+  return SRSLTE_SUCCESS;
+}
+
 typedef struct {
   srslte_dci_msg_t      dci_tx, dci_rx;
   srslte_dci_location_t dci_location;
@@ -185,6 +312,10 @@ int main(int argc, char** argv)
     exit(-1);
   }
 
+  if (test_ue_locations()) {
+    exit(-1);
+  }
+
   /* init memory */
 
   srslte_chest_dl_res_init(&chest_dl_res, cell.nof_prb);
@@ -342,6 +473,10 @@ int main(int argc, char** argv)
       }
     }
 
+    if (test_batch_decode(&pdcch_rx, &dl_sf, &dci_cfg, 1234)) {
+      goto quit;
+    }
+
     /* Compare Tx and Rx */
     for (i = 0; i < nof_dcis; i++) {
       if (memcmp(testcases[i].dci_tx.payload, testcases[i].dci_rx.payload, testcases[i].dci_tx.nof_bits)) {
@@ -394,6 +529,10 @@ int main(int argc, char** argv)
       }
     }
   }
+  printf("Decoded %d PDCCH candidates: %.2f Mcand/s one by one, %.2f Mcand/s batched\n",
+         batch_nof_decoded,
+         batch_nof_decoded / batch_serial_us,
+         batch_nof_decoded / batch_us);
   ret = 0;
 
 quit:
@@ -55,15 +55,17 @@ static char*       input_file                   = NULL;
 static int         M                            = 1;
 static bool        enable_256qam                = false;
 static bool        use_8_bit                    = false;
+static bool        check_bit_per_byte           = false;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [fmMbcsrtRFpnwav] \n", prog);
+  printf("Usage: %s [fmMbecsrtRFpnwav] \n", prog);
   printf("\t-f read signal from file [Default generate it with pdsch_encode()]\n");
   printf("\t-m MCS [Default %d]\n", mcs[0]);
   printf("\t-M MCS2 [Default %d]\n", mcs[1]);
   printf("\t-c cell id [Default %d]\n", cell.id);
   printf("\t-b Use 8-bit LLR [Default 16-bit]\n");
+  printf("\t-e Check the encoded symbols against the bit per byte reference encoder\n");
   printf("\t-s subframe [Default %d]\n", subframe);
   printf("\t-r rv_idx [Default %d]\n", rv_idx[0]);
   printf("\t-t rv_idx2 [Default %d]\n", rv_idx[1]);
@@ -83,7 +85,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxj")) != -1) {
+  while ((opt = getopt(argc, argv, "fmMcsbertRFpnqawvXxj")) != -1) {
     switch (opt) {
       case 'f':
         input_file = argv[optind];
@@ -94,6 +96,9 @@ void parse_args(int argc, char** argv)
       case 'b':
         use_8_bit = true;
         break;
+      case 'e':
+        check_bit_per_byte = true;
+        break;
       case 'M':
         mcs[1] = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
@@ -186,6 +191,60 @@ static int check_softbits(srslte_pdsch_t*     pdsch_enb,
   return ret;
 }
 
+static int check_encoder_bit_per_byte(srslte_pdsch_t*     pdsch_enb,
+                                      srslte_dl_sf_cfg_t* sf,
+                                      srslte_pdsch_cfg_t* pdsch_cfg,
+                                      uint8_t*            data[SRSLTE_MAX_CODEWORDS],
+                                      cf_t*               symbols[SRSLTE_MAX_PORTS])
+{
+  int            ret = SRSLTE_ERROR;
+  struct timeval t[3];
+  cf_t*          ref_symbols[SRSLTE_MAX_PORTS] = {};
+
+  if (srslte_sch_set_tx_bit_per_byte(&pdsch_enb->dl_sch, true)) {
+    ERROR("Error enabling the bit per byte encoder\n");
+    return SRSLTE_ERROR;
+  }
+
+  for (uint32_t i = 0; i < cell.nof_ports; i++) {
+    ref_symbols[i] = calloc(SRSLTE_NOF_RE(cell), sizeof(cf_t));
+    if (!ref_symbols[i]) {
+      perror("calloc");
+      goto clean;
+    }
+  }
+
+  gettimeofday(&t[1], NULL);
+  for (uint32_t k = 0; k < M; k++) {
+    if (srslte_pdsch_encode(pdsch_enb, sf, pdsch_cfg, data, ref_symbols)) {
+      ERROR("Error encoding PDSCH\n");
+      goto clean;
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("ENCODED bit per byte in %.2f (Processing bitrate=%.2f Mbps)\n",
+         (float)t[0].tv_usec / M,
+         (float)(pdsch_cfg->grant.tb[0].tbs + pdsch_cfg->grant.tb[1].tbs) * M / t[0].tv_usec);
+
+  for (uint32_t i = 0; i < cell.nof_ports; i++) {
+    if (memcmp(symbols[i], ref_symbols[i], SRSLTE_NOF_RE(cell) * sizeof(cf_t)) != 0) {
+      ERROR("The packed encoder output does not match the bit per byte encoder in port %d\n", i);
+      goto clean;
+    }
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean:
+  srslte_sch_set_tx_bit_per_byte(&pdsch_enb->dl_sch, false);
+  for (uint32_t i = 0; i < SRSLTE_MAX_PORTS; i++) {
+    if (ref_symbols[i]) {
+      free(ref_symbols[i]);
+    }
+  }
+  return ret;
+}
+
 int main(int argc, char** argv)
 {
   int                     ret  = -1;
@@ -442,6 +501,12 @@ int main(int argc, char** argv)
            (float)(pdsch_cfg.grant.tb[0].tbs + pdsch_cfg.grant.tb[1].tbs) / 1000.0f,
            (float)(pdsch_cfg.grant.tb[0].tbs + pdsch_cfg.grant.tb[1].tbs) * M / t[0].tv_usec);
 
+    if (check_bit_per_byte) {
+      if (check_encoder_bit_per_byte(&pdsch_tx, &dl_sf, &pdsch_cfg, data_tx, tx_slot_symbols)) {
+        goto quit;
+      }
+    }
+
     /* combine outputs */
     for (uint32_t j = 0; j < nof_rx_antennas; j++) {
       for (uint32_t k = 0; k < SRSLTE_NOF_RE(cell); k++) {
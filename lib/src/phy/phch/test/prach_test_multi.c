@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -38,6 +39,7 @@ uint32_t root_seq_idx     = 0;
 uint32_t zero_corr_zone   = 1;
 uint32_t n_seqs           = 64;
 uint32_t num_ra_preambles = 0; // use default
+uint32_t nof_repetitions  = 1;
 
 void usage(char* prog)
 {
@@ -47,12 +49,13 @@ void usage(char* prog)
   printf("\t-r Root sequence index [Default 0]\n");
   printf("\t-z Zero correlation zone config [Default 1]\n");
   printf("\t-n Number of sequences used for each test [Default 64]\n");
+  printf("\t-R Number of detection repetitions for benchmarking [Default %d]\n", nof_repetitions);
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "Nfrzn")) != -1) {
+  while ((opt = getopt(argc, argv, "NfrznR")) != -1) {
     switch (opt) {
       case 'N':
         nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -69,6 +72,9 @@ void parse_args(int argc, char** argv)
       case 'n':
         n_seqs = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'R':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -128,7 +134,16 @@ int main(int argc, char** argv)
   if (preamble_format == 2 || preamble_format == 3) {
     prach_len /= 2;
   }
-  srslte_prach_detect(&prach, 0, &preamble_sum[prach.N_cp], prach_len, indices, &n_indices);
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_repetitions; r++) {
+    srslte_prach_detect(&prach, 0, &preamble_sum[prach.N_cp], prach_len, indices, &n_indices);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("N_roots=%d; texec=%.1f us\n",
+         prach.num_ra_preambles,
+         (t[0].tv_sec * 1e6 + t[0].tv_usec) / (double)nof_repetitions);
 
   if (n_indices != n_seqs) {
     return -1;
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "srslte/phy/resampling/channelizer.h"
+#include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Blackman windowed sinc, normalised to unity gain at DC */
+static void prototype_filter(double* h, uint32_t nof_taps, double cutoff)
+{
+  double sum = 0.0;
+  for (uint32_t n = 0; n < nof_taps; n++) {
+    double t = (double)n - (double)(nof_taps - 1) / 2.0;
+    double x = 2.0 * cutoff * t;
+    double w = 0.42 - 0.5 * cos(2.0 * M_PI * n / (nof_taps - 1)) + 0.08 * cos(4.0 * M_PI * n / (nof_taps - 1));
+    h[n]     = w * ((t == 0.0) ? 1.0 : sin(M_PI * x) / (M_PI * x));
+    sum += h[n];
+  }
+  for (uint32_t n = 0; n < nof_taps; n++) {
+    h[n] /= sum;
+  }
+}
+
+int srslte_channelizer_init(srslte_channelizer_t* q,
+                            double                srate_hz,
+                            double                channel_srate_hz,
+                            double                cutoff_hz,
+                            const double*         offset_hz,
+                            uint32_t              nof_channels,
+                            uint32_t              max_input_len)
+{
+  int     ret = SRSLTE_ERROR_INVALID_INPUTS;
+  double* h   = NULL;
+
+  if (q != NULL && offset_hz != NULL && nof_channels > 0 && channel_srate_hz > 0 && srate_hz >= channel_srate_hz) {
+    ret = SRSLTE_ERROR;
+    bzero(q, sizeof(srslte_channelizer_t));
+
+    double ratio = srate_hz / channel_srate_hz;
+    if (fabs(ratio - round(ratio)) > 1e-6) {
+      ERROR("The sampling rate %.2f MHz is not a multiple of the channel rate %.2f MHz\n",
+            srate_hz / 1e6,
+            channel_srate_hz / 1e6);
+      return ret;
+    }
+
+    q->decimation    = (uint32_t)round(ratio);
+    q->nof_taps      = SRSLTE_CHANNELIZER_TAPS_PER_PHASE * q->decimation + 1;
+    q->nof_channels  = nof_channels;
+    q->max_input_len = max_input_len;
+
+    q->taps     = calloc(nof_channels, sizeof(cf_t*));
+    q->rotation = srslte_vec_cf_malloc(nof_channels);
+    q->phasor   = srslte_vec_cf_malloc(nof_channels);
+    q->buffer   = srslte_vec_cf_malloc(q->nof_taps - 1 + max_input_len);
+    h           = malloc(sizeof(double) * q->nof_taps);
+    if (!q->taps || !q->rotation || !q->phasor || !q->buffer || !h) {
+      perror("malloc");
+      goto clean_exit;
+    }
+
+    prototype_filter(h, q->nof_taps, cutoff_hz / srate_hz);
+
+    // The band-pass filter of each channel is the prototype modulated to the channel offset
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      double w    = 2.0 * M_PI * offset_hz[ch] / srate_hz;
+      q->taps[ch] = srslte_vec_cf_malloc(q->nof_taps);
+      if (!q->taps[ch]) {
+        perror("malloc");
+        goto clean_exit;
+      }
+      for (uint32_t i = 0; i < q->nof_taps; i++) {
+        uint32_t n     = q->nof_taps - 1 - i;
+        q->taps[ch][i] = (float)h[n] * cexpf(I * (float)fmod(w * n, 2.0 * M_PI));
+      }
+      q->rotation[ch] = cexpf(-I * (float)fmod(w * q->decimation, 2.0 * M_PI));
+    }
+
+    srslte_channelizer_reset(q);
+    ret = SRSLTE_SUCCESS;
+  }
+
+clean_exit:
+  if (h) {
+    free(h);
+  }
+  if (ret == SRSLTE_ERROR) {
+    srslte_channelizer_free(q);
+  }
+  return ret;
+}
+
+void srslte_channelizer_free(srslte_channelizer_t* q)
+{
+  if (q) {
+    if (q->taps) {
+      for (uint32_t ch = 0; ch < q->nof_channels; ch++) {
+        if (q->taps[ch]) {
+          free(q->taps[ch]);
+        }
+      }
+      free(q->taps);
+    }
+    if (q->rotation) {
+      free(q->rotation);
+    }
+    if (q->phasor) {
+      free(q->phasor);
+    }
+    if (q->buffer) {
+      free(q->buffer);
+    }
+    bzero(q, sizeof(srslte_channelizer_t));
+  }
+}
+
+void srslte_channelizer_reset(srslte_channelizer_t* q)
+{
+  srslte_vec_cf_zero(q->buffer, q->nof_taps - 1);
+  for (uint32_t ch = 0; ch < q->nof_channels; ch++) {
+    q->phasor[ch] = 1.0f;
+  }
+  q->phase = 0;
+}
+
+int srslte_channelizer_execute(srslte_channelizer_t* q, const cf_t* input, uint32_t nof_samples, cf_t** output)
+{
+  if (q == NULL || input == NULL || output == NULL || nof_samples > q->max_input_len) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t history = q->nof_taps - 1;
+  srslte_vec_cf_copy(&q->buffer[history], input, nof_samples);
+
+  // Number of filter windows that fit in the history and the new samples
+  uint32_t nof_outputs = 0;
+  if (q->phase + q->nof_taps <= history + nof_samples) {
+    nof_outputs = (history + nof_samples - q->phase - q->nof_taps) / q->decimation + 1;
+  }
+
+  for (uint32_t ch = 0; ch < q->nof_channels; ch++) {
+    const cf_t* window = &q->buffer[q->phase];
+    cf_t        phasor = q->phasor[ch];
+    for (uint32_t m = 0; m < nof_outputs; m++) {
+      output[ch][m] = srslte_vec_dot_prod_ccc(window, q->taps[ch], q->nof_taps) * phasor;
+      phasor *= q->rotation[ch];
+      window += q->decimation;
+    }
+    // Avoid the drift of the phasor amplitude
+    q->phasor[ch] = phasor / cabsf(phasor);
+  }
+
+  q->phase = q->phase + nof_outputs * q->decimation - nof_samples;
+  memmove(q->buffer, &q->buffer[nof_samples], sizeof(cf_t) * history);
+
+  return (int)nof_outputs;
+}
@@ -24,6 +24,15 @@
 #include "srslte/phy/utils/vector.h"
 #include <math.h>
 #include <string.h>
+#include <strings.h>
+
+#ifdef LV_HAVE_SSE
+#include <immintrin.h>
+#endif /* LV_HAVE_SSE */
+
+#ifdef HAVE_NEON
+#include <arm_neon.h>
+#endif /* HAVE_NEON */
 
 // clang-format off
 float srslte_resample_arb_polyfilt[SRSLTE_RESAMPLE_ARB_N][SRSLTE_RESAMPLE_ARB_M] __attribute__((aligned(256))) =
@@ -101,81 +110,207 @@ float srslte_resample_arb_polyfilt[SRSLTE_RESAMPLE_ARB_N][SRSLTE_RESAMPLE_ARB_M]
 {0.000722236729272,  -0.032053439082436,   0.171322660416961,   0.704261032406613,   0.188481383863832,  -0.033395686652146,   0.000657994314549 ,  0.000002955485215}};
 
 // clang-format on
-static inline cf_t srslte_resample_arb_dot_prod(cf_t* x, float* y, int len)
+
+#define TAPS_LEN (2 * SRSLTE_RESAMPLE_ARB_M)
+
+// Filters the M samples at x with taps that repeat every coefficient for the real and imaginary parts
+static inline cf_t resample_arb_fir(const cf_t* x, const float* taps)
 {
-  cf_t res1 = srslte_vec_dot_prod_cfc(x, y, len);
-  return res1;
+#ifdef LV_HAVE_AVX
+  __m256 acc = _mm256_mul_ps(_mm256_loadu_ps((float*)x), _mm256_loadu_ps(taps));
+#ifdef LV_HAVE_FMA
+  acc = _mm256_fmadd_ps(_mm256_loadu_ps((float*)&x[4]), _mm256_loadu_ps(&taps[8]), acc);
+#else  /* LV_HAVE_FMA */
+  acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps((float*)&x[4]), _mm256_loadu_ps(&taps[8])));
+#endif /* LV_HAVE_FMA */
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  sum        = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  cf_t ret;
+  _mm_storel_pi((__m64*)&ret, sum);
+  return ret;
+#elif defined(LV_HAVE_SSE)
+  __m128 acc = _mm_mul_ps(_mm_loadu_ps((float*)x), _mm_loadu_ps(taps));
+  for (int i = 1; i < SRSLTE_RESAMPLE_ARB_M / 2; i++) {
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps((float*)&x[2 * i]), _mm_loadu_ps(&taps[4 * i])));
+  }
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  cf_t ret;
+  _mm_storel_pi((__m64*)&ret, acc);
+  return ret;
+#elif defined(HAVE_NEON)
+  float32x4_t acc = vmulq_f32(vld1q_f32((float*)x), vld1q_f32(taps));
+  for (int i = 1; i < SRSLTE_RESAMPLE_ARB_M / 2; i++) {
+    acc = vmlaq_f32(acc, vld1q_f32((float*)&x[2 * i]), vld1q_f32(&taps[4 * i]));
+  }
+  float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+  cf_t        ret;
+  vst1_f32((float*)&ret, sum);
+  return ret;
+#else
+  cf_t ret = 0;
+  for (int i = 0; i < SRSLTE_RESAMPLE_ARB_M; i++) {
+    ret += x[i] * taps[2 * i];
+  }
+  return ret;
+#endif
 }
 
-// Right-shift our window of samples
-void srslte_resample_arb_push(srslte_resample_arb_t* q, cf_t x)
+static void resample_arb_set_taps(float* taps, uint32_t row, float frac)
 {
+  const float* h0 = srslte_resample_arb_polyfilt[row];
+  const float* h1 = srslte_resample_arb_polyfilt[(row + 1) % SRSLTE_RESAMPLE_ARB_N];
+  for (int i = 0; i < SRSLTE_RESAMPLE_ARB_M; i++) {
+    float h          = h0[i] + (h1[i] - h0[i]) * frac;
+    taps[2 * i]     = h;
+    taps[2 * i + 1] = h;
+  }
+}
 
-  memmove(&q->reg[1], &q->reg[0], (SRSLTE_RESAMPLE_ARB_M - 1) * sizeof(cf_t));
-  q->reg[0] = x;
+// Finds the shortest L/D that matches the rate within the float precision
+static uint32_t resample_arb_find_period(float rate, uint32_t* den)
+{
+  for (uint32_t l = 1; l <= SRSLTE_RESAMPLE_ARB_MAX_PERIOD; l++) {
+    double d = round(l / (double)rate);
+    if (d >= 1 && fabs(l / d - rate) <= 1e-7 * rate) {
+      *den = (uint32_t)d;
+      return l;
+    }
+  }
+  return 0;
 }
 
 // Initialize our struct
-void srslte_resample_arb_init(srslte_resample_arb_t* q, float rate, bool interpolate)
+int srslte_resample_arb_init(srslte_resample_arb_t* q, float rate, bool interpolate)
 {
+  if (q == NULL || rate <= 0) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  bzero(q, sizeof(srslte_resample_arb_t));
 
-  memset(q->reg, 0, SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
-  q->acc         = 0.0;
   q->rate        = rate;
   q->interpolate = interpolate;
-  q->step        = (1 / rate) * SRSLTE_RESAMPLE_ARB_N;
+  q->step        = (1 / (double)rate) * SRSLTE_RESAMPLE_ARB_N;
+
+  uint32_t den = 0;
+  q->period    = resample_arb_find_period(rate, &den);
+
+  if (q->period) {
+    // Output n falls n*D/L input samples after the first one, store its filter and the input advance to output n+1
+    q->taps    = srslte_vec_f_malloc(q->period * TAPS_LEN);
+    q->advance = srslte_vec_u32_malloc(q->period);
+    if (!q->taps || !q->advance) {
+      srslte_resample_arb_free(q);
+      return SRSLTE_ERROR;
+    }
+    for (uint32_t n = 0; n < q->period; n++) {
+      uint32_t rem  = (uint32_t)(((uint64_t)n * den) % q->period);
+      uint32_t pos  = rem * SRSLTE_RESAMPLE_ARB_N;
+      uint32_t row  = pos / q->period;
+      float    frac = interpolate ? (float)(pos - row * q->period) / q->period : 0;
+      resample_arb_set_taps(&q->taps[n * TAPS_LEN], row, frac);
+      q->advance[n] = (uint32_t)(((uint64_t)(n + 1) * den) / q->period - ((uint64_t)n * den) / q->period);
+    }
+  } else {
+    q->taps = srslte_vec_f_malloc(SRSLTE_RESAMPLE_ARB_N * TAPS_LEN);
+    if (!q->taps) {
+      return SRSLTE_ERROR;
+    }
+    for (uint32_t row = 0; row < SRSLTE_RESAMPLE_ARB_N; row++) {
+      resample_arb_set_taps(&q->taps[row * TAPS_LEN], row, 0);
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_resample_arb_free(srslte_resample_arb_t* q)
+{
+  if (q->taps) {
+    free(q->taps);
+  }
+  if (q->advance) {
+    free(q->advance);
+  }
+  bzero(q, sizeof(srslte_resample_arb_t));
+}
+
+void srslte_resample_arb_reset(srslte_resample_arb_t* q)
+{
+  srslte_vec_cf_zero(q->reg, SRSLTE_RESAMPLE_ARB_M);
+  q->acc    = 0;
+  q->offset = 0;
+  q->phase  = 0;
 }
 
 // Resample a block of input data
 int srslte_resample_arb_compute(srslte_resample_arb_t* q, cf_t* input, cf_t* output, int n_in)
 {
-  int   cnt   = 0;
-  int   n_out = 0;
-  int   idx   = 0;
-  cf_t  res1, res2;
-  cf_t* filter_input;
-  float frac = 0;
-  memset(q->reg, 0, SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
-
-  while (cnt < n_in) {
-
-    if (cnt < SRSLTE_RESAMPLE_ARB_M) {
-      memcpy(&q->reg[SRSLTE_RESAMPLE_ARB_M - cnt], input, (cnt) * sizeof(cf_t));
-      filter_input = q->reg;
-    } else {
-      filter_input = &input[cnt - SRSLTE_RESAMPLE_ARB_M];
-    }
+  // The windows of the first M outputs start in the previous block
+  cf_t     head[2 * SRSLTE_RESAMPLE_ARB_M];
+  uint32_t nof_head = SRSLTE_MIN(n_in, SRSLTE_RESAMPLE_ARB_M);
+  memcpy(head, q->reg, SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
+  memcpy(&head[SRSLTE_RESAMPLE_ARB_M], input, nof_head * sizeof(cf_t));
 
-    res1 = srslte_resample_arb_dot_prod(filter_input, srslte_resample_arb_polyfilt[idx], SRSLTE_RESAMPLE_ARB_M);
-    if (q->interpolate) {
-      res2 = srslte_resample_arb_dot_prod(
-          filter_input, srslte_resample_arb_polyfilt[(idx + 1) % SRSLTE_RESAMPLE_ARB_N], SRSLTE_RESAMPLE_ARB_M);
-    }
+  int cnt   = q->offset;
+  int n_out = 0;
 
-    if (idx == SRSLTE_RESAMPLE_ARB_N) {
-      *output = res1;
-    } else {
-      *output = (q->interpolate) ? (res1 + (res2 - res1) * frac) : res1;
+  if (q->period) {
+    uint32_t phase = q->phase;
+    while (cnt < n_in) {
+      const cf_t* x  = (cnt < SRSLTE_RESAMPLE_ARB_M) ? &head[cnt] : &input[cnt - SRSLTE_RESAMPLE_ARB_M];
+      output[n_out++] = resample_arb_fir(x, &q->taps[phase * TAPS_LEN]);
+      cnt += q->advance[phase];
+      phase = (phase + 1 == q->period) ? 0 : phase + 1;
     }
+    q->phase = phase;
+  } else {
+    while (cnt < n_in) {
+      const cf_t* x   = (cnt < SRSLTE_RESAMPLE_ARB_M) ? &head[cnt] : &input[cnt - SRSLTE_RESAMPLE_ARB_M];
+      uint32_t    idx = (uint32_t)q->acc;
+      cf_t        res = resample_arb_fir(x, &q->taps[idx * TAPS_LEN]);
+      if (q->interpolate) {
+        cf_t res2 = resample_arb_fir(x, &q->taps[((idx + 1) % SRSLTE_RESAMPLE_ARB_N) * TAPS_LEN]);
+        res += (res2 - res) * (float)(q->acc - idx);
+      }
+      output[n_out++] = res;
 
-    output++;
-    n_out++;
-    q->acc += q->step;
-    idx = (int)(q->acc);
-
-    while (idx >= SRSLTE_RESAMPLE_ARB_N) {
-      q->acc -= SRSLTE_RESAMPLE_ARB_N;
-      idx -= SRSLTE_RESAMPLE_ARB_N;
-      if (cnt < n_in) {
+      q->acc += q->step;
+      while (q->acc >= SRSLTE_RESAMPLE_ARB_N) {
+        q->acc -= SRSLTE_RESAMPLE_ARB_N;
         cnt++;
       }
     }
+  }
+  q->offset = cnt - n_in;
 
-    if (q->interpolate) {
-      frac = q->acc - idx;
-      if (frac < 0)
-        frac = frac * (-1);
-    }
+  // Keep the last M samples of the stream
+  if (n_in >= SRSLTE_RESAMPLE_ARB_M) {
+    memcpy(q->reg, &input[n_in - SRSLTE_RESAMPLE_ARB_M], SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
+  } else {
+    memcpy(q->reg, &head[n_in], SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
   }
+
   return n_out;
 }
+
+uint32_t srslte_resample_arb_nof_input(const srslte_resample_arb_t* q, uint32_t nof_output)
+{
+  uint32_t cnt = q->offset;
+  if (q->period) {
+    uint32_t phase = q->phase;
+    for (uint32_t n = 0; n < nof_output; n++) {
+      cnt += q->advance[phase];
+      phase = (phase + 1 == q->period) ? 0 : phase + 1;
+    }
+  } else {
+    double acc = q->acc;
+    for (uint32_t n = 0; n < nof_output; n++) {
+      acc += q->step;
+      while (acc >= SRSLTE_RESAMPLE_ARB_N) {
+        acc -= SRSLTE_RESAMPLE_ARB_N;
+        cnt++;
+      }
+    }
+  }
+  return cnt;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "srslte/common/test_common.h"
+#include "srslte/phy/resampling/channelizer.h"
+#include "srslte/srslte.h"
+
+#define SRATE_HZ 15.36e6
+#define CHANNEL_SRATE_HZ 1.92e6
+#define CUTOFF_HZ 750e3
+#define NOF_SAMPLES 153600
+#define NOF_CHANNELS 3
+
+static const double offset_hz[NOF_CHANNELS] = {-3.0e6, 0.0, 2.5e6};
+
+int main(int argc, char** argv)
+{
+  srslte_channelizer_t ch_all   = {};
+  srslte_channelizer_t ch_parts = {};
+  cf_t*                input    = srslte_vec_cf_malloc(NOF_SAMPLES);
+  cf_t*                out_all[NOF_CHANNELS];
+  cf_t*                out_parts[NOF_CHANNELS];
+  for (uint32_t ch = 0; ch < NOF_CHANNELS; ch++) {
+    out_all[ch]   = srslte_vec_cf_malloc(NOF_SAMPLES);
+    out_parts[ch] = srslte_vec_cf_malloc(NOF_SAMPLES);
+  }
+
+  // Tone 200 kHz above the last channel center
+  double tone_hz = offset_hz[NOF_CHANNELS - 1] + 200e3;
+  for (uint32_t i = 0; i < NOF_SAMPLES; i++) {
+    input[i] = cexpf(I * (float)fmod(2.0 * M_PI * tone_hz * i / SRATE_HZ, 2.0 * M_PI));
+  }
+
+  TESTASSERT(srslte_channelizer_init(&ch_all, SRATE_HZ, CHANNEL_SRATE_HZ, CUTOFF_HZ, offset_hz, NOF_CHANNELS, NOF_SAMPLES) ==
+             SRSLTE_SUCCESS);
+  TESTASSERT(srslte_channelizer_init(&ch_parts, SRATE_HZ, CHANNEL_SRATE_HZ, CUTOFF_HZ, offset_hz, NOF_CHANNELS, 1001) ==
+             SRSLTE_SUCCESS);
+  TESTASSERT(ch_all.decimation == 8);
+
+  // Rates that are not a multiple of the channel rate are rejected
+  srslte_channelizer_t ch_bad = {};
+  TESTASSERT(srslte_channelizer_init(&ch_bad, 10e6, CHANNEL_SRATE_HZ, CUTOFF_HZ, offset_hz, NOF_CHANNELS, 100) !=
+             SRSLTE_SUCCESS);
+
+  int nof_out = srslte_channelizer_execute(&ch_all, input, NOF_SAMPLES, out_all);
+  TESTASSERT(nof_out == NOF_SAMPLES / 8);
+
+  // Processing the same stream in blocks that are not multiple of the decimation gives the same samples
+  int nof_parts = 0;
+  for (uint32_t i = 0; i < NOF_SAMPLES; i += 1001) {
+    cf_t* out[NOF_CHANNELS];
+    for (uint32_t ch = 0; ch < NOF_CHANNELS; ch++) {
+      out[ch] = &out_parts[ch][nof_parts];
+    }
+    int n = srslte_channelizer_execute(&ch_parts, &input[i], SRSLTE_MIN(1001, NOF_SAMPLES - i), out);
+    TESTASSERT(n >= 0);
+    nof_parts += n;
+  }
+  TESTASSERT(nof_parts == nof_out);
+  for (uint32_t ch = 0; ch < NOF_CHANNELS; ch++) {
+    for (int i = 0; i < nof_out; i++) {
+      TESTASSERT(cabsf(out_all[ch][i] - out_parts[ch][i]) < 1e-3f);
+    }
+  }
+
+  // The tone goes through its channel with unity gain and at 200 kHz, the other channels reject it
+  float power[NOF_CHANNELS];
+  for (uint32_t ch = 0; ch < NOF_CHANNELS; ch++) {
+    power[ch] = srslte_vec_avg_power_cf(out_all[ch], (uint32_t)nof_out);
+    printf("Channel %d (%+.1f MHz): tone power %+.1f dB\n", ch, offset_hz[ch] / 1e6, srslte_convert_power_to_dB(power[ch]));
+  }
+  TESTASSERT(fabsf(srslte_convert_power_to_dB(power[NOF_CHANNELS - 1])) < 0.5f);
+  TESTASSERT(srslte_convert_power_to_dB(power[0]) < -60.0f);
+  TESTASSERT(srslte_convert_power_to_dB(power[1]) < -60.0f);
+
+  cf_t  rot     = out_all[NOF_CHANNELS - 1][nof_out - 1] * conjf(out_all[NOF_CHANNELS - 1][nof_out - 2]);
+  float freq_hz = cargf(rot) / (2.0f * (float)M_PI) * (float)CHANNEL_SRATE_HZ;
+  printf("Baseband tone frequency %.1f kHz\n", freq_hz / 1e3);
+  TESTASSERT(fabsf(freq_hz - 200e3f) < 100.0f);
+
+  srslte_channelizer_free(&ch_all);
+  srslte_channelizer_free(&ch_parts);
+  free(input);
+  for (uint32_t ch = 0; ch < NOF_CHANNELS; ch++) {
+    free(out_all[ch]);
+    free(out_parts[ch]);
+  }
+
+  printf("Ok\n");
+  return SRSLTE_SUCCESS;
+}
@@ -30,30 +30,50 @@
 #include "srslte/srslte.h"
 
 #define ITERATIONS 10000
-int main(int argc, char** argv)
-{
-  int   N    = 9000;
-  float rate = 24.0 / 25.0;
-  cf_t* in   = srslte_vec_cf_malloc(N);
-  cf_t* out  = srslte_vec_cf_malloc(N);
-
-  for (int i = 0; i < N; i++)
-    in[i] = sin(i * 2 * M_PI / 100);
 
+static void bench(float rate, bool interpolate, cf_t* in, cf_t* out, int N)
+{
   srslte_resample_arb_t r;
-  srslte_resample_arb_init(&r, rate, 0);
+  if (srslte_resample_arb_init(&r, rate, interpolate)) {
+    exit(-1);
+  }
 
+  int     n_out = 0;
   clock_t start = clock(), diff;
   for (int xx = 0; xx < ITERATIONS; xx++) {
-    srslte_resample_arb_compute(&r, in, out, N);
+    n_out = srslte_resample_arb_compute(&r, in, out, N);
   }
   diff = clock() - start;
 
-  diff       = diff / ITERATIONS;
-  int   msec = diff * 1000 / CLOCKS_PER_SEC;
-  float thru = (CLOCKS_PER_SEC / (float)diff) * (N / 1e6);
-  printf("Time taken %d seconds %d milliseconds\n", msec / 1000, msec % 1000);
-  printf("Rate = %f MS/sec\n", thru);
+  float secs = (float)diff / CLOCKS_PER_SEC;
+  printf("Rate %f%s (%s): %d -> %d samples, %.1f us, in %.1f Msps, out %.1f Msps\n",
+         rate,
+         interpolate ? " interpolated" : "",
+         r.period ? "rational" : "arbitrary",
+         N,
+         n_out,
+         secs * 1e6 / ITERATIONS,
+         (float)N * ITERATIONS / secs / 1e6,
+         (float)n_out * ITERATIONS / secs / 1e6);
+
+  srslte_resample_arb_free(&r);
+}
+
+int main(int argc, char** argv)
+{
+  int   N   = 9000;
+  cf_t* in  = srslte_vec_cf_malloc(N);
+  cf_t* out = srslte_vec_cf_malloc(2 * N);
+
+  for (int i = 0; i < N; i++)
+    in[i] = sin(i * 2 * M_PI / 100);
+
+  // 3.84 Msps on a 4 Msps radio, 23.04 Msps on 30.72 Msps, and non-rational rates
+  float rates[] = {24.0 / 25.0, 3.0 / 4.0, 25.0 / 24.0, 0.8123, 1.2345};
+  for (int i = 0; i < sizeof(rates) / sizeof(float); i++) {
+    bench(rates[i], false, in, out, N);
+    bench(rates[i], true, in, out, N);
+  }
 
   free(in);
   free(out);
@@ -22,6 +22,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 #include <time.h>
 #include <unistd.h>
@@ -55,8 +56,11 @@ int main(int argc, char** argv)
 
     // Resample
     srslte_resample_arb_t r;
-    srslte_resample_arb_init(&r, rate, 0);
+    if (srslte_resample_arb_init(&r, rate, 0)) {
+      exit(-1);
+    }
     int n_out = srslte_resample_arb_compute(&r, in, out, N);
+    srslte_resample_arb_free(&r);
 
     // Check interp values
     for (int i = delay + 1; i < n_out; i++) {
@@ -76,6 +80,65 @@ int main(int argc, char** argv)
     free(out);
   }
 
+  // Streams cut into blocks must match the whole stream, and the output count must be exact for the decimators
+  float rates[] = {24.0f / 25.0f, 0.75f, 0.5f, 4.0f / 3.0f, 0.8123f, 1.2345f};
+  for (int i = 0; i < sizeof(rates) / sizeof(float); i++) {
+    for (int interp = 0; interp < 2; interp++) {
+      int   len = 10000;
+      cf_t* in  = srslte_vec_cf_malloc(len);
+      cf_t* out = srslte_vec_cf_malloc(2 * len);
+      cf_t* ref = srslte_vec_cf_malloc(2 * len);
+      if (!in || !out || !ref) {
+        perror("malloc");
+        exit(-1);
+      }
+      for (int j = 0; j < len; j++) {
+        in[j] = cexpf(I * 2 * M_PI * j / 37.0f);
+      }
+
+      srslte_resample_arb_t r;
+      if (srslte_resample_arb_init(&r, rates[i], interp)) {
+        exit(-1);
+      }
+      int n_ref = srslte_resample_arb_compute(&r, in, ref, len);
+      srslte_resample_arb_reset(&r);
+
+      int n_in  = 0;
+      int n_out = 0;
+      int block = 1;
+      while (n_in < len) {
+        int n = SRSLTE_MIN(block, len - n_in);
+        n_out += srslte_resample_arb_compute(&r, &in[n_in], &out[n_out], n);
+        n_in += n;
+        block = (block * 7 + 3) % 1500;
+      }
+      if (n_out != n_ref || memcmp(out, ref, n_out * sizeof(cf_t))) {
+        printf("Block processing failed for rate %f\n", rates[i]);
+        exit(-1);
+      }
+
+      if (rates[i] <= 1) {
+        srslte_resample_arb_reset(&r);
+        n_in = 0;
+        for (int j = 0; j < 10; j++) {
+          uint32_t nof_out = 100 + 37 * j;
+          uint32_t nof_in  = srslte_resample_arb_nof_input(&r, nof_out);
+          if (n_in + nof_in > len || srslte_resample_arb_compute(&r, &in[n_in], out, nof_in) != nof_out) {
+            printf("Wrong number of input samples for rate %f\n", rates[i]);
+            exit(-1);
+          }
+          n_in += nof_in;
+        }
+      }
+
+      printf("Rate %f%s: %d outputs for %d inputs\n", rates[i], interp ? " (interpolated)" : "", n_ref, len);
+      srslte_resample_arb_free(&r);
+      free(in);
+      free(out);
+      free(ref);
+    }
+  }
+
   printf("Ok\n");
   exit(0);
 }
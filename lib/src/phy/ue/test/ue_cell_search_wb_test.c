@@ -0,0 +1,201 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srslte/common/test_common.h"
+#include "srslte/srslte.h"
+
+#define SRATE_HZ 15.36e6
+#define SYMBOL_SZ 1024
+#define SF_LEN SRSLTE_SF_LEN(SYMBOL_SZ)
+#define NOF_SF 40
+#define NOF_CELLS 3
+#define NOF_CHANNELS 5
+#define MIN_PSR 2.0f
+
+typedef struct {
+  uint32_t id;
+  double   offset_hz;
+  uint32_t delay;
+} test_cell_t;
+
+// Cells on the 100 kHz raster with different timings, the last two channels are empty
+static const test_cell_t cells[NOF_CELLS] = {{1, -5.0e6, 1234}, {152, 1.2e6, 5000}, {401, 4.3e6, 9000}};
+static const double      offset_hz[NOF_CHANNELS] = {-5.0e6, 1.2e6, 4.3e6, -2.0e6, 6.5e6};
+
+static uint32_t nof_threads = 2;
+static float    snr_db      = 0.0f;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nsv]\n", prog);
+  printf("\t-n number of threads [Default %d]\n", nof_threads);
+  printf("\t-s wideband SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-v [set srslte_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nsv")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'v':
+        srslte_verbose++;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/* Adds the PSS and SSS of a 6 PRB cell shifted by offset_hz and delayed by delay samples, scaled to unit power */
+static int add_cell(cf_t* capture, const test_cell_t* c)
+{
+  int               ret  = SRSLTE_ERROR;
+  srslte_ofdm_t     ifft = {};
+  srslte_ofdm_cfg_t cfg  = {};
+  cf_t              pss_signal[SRSLTE_PSS_LEN];
+  float             sss_signal0[SRSLTE_SSS_LEN];
+  float             sss_signal5[SRSLTE_SSS_LEN];
+  cf_t*             grid   = srslte_vec_cf_malloc(SRSLTE_SF_LEN_RE(SRSLTE_CS_NOF_PRB, SRSLTE_CP_NORM));
+  cf_t*             sf_buf = srslte_vec_cf_malloc(SF_LEN);
+  cf_t*             signal = srslte_vec_cf_malloc(SF_LEN * NOF_SF);
+
+  if (!grid || !sf_buf || !signal) {
+    goto clean_exit;
+  }
+
+  cfg.nof_prb      = SRSLTE_CS_NOF_PRB;
+  cfg.cp           = SRSLTE_CP_NORM;
+  cfg.symbol_sz    = SYMBOL_SZ;
+  cfg.in_buffer    = grid;
+  cfg.out_buffer   = sf_buf;
+  if (srslte_ofdm_tx_init_cfg(&ifft, &cfg)) {
+    goto clean_exit;
+  }
+
+  srslte_pss_generate(pss_signal, c->id % 3);
+  srslte_sss_generate(sss_signal0, sss_signal5, c->id);
+  for (uint32_t sf = 0; sf < NOF_SF; sf++) {
+    srslte_vec_cf_zero(grid, SRSLTE_SF_LEN_RE(SRSLTE_CS_NOF_PRB, SRSLTE_CP_NORM));
+    if (sf % 5 == 0) {
+      srslte_pss_put_slot(pss_signal, grid, SRSLTE_CS_NOF_PRB, SRSLTE_CP_NORM);
+      srslte_sss_put_slot((sf % 10) ? sss_signal5 : sss_signal0, grid, SRSLTE_CS_NOF_PRB, SRSLTE_CP_NORM);
+    }
+    srslte_ofdm_tx_sf(&ifft);
+    srslte_vec_cf_copy(&signal[sf * SF_LEN], sf_buf, SF_LEN);
+  }
+  srslte_ofdm_tx_free(&ifft);
+
+  // Continuous frequency shift over the whole capture, as the radio would see the carrier
+  float scale = 1.0f / sqrtf(srslte_vec_avg_power_cf(signal, SF_LEN * NOF_SF));
+  for (uint32_t i = 0; i < SF_LEN * NOF_SF; i++) {
+    double phase = fmod(2.0 * M_PI * c->offset_hz * i / SRATE_HZ, 2.0 * M_PI);
+    capture[(i + c->delay) % (SF_LEN * NOF_SF)] += signal[i] * scale * cexpf(I * (float)phase);
+  }
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  if (grid) {
+    free(grid);
+  }
+  if (sf_buf) {
+    free(sf_buf);
+  }
+  if (signal) {
+    free(signal);
+  }
+  return ret;
+}
+
+int main(int argc, char** argv)
+{
+  srslte_ue_cellsearch_wb_t        cs = {};
+  srslte_ue_cellsearch_wb_result_t found[3 * NOF_CHANNELS];
+  struct timeval                   t[3];
+  uint32_t                         nof_samples = SF_LEN * NOF_SF;
+
+  parse_args(argc, argv);
+
+  cf_t* capture = srslte_vec_cf_malloc(nof_samples);
+  TESTASSERT(capture != NULL);
+  srslte_vec_cf_zero(capture, nof_samples);
+  for (uint32_t i = 0; i < NOF_CELLS; i++) {
+    TESTASSERT(add_cell(capture, &cells[i]) == SRSLTE_SUCCESS);
+  }
+  srslte_ch_awgn_c(capture, capture, srslte_convert_dB_to_power(-snr_db), nof_samples);
+
+  TESTASSERT(srslte_ue_cellsearch_wb_init(&cs, SRATE_HZ, offset_hz, NOF_CHANNELS, nof_samples, nof_threads) ==
+             SRSLTE_SUCCESS);
+
+  gettimeofday(&t[1], NULL);
+  int n = srslte_ue_cellsearch_wb_scan(&cs, capture, nof_samples, found, 3 * NOF_CHANNELS);
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  TESTASSERT(n >= 0);
+
+  printf("Scanned %d channels of %d ms in %.1f ms with %d threads\n",
+         NOF_CHANNELS,
+         NOF_SF,
+         t[0].tv_sec * 1e3 + t[0].tv_usec / 1e3,
+         nof_threads);
+
+  // Every cell is found on its channel and nothing else exceeds the detection threshold
+  bool detected[NOF_CELLS] = {};
+  for (int i = 0; i < n; i++) {
+    printf("Channel %d (%+.1f MHz): cell_id=%d, PSR=%.1f, CP=%s\n",
+           found[i].channel,
+           offset_hz[found[i].channel] / 1e6,
+           found[i].cell.cell_id,
+           found[i].cell.psr,
+           srslte_cp_string(found[i].cell.cp));
+    if (found[i].cell.psr < MIN_PSR) {
+      continue;
+    }
+    TESTASSERT(found[i].channel < NOF_CELLS);
+    TESTASSERT(found[i].cell.cell_id == cells[found[i].channel].id);
+    TESTASSERT(found[i].cell.cp == SRSLTE_CP_NORM);
+    detected[found[i].channel] = true;
+  }
+  for (uint32_t i = 0; i < NOF_CELLS; i++) {
+    TESTASSERT(detected[i]);
+  }
+
+  srslte_ue_cellsearch_wb_free(&cs);
+  free(capture);
+
+  printf("Ok\n");
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "srslte/phy/ue/ue_cell_search_wb.h"
+
+#include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/vector.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Half of the band kept around each carrier, covers the 62 subcarriers of PSS and SSS
+#define CELL_SEARCH_WB_CUTOFF_HZ 750e3
+
+// Duration of the frames the cell search works with
+#define CELL_SEARCH_WB_FRAME_LEN (5 * SRSLTE_SF_LEN_PRB(SRSLTE_CS_NOF_PRB))
+
+// Wideband samples given to the channelizer at once
+#define CELL_SEARCH_WB_CHUNK_MS 10
+
+/* Plays the channel stream of the worker as if it was received from a radio. The stream is repeated if the cell
+ * search asks for more samples than captured.
+ */
+static int recv_channel(void* h, void* data, uint32_t nsamples, srslte_timestamp_t* t)
+{
+  srslte_ue_cellsearch_wb_worker_t* w   = (srslte_ue_cellsearch_wb_worker_t*)h;
+  cf_t*                             ptr = (cf_t*)data;
+
+  for (uint32_t n = 0; n < nsamples;) {
+    uint32_t len = SRSLTE_MIN(nsamples - n, w->nof_samples - w->read_idx);
+    srslte_vec_cf_copy(&ptr[n], &w->buffer[w->read_idx], len);
+    w->read_idx = (w->read_idx + len) % w->nof_samples;
+    n += len;
+  }
+  return (int)nsamples;
+}
+
+int srslte_ue_cellsearch_wb_init(srslte_ue_cellsearch_wb_t* q,
+                                 double                     srate_hz,
+                                 const double*              offset_hz,
+                                 uint32_t                   nof_channels,
+                                 uint32_t                   max_samples,
+                                 uint32_t                   nof_threads)
+{
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+
+  if (q != NULL && offset_hz != NULL && nof_channels > 0 && nof_threads > 0) {
+    ret = SRSLTE_ERROR;
+    bzero(q, sizeof(srslte_ue_cellsearch_wb_t));
+
+    uint32_t chunk_len = (uint32_t)(srate_hz * CELL_SEARCH_WB_CHUNK_MS / 1000);
+    if (srslte_channelizer_init(&q->channelizer,
+                                srate_hz,
+                                SRSLTE_CS_SAMP_FREQ,
+                                CELL_SEARCH_WB_CUTOFF_HZ,
+                                offset_hz,
+                                nof_channels,
+                                chunk_len)) {
+      ERROR("Error initiating channelizer\n");
+      goto clean_exit;
+    }
+    pthread_mutex_init(&q->mutex, NULL);
+
+    q->decimation   = q->channelizer.decimation;
+    q->max_samples  = max_samples;
+    q->nof_channels = nof_channels;
+    q->nof_workers  = SRSLTE_MIN(nof_threads, nof_channels);
+
+    uint32_t max_channel_samples = max_samples / q->decimation + 1;
+    uint32_t max_frames          = SRSLTE_MAX(1, max_channel_samples / CELL_SEARCH_WB_FRAME_LEN);
+
+    q->channel_buffer = calloc(nof_channels, sizeof(cf_t*));
+    q->found          = calloc(nof_channels * 3, sizeof(bool));
+    q->found_cells    = calloc(nof_channels * 3, sizeof(srslte_ue_cellsearch_result_t));
+    q->workers        = calloc(q->nof_workers, sizeof(srslte_ue_cellsearch_wb_worker_t));
+    if (!q->channel_buffer || !q->found || !q->found_cells || !q->workers) {
+      perror("malloc");
+      goto clean_exit;
+    }
+
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      q->channel_buffer[ch] = srslte_vec_cf_malloc(max_channel_samples);
+      if (!q->channel_buffer[ch]) {
+        perror("malloc");
+        goto clean_exit;
+      }
+    }
+
+    q->max_frames = max_frames;
+    for (uint32_t i = 0; i < q->nof_workers; i++) {
+      srslte_ue_cellsearch_wb_worker_t* w = &q->workers[i];
+      w->parent                           = q;
+      if (srslte_ue_cellsearch_init(&w->cs, max_frames, recv_channel, w)) {
+        ERROR("Error initiating cell search worker %d\n", i);
+        goto clean_exit;
+      }
+    }
+
+    ret = SRSLTE_SUCCESS;
+  }
+
+clean_exit:
+  if (ret == SRSLTE_ERROR) {
+    srslte_ue_cellsearch_wb_free(q);
+  }
+  return ret;
+}
+
+void srslte_ue_cellsearch_wb_free(srslte_ue_cellsearch_wb_t* q)
+{
+  if (q) {
+    if (q->workers) {
+      for (uint32_t i = 0; i < q->nof_workers; i++) {
+        if (q->workers[i].cs.candidates) {
+          srslte_ue_cellsearch_free(&q->workers[i].cs);
+        }
+      }
+      free(q->workers);
+    }
+    if (q->channel_buffer) {
+      for (uint32_t ch = 0; ch < q->nof_channels; ch++) {
+        if (q->channel_buffer[ch]) {
+          free(q->channel_buffer[ch]);
+        }
+      }
+      free(q->channel_buffer);
+    }
+    if (q->found) {
+      free(q->found);
+    }
+    if (q->found_cells) {
+      free(q->found_cells);
+    }
+    if (q->channelizer.taps) {
+      srslte_channelizer_free(&q->channelizer);
+      pthread_mutex_destroy(&q->mutex);
+    }
+    bzero(q, sizeof(srslte_ue_cellsearch_wb_t));
+  }
+}
+
+/* Every worker takes the next channel not searched yet until all are done */
+static void* cellsearch_wb_worker(void* arg)
+{
+  srslte_ue_cellsearch_wb_worker_t* w = (srslte_ue_cellsearch_wb_worker_t*)arg;
+  srslte_ue_cellsearch_wb_t*        q = (srslte_ue_cellsearch_wb_t*)w->parent;
+
+  while (true) {
+    pthread_mutex_lock(&q->mutex);
+    uint32_t ch   = q->next_channel++;
+    bool     stop = ch >= q->nof_channels || q->error;
+    pthread_mutex_unlock(&q->mutex);
+    if (stop) {
+      break;
+    }
+
+    w->buffer      = q->channel_buffer[ch];
+    w->nof_samples = q->nof_channel_samples;
+    for (uint32_t N_id_2 = 0; N_id_2 < 3; N_id_2++) {
+      // All the N_id_2 are searched from the beginning of the capture
+      w->read_idx = 0;
+      int n       = srslte_ue_cellsearch_scan_N_id_2(&w->cs, N_id_2, &q->found_cells[3 * ch + N_id_2]);
+      if (n < 0) {
+        ERROR("Error searching cell in channel %d\n", ch);
+        pthread_mutex_lock(&q->mutex);
+        q->error = n;
+        pthread_mutex_unlock(&q->mutex);
+        break;
+      }
+      q->found[3 * ch + N_id_2] = n > 0;
+    }
+  }
+  return NULL;
+}
+
+int srslte_ue_cellsearch_wb_scan(srslte_ue_cellsearch_wb_t*        q,
+                                 const cf_t*                       samples,
+                                 uint32_t                          nof_samples,
+                                 srslte_ue_cellsearch_wb_result_t* found_cells,
+                                 uint32_t                          max_cells)
+{
+  if (q == NULL || samples == NULL || found_cells == NULL || nof_samples > q->max_samples) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  // Split the capture in one stream per channel
+  srslte_channelizer_reset(&q->channelizer);
+  cf_t*    output[q->nof_channels];
+  uint32_t nof_channel_samples = 0;
+  for (uint32_t i = 0; i < nof_samples; i += q->channelizer.max_input_len) {
+    for (uint32_t ch = 0; ch < q->nof_channels; ch++) {
+      output[ch] = &q->channel_buffer[ch][nof_channel_samples];
+    }
+    int n = srslte_channelizer_execute(
+        &q->channelizer, &samples[i], SRSLTE_MIN(q->channelizer.max_input_len, nof_samples - i), output);
+    if (n < 0) {
+      return SRSLTE_ERROR;
+    }
+    nof_channel_samples += (uint32_t)n;
+  }
+
+  uint32_t nof_frames = nof_channel_samples / CELL_SEARCH_WB_FRAME_LEN;
+  if (nof_frames == 0) {
+    ERROR("The capture is too short, at least 5 ms are required\n");
+    return SRSLTE_ERROR;
+  }
+  q->nof_channel_samples = nof_channel_samples;
+
+  // Scan each captured frame once per N_id_2, the candidate tables were allocated for the longest capture
+  for (uint32_t i = 0; i < q->nof_workers; i++) {
+    q->workers[i].cs.max_frames = SRSLTE_MIN(nof_frames, q->max_frames);
+    srslte_ue_cellsearch_set_nof_valid_frames(&q->workers[i].cs, q->workers[i].cs.max_frames);
+  }
+
+  q->next_channel = 0;
+  q->error        = SRSLTE_SUCCESS;
+  bzero(q->found, sizeof(bool) * q->nof_channels * 3);
+
+  for (uint32_t i = 0; i < q->nof_workers; i++) {
+    if (pthread_create(&q->workers[i].thread, NULL, cellsearch_wb_worker, &q->workers[i])) {
+      perror("pthread_create");
+      pthread_mutex_lock(&q->mutex);
+      q->error = SRSLTE_ERROR;
+      pthread_mutex_unlock(&q->mutex);
+      for (uint32_t j = 0; j < i; j++) {
+        pthread_join(q->workers[j].thread, NULL);
+      }
+      return SRSLTE_ERROR;
+    }
+  }
+  for (uint32_t i = 0; i < q->nof_workers; i++) {
+    pthread_join(q->workers[i].thread, NULL);
+  }
+  if (q->error) {
+    return q->error;
+  }
+
+  uint32_t nof_found = 0;
+  for (uint32_t ch = 0; ch < q->nof_channels; ch++) {
+    for (uint32_t N_id_2 = 0; N_id_2 < 3; N_id_2++) {
+      if (q->found[3 * ch + N_id_2] && nof_found < max_cells) {
+        found_cells[nof_found].channel = ch;
+        found_cells[nof_found].N_id_2  = N_id_2;
+        found_cells[nof_found].cell    = q->found_cells[3 * ch + N_id_2];
+        nof_found++;
+      }
+    }
+  }
+  return (int)nof_found;
+}
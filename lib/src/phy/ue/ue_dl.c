@@ -440,8 +440,22 @@ static int dci_blind_search(srslte_ue_dl_t*     q,
 {
   uint32_t nof_dci = 0;
   if (rnti) {
+    // Decode all the candidates at once, then go through them in order
+    srslte_dci_msg_t candidates[MAX_CANDIDATES];
+    uint32_t         nof_candidates = SRSLTE_MIN(search_space->nof_locations, MAX_CANDIDATES);
+    for (uint32_t i = 0; i < nof_candidates; i++) {
+      candidates[i].location = search_space->loc[i];
+      candidates[i].format   = search_space->format;
+      candidates[i].rnti     = 0;
+      candidates[i].nof_bits = 0;
+    }
+    if (srslte_pdcch_decode_msg_batch(&q->pdcch, sf, dci_cfg, candidates, nof_candidates)) {
+      ERROR("Error decoding DCI msg\n");
+      return SRSLTE_ERROR;
+    }
+
     int i = 0;
-    while ((dci_cfg->cif_enabled || !nof_dci) && (i < search_space->nof_locations) && (nof_dci < SRSLTE_MAX_DCI_MSG)) {
+    while ((dci_cfg->cif_enabled || !nof_dci) && (i < nof_candidates) && (nof_dci < SRSLTE_MAX_DCI_MSG)) {
       DEBUG("Searching format %s in %d,%d (%d/%d)\n",
             srslte_dci_format_string(search_space->format),
             search_space->loc[i].ncce,
@@ -449,13 +463,7 @@ static int dci_blind_search(srslte_ue_dl_t*     q,
             i,
             search_space->nof_locations);
 
-      dci_msg[nof_dci].location = search_space->loc[i];
-      dci_msg[nof_dci].format   = search_space->format;
-      dci_msg[nof_dci].rnti     = 0;
-      if (srslte_pdcch_decode_msg(&q->pdcch, sf, dci_cfg, &dci_msg[nof_dci])) {
-        ERROR("Error decoding DCI msg\n");
-        return SRSLTE_ERROR;
-      }
+      dci_msg[nof_dci] = candidates[i];
 
       if ((dci_msg[nof_dci].rnti == rnti) && (dci_msg[nof_dci].nof_bits > 0)) {
 
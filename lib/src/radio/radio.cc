@@ -31,6 +31,35 @@ extern "C" {
 
 namespace srslte {
 
+static void free_buffers(cf_t** buffers, uint32_t nof_buffers)
+{
+  for (uint32_t i = 0; i < nof_buffers; i++) {
+    if (buffers[i]) {
+      free(buffers[i]);
+      buffers[i] = nullptr;
+    }
+  }
+}
+
+// Grows the buffers so that they hold at least nof_samples
+static bool reserve_buffers(cf_t** buffers, uint32_t nof_buffers, uint32_t* len, uint32_t nof_samples)
+{
+  if (nof_samples <= *len) {
+    return true;
+  }
+  free_buffers(buffers, nof_buffers);
+  *len = 0;
+  for (uint32_t i = 0; i < nof_buffers; i++) {
+    buffers[i] = srslte_vec_cf_malloc(nof_samples);
+    if (!buffers[i]) {
+      free_buffers(buffers, nof_buffers);
+      return false;
+    }
+  }
+  *len = nof_samples;
+  return true;
+}
+
 radio::radio(srslte::log_filter* log_h_) : logger(nullptr), log_h(log_h_), zeros(NULL)
 {
   zeros = srslte_vec_cf_malloc(SRSLTE_SF_LEN_MAX);
@@ -49,6 +78,7 @@ radio::~radio()
     free(zeros);
     zeros = nullptr;
   }
+  free_resamplers();
 }
 
 int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
@@ -139,6 +169,12 @@ int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
   // Frequency offset
   freq_offset = args.freq_offset;
 
+  // Front-end sampling rate
+  base_srate = args.srate_hz;
+  if (base_srate > 0) {
+    log_h->console("Resampling to front-end sampling rates of %.2f MHz x 2^n\n", base_srate / 1e6);
+  }
+
   // Get device info
   rf_info = *get_info();
 
@@ -165,6 +201,7 @@ void radio::stop()
   if (is_initialized) {
     srslte_rf_close(&rf_device);
   }
+  free_resamplers();
 }
 
 void radio::reset()
@@ -227,12 +264,38 @@ bool radio::rx_now(rf_buffer_interface& buffer, const uint32_t& nof_samples, srs
     return false;
   }
 
-  if (srslte_rf_recv_with_time_multi(&rf_device, radio_buffers, nof_samples, true, full_secs, frac_secs) > 0) {
+  // Receive at the front-end rate the samples that resample to nof_samples at the PHY rate
+  uint32_t nof_rf_samples                   = nof_samples;
+  void*    phy_buffers[SRSLTE_MAX_CHANNELS] = {};
+  if (rx_resample) {
+    nof_rf_samples = srslte_resample_arb_nof_input(&rx_resamplers[0], nof_samples);
+    if (!reserve_buffers(rx_resample_buffers, nof_channels + 1, &rx_resample_len, nof_rf_samples)) {
+      log_h->error("Allocating resampling buffers\n");
+      return false;
+    }
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      phy_buffers[i]   = radio_buffers[i];
+      radio_buffers[i] = rx_resample_buffers[i];
+    }
+  }
+
+  if (srslte_rf_recv_with_time_multi(&rf_device, radio_buffers, nof_rf_samples, true, full_secs, frac_secs) > 0) {
     ret = true;
   } else {
     ret = false;
   }
 
+  // All the channels are resampled so that their filters stay aligned
+  if (ret && rx_resample) {
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      cf_t* out = (cf_t*)phy_buffers[i];
+      if (out == nullptr || out == zeros) {
+        out = rx_resample_buffers[nof_channels];
+      }
+      srslte_resample_arb_compute(&rx_resamplers[i], rx_resample_buffers[i], out, nof_rf_samples);
+    }
+  }
+
   return ret;
 }
 
@@ -309,12 +372,13 @@ bool radio::tx(rf_buffer_interface& buffer, const uint32_t& nof_samples_, const
         // Otherwise, transmit zeros
         uint32_t gap_nsamples = abs(past_nsamples);
         while (gap_nsamples > 0) {
-          // Transmission cannot exceed SRSLTE_SF_LEN_MAX (zeros buffer size limitation)
-          uint32_t nzeros = SRSLTE_MIN(gap_nsamples, SRSLTE_SF_LEN_MAX);
+          // Transmission cannot exceed SRSLTE_SF_LEN_MAX (zeros buffer size limitation), resampling may double it
+          uint32_t nzeros    = SRSLTE_MIN(gap_nsamples, tx_resample ? SRSLTE_SF_LEN_MAX / 2 : SRSLTE_SF_LEN_MAX);
+          uint32_t nzeros_rf = tx_resample ? (uint32_t)round(nzeros * tx_resamplers[0].rate) : nzeros;
 
           // Zeros transmission
           int ret = srslte_rf_send_timed2(
-              &rf_device, zeros, nzeros, end_of_burst_time.full_secs, end_of_burst_time.frac_secs, false, false);
+              &rf_device, zeros, nzeros_rf, end_of_burst_time.full_secs, end_of_burst_time.frac_secs, false, false);
           if (ret < SRSLTE_SUCCESS) {
             return false;
           }
@@ -339,8 +403,26 @@ bool radio::tx(rf_buffer_interface& buffer, const uint32_t& nof_samples_, const
     return false;
   }
 
+  // Resample to the front-end rate, the filters carry over between the transmissions of a burst
+  uint32_t nof_rf_samples = nof_samples;
+  if (tx_resample) {
+    uint32_t max_rf_samples = (uint32_t)ceil(nof_samples * tx_resamplers[0].rate) + 1;
+    if (!reserve_buffers(tx_resample_buffers, nof_channels, &tx_resample_len, max_rf_samples)) {
+      log_h->error("Allocating resampling buffers\n");
+      return false;
+    }
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      if (is_start_of_burst) {
+        srslte_resample_arb_reset(&tx_resamplers[i]);
+      }
+      cf_t* in       = radio_buffers[i] ? (cf_t*)radio_buffers[i] : zeros;
+      nof_rf_samples = srslte_resample_arb_compute(&tx_resamplers[i], in, tx_resample_buffers[i], nof_samples);
+      radio_buffers[i] = tx_resample_buffers[i];
+    }
+  }
+
   int ret = srslte_rf_send_timed_multi(
-      &rf_device, radio_buffers, nof_samples, tx_time.full_secs, tx_time.frac_secs, true, is_start_of_burst, false);
+      &rf_device, radio_buffers, nof_rf_samples, tx_time.full_secs, tx_time.frac_secs, true, is_start_of_burst, false);
   is_start_of_burst = false;
   return ret > SRSLTE_SUCCESS;
 }
@@ -424,7 +506,13 @@ void radio::set_rx_srate(const double& srate)
   if (!is_initialized) {
     return;
   }
-  srslte_rf_set_rx_srate(&rf_device, srate);
+  double rf_srate = srslte_rf_set_rx_srate(&rf_device, get_device_srate(srate));
+
+  rx_resample = base_srate > 0 && rf_srate != srate;
+  if (rx_resample && !set_resamplers(rx_resamplers, (float)(srate / rf_srate))) {
+    log_h->error("Initiating the resampling from %.2f to %.2f MHz\n", rf_srate / 1e6, srate / 1e6);
+    rx_resample = false;
+  }
 }
 
 void radio::set_tx_freq(const uint32_t& carrier_idx, const double& freq)
@@ -489,7 +577,17 @@ void radio::set_tx_srate(const double& srate)
   if (!is_initialized) {
     return;
   }
-  cur_tx_srate = srslte_rf_set_tx_srate(&rf_device, srate);
+  cur_tx_srate = srslte_rf_set_tx_srate(&rf_device, get_device_srate(srate));
+
+  // Transmission times and advances are kept at the PHY rate
+  tx_resample = base_srate > 0 && cur_tx_srate != srate;
+  if (tx_resample) {
+    if (!set_resamplers(tx_resamplers, (float)(cur_tx_srate / srate))) {
+      log_h->error("Initiating the resampling from %.2f to %.2f MHz\n", srate / 1e6, cur_tx_srate / 1e6);
+      tx_resample = false;
+    }
+    cur_tx_srate = srate;
+  }
 
   int nsamples = 0;
   /* Set time advance for each known device if in auto mode */
@@ -733,6 +831,48 @@ bool radio::config_rf_channels(const rf_args_t& args)
   return true;
 }
 
+double radio::get_device_srate(double srate)
+{
+  if (base_srate <= 0) {
+    return srate;
+  }
+
+  // The resampler filters are not steep enough to decimate by more than two
+  double rf_srate = base_srate;
+  while (rf_srate < srate) {
+    rf_srate *= 2;
+  }
+  while (rf_srate / 2 >= srate) {
+    rf_srate /= 2;
+  }
+  return rf_srate;
+}
+
+bool radio::set_resamplers(srslte_resample_arb_t* resamplers, float rate)
+{
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    srslte_resample_arb_free(&resamplers[i]);
+    if (srslte_resample_arb_init(&resamplers[i], rate, true)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void radio::free_resamplers()
+{
+  for (uint32_t i = 0; i < SRSLTE_MAX_CHANNELS; i++) {
+    srslte_resample_arb_free(&rx_resamplers[i]);
+    srslte_resample_arb_free(&tx_resamplers[i]);
+  }
+  free_buffers(rx_resample_buffers, SRSLTE_MAX_CHANNELS + 1);
+  free_buffers(tx_resample_buffers, SRSLTE_MAX_CHANNELS);
+  rx_resample_len = 0;
+  tx_resample_len = 0;
+  rx_resample     = false;
+  tx_resample     = false;
+}
+
 /***
  * Carrier mapping class
  */
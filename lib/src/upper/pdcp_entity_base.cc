@@ -38,6 +38,16 @@ void pdcp_entity_base::config_security(as_security_config_t sec_cfg_)
 {
   sec_cfg = sec_cfg_;
 
+  // Expand the AES key schedules once per configuration instead of once per PDU
+  k_enc_aes.reset();
+  k_int_aes.reset();
+  if (sec_cfg.cipher_algo == CIPHERING_ALGORITHM_ID_128_EEA2) {
+    k_enc_aes.set_key(is_srb() ? &sec_cfg.k_rrc_enc[16] : &sec_cfg.k_up_enc[16]);
+  }
+  if (sec_cfg.integ_algo == INTEGRITY_ALGORITHM_ID_128_EIA2) {
+    k_int_aes.set_key(is_srb() ? &sec_cfg.k_rrc_int[16] : &sec_cfg.k_up_int[16]);
+  }
+
   log->info("Configuring security with %s and %s\n",
             integrity_algorithm_id_text[sec_cfg.integ_algo],
             ciphering_algorithm_id_text[sec_cfg.cipher_algo]);
@@ -69,7 +79,11 @@ void pdcp_entity_base::integrity_generate(uint8_t* msg, uint32_t msg_len, uint32
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
+      if (k_int_aes.is_set()) {
+        security_128_eia2(k_int_aes, count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
+      } else {
+        security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
+      }
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
@@ -106,7 +120,11 @@ bool pdcp_entity_base::integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
+      if (k_int_aes.is_set()) {
+        security_128_eia2(k_int_aes, count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
+      } else {
+        security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
+      }
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
@@ -164,7 +182,11 @@ void pdcp_entity_base::cipher_encrypt(uint8_t* msg, uint32_t msg_len, uint32_t c
       memcpy(ct, ct_tmp, msg_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
+      if (k_enc_aes.is_set()) {
+        security_128_eea2(k_enc_aes, count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
+      } else {
+        security_128_eea2(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
+      }
       memcpy(ct, ct_tmp, msg_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
@@ -203,7 +225,11 @@ void pdcp_entity_base::cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t cou
       memcpy(msg, msg_tmp, ct_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
+      if (k_enc_aes.is_set()) {
+        security_128_eea2(k_enc_aes, count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
+      } else {
+        security_128_eea2(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
+      }
       memcpy(msg, msg_tmp, ct_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/asn1/rrc_asn1.h"
+#include "srslte/asn1/s1ap_asn1.h"
+#include "srslte/common/test_common.h"
+#include <chrono>
+#include <getopt.h>
+
+/*
+ * Encode/decode time of the RRC and S1AP test vectors, with decoded trees allocated from the heap or from an arena
+ */
+
+using namespace asn1;
+
+uint32_t nof_repetitions = 1000;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [n]\n", prog);
+  printf("\t-n number of encode/decode repetitions per message [Default %d]\n", nof_repetitions);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "n")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+template <typename Msg>
+int bench_msg(const char* name, const std::string& hex)
+{
+  std::vector<uint8_t> msg(hex.size() / 2);
+  string_to_octstring(msg.data(), hex);
+
+  uint8_t buf[2048];
+  arena   rx_arena;
+
+  // every decode builds and destroys a whole tree, as a protocol handler does per PDU
+  auto t0 = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    Msg      pdu;
+    cbit_ref bref(msg.data(), msg.size());
+    TESTASSERT(pdu.unpack(bref) == SRSASN_SUCCESS);
+  }
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    rx_arena.reset();
+    Msg      pdu;
+    cbit_ref bref(msg.data(), msg.size());
+    {
+      arena_scope scope(rx_arena);
+      TESTASSERT(pdu.unpack(bref) == SRSASN_SUCCESS);
+    }
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  Msg      pdu;
+  cbit_ref bref(msg.data(), msg.size());
+  TESTASSERT(pdu.unpack(bref) == SRSASN_SUCCESS);
+  int nof_bits = 0;
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    bit_ref bref2(buf, sizeof(buf));
+    TESTASSERT(pdu.pack(bref2) == SRSASN_SUCCESS);
+    nof_bits = bref2.distance();
+  }
+  auto t3 = std::chrono::high_resolution_clock::now();
+
+  TESTASSERT(nof_bits > 0);
+  TESTASSERT(test_pack_unpack_consistency(pdu) == SRSASN_SUCCESS);
+
+  double dec_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / (double)nof_repetitions;
+  double are_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / (double)nof_repetitions;
+  double enc_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count() / (double)nof_repetitions;
+  printf("%-26s %4zu bytes: decode %7.1f ns, decode (arena %5zu bytes) %7.1f ns, encode %7.1f ns\n",
+         name,
+         msg.size(),
+         dec_ns,
+         rx_arena.nof_bytes_used(),
+         are_ns,
+         enc_ns);
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  TESTASSERT(bench_msg<rrc::bcch_dl_sch_msg_s>(
+                 "RRC SIB2", "00830992B7EC9300A3424B000C000500205D6AAAF04200C01DDC801C4880030010A713228500") ==
+             SRSLTE_SUCCESS);
+  TESTASSERT(bench_msg<rrc::dl_dcch_msg_s>(
+                 "RRC ConnectionReconfig",
+                 "201615C8400003C2841810A804D79514A20102189A018014810ACB840800AD6DC40608AF6DC7A0C08200000C38602030C3000"
+                 "010044010C23C2A06203011102813DA4E96DA8083A100A48300327B0895AE0016A900E080848C82BBB1B4BA188336B731981898"
+                 "8336B1B19A1B1B0233B839398280857F8080AF037F7F7D7D7F7F2805FB327B08C00001F83E3CB1B200C030381FFA9C083EA25F1C"
+                 "E1D084") == SRSLTE_SUCCESS);
+  TESTASSERT(bench_msg<s1ap::s1ap_pdu_c>(
+                 "S1AP InitialContextSetup",
+                 "00090080c60000060000000200640008000200010042000a183b9aca00603b9aca000018007800003400734500093c0f800a00"
+                 "21f0b7361c5664273e5b04b7020742023e060009f107000700375266c101091b0774657374313233066d6e63303730066d6363"
+                 "39303104677072730501c0a80302270e8080210a0300000a810608080808500bf609f107800101f67e72691309f10700012305"
+                 "f4f67e7269006b000518000c0000004900204525e49a77c8d5cf263363eb5bb9c3439b9eb3861fa8a7cf435407ae422b63b9") ==
+             SRSLTE_SUCCESS);
+  TESTASSERT(bench_msg<s1ap::s1ap_pdu_c>(
+                 "S1AP HandoverRequest",
+                 "00010080E600000800000002006400010001000002400200000042000A183B9ACA00603B9ACA000035001900001B00144A1F0A"
+                 "0021F0B7361C5600093C0000008F4001000068007574005F0A100C81A00000180002E87FE400001500000005910000029009780"
+                 "00000627C1F50298F00E9CE021300009501004640000001901384001C006700A0518041400670DFBC44006B0140008002080"
+                 "0C14CA2D54E2803517240E0591401217B000009F1070019B0100009F1070019C02100001F006B000518000C00000028002110"
+                 "8B0DABD7E59834B3EF6CC1AAA727FBF45308FF74947CA71BD9B437B902786212") == SRSLTE_SUCCESS);
+
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
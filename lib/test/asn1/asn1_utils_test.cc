@@ -0,0 +1,250 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/asn1/asn1_utils.h"
+#include "srslte/common/test_common.h"
+#include <random>
+
+using namespace asn1;
+
+// Reference MSB-first bit writer/reader, one bit at a time
+static void ref_write(uint8_t* buf, uint32_t& pos, uint64_t val, uint32_t n_bits)
+{
+  for (uint32_t i = 0; i < n_bits; ++i, ++pos) {
+    uint8_t bit = (val >> (n_bits - 1 - i)) & 1u;
+    buf[pos / 8] = (buf[pos / 8] & ~(0x80u >> (pos % 8))) | (bit << (7 - pos % 8));
+  }
+}
+
+static uint64_t ref_read(const uint8_t* buf, uint32_t& pos, uint32_t n_bits)
+{
+  uint64_t val = 0;
+  for (uint32_t i = 0; i < n_bits; ++i, ++pos) {
+    val = (val << 1u) | ((buf[pos / 8] >> (7 - pos % 8)) & 1u);
+  }
+  return val;
+}
+
+int test_random_pack_unpack()
+{
+  std::mt19937                            rgen(1234);
+  std::uniform_int_distribution<uint32_t> nbits_dist(0, 31), nbytes_dist(0, 40), op_dist(0, 3);
+
+  for (uint32_t trial = 0; trial < 100; ++trial) {
+    uint8_t  buf[2048] = {}, ref[2048] = {}, tmp[64];
+    uint32_t ref_pos   = 0;
+    bit_ref  bref(buf, sizeof(buf));
+
+    struct op_t {
+      uint32_t type;
+      uint32_t n;
+      uint64_t val;
+      uint8_t  bytes[64];
+    };
+    std::vector<op_t> ops(30);
+    for (auto& op : ops) {
+      op.type = op_dist(rgen);
+      switch (op.type) {
+        case 0: // scalar
+          op.n   = nbits_dist(rgen);
+          op.val = rgen() & ((1u << op.n) - 1u);
+          TESTASSERT(bref.pack(op.val, op.n) == SRSASN_SUCCESS);
+          ref_write(ref, ref_pos, op.val, op.n);
+          break;
+        case 1: // octets
+          op.n = nbytes_dist(rgen);
+          for (uint32_t i = 0; i < op.n; ++i) {
+            op.bytes[i] = rgen();
+            ref_write(ref, ref_pos, op.bytes[i], 8);
+          }
+          TESTASSERT(bref.pack_bytes(op.bytes, op.n) == SRSASN_SUCCESS);
+          break;
+        case 2: // alignment
+          TESTASSERT(bref.align_bytes_zero() == SRSASN_SUCCESS);
+          ref_write(ref, ref_pos, 0, (8 - ref_pos % 8) % 8);
+          break;
+        default: // single bit
+          op.n   = 1;
+          op.val = rgen() & 1u;
+          TESTASSERT(bref.pack(op.val, 1) == SRSASN_SUCCESS);
+          ref_write(ref, ref_pos, op.val, 1);
+          break;
+      }
+      TESTASSERT(bref.distance(buf) == (int)ref_pos);
+    }
+    // the trailing bits of the last octet are zero in both
+    TESTASSERT(memcmp(buf, ref, (ref_pos + 7) / 8) == 0);
+
+    cbit_ref cbref(buf, sizeof(buf));
+    ref_pos = 0;
+    for (auto& op : ops) {
+      switch (op.type) {
+        case 0:
+        case 3: {
+          uint32_t val;
+          TESTASSERT(cbref.unpack(val, op.n) == SRSASN_SUCCESS);
+          TESTASSERT(val == ref_read(ref, ref_pos, op.n));
+          TESTASSERT(val == op.val);
+        } break;
+        case 1:
+          TESTASSERT(cbref.unpack_bytes(tmp, op.n) == SRSASN_SUCCESS);
+          TESTASSERT(memcmp(tmp, op.bytes, op.n) == 0);
+          ref_pos += 8 * op.n;
+          break;
+        default:
+          TESTASSERT(cbref.align_bytes() == SRSASN_SUCCESS);
+          ref_pos += (8 - ref_pos % 8) % 8;
+          break;
+      }
+      TESTASSERT(cbref.distance(buf) == (int)ref_pos);
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
+int test_wide_unpack()
+{
+  uint8_t buf[16];
+  for (uint32_t i = 0; i < sizeof(buf); ++i) {
+    buf[i] = 0x5a ^ (i * 37);
+  }
+  for (uint32_t offset = 0; offset < 8; ++offset) {
+    for (uint32_t n_bits = 0; n_bits <= 64; ++n_bits) {
+      cbit_ref bref(buf, sizeof(buf));
+      uint32_t pos = 0;
+      uint64_t skip, val;
+      TESTASSERT(bref.unpack(skip, offset) == SRSASN_SUCCESS);
+      TESTASSERT(bref.unpack(val, n_bits) == SRSASN_SUCCESS);
+      TESTASSERT(skip == ref_read(buf, pos, offset));
+      TESTASSERT(val == ref_read(buf, pos, n_bits));
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
+int test_buffer_limits()
+{
+  srslte::scoped_log<srslte::nullsink_log> null_log("ASN1");
+  uint8_t                                  buf[4] = {}, bytes[4] = {1, 2, 3, 4};
+
+  // packing up to the last bit of the buffer succeeds, one more bit fails
+  bit_ref bref(buf, sizeof(buf));
+  TESTASSERT(bref.pack(0x1ffffff, 25) == SRSASN_SUCCESS);
+  TESTASSERT(bref.pack(0x7f, 7) == SRSASN_SUCCESS);
+  TESTASSERT(bref.distance_bytes() == 4);
+  TESTASSERT(bref.pack(1, 1) == SRSASN_ERROR_ENCODE_FAIL);
+
+  // octets fill the buffer exactly when aligned, need one more octet when not
+  bref.set(buf, sizeof(buf));
+  TESTASSERT(bref.pack_bytes(bytes, 4) == SRSASN_SUCCESS);
+  bref.set(buf, sizeof(buf));
+  TESTASSERT(bref.pack(0, 1) == SRSASN_SUCCESS);
+  TESTASSERT(bref.pack_bytes(bytes, 4) == SRSASN_ERROR_ENCODE_FAIL);
+  TESTASSERT(bref.pack_bytes(bytes, 3) == SRSASN_SUCCESS);
+
+  cbit_ref cbref(buf, sizeof(buf));
+  uint8_t  out[4];
+  TESTASSERT(cbref.unpack_bytes(out, 4) == SRSASN_SUCCESS);
+  TESTASSERT(cbref.unpack(out[0], 1) == SRSASN_ERROR_DECODE_FAIL);
+  cbref.set(buf, sizeof(buf));
+  TESTASSERT(cbref.unpack(out[0], 1) == SRSASN_SUCCESS);
+  TESTASSERT(cbref.unpack_bytes(out, 4) == SRSASN_ERROR_DECODE_FAIL);
+  TESTASSERT(cbref.unpack_bytes(out, 3) == SRSASN_SUCCESS);
+  TESTASSERT(memcmp(out, bytes, 3) == 0);
+  return SRSLTE_SUCCESS;
+}
+
+int test_arena()
+{
+  arena               a(256);
+  dyn_array<uint32_t> copy;
+
+  {
+    dyn_array<uint32_t> heap_arr(10);
+    {
+      arena_scope scope(a);
+      TESTASSERT(get_thread_arena() == &a);
+
+      // nested arrays, growth and optional fields are all taken from the arena
+      dyn_array<dyn_array<uint16_t> > arr(4);
+      for (uint32_t i = 0; i < arr.size(); ++i) {
+        for (uint32_t j = 0; j < 20; ++j) {
+          arr[i].push_back(i * j);
+        }
+      }
+      ext_array<uint64_t> ext;
+      ext.resize(100);
+      for (uint32_t i = 0; i < ext.size(); ++i) {
+        ext[i] = i;
+      }
+      copy_ptr<dyn_array<uint8_t> > opt;
+      opt.set_present();
+      opt->resize(300);
+      size_t used = a.nof_bytes_used();
+      TESTASSERT(used > 100 * sizeof(uint64_t) + 300);
+      TESTASSERT(a.nof_blocks() > 1);
+
+      // a heap array that grows inside the scope moves to the arena
+      heap_arr.resize(1000);
+      heap_arr[999] = 5;
+      TESTASSERT(a.nof_bytes_used() >= used + 1000 * sizeof(uint32_t));
+
+      for (uint32_t i = 0; i < arr.size(); ++i) {
+        for (uint32_t j = 0; j < 20; ++j) {
+          TESTASSERT(arr[i][j] == i * j);
+        }
+      }
+      TESTASSERT(ext[99] == 99);
+    }
+    TESTASSERT(get_thread_arena() == nullptr);
+
+    // copies made after the scope go to the heap
+    copy = heap_arr;
+  }
+
+  // the arena can be reset once all the objects using it are gone
+  uint32_t nof_blocks = a.nof_blocks();
+  a.reset();
+  TESTASSERT(a.nof_bytes_used() == 0);
+  TESTASSERT(copy[999] == 5);
+
+  // blocks are reused after a reset
+  {
+    arena_scope         scope(a);
+    dyn_array<uint8_t>  arr(200);
+    ext_array<uint32_t> ext(40);
+    TESTASSERT(a.nof_blocks() == nof_blocks);
+  }
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_DEBUG);
+
+  TESTASSERT(test_random_pack_unpack() == SRSLTE_SUCCESS);
+  TESTASSERT(test_wide_unpack() == SRSLTE_SUCCESS);
+  TESTASSERT(test_buffer_limits() == SRSLTE_SUCCESS);
+  TESTASSERT(test_arena() == SRSLTE_SUCCESS);
+
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/rcu.h"
+#include "srslte/common/rnti_map.h"
+#include "srslte/common/rwlock_guard.h"
+#include "srslte/common/test_common.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+using srslte::rcu_read_guard;
+using srslte::rcu_reclaimer;
+
+struct obj_t {
+  static std::atomic<int> nof_objs;
+  obj_t() { nof_objs++; }
+  ~obj_t() { nof_objs--; }
+  std::atomic<bool> alive{true};
+};
+std::atomic<int> obj_t::nof_objs{0};
+
+int test_rcu_same_thread()
+{
+  rcu_reclaimer reclaimer;
+  {
+    rcu_read_guard rcu;
+    reclaimer.retire(new obj_t);
+    {
+      // Nested critical sections keep the outer epoch
+      rcu_read_guard rcu2;
+    }
+    TESTASSERT(reclaimer.reclaim() == 1);
+    TESTASSERT(obj_t::nof_objs == 1);
+  }
+  TESTASSERT(reclaimer.reclaim() == 0);
+  TESTASSERT(obj_t::nof_objs == 0);
+
+  // Readers entering after the retirement do not delay it
+  reclaimer.retire(new obj_t);
+  {
+    rcu_read_guard rcu;
+    TESTASSERT(reclaimer.reclaim() == 0);
+  }
+  TESTASSERT(obj_t::nof_objs == 0);
+  return SRSLTE_SUCCESS;
+}
+
+int test_rcu_other_thread()
+{
+  rcu_reclaimer    reclaimer;
+  std::atomic<int> step{0};
+  std::thread      reader([&step]() {
+    rcu_read_guard rcu;
+    step = 1;
+    while (step != 2) {
+      std::this_thread::yield();
+    }
+  });
+  while (step != 1) {
+    std::this_thread::yield();
+  }
+  reclaimer.retire(new obj_t);
+  TESTASSERT(reclaimer.reclaim() == 1);
+  TESTASSERT(obj_t::nof_objs == 1);
+  step = 2;
+  reclaimer.synchronize();
+  TESTASSERT(obj_t::nof_objs == 0);
+  reader.join();
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Several PHY-like threads look up random RNTIs while a writer keeps adding and removing UEs, once with the UE table
+ * guarded by a rwlock and once with RCU snapshots. Removed UEs are only marked dead, so that readers can check they
+ * never reach a UE after its deletion.
+ */
+typedef srslte::rnti_map<obj_t*> table_t;
+
+const uint32_t nof_ues      = 64;
+const uint32_t nof_rnti     = 256;
+const auto     bench_length = std::chrono::milliseconds(300);
+
+struct bench_ctxt_t {
+  std::atomic<bool>     running{true};
+  std::atomic<uint64_t> nof_lookups{0};
+  std::atomic<uint64_t> nof_errors{0};
+  std::vector<obj_t*>   graveyard;
+
+  // rwlock mode
+  pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+  table_t          locked_table;
+
+  // RCU mode
+  std::atomic<table_t*> rcu_table{nullptr};
+  rcu_reclaimer         reclaimer;
+};
+
+static void mark_dead(void* p)
+{
+  static_cast<obj_t*>(p)->alive = false;
+}
+
+static table_t* copy_table(const table_t& t)
+{
+  table_t* n = new table_t;
+  n->reserve(t.size() + 1);
+  for (auto& e : t) {
+    n->emplace(e.first, e.second);
+  }
+  return n;
+}
+
+template <bool use_rcu>
+void reader_thread(bench_ctxt_t* ctxt, uint32_t seed)
+{
+  std::minstd_rand rng(seed);
+  uint64_t         n = 0, errors = 0;
+  while (ctxt->running.load(std::memory_order_relaxed)) {
+    for (uint32_t i = 0; i < 1000; i++) {
+      uint16_t rnti = 70 + rng() % nof_rnti;
+      if (use_rcu) {
+        rcu_read_guard rcu;
+        table_t*       t  = ctxt->rcu_table.load(std::memory_order_acquire);
+        auto           it = t->find(rnti);
+        if (it != t->end() and not it->second->alive.load(std::memory_order_relaxed)) {
+          errors++;
+        }
+      } else {
+        srslte::rwlock_read_guard lock(ctxt->rwlock);
+        auto                      it = ctxt->locked_table.find(rnti);
+        if (it != ctxt->locked_table.end() and not it->second->alive.load(std::memory_order_relaxed)) {
+          errors++;
+        }
+      }
+    }
+    n += 1000;
+  }
+  ctxt->nof_lookups += n;
+  ctxt->nof_errors += errors;
+}
+
+template <bool use_rcu>
+void writer_thread(bench_ctxt_t* ctxt)
+{
+  std::minstd_rand      rng(1);
+  std::vector<uint16_t> active;
+  while (ctxt->running.load(std::memory_order_relaxed)) {
+    uint16_t rnti   = 70 + rng() % nof_rnti;
+    bool     remove = active.size() >= nof_ues;
+    if (remove) {
+      size_t idx = rng() % active.size();
+      rnti       = active[idx];
+      active.erase(active.begin() + idx);
+    } else if (std::find(active.begin(), active.end(), rnti) == active.end()) {
+      active.push_back(rnti);
+    } else {
+      continue;
+    }
+
+    if (use_rcu) {
+      table_t* old_table = ctxt->rcu_table.load(std::memory_order_relaxed);
+      table_t* new_table = copy_table(*old_table);
+      obj_t*   removed   = nullptr;
+      if (remove) {
+        removed = new_table->at(rnti);
+        new_table->erase(rnti);
+      } else {
+        obj_t* o = new obj_t;
+        ctxt->graveyard.push_back(o);
+        new_table->emplace(rnti, o);
+      }
+      ctxt->rcu_table.store(new_table, std::memory_order_release);
+      ctxt->reclaimer.retire(old_table);
+      if (removed != nullptr) {
+        ctxt->reclaimer.retire(removed, mark_dead);
+      }
+      ctxt->reclaimer.reclaim();
+    } else {
+      srslte::rwlock_write_guard lock(ctxt->rwlock);
+      if (remove) {
+        ctxt->locked_table.at(rnti)->alive = false;
+        ctxt->locked_table.erase(rnti);
+      } else {
+        obj_t* o = new obj_t;
+        ctxt->graveyard.push_back(o);
+        ctxt->locked_table.emplace(rnti, o);
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+template <bool use_rcu>
+int run_bench(uint32_t nof_readers)
+{
+  bench_ctxt_t ctxt;
+  ctxt.rcu_table = new table_t;
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < nof_readers; i++) {
+    threads.emplace_back(reader_thread<use_rcu>, &ctxt, i + 1);
+  }
+  threads.emplace_back(writer_thread<use_rcu>, &ctxt);
+  std::this_thread::sleep_for(bench_length);
+  ctxt.running = false;
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  ctxt.reclaimer.synchronize();
+  delete ctxt.rcu_table.load();
+  for (obj_t* o : ctxt.graveyard) {
+    delete o;
+  }
+
+  double secs = std::chrono::duration_cast<std::chrono::microseconds>(bench_length).count() / 1e6;
+  printf("%s, %d readers: %.1f Mlookups/s\n",
+         use_rcu ? "RCU   " : "rwlock",
+         nof_readers,
+         ctxt.nof_lookups / secs / 1e6);
+  TESTASSERT(ctxt.nof_errors == 0);
+  TESTASSERT(obj_t::nof_objs == 0);
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t nof_readers = 4;
+  if (argc > 1) {
+    nof_readers = (uint32_t)strtol(argv[1], nullptr, 10);
+  }
+
+  TESTASSERT(test_rcu_same_thread() == SRSLTE_SUCCESS);
+  TESTASSERT(test_rcu_other_thread() == SRSLTE_SUCCESS);
+  TESTASSERT(run_bench<false>(nof_readers) == SRSLTE_SUCCESS);
+  TESTASSERT(run_bench<true>(nof_readers) == SRSLTE_SUCCESS);
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/rnti_map.h"
+#include "srslte/common/test_common.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+
+using srslte::rnti_map;
+
+struct C {
+  static int nof_objs;
+  C() { nof_objs++; }
+  explicit C(uint32_t v_) : v(v_) { nof_objs++; }
+  C(const C& other) = delete;
+  C& operator=(const C&) = delete;
+  ~C() { nof_objs--; }
+  uint32_t v = 0;
+};
+int C::nof_objs = 0;
+
+int test_rnti_map_basic()
+{
+  rnti_map<C> m;
+  TESTASSERT(m.empty() and m.size() == 0);
+  TESTASSERT(m.find(0x46) == m.end());
+  TESTASSERT(m.count(0x46) == 0);
+
+  TESTASSERT(m.emplace(0x46, 5).second);
+  TESTASSERT(not m.emplace(0x46, 6).second);
+  TESTASSERT(m.size() == 1 and C::nof_objs == 1);
+  TESTASSERT(m.at(0x46).v == 5);
+  TESTASSERT(m.find(0x46)->first == 0x46);
+  m[0x47].v = 3;
+  TESTASSERT(m.size() == 2 and m.count(0x47) == 1);
+
+  // RNTIs colliding in the table index
+  uint16_t rnti_collision = 0x46 + m.capacity();
+  m[rnti_collision].v     = 7;
+  TESTASSERT(m.at(rnti_collision).v == 7);
+  TESTASSERT(m.erase(0x46) == 1);
+  TESTASSERT(m.erase(0x46) == 0);
+  TESTASSERT(m.at(rnti_collision).v == 7);
+  TESTASSERT(m.size() == 2 and C::nof_objs == 2);
+
+  bool caught = false;
+  try {
+    m.at(0x46);
+  } catch (const std::out_of_range&) {
+    caught = true;
+  }
+  TESTASSERT(caught);
+
+  m.clear();
+  TESTASSERT(m.empty() and C::nof_objs == 0);
+  TESTASSERT(m.begin() == m.end());
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_rnti_map_stable_addresses()
+{
+  rnti_map<C>                     m;
+  std::map<uint16_t, const C*>    addrs;
+  std::mt19937                    rgen(0);
+  std::uniform_int_distribution<> rnti_dist(0x46, 0xfff3);
+
+  // Insert/erase random RNTIs. Element addresses must survive rehashes
+  for (uint32_t i = 0; i < 4000; ++i) {
+    uint16_t rnti = rnti_dist(rgen);
+    if (m.count(rnti) > 0) {
+      TESTASSERT(&m.at(rnti) == addrs[rnti]);
+      TESTASSERT(m.at(rnti).v == rnti);
+      m.erase(rnti);
+      addrs.erase(rnti);
+    } else {
+      auto ret = m.emplace(rnti, rnti);
+      TESTASSERT(ret.second);
+      addrs[rnti] = &ret.first->second;
+    }
+  }
+  TESTASSERT(m.size() == addrs.size());
+  TESTASSERT(C::nof_objs == (int)addrs.size());
+  for (auto& p : addrs) {
+    TESTASSERT(&m.at(p.first) == p.second);
+  }
+
+  // Iteration visits every element once
+  size_t count = 0;
+  for (const auto& p : m) {
+    TESTASSERT(p.first == p.second.v);
+    count++;
+  }
+  TESTASSERT(count == m.size());
+
+  // Erasure while iterating
+  for (auto it = m.begin(); it != m.end();) {
+    if (it->first % 2 == 0) {
+      it = m.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (const auto& p : m) {
+    TESTASSERT(p.first % 2 == 1);
+  }
+  size_t nof_odd = 0;
+  for (auto& p : addrs) {
+    nof_odd += p.first % 2;
+  }
+  TESTASSERT(m.size() == nof_odd and C::nof_objs == (int)nof_odd);
+
+  // Move
+  rnti_map<C> m2 = std::move(m);
+  TESTASSERT(m.empty() and m2.size() == nof_odd);
+  m2.clear();
+  TESTASSERT(C::nof_objs == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+template <typename Map>
+double bench_lookups(Map& m, const std::vector<uint16_t>& rntis, uint32_t nof_ttis)
+{
+  uint64_t sum     = 0;
+  auto     t_start = std::chrono::high_resolution_clock::now();
+  for (uint32_t tti = 0; tti < nof_ttis; ++tti) {
+    // Several lookups per UE per TTI, as done by the PHY/MAC callbacks
+    for (uint16_t rnti : rntis) {
+      auto it = m.find(rnti);
+      if (it != m.end()) {
+        sum += it->second;
+      }
+    }
+  }
+  auto t_end = std::chrono::high_resolution_clock::now();
+  TESTASSERT(sum > 0);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count() / (double)nof_ttis;
+}
+
+int test_rnti_map_bench()
+{
+  const uint32_t nof_ttis = 2000;
+  for (uint32_t nof_ues : {100u, 500u, 1000u}) {
+    std::map<uint16_t, uint32_t> ref_map;
+    rnti_map<uint32_t>           map;
+    std::vector<uint16_t>        rntis;
+    for (uint32_t i = 0; i < nof_ues; ++i) {
+      uint16_t rnti = 0x46 + i;
+      rntis.push_back(rnti);
+      ref_map[rnti] = i + 1;
+      map[rnti]     = i + 1;
+    }
+    std::shuffle(rntis.begin(), rntis.end(), std::mt19937(nof_ues));
+
+    double t_ref = bench_lookups(ref_map, rntis, nof_ttis);
+    double t_new = bench_lookups(map, rntis, nof_ttis);
+    printf("nof_ues=%4d: std::map=%.1f usec/tti, rnti_map=%.1f usec/tti\n", nof_ues, t_ref / 1000, t_new / 1000);
+  }
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_rnti_map_basic() == SRSLTE_SUCCESS);
+  TESTASSERT(test_rnti_map_stable_addresses() == SRSLTE_SUCCESS);
+  TESTASSERT(test_rnti_map_bench() == SRSLTE_SUCCESS);
+  printf("Success\n");
+  return 0;
+}
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 
 #include "srslte/common/liblte_security.h"
+#include "srslte/common/security.h"
 #include "srslte/srslte.h"
 
 /*
@@ -446,6 +447,52 @@ void test_set_1_invalid()
   free(out);
 }
 
+// multi-buffer encryption must match the single PDU reference for every length and lane position
+void test_multi()
+{
+  const uint32_t nof_pdus = 3 * LIBLTE_SECURITY_MAX_LANES + 1;
+  const uint32_t max_len  = 200;
+
+  srslte::security_aes_key keys[2];
+  uint8_t                  raw_keys[2][16];
+  for (uint32_t k = 0; k < 2; k++) {
+    for (uint32_t i = 0; i < 16; i++) {
+      raw_keys[k][i] = (uint8_t)rand();
+    }
+    keys[k].set_key(raw_keys[k]);
+  }
+
+  srslte::security_pdu_t pdus[nof_pdus];
+  uint8_t                msgs[nof_pdus][max_len];
+  uint8_t                cts[nof_pdus][max_len];
+  for (uint32_t n = 0; n < nof_pdus; n++) {
+    pdus[n].key       = &keys[n % 2];
+    pdus[n].count     = (uint32_t)rand();
+    pdus[n].bearer    = n % 32;
+    pdus[n].direction = n % 2;
+    pdus[n].msg       = msgs[n];
+    pdus[n].msg_len   = 1 + (n * 7) % (max_len - 1);
+    pdus[n].out       = cts[n];
+    for (uint32_t i = 0; i < pdus[n].msg_len; i++) {
+      msgs[n][i] = (uint8_t)rand();
+    }
+  }
+
+  assert(srslte::security_128_eea2_multi(pdus, nof_pdus) == LIBLTE_SUCCESS);
+
+  for (uint32_t n = 0; n < nof_pdus; n++) {
+    uint8_t ct[max_len];
+    liblte_security_encryption_eea2(
+        raw_keys[n % 2], pdus[n].count, pdus[n].bearer, pdus[n].direction, msgs[n], pdus[n].msg_len * 8, ct);
+    assert(arrcmp(ct, cts[n], pdus[n].msg_len) == 0);
+
+    // single PDU with cached key schedule
+    srslte::security_128_eea2(
+        keys[n % 2], pdus[n].count, pdus[n].bearer, pdus[n].direction, msgs[n], pdus[n].msg_len, ct);
+    assert(arrcmp(ct, cts[n], pdus[n].msg_len) == 0);
+  }
+}
+
 /*
  * Functions
  */
@@ -460,4 +507,5 @@ int main(int argc, char* argv[])
   test_set_6();
   test_set_1_block_size();
   test_set_1_invalid();
+  test_multi();
 }
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srslte/common/liblte_security.h"
+#include "srslte/common/security.h"
+
+/*
+ * Tests
+ *
+ * Document Reference: 33.401 V13.1.0 Annex C.2
+ *
+ */
+
+void test_set_1()
+{
+  uint8_t  key[]     = {0xd3, 0xc5, 0xd5, 0x92, 0x32, 0x7f, 0xb1, 0x1c, 0x40, 0x35, 0xc6, 0x68, 0x0a, 0xf8, 0xc6, 0xd1};
+  uint32_t count     = 0x398a59b4;
+  uint8_t  bearer    = 0x1a;
+  uint8_t  direction = 1;
+  uint32_t len_bits = 64, len_bytes = (len_bits + 7) / 8;
+  uint8_t  msg[] = {0x48, 0x45, 0x83, 0xd5, 0xaf, 0xe0, 0x82, 0xae};
+  uint8_t  mt[]  = {0xb9, 0x37, 0x87, 0xe6};
+
+  uint8_t mac[4];
+
+  // gen mac
+  srslte::security_128_eia2(key, count, bearer, direction, msg, len_bytes, mac);
+  assert(memcmp(mac, mt, 4) == 0);
+
+  // gen mac with cached key schedule
+  srslte::security_aes_key aes_key;
+  aes_key.set_key(key);
+  memset(mac, 0, sizeof(mac));
+  srslte::security_128_eia2(aes_key, count, bearer, direction, msg, len_bytes, mac);
+  assert(memcmp(mac, mt, 4) == 0);
+}
+
+// multi-buffer MACs must match the single PDU reference for every length and lane position
+void test_multi()
+{
+  const uint32_t nof_pdus = 3 * LIBLTE_SECURITY_MAX_LANES + 1;
+  const uint32_t max_len  = 200;
+
+  srslte::security_aes_key keys[2];
+  uint8_t                  raw_keys[2][16];
+  for (uint32_t k = 0; k < 2; k++) {
+    for (uint32_t i = 0; i < 16; i++) {
+      raw_keys[k][i] = (uint8_t)rand();
+    }
+    keys[k].set_key(raw_keys[k]);
+  }
+
+  srslte::security_pdu_t pdus[nof_pdus];
+  uint8_t                msgs[nof_pdus][max_len];
+  uint8_t                macs[nof_pdus][4];
+  for (uint32_t n = 0; n < nof_pdus; n++) {
+    pdus[n].key       = &keys[n % 2];
+    pdus[n].count     = (uint32_t)rand();
+    pdus[n].bearer    = n % 32;
+    pdus[n].direction = n % 2;
+    pdus[n].msg       = msgs[n];
+    pdus[n].msg_len   = (n * 7) % max_len;
+    pdus[n].out       = macs[n];
+    for (uint32_t i = 0; i < pdus[n].msg_len; i++) {
+      msgs[n][i] = (uint8_t)rand();
+    }
+  }
+
+  assert(srslte::security_128_eia2_multi(pdus, nof_pdus) == LIBLTE_SUCCESS);
+
+  for (uint32_t n = 0; n < nof_pdus; n++) {
+    uint8_t mac[4];
+    srslte::security_128_eia2(
+        raw_keys[n % 2], pdus[n].count, pdus[n].bearer, pdus[n].direction, msgs[n], pdus[n].msg_len, mac);
+    assert(memcmp(mac, macs[n], 4) == 0);
+  }
+}
+
+/*
+ * Functions
+ */
+
+int main(int argc, char* argv[])
+{
+  test_set_1();
+  test_multi();
+}
@@ -22,8 +22,10 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "srslte/common/liblte_security.h"
+#include "srslte/common/security.h"
 
 /*
  * Prototypes
@@ -162,6 +164,72 @@ void test_set_2()
   return;
 }
 
+// Batched vectors must match the single vector functions for every lane position
+void test_multi()
+{
+  const uint32_t nof_vecs = 3 * LIBLTE_SECURITY_MAX_LANES + 1;
+
+  srslte::security_aes_key keys[2];
+  uint8_t                  raw_keys[2][16];
+  uint8_t                  opc[2][16];
+  for (uint32_t k = 0; k < 2; k++) {
+    for (uint32_t i = 0; i < 16; i++) {
+      raw_keys[k][i] = (uint8_t)rand();
+      opc[k][i]      = (uint8_t)rand();
+    }
+    keys[k].set_key(raw_keys[k]);
+  }
+
+  srslte::security_milenage_t vecs[nof_vecs];
+  uint8_t                     rands[nof_vecs][16];
+  uint8_t                     sqns[nof_vecs][6];
+  uint8_t                     amfs[nof_vecs][2];
+  uint8_t                     mac_a[nof_vecs][8];
+  uint8_t                     res[nof_vecs][8];
+  uint8_t                     ck[nof_vecs][16];
+  uint8_t                     ik[nof_vecs][16];
+  uint8_t                     ak[nof_vecs][6];
+  for (uint32_t n = 0; n < nof_vecs; n++) {
+    for (uint32_t i = 0; i < 16; i++) {
+      rands[n][i] = (uint8_t)rand();
+    }
+    for (uint32_t i = 0; i < 6; i++) {
+      sqns[n][i] = (uint8_t)rand();
+    }
+    amfs[n][0]    = (uint8_t)rand();
+    amfs[n][1]    = (uint8_t)rand();
+    vecs[n].key   = &keys[n % 2];
+    vecs[n].opc   = opc[n % 2];
+    vecs[n].rand  = rands[n];
+    vecs[n].sqn   = sqns[n];
+    vecs[n].amf   = amfs[n];
+    vecs[n].mac_a = mac_a[n];
+    vecs[n].res   = res[n];
+    vecs[n].ck    = ck[n];
+    vecs[n].ik    = ik[n];
+    vecs[n].ak    = ak[n];
+  }
+
+  assert(srslte::security_milenage_multi(vecs, nof_vecs) == LIBLTE_SUCCESS);
+
+  for (uint32_t n = 0; n < nof_vecs; n++) {
+    uint8_t mac_a_o[8];
+    uint8_t res_o[8];
+    uint8_t ck_o[16];
+    uint8_t ik_o[16];
+    uint8_t ak_o[6];
+    assert(liblte_security_milenage_f1(raw_keys[n % 2], opc[n % 2], rands[n], sqns[n], amfs[n], mac_a_o) ==
+           LIBLTE_SUCCESS);
+    assert(liblte_security_milenage_f2345(raw_keys[n % 2], opc[n % 2], rands[n], res_o, ck_o, ik_o, ak_o) ==
+           LIBLTE_SUCCESS);
+    assert(memcmp(mac_a_o, mac_a[n], 8) == 0);
+    assert(memcmp(res_o, res[n], 8) == 0);
+    assert(memcmp(ck_o, ck[n], 16) == 0);
+    assert(memcmp(ik_o, ik[n], 16) == 0);
+    assert(memcmp(ak_o, ak[n], 6) == 0);
+  }
+}
+
 /*
   Own test sets
 */
@@ -170,6 +238,7 @@ int main(int argc, char* argv[])
 {
 
   test_set_2();
+  test_multi();
   /*
   test_set_3();
   test_set_4();
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/test_common.h"
+#include "srslte/common/tti_deadline_tracker.h"
+#include <thread>
+#include <vector>
+
+using srslte::rt_metrics_t;
+using srslte::tti_deadline_tracker;
+
+int test_tracker_empty()
+{
+  tti_deadline_tracker tracker;
+  rt_metrics_t         m = {};
+
+  tracker.get_metrics(&m);
+  TESTASSERT(m.nof_tti == 0);
+  TESTASSERT(m.nof_late == 0);
+  TESTASSERT(m.tx.max_us == 0);
+
+  // Stages without a preceding RX stamp are ignored
+  tracker.worker_start(3);
+  tracker.worker_end(3);
+  tracker.tx_handoff(3);
+  tracker.get_metrics(&m);
+  TESTASSERT(m.nof_tti == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_tracker_deadline()
+{
+  tti_deadline_tracker tracker(std::chrono::microseconds{2000});
+  rt_metrics_t         m = {};
+
+  for (uint32_t tti = 0; tti < 10; tti++) {
+    tracker.rx_done(tti);
+    tracker.worker_start(tti);
+    if (tti == 9) {
+      std::this_thread::sleep_for(std::chrono::microseconds{2500});
+    }
+    tracker.worker_end(tti);
+    tracker.tx_handoff(tti);
+  }
+
+  tracker.get_metrics(&m);
+  TESTASSERT(m.nof_tti == 10);
+  TESTASSERT(m.nof_late == 1);
+  TESTASSERT(m.tx.max_us >= 2500);
+  TESTASSERT(m.proc.max_us >= 2500);
+  TESTASSERT(m.tx.p50_us < 2000);
+  TESTASSERT(m.tx.p50_us <= m.tx.p99_us);
+  TESTASSERT(m.tx.p99_us <= m.tx.max_us);
+
+  // Metrics are reset after being read
+  tracker.get_metrics(&m);
+  TESTASSERT(m.nof_tti == 0);
+  TESTASSERT(m.nof_late == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_tracker_concurrent()
+{
+  const uint32_t       nof_threads = 4, nof_tti_per_thread = 1000;
+  tti_deadline_tracker tracker;
+  rt_metrics_t         m = {};
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    threads.emplace_back([&tracker, i]() {
+      for (uint32_t n = 0; n < nof_tti_per_thread; n++) {
+        // Each thread owns its own slots of the TTI ring
+        uint32_t tti = (n * nof_threads + i) % TTIMOD_SZ;
+        tracker.rx_done(tti);
+        tracker.worker_start(tti);
+        tracker.worker_end(tti);
+        tracker.tx_handoff(tti);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  tracker.get_metrics(&m);
+  TESTASSERT(m.nof_tti == nof_threads * nof_tti_per_thread);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_tracker_empty() == SRSLTE_SUCCESS);
+  TESTASSERT(test_tracker_deadline() == SRSLTE_SUCCESS);
+  TESTASSERT(test_tracker_concurrent() == SRSLTE_SUCCESS);
+  return 0;
+}
@@ -44,6 +44,10 @@ static bool     print_dci_table;
 static uint32_t mcs                     = 20;
 static int      cross_carrier_indicator = -1;
 static bool     enable_256qam           = false;
+static bool     ifft_cache              = false;
+
+#define IFFT_CACHE_CHECK_NOF_SF 20
+#define IFFT_CACHE_BENCH_NOF_SF 1000
 
 void usage(char* prog)
 {
@@ -63,6 +67,8 @@ void usage(char* prog)
   }
   printf("\t-v [set srslte_verbose to debug, default none]\n");
   printf("\t-q Enable/Disable 256QAM modulation (default %s)\n", enable_256qam ? "enabled" : "disabled");
+  printf("\t-i Enable the eNb iFFT cache and check it on control-only subframes (default %s)\n",
+         ifft_cache ? "enabled" : "disabled");
 }
 
 void parse_extensive_param(char* param, char* arg)
@@ -93,7 +99,7 @@ void parse_args(int argc, char** argv)
     nof_rx_ant     = 2;
   }
 
-  while ((opt = getopt(argc, argv, "cfapndvqstm")) != -1) {
+  while ((opt = getopt(argc, argv, "cfapndvqstmi")) != -1) {
     switch (opt) {
       case 't':
         transmission_mode = (uint32_t)strtol(argv[optind], NULL, 10) - 1;
@@ -133,6 +139,9 @@ void parse_args(int argc, char** argv)
       case 'q':
         enable_256qam = (enable_256qam) ? false : true;
         break;
+      case 'i':
+        ifft_cache = true;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -191,6 +200,100 @@ quit:
   return ret;
 }
 
+// Subframes without PDSCH, every other one carries a PDCCH
+static int work_enb_ctrl(srslte_enb_dl_t*       enb_dl,
+                         uint32_t               tti,
+                         srslte_dci_cfg_t*      dci_cfg,
+                         srslte_dci_dl_t*       dci,
+                         srslte_dci_location_t* location)
+{
+  srslte_dl_sf_cfg_t dl_sf = {};
+  dl_sf.tti                = tti;
+  dl_sf.cfi                = cfi;
+  dl_sf.sf_type            = SRSLTE_SF_NORM;
+
+  srslte_enb_dl_put_base(enb_dl, &dl_sf);
+  if (tti % 2) {
+    dci->location = *location;
+    if (srslte_enb_dl_put_pdcch_dl(enb_dl, dci_cfg, dci)) {
+      ERROR("Error putting PDCCH sf_idx=%d\n", tti);
+      return SRSLTE_ERROR;
+    }
+  }
+  srslte_enb_dl_gen_signal(enb_dl);
+
+  return SRSLTE_SUCCESS;
+}
+
+static int test_ifft_cache(srslte_enb_dl_t*      enb_dl,
+                           cf_t*                 signal_buffer[SRSLTE_MAX_PORTS],
+                           srslte_dci_cfg_t*     dci_cfg,
+                           srslte_dci_dl_t*      dci,
+                           srslte_dci_location_t dci_locations[SRSLTE_NOF_SF_X_FRAME][MAX_CANDIDATES_UE])
+{
+  int            ret     = SRSLTE_ERROR;
+  uint32_t       sf_len  = SRSLTE_SF_LEN_PRB(cell.nof_prb);
+  cf_t*          ref     = srslte_vec_cf_malloc(sf_len * cell.nof_ports * IFFT_CACHE_CHECK_NOF_SF);
+  struct timeval t[3]    = {};
+  size_t         us[2]   = {};
+  float          max_err = 0.0f;
+
+  if (!ref) {
+    ERROR("Error allocating buffer\n");
+    return SRSLTE_ERROR;
+  }
+
+  // The cached symbols must produce the same signal than the regular iFFT, PBCH and PDCCH included
+  for (uint32_t enable = 0; enable < 2; enable++) {
+    srslte_enb_dl_set_ifft_cache(enb_dl, enable);
+    for (uint32_t tti = 0; tti < IFFT_CACHE_CHECK_NOF_SF; tti++) {
+      if (work_enb_ctrl(enb_dl, tti, dci_cfg, dci, &dci_locations[tti % 10][0])) {
+        goto clean_exit;
+      }
+      for (uint32_t p = 0; p < cell.nof_ports; p++) {
+        cf_t* ref_p = &ref[(tti * cell.nof_ports + p) * sf_len];
+        if (!enable) {
+          memcpy(ref_p, signal_buffer[p], sizeof(cf_t) * sf_len);
+        } else {
+          for (uint32_t i = 0; i < sf_len; i++) {
+            max_err = SRSLTE_MAX(max_err, cabsf(ref_p[i] - signal_buffer[p][i]));
+          }
+        }
+      }
+    }
+  }
+
+  for (uint32_t enable = 0; enable < 2; enable++) {
+    srslte_enb_dl_set_ifft_cache(enb_dl, enable);
+    gettimeofday(&t[1], NULL);
+    for (uint32_t tti = 0; tti < IFFT_CACHE_BENCH_NOF_SF; tti++) {
+      if (work_enb_ctrl(enb_dl, tti % 10240, dci_cfg, dci, &dci_locations[tti % 10][0])) {
+        goto clean_exit;
+      }
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    us[enable] = (size_t)(t[0].tv_sec * 1e6 + t[0].tv_usec);
+  }
+
+  printf("iFFT cache: max error %.2e; control-only subframe %.1f us without cache, %.1f us with cache\n",
+         max_err,
+         (float)us[0] / IFFT_CACHE_BENCH_NOF_SF,
+         (float)us[1] / IFFT_CACHE_BENCH_NOF_SF);
+
+  // Signal amplitude is around 0.05 / sqrt(nof_prb) per subcarrier, allow for the iFFT rounding only
+  if (max_err > 1e-4f) {
+    ERROR("The cached iFFT does not match the regular iFFT (max error %e)\n", max_err);
+    goto clean_exit;
+  }
+
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  free(ref);
+  return ret;
+}
+
 int work_ue(srslte_ue_dl_t*     ue_dl,
             srslte_dl_sf_cfg_t* sf_cfg_dl,
             srslte_ue_dl_cfg_t* ue_dl_cfg,
@@ -502,6 +605,12 @@ int main(int argc, char** argv)
     ERROR("Wrong transmission mode (%d)\n", transmission_mode);
   }
 
+  if (ifft_cache) {
+    if (test_ifft_cache(enb_dl, signal_buffer, &dci_cfg, &dci, dci_locations)) {
+      goto quit;
+    }
+  }
+
   /*
    * Loop
    */
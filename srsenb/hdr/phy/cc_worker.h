@@ -90,6 +90,11 @@ private:
 
   srslte_softbuffer_tx_t temp_mbsfn_softbuffer = {};
 
+  // PUSCH configuration and channel estimates of the grants decoded in the current subframe
+  std::array<srslte_pusch_cfg_t, stack_interface_phy_lte::MAX_GRANTS>    pusch_cfg       = {};
+  std::array<srslte_chest_ul_res_t, stack_interface_phy_lte::MAX_GRANTS> pusch_chest_res = {};
+  std::array<uint32_t, stack_interface_phy_lte::MAX_GRANTS>              pusch_grant_idx = {};
+
   // Class to store user information
   class ue
   {
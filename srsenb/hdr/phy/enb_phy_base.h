@@ -27,6 +27,7 @@
 #ifndef SRSENB_PHY_BASE_H
 #define SRSENB_PHY_BASE_H
 
+#include "srslte/common/tti_deadline_tracker.h"
 #include "srsue/hdr/phy/phy_metrics.h"
 
 namespace srsenb {
@@ -44,6 +45,8 @@ public:
   virtual void start_plot() = 0;
 
   virtual void get_metrics(phy_metrics_t* m) = 0;
+
+  virtual void get_rt_metrics(srslte::rt_metrics_t* m) = 0;
 };
 
 } // namespace srsenb
@@ -67,6 +67,7 @@ public:
   void complete_config_dedicated(uint16_t rnti) override;
 
   void get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS]) override;
+  void get_rt_metrics(srslte::rt_metrics_t* m) override;
 
   void radio_overflow() override{};
   void radio_failure() override{};
@@ -29,6 +29,7 @@
 #include "srslte/common/log.h"
 #include "srslte/common/thread_pool.h"
 #include "srslte/common/threads.h"
+#include "srslte/common/tti_deadline_tracker.h"
 #include "srslte/interfaces/enb_interfaces.h"
 #include "srslte/interfaces/enb_metrics_interface.h"
 #include "srslte/interfaces/radio_interfaces.h"
@@ -59,11 +60,21 @@ public:
    * Performs common end worker transmission tasks such as transmission and stack TTI execution
    *
    * @param tx_sem_id Semaphore identifier, the worker thread pointer is used
+   * @param tti TTI in which the worker samples were received
    * @param buffer baseband IQ sample buffer
    * @param nof_samples number of samples to transmit
    * @param tx_time timestamp to transmit samples
    */
-  void worker_end(void* tx_sem_id, srslte::rf_buffer_t& buffer, uint32_t nof_samples, srslte_timestamp_t tx_time);
+  void worker_end(void*                tx_sem_id,
+                  uint32_t             tti,
+                  srslte::rf_buffer_t& buffer,
+                  uint32_t             nof_samples,
+                  srslte_timestamp_t   tx_time);
+
+  /**
+   * Real-time deadline tracker, timestamped by the RX thread and by the PHY workers for every TTI
+   */
+  srslte::tti_deadline_tracker rt_tracker{std::chrono::milliseconds{FDD_HARQ_DELAY_UL_MS - 1}};
 
   // Common objects
   phy_args_t params = {};
@@ -49,6 +49,7 @@ struct phy_args_t {
   float       max_prach_offset_us = 10;
   int         pusch_max_its       = 10;
   bool        pusch_8bit_decoder  = false;
+  bool        dl_ifft_cache       = false;
   float       tx_amplitude        = 1.0f;
   int         nof_phy_threads     = 1;
   std::string equalizer_mode      = "mmse";
@@ -101,6 +101,7 @@ public:
   {
     mac.set_sched_dl_tti_mask(tti_mask, nof_sfs);
   }
+  void tti_done(uint32_t tti_rx) final { mac.tti_done(tti_rx); }
   // Radio-Link status
   void rl_failure(uint16_t rnti) final { mac.rl_failure(rnti); }
   void rl_ok(uint16_t rnti) final { mac.rl_ok(rnti); }
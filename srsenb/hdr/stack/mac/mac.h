@@ -26,6 +26,8 @@
 #include "scheduler_metric.h"
 #include "srslte/common/log.h"
 #include "srslte/common/mac_pcap.h"
+#include "srslte/common/rcu.h"
+#include "srslte/common/rnti_map.h"
 #include "srslte/common/threads.h"
 #include "srslte/common/tti_sync_cv.h"
 #include "srslte/interfaces/enb_interfaces.h"
@@ -34,6 +36,7 @@
 #include "srslte/interfaces/sched_interface.h"
 #include "ta.h"
 #include "ue.h"
+#include <atomic>
 #include <vector>
 
 namespace srsenb {
@@ -73,6 +76,7 @@ public:
   {
     scheduler.set_dl_tti_mask(tti_mask, nof_sfs);
   }
+  void tti_done(uint32_t tti_rx) override;
   void build_mch_sched(uint32_t tbs);
   void rl_failure(uint16_t rnti) override;
   void rl_ok(uint16_t rnti) override;
@@ -98,6 +102,8 @@ public:
   bool process_pdus();
 
   void get_metrics(mac_metrics_t metrics[ENB_METRICS_MAX_USERS]);
+  void get_sched_metrics(mac_sched_metrics_t& metrics) { scheduler.get_metrics(metrics); }
+  void get_softbuffer_pool_metrics(srslte_softbuffer_pool_metrics_t& rx, srslte_softbuffer_pool_metrics_t& tx);
   void
   write_mcch(asn1::rrc::sib_type2_s* sib2, asn1::rrc::sib_type13_r9_s* sib13, asn1::rrc::mcch_msg_s* mcch) override;
 
@@ -106,13 +112,10 @@ public:
 
 private:
   static const uint32_t cfi                      = 3;
+  static const uint32_t no_tti                   = UINT32_MAX;
 
   std::mutex rnti_mutex;
 
-  // We use a rwlock in MAC to allow multiple workers to access MAC simultaneously. No conflicts will happen since
-  // access for different TTIs
-  pthread_rwlock_t rwlock = {};
-
   // Interaction with PHY
   phy_interface_stack_lte* phy_h = nullptr;
   rlc_interface_mac*       rlc_h = nullptr;
@@ -134,9 +137,35 @@ private:
 
   sched_interface::dl_pdu_mch_t mch = {};
 
-  /* Map of active UEs */
-  std::map<uint16_t, std::unique_ptr<ue> > ue_db;
-  uint16_t                                 last_rnti = 0;
+  /* Code block buffers lent to the UE softbuffers while their TBs are in flight */
+  srslte_softbuffer_pool_t ue_rx_softbuffer_pool = {};
+  srslte_softbuffer_pool_t ue_tx_softbuffer_pool = {};
+
+  /* Map of active UEs. It is only modified by UE additions and removals, which serialize on ue_db_mutex and publish
+   * an immutable copy of it in ue_table. Every other access reads ue_table within an RCU read-side critical section,
+   * so the PHY workers never take a lock. Removed UEs and old copies are deleted once no reader can reference them.
+   * The PHY keeps using the softbuffers and PDU buffers of the grants after get_dl_sched()/get_ul_sched() return, so
+   * removed UEs are first parked in removed_ues, stamped with the last TTI whose grants may point to them, and only
+   * handed to ue_reclaimer once the PHY reports that TTI done.
+   */
+  typedef srslte::rnti_map<ue*> ue_table_t;
+
+  std::mutex                             ue_db_mutex;
+  srslte::rnti_map<std::unique_ptr<ue> > ue_db;
+  std::atomic<ue_table_t*>               ue_table{nullptr};
+  srslte::rcu_reclaimer                  ue_reclaimer;
+  std::vector<std::pair<ue*, uint32_t> > removed_ues;
+  std::atomic<uint32_t>                  last_sched_tti{no_tti}; ///< Latest TTI whose grants the PHY may still use
+  std::atomic<uint32_t>                  last_done_tti{no_tti};  ///< Latest TTI the PHY is done with
+  uint16_t                               last_rnti = 0;
+
+  ue_table_t* get_ue_table() { return ue_table.load(std::memory_order_acquire); }
+  ue*         get_ue(uint16_t rnti);
+  void        add_ue(uint16_t rnti, std::unique_ptr<ue> ue_ptr);
+  void        publish_ue_table();
+  void        retire_ue(std::unique_ptr<ue> ue_ptr);
+  void        reclaim_ues();
+  void        update_last_sched_tti(uint32_t tti_rx);
 
   uint8_t* assemble_rar(sched_interface::dl_sched_rar_grant_t* grants,
                         uint32_t                               nof_grants,
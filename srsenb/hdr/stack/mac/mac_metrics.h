@@ -43,6 +43,22 @@ struct mac_metrics_t {
   float    phr;
 };
 
+// Scheduler runtime of a phase of the TTI scheduling, since the previous metrics report
+
+struct mac_sched_phase_metrics_t {
+  uint32_t nof_samples;
+  float    avg_us;
+  float    max_us;
+};
+
+// Scheduler runtime metrics of all the carriers
+
+struct mac_sched_metrics_t {
+  enum phase_t { BC, RAR, DL_DATA, UL_DATA, PDCCH, TTI, NOF_PHASES };
+  mac_sched_phase_metrics_t phase[NOF_PHASES];
+  uint32_t                  nof_budget_overruns; ///< TTIs in which the scheduling time budget ran out
+};
+
 } // namespace srsenb
 
 #endif // SRSENB_MAC_METRICS_H
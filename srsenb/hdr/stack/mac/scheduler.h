@@ -23,11 +23,14 @@
 #define SRSENB_SCHEDULER_H
 
 #include "scheduler_grid.h"
+#include "mac_metrics.h"
 #include "scheduler_harq.h"
 #include "scheduler_ue.h"
 #include "srslte/common/log.h"
+#include "srslte/common/thread_pool.h"
 #include "srslte/interfaces/enb_interfaces.h"
 #include "srslte/interfaces/sched_interface.h"
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <pthread.h>
@@ -71,8 +74,8 @@ public:
   public:
     virtual ~metric_dl() = default;
     /* Virtual methods for user metric calculation */
-    virtual void set_params(const sched_cell_params_t& cell_params_)                          = 0;
-    virtual void sched_users(std::map<uint16_t, sched_ue>& ue_db, dl_sf_sched_itf* tti_sched) = 0;
+    virtual void set_params(const sched_cell_params_t& cell_params_)           = 0;
+    virtual void sched_users(sched_ue_list& ue_db, dl_sf_sched_itf* tti_sched) = 0;
   };
 
   class metric_ul
@@ -80,8 +83,8 @@ public:
   public:
     virtual ~metric_ul() = default;
     /* Virtual methods for user metric calculation */
-    virtual void set_params(const sched_cell_params_t& cell_params_)                          = 0;
-    virtual void sched_users(std::map<uint16_t, sched_ue>& ue_db, ul_sf_sched_itf* tti_sched) = 0;
+    virtual void set_params(const sched_cell_params_t& cell_params_)           = 0;
+    virtual void sched_users(sched_ue_list& ue_db, ul_sf_sched_itf* tti_sched) = 0;
   };
 
   /*************************************************************
@@ -125,6 +128,10 @@ public:
   int ul_phr(uint16_t rnti, int phr) final;
   int ul_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi, uint32_t ul_ch_code) final;
 
+  //! Whether the HARQ feedback ends its TB, i.e. it is an ACK or the NACK of the last retx. Call it before the feedback
+  bool dl_ack_ends_tb(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack);
+  bool ul_crc_ends_tb(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool crc);
+
   int dl_sched(uint32_t tti, uint32_t enb_cc_idx, dl_sched_res_t& sched_result) final;
   int ul_sched(uint32_t tti, uint32_t enb_cc_idx, ul_sched_res_t& sched_result) final;
 
@@ -134,25 +141,37 @@ public:
   void                                 tpc_inc(uint16_t rnti);
   void                                 tpc_dec(uint16_t rnti);
   std::array<int, SRSLTE_MAX_CARRIERS> get_enb_ue_cc_map(uint16_t rnti) final;
+  void                                 get_metrics(mac_sched_metrics_t& metrics);
+  //! Replaces the clock of the scheduling time budget, e.g. by a test clock
+  void                                 set_clock(const sched_clock_t& clock_);
+  uint32_t                             get_nof_workers() const;
 
   class carrier_sched;
 
 protected:
   // Helper methods
   template <typename Func>
-  int ue_db_access(uint16_t rnti, Func, const char* func_name = nullptr);
+  int                    ue_db_access(uint16_t rnti, Func, const char* func_name = nullptr);
+  const sf_sched_result& generate_tti_result(uint32_t tti_rx, uint32_t enb_cc_idx);
 
   // args
   srslte::log_ref                  log_h;
   rrc_interface_mac*               rrc       = nullptr;
   sched_args_t                     sched_cfg = {};
   std::vector<sched_cell_params_t> sched_cell_params;
+  sched_clock_t                    clock = std::chrono::steady_clock::now;
 
-  std::map<uint16_t, sched_ue> ue_db;
+  sched_ue_list ue_db;
 
   // independent schedulers for each carrier
   std::vector<std::unique_ptr<carrier_sched> > carrier_schedulers;
 
+  // workers allocating the carriers of a TTI in parallel with the calling thread
+  std::unique_ptr<srslte::task_thread_pool> workers;
+  std::mutex                                workers_mutex;
+  std::condition_variable                   workers_cvar;
+  uint32_t                                  workers_pending = 0;
+
   uint32_t   last_tti = 0;
   std::mutex sched_mutex;
   bool       configured = false;
@@ -23,22 +23,40 @@
 #define SRSLTE_SCHEDULER_CARRIER_H
 
 #include "scheduler.h"
+#include "srslte/common/time_prof.h"
 
 namespace srsenb {
 
 class bc_sched;
 class ra_sched;
 
+//! Accumulates the runtime of a scheduling phase until the next metrics report
+struct sched_phase_stats {
+  void operator()(std::chrono::nanoseconds duration);
+  //! Adds the accumulated runtime to the metrics of the other carriers and restarts the accumulation
+  void get_metrics(mac_sched_phase_metrics_t& metrics);
+
+  uint32_t                 nof_samples = 0;
+  std::chrono::nanoseconds total{0}, max{0};
+};
+
 class sched::carrier_sched
 {
 public:
-  explicit carrier_sched(rrc_interface_mac* rrc_, std::map<uint16_t, sched_ue>* ue_db_, uint32_t enb_cc_idx_);
+  explicit carrier_sched(rrc_interface_mac*   rrc_,
+                         sched_ue_list*       ue_db_,
+                         uint32_t             enb_cc_idx_,
+                         const sched_clock_t* clock_);
   ~carrier_sched();
   void                   reset();
   void                   carrier_cfg(const sched_cell_params_t& sched_params_);
   void                   set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs);
+  void                   fetch_bc_data(uint32_t tti_rx);
+  void                   alloc_tti(uint32_t tti_rx);
   const sf_sched_result& generate_tti_result(uint32_t tti_rx);
+  bool                   is_tti_generated(uint32_t tti_rx) const;
   int                    dl_rach_info(dl_sched_rar_info_t rar_info);
+  void                   get_metrics(mac_sched_metrics_t& metrics);
 
   // getters
   const ra_sched* get_ra_sched() const { return ra_sched_ptr.get(); }
@@ -55,13 +73,14 @@ private:
   sf_sched_result* get_next_sf_result(uint32_t tti_rx);
 
   // args
-  const sched_cell_params_t*    cc_cfg = nullptr;
-  srslte::log_ref               log_h;
-  rrc_interface_mac*            rrc   = nullptr;
-  std::map<uint16_t, sched_ue>* ue_db = nullptr;
-  std::unique_ptr<metric_dl>    dl_metric;
-  std::unique_ptr<metric_ul>    ul_metric;
-  const uint32_t                enb_cc_idx;
+  const sched_cell_params_t* cc_cfg = nullptr;
+  srslte::log_ref            log_h;
+  rrc_interface_mac*         rrc   = nullptr;
+  sched_ue_list*             ue_db = nullptr;
+  std::unique_ptr<metric_dl> dl_metric;
+  std::unique_ptr<metric_ul> ul_metric;
+  const uint32_t             enb_cc_idx;
+  const sched_clock_t*       clock = nullptr;
 
   // derived from args
   prbmask_t prach_mask;
@@ -75,6 +94,13 @@ private:
 
   std::unique_ptr<bc_sched> bc_sched_ptr;
   std::unique_ptr<ra_sched> ra_sched_ptr;
+
+  // runtime of each scheduling phase, always measured since it is reported in the metrics
+  std::array<srslte::tprof<sched_phase_stats, true>, mac_sched_metrics_t::NOF_PHASES> phase_tprof;
+
+  uint32_t nof_budget_overruns = 0; ///< TTIs in which the data allocations were cut short
+
+  int alloc_tti_rx = -1; ///< last TTI whose resources were allocated
 };
 
 //! Broadcast (SIB + paging) scheduler
@@ -82,6 +108,7 @@ class bc_sched
 {
 public:
   explicit bc_sched(const sched_cell_params_t& cfg_, rrc_interface_mac* rrc_);
+  void fetch_paging(uint32_t tti_tx_dl);
   void dl_sched(sf_sched* tti_sched);
   void reset();
 
@@ -103,8 +130,9 @@ private:
   std::array<sched_sib_t, sched_interface::MAX_SIBS> pending_sibs;
 
   // TTI specific
-  uint32_t current_tti   = 0;
-  uint32_t bc_aggr_level = 2;
+  uint32_t current_tti    = 0;
+  uint32_t bc_aggr_level  = 2;
+  uint32_t paging_payload = 0; ///< paging fetched from the RRC for current_tti
 };
 
 //! RAR/Msg3 scheduler
@@ -115,7 +143,7 @@ public:
   using dl_sched_rar_t       = sched_interface::dl_sched_rar_t;
   using dl_sched_rar_grant_t = sched_interface::dl_sched_rar_grant_t;
 
-  explicit ra_sched(const sched_cell_params_t& cfg_, std::map<uint16_t, sched_ue>& ue_db_);
+  explicit ra_sched(const sched_cell_params_t& cfg_, sched_ue_list& ue_db_);
   void dl_sched(sf_sched* tti_sched);
   void ul_sched(sf_sched* sf_dl_sched, sf_sched* sf_msg3_sched);
   int  dl_rach_info(dl_sched_rar_info_t rar_info);
@@ -123,9 +151,9 @@ public:
 
 private:
   // args
-  srslte::log_ref               log_h;
-  const sched_cell_params_t*    cc_cfg = nullptr;
-  std::map<uint16_t, sched_ue>* ue_db  = nullptr;
+  srslte::log_ref            log_h;
+  const sched_cell_params_t* cc_cfg = nullptr;
+  sched_ue_list*             ue_db  = nullptr;
 
   std::deque<sf_sched::pending_rar_t> pending_rars;
   uint32_t                            rar_aggr_level = 2;
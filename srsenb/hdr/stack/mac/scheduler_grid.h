@@ -26,7 +26,9 @@
 #include "scheduler_ue.h"
 #include "srslte/common/bounded_bitset.h"
 #include "srslte/common/log.h"
+#include <chrono>
 #include <deque>
+#include <functional>
 #include <vector>
 
 namespace srsenb {
@@ -102,6 +104,14 @@ private:
     uint32_t     aggr_idx;
     alloc_type_t alloc_type;
   };
+  //! Candidate CCE positions of one DCI, used by the bounded search
+  struct dci_candidates_t {
+    uint32_t     record_idx;
+    uint32_t     nof_cands;
+    uint32_t     chosen;
+    uint32_t     ncce[6];
+    pdcch_mask_t mask[6];
+  };
 
   const alloc_tree_t&    get_alloc_tree() const { return alloc_trees[current_cfix]; }
   const sched_dci_cce_t* get_cce_loc_table(alloc_type_t alloc_type, sched_ue* user, uint32_t cfix) const;
@@ -113,6 +123,9 @@ private:
                                    const alloc_record_t&  dci_record,
                                    const sched_dci_cce_t& dci_locs,
                                    uint32_t               tti_tx_dl);
+  bool        alloc_dci_record_bounded(const alloc_record_t& record, uint32_t cfix);
+  void        set_dci_candidates(dci_candidates_t& cands, const alloc_record_t& record, uint32_t cfix) const;
+  bool        search_dci_positions(size_t nof_cces);
 
   // consts
   const sched_cell_params_t* cc_cfg = nullptr;
@@ -123,6 +136,11 @@ private:
   uint32_t                    current_cfix = 0;
   std::vector<alloc_tree_t>   alloc_trees;     ///< List of PDCCH alloc trees, where index is the cfi index
   std::vector<alloc_record_t> dci_record_list; ///< Keeps a record of all the PDCCH allocations done so far
+
+  // bounded search scratch space
+  std::vector<dci_candidates_t> search_cands;
+  std::vector<uint32_t>         search_cursor;
+  std::vector<pdcch_mask_t>     search_masks;
 };
 
 //! manages a subframe grid resources, namely CCE and DL/UL RB allocations
@@ -168,6 +186,9 @@ private:
   prbmask_t ul_mask   = {};
 };
 
+//! Clock of the per-TTI scheduling time budget
+using sched_clock_t = std::function<std::chrono::steady_clock::time_point()>;
+
 //! generic interface used by DL scheduler algorithm
 class dl_sf_sched_itf
 {
@@ -177,6 +198,7 @@ public:
   virtual uint32_t         get_tti_tx_dl() const                                                   = 0;
   virtual uint32_t         get_nof_ctrl_symbols() const                                            = 0;
   virtual bool             is_dl_alloc(sched_ue* user) const                                       = 0;
+  virtual bool             is_out_of_time()                                                        = 0;
 };
 
 //! generic interface used by UL scheduler algorithm
@@ -187,6 +209,7 @@ public:
   virtual const prbmask_t& get_ul_mask() const                                           = 0;
   virtual uint32_t         get_tti_tx_ul() const                                         = 0;
   virtual bool             is_ul_alloc(sched_ue* user) const                             = 0;
+  virtual bool             is_out_of_time()                                              = 0;
 };
 
 /** Description: Stores the RAR, broadcast, paging, DL data, UL data allocations for the given subframe
@@ -279,6 +302,11 @@ public:
   const prbmask_t& get_ul_mask() const final { return tti_alloc.get_ul_mask(); }
   uint32_t         get_tti_tx_ul() const final { return tti_params.tti_tx_ul; }
 
+  // time budget of the data allocations
+  void set_deadline(std::chrono::steady_clock::time_point deadline_, const sched_clock_t* clock_);
+  bool is_out_of_time() final;
+  bool is_budget_exceeded() const { return budget_exceeded; }
+
   // getters
   uint32_t            get_tti_rx() const { return tti_params.tti_rx; }
   const tti_params_t& get_tti_params() const { return tti_params; }
@@ -311,6 +339,12 @@ private:
   std::vector<ul_alloc_t>  ul_data_allocs;
   uint32_t                 last_msg3_prb = 0, max_msg3_prb = 0;
 
+  // time budget
+  std::chrono::steady_clock::time_point deadline;
+  const sched_clock_t*                  clock           = nullptr;
+  bool                                  has_deadline    = false;
+  bool                                  budget_exceeded = false;
+
   // Next TTI state
   tti_params_t tti_params{10241};
 };
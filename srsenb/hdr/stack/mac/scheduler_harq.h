@@ -39,6 +39,7 @@ public:
   uint32_t get_id() const;
   bool     is_empty() const;
   bool     is_empty(uint32_t tb_idx) const;
+  bool     ack_ends_tb(uint32_t tb_idx, bool ack) const;
 
   uint32_t          nof_tx(uint32_t tb_idx) const;
   uint32_t          nof_retx(uint32_t tb_idx) const;
@@ -158,6 +159,15 @@ public:
    */
   std::pair<uint32_t, int> set_ack_info(uint32_t tti_rx, uint32_t tb_idx, bool ack);
 
+  /**
+   * Check whether a DL HARQ feedback ends the TB, as an ACK or as the NACK of its last retx
+   * @param tti_rx tti the DL ACK is received
+   * @param tb_idx TB index for the given ACK
+   * @param ack true for ACK and false for NACK
+   * @return true if the DL harq will release the TB once it gets the feedback
+   */
+  bool dl_ack_ends_tb(uint32_t tti_rx, uint32_t tb_idx, bool ack) const;
+
   //! Get UL Harq for a given tti_tx_ul
   ul_harq_proc* get_ul_harq(uint32_t tti_tx_ul);
 
@@ -166,6 +176,9 @@ public:
    */
   std::pair<bool, uint32_t> set_ul_crc(srslte::tti_point tti_tx_ul, uint32_t tb_idx, bool ack_);
 
+  //! Check whether a UL CRC ends the TB, as a CRC OK or as the failed CRC of its last retx
+  bool ul_crc_ends_tb(srslte::tti_point tti_rx, bool ack_) const;
+
   //! Resets pending harq ACKs and cleans UL Harqs with maxretx == 0
   void reset_pending_data(uint32_t tti_rx);
 
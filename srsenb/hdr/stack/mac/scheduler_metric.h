@@ -32,11 +32,11 @@ class dl_metric_rr : public sched::metric_dl
 
 public:
   void set_params(const sched_cell_params_t& cell_params_) final;
-  void sched_users(std::map<uint16_t, sched_ue>& ue_db, dl_sf_sched_itf* tti_sched) final;
+  void sched_users(sched_ue_list& ue_db, dl_sf_sched_itf* tti_sched) final;
 
 private:
   bool          find_allocation(uint32_t min_nof_rbg, uint32_t max_nof_rbg, rbgmask_t* rbgmask);
-  dl_harq_proc* allocate_user(sched_ue* user);
+  dl_harq_proc* allocate_user(sched_ue* user, bool retx_only);
 
   const sched_cell_params_t* cc_cfg = nullptr;
   srslte::log_ref            log_h;
@@ -47,7 +47,7 @@ class ul_metric_rr : public sched::metric_ul
 {
 public:
   void set_params(const sched_cell_params_t& cell_params_) final;
-  void sched_users(std::map<uint16_t, sched_ue>& ue_db, ul_sf_sched_itf* tti_sched) final;
+  void sched_users(sched_ue_list& ue_db, ul_sf_sched_itf* tti_sched) final;
 
 private:
   bool          find_allocation(uint32_t L, ul_harq_proc::ul_alloc_t* alloc);
@@ -24,6 +24,7 @@
 
 #include "scheduler_common.h"
 #include "srslte/common/log.h"
+#include "srslte/common/rnti_map.h"
 #include "srslte/mac/pdu.h"
 #include <map>
 #include <vector>
@@ -48,10 +49,13 @@ struct sched_ue_carrier {
   int                        alloc_tbs_dl(uint32_t nof_prb, uint32_t nof_re, uint32_t req_bytes, int* mcs);
   int                        alloc_tbs_ul(uint32_t nof_prb, uint32_t nof_re, uint32_t req_bytes, int* mcs);
   int                        get_required_prb_dl(uint32_t req_bytes, uint32_t nof_ctrl_symbols);
+  int                        get_dl_tbs_estimate(uint32_t nof_prb, uint32_t nof_ctrl_symbols);
+  int                        get_ul_tbs_estimate(uint32_t nof_prb);
   uint32_t                   get_required_prb_ul(uint32_t req_bytes);
   const sched_cell_params_t* get_cell_cfg() const { return cell_params; }
   bool                       is_active() const { return active; }
   void                       set_dl_cqi(uint32_t tti_tx_dl, uint32_t dl_cqi);
+  sched_dci_cce_t*           get_locations(uint32_t cfi, uint32_t sf_idx);
 
   harq_entity harq_ent;
 
@@ -69,10 +73,12 @@ struct sched_ue_carrier {
   uint32_t max_aggr_level = 3;
   int      fixed_mcs_ul = 0, fixed_mcs_dl = 0;
 
-  // Allowed DCI locations per per CFI and per subframe
-  std::array<std::array<sched_dci_cce_t, 10>, 3> dci_locations = {};
-
 private:
+  // Allowed DCI locations per CFI of the last subframe they were requested for. They are derived from the search space
+  // table shared with the PHY when the subframe changes, instead of keeping the 3x10 combinations of every UE.
+  std::array<sched_dci_cce_t, 3> dci_locations = {};
+  std::array<uint32_t, 3>        dci_locations_sf{{SRSLTE_NOF_SF_X_FRAME, SRSLTE_NOF_SF_X_FRAME, SRSLTE_NOF_SF_X_FRAME}};
+
   // config
   srslte::log_ref                  log_h;
   const sched_interface::ue_cfg_t* cfg         = nullptr;
@@ -114,6 +120,8 @@ public:
   void set_dl_cqi(uint32_t tti, uint32_t enb_cc_idx, uint32_t cqi);
   int  set_ack_info(uint32_t tti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack);
   void set_ul_crc(srslte::tti_point tti_rx, uint32_t enb_cc_idx, bool crc_res);
+  bool dl_ack_ends_tb(uint32_t tti_rx, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack) const;
+  bool ul_crc_ends_tb(srslte::tti_point tti_rx, uint32_t enb_cc_idx, bool crc_res) const;
 
   /*******************************************************
    * Custom functions
@@ -140,6 +148,7 @@ public:
   uint32_t                      get_pending_ul_new_data(uint32_t tti);
   uint32_t                      get_pending_ul_old_data(uint32_t cc_idx);
   uint32_t                      get_pending_dl_new_data_total();
+  uint32_t                      get_ul_new_data_share(uint32_t tti, uint32_t ue_cc_idx);
 
   dl_harq_proc* get_pending_dl_harq(uint32_t tti_tx_dl, uint32_t cc_idx);
   dl_harq_proc* get_empty_dl_harq(uint32_t tti_tx_dl, uint32_t cc_idx);
@@ -226,6 +235,10 @@ private:
   uint32_t get_pending_ul_old_data_unlocked(uint32_t cc_idx);
   uint32_t get_pending_ul_new_data_unlocked(uint32_t tti);
 
+  // split of the pending new data among the carriers of a TTI
+  static const uint32_t min_new_data_share = 100;
+  uint32_t              get_new_data_share(uint32_t ue_cc_idx, uint32_t pending_bytes) const;
+
   bool needs_cqi_unlocked(uint32_t tti, uint32_t cc_idx, bool will_send = false);
 
   int generate_format1(uint32_t                          pid,
@@ -274,7 +287,14 @@ private:
   // Control Element Command queue
   using ce_cmd = srslte::dl_sch_lcid;
   std::deque<ce_cmd> pending_ces;
+
+  // DL new data already sent by the carriers of the TTI whose results were generated
+  uint32_t dl_new_data_tti  = UINT32_MAX;
+  uint32_t dl_new_data_sent = 0;
 };
+
+using sched_ue_list = srslte::rnti_map<sched_ue>;
+
 } // namespace srsenb
 
 #endif // SRSENB_SCHEDULER_UE_H
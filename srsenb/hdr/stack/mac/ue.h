@@ -31,6 +31,7 @@
 #include "srslte/mac/pdu.h"
 #include "srslte/mac/pdu_queue.h"
 #include "ta.h"
+#include <atomic>
 #include <pthread.h>
 #include <vector>
 
@@ -39,16 +40,18 @@ namespace srsenb {
 class ue : public srslte::read_pdu_interface, public srslte::pdu_queue::process_callback, public mac_ta_ue_interface
 {
 public:
-  ue(uint16_t                 rnti,
-     uint32_t                 nof_prb,
-     sched_interface*         sched,
-     rrc_interface_mac*       rrc_,
-     rlc_interface_mac*       rlc,
-     phy_interface_stack_lte* phy_,
-     srslte::log_ref          log_,
-     uint32_t                 nof_cells_,
-     uint32_t                 nof_rx_harq_proc = SRSLTE_FDD_NOF_HARQ,
-     uint32_t                 nof_tx_harq_proc = SRSLTE_FDD_NOF_HARQ * SRSLTE_MAX_TB);
+  ue(uint16_t                  rnti,
+     uint32_t                  nof_prb,
+     sched_interface*          sched,
+     rrc_interface_mac*        rrc_,
+     rlc_interface_mac*        rlc,
+     phy_interface_stack_lte*  phy_,
+     srslte::log_ref           log_,
+     uint32_t                  nof_cells_,
+     srslte_softbuffer_pool_t* rx_pool_         = nullptr,
+     srslte_softbuffer_pool_t* tx_pool_         = nullptr,
+     uint32_t                  nof_rx_harq_proc = SRSLTE_FDD_NOF_HARQ,
+     uint32_t                  nof_tx_harq_proc = SRSLTE_FDD_NOF_HARQ * SRSLTE_MAX_TB);
   virtual ~ue();
 
   void reset();
@@ -72,10 +75,17 @@ public:
   uint8_t*
   generate_mch_pdu(uint32_t harq_pid, sched_interface::dl_pdu_mch_t sched, uint32_t nof_pdu_elems, uint32_t grant_size);
 
-  srslte_softbuffer_tx_t*
-                          get_tx_softbuffer(const uint32_t ue_cc_idx, const uint32_t harq_process, const uint32_t tb_idx);
+  // The transmission TTI identifies the softbuffer whose HARQ ACK releases it when the softbuffers are pooled
+  srslte_softbuffer_tx_t* get_tx_softbuffer(const uint32_t ue_cc_idx,
+                                            const uint32_t harq_process,
+                                            const uint32_t tb_idx,
+                                            const uint32_t tti_tx_dl);
   srslte_softbuffer_rx_t* get_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti);
 
+  // Give the code block buffers of a pooled softbuffer back once its TB has been acknowledged, decoded or dropped
+  void release_tx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti_ack, const uint32_t tb_idx);
+  void release_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti_rx);
+
   bool     process_pdus();
   uint8_t* request_buffer(const uint32_t ue_cc_idx, const uint32_t tti, const uint32_t len);
   void     process_pdu(uint8_t* pdu, uint32_t nof_bytes, srslte::pdu_queue::channel_t channel) override;
@@ -125,12 +135,18 @@ private:
 
   typedef std::vector<srslte_softbuffer_tx_t>
                                        cc_softbuffer_tx_list_t; ///< List of Tx softbuffers for all HARQ processes of one carrier
+  typedef std::vector<std::atomic<uint32_t> >
+                                       cc_tti_list_t;           ///< List of Tx softbuffer TTIs of one carrier
   std::vector<cc_softbuffer_tx_list_t> softbuffer_tx;           ///< List of softbuffer lists for Tx
+  std::vector<cc_tti_list_t>           softbuffer_tx_tti;       ///< Last transmission TTI of each Tx softbuffer
 
   typedef std::vector<srslte_softbuffer_rx_t>
                                        cc_softbuffer_rx_list_t; ///< List of Rx softbuffers for all HARQ processes of one carrier
   std::vector<cc_softbuffer_rx_list_t> softbuffer_rx;           ///< List of softbuffer lists for Rx
 
+  srslte_softbuffer_pool_t* rx_pool = nullptr; ///< Softbuffers borrow their code block buffers from the MAC if set
+  srslte_softbuffer_pool_t* tx_pool = nullptr;
+
   typedef std::vector<uint8_t*> cc_buffer_ptr_t; ///< List of buffer pointers for RX HARQ processes of one carrier
   std::vector<cc_buffer_ptr_t>  pending_buffers; ///< List of buffer pointer list for Rx
 
@@ -24,11 +24,13 @@
 
 #include "rrc_cell_cfg.h"
 #include "rrc_metrics.h"
+#include "rrc_paging.h"
 #include "srsenb/hdr/stack/upper/common_enb.h"
 #include "srslte/common/block_queue.h"
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/common.h"
 #include "srslte/common/logmap.h"
+#include "srslte/common/rnti_map.h"
 #include "srslte/common/stack_procedure.h"
 #include "srslte/common/timeout.h"
 #include "srslte/interfaces/enb_interfaces.h"
@@ -288,8 +290,8 @@ private:
 
   // state
   std::unique_ptr<freq_res_common_list>          pucch_res_list;
-  std::map<uint16_t, std::unique_ptr<ue> >       users; // NOTE: has to have fixed addr
-  std::map<uint32_t, asn1::rrc::paging_record_s> pending_paging;
+  srslte::rnti_map<std::unique_ptr<ue> >         users; // NOTE: has to have fixed addr
+  std::unique_ptr<paging_manager>                pending_paging;
 
   void     process_release_complete(uint16_t rnti);
   void     process_rl_failure(uint16_t rnti);
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_RRC_PAGING_H
+#define SRSLTE_RRC_PAGING_H
+
+#include "srslte/asn1/rrc_asn1.h"
+#include "srslte/asn1/s1ap_asn1.h"
+#include "srslte/common/logmap.h"
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace srsenb {
+
+/// Converts the UE Paging Identity of an S1AP Paging message to a PCCH paging record
+asn1::rrc::paging_record_s make_paging_record(const asn1::s1ap::ue_paging_id_c& ue_paging_id);
+
+/**
+ * Pending paging records of the cell, bucketed by paging occasion (Section 7 of 36.304).
+ * Records are added to the PCCH message of their occasion as the S1AP Paging messages arrive. Each record is packed
+ * once and its bits appended to the PDU of the message, of which only the record count is rewritten, so that a paging
+ * occasion just hands over an already packed PDU. An occasion with more than ASN1_RRC_MAX_PAGE_REC records keeps the
+ * remaining ones in further PCCH messages, sent in the next paging cycles.
+ */
+class paging_manager
+{
+public:
+  struct pcch_pdu_t {
+    asn1::rrc::pcch_msg_s msg;
+    std::vector<uint8_t>  pdu;
+    uint32_t              nof_bits = 0;
+    std::vector<uint32_t> ueids;
+  };
+
+  /// T is the default paging cycle in radio frames and Nb the number of paging occasions per cycle (nB of SIB2)
+  paging_manager(uint32_t T_, uint32_t Nb_);
+
+  /// Queues a paging record in the PCCH message of its paging occasion. Returns false if the UE is already paged
+  bool add_paging_record(uint32_t ueid, const asn1::rrc::paging_record_s& rec);
+
+  /// Returns the PCCH message to transmit in the given TTI, or nullptr if it is not a pending paging occasion
+  const pcch_pdu_t* get_pcch(uint32_t tti) const;
+
+  /// Removes the PCCH message of the given TTI, once transmitted
+  void pop_pcch(uint32_t tti);
+
+  /// Subframe index of the paging occasion of a UE, or -1 if the configuration does not define one
+  int get_paging_occasion(uint32_t ueid, uint32_t* pf_offset) const;
+
+  bool   empty() const { return pending_ueids.empty(); }
+  size_t nof_pending_records() const { return pending_ueids.size(); }
+
+private:
+  uint32_t tti_to_occasion(uint32_t tti) const { return ((tti / 10) % T) * 10 + tti % 10; }
+
+  uint32_t T, N, Ns;
+
+  // PCCH message fields that precede the paging records, the last ones being the record count
+  std::vector<uint8_t> pcch_hdr;
+  uint32_t             pcch_hdr_bits = 0;
+
+  std::map<uint32_t, std::deque<pcch_pdu_t> > occasions; // keyed by (SFN mod T) * 10 + subframe index
+  std::set<uint32_t>                          pending_ueids;
+  srslte::log_ref                             log_h{"RRC"};
+};
+
+} // namespace srsenb
+
+#endif // SRSLTE_RRC_PAGING_H
@@ -25,6 +25,7 @@
 #include "common_enb.h"
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/logmap.h"
+#include "srslte/common/rnti_map.h"
 #include "srslte/common/threads.h"
 #include "srslte/interfaces/enb_interfaces.h"
 #include "srslte/srslte.h"
@@ -103,7 +104,7 @@ private:
     uint32_t teids_out[SRSENB_N_RADIO_BEARERS];
     uint32_t spgw_addrs[SRSENB_N_RADIO_BEARERS];
   } bearer_map;
-  std::map<uint16_t, bearer_map> rnti_bearers;
+  srslte::rnti_map<bearer_map> rnti_bearers;
 
   // Socket file descriptor
   int fd = -1;
@@ -19,6 +19,7 @@
  *
  */
 
+#include "srslte/common/rnti_map.h"
 #include "srslte/common/timers.h"
 #include "srslte/interfaces/enb_interfaces.h"
 #include "srslte/interfaces/ue_interfaces.h"
@@ -101,7 +102,7 @@ private:
 
   void clear_user(user_interface* ue);
 
-  std::map<uint32_t, user_interface> users;
+  srslte::rnti_map<user_interface> users;
 
   rlc_interface_pdcp*             rlc;
   rrc_interface_pdcp*             rrc;
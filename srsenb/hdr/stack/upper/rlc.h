@@ -19,6 +19,7 @@
  *
  */
 
+#include "srslte/common/rnti_map.h"
 #include "srslte/interfaces/enb_interfaces.h"
 #include "srslte/interfaces/ue_interfaces.h"
 #include "srslte/upper/rlc.h"
@@ -88,8 +89,8 @@ private:
 
   pthread_rwlock_t rwlock;
 
-  std::map<uint32_t, user_interface> users;
-  std::vector<mch_service_t>         mch_services;
+  srslte::rnti_map<user_interface> users;
+  std::vector<mch_service_t>       mch_services;
 
   mac_interface_rlc*        mac;
   pdcp_interface_rlc*       pdcp;
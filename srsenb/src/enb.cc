@@ -148,6 +148,7 @@ bool enb::get_metrics(enb_metrics_t* m)
 {
   radio->get_metrics(&m->rf);
   phy->get_metrics(m->phy);
+  phy->get_rt_metrics(&m->phy_rt);
   stack->get_metrics(&m->stack);
   m->running = started;
   return true;
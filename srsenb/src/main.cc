@@ -91,6 +91,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("rf.device_name",       bpo::value<string>(&args->rf.device_name)->default_value("auto"),       "Front-end device name")
     ("rf.device_args",       bpo::value<string>(&args->rf.device_args)->default_value("auto"),       "Front-end device arguments")
     ("rf.time_adv_nsamples", bpo::value<string>(&args->rf.time_adv_nsamples)->default_value("auto"), "Transmission time advance")
+    ("rf.srate",             bpo::value<float>(&args->rf.srate_hz)->default_value(0),                "Front-end sampling rate, scaled by powers of two and resampled to the cell rate (0 disables)")
 
     ("gui.enable",        bpo::value<bool>(&args->gui.enable)->default_value(false),          "Enable GUI plots")
 
@@ -134,6 +135,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("scheduler.max_aggr_level", bpo::value<int>(&args->stack.mac.sched.max_aggr_level)->default_value(-1), "Optional maximum aggregation level index (l=log2(L)) ")
     ("scheduler.max_nof_ctrl_symbols", bpo::value<uint32_t>(&args->stack.mac.sched.max_nof_ctrl_symbols)->default_value(3), "Number of control symbols")
     ("scheduler.min_nof_ctrl_symbols", bpo::value<uint32_t>(&args->stack.mac.sched.min_nof_ctrl_symbols)->default_value(1), "Minimum number of control symbols")
+    ("scheduler.pdcch_max_search_nodes", bpo::value<uint32_t>(&args->stack.mac.sched.pdcch_max_search_nodes)->default_value(0), "CCE placements tried per DCI by the bounded PDCCH allocator (0 keeps the exhaustive allocation tree)")
+    ("scheduler.max_sched_time_us", bpo::value<uint32_t>(&args->stack.mac.sched.max_sched_time_us)->default_value(0), "Time budget in microseconds after which the scheduler stops allocating further UEs in a TTI (0 disables it)")
+    ("scheduler.nof_workers", bpo::value<uint32_t>(&args->stack.mac.sched.nof_sched_workers)->default_value(0), "Number of threads allocating the carriers of a TTI in parallel (0 schedules the carriers serially)")
 
     /* Downlink Channel emulator section */
     ("channel.dl.enable", bpo::value<bool>(&args->phy.dl_channel_args.enable)->default_value(false), "Enable/Disable internal Downlink channel emulator")
@@ -153,6 +157,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("channel.dl.hst.period_s", bpo::value<float>(&args->phy.dl_channel_args.hst_period_s)->default_value(7.2f), "HST simulation period in seconds")
     ("channel.dl.hst.fd_hz", bpo::value<float>(&args->phy.dl_channel_args.hst_fd_hz)->default_value(+750.0f), "Doppler frequency in Hz")
     ("channel.dl.hst.init_time_s", bpo::value<float>(&args->phy.dl_channel_args.hst_init_time_s)->default_value(0), "Initial time in seconds")
+    ("channel.dl.nof_workers", bpo::value<uint32_t>(&args->phy.dl_channel_args.nof_workers)->default_value(0), "Threads emulating the RF channels in parallel, 0 emulates them serially")
 
     /* Uplink Channel emulator section */
     ("channel.ul.enable", bpo::value<bool>(&args->phy.ul_channel_args.enable)->default_value(false), "Enable/Disable internal Uplink channel emulator")
@@ -172,6 +177,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("channel.ul.hst.period_s", bpo::value<float>(&args->phy.ul_channel_args.hst_period_s)->default_value(7.2f), "HST simulation period in seconds")
     ("channel.ul.hst.fd_hz", bpo::value<float>(&args->phy.ul_channel_args.hst_fd_hz)->default_value(-750.0f), "Doppler frequency in Hz")
     ("channel.ul.hst.init_time_s", bpo::value<float>(&args->phy.ul_channel_args.hst_init_time_s)->default_value(0), "Initial time in seconds")
+    ("channel.ul.nof_workers", bpo::value<uint32_t>(&args->phy.ul_channel_args.nof_workers)->default_value(0), "Threads emulating the RF channels in parallel, 0 emulates them serially")
 
       /* Expert section */
     ("expert.metrics_period_secs", bpo::value<float>(&args->general.metrics_period_secs)->default_value(1.0), "Periodicity for metrics in seconds")
@@ -179,6 +185,7 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.metrics_csv_filename", bpo::value<string>(&args->general.metrics_csv_filename)->default_value("/tmp/enb_metrics.csv"), "Metrics CSV filename")
     ("expert.pusch_max_its", bpo::value<int>(&args->phy.pusch_max_its)->default_value(8), "Maximum number of turbo decoder iterations")
     ("expert.pusch_8bit_decoder", bpo::value<bool>(&args->phy.pusch_8bit_decoder)->default_value(false), "Use 8-bit for LLR representation and turbo decoder trellis computation (Experimental)")
+    ("expert.dl_ifft_cache", bpo::value<bool>(&args->phy.dl_ifft_cache)->default_value(false), "Reuse the precomputed time-domain symbols of the downlink subframes that carry no channel")
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor")
     ("expert.nof_phy_threads", bpo::value<int>(&args->phy.nof_phy_threads)->default_value(3), "Number of PHY threads")
@@ -63,7 +63,9 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
 {
   if (file.is_open() && enb != NULL) {
     if (n_reports == 0) {
-      file << "time;nof_ue;dl_brate;ul_brate\n";
+      file << "time;nof_ue;dl_brate;ul_brate;proc_p50;proc_p99;tx_p50;tx_p99;tx_max;nof_late;"
+              "sched_bc_avg;sched_bc_max;sched_rar_avg;sched_rar_max;sched_dl_avg;sched_dl_max;"
+              "sched_ul_avg;sched_ul_max;sched_pdcch_avg;sched_pdcch_max;sched_tti_avg;sched_tti_max;sched_overruns\n";
     }
 
     // Time
@@ -88,10 +90,25 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
 
     // UL rate
     if (ul_rate_sum > 0) {
-      file << float_to_string(SRSLTE_MAX(0.1, (float)ul_rate_sum), 2, false);
+      file << float_to_string(SRSLTE_MAX(0.1, (float)ul_rate_sum), 2);
     } else {
-      file << float_to_string(0, 2, false);
+      file << float_to_string(0, 2);
+    }
+
+    // PHY real-time processing latencies (usec)
+    file << float_to_string(metrics.phy_rt.proc.p50_us, 2);
+    file << float_to_string(metrics.phy_rt.proc.p99_us, 2);
+    file << float_to_string(metrics.phy_rt.tx.p50_us, 2);
+    file << float_to_string(metrics.phy_rt.tx.p99_us, 2);
+    file << float_to_string(metrics.phy_rt.tx.max_us, 2);
+    file << metrics.phy_rt.nof_late << ";";
+
+    // Scheduler runtime per phase (usec)
+    for (const mac_sched_phase_metrics_t& phase : metrics.stack.mac_sched.phase) {
+      file << float_to_string(phase.avg_us, 2);
+      file << float_to_string(phase.max_us, 2);
     }
+    file << metrics.stack.mac_sched.nof_budget_overruns;
 
     file << "\n";
 
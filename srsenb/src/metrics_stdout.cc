@@ -83,6 +83,14 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
     printf("RF status: O=%d, U=%d, L=%d\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
   }
 
+  if (metrics.stack.mac_sched.nof_budget_overruns > 0) {
+    const mac_sched_phase_metrics_t& tti = metrics.stack.mac_sched.phase[mac_sched_metrics_t::TTI];
+    printf("Scheduler status: overruns=%d, avg=%.0fus, max=%.0fus\n",
+           metrics.stack.mac_sched.nof_budget_overruns,
+           tti.avg_us,
+           tti.max_us);
+  }
+
   if (metrics.stack.rrc.n_ues == 0) {
     return;
   }
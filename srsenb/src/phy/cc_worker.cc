@@ -150,6 +150,9 @@ void cc_worker::init(phy_common* phy_, srslte::log* log_h_, uint32_t cc_idx_)
     enb_ul.pusch.llr_is_8bit        = true;
     enb_ul.pusch.ul_sch.llr_is_8bit = true;
   }
+  if (phy->params.dl_ifft_cache) {
+    srslte_enb_dl_set_ifft_cache(&enb_dl, true);
+  }
   initiated = true;
 
 #ifdef DEBUG_WRITE_FILE
@@ -277,7 +280,8 @@ void cc_worker::work_dl(const srslte_dl_sf_cfg_t&            dl_sf_cfg,
 
 int cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch)
 {
-  srslte_pusch_res_t pusch_res;
+  // Compute the configuration of every grant first, so that the channel of all of them is estimated in one go
+  uint32_t nof_cfg = 0;
   for (uint32_t i = 0; i < nof_pusch; i++) {
     // Get grant itself and RNTI
     auto&    ul_grant = grants[i];
@@ -310,60 +314,80 @@ int cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, u
       }
       phy->ue_db.set_last_ul_tb(rnti, cc_idx, ul_pid, grant.tb);
 
-      // Run PUSCH decoder
-      pusch_res                   = {};
       ul_cfg.pusch.softbuffers.rx = grants[i].softbuffer_rx;
-      pusch_res.data              = grants[i].data;
-      if (pusch_res.data) {
-        if (srslte_enb_ul_get_pusch(&enb_ul, &ul_sf, &ul_cfg.pusch, &pusch_res)) {
-          Error("Decoding PUSCH\n");
-          return SRSLTE_ERROR;
-        }
+      pusch_cfg[nof_cfg]          = ul_cfg.pusch;
+      pusch_grant_idx[nof_cfg]    = i;
+      nof_cfg++;
+    }
+  }
+
+  // Estimate the channel of all the grants at once, or of each grant before decoding it if they can not be batched
+  bool batched = nof_cfg > 0 && srslte_enb_ul_estimate_pusch_multi(&enb_ul,
+                                                                   &ul_sf,
+                                                                   pusch_cfg.data(),
+                                                                   pusch_chest_res.data(),
+                                                                   nof_cfg) == SRSLTE_SUCCESS;
+
+  srslte_pusch_res_t pusch_res;
+  for (uint32_t n = 0; n < nof_cfg; n++) {
+    uint32_t               i         = pusch_grant_idx[n];
+    uint16_t               rnti      = grants[i].dci.rnti;
+    srslte_pusch_cfg_t&    cfg       = pusch_cfg[n];
+    srslte_chest_ul_res_t& chest_res = batched ? pusch_chest_res[n] : enb_ul.chest_res;
+
+    // Run PUSCH decoder
+    pusch_res      = {};
+    pusch_res.data = grants[i].data;
+    if (pusch_res.data) {
+      int ret = batched ? srslte_enb_ul_decode_pusch(&enb_ul, &ul_sf, &cfg, &chest_res, &pusch_res)
+                        : srslte_enb_ul_get_pusch(&enb_ul, &ul_sf, &cfg, &pusch_res);
+      if (ret) {
+        Error("Decoding PUSCH\n");
+        return SRSLTE_ERROR;
       }
+    }
 
-      // Save PHICH scheduling for this user. Each user can have just 1 PUSCH dci per TTI
-      ue_db[rnti]->phich_grant.n_prb_lowest = grant.n_prb_tilde[0];
-      ue_db[rnti]->phich_grant.n_dmrs       = grants[i].dci.n_dmrs;
+    // Save PHICH scheduling for this user. Each user can have just 1 PUSCH dci per TTI
+    ue_db[rnti]->phich_grant.n_prb_lowest = cfg.grant.n_prb_tilde[0];
+    ue_db[rnti]->phich_grant.n_dmrs       = grants[i].dci.n_dmrs;
 
-      float snr_db = enb_ul.chest_res.snr_db;
+    float snr_db = chest_res.snr_db;
 
-      // Notify MAC of RL status
-      if (snr_db >= PUSCH_RL_SNR_DB_TH) {
-        // Notify MAC UL channel quality
-        phy->stack->snr_info(ul_sf.tti, rnti, cc_idx, snr_db);
+    // Notify MAC of RL status
+    if (snr_db >= PUSCH_RL_SNR_DB_TH) {
+      // Notify MAC UL channel quality
+      phy->stack->snr_info(ul_sf.tti, rnti, cc_idx, snr_db);
 
-        if (grants[i].dci.tb.rv == 0) {
-          if (!pusch_res.crc) {
-            Debug("PUSCH: Radio-Link failure snr=%.1f dB\n", snr_db);
-            phy->stack->rl_failure(rnti);
-          } else {
-            phy->stack->rl_ok(rnti);
+      if (grants[i].dci.tb.rv == 0) {
+        if (!pusch_res.crc) {
+          Debug("PUSCH: Radio-Link failure snr=%.1f dB\n", snr_db);
+          phy->stack->rl_failure(rnti);
+        } else {
+          phy->stack->rl_ok(rnti);
 
-            // Notify MAC of Time Alignment only if it enabled and valid measurement, ignore value otherwise
-            if (ul_cfg.pusch.meas_ta_en and not std::isnan(enb_ul.chest_res.ta_us) and
-                not std::isinf(enb_ul.chest_res.ta_us)) {
-              phy->stack->ta_info(ul_sf.tti, rnti, enb_ul.chest_res.ta_us);
-            }
+          // Notify MAC of Time Alignment only if it enabled and valid measurement, ignore value otherwise
+          if (cfg.meas_ta_en and not std::isnan(chest_res.ta_us) and not std::isinf(chest_res.ta_us)) {
+            phy->stack->ta_info(ul_sf.tti, rnti, chest_res.ta_us);
           }
         }
       }
+    }
 
-      // Send UCI data to MAC
-      phy->ue_db.send_uci_data(tti_rx, rnti, cc_idx, ul_cfg.pusch.uci_cfg, pusch_res.uci);
+    // Send UCI data to MAC
+    phy->ue_db.send_uci_data(tti_rx, rnti, cc_idx, cfg.uci_cfg, pusch_res.uci);
 
-      // Notify MAC new received data and HARQ Indication value
-      if (pusch_res.data) {
-        phy->stack->crc_info(tti_rx, rnti, cc_idx, grant.tb.tbs / 8, pusch_res.crc);
+    // Notify MAC new received data and HARQ Indication value
+    if (pusch_res.data) {
+      phy->stack->crc_info(tti_rx, rnti, cc_idx, cfg.grant.tb.tbs / 8, pusch_res.crc);
 
-        // Save metrics stats
-        ue_db[rnti]->metrics_ul(grants[i].dci.tb.mcs_idx, 0, snr_db, pusch_res.avg_iterations_block);
+      // Save metrics stats
+      ue_db[rnti]->metrics_ul(grants[i].dci.tb.mcs_idx, 0, snr_db, pusch_res.avg_iterations_block);
 
-        // Logging
-        if (log_h->get_level() >= srslte::LOG_LEVEL_INFO) {
-          char str[512];
-          srslte_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &enb_ul.chest_res, str, sizeof(str));
-          log_h->info("PUSCH: cc=%d, %s\n", cc_idx, str);
-        }
+      // Logging
+      if (log_h->get_level() >= srslte::LOG_LEVEL_INFO) {
+        char str[512];
+        srslte_pusch_rx_info(&cfg, &pusch_res, &chest_res, str, sizeof(str));
+        log_h->info("PUSCH: cc=%d, %s\n", cc_idx, str);
       }
     }
   }
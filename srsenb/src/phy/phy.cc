@@ -226,6 +226,11 @@ void phy::get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS])
   }
 }
 
+void phy::get_rt_metrics(srslte::rt_metrics_t* m)
+{
+  workers_common.rt_tracker.get_metrics(m);
+}
+
 /***** RRC->PHY interface **********/
 
 void phy::set_config_dedicated(uint16_t rnti, const phy_rrc_dedicated_list_t& dedicated_list)
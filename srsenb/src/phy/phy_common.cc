@@ -125,13 +125,18 @@ void phy_common::set_ul_grants(uint32_t tti, const stack_interface_phy_lte::ul_s
  * there is no transmission at all (tx_enable). In that case, the end of burst message will be sent to the radio
  */
 void phy_common::worker_end(void*                tx_sem_id,
+                            uint32_t             tti,
                             srslte::rf_buffer_t& buffer,
                             uint32_t             nof_samples,
                             srslte_timestamp_t   tx_time)
 {
+  rt_tracker.worker_end(tti);
+
   // Wait for the green light to transmit in the current TTI
   semaphore.wait(tx_sem_id);
 
+  rt_tracker.tx_handoff(tti);
+
   // Run DL channel emulator if created
   if (dl_channel) {
     dl_channel->run(buffer.to_cf_t(), buffer.to_cf_t(), nof_samples, tx_time);
@@ -140,6 +145,9 @@ void phy_common::worker_end(void*                tx_sem_id,
   // Always transmit on single radio
   radio->tx(buffer, nof_samples, tx_time);
 
+  // Workers get here in TTI order, so every earlier TTI is over too
+  stack->tti_done(tti);
+
   // Trigger MAC clock
   stack->tti_clock();
 
@@ -135,6 +135,7 @@ void txrx::run_thread()
       }
 
       radio_h->rx_now(buffer, sf_len, &rx_time);
+      worker_com->rt_tracker.rx_done(tti);
 
       if (ul_channel) {
         ul_channel->run(buffer.to_cf_t(), buffer.to_cf_t(), sf_len, rx_time);
@@ -183,6 +183,7 @@ bool enb_stack_lte::get_metrics(stack_metrics_t* metrics)
   pending_tasks.try_push(enb_queue_id, [this]() {
     stack_metrics_t metrics{};
     mac.get_metrics(metrics.mac);
+    mac.get_sched_metrics(metrics.mac_sched);
     rrc.get_metrics(metrics.rrc);
     s1ap.get_metrics(metrics.s1ap);
     pending_stack_metrics.push(metrics);
@@ -19,6 +19,7 @@
  *
  */
 
+#include <inttypes.h>
 #include <pthread.h>
 #include <srslte/interfaces/sched_interface.h>
 #include <string.h>
@@ -28,7 +29,6 @@
 #include "srsenb/hdr/stack/mac/mac.h"
 #include "srslte/common/log.h"
 #include "srslte/common/log_helper.h"
-#include "srslte/common/rwlock_guard.h"
 #include "srslte/common/time_prof.h"
 
 //#define WRITE_SIB_PCAP
@@ -42,13 +42,14 @@ mac::mac() :
   rar_payload(),
   common_buffers(SRSLTE_MAX_CARRIERS)
 {
-  pthread_rwlock_init(&rwlock, nullptr);
+  ue_table = new ue_table_t;
 }
 
 mac::~mac()
 {
   stop();
-  pthread_rwlock_destroy(&rwlock);
+  ue_reclaimer.synchronize();
+  delete ue_table.load();
 }
 
 bool mac::init(const mac_args_t&        args_,
@@ -78,6 +79,10 @@ bool mac::init(const mac_args_t&        args_,
     // Set default scheduler configuration
     scheduler.set_sched_cfg(&args.sched);
 
+    // UE softbuffers borrow their code block buffers from these pools
+    srslte_softbuffer_pool_init_rx(&ue_rx_softbuffer_pool, args.pusch_8bit_decoder, 0);
+    srslte_softbuffer_pool_init_tx(&ue_tx_softbuffer_pool, 0);
+
     // Init softbuffer for SI messages
     common_buffers.resize(cells.size());
     for (auto& cc : common_buffers) {
@@ -101,9 +106,21 @@ bool mac::init(const mac_args_t&        args_,
 
 void mac::stop()
 {
-  srslte::rwlock_write_guard lock(rwlock);
+  std::lock_guard<std::mutex> lock(ue_db_mutex);
   if (started) {
+    // The UEs return their code block buffers to the pools when deleted. The PHY is stopped, it no longer uses them
+    for (auto& u : ue_db) {
+      ue_reclaimer.retire(u.second.release());
+    }
     ue_db.clear();
+    publish_ue_table();
+    for (auto& r : removed_ues) {
+      ue_reclaimer.retire(r.first);
+    }
+    removed_ues.clear();
+    ue_reclaimer.synchronize();
+    srslte_softbuffer_pool_free(&ue_rx_softbuffer_pool);
+    srslte_softbuffer_pool_free(&ue_tx_softbuffer_pool);
     for (auto& cc : common_buffers) {
       for (int i = 0; i < NOF_BCCH_DLSCH_MSG; i++) {
         srslte_softbuffer_tx_free(&cc.bcch_softbuffer_tx[i]);
@@ -130,11 +147,87 @@ void mac::start_pcap(srslte::mac_pcap* pcap_)
 {
   pcap = pcap_;
   // Set pcap in all UEs for UL messages
+  std::lock_guard<std::mutex> lock(ue_db_mutex);
   for (auto& u : ue_db) {
     u.second->start_pcap(pcap);
   }
 }
 
+// Must be called within an RCU read-side critical section, the UE remains valid until it is left
+ue* mac::get_ue(uint16_t rnti)
+{
+  ue_table_t* table = get_ue_table();
+  auto        it    = table->find(rnti);
+  return it != table->end() ? it->second : nullptr;
+}
+
+// Must be called with ue_db_mutex locked
+void mac::add_ue(uint16_t rnti, std::unique_ptr<ue> ue_ptr)
+{
+  std::unique_ptr<ue> old_ue;
+  auto                it = ue_db.find(rnti);
+  if (it != ue_db.end()) {
+    old_ue     = std::move(it->second);
+    it->second = std::move(ue_ptr);
+  } else {
+    ue_db.emplace(rnti, std::move(ue_ptr));
+  }
+  publish_ue_table();
+  if (old_ue != nullptr) {
+    retire_ue(std::move(old_ue));
+  }
+}
+
+// Replaces the UE table read by the PHY workers with a copy of ue_db. Must be called with ue_db_mutex locked
+void mac::publish_ue_table()
+{
+  ue_table_t* new_table = new ue_table_t;
+  new_table->reserve(ue_db.size());
+  for (auto& u : ue_db) {
+    new_table->emplace(u.first, u.second.get());
+  }
+  ue_reclaimer.retire(ue_table.exchange(new_table, std::memory_order_acq_rel));
+}
+
+// Defers the deletion of a UE until the PHY is done with its grants. Must be called with ue_db_mutex locked, after
+// the UE was removed from the published table
+void mac::retire_ue(std::unique_ptr<ue> ue_ptr)
+{
+  // Pairs with the fence of rcu_read_lock(): a PHY worker either stored its TTI before, or does not find the UE
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  removed_ues.emplace_back(ue_ptr.release(), last_sched_tti.load(std::memory_order_relaxed));
+}
+
+// Hands the removed UEs whose last TTI is done to the RCU reclaimer and deletes the ones no reader references
+void mac::reclaim_ues()
+{
+  {
+    std::lock_guard<std::mutex> lock(ue_db_mutex);
+    uint32_t                    done_tti = last_done_tti.load(std::memory_order_acquire);
+    size_t                      n        = 0;
+    for (auto& r : removed_ues) {
+      if (r.second == no_tti or (done_tti != no_tti and TTI_SUB(done_tti, r.second) < 10240 / 2)) {
+        ue_reclaimer.retire(r.first);
+      } else {
+        removed_ues[n++] = r;
+      }
+    }
+    removed_ues.resize(n);
+  }
+  ue_reclaimer.reclaim();
+}
+
+// The grants scheduled while processing tti_rx are last used by the PHY worker decoding its PUSCH
+void mac::update_last_sched_tti(uint32_t tti_rx)
+{
+  uint32_t tti  = TTI_RX_ACK(tti_rx);
+  uint32_t last = last_sched_tti.load(std::memory_order_relaxed);
+  // Several PHY workers may be scheduling at once, keep the latest TTI
+  while ((last == no_tti or (last != tti and TTI_SUB(tti, last) < 10240 / 2)) and
+         not last_sched_tti.compare_exchange_weak(last, tti)) {
+  }
+}
+
 /********************************************************
  *
  * RLC interface
@@ -142,9 +235,9 @@ void mac::start_pcap(srslte::mac_pcap* pcap_)
  *******************************************************/
 int mac::rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint32_t retx_queue)
 {
-  srslte::rwlock_read_guard lock(rwlock);
-  int                       ret = -1;
-  if (ue_db.count(rnti)) {
+  srslte::rcu_read_guard rcu;
+  int                    ret = -1;
+  if (get_ue(rnti) != nullptr) {
     if (rnti != SRSLTE_MRNTI) {
       ret = scheduler.dl_rlc_buffer_state(rnti, lc_id, tx_queue, retx_queue);
     } else {
@@ -163,11 +256,12 @@ int mac::rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint
 
 int mac::bearer_ue_cfg(uint16_t rnti, uint32_t lc_id, sched_interface::ue_bearer_cfg_t* cfg)
 {
-  int                       ret = -1;
-  srslte::rwlock_read_guard lock(rwlock);
-  if (ue_db.count(rnti)) {
+  int                    ret = -1;
+  srslte::rcu_read_guard rcu;
+  ue*                    user = get_ue(rnti);
+  if (user != nullptr) {
     // configure BSR group in UE
-    ue_db[rnti]->set_lcg(lc_id, (uint32_t)cfg->group);
+    user->set_lcg(lc_id, (uint32_t)cfg->group);
     ret = scheduler.bearer_ue_cfg(rnti, lc_id, cfg);
   } else {
     Error("User rnti=0x%x not found\n", rnti);
@@ -177,9 +271,9 @@ int mac::bearer_ue_cfg(uint16_t rnti, uint32_t lc_id, sched_interface::ue_bearer
 
 int mac::bearer_ue_rem(uint16_t rnti, uint32_t lc_id)
 {
-  srslte::rwlock_read_guard lock(rwlock);
-  int                       ret = -1;
-  if (ue_db.count(rnti)) {
+  srslte::rcu_read_guard rcu;
+  int                    ret = -1;
+  if (get_ue(rnti) != nullptr) {
     ret = scheduler.bearer_ue_rem(rnti, lc_id);
   } else {
     Error("User rnti=0x%x not found\n", rnti);
@@ -195,15 +289,13 @@ void mac::phy_config_enabled(uint16_t rnti, bool enabled)
 // Update UE configuration
 int mac::ue_cfg(uint16_t rnti, sched_interface::ue_cfg_t* cfg)
 {
-  srslte::rwlock_read_guard lock(rwlock);
+  srslte::rcu_read_guard rcu;
 
-  auto it     = ue_db.find(rnti);
-  ue*  ue_ptr = nullptr;
-  if (it == ue_db.end()) {
+  ue* ue_ptr = get_ue(rnti);
+  if (ue_ptr == nullptr) {
     Error("User rnti=0x%x not found\n", rnti);
     return SRSLTE_ERROR;
   }
-  ue_ptr = it->second.get();
 
   // Start TA FSM in UE entity
   ue_ptr->start_ta();
@@ -232,8 +324,8 @@ int mac::ue_rem(uint16_t rnti)
 {
   int ret = -1;
   {
-    srslte::rwlock_read_guard lock(rwlock);
-    if (ue_db.count(rnti)) {
+    srslte::rcu_read_guard rcu;
+    if (get_ue(rnti) != nullptr) {
       phy_h->rem_rnti(rnti);
       scheduler.ue_rem(rnti);
       ret = 0;
@@ -244,13 +336,21 @@ int mac::ue_rem(uint16_t rnti)
   if (ret) {
     return ret;
   }
-  srslte::rwlock_write_guard lock(rwlock);
-  if (ue_db.count(rnti)) {
-    ue_db.erase(rnti);
-    Info("User rnti=0x%x removed from MAC/PHY\n", rnti);
-  } else {
-    Error("User rnti=0x%x already removed\n", rnti);
+  {
+    std::lock_guard<std::mutex> lock(ue_db_mutex);
+    auto                        it = ue_db.find(rnti);
+    if (it != ue_db.end()) {
+      // The PHY may still be using the UE buffers, it is deleted once it is done with the TTIs scheduled so far
+      std::unique_ptr<ue> ue_ptr = std::move(it->second);
+      ue_db.erase(it);
+      publish_ue_table();
+      retire_ue(std::move(ue_ptr));
+      Info("User rnti=0x%x removed from MAC/PHY\n", rnti);
+    } else {
+      Error("User rnti=0x%x already removed\n", rnti);
+    }
   }
+  reclaim_ues();
   return 0;
 }
 
@@ -261,7 +361,6 @@ int mac::ue_set_crnti(uint16_t temp_crnti, uint16_t crnti, sched_interface::ue_c
   if (ret != SRSLTE_SUCCESS) {
     return ret;
   }
-  srslte::rwlock_read_guard lock(rwlock);
   if (temp_crnti == crnti) {
     // if RNTI is maintained, Msg3 contained a RRC Setup Request
     scheduler.dl_mac_buffer_state(crnti, (uint32_t)srslte::dl_sch_lcid::CON_RES_ID);
@@ -282,12 +381,33 @@ int mac::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg_)
 
 void mac::get_metrics(mac_metrics_t metrics[ENB_METRICS_MAX_USERS])
 {
-  srslte::rwlock_read_guard lock(rwlock);
-  int                       cnt = 0;
-  for (auto& u : ue_db) {
+  srslte::rcu_read_guard rcu;
+  int                    cnt = 0;
+  for (auto& u : *get_ue_table()) {
     u.second->metrics_read(&metrics[cnt]);
     cnt++;
   }
+
+  srslte_softbuffer_pool_metrics_t rx_pool = {}, tx_pool = {};
+  get_softbuffer_pool_metrics(rx_pool, tx_pool);
+  Info("Softbuffer pools: rx %d/%d CB in use (peak %d, %.1f MB, %" PRIu64 " failures), "
+       "tx %d/%d CB in use (peak %d, %.1f MB, %" PRIu64 " failures)\n",
+       rx_pool.nof_in_use,
+       rx_pool.nof_buffers,
+       rx_pool.max_in_use,
+       rx_pool.nof_bytes / 1e6,
+       rx_pool.nof_failures,
+       tx_pool.nof_in_use,
+       tx_pool.nof_buffers,
+       tx_pool.max_in_use,
+       tx_pool.nof_bytes / 1e6,
+       tx_pool.nof_failures);
+}
+
+void mac::get_softbuffer_pool_metrics(srslte_softbuffer_pool_metrics_t& rx, srslte_softbuffer_pool_metrics_t& tx)
+{
+  srslte_softbuffer_pool_get_metrics(&ue_rx_softbuffer_pool, &rx);
+  srslte_softbuffer_pool_get_metrics(&ue_tx_softbuffer_pool, &tx);
 }
 
 /********************************************************
@@ -298,13 +418,14 @@ void mac::get_metrics(mac_metrics_t metrics[ENB_METRICS_MAX_USERS])
 
 void mac::rl_failure(uint16_t rnti)
 {
-  srslte::rwlock_read_guard lock(rwlock);
-  if (ue_db.count(rnti)) {
-    uint32_t nof_fails = ue_db[rnti]->rl_failure();
+  srslte::rcu_read_guard rcu;
+  ue*                    user = get_ue(rnti);
+  if (user != nullptr) {
+    uint32_t nof_fails = user->rl_failure();
     if (nof_fails >= (uint32_t)args.link_failure_nof_err && args.link_failure_nof_err > 0) {
       Info("Detected Uplink failure for rnti=0x%x\n", rnti);
       rrc_h->rl_failure(rnti);
-      ue_db[rnti]->rl_failure_reset();
+      user->rl_failure_reset();
     }
   } else {
     Error("User rnti=0x%x not found\n", rnti);
@@ -313,9 +434,10 @@ void mac::rl_failure(uint16_t rnti)
 
 void mac::rl_ok(uint16_t rnti)
 {
-  srslte::rwlock_read_guard lock(rwlock);
-  if (ue_db.count(rnti)) {
-    ue_db[rnti]->rl_failure_reset();
+  srslte::rcu_read_guard rcu;
+  ue*                    user = get_ue(rnti);
+  if (user != nullptr) {
+    user->rl_failure_reset();
   } else {
     Error("User rnti=0x%x not found\n", rnti);
   }
@@ -323,11 +445,19 @@ void mac::rl_ok(uint16_t rnti)
 
 int mac::ack_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack)
 {
-  srslte::rwlock_read_guard lock(rwlock);
+  srslte::rcu_read_guard rcu;
   log_h->step(tti);
-  if (ue_db.count(rnti)) {
+  ue* user = get_ue(rnti);
+  if (user != nullptr) {
+    // The scheduler may reuse the HARQ process as soon as it gets the feedback, release the softbuffer before if the
+    // TB is over, either acknowledged or out of retxs
+    int ue_cc_idx = scheduler.get_enb_ue_cc_map(rnti)[enb_cc_idx];
+    if (ue_cc_idx >= 0 and scheduler.dl_ack_ends_tb(tti, rnti, enb_cc_idx, tb_idx, ack)) {
+      user->release_tx_softbuffer(ue_cc_idx, tti, tb_idx);
+    }
+
     uint32_t nof_bytes = scheduler.dl_ack_info(tti, rnti, enb_cc_idx, tb_idx, ack);
-    ue_db[rnti]->metrics_tx(ack, nof_bytes);
+    user->metrics_tx(ack, nof_bytes);
 
     if (ack) {
       if (nof_bytes > 64) { // do not count RLC status messages only
@@ -343,11 +473,12 @@ int mac::crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
 {
   int ret = SRSLTE_ERROR;
   log_h->step(tti_rx);
-  srslte::rwlock_read_guard lock(rwlock);
+  srslte::rcu_read_guard rcu;
 
-  if (ue_db.count(rnti)) {
-    ue_db[rnti]->set_tti(tti_rx);
-    ue_db[rnti]->metrics_rx(crc, nof_bytes);
+  ue* user = get_ue(rnti);
+  if (user != nullptr) {
+    user->set_tti(tti_rx);
+    user->metrics_rx(crc, nof_bytes);
 
     std::array<int, SRSLTE_MAX_CARRIERS> enb_ue_cc_map = scheduler.get_enb_ue_cc_map(rnti);
     if (enb_ue_cc_map[enb_cc_idx] < 0) {
@@ -359,10 +490,15 @@ int mac::crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
     // push the pdu through the queue if received correctly
     if (crc) {
       Info("Pushing PDU rnti=0x%x, tti_rx=%d, nof_bytes=%d\n", rnti, tti_rx, nof_bytes);
-      ue_db[rnti]->push_pdu(ue_cc_idx, tti_rx, nof_bytes);
+      user->push_pdu(ue_cc_idx, tti_rx, nof_bytes);
+      user->release_rx_softbuffer(ue_cc_idx, tti_rx);
       stack_task_queue.push([this]() { process_pdus(); });
     } else {
-      ue_db[rnti]->deallocate_pdu(ue_cc_idx, tti_rx);
+      user->deallocate_pdu(ue_cc_idx, tti_rx);
+      // A TB out of retxs gives its buffers back now, the UE may not be scheduled again for a while
+      if (scheduler.ul_crc_ends_tb(tti_rx, rnti, enb_cc_idx, crc)) {
+        user->release_rx_softbuffer(ue_cc_idx, tti_rx);
+      }
     }
 
     // Scheduler uses eNB's CC mapping
@@ -378,11 +514,12 @@ int mac::ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_v
 {
   int ret = SRSLTE_ERROR;
   log_h->step(tti);
-  srslte::rwlock_read_guard lock(rwlock);
+  srslte::rcu_read_guard rcu;
 
-  if (ue_db.count(rnti)) {
+  ue* user = get_ue(rnti);
+  if (user != nullptr) {
     scheduler.dl_ri_info(tti, rnti, enb_cc_idx, ri_value);
-    ue_db[rnti]->metrics_dl_ri(ri_value);
+    user->metrics_dl_ri(ri_value);
     ret = SRSLTE_SUCCESS;
   } else {
     Error("User rnti=0x%x not found\n", rnti);
@@ -395,11 +532,12 @@ int mac::pmi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t pmi
 {
   int ret = SRSLTE_ERROR;
   log_h->step(tti);
-  srslte::rwlock_read_guard lock(rwlock);
+  srslte::rcu_read_guard rcu;
 
-  if (ue_db.count(rnti)) {
+  ue* user = get_ue(rnti);
+  if (user != nullptr) {
     scheduler.dl_pmi_info(tti, rnti, enb_cc_idx, pmi_value);
-    ue_db[rnti]->metrics_dl_pmi(pmi_value);
+    user->metrics_dl_pmi(pmi_value);
     ret = SRSLTE_SUCCESS;
   } else {
     Error("User rnti=0x%x not found\n", rnti);
@@ -412,11 +550,12 @@ int mac::cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi
 {
   int ret = SRSLTE_ERROR;
   log_h->step(tti);
-  srslte::rwlock_read_guard lock(rwlock);
+  srslte::rcu_read_guard rcu;
 
-  if (ue_db.count(rnti)) {
+  ue* user = get_ue(rnti);
+  if (user != nullptr) {
     scheduler.dl_cqi_info(tti, rnti, enb_cc_idx, cqi_value);
-    ue_db[rnti]->metrics_dl_cqi(cqi_value);
+    user->metrics_dl_cqi(cqi_value);
     ret = SRSLTE_SUCCESS;
   } else {
     Error("User rnti=0x%x not found\n", rnti);
@@ -429,9 +568,9 @@ int mac::snr_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, float snr)
 {
   int ret = SRSLTE_ERROR;
   log_h->step(tti);
-  srslte::rwlock_read_guard lock(rwlock);
+  srslte::rcu_read_guard rcu;
 
-  if (ue_db.count(rnti)) {
+  if (get_ue(rnti) != nullptr) {
     uint32_t cqi = srslte_cqi_from_snr(snr);
     scheduler.ul_cqi_info(tti, rnti, enb_cc_idx, cqi, 0);
     ret = SRSLTE_SUCCESS;
@@ -444,9 +583,10 @@ int mac::snr_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, float snr)
 
 int mac::ta_info(uint32_t tti, uint16_t rnti, float ta_us)
 {
-  srslte::rwlock_read_guard lock(rwlock);
-  if (ue_db.count(rnti)) {
-    uint32_t nof_ta_count = ue_db[rnti]->set_ta_us(ta_us);
+  srslte::rcu_read_guard rcu;
+  ue*                    user = get_ue(rnti);
+  if (user != nullptr) {
+    uint32_t nof_ta_count = user->set_ta_us(ta_us);
     if (nof_ta_count) {
       scheduler.dl_mac_buffer_state(rnti, (uint32_t)srslte::dl_sch_lcid::TA_CMD, nof_ta_count);
     }
@@ -457,9 +597,9 @@ int mac::ta_info(uint32_t tti, uint16_t rnti, float ta_us)
 int mac::sr_detected(uint32_t tti, uint16_t rnti)
 {
   log_h->step(tti);
-  int                       ret = -1;
-  srslte::rwlock_read_guard lock(rwlock);
-  if (ue_db.count(rnti)) {
+  int                    ret = -1;
+  srslte::rcu_read_guard rcu;
+  if (get_ue(rnti) != nullptr) {
     scheduler.ul_sr_info(tti, rnti);
     ret = 0;
   } else {
@@ -490,7 +630,16 @@ void mac::rach_detected(uint32_t tti, uint32_t enb_cc_idx, uint32_t preamble_idx
   uint16_t rnti = allocate_rnti();
 
   // Create new UE
-  std::unique_ptr<ue> ue_ptr{new ue(rnti, args.nof_prb, &scheduler, rrc_h, rlc_h, phy_h, log_h, cells.size())};
+  std::unique_ptr<ue> ue_ptr{new ue(rnti,
+                                    args.nof_prb,
+                                    &scheduler,
+                                    rrc_h,
+                                    rlc_h,
+                                    phy_h,
+                                    log_h,
+                                    cells.size(),
+                                    &ue_rx_softbuffer_pool,
+                                    &ue_tx_softbuffer_pool)};
 
   // Set PCAP if available
   if (pcap != nullptr) {
@@ -498,8 +647,8 @@ void mac::rach_detected(uint32_t tti, uint32_t enb_cc_idx, uint32_t preamble_idx
   }
 
   {
-    srslte::rwlock_write_guard lock(rwlock);
-    ue_db[rnti] = std::move(ue_ptr);
+    std::lock_guard<std::mutex> lock(ue_db_mutex);
+    add_ue(rnti, std::move(ue_ptr));
   }
 
   stack_task_queue.push([this, rnti, tti, enb_cc_idx, preamble_idx, time_adv, rach_tprof_meas]() mutable {
@@ -548,6 +697,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
   }
 
   log_h->step(TTI_SUB(tti_tx_dl, FDD_HARQ_DELAY_UL_MS));
+  update_last_sched_tti(TTI_SUB(tti_tx_dl, FDD_HARQ_DELAY_UL_MS));
 
   for (uint32_t enb_cc_idx = 0; enb_cc_idx < cell_config.size(); enb_cc_idx++) {
     // Run scheduler with current info
@@ -561,30 +711,34 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
     dl_sched_t* dl_sched_res = &dl_sched_res_list[enb_cc_idx];
 
     {
-      srslte::rwlock_read_guard lock(rwlock);
+      srslte::rcu_read_guard rcu;
 
       // Copy data grants
       for (uint32_t i = 0; i < sched_result.nof_data_elems; i++) {
 
         // Get UE
         uint16_t rnti = sched_result.data[i].dci.rnti;
+        ue*      user = get_ue(rnti);
 
-        if (ue_db.count(rnti)) {
+        if (user != nullptr) {
           // Copy dci info
           dl_sched_res->pdsch[n].dci = sched_result.data[i].dci;
 
           for (uint32_t tb = 0; tb < SRSLTE_MAX_TB; tb++) {
-            dl_sched_res->pdsch[n].softbuffer_tx[tb] =
-                ue_db[rnti]->get_tx_softbuffer(sched_result.data[i].dci.ue_cc_idx, sched_result.data[i].dci.pid, tb);
+            dl_sched_res->pdsch[n].softbuffer_tx[tb] = user->get_tx_softbuffer(
+                sched_result.data[i].dci.ue_cc_idx, sched_result.data[i].dci.pid, tb, tti_tx_dl);
 
             if (sched_result.data[i].nof_pdu_elems[tb] > 0) {
+              srslte_softbuffer_tx_reset_tbs(dl_sched_res->pdsch[n].softbuffer_tx[tb],
+                                             sched_result.data[i].tbs[tb] * 8);
+
               /* Get PDU if it's a new transmission */
-              dl_sched_res->pdsch[n].data[tb] = ue_db[rnti]->generate_pdu(sched_result.data[i].dci.ue_cc_idx,
-                                                                          sched_result.data[i].dci.pid,
-                                                                          tb,
-                                                                          sched_result.data[i].pdu[tb],
-                                                                          sched_result.data[i].nof_pdu_elems[tb],
-                                                                          sched_result.data[i].tbs[tb]);
+              dl_sched_res->pdsch[n].data[tb] = user->generate_pdu(sched_result.data[i].dci.ue_cc_idx,
+                                                                   sched_result.data[i].dci.pid,
+                                                                   tb,
+                                                                   sched_result.data[i].pdu[tb],
+                                                                   sched_result.data[i].nof_pdu_elems[tb],
+                                                                   sched_result.data[i].tbs[tb]);
 
               if (!dl_sched_res->pdsch[n].data[tb]) {
                 Error("Error! PDU was not generated (rnti=0x%04x, tb=%d)\n", rnti, tb);
@@ -668,7 +822,8 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
   }
 
   // Count number of TTIs for all active users
-  for (auto& u : ue_db) {
+  srslte::rcu_read_guard rcu;
+  for (auto& u : *get_ue_table()) {
     u.second->metrics_cnt();
   }
 
@@ -710,6 +865,13 @@ void mac::build_mch_sched(uint32_t tbs)
 
 int mac::get_mch_sched(uint32_t tti, bool is_mcch, dl_sched_list_t& dl_sched_res_list)
 {
+  srslte::rcu_read_guard rcu;
+  ue*                    mch_ue = get_ue(SRSLTE_MRNTI);
+  if (mch_ue == nullptr) {
+    Error("MCH user not found\n");
+    return SRSLTE_ERROR;
+  }
+
   dl_sched_t* dl_sched_res = &dl_sched_res_list[0];
   log_h->step(tti);
   srslte_ra_tb_t mcs      = {};
@@ -737,9 +899,9 @@ int mac::get_mch_sched(uint32_t tti, bool is_mcch, dl_sched_list_t& dl_sched_res
     dl_sched_res->pdsch[0].dci.rnti    = SRSLTE_MRNTI;
 
     // we use TTI % HARQ to make sure we use different buffers for consecutive TTIs to avoid races between PHY workers
-    ue_db[SRSLTE_MRNTI]->metrics_tx(true, mcs.tbs);
+    mch_ue->metrics_tx(true, mcs.tbs);
     dl_sched_res->pdsch[0].data[0] =
-        ue_db[SRSLTE_MRNTI]->generate_mch_pdu(tti % SRSLTE_FDD_NOF_HARQ, mch, mch.num_mtch_sched + 1, mcs.tbs / 8);
+        mch_ue->generate_mch_pdu(tti % SRSLTE_FDD_NOF_HARQ, mch, mch.num_mtch_sched + 1, mcs.tbs / 8);
 
   } else {
     uint32_t current_lcid = 1;
@@ -757,15 +919,14 @@ int mac::get_mch_sched(uint32_t tti, bool is_mcch, dl_sched_list_t& dl_sched_res
       int requested_bytes = (mcs_data.tbs / 8 > (int)mch.mtch_sched[mtch_index].lcid_buffer_size)
                                 ? (mch.mtch_sched[mtch_index].lcid_buffer_size)
                                 : ((mcs_data.tbs / 8) - 2);
-      int bytes_received = ue_db[SRSLTE_MRNTI]->read_pdu(current_lcid, mtch_payload_buffer, requested_bytes);
+      int bytes_received = mch_ue->read_pdu(current_lcid, mtch_payload_buffer, requested_bytes);
       mch.pdu[0].lcid    = current_lcid;
       mch.pdu[0].nbytes  = bytes_received;
       mch.mtch_sched[0].mtch_payload  = mtch_payload_buffer;
       dl_sched_res->pdsch[0].dci.rnti = SRSLTE_MRNTI;
       if (bytes_received) {
-        ue_db[SRSLTE_MRNTI]->metrics_tx(true, mcs.tbs);
-        dl_sched_res->pdsch[0].data[0] =
-            ue_db[SRSLTE_MRNTI]->generate_mch_pdu(tti % SRSLTE_FDD_NOF_HARQ, mch, 1, mcs_data.tbs / 8);
+        mch_ue->metrics_tx(true, mcs.tbs);
+        dl_sched_res->pdsch[0].data[0] = mch_ue->generate_mch_pdu(tti % SRSLTE_FDD_NOF_HARQ, mch, 1, mcs_data.tbs / 8);
       }
     } else {
       dl_sched_res->pdsch[0].dci.rnti = 0;
@@ -775,7 +936,7 @@ int mac::get_mch_sched(uint32_t tti, bool is_mcch, dl_sched_list_t& dl_sched_res
   }
 
   // Count number of TTIs for all active users
-  for (auto& u : ue_db) {
+  for (auto& u : *get_ue_table()) {
     u.second->metrics_cnt();
   }
   return SRSLTE_SUCCESS;
@@ -816,12 +977,15 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
   }
 
   log_h->step(TTI_SUB(tti_tx_ul, FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS));
+  update_last_sched_tti(TTI_SUB(tti_tx_ul, FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS));
+
+  srslte::rcu_read_guard rcu;
 
   // Execute TA FSM
-  for (auto& ue : ue_db) {
-    uint32_t nof_ta_count = ue.second->tick_ta_fsm();
+  for (auto& u : *get_ue_table()) {
+    uint32_t nof_ta_count = u.second->tick_ta_fsm();
     if (nof_ta_count) {
-      scheduler.dl_mac_buffer_state(ue.first, (uint32_t)srslte::dl_sch_lcid::TA_CMD, nof_ta_count);
+      scheduler.dl_mac_buffer_state(u.first, (uint32_t)srslte::dl_sch_lcid::TA_CMD, nof_ta_count);
     }
   }
 
@@ -836,8 +1000,6 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
     }
 
     {
-      srslte::rwlock_read_guard lock(rwlock);
-
       // Copy DCI grants
       phy_ul_sched_res->nof_grants = 0;
       int n                        = 0;
@@ -846,19 +1008,20 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
         if (sched_result.pusch[i].tbs > 0) {
           // Get UE
           uint16_t rnti = sched_result.pusch[i].dci.rnti;
+          ue*      user = get_ue(rnti);
 
-          if (ue_db.count(rnti)) {
+          if (user != nullptr) {
             // Copy grant info
             phy_ul_sched_res->pusch[n].current_tx_nb = sched_result.pusch[i].current_tx_nb;
             phy_ul_sched_res->pusch[n].needs_pdcch   = sched_result.pusch[i].needs_pdcch;
             phy_ul_sched_res->pusch[n].dci           = sched_result.pusch[i].dci;
             phy_ul_sched_res->pusch[n].softbuffer_rx =
-                ue_db[rnti]->get_rx_softbuffer(sched_result.pusch[i].dci.ue_cc_idx, tti_tx_ul);
-            if (sched_result.pusch[n].current_tx_nb == 0) {
+                user->get_rx_softbuffer(sched_result.pusch[i].dci.ue_cc_idx, tti_tx_ul);
+            if (sched_result.pusch[i].current_tx_nb == 0) {
               srslte_softbuffer_rx_reset_tbs(phy_ul_sched_res->pusch[n].softbuffer_rx, sched_result.pusch[i].tbs * 8);
             }
             phy_ul_sched_res->pusch[n].data =
-                ue_db[rnti]->request_buffer(sched_result.pusch[i].dci.ue_cc_idx, tti_tx_ul, sched_result.pusch[i].tbs);
+                user->request_buffer(sched_result.pusch[i].dci.ue_cc_idx, tti_tx_ul, sched_result.pusch[i].tbs);
             phy_ul_sched_res->nof_grants++;
             n++;
           } else {
@@ -883,13 +1046,23 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
   return SRSLTE_SUCCESS;
 }
 
+void mac::tti_done(uint32_t tti_rx)
+{
+  last_done_tti.store(tti_rx, std::memory_order_release);
+}
+
 bool mac::process_pdus()
 {
-  srslte::rwlock_read_guard lock(rwlock);
-  bool                      ret = false;
-  for (auto& u : ue_db) {
-    ret |= u.second->process_pdus();
+  bool ret = false;
+  {
+    srslte::rcu_read_guard rcu;
+    for (auto& u : *get_ue_table()) {
+      ret |= u.second->process_pdus();
+    }
   }
+
+  // Deletes the removed UEs the PHY workers are done with
+  reclaim_ues();
   return ret;
 }
 
@@ -909,8 +1082,20 @@ void mac::write_mcch(sib_type2_s* sib2_, sib_type13_r9_s* sib13_, mcch_msg_s* mc
   mcch.pack(bref);
   current_mcch_length = bref.distance_bytes(&mcch_payload_buffer[1]);
   current_mcch_length = current_mcch_length + rlc_header_len;
-  ue_db[SRSLTE_MRNTI] =
-      std::unique_ptr<ue>{new ue(SRSLTE_MRNTI, args.nof_prb, &scheduler, rrc_h, rlc_h, phy_h, log_h, cells.size())};
+  {
+    std::lock_guard<std::mutex> lock(ue_db_mutex);
+    add_ue(SRSLTE_MRNTI,
+           std::unique_ptr<ue>{new ue(SRSLTE_MRNTI,
+                                      args.nof_prb,
+                                      &scheduler,
+                                      rrc_h,
+                                      rlc_h,
+                                      phy_h,
+                                      log_h,
+                                      cells.size(),
+                                      &ue_rx_softbuffer_pool,
+                                      &ue_tx_softbuffer_pool)});
+  }
 
   rrc_h->add_user(SRSLTE_MRNTI, {});
 }
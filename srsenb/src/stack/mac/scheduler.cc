@@ -137,14 +137,19 @@ bool sched_cell_params_t::set_cfg(uint32_t                             enb_cc_id
 
 sched::sched() : log_h(srslte::logmap::get("MAC")) {}
 
-sched::~sched() {}
+sched::~sched()
+{
+  if (workers) {
+    workers->stop();
+  }
+}
 
 void sched::init(rrc_interface_mac* rrc_)
 {
   rrc = rrc_;
 
   // Initialize first carrier scheduler
-  carrier_schedulers.emplace_back(new carrier_sched{rrc, &ue_db, 0});
+  carrier_schedulers.emplace_back(new carrier_sched{rrc, &ue_db, 0, &clock});
 
   reset();
 }
@@ -160,6 +165,17 @@ int sched::reset()
   return 0;
 }
 
+void sched::set_clock(const sched_clock_t& clock_)
+{
+  std::lock_guard<std::mutex> lock(sched_mutex);
+  clock = clock_;
+}
+
+uint32_t sched::get_nof_workers() const
+{
+  return workers == nullptr ? 0 : workers->nof_workers();
+}
+
 void sched::set_sched_cfg(sched_interface::sched_args_t* sched_cfg_)
 {
   std::lock_guard<std::mutex> lock(sched_mutex);
@@ -183,7 +199,7 @@ int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
   uint32_t prev_size = carrier_schedulers.size();
   carrier_schedulers.resize(sched_cell_params.size());
   for (uint32_t i = prev_size; i < sched_cell_params.size(); ++i) {
-    carrier_schedulers[i].reset(new carrier_sched{rrc, &ue_db, i});
+    carrier_schedulers[i].reset(new carrier_sched{rrc, &ue_db, i, &clock});
   }
 
   // setup all carriers cfg params
@@ -191,6 +207,20 @@ int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
     carrier_schedulers[i]->carrier_cfg(sched_cell_params[i]);
   }
 
+  // The calling thread allocates one of the carriers, the workers the remaining ones. The pool is recreated when a
+  // reconfiguration changes the number of carriers
+  uint32_t nof_workers = std::min(sched_cfg.nof_sched_workers, (uint32_t)carrier_schedulers.size() - 1);
+  if (nof_workers != get_nof_workers()) {
+    if (workers != nullptr) {
+      workers->stop();
+      workers.reset();
+    }
+    if (nof_workers > 0) {
+      workers.reset(new srslte::task_thread_pool(nof_workers));
+      workers->start();
+    }
+  }
+
   configured = true;
 
   return 0;
@@ -289,6 +319,23 @@ int sched::ul_crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool
       rnti, [tti_rx, enb_cc_idx, crc](sched_ue& ue) { ue.set_ul_crc(srslte::tti_point{tti_rx}, enb_cc_idx, crc); });
 }
 
+bool sched::dl_ack_ends_tb(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack)
+{
+  bool ret = false;
+  ue_db_access(rnti, [&](sched_ue& ue) { ret = ue.dl_ack_ends_tb(tti, enb_cc_idx, tb_idx, ack); }, __PRETTY_FUNCTION__);
+  return ret;
+}
+
+bool sched::ul_crc_ends_tb(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool crc)
+{
+  bool ret = false;
+  ue_db_access(
+      rnti,
+      [&](sched_ue& ue) { ret = ue.ul_crc_ends_tb(srslte::tti_point{tti_rx}, enb_cc_idx, crc); },
+      __PRETTY_FUNCTION__);
+  return ret;
+}
+
 int sched::dl_ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_value)
 {
   return ue_db_access(rnti, [tti, enb_cc_idx, ri_value](sched_ue& ue) { ue.set_dl_ri(tti, enb_cc_idx, ri_value); });
@@ -368,6 +415,16 @@ std::array<int, SRSLTE_MAX_CARRIERS> sched::get_enb_ue_cc_map(uint16_t rnti)
   return ret;
 }
 
+//! Runtime of the scheduling phases of all carriers since the previous call
+void sched::get_metrics(mac_sched_metrics_t& metrics)
+{
+  std::lock_guard<std::mutex> lock(sched_mutex);
+  metrics = {};
+  for (auto& c : carrier_schedulers) {
+    c->get_metrics(metrics);
+  }
+}
+
 /*******************************************************
  *
  * Main sched functions
@@ -387,7 +444,7 @@ int sched::dl_sched(uint32_t tti_tx_dl, uint32_t cc_idx, sched_interface::dl_sch
 
   if (cc_idx < carrier_schedulers.size()) {
     // Compute scheduling Result for tti_rx
-    const sf_sched_result& tti_sched = carrier_schedulers[cc_idx]->generate_tti_result(tti_rx);
+    const sf_sched_result& tti_sched = generate_tti_result(tti_rx, cc_idx);
 
     // copy result
     sched_result = tti_sched.dl_sched_result;
@@ -408,7 +465,7 @@ int sched::ul_sched(uint32_t tti, uint32_t cc_idx, srsenb::sched_interface::ul_s
   uint32_t tti_rx = sched_utils::tti_subtract(tti, FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS);
 
   if (cc_idx < carrier_schedulers.size()) {
-    const sf_sched_result& tti_sched = carrier_schedulers[cc_idx]->generate_tti_result(tti_rx);
+    const sf_sched_result& tti_sched = generate_tti_result(tti_rx, cc_idx);
 
     // copy result
     sched_result = tti_sched.ul_sched_result;
@@ -417,6 +474,58 @@ int sched::ul_sched(uint32_t tti, uint32_t cc_idx, srsenb::sched_interface::ul_s
   return SRSLTE_SUCCESS;
 }
 
+/**
+ * Computes the scheduling result of a carrier for tti_rx. The first request of a TTI allocates all its carriers, in
+ * parallel if there are workers, and then generates their results in carrier order. Since a carrier allocation only
+ * depends on the UE state left by the previous TTIs, the results are the same with or without workers. The generation
+ * is the point where the carriers apply their changes to the buffers and HARQs of the UEs
+ */
+const sf_sched_result& sched::generate_tti_result(uint32_t tti_rx, uint32_t enb_cc_idx)
+{
+  if (not carrier_schedulers[enb_cc_idx]->is_tti_generated(tti_rx)) {
+    std::vector<carrier_sched*> pending_carriers;
+    for (std::unique_ptr<carrier_sched>& c : carrier_schedulers) {
+      if (not c->is_tti_generated(tti_rx)) {
+        pending_carriers.push_back(c.get());
+      }
+    }
+    // the RRC is not called from the workers, so the carrier that gets each paging does not depend on their timing
+    for (carrier_sched* c : pending_carriers) {
+      c->fetch_bc_data(tti_rx);
+    }
+
+    if (workers != nullptr) {
+      {
+        std::lock_guard<std::mutex> lock(workers_mutex);
+        workers_pending = pending_carriers.size() - 1;
+      }
+      for (uint32_t i = 1; i < pending_carriers.size(); ++i) {
+        carrier_sched* c = pending_carriers[i];
+        workers->push_task([this, c, tti_rx](uint32_t worker_id) {
+          c->alloc_tti(tti_rx);
+          std::lock_guard<std::mutex> lock(workers_mutex);
+          workers_pending--;
+          workers_cvar.notify_one();
+        });
+      }
+      pending_carriers[0]->alloc_tti(tti_rx);
+      std::unique_lock<std::mutex> lock(workers_mutex);
+      while (workers_pending > 0) {
+        workers_cvar.wait(lock);
+      }
+    } else {
+      for (carrier_sched* c : pending_carriers) {
+        c->alloc_tti(tti_rx);
+      }
+    }
+
+    for (carrier_sched* c : pending_carriers) {
+      c->generate_tti_result(tti_rx);
+    }
+  }
+  return carrier_schedulers[enb_cc_idx]->generate_tti_result(tti_rx);
+}
+
 // Common way to access ue_db elements in a read locking way
 template <typename Func>
 int sched::ue_db_access(uint16_t rnti, Func f, const char* func_name)
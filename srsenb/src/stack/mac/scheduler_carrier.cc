@@ -32,6 +32,21 @@ namespace srsenb {
 
 bc_sched::bc_sched(const sched_cell_params_t& cfg_, srsenb::rrc_interface_mac* rrc_) : cc_cfg(&cfg_), rrc(rrc_) {}
 
+/**
+ * Fetches the paging of a TTI from the RRC. The RRC hands each paging message out only once, so the carriers of a TTI
+ * have to fetch it one at a time and in carrier order, before their allocations run in parallel
+ */
+void bc_sched::fetch_paging(uint32_t tti_tx_dl)
+{
+  paging_payload = 0;
+  if (rrc != nullptr) {
+    uint32_t payload_len = 0;
+    if (rrc->is_paging_opportunity(tti_tx_dl, &payload_len)) {
+      paging_payload = payload_len;
+    }
+  }
+}
+
 void bc_sched::dl_sched(sf_sched* tti_sched)
 {
   current_tti   = tti_sched->get_tti_tx_dl();
@@ -44,7 +59,6 @@ void bc_sched::dl_sched(sf_sched* tti_sched)
   alloc_sibs(tti_sched);
 
   /* Allocate Paging */
-  // NOTE: It blocks
   alloc_paging(tti_sched);
 }
 
@@ -116,11 +130,9 @@ void bc_sched::alloc_sibs(sf_sched* tti_sched)
 void bc_sched::alloc_paging(sf_sched* tti_sched)
 {
   /* Allocate DCIs and RBGs for paging */
-  if (rrc != nullptr) {
-    uint32_t paging_payload = 0;
-    if (rrc->is_paging_opportunity(current_tti, &paging_payload) and paging_payload > 0) {
-      tti_sched->alloc_paging(bc_aggr_level, paging_payload);
-    }
+  if (paging_payload > 0) {
+    tti_sched->alloc_paging(bc_aggr_level, paging_payload);
+    paging_payload = 0;
   }
 }
 
@@ -135,7 +147,7 @@ void bc_sched::reset()
  *                 RAR scheduling
  *******************************************************/
 
-ra_sched::ra_sched(const sched_cell_params_t& cfg_, std::map<uint16_t, sched_ue>& ue_db_) :
+ra_sched::ra_sched(const sched_cell_params_t& cfg_, sched_ue_list& ue_db_) :
   cc_cfg(&cfg_),
   log_h(srslte::logmap::get("MAC")),
   ue_db(&ue_db_)
@@ -257,13 +269,36 @@ void ra_sched::reset()
  *                 Carrier scheduling
  *******************************************************/
 
-sched::carrier_sched::carrier_sched(rrc_interface_mac*            rrc_,
-                                    std::map<uint16_t, sched_ue>* ue_db_,
-                                    uint32_t                      enb_cc_idx_) :
+void sched_phase_stats::operator()(std::chrono::nanoseconds duration)
+{
+  nof_samples++;
+  total += duration;
+  max = std::max(max, duration);
+}
+
+void sched_phase_stats::get_metrics(mac_sched_phase_metrics_t& metrics)
+{
+  uint32_t n = metrics.nof_samples + nof_samples;
+  if (n > 0) {
+    metrics.avg_us = (metrics.avg_us * metrics.nof_samples + total.count() / 1000.0f) / n;
+  }
+  metrics.max_us      = std::max(metrics.max_us, max.count() / 1000.0f);
+  metrics.nof_samples = n;
+
+  nof_samples = 0;
+  total       = std::chrono::nanoseconds{0};
+  max         = std::chrono::nanoseconds{0};
+}
+
+sched::carrier_sched::carrier_sched(rrc_interface_mac*   rrc_,
+                                    sched_ue_list*       ue_db_,
+                                    uint32_t             enb_cc_idx_,
+                                    const sched_clock_t* clock_) :
   rrc(rrc_),
   ue_db(ue_db_),
   log_h(srslte::logmap::get("MAC ")),
-  enb_cc_idx(enb_cc_idx_)
+  enb_cc_idx(enb_cc_idx_),
+  clock(clock_)
 {
   sf_dl_mask.resize(1, 0);
 }
@@ -311,59 +346,113 @@ void sched::carrier_sched::set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)
   sf_dl_mask.assign(tti_mask, tti_mask + nof_sfs);
 }
 
-const sf_sched_result& sched::carrier_sched::generate_tti_result(uint32_t tti_rx)
+/**
+ * Fetches from the RRC the broadcast data of a TTI. The RRC is shared by all carriers, so it is called from the thread
+ * that dispatches the allocations, in carrier order
+ */
+void sched::carrier_sched::fetch_bc_data(uint32_t tti_rx)
 {
+  uint32_t tti_tx_dl = TTI_ADD(tti_rx, FDD_HARQ_DELAY_UL_MS);
+  if (sf_dl_mask[tti_tx_dl % sf_dl_mask.size()] == 0) {
+    bc_sched_ptr->fetch_paging(tti_tx_dl);
+  }
+}
+
+/**
+ * Allocates the PHICH, broadcast, RAR and data resources of a TTI. It only changes the state of this carrier, so the
+ * carriers of a TTI may be allocated in parallel
+ */
+void sched::carrier_sched::alloc_tti(uint32_t tti_rx)
+{
+  phase_tprof[mac_sched_metrics_t::TTI].start();
+  sf_sched*        tti_sched = get_sf_sched(tti_rx);
   sf_sched_result* sf_result = get_next_sf_result(tti_rx);
+  *sf_result                 = {};
+  alloc_tti_rx               = tti_rx;
 
-  // if it is the first time tti is run, reset vars
-  if (tti_rx != sf_result->tti_params.tti_rx) {
-    sf_sched* tti_sched = get_sf_sched(tti_rx);
-    *sf_result          = {};
+  // past the deadline, the metrics stop looking for new data allocations
+  if (cc_cfg->sched_cfg->max_sched_time_us > 0) {
+    tti_sched->set_deadline((*clock)() + std::chrono::microseconds(cc_cfg->sched_cfg->max_sched_time_us), clock);
+  }
 
-    bool dl_active = sf_dl_mask[tti_sched->get_tti_tx_dl() % sf_dl_mask.size()] == 0;
+  bool dl_active = sf_dl_mask[tti_sched->get_tti_tx_dl() % sf_dl_mask.size()] == 0;
 
-    /* Schedule PHICH */
-    for (auto& ue_pair : *ue_db) {
-      tti_sched->alloc_phich(&ue_pair.second, &sf_result->ul_sched_result);
-    }
+  /* Schedule PHICH */
+  for (auto& ue_pair : *ue_db) {
+    tti_sched->alloc_phich(&ue_pair.second, &sf_result->ul_sched_result);
+  }
 
-    /* Schedule DL control data */
-    if (dl_active) {
-      /* Schedule Broadcast data (SIB and paging) */
-      bc_sched_ptr->dl_sched(tti_sched);
+  /* Schedule DL control data */
+  if (dl_active) {
+    /* Schedule Broadcast data (SIB and paging) */
+    phase_tprof[mac_sched_metrics_t::BC].start();
+    bc_sched_ptr->dl_sched(tti_sched);
+    phase_tprof[mac_sched_metrics_t::BC].stop();
+
+    /* Schedule RAR */
+    phase_tprof[mac_sched_metrics_t::RAR].start();
+    ra_sched_ptr->dl_sched(tti_sched);
+
+    /* Schedule Msg3 */
+    sf_sched* sf_msg3_sched = get_sf_sched(tti_rx + MSG3_DELAY_MS);
+    ra_sched_ptr->ul_sched(tti_sched, sf_msg3_sched);
+    phase_tprof[mac_sched_metrics_t::RAR].stop();
+  }
 
-      /* Schedule RAR */
-      ra_sched_ptr->dl_sched(tti_sched);
+  /* Prioritize PDCCH scheduling for DL and UL data in a RoundRobin fashion */
+  if ((tti_rx % 2) == 0) {
+    alloc_ul_users(tti_sched);
+  }
 
-      /* Schedule Msg3 */
-      sf_sched* sf_msg3_sched = get_sf_sched(tti_rx + MSG3_DELAY_MS);
-      ra_sched_ptr->ul_sched(tti_sched, sf_msg3_sched);
-    }
+  /* Schedule DL user data */
+  alloc_dl_users(tti_sched);
 
-    /* Prioritize PDCCH scheduling for DL and UL data in a RoundRobin fashion */
-    if ((tti_rx % 2) == 0) {
-      alloc_ul_users(tti_sched);
-    }
+  if ((tti_rx % 2) == 1) {
+    alloc_ul_users(tti_sched);
+  }
+}
 
-    /* Schedule DL user data */
-    alloc_dl_users(tti_sched);
+/**
+ * Generates the DCIs and MAC PDUs of the allocations of a TTI, allocating it first if needed. It consumes the buffers
+ * and HARQs the UEs share among carriers, so the carriers of a TTI must generate their results one at a time
+ */
+const sf_sched_result& sched::carrier_sched::generate_tti_result(uint32_t tti_rx)
+{
+  sf_sched_result* sf_result = get_next_sf_result(tti_rx);
 
-    if ((tti_rx % 2) == 1) {
-      alloc_ul_users(tti_sched);
+  // if it is the first time tti is run, reset vars
+  if (tti_rx != sf_result->tti_params.tti_rx) {
+    if (alloc_tti_rx != (int)tti_rx) {
+      fetch_bc_data(tti_rx);
+      alloc_tti(tti_rx);
     }
+    sf_sched* tti_sched = get_sf_sched(tti_rx);
 
     /* Select the winner DCI allocation combination, store all the scheduling results */
+    phase_tprof[mac_sched_metrics_t::PDCCH].start();
     tti_sched->generate_sched_results(sf_result);
+    phase_tprof[mac_sched_metrics_t::PDCCH].stop();
 
     /* Reset ue harq pending ack state, clean-up blocked pids */
     for (auto& user : *ue_db) {
       user.second.finish_tti(sf_result->tti_params, enb_cc_idx);
     }
+
+    if (tti_sched->is_budget_exceeded()) {
+      nof_budget_overruns++;
+      log_h->debug("SCHED: Scheduling time budget of tti=%d exceeded. Remaining UEs were not allocated\n", tti_rx);
+    }
+    phase_tprof[mac_sched_metrics_t::TTI].stop();
   }
 
   return *sf_result;
 }
 
+bool sched::carrier_sched::is_tti_generated(uint32_t tti_rx) const
+{
+  return get_sf_result(tti_rx).tti_params.tti_rx == tti_rx;
+}
+
 void sched::carrier_sched::alloc_dl_users(sf_sched* tti_result)
 {
   if (sf_dl_mask[tti_result->get_tti_tx_dl() % sf_dl_mask.size()] != 0) {
@@ -379,13 +468,17 @@ void sched::carrier_sched::alloc_dl_users(sf_sched* tti_result)
   }
 
   // call DL scheduler metric to fill RB grid
+  phase_tprof[mac_sched_metrics_t::DL_DATA].start();
   dl_metric->sched_users(*ue_db, tti_result);
+  phase_tprof[mac_sched_metrics_t::DL_DATA].stop();
 }
 
 int sched::carrier_sched::alloc_ul_users(sf_sched* tti_sched)
 {
   uint32_t tti_tx_ul = tti_sched->get_tti_tx_ul();
 
+  phase_tprof[mac_sched_metrics_t::UL_DATA].start();
+
   /* reserve PRBs for PRACH */
   if (srslte_prach_tti_opportunity_config_fdd(cc_cfg->cfg.prach_config, tti_tx_ul, -1)) {
     tti_sched->reserve_ul_prbs(prach_mask, false);
@@ -398,9 +491,19 @@ int sched::carrier_sched::alloc_ul_users(sf_sched* tti_sched)
   /* Call scheduler for UL data */
   ul_metric->sched_users(*ue_db, tti_sched);
 
+  phase_tprof[mac_sched_metrics_t::UL_DATA].stop();
   return SRSLTE_SUCCESS;
 }
 
+void sched::carrier_sched::get_metrics(mac_sched_metrics_t& metrics)
+{
+  for (uint32_t i = 0; i < mac_sched_metrics_t::NOF_PHASES; ++i) {
+    phase_tprof[i].prof.get_metrics(metrics.phase[i]);
+  }
+  metrics.nof_budget_overruns += nof_budget_overruns;
+  nof_budget_overruns = 0;
+}
+
 sf_sched* sched::carrier_sched::get_sf_sched(uint32_t tti_rx)
 {
   sf_sched* ret = &sf_scheds[tti_rx % sf_scheds.size()];
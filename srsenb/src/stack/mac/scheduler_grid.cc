@@ -133,6 +133,10 @@ bool pdcch_grid_t::alloc_dci(alloc_type_t alloc_type, uint32_t aggr_idx, sched_u
 
 bool pdcch_grid_t::alloc_dci_record(const alloc_record_t& record, uint32_t cfix)
 {
+  if (cc_cfg->sched_cfg->pdcch_max_search_nodes > 0) {
+    return alloc_dci_record_bounded(record, cfix);
+  }
+
   bool  ret  = false;
   auto& tree = alloc_trees[cfix];
 
@@ -219,6 +223,149 @@ bool pdcch_grid_t::add_tree_node_leaves(alloc_tree_t&          tree,
   return ret;
 }
 
+/**
+ * Bounded-cost alternative to the alloc tree. Only one solution is kept per CFI, stored as a single route in the tree.
+ * The new DCI is placed on top of the current solution if there is space for it. Otherwise, all the DCIs are placed
+ * again, the most constrained first, through a depth-first search that gives up after a fixed number of CCE
+ * placement attempts (pdcch_max_search_nodes).
+ */
+bool pdcch_grid_t::alloc_dci_record_bounded(const alloc_record_t& record, uint32_t cfix)
+{
+  auto&  tree       = alloc_trees[cfix];
+  size_t nof_placed = tree.dci_alloc_tree.size();
+
+  search_cands.resize(nof_placed + 1);
+  dci_candidates_t& new_cands = search_cands[nof_placed];
+  set_dci_candidates(new_cands, record, cfix);
+  new_cands.record_idx = nof_placed;
+  if (new_cands.nof_cands == 0) {
+    return false;
+  }
+
+  // Greedy: take the first free position given the current solution
+  pdcch_mask_t cum_mask(tree.nof_cces);
+  if (nof_placed > 0) {
+    cum_mask = tree.dci_alloc_tree.back().node.total_mask;
+  }
+  for (uint32_t i = 0; i < new_cands.nof_cands; ++i) {
+    if ((cum_mask & new_cands.mask[i]).none()) {
+      alloc_t alloc;
+      alloc.rnti         = (record.user != nullptr) ? record.user->get_rnti() : (uint16_t)0u;
+      alloc.dci_pos.L    = record.aggr_idx;
+      alloc.dci_pos.ncce = new_cands.ncce[i];
+      alloc.current_mask = new_cands.mask[i];
+      alloc.total_mask   = cum_mask | new_cands.mask[i];
+      tree.dci_alloc_tree.emplace_back((int)nof_placed - 1, alloc);
+      tree.prev_start = nof_placed;
+      tree.prev_end   = nof_placed + 1;
+      return true;
+    }
+  }
+
+  // Backtracking: search positions for all the DCIs
+  for (size_t i = 0; i < nof_placed; ++i) {
+    set_dci_candidates(search_cands[i], dci_record_list[i], cfix);
+    search_cands[i].record_idx = i;
+  }
+  std::stable_sort(search_cands.begin(), search_cands.end(), [](const dci_candidates_t& a, const dci_candidates_t& b) {
+    return a.nof_cands < b.nof_cands;
+  });
+  if (not search_dci_positions(tree.nof_cces)) {
+    return false;
+  }
+
+  // Replace the current solution, keeping the DCIs in allocation order
+  std::sort(search_cands.begin(), search_cands.end(), [](const dci_candidates_t& a, const dci_candidates_t& b) {
+    return a.record_idx < b.record_idx;
+  });
+  tree.dci_alloc_tree.clear();
+  cum_mask.reset();
+  for (size_t i = 0; i <= nof_placed; ++i) {
+    const alloc_record_t&   rec   = (i < nof_placed) ? dci_record_list[i] : record;
+    const dci_candidates_t& cands = search_cands[i];
+    alloc_t                 alloc;
+    alloc.rnti         = (rec.user != nullptr) ? rec.user->get_rnti() : (uint16_t)0u;
+    alloc.dci_pos.L    = rec.aggr_idx;
+    alloc.dci_pos.ncce = cands.ncce[cands.chosen];
+    alloc.current_mask = cands.mask[cands.chosen];
+    cum_mask |= alloc.current_mask;
+    alloc.total_mask = cum_mask;
+    tree.dci_alloc_tree.emplace_back((int)i - 1, alloc);
+  }
+  tree.prev_start = nof_placed;
+  tree.prev_end   = nof_placed + 1;
+  return true;
+}
+
+void pdcch_grid_t::set_dci_candidates(dci_candidates_t& cands, const alloc_record_t& record, uint32_t cfix) const
+{
+  cands.nof_cands = 0;
+  cands.chosen    = 0;
+
+  const sched_dci_cce_t* dci_locs = get_cce_loc_table(record.alloc_type, record.user, cfix);
+  if (dci_locs == nullptr) {
+    return;
+  }
+  size_t nof_cces = alloc_trees[cfix].nof_cces;
+  for (uint32_t i = 0; i < dci_locs->nof_loc[record.aggr_idx]; ++i) {
+    uint32_t startpos = dci_locs->cce_start[record.aggr_idx][i];
+    if (record.alloc_type == alloc_type_t::DL_DATA and
+        record.user->pucch_sr_collision(tti_params->tti_tx_dl, startpos)) {
+      // will cause a collision in the PUCCH
+      continue;
+    }
+    pdcch_mask_t& mask = cands.mask[cands.nof_cands];
+    mask.resize(nof_cces);
+    mask.reset();
+    mask.fill(startpos, startpos + (1u << record.aggr_idx));
+    cands.ncce[cands.nof_cands++] = startpos;
+  }
+}
+
+//! Depth-first search over the candidates in search_cands. Each tried CCE position counts as one node of the budget
+bool pdcch_grid_t::search_dci_positions(size_t nof_cces)
+{
+  size_t   depth     = search_cands.size();
+  uint32_t max_nodes = cc_cfg->sched_cfg->pdcch_max_search_nodes;
+  uint32_t nof_nodes = 0;
+
+  search_cursor.assign(depth, 0);
+  search_masks.resize(depth + 1);
+  search_masks[0].resize(nof_cces);
+  search_masks[0].reset();
+
+  size_t d = 0;
+  while (true) {
+    dci_candidates_t& cands = search_cands[d];
+    uint32_t&         i     = search_cursor[d];
+    for (; i < cands.nof_cands; ++i) {
+      if (++nof_nodes > max_nodes) {
+        return false;
+      }
+      if ((search_masks[d] & cands.mask[i]).none()) {
+        break;
+      }
+    }
+
+    if (i < cands.nof_cands) {
+      // descend
+      cands.chosen        = i;
+      search_masks[d + 1] = search_masks[d] | cands.mask[i];
+      if (++d == depth) {
+        return true;
+      }
+      search_cursor[d] = 0;
+    } else {
+      // no position left for this DCI. Backtrack
+      if (d == 0) {
+        return false;
+      }
+      --d;
+      ++search_cursor[d];
+    }
+  }
+}
+
 bool pdcch_grid_t::set_cfi(uint32_t cfi)
 {
   if (cfi < cc_cfg->sched_cfg->min_nof_ctrl_symbols or cfi > cc_cfg->sched_cfg->max_nof_ctrl_symbols) {
@@ -480,6 +627,8 @@ void sf_sched::new_tti(uint32_t tti_rx_)
   rar_allocs.clear();
   data_allocs.clear();
   ul_data_allocs.clear();
+  has_deadline    = false;
+  budget_exceeded = false;
 
   tti_params = tti_params_t{tti_rx_};
   tti_alloc.new_tti(tti_params);
@@ -492,6 +641,23 @@ void sf_sched::new_tti(uint32_t tti_rx_)
   }
 }
 
+void sf_sched::set_deadline(std::chrono::steady_clock::time_point deadline_, const sched_clock_t* clock_)
+{
+  has_deadline    = true;
+  budget_exceeded = false;
+  deadline        = deadline_;
+  clock           = clock_;
+}
+
+//! Once the deadline is reached, it stays reached for the rest of the TTI so that metrics stop looking for allocations
+bool sf_sched::is_out_of_time()
+{
+  if (has_deadline and not budget_exceeded and (*clock)() >= deadline) {
+    budget_exceeded = true;
+  }
+  return budget_exceeded;
+}
+
 bool sf_sched::is_dl_alloc(sched_ue* user) const
 {
   for (const auto& a : data_allocs) {
@@ -718,7 +884,11 @@ alloc_outcome_t sf_sched::alloc_ul_user(sched_ue* user, ul_harq_proc::ul_alloc_t
 
 bool sf_sched::alloc_phich(sched_ue* user, sched_interface::ul_sched_res_t* ul_sf_result)
 {
-  using phich_t    = sched_interface::ul_sched_phich_t;
+  using phich_t = sched_interface::ul_sched_phich_t;
+  if (ul_sf_result->nof_phich_elems >= sched_interface::MAX_PHICH_LIST) {
+    log_h->warning("SCHED: Maximum number of PHICH allocations has been reached\n");
+    return false;
+  }
   auto& phich_list = ul_sf_result->phich[ul_sf_result->nof_phich_elems];
 
   auto p = user->get_cell_index(cc_cfg->enb_cc_idx);
@@ -79,6 +79,12 @@ bool harq_proc::is_empty(uint32_t tb_idx) const
   return !active[tb_idx];
 }
 
+// An ACK ends the TB, and so does a NACK once the maximum number of retxs is reached
+bool harq_proc::ack_ends_tb(uint32_t tb_idx, bool ack_) const
+{
+  return !is_empty(tb_idx) && (ack_ || n_rtx[tb_idx] + 1 >= max_retx);
+}
+
 bool harq_proc::has_pending_retx_common(uint32_t tb_idx) const
 {
   return !is_empty(tb_idx) && ack_state[tb_idx] == NACK;
@@ -95,18 +101,18 @@ int harq_proc::set_ack_common(uint32_t tb_idx, bool ack_)
     log_h->warning("Received ACK for inactive harq\n");
     return SRSLTE_ERROR;
   }
-  ack_state[tb_idx] = ack_ ? ACK : NACK;
   log_h->debug("ACK=%d received pid=%d, tb_idx=%d, n_rtx=%d, max_retx=%d\n", ack_, id, tb_idx, n_rtx[tb_idx], max_retx);
-  if (!ack_ && (n_rtx[tb_idx] + 1 >= max_retx)) {
-    Warning("SCHED: discarding TB %d pid=%d, tti=%d, maximum number of retx exceeded (%d)\n",
-            tb_idx,
-            id,
-            tti.to_uint(),
-            max_retx);
-    active[tb_idx] = false;
-  } else if (ack_) {
+  if (ack_ends_tb(tb_idx, ack_)) {
+    if (!ack_) {
+      Warning("SCHED: discarding TB %d pid=%d, tti=%d, maximum number of retx exceeded (%d)\n",
+              tb_idx,
+              id,
+              tti.to_uint(),
+              max_retx);
+    }
     active[tb_idx] = false;
   }
+  ack_state[tb_idx] = ack_ ? ACK : NACK;
   return SRSLTE_SUCCESS;
 }
 
@@ -368,6 +374,16 @@ std::pair<uint32_t, int> harq_entity::set_ack_info(uint32_t tti_rx, uint32_t tb_
   return {dl_harqs.size(), -1};
 }
 
+bool harq_entity::dl_ack_ends_tb(uint32_t tti_rx, uint32_t tb_idx, bool ack) const
+{
+  for (auto& h : dl_harqs) {
+    if (h.get_tti() + FDD_HARQ_DELAY_DL_MS == tti_point{tti_rx}) {
+      return h.ack_ends_tb(tb_idx, ack);
+    }
+  }
+  return false;
+}
+
 ul_harq_proc* harq_entity::get_ul_harq(uint32_t tti_tx_ul)
 {
   return &ul_harqs[tti_tx_ul % ul_harqs.size()];
@@ -380,6 +396,11 @@ std::pair<bool, uint32_t> harq_entity::set_ul_crc(srslte::tti_point tti_rx, uint
   return {h->set_ack(tb_idx, ack_), pid};
 }
 
+bool harq_entity::ul_crc_ends_tb(srslte::tti_point tti_rx, bool ack_) const
+{
+  return ul_harqs[tti_rx.to_uint() % ul_harqs.size()].ack_ends_tb(0, ack_);
+}
+
 void harq_entity::reset_pending_data(uint32_t tti_rx)
 {
   tti_point tti_tx_ul = srslte::to_tx_ul(tti_point{tti_rx});
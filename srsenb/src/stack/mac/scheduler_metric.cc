@@ -27,6 +27,9 @@
 
 namespace srsenb {
 
+//! Number of UEs considered between two checks of the TTI time budget
+const static uint32_t BUDGET_CHECK_PERIOD = 8;
+
 /*****************************************************************
  *
  * Downlink Metric
@@ -39,7 +42,7 @@ void dl_metric_rr::set_params(const sched_cell_params_t& cell_params_)
   log_h  = srslte::logmap::get("MAC ");
 }
 
-void dl_metric_rr::sched_users(std::map<uint16_t, sched_ue>& ue_db, dl_sf_sched_itf* tti_sched)
+void dl_metric_rr::sched_users(sched_ue_list& ue_db, dl_sf_sched_itf* tti_sched)
 {
   tti_alloc = tti_sched;
 
@@ -51,12 +54,17 @@ void dl_metric_rr::sched_users(std::map<uint16_t, sched_ue>& ue_db, dl_sf_sched_
   uint32_t priority_idx = tti_alloc->get_tti_tx_dl() % (uint32_t)ue_db.size();
   auto     iter         = ue_db.begin();
   std::advance(iter, priority_idx);
+  bool out_of_time = false;
   for (uint32_t ue_count = 0; ue_count < ue_db.size(); ++iter, ++ue_count) {
     if (iter == ue_db.end()) {
       iter = ue_db.begin(); // wrap around
     }
+    // out of time, keep the allocations found so far. The retxs of the remaining UEs are still allocated
+    if (not out_of_time and ue_count % BUDGET_CHECK_PERIOD == 0) {
+      out_of_time = tti_alloc->is_out_of_time();
+    }
     sched_ue* user = &iter->second;
-    allocate_user(user);
+    allocate_user(user, out_of_time);
   }
 }
 
@@ -82,7 +90,7 @@ bool dl_metric_rr::find_allocation(uint32_t min_nof_rbg, uint32_t max_nof_rbg, r
   return true;
 }
 
-dl_harq_proc* dl_metric_rr::allocate_user(sched_ue* user)
+dl_harq_proc* dl_metric_rr::allocate_user(sched_ue* user, bool retx_only)
 {
   // Do not allocate a user multiple times in the same tti
   if (tti_alloc->is_dl_alloc(user)) {
@@ -127,6 +135,10 @@ dl_harq_proc* dl_metric_rr::allocate_user(sched_ue* user)
     }
   }
 
+  if (retx_only) {
+    return nullptr;
+  }
+
   // If could not schedule the reTx, or there wasn't any pending retx, find an empty PID
   h = user->get_empty_dl_harq(tti_dl, cell_idx);
   if (h != nullptr) {
@@ -161,7 +173,7 @@ void ul_metric_rr::set_params(const sched_cell_params_t& cell_params_)
   log_h  = srslte::logmap::get("MAC ");
 }
 
-void ul_metric_rr::sched_users(std::map<uint16_t, sched_ue>& ue_db, ul_sf_sched_itf* tti_sched)
+void ul_metric_rr::sched_users(sched_ue_list& ue_db, ul_sf_sched_itf* tti_sched)
 {
   tti_alloc   = tti_sched;
   current_tti = tti_alloc->get_tti_tx_ul();
@@ -192,6 +204,10 @@ void ul_metric_rr::sched_users(std::map<uint16_t, sched_ue>& ue_db, ul_sf_sched_
     if (iter == ue_db.end()) {
       iter = ue_db.begin(); // wrap around
     }
+    // out of time, keep the allocations found so far. Retxs are always allocated
+    if (ue_count % BUDGET_CHECK_PERIOD == 0 and tti_alloc->is_out_of_time()) {
+      break;
+    }
     sched_ue* user = &iter->second;
     allocate_user_newtx_prbs(user);
   }
@@ -288,7 +304,7 @@ ul_harq_proc* ul_metric_rr::allocate_user_newtx_prbs(sched_ue* user)
   }
   uint32_t cell_idx = p.second;
 
-  uint32_t      pending_data = user->get_pending_ul_new_data(current_tti);
+  uint32_t      pending_data = user->get_ul_new_data_share(current_tti, cell_idx);
   ul_harq_proc* h            = user->get_ul_harq(current_tti, cell_idx);
 
   // find an empty PID
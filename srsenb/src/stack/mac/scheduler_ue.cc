@@ -305,6 +305,18 @@ void sched_ue::set_ul_crc(srslte::tti_point tti_rx, uint32_t enb_cc_idx, bool cr
   }
 }
 
+bool sched_ue::dl_ack_ends_tb(uint32_t tti_rx, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack) const
+{
+  auto p = get_cell_index(enb_cc_idx);
+  return p.first and carriers[p.second].harq_ent.dl_ack_ends_tb(tti_rx, tb_idx, ack);
+}
+
+bool sched_ue::ul_crc_ends_tb(srslte::tti_point tti_rx, uint32_t enb_cc_idx, bool crc_res) const
+{
+  auto p = get_cell_index(enb_cc_idx);
+  return p.first and carriers[p.second].harq_ent.ul_crc_ends_tb(tti_rx, crc_res);
+}
+
 void sched_ue::set_dl_ri(uint32_t tti, uint32_t enb_cc_idx, uint32_t ri)
 {
   auto p = get_cell_index(enb_cc_idx);
@@ -455,10 +467,17 @@ std::pair<int, int> sched_ue::allocate_new_dl_mac_pdu(sched::dl_sched_data_t* da
 
   /* Allocate DL UE Harq */
   if (rem_tbs != tbs) {
+    if (dl_new_data_tti != tti_tx_dl) {
+      dl_new_data_tti  = tti_tx_dl;
+      dl_new_data_sent = 0;
+    }
+    dl_new_data_sent += tbs - rem_tbs;
     h->new_tx(user_mask, tb, tti_tx_dl, mcs, tbs, data->dci.location.ncce);
     Debug("SCHED: Alloc DCI format%s new mcs=%d, tbs=%d, nof_prb=%d\n", dci_format, mcs, tbs, nof_prb);
   } else {
+    // nothing to transmit, e.g. the data was already sent in another carrier. The TB is not scheduled
     Warning("SCHED: Failed to allocate DL harq pid=%d\n", h->get_id());
+    tbs = 0;
   }
 
   return std::make_pair(tbs, mcs);
@@ -553,6 +572,11 @@ std::pair<int, int> sched_ue::compute_mcs_and_tbs(uint32_t               ue_cc_i
   int                           mcs = 0, tbs_bytes = 0;
   std::pair<uint32_t, uint32_t> req_bytes = get_requested_dl_bytes(ue_cc_idx);
 
+  // The carrier only sends its share of the data pending at the start of the TTI, for which it was allocated
+  uint32_t sent    = (dl_new_data_tti == tti_tx_dl) ? dl_new_data_sent : 0;
+  req_bytes.second = std::min(req_bytes.second, get_new_data_share(ue_cc_idx, req_bytes.second + sent));
+  req_bytes.first  = std::min(req_bytes.first, req_bytes.second);
+
   // Calculate exact number of RE for this PRB allocation
   srslte_pdsch_grant_t grant = {};
   srslte_dl_sf_cfg_t   dl_sf = {};
@@ -829,6 +853,12 @@ rbg_range_t sched_ue::get_required_dl_rbgs(uint32_t ue_cc_idx)
   if (req_bytes.first == 0 and req_bytes.second == 0) {
     return {0, 0};
   }
+  // Only the share of the new data of this carrier
+  req_bytes.second = get_new_data_share(ue_cc_idx, req_bytes.second);
+  if (req_bytes.second == 0) {
+    return {0, 0};
+  }
+  req_bytes.first = std::min(req_bytes.first, req_bytes.second);
   const auto* cellparams = carriers[ue_cc_idx].get_cell_cfg();
   int         pending_prbs =
       carriers[ue_cc_idx].get_required_prb_dl(req_bytes.first, cellparams->sched_cfg->max_nof_ctrl_symbols);
@@ -950,6 +980,12 @@ uint32_t sched_ue::get_pending_ul_new_data(uint32_t tti)
   return get_pending_ul_new_data_unlocked(tti);
 }
 
+/// Share of the pending UL data that the carrier ue_cc_idx may grant
+uint32_t sched_ue::get_ul_new_data_share(uint32_t tti, uint32_t ue_cc_idx)
+{
+  return get_new_data_share(ue_cc_idx, get_pending_ul_new_data_unlocked(tti));
+}
+
 uint32_t sched_ue::get_pending_ul_old_data(uint32_t cc_idx)
 {
   return get_pending_ul_old_data_unlocked(cc_idx);
@@ -1055,6 +1091,30 @@ ul_harq_proc* sched_ue::get_ul_harq(uint32_t tti_tx_ul, uint32_t ue_cc_idx)
   return nullptr;
 }
 
+/**
+ * Part of the pending new data that a carrier of the UE may allocate in a TTI. The data is split evenly among the
+ * active carriers, in carrier order and in shares of at least min_new_data_share bytes. Each carrier thus allocates
+ * the UE independently of the other carriers of the TTI, which then consume the buffers in carrier order
+ */
+uint32_t sched_ue::get_new_data_share(uint32_t ue_cc_idx, uint32_t pending_bytes) const
+{
+  if (not carriers[ue_cc_idx].is_active()) {
+    return pending_bytes;
+  }
+  uint32_t nof_active = 0, share_idx = 0;
+  for (uint32_t i = 0; i < carriers.size(); ++i) {
+    if (carriers[i].is_active()) {
+      share_idx += (i < ue_cc_idx) ? 1 : 0;
+      nof_active++;
+    }
+  }
+  uint32_t nof_shares = std::min(nof_active, std::max(pending_bytes / min_new_data_share, 1u));
+  if (share_idx >= nof_shares) {
+    return 0;
+  }
+  return pending_bytes / nof_shares + ((share_idx < pending_bytes % nof_shares) ? 1 : 0);
+}
+
 const dl_harq_proc& sched_ue::get_dl_harq(uint32_t idx, uint32_t ue_cc_idx) const
 {
   return carriers[ue_cc_idx].harq_ent.dl_harq_procs()[idx];
@@ -1121,12 +1181,11 @@ srslte_dci_format_t sched_ue::get_dci_format()
 
 sched_dci_cce_t* sched_ue::get_locations(uint32_t enb_cc_idx, uint32_t cfi, uint32_t sf_idx)
 {
-  if (cfi > 0 && cfi <= 3) {
-    return &carriers[get_cell_index(enb_cc_idx).second].dci_locations[cfi - 1][sf_idx];
-  } else {
+  if (cfi == 0 || cfi > 3) {
     Error("SCHED: Invalid CFI=%d\n", cfi);
-    return &carriers[get_cell_index(enb_cc_idx).second].dci_locations[0][sf_idx];
+    cfi = 1;
   }
+  return carriers[get_cell_index(enb_cc_idx).second].get_locations(cfi, sf_idx);
 }
 
 sched_ue_carrier* sched_ue::get_ue_carrier(uint32_t enb_cc_idx)
@@ -1225,13 +1284,6 @@ sched_ue_carrier::sched_ue_carrier(const sched_interface::ue_cfg_t& cfg_,
   fixed_mcs_dl = cell_params->sched_cfg->pdsch_mcs;
   fixed_mcs_ul = cell_params->sched_cfg->pusch_mcs;
 
-  // Generate allowed CCE locations
-  for (int cfi = 0; cfi < 3; cfi++) {
-    for (int sf_idx = 0; sf_idx < 10; sf_idx++) {
-      sched_utils::generate_cce_location(cell_params->regs.get(), &dci_locations[cfi][sf_idx], cfi + 1, sf_idx, rnti);
-    }
-  }
-
   set_cfg(cfg_);
 }
 
@@ -1334,21 +1386,35 @@ int sched_ue_carrier::alloc_tbs_ul(uint32_t nof_prb, uint32_t nof_re, uint32_t r
   return alloc_tbs(nof_prb, nof_re, req_bytes, true, mcs);
 }
 
-int sched_ue_carrier::get_required_prb_dl(uint32_t req_bytes, uint32_t nof_ctrl_symbols)
+//! TBS in bytes of a DL new tx with nof_prb PRBs, using the approximate number of REs
+int sched_ue_carrier::get_dl_tbs_estimate(uint32_t nof_prb, uint32_t nof_ctrl_symbols)
+{
+  int mcs = 0;
+  if (fixed_mcs_dl < 0 or not dl_cqi_rx) {
+    uint32_t nof_re = srslte_ra_dl_approx_nof_re(&cell_params->cfg.cell, nof_prb, nof_ctrl_symbols);
+    return alloc_tbs_dl(nof_prb, nof_re, 0, &mcs);
+  }
+  return srslte_ra_tbs_from_idx(srslte_ra_tbs_idx_from_mcs(fixed_mcs_dl, cfg->use_tbs_index_alt, false), nof_prb) / 8;
+}
+
+//! TBS in bytes of an UL new tx with nof_prb PRBs
+int sched_ue_carrier::get_ul_tbs_estimate(uint32_t nof_prb)
 {
-  int      mcs    = 0;
-  uint32_t nof_re = 0;
-  int      tbs    = 0;
+  int      mcs   = 0;
+  uint32_t N_srs = 0;
+  if (fixed_mcs_ul < 0) {
+    uint32_t nof_re = (2 * (SRSLTE_CP_NSYMB(cell_params->cfg.cell.cp) - 1) - N_srs) * nof_prb * SRSLTE_NRE;
+    return alloc_tbs_ul(nof_prb, nof_re, 0, &mcs);
+  }
+  return srslte_ra_tbs_from_idx(srslte_ra_tbs_idx_from_mcs(fixed_mcs_ul, false, true), nof_prb) / 8;
+}
 
+int sched_ue_carrier::get_required_prb_dl(uint32_t req_bytes, uint32_t nof_ctrl_symbols)
+{
   uint32_t nbytes = 0;
   uint32_t n;
   for (n = 0; n < cell_params->nof_prb() and nbytes < req_bytes; ++n) {
-    nof_re = srslte_ra_dl_approx_nof_re(&cell_params->cfg.cell, n + 1, nof_ctrl_symbols);
-    if (fixed_mcs_dl < 0 or not dl_cqi_rx) {
-      tbs = alloc_tbs_dl(n + 1, nof_re, 0, &mcs);
-    } else {
-      tbs = srslte_ra_tbs_from_idx(srslte_ra_tbs_idx_from_mcs(fixed_mcs_dl, cfg->use_tbs_index_alt, false), n + 1) / 8;
-    }
+    int tbs = get_dl_tbs_estimate(n + 1, nof_ctrl_symbols);
     if (tbs > 0) {
       nbytes = tbs;
     } else if (tbs < 0) {
@@ -1361,9 +1427,7 @@ int sched_ue_carrier::get_required_prb_dl(uint32_t req_bytes, uint32_t nof_ctrl_
 
 uint32_t sched_ue_carrier::get_required_prb_ul(uint32_t req_bytes)
 {
-  int      mcs    = 0;
   uint32_t nbytes = 0;
-  uint32_t N_srs  = 0;
 
   uint32_t n = 0;
   if (req_bytes == 0) {
@@ -1371,13 +1435,7 @@ uint32_t sched_ue_carrier::get_required_prb_ul(uint32_t req_bytes)
   }
 
   for (n = 1; n < cell_params->nof_prb() && nbytes < req_bytes + 4; n++) {
-    uint32_t nof_re = (2 * (SRSLTE_CP_NSYMB(cell_params->cfg.cell.cp) - 1) - N_srs) * n * SRSLTE_NRE;
-    int      tbs    = 0;
-    if (fixed_mcs_ul < 0) {
-      tbs = alloc_tbs_ul(n, nof_re, 0, &mcs);
-    } else {
-      tbs = srslte_ra_tbs_from_idx(srslte_ra_tbs_idx_from_mcs(fixed_mcs_ul, false, true), n) / 8;
-    }
+    int tbs = get_ul_tbs_estimate(n);
     if (tbs > 0) {
       nbytes = tbs;
     }
@@ -1403,4 +1461,13 @@ void sched_ue_carrier::set_dl_cqi(uint32_t tti_tx_dl, uint32_t dl_cqi_)
   }
 }
 
+sched_dci_cce_t* sched_ue_carrier::get_locations(uint32_t cfi, uint32_t sf_idx)
+{
+  if (dci_locations_sf[cfi - 1] != sf_idx) {
+    sched_utils::generate_cce_location(cell_params->regs.get(), &dci_locations[cfi - 1], cfi, sf_idx, rnti);
+    dci_locations_sf[cfi - 1] = sf_idx;
+  }
+  return &dci_locations[cfi - 1];
+}
+
 } // namespace srsenb
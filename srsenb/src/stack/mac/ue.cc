@@ -30,16 +30,18 @@
 
 namespace srsenb {
 
-ue::ue(uint16_t                 rnti_,
-       uint32_t                 nof_prb_,
-       sched_interface*         sched_,
-       rrc_interface_mac*       rrc_,
-       rlc_interface_mac*       rlc_,
-       phy_interface_stack_lte* phy_,
-       srslte::log_ref          log_,
-       uint32_t                 nof_cells_,
-       uint32_t                 nof_rx_harq_proc_,
-       uint32_t                 nof_tx_harq_proc_) :
+ue::ue(uint16_t                  rnti_,
+       uint32_t                  nof_prb_,
+       sched_interface*          sched_,
+       rrc_interface_mac*        rrc_,
+       rlc_interface_mac*        rlc_,
+       phy_interface_stack_lte*  phy_,
+       srslte::log_ref           log_,
+       uint32_t                  nof_cells_,
+       srslte_softbuffer_pool_t* rx_pool_,
+       srslte_softbuffer_pool_t* tx_pool_,
+       uint32_t                  nof_rx_harq_proc_,
+       uint32_t                  nof_tx_harq_proc_) :
   rnti(rnti_),
   nof_prb(nof_prb_),
   sched(sched_),
@@ -53,6 +55,8 @@ ue::ue(uint16_t                 rnti_,
   pdus(128),
   nof_rx_harq_proc(nof_rx_harq_proc_),
   nof_tx_harq_proc(nof_tx_harq_proc_),
+  rx_pool(rx_pool_),
+  tx_pool(tx_pool_),
   ta_fsm(this)
 {
   srslte::byte_buffer_pool* pool = srslte::byte_buffer_pool::get_instance();
@@ -78,14 +82,14 @@ ue::ue(uint16_t                 rnti_,
 ue::~ue()
 {
   // Free up all softbuffers for all CCs
-  for (auto cc : softbuffer_rx) {
-    for (auto buffer : cc) {
+  for (auto& cc : softbuffer_rx) {
+    for (auto& buffer : cc) {
       srslte_softbuffer_rx_free(&buffer);
     }
   }
 
-  for (auto cc : softbuffer_tx) {
-    for (auto buffer : cc) {
+  for (auto& cc : softbuffer_tx) {
+    for (auto& buffer : cc) {
       srslte_softbuffer_tx_free(&buffer);
     }
   }
@@ -96,14 +100,14 @@ void ue::reset()
   metrics      = {};
   nof_failures = 0;
 
-  for (auto cc : softbuffer_rx) {
-    for (auto buffer : cc) {
+  for (auto& cc : softbuffer_rx) {
+    for (auto& buffer : cc) {
       srslte_softbuffer_rx_reset(&buffer);
     }
   }
 
-  for (auto cc : softbuffer_tx) {
-    for (auto buffer : cc) {
+  for (auto& cc : softbuffer_tx) {
+    for (auto& buffer : cc) {
       srslte_softbuffer_tx_reset(&buffer);
     }
   }
@@ -124,7 +128,11 @@ uint32_t ue::allocate_cc_buffers(const uint32_t num_cc)
     softbuffer_rx.emplace_back();
     softbuffer_rx.back().resize(nof_rx_harq_proc);
     for (auto& buffer : softbuffer_rx.back()) {
-      srslte_softbuffer_rx_init(&buffer, nof_prb);
+      if (rx_pool != nullptr) {
+        srslte_softbuffer_rx_init_pool(&buffer, nof_prb, rx_pool);
+      } else {
+        srslte_softbuffer_rx_init(&buffer, nof_prb);
+      }
     }
 
     pending_buffers.emplace_back();
@@ -137,7 +145,15 @@ uint32_t ue::allocate_cc_buffers(const uint32_t num_cc)
     softbuffer_tx.emplace_back();
     softbuffer_tx.back().resize(nof_tx_harq_proc);
     for (auto& buffer : softbuffer_tx.back()) {
-      srslte_softbuffer_tx_init(&buffer, nof_prb);
+      if (tx_pool != nullptr) {
+        srslte_softbuffer_tx_init_pool(&buffer, nof_prb, tx_pool);
+      } else {
+        srslte_softbuffer_tx_init(&buffer, nof_prb);
+      }
+    }
+    softbuffer_tx_tti.emplace_back(nof_tx_harq_proc);
+    for (auto& tti : softbuffer_tx_tti.back()) {
+      tti.store(UINT32_MAX, std::memory_order_relaxed);
     }
     // don't need to reset because just initiated the buffers
   }
@@ -174,10 +190,37 @@ srslte_softbuffer_rx_t* ue::get_rx_softbuffer(const uint32_t ue_cc_idx, const ui
   return &softbuffer_rx.at(ue_cc_idx).at(tti % nof_rx_harq_proc);
 }
 
-srslte_softbuffer_tx_t*
-ue::get_tx_softbuffer(const uint32_t ue_cc_idx, const uint32_t harq_process, const uint32_t tb_idx)
+srslte_softbuffer_tx_t* ue::get_tx_softbuffer(const uint32_t ue_cc_idx,
+                                              const uint32_t harq_process,
+                                              const uint32_t tb_idx,
+                                              const uint32_t tti_tx_dl)
+{
+  uint32_t idx = (harq_process * SRSLTE_MAX_TB + tb_idx) % nof_tx_harq_proc;
+  softbuffer_tx_tti.at(ue_cc_idx).at(idx).store(tti_tx_dl, std::memory_order_release);
+  return &softbuffer_tx.at(ue_cc_idx).at(idx);
+}
+
+void ue::release_tx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti_ack, const uint32_t tb_idx)
 {
-  return &softbuffer_tx.at(ue_cc_idx).at((harq_process * SRSLTE_MAX_TB + tb_idx) % nof_tx_harq_proc);
+  if (tx_pool == nullptr || ue_cc_idx >= softbuffer_tx.size()) {
+    return;
+  }
+  // The HARQ process is not known here, find it from the TTI the TB was transmitted in
+  uint32_t tti_tx_dl = TTI_SUB(tti_ack, FDD_HARQ_DELAY_DL_MS);
+  for (uint32_t idx = tb_idx; idx < (uint32_t)nof_tx_harq_proc; idx += SRSLTE_MAX_TB) {
+    uint32_t tti = tti_tx_dl;
+    if (softbuffer_tx_tti[ue_cc_idx][idx].compare_exchange_strong(tti, UINT32_MAX, std::memory_order_acq_rel)) {
+      srslte_softbuffer_tx_release(&softbuffer_tx[ue_cc_idx][idx]);
+      return;
+    }
+  }
+}
+
+void ue::release_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti_rx)
+{
+  if (rx_pool != nullptr && ue_cc_idx < softbuffer_rx.size()) {
+    srslte_softbuffer_rx_release(&softbuffer_rx[ue_cc_idx][tti_rx % nof_rx_harq_proc]);
+  }
 }
 
 uint8_t* ue::request_buffer(const uint32_t ue_cc_idx, const uint32_t tti, const uint32_t len)
@@ -37,10 +37,7 @@ using namespace asn1::rrc;
 
 namespace srsenb {
 
-rrc::rrc() : rrc_log("RRC")
-{
-  pending_paging.clear();
-}
+rrc::rrc() : rrc_log("RRC") {}
 
 rrc::~rrc() {}
 
@@ -72,6 +69,10 @@ void rrc::init(const rrc_cfg_t&       cfg_,
 
   pucch_res_list.reset(new freq_res_common_list{cfg});
 
+  // Default paging cycle, should get DRX from user
+  uint32_t T = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.default_paging_cycle.to_number();
+  pending_paging.reset(new paging_manager(T, T * cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.nb.to_number()));
+
   // Loads the PRACH root sequence
   cfg.sibs[1].sib2().rr_cfg_common.prach_cfg.root_seq_idx = cfg.cell_list[0].root_seq_idx;
 
@@ -448,115 +449,45 @@ bool rrc::release_erabs(uint32_t rnti)
 
 void rrc::add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_paging_id)
 {
-  std::lock_guard<std::mutex> lock(paging_mutex);
-  if (pending_paging.count(ueid) > 0) {
-    rrc_log->warning("Received Paging for UEID=%d but not yet transmitted\n", ueid);
-    return;
-  }
-
-  paging_record_s paging_elem;
   if (ue_paging_id.type().value == asn1::s1ap::ue_paging_id_c::types_opts::imsi) {
-    paging_elem.ue_id.set_imsi();
-    paging_elem.ue_id.imsi().resize(ue_paging_id.imsi().size());
-    memcpy(paging_elem.ue_id.imsi().data(), ue_paging_id.imsi().data(), ue_paging_id.imsi().size());
     rrc_log->console("Warning IMSI paging not tested\n");
-  } else {
-    paging_elem.ue_id.set_s_tmsi();
-    paging_elem.ue_id.s_tmsi().mmec.from_number(ue_paging_id.s_tmsi().mmec[0]);
-    uint32_t m_tmsi     = 0;
-    uint32_t nof_octets = ue_paging_id.s_tmsi().m_tmsi.size();
-    for (uint32_t i = 0; i < nof_octets; i++) {
-      m_tmsi |= ue_paging_id.s_tmsi().m_tmsi[i] << (8u * (nof_octets - i - 1u));
-    }
-    paging_elem.ue_id.s_tmsi().m_tmsi.from_number(m_tmsi);
   }
-  paging_elem.cn_domain = paging_record_s::cn_domain_e_::ps;
+  paging_record_s paging_elem = make_paging_record(ue_paging_id);
 
-  pending_paging.insert(std::make_pair(ueid, paging_elem));
+  std::lock_guard<std::mutex> lock(paging_mutex);
+  pending_paging->add_paging_record(ueid, paging_elem);
 }
 
-// Described in Section 7 of 36.304
+// The PCCH messages are packed as the paging records arrive, a paging occasion only copies the PDU
 bool rrc::is_paging_opportunity(uint32_t tti, uint32_t* payload_len)
 {
-  constexpr static int sf_pattern[4][4] = {{9, 4, -1, 0}, {-1, 9, -1, 4}, {-1, -1, -1, 5}, {-1, -1, -1, 9}};
-
-  if (pending_paging.empty()) {
+  std::lock_guard<std::mutex> lock(paging_mutex);
+  if (pending_paging->empty()) {
     return false;
   }
 
-  asn1::rrc::pcch_msg_s pcch_msg;
-  pcch_msg.msg.set_c1();
-  paging_s* paging_rec = &pcch_msg.msg.c1().paging();
-
-  // Default paging cycle, should get DRX from user
-  uint32_t T  = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.default_paging_cycle.to_number();
-  uint32_t Nb = T * cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.nb.to_number();
-
-  uint32_t N   = T < Nb ? T : Nb;
-  uint32_t Ns  = Nb / T > 1 ? Nb / T : 1;
-  uint32_t sfn = tti / 10;
-
-  std::vector<uint32_t> ue_to_remove;
-
-  {
-    std::lock_guard<std::mutex> lock(paging_mutex);
-
-    int n = 0;
-    for (auto& item : pending_paging) {
-      if (n >= ASN1_RRC_MAX_PAGE_REC) {
-        break;
-      }
-      const asn1::rrc::paging_record_s& u    = item.second;
-      uint32_t                          ueid = ((uint32_t)item.first) % 1024;
-      uint32_t                          i_s  = (ueid / N) % Ns;
-
-      if ((sfn % T) != (T / N) * (ueid % N)) {
-        continue;
-      }
-
-      int sf_idx = sf_pattern[i_s % 4][(Ns - 1) % 4];
-      if (sf_idx < 0) {
-        rrc_log->error("SF pattern is N/A for Ns=%d, i_s=%d, imsi_decimal=%d\n", Ns, i_s, ueid);
-        continue;
-      }
-
-      if ((uint32_t)sf_idx == (tti % 10)) {
-        paging_rec->paging_record_list_present = true;
-        paging_rec->paging_record_list.push_back(u);
-        ue_to_remove.push_back(ueid);
-        n++;
-        rrc_log->info("Assembled paging for ue_id=%d, tti=%d\n", ueid, tti);
-      }
-    }
-
-    for (unsigned int i : ue_to_remove) {
-      pending_paging.erase(i);
-    }
+  const paging_manager::pcch_pdu_t* pcch = pending_paging->get_pcch(tti);
+  if (pcch == nullptr) {
+    return false;
   }
 
-  if (paging_rec->paging_record_list.size() > 0) {
-    byte_buf_paging.clear();
-    asn1::bit_ref bref(byte_buf_paging.msg, byte_buf_paging.get_tailroom());
-    if (pcch_msg.pack(bref) == asn1::SRSASN_ERROR_ENCODE_FAIL) {
-      rrc_log->error("Failed to pack PCCH\n");
-      return false;
-    }
-    byte_buf_paging.N_bytes = (uint32_t)bref.distance_bytes();
-    uint32_t N_bits         = (uint32_t)bref.distance();
-
-    if (payload_len) {
-      *payload_len = byte_buf_paging.N_bytes;
-    }
-    rrc_log->info("Assembling PCCH payload with %d UE identities, payload_len=%d bytes, nbits=%d\n",
-                  paging_rec->paging_record_list.size(),
-                  byte_buf_paging.N_bytes,
-                  N_bits);
-    log_rrc_message("PCCH-Message", Tx, &byte_buf_paging, pcch_msg, pcch_msg.msg.c1().type().to_string());
-
-    return true;
+  byte_buf_paging.clear();
+  memcpy(byte_buf_paging.msg, pcch->pdu.data(), pcch->pdu.size());
+  byte_buf_paging.N_bytes = (uint32_t)pcch->pdu.size();
+  if (payload_len) {
+    *payload_len = byte_buf_paging.N_bytes;
   }
+  for (uint32_t ueid : pcch->ueids) {
+    rrc_log->debug("Assembled paging for ue_id=%d, tti=%d\n", ueid, tti);
+  }
+  rrc_log->info("Assembling PCCH payload with %zd UE identities, payload_len=%d bytes, nbits=%d\n",
+                pcch->ueids.size(),
+                byte_buf_paging.N_bytes,
+                pcch->nof_bits);
+  log_rrc_message("PCCH-Message", Tx, &byte_buf_paging, pcch->msg, pcch->msg.msg.c1().type().to_string());
 
-  return false;
+  pending_paging->pop_pcch(tti);
+  return true;
 }
 
 void rrc::read_pdu_pcch(uint8_t* payload, uint32_t buffer_size)
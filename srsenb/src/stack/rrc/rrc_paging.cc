@@ -0,0 +1,162 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/rrc/rrc_paging.h"
+
+using namespace asn1::rrc;
+
+namespace srsenb {
+
+asn1::rrc::paging_record_s make_paging_record(const asn1::s1ap::ue_paging_id_c& ue_paging_id)
+{
+  paging_record_s paging_elem;
+  if (ue_paging_id.type().value == asn1::s1ap::ue_paging_id_c::types_opts::imsi) {
+    paging_elem.ue_id.set_imsi();
+    paging_elem.ue_id.imsi().resize(ue_paging_id.imsi().size());
+    memcpy(paging_elem.ue_id.imsi().data(), ue_paging_id.imsi().data(), ue_paging_id.imsi().size());
+  } else {
+    paging_elem.ue_id.set_s_tmsi();
+    paging_elem.ue_id.s_tmsi().mmec.from_number(ue_paging_id.s_tmsi().mmec[0]);
+    uint32_t m_tmsi     = 0;
+    uint32_t nof_octets = ue_paging_id.s_tmsi().m_tmsi.size();
+    for (uint32_t i = 0; i < nof_octets; i++) {
+      m_tmsi |= ue_paging_id.s_tmsi().m_tmsi[i] << (8u * (nof_octets - i - 1u));
+    }
+    paging_elem.ue_id.s_tmsi().m_tmsi.from_number(m_tmsi);
+  }
+  paging_elem.cn_domain = paging_record_s::cn_domain_e_::ps;
+  return paging_elem;
+}
+
+paging_manager::paging_manager(uint32_t T_, uint32_t Nb_) :
+  T(T_),
+  N(T_ < Nb_ ? T_ : Nb_),
+  Ns(Nb_ / T_ > 1 ? Nb_ / T_ : 1)
+{
+  // The fields before the records are the bits a message with a single record has on top of the record itself
+  pcch_msg_s      msg;
+  paging_record_s rec;
+  rec.ue_id.set_s_tmsi();
+  rec.cn_domain = paging_record_s::cn_domain_e_::ps;
+  msg.msg.set_c1().paging().paging_record_list_present = true;
+  msg.msg.c1().paging().paging_record_list.push_back(rec);
+
+  uint8_t       buffer[64];
+  asn1::bit_ref bref(buffer, sizeof(buffer));
+  asn1::bit_ref bref_rec(buffer, sizeof(buffer));
+  msg.msg.pack(bref); // without the final byte alignment
+  pcch_hdr.assign(buffer, buffer + bref.distance_bytes());
+  rec.pack(bref_rec);
+  pcch_hdr_bits = bref.distance() - bref_rec.distance();
+}
+
+// Copies n_bits bits, MSB first, to the given bit offset of dst
+static void copy_bits(std::vector<uint8_t>& dst, uint32_t dst_offset, const uint8_t* src, uint32_t n_bits)
+{
+  if (dst.size() < (dst_offset + n_bits + 7) / 8) {
+    dst.resize((dst_offset + n_bits + 7) / 8, 0);
+  }
+  for (uint32_t i = 0; i < n_bits; ++i, ++dst_offset) {
+    uint8_t mask = 0x80u >> (dst_offset % 8);
+    if (src[i / 8] & (0x80u >> (i % 8))) {
+      dst[dst_offset / 8] |= mask;
+    } else {
+      dst[dst_offset / 8] &= ~mask;
+    }
+  }
+}
+
+// Described in Section 7 of 36.304
+int paging_manager::get_paging_occasion(uint32_t ueid, uint32_t* pf_offset) const
+{
+  constexpr static int sf_pattern[4][4] = {{9, 4, -1, 0}, {-1, 9, -1, 4}, {-1, -1, -1, 5}, {-1, -1, -1, 9}};
+
+  ueid         = ueid % 1024;
+  uint32_t i_s = (ueid / N) % Ns;
+  if (pf_offset != nullptr) {
+    *pf_offset = (T / N) * (ueid % N);
+  }
+  return sf_pattern[i_s % 4][(Ns - 1) % 4];
+}
+
+bool paging_manager::add_paging_record(uint32_t ueid, const asn1::rrc::paging_record_s& rec)
+{
+  if (pending_ueids.count(ueid) > 0) {
+    log_h->warning("Received Paging for UEID=%d but not yet transmitted\n", ueid);
+    return false;
+  }
+
+  uint32_t pf_offset;
+  int      sf_idx = get_paging_occasion(ueid, &pf_offset);
+  if (sf_idx < 0) {
+    log_h->error("SF pattern is N/A for Ns=%d, ue_id=%d\n", Ns, ueid);
+    return false;
+  }
+
+  uint8_t       buffer[64];
+  asn1::bit_ref bref(buffer, sizeof(buffer));
+  if (rec.pack(bref) == asn1::SRSASN_ERROR_ENCODE_FAIL) {
+    log_h->error("Failed to pack PCCH\n");
+    return false;
+  }
+
+  std::deque<pcch_pdu_t>& pcch_list = occasions[pf_offset * 10 + sf_idx];
+  if (pcch_list.empty() or pcch_list.back().ueids.size() >= ASN1_RRC_MAX_PAGE_REC) {
+    pcch_list.emplace_back();
+    pcch_list.back().msg.msg.set_c1().paging().paging_record_list_present = true;
+    copy_bits(pcch_list.back().pdu, 0, pcch_hdr.data(), pcch_hdr_bits);
+    pcch_list.back().nof_bits = pcch_hdr_bits;
+  }
+  pcch_pdu_t& pcch = pcch_list.back();
+  pcch.msg.msg.c1().paging().paging_record_list.push_back(rec);
+
+  // Append the record and update the record count, coded as count - 1 in the 4 bits preceding the records
+  copy_bits(pcch.pdu, pcch.nof_bits, buffer, bref.distance());
+  pcch.nof_bits += bref.distance();
+  uint8_t count = (uint8_t)((pcch.msg.msg.c1().paging().paging_record_list.size() - 1) << 4u);
+  copy_bits(pcch.pdu, pcch_hdr_bits - 4, &count, 4);
+  pcch.ueids.push_back(ueid);
+  pending_ueids.insert(ueid);
+  return true;
+}
+
+const paging_manager::pcch_pdu_t* paging_manager::get_pcch(uint32_t tti) const
+{
+  auto it = occasions.find(tti_to_occasion(tti));
+  return it == occasions.end() ? nullptr : &it->second.front();
+}
+
+void paging_manager::pop_pcch(uint32_t tti)
+{
+  auto it = occasions.find(tti_to_occasion(tti));
+  if (it == occasions.end()) {
+    return;
+  }
+  for (uint32_t ueid : it->second.front().ueids) {
+    pending_ueids.erase(ueid);
+  }
+  it->second.pop_front();
+  if (it->second.empty()) {
+    occasions.erase(it);
+  }
+}
+
+} // namespace srsenb
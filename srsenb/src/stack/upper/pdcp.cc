@@ -40,7 +40,7 @@ void pdcp::init(rlc_interface_pdcp* rlc_, rrc_interface_pdcp* rrc_, gtpu_interfa
 
 void pdcp::stop()
 {
-  for (std::map<uint32_t, user_interface>::iterator iter = users.begin(); iter != users.end(); ++iter) {
+  for (auto iter = users.begin(); iter != users.end(); ++iter) {
     clear_user(&iter->second);
   }
   users.clear();
@@ -63,6 +63,17 @@ public:
     metrics[0].phy->dl.mcs            = 28.0;
     metrics[0].phy->ul.mcs            = 20.2;
     metrics[0].phy->ul.sinr           = 14.2;
+    metrics[0].phy_rt.proc.p50_us     = 650.0;
+    metrics[0].phy_rt.proc.p99_us     = 1210.0;
+    metrics[0].phy_rt.tx.p50_us       = 720.0;
+    metrics[0].phy_rt.tx.p99_us       = 2950.0;
+    metrics[0].phy_rt.tx.max_us       = 3120.0;
+    metrics[0].phy_rt.nof_late        = 2;
+    metrics[0].stack.mac_sched.phase[mac_sched_metrics_t::DL_DATA].avg_us = 120.0;
+    metrics[0].stack.mac_sched.phase[mac_sched_metrics_t::DL_DATA].max_us = 310.0;
+    metrics[0].stack.mac_sched.phase[mac_sched_metrics_t::TTI].avg_us     = 240.0;
+    metrics[0].stack.mac_sched.phase[mac_sched_metrics_t::TTI].max_us     = 780.0;
+    metrics[0].stack.mac_sched.nof_budget_overruns                        = 3;
 
     // second
     metrics[1].rf.rf_o                = 10;
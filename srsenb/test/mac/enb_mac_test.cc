@@ -0,0 +1,301 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "scheduler_test_utils.h"
+#include "srsenb/hdr/stack/mac/mac.h"
+#include "srslte/common/test_common.h"
+
+using namespace srsenb;
+
+/*******************
+ *     Dummies     *
+ *******************/
+
+class phy_mac_dummy : public phy_interface_stack_lte
+{
+public:
+  int  add_rnti(uint16_t rnti, uint32_t pcell_index, bool is_temporal) override { return SRSLTE_SUCCESS; }
+  void rem_rnti(uint16_t rnti) override {}
+  void set_mch_period_stop(uint32_t stop) override {}
+  void set_activation_deactivation_scell(uint16_t                                     rnti,
+                                         const std::array<bool, SRSLTE_MAX_CARRIERS>& activation) override
+  {}
+  void configure_mbsfn(asn1::rrc::sib_type2_s*      sib2,
+                       asn1::rrc::sib_type13_r9_s*  sib13,
+                       const asn1::rrc::mcch_msg_s& mcch) override
+  {}
+  void set_config_dedicated(uint16_t rnti, const phy_rrc_dedicated_list_t& dedicated_list) override {}
+  void complete_config_dedicated(uint16_t rnti) override {}
+};
+
+class rlc_mac_dummy : public rlc_interface_mac
+{
+public:
+  int  read_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) override { return nof_bytes; }
+  void read_pdu_pcch(uint8_t* payload, uint32_t buffer_size) override {}
+  void write_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) override {}
+};
+
+class rrc_mac_dummy : public rrc_interface_mac
+{
+public:
+  void     rl_failure(uint16_t rnti) override {}
+  void     add_user(uint16_t rnti, const sched_interface::ue_cfg_t& init_ue_cfg) override {}
+  void     upd_user(uint16_t new_rnti, uint16_t old_rnti) override {}
+  void     set_activity_user(uint16_t rnti) override {}
+  bool     is_paging_opportunity(uint32_t tti, uint32_t* payload_len) override { return false; }
+  uint8_t* read_pdu_bcch_dlsch(const uint8_t enb_cc_idx, const uint32_t sib_index) override { return sib_payload; }
+
+private:
+  uint8_t sib_payload[256] = {};
+};
+
+class stack_mac_dummy : public stack_interface_mac_lte
+{
+public:
+  srslte::timer_handler::unique_timer    get_unique_timer() override { return timers.get_unique_timer(); }
+  srslte::task_multiqueue::queue_handler make_task_queue() override { return pending_tasks.get_queue_handler(); }
+  void defer_callback(uint32_t duration_ms, std::function<void()> func) override
+  {
+    timers.defer_callback(duration_ms, func);
+  }
+  void defer_task(srslte::move_task_t func) override { func(); }
+  void enqueue_background_task(std::function<void(uint32_t)> task) override { task(0); }
+  void notify_background_task_result(srslte::move_task_t task) override { task(); }
+
+  void run_pending_tasks()
+  {
+    srslte::move_task_t task;
+    while (pending_tasks.try_pop(&task) >= 0) {
+      task();
+    }
+  }
+
+private:
+  srslte::timer_handler   timers;
+  srslte::task_multiqueue pending_tasks;
+};
+
+/*******************
+ *      Tests      *
+ *******************/
+
+struct mac_tester {
+  phy_mac_dummy   phy;
+  rlc_mac_dummy   rlc;
+  rrc_mac_dummy   rrc;
+  stack_mac_dummy stack;
+  srsenb::mac     mac;
+
+  mac_interface_phy_lte::dl_sched_list_t dl_sched_res{1};
+  mac_interface_phy_lte::ul_sched_list_t ul_sched_res{1};
+
+  // HARQ feedback the PHY reports for every UE grant, in the TTI it receives it
+  bool                                                                       dl_ack = true;
+  bool                                                                       ul_crc = true;
+  std::vector<std::pair<uint32_t, srslte_dci_dl_t> >                         pending_dl_acks;
+  std::vector<std::pair<uint32_t, mac_interface_phy_lte::ul_sched_grant_t> > pending_ul_crcs;
+
+  mac_tester()
+  {
+    mac_args_t args = {};
+    args.nof_prb    = 25;
+    mac.init(args, cell_list_t(1), &phy, &rlc, &rrc, &stack, srslte::logmap::get("MAC"));
+    mac.cell_cfg({generate_default_cell_cfg(args.nof_prb)});
+  }
+
+  // Runs the MAC calls of the PHY worker processing tti_rx
+  void run_tti(uint32_t tti_rx)
+  {
+    stack.run_pending_tasks();
+    send_feedback(tti_rx);
+
+    mac.get_dl_sched(TTI_TX(tti_rx), dl_sched_res);
+    for (uint32_t i = 0; i < dl_sched_res[0].nof_grants; ++i) {
+      if (SRSLTE_RNTI_ISUSER(dl_sched_res[0].pdsch[i].dci.rnti)) {
+        pending_dl_acks.emplace_back(TTI_ADD(TTI_TX(tti_rx), FDD_HARQ_DELAY_DL_MS), dl_sched_res[0].pdsch[i].dci);
+      }
+    }
+    mac.get_ul_sched(TTI_RX_ACK(tti_rx), ul_sched_res);
+    for (uint32_t i = 0; i < ul_sched_res[0].nof_grants; ++i) {
+      pending_ul_crcs.emplace_back(TTI_RX_ACK(tti_rx), ul_sched_res[0].pusch[i]);
+    }
+
+    mac.tti_done(tti_rx);
+    mac.process_pdus();
+  }
+
+  void send_feedback(uint32_t tti_rx)
+  {
+    for (auto it = pending_ul_crcs.begin(); it != pending_ul_crcs.end();) {
+      if (it->first == tti_rx) {
+        if (ul_crc) {
+          // Padding only MAC PDU
+          it->second.data[0] = 0x1f;
+        }
+        mac.crc_info(tti_rx, it->second.dci.rnti, 0, 1, ul_crc);
+        it = pending_ul_crcs.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (auto it = pending_dl_acks.begin(); it != pending_dl_acks.end();) {
+      if (it->first == tti_rx) {
+        for (uint32_t tb = 0; tb < SRSLTE_MAX_TB; ++tb) {
+          if (SRSLTE_DCI_IS_TB_EN(it->second.tb[tb])) {
+            mac.ack_info(tti_rx, it->second.rnti, 0, tb, dl_ack);
+          }
+        }
+        it = pending_dl_acks.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  uint16_t rach(uint32_t prach_tti)
+  {
+    mac.rach_detected(prach_tti, 0, 0, 0);
+    stack.run_pending_tasks();
+    // The new UE has the highest RNTI
+    mac_metrics_t metrics[ENB_METRICS_MAX_USERS] = {};
+    mac.get_metrics(metrics);
+    uint16_t rnti = 0;
+    for (auto& m : metrics) {
+      rnti = std::max(rnti, m.rnti);
+    }
+    return rnti;
+  }
+
+  bool has_ul_grant(uint16_t rnti) const
+  {
+    for (uint32_t i = 0; i < ul_sched_res[0].nof_grants; ++i) {
+      if (ul_sched_res[0].pusch[i].dci.rnti == rnti) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  uint32_t nof_rx_buffers_in_use()
+  {
+    srslte_softbuffer_pool_metrics_t rx = {}, tx = {};
+    mac.get_softbuffer_pool_metrics(rx, tx);
+    return rx.nof_in_use;
+  }
+
+  uint32_t nof_tx_buffers_in_use()
+  {
+    srslte_softbuffer_pool_metrics_t rx = {}, tx = {};
+    mac.get_softbuffer_pool_metrics(rx, tx);
+    return tx.nof_in_use;
+  }
+};
+
+/// A UE removed while the PHY still holds its Msg3 grant must outlive the TTI in which that grant is decoded
+int test_ue_rem_with_ul_grant()
+{
+  mac_tester t;
+  uint32_t   prach_tti = 10230;
+
+  uint16_t rnti = t.rach(prach_tti);
+  TESTASSERT(rnti != 0);
+
+  // Schedule until the Msg3 grant, which holds code block buffers of the Rx pool
+  uint32_t tti_rx = TTI_ADD(prach_tti, 1);
+  uint32_t msg3_tti;
+  for (uint32_t n = 0;; ++n) {
+    TESTASSERT(n < 20);
+    t.run_tti(tti_rx);
+    if (t.has_ul_grant(rnti)) {
+      msg3_tti = TTI_RX_ACK(tti_rx);
+      break;
+    }
+    tti_rx = TTI_ADD(tti_rx, 1);
+  }
+  TESTASSERT(t.nof_rx_buffers_in_use() > 0);
+
+  // The UE is kept while the PHY may still decode the Msg3 into its softbuffer
+  TESTASSERT(t.mac.ue_rem(rnti) == SRSLTE_SUCCESS);
+  TESTASSERT(t.nof_rx_buffers_in_use() > 0);
+  for (tti_rx = TTI_ADD(tti_rx, 1); tti_rx != msg3_tti; tti_rx = TTI_ADD(tti_rx, 1)) {
+    t.run_tti(tti_rx);
+    TESTASSERT(not t.has_ul_grant(rnti));
+    TESTASSERT(t.nof_rx_buffers_in_use() > 0);
+  }
+
+  // Once the PHY is done with the Msg3 TTI, the UE is deleted and returns its buffers
+  t.run_tti(msg3_tti);
+  TESTASSERT(t.nof_rx_buffers_in_use() == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+/// TBs that exhaust their retxs must give their code block buffers back, without waiting for their HARQ to be reused
+int test_failed_tbs_release_buffers()
+{
+  mac_tester t;
+  uint32_t   tti_rx = 0;
+
+  // Failed Msg3 retxs
+  t.ul_crc      = false;
+  uint16_t rnti = t.rach(tti_rx);
+  TESTASSERT(rnti != 0);
+  bool msg3_sent = false;
+  for (uint32_t n = 0; n < 40; ++n) {
+    tti_rx = TTI_ADD(tti_rx, 1);
+    t.run_tti(tti_rx);
+    msg3_sent |= t.has_ul_grant(rnti);
+  }
+  TESTASSERT(msg3_sent);
+  TESTASSERT(t.pending_ul_crcs.empty());
+  TESTASSERT(t.nof_rx_buffers_in_use() == 0);
+
+  // Failed DL retxs of a UE whose Msg3 was received
+  t.ul_crc = true;
+  t.dl_ack = false;
+  rnti     = t.rach(tti_rx);
+  TESTASSERT(rnti != 0);
+  TESTASSERT(t.mac.rlc_buffer_state(rnti, 0, 50, 0) == SRSLTE_SUCCESS);
+  bool dl_sent = false;
+  for (uint32_t n = 0; n < 200; ++n) {
+    tti_rx = TTI_ADD(tti_rx, 1);
+    t.run_tti(tti_rx);
+    dl_sent |= t.nof_tx_buffers_in_use() > 0;
+  }
+  TESTASSERT(dl_sent);
+  TESTASSERT(t.pending_dl_acks.empty());
+  TESTASSERT(t.nof_tx_buffers_in_use() == 0);
+  TESTASSERT(t.nof_rx_buffers_in_use() == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_NONE);
+  srslte::logmap::get("TEST")->set_level(srslte::LOG_LEVEL_INFO);
+
+  TESTASSERT(test_ue_rem_with_ul_grant() == SRSLTE_SUCCESS);
+  TESTASSERT(test_failed_tbs_release_buffers() == SRSLTE_SUCCESS);
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
@@ -144,6 +144,113 @@ int test_pdcch_one_ue()
   return SRSLTE_SUCCESS;
 }
 
+struct pdcch_alloc_stats {
+  uint32_t nof_attempts = 0;
+  uint32_t nof_success  = 0;
+  double   total_us     = 0;
+  double   max_tti_us   = 0;
+};
+
+/// Allocates nof_dcis DCIs per TTI for as many UEs and checks that the resulting CCE allocation is valid
+int run_pdcch_many_ues(uint32_t nof_dcis, uint32_t max_search_nodes, uint32_t nof_ttis, pdcch_alloc_stats& stats)
+{
+  using rand_uint           = std::uniform_int_distribution<uint32_t>;
+  const uint32_t ENB_CC_IDX = 0;
+
+  std::vector<sched_cell_params_t> cell_params(1);
+  sched_interface::ue_cfg_t        ue_cfg   = generate_default_ue_cfg();
+  sched_interface::cell_cfg_t      cell_cfg = generate_default_cell_cfg(100);
+  sched_interface::sched_args_t    sched_args{};
+  sched_args.pdcch_max_search_nodes = max_search_nodes;
+  TESTASSERT(cell_params[ENB_CC_IDX].set_cfg(ENB_CC_IDX, cell_cfg, sched_args));
+
+  std::vector<std::unique_ptr<sched_ue> > ues(nof_dcis);
+  for (uint32_t i = 0; i < nof_dcis; ++i) {
+    ues[i].reset(new sched_ue{});
+    ues[i]->init(70 + i, cell_params);
+    ues[i]->set_cfg(ue_cfg);
+  }
+
+  pdcch_grid_t pdcch;
+  pdcch.init(cell_params[PCell_IDX]);
+
+  // Mostly aggregation level 1, so that several tens of DCIs may fit in the PDCCH
+  std::discrete_distribution<uint32_t> aggr_dist{60, 25, 10, 5};
+  std::vector<uint32_t>                aggr_idxs(nof_dcis);
+  srslte::tti_point                    start_tti{rand_uint{0, 10240}(get_rand_gen())};
+  for (uint32_t tti_counter = 0; tti_counter < nof_ttis; ++tti_counter) {
+    tti_params_t tti_params{(start_tti + tti_counter).to_uint()};
+    for (auto& a : aggr_idxs) {
+      a = aggr_dist(get_rand_gen());
+    }
+
+    auto     tp_start    = std::chrono::steady_clock::now();
+    uint32_t nof_success = 0;
+    pdcch.new_tti(tti_params);
+    for (uint32_t i = 0; i < nof_dcis; ++i) {
+      alloc_type_t alloc_type = (i % 2 == 0) ? alloc_type_t::DL_DATA : alloc_type_t::UL_DATA;
+      nof_success += pdcch.alloc_dci(alloc_type, aggr_idxs[i], ues[i].get()) ? 1 : 0;
+    }
+    double tti_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tp_start).count();
+
+    stats.nof_attempts += nof_dcis;
+    stats.nof_success += nof_success;
+    stats.total_us += tti_us;
+    stats.max_tti_us = std::max(stats.max_tti_us, tti_us);
+
+    // TEST: DCIs are placed in their search space without overlapping
+    TESTASSERT(pdcch.nof_allocs() == nof_success);
+    pdcch_grid_t::alloc_result_t pdcch_result;
+    pdcch_mask_t                 pdcch_mask;
+    pdcch.get_allocs(&pdcch_result, &pdcch_mask, 0);
+    TESTASSERT(pdcch_result.size() == nof_success);
+    pdcch_mask_t cum_mask(pdcch.nof_cces());
+    for (const auto& alloc : pdcch_result) {
+      TESTASSERT(alloc->current_mask.size() == pdcch.nof_cces());
+      TESTASSERT((cum_mask & alloc->current_mask).none());
+      TESTASSERT(alloc->current_mask.count() == 1u << alloc->dci_pos.L);
+      cum_mask |= alloc->current_mask;
+      TESTASSERT(alloc->total_mask == cum_mask);
+
+      const sched_dci_cce_t* dci_cce =
+          ues[alloc->rnti - 70]->get_locations(ENB_CC_IDX, pdcch.get_cfi(), tti_params.sf_idx_tx_dl);
+      const uint32_t* dci_locs = dci_cce->cce_start[alloc->dci_pos.L];
+      TESTASSERT(std::count(dci_locs, dci_locs + dci_cce->nof_loc[alloc->dci_pos.L], alloc->dci_pos.ncce) > 0);
+    }
+    TESTASSERT(cum_mask == pdcch_mask);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_pdcch_many_ues()
+{
+  const uint32_t nof_ttis         = 100;
+  const uint32_t max_search_nodes = 512;
+  const uint32_t max_tree_dcis    = 6;
+
+  printf("PDCCH allocation with 100 PRBs, %d TTIs per run:\n", nof_ttis);
+  for (uint32_t nof_dcis : {4u, 6u, 20u, 30u, 40u, 50u}) {
+    for (uint32_t nodes : {0u, max_search_nodes}) {
+      if (nodes == 0 and nof_dcis > max_tree_dcis) {
+        // the alloc tree grows exponentially with the number of DCIs
+        continue;
+      }
+      pdcch_alloc_stats stats;
+      TESTASSERT(run_pdcch_many_ues(nof_dcis, nodes, nof_ttis, stats) == SRSLTE_SUCCESS);
+      printf("  %2d DCIs/TTI, %-14s: success=%5.1f%%, avg=%7.1f us/TTI, max=%7.1f us/TTI\n",
+             nof_dcis,
+             nodes == 0 ? "alloc tree" : "bounded search",
+             100.0 * stats.nof_success / stats.nof_attempts,
+             stats.total_us / nof_ttis,
+             stats.max_tti_us);
+      fflush(stdout);
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 int main()
 {
   srsenb::set_randseed(seed);
@@ -151,5 +258,6 @@ int main()
   srslte::logmap::get("TEST")->set_level(srslte::LOG_LEVEL_INFO);
 
   TESTASSERT(test_pdcch_one_ue() == SRSLTE_SUCCESS);
+  TESTASSERT(test_pdcch_many_ues() == SRSLTE_SUCCESS);
   printf("Success\n");
 }
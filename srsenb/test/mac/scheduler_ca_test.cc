@@ -77,7 +77,8 @@ sim_sched_args generate_default_sim_args(uint32_t nof_prb, uint32_t nof_ccs)
 }
 
 struct test_scell_activation_params {
-  uint32_t pcell_idx = 0;
+  uint32_t pcell_idx         = 0;
+  uint32_t nof_sched_workers = 0;
 };
 
 int test_scell_activation(test_scell_activation_params params)
@@ -97,8 +98,11 @@ int test_scell_activation(test_scell_activation_params params)
   /* Simulation Objects Setup */
   sched_sim_event_generator generator;
   // Setup scheduler
-  common_sched_tester tester;
+  common_sched_tester                   tester;
+  srsenb::sched_interface::sched_args_t sched_args{};
+  sched_args.nof_sched_workers = params.nof_sched_workers;
   tester.init(nullptr);
+  tester.set_sched_cfg(&sched_args);
   tester.sim_cfg(sim_args);
 
   /* Internal configurations. Do not touch */
@@ -228,6 +232,306 @@ int test_scell_activation(test_scell_activation_params params)
   return SRSLTE_SUCCESS;
 }
 
+/*
+ * Schedules UEs with all the carriers active and full buffers, with the carriers of a TTI allocated serially or by
+ * workers in parallel. Since the buffers are set to the same size every TTI, the data the carriers grant to a UE in a
+ * TTI must never exceed it.
+ */
+struct ca_scaling_stats {
+  double   avg_us        = 0;
+  uint32_t nof_dl_grants = 0;
+  uint32_t nof_ul_grants = 0;
+  uint32_t nof_idle_ccs  = 0; ///< carriers that never got a DL grant
+};
+
+int run_ca_scaling(uint32_t nof_ccs, uint32_t nof_workers, uint32_t nof_ues, uint32_t nof_ttis, ca_scaling_stats& stats)
+{
+  const uint32_t ack_delay    = FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS;
+  const uint32_t drb_lcid     = 3;
+  const uint32_t buffer_bytes = 1000;
+
+  srsenb::sched                                             sched;
+  srsenb::sched_interface::sched_args_t                     sched_args{};
+  srsenb::sched_interface::dl_sched_res_t                   dl_res;
+  srsenb::sched_interface::ul_sched_res_t                   ul_res;
+  std::vector<std::vector<std::pair<uint16_t, uint32_t> > > dl_acks(ack_delay), ul_crcs(ack_delay);
+  std::vector<uint32_t>                                     dl_grants_per_cc(nof_ccs, 0);
+  std::map<uint16_t, uint32_t>                              dl_bytes_per_ue;
+  double                                                    total_us = 0;
+
+  sched_args.pdcch_max_search_nodes = 512;
+  sched_args.nof_sched_workers      = nof_workers;
+  sched.init(nullptr);
+  sched.set_sched_cfg(&sched_args);
+  std::vector<srsenb::sched_interface::cell_cfg_t> cell_cfg(nof_ccs, generate_default_cell_cfg(50));
+  for (uint32_t i = 0; i < nof_ccs; ++i) {
+    cell_cfg[i].cell.id = i + 1;
+  }
+  TESTASSERT(sched.cell_cfg(cell_cfg) == SRSLTE_SUCCESS);
+
+  srsenb::sched_interface::ue_cfg_t ue_cfg = generate_default_ue_cfg();
+  ue_cfg.ue_bearers[drb_lcid].direction    = srsenb::sched_interface::ue_bearer_cfg_t::BOTH;
+  ue_cfg.supported_cc_list.resize(nof_ccs);
+  for (uint32_t i = 0; i < nof_ccs; ++i) {
+    ue_cfg.supported_cc_list[i].active     = true;
+    ue_cfg.supported_cc_list[i].enb_cc_idx = i;
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    uint16_t rnti = 70 + i;
+    TESTASSERT(sched.ue_cfg(rnti, ue_cfg) == SRSLTE_SUCCESS);
+    for (uint32_t cc = 0; cc < nof_ccs; ++cc) {
+      // a valid CQI activates the SCells
+      sched.dl_cqi_info(0, rnti, cc, 15);
+      sched.ul_cqi_info(0, rnti, cc, 15, 0);
+    }
+  }
+
+  for (uint32_t tti_rx = 0; tti_rx < nof_ttis; ++tti_rx) {
+    for (uint32_t i = 0; i < nof_ues; ++i) {
+      sched.dl_rlc_buffer_state(70 + i, drb_lcid, buffer_bytes, 0);
+      sched.ul_bsr(70 + i, drb_lcid, buffer_bytes);
+    }
+    for (auto& ack : dl_acks[tti_rx % ack_delay]) {
+      sched.dl_ack_info(tti_rx, ack.first, ack.second, 0, true);
+    }
+    for (auto& crc : ul_crcs[tti_rx % ack_delay]) {
+      sched.ul_crc_info(tti_rx, crc.first, crc.second, true);
+    }
+    dl_acks[tti_rx % ack_delay].clear();
+    ul_crcs[tti_rx % ack_delay].clear();
+    dl_bytes_per_ue.clear();
+
+    auto tp_start = std::chrono::steady_clock::now();
+    for (uint32_t cc = 0; cc < nof_ccs; ++cc) {
+      sched.dl_sched(TTI_ADD(tti_rx, FDD_HARQ_DELAY_UL_MS), cc, dl_res);
+      sched.ul_sched(TTI_ADD(tti_rx, ack_delay), cc, ul_res);
+
+      for (uint32_t i = 0; i < dl_res.nof_data_elems; ++i) {
+        const srsenb::sched_interface::dl_sched_data_t& data = dl_res.data[i];
+        TESTASSERT(data.tbs[0] + data.tbs[1] > 0);
+        for (uint32_t tb = 0; tb < SRSLTE_MAX_TB; ++tb) {
+          for (uint32_t j = 0; j < data.nof_pdu_elems[tb]; ++j) {
+            if (data.pdu[tb][j].lcid == drb_lcid) {
+              dl_bytes_per_ue[data.dci.rnti] += data.pdu[tb][j].nbytes;
+            }
+          }
+        }
+        dl_acks[tti_rx % ack_delay].emplace_back(data.dci.rnti, cc);
+      }
+      for (uint32_t i = 0; i < ul_res.nof_dci_elems; ++i) {
+        ul_crcs[tti_rx % ack_delay].emplace_back(ul_res.pusch[i].dci.rnti, cc);
+      }
+      dl_grants_per_cc[cc] += dl_res.nof_data_elems;
+      stats.nof_dl_grants += dl_res.nof_data_elems;
+      stats.nof_ul_grants += ul_res.nof_dci_elems;
+    }
+    total_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tp_start).count();
+
+    // TEST: the carriers never grant the same data twice
+    for (auto& e : dl_bytes_per_ue) {
+      TESTASSERT(e.second <= buffer_bytes);
+    }
+  }
+
+  stats.avg_us       = total_us / nof_ttis;
+  stats.nof_idle_ccs = std::count(dl_grants_per_cc.begin(), dl_grants_per_cc.end(), 0);
+  return SRSLTE_SUCCESS;
+}
+
+int test_ca_scaling()
+{
+  const uint32_t nof_ues  = 100;
+  const uint32_t nof_ttis = 200;
+
+  // The scheduler log is too verbose with so many UEs
+  srslte::logmap::get("MAC ")->set_level(srslte::LOG_LEVEL_ERROR);
+
+  printf("Scheduling time per TTI of %d UEs with 50 PRBs, %d TTIs per run:\n", nof_ues, nof_ttis);
+  for (uint32_t nof_ccs = 1; nof_ccs <= 8; nof_ccs *= 2) {
+    ca_scaling_stats serial, parallel;
+    TESTASSERT(run_ca_scaling(nof_ccs, 0, nof_ues, nof_ttis, serial) == SRSLTE_SUCCESS);
+    TESTASSERT(run_ca_scaling(nof_ccs, nof_ccs - 1, nof_ues, nof_ttis, parallel) == SRSLTE_SUCCESS);
+    printf("  %d carriers: serial=%7.1f us, %d workers=%7.1f us (x%.2f), "
+           "grants/TTI={DL: %5.1f/%5.1f, UL: %5.1f/%5.1f}\n",
+           nof_ccs,
+           serial.avg_us,
+           nof_ccs - 1,
+           parallel.avg_us,
+           serial.avg_us / parallel.avg_us,
+           (double)serial.nof_dl_grants / nof_ttis,
+           (double)parallel.nof_dl_grants / nof_ttis,
+           (double)serial.nof_ul_grants / nof_ttis,
+           (double)parallel.nof_ul_grants / nof_ttis);
+    fflush(stdout);
+
+    // TEST: all carriers are used in both modes
+    TESTASSERT(serial.nof_idle_ccs == 0 and parallel.nof_idle_ccs == 0);
+    TESTASSERT(serial.nof_ul_grants > 0 and parallel.nof_ul_grants > 0);
+  }
+
+  srslte::logmap::get("MAC ")->set_level(srslte::LOG_LEVEL_INFO);
+  return SRSLTE_SUCCESS;
+}
+
+//! Hands each paging message out once, like the eNB RRC, so the carrier that gets it is the first one to ask
+class rrc_paging_dummy : public rrc_interface_mac
+{
+public:
+  void     rl_failure(uint16_t rnti) override {}
+  void     add_user(uint16_t rnti, const sched_interface::ue_cfg_t& init_ue_cfg) override {}
+  void     upd_user(uint16_t new_rnti, uint16_t old_rnti) override {}
+  void     set_activity_user(uint16_t rnti) override {}
+  uint8_t* read_pdu_bcch_dlsch(const uint8_t enb_cc_idx, const uint32_t sib_index) override { return nullptr; }
+  bool     is_paging_opportunity(uint32_t tti, uint32_t* payload_len) override
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tti % 5 != 0 or tti == last_paging_tti) {
+      return false;
+    }
+    last_paging_tti = tti;
+    nof_pagings++;
+    *payload_len = 10;
+    return true;
+  }
+
+  std::mutex mutex;
+  uint32_t   last_paging_tti = UINT32_MAX;
+  uint32_t   nof_pagings     = 0;
+};
+
+/*
+ * Schedules CA UEs with random traffic and HARQ feedback, and records the DL and UL grants of every carrier. The
+ * random sequence only depends on the seed and on the previous grants
+ */
+int run_ca_sched_trace(uint32_t nof_workers, uint32_t trace_seed, std::vector<uint32_t>& trace)
+{
+  const uint32_t nof_ccs   = 4;
+  const uint32_t nof_ues   = 20;
+  const uint32_t nof_ttis  = 400;
+  const uint32_t ack_delay = FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS;
+  const uint32_t drb_lcid  = 3;
+
+  std::minstd_rand                                          rng(trace_seed);
+  rrc_paging_dummy                                          rrc;
+  srsenb::sched                                             sched;
+  srsenb::sched_interface::sched_args_t                     sched_args{};
+  srsenb::sched_interface::dl_sched_res_t                   dl_res;
+  srsenb::sched_interface::ul_sched_res_t                   ul_res;
+  std::vector<std::vector<std::pair<uint16_t, uint32_t> > > dl_acks(ack_delay), ul_crcs(ack_delay);
+  uint32_t                                                  nof_pcch_grants = 0;
+
+  sched_args.pdcch_max_search_nodes = 512;
+  sched_args.nof_sched_workers      = nof_workers;
+  sched.init(&rrc);
+  sched.set_sched_cfg(&sched_args);
+  std::vector<srsenb::sched_interface::cell_cfg_t> cell_cfg(nof_ccs, generate_default_cell_cfg(25));
+  for (uint32_t i = 0; i < nof_ccs; ++i) {
+    cell_cfg[i].cell.id = i + 1;
+  }
+  TESTASSERT(sched.cell_cfg(cell_cfg) == SRSLTE_SUCCESS);
+  TESTASSERT(sched.get_nof_workers() == std::min(nof_workers, nof_ccs - 1));
+
+  srsenb::sched_interface::ue_cfg_t ue_cfg = generate_default_ue_cfg();
+  ue_cfg.ue_bearers[drb_lcid].direction    = srsenb::sched_interface::ue_bearer_cfg_t::BOTH;
+  ue_cfg.supported_cc_list.resize(nof_ccs);
+  for (uint32_t i = 0; i < nof_ccs; ++i) {
+    ue_cfg.supported_cc_list[i].active     = true;
+    ue_cfg.supported_cc_list[i].enb_cc_idx = i;
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    uint16_t rnti = 70 + i;
+    TESTASSERT(sched.ue_cfg(rnti, ue_cfg) == SRSLTE_SUCCESS);
+    for (uint32_t cc = 0; cc < nof_ccs; ++cc) {
+      sched.dl_cqi_info(0, rnti, cc, 5 + rng() % 11);
+      sched.ul_cqi_info(0, rnti, cc, 5 + rng() % 11, 0);
+    }
+  }
+
+  for (uint32_t tti_rx = 0; tti_rx < nof_ttis; ++tti_rx) {
+    for (uint32_t i = 0; i < nof_ues; ++i) {
+      if (rng() % 4 == 0) {
+        sched.dl_rlc_buffer_state(70 + i, drb_lcid, rng() % 5000, 0);
+      }
+      if (rng() % 8 == 0) {
+        sched.ul_bsr(70 + i, drb_lcid, rng() % 2000);
+      }
+    }
+    for (auto& ack : dl_acks[tti_rx % ack_delay]) {
+      sched.dl_ack_info(tti_rx, ack.first, ack.second, 0, rng() % 10 != 0);
+    }
+    for (auto& crc : ul_crcs[tti_rx % ack_delay]) {
+      sched.ul_crc_info(tti_rx, crc.first, crc.second, rng() % 10 != 0);
+    }
+    dl_acks[tti_rx % ack_delay].clear();
+    ul_crcs[tti_rx % ack_delay].clear();
+
+    for (uint32_t cc = 0; cc < nof_ccs; ++cc) {
+      sched.dl_sched(TTI_ADD(tti_rx, FDD_HARQ_DELAY_UL_MS), cc, dl_res);
+      sched.ul_sched(TTI_ADD(tti_rx, ack_delay), cc, ul_res);
+
+      trace.push_back(dl_res.nof_bc_elems);
+      for (uint32_t i = 0; i < dl_res.nof_bc_elems; ++i) {
+        const srsenb::sched_interface::dl_sched_bc_t& bc = dl_res.bc[i];
+        trace.insert(trace.end(), {(uint32_t)bc.type, bc.index, bc.dci.location.ncce, bc.tbs});
+        nof_pcch_grants += bc.type == srsenb::sched_interface::dl_sched_bc_t::PCCH ? 1 : 0;
+      }
+      trace.push_back(dl_res.nof_data_elems);
+      for (uint32_t i = 0; i < dl_res.nof_data_elems; ++i) {
+        const srsenb::sched_interface::dl_sched_data_t& data = dl_res.data[i];
+        trace.insert(trace.end(),
+                     {data.dci.rnti,
+                      data.dci.pid,
+                      data.dci.location.ncce,
+                      data.dci.location.L,
+                      data.dci.type0_alloc.rbg_bitmask,
+                      data.tbs[0],
+                      data.tbs[1]});
+        dl_acks[tti_rx % ack_delay].emplace_back(data.dci.rnti, cc);
+      }
+      trace.push_back(ul_res.nof_dci_elems);
+      for (uint32_t i = 0; i < ul_res.nof_dci_elems; ++i) {
+        const srsenb::sched_interface::ul_sched_data_t& pusch = ul_res.pusch[i];
+        trace.insert(
+            trace.end(),
+            {pusch.dci.rnti, pusch.dci.type2_alloc.riv, pusch.dci.location.ncce, pusch.tbs, pusch.current_tx_nb});
+        ul_crcs[tti_rx % ack_delay].emplace_back(pusch.dci.rnti, cc);
+      }
+    }
+  }
+  // every paging handed out by the RRC was transmitted, in a single carrier
+  TESTASSERT(rrc.nof_pagings > 0);
+  TESTASSERT(nof_pcch_grants == rrc.nof_pagings);
+  return SRSLTE_SUCCESS;
+}
+
+int test_parallel_sched_results()
+{
+  srslte::logmap::get("MAC ")->set_level(srslte::LOG_LEVEL_ERROR);
+
+  // TEST: the carriers allocated by workers give the same grants, paging included, as the carriers allocated serially
+  std::vector<uint32_t> serial, parallel;
+  TESTASSERT(run_ca_sched_trace(0, seed, serial) == SRSLTE_SUCCESS);
+  TESTASSERT(run_ca_sched_trace(3, seed, parallel) == SRSLTE_SUCCESS);
+  TESTASSERT(serial.size() > 4 * 400 * 2);
+  TESTASSERT(serial == parallel);
+
+  // TEST: the workers follow the number of carriers of the cell reconfigurations
+  srsenb::sched                         sched;
+  srsenb::sched_interface::sched_args_t sched_args{};
+  sched_args.nof_sched_workers = 3;
+  sched.init(nullptr);
+  sched.set_sched_cfg(&sched_args);
+  std::vector<srsenb::sched_interface::cell_cfg_t> cell_cfg(2, generate_default_cell_cfg(25));
+  TESTASSERT(sched.cell_cfg(cell_cfg) == SRSLTE_SUCCESS);
+  TESTASSERT(sched.get_nof_workers() == 1);
+  cell_cfg.resize(4, generate_default_cell_cfg(25));
+  TESTASSERT(sched.cell_cfg(cell_cfg) == SRSLTE_SUCCESS);
+  TESTASSERT(sched.get_nof_workers() == 3);
+
+  srslte::logmap::get("MAC ")->set_level(srslte::LOG_LEVEL_INFO);
+  return SRSLTE_SUCCESS;
+}
+
 int main()
 {
   // Setup rand seed
@@ -235,6 +539,9 @@ int main()
 
   srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_INFO);
   printf("[TESTER] This is the chosen seed: %u\n", seed);
+  TESTASSERT(test_ca_scaling() == SRSLTE_SUCCESS);
+  TESTASSERT(test_parallel_sched_results() == SRSLTE_SUCCESS);
+
   uint32_t N_runs = 20;
   for (uint32_t n = 0; n < N_runs; ++n) {
     printf("Sim run number: %u\n", n + 1);
@@ -246,6 +553,12 @@ int main()
     p           = {};
     p.pcell_idx = 1;
     TESTASSERT(test_scell_activation(p) == SRSLTE_SUCCESS);
+
+    // same with the carriers allocated in parallel
+    p                   = {};
+    p.pcell_idx         = n % 2;
+    p.nof_sched_workers = 1;
+    TESTASSERT(test_scell_activation(p) == SRSLTE_SUCCESS);
   }
 
   return 0;
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/scheduler.h"
+#include "scheduler_test_utils.h"
+#include "srslte/common/test_common.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+constexpr uint32_t CARRIER_IDX = 0;
+
+struct sched_latency_stats {
+  double                      avg_us = 0, p99_us = 0, max_us = 0;
+  uint64_t                    nof_dl_grants = 0, nof_ul_grants = 0;
+  srsenb::mac_sched_metrics_t metrics = {};
+};
+
+/// Schedules a 100 PRB carrier whose UEs always have pending data and measures the DL+UL scheduling time of each TTI
+int run_sched_latency(uint32_t nof_ues, uint32_t max_sched_time_us, uint32_t nof_ttis, sched_latency_stats& stats)
+{
+  const uint32_t ack_delay    = FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS;
+  const uint32_t drb_lcid     = 3;
+  const uint32_t buffer_bytes = 200;
+
+  srsenb::sched                           sched;
+  srsenb::sched_interface::sched_args_t   sched_args{};
+  srsenb::sched_interface::dl_sched_res_t dl_res;
+  srsenb::sched_interface::ul_sched_res_t ul_res;
+  std::vector<double>                     tti_us;
+  std::vector<std::vector<uint16_t> >     dl_acks(ack_delay), ul_crcs(ack_delay);
+
+  // the exhaustive PDCCH alloc tree does not scale to tens of DCIs per TTI
+  sched_args.pdcch_max_search_nodes = 512;
+  sched_args.max_sched_time_us      = max_sched_time_us;
+  sched.init(nullptr);
+  sched.set_sched_cfg(&sched_args);
+  TESTASSERT(sched.cell_cfg({generate_default_cell_cfg(100)}) == SRSLTE_SUCCESS);
+
+  srsenb::sched_interface::ue_cfg_t ue_cfg = generate_default_ue_cfg();
+  ue_cfg.ue_bearers[drb_lcid].direction    = srsenb::sched_interface::ue_bearer_cfg_t::BOTH;
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    uint16_t rnti = 70 + i;
+    TESTASSERT(sched.ue_cfg(rnti, ue_cfg) == SRSLTE_SUCCESS);
+    sched.dl_cqi_info(0, rnti, CARRIER_IDX, 15);
+    sched.ul_cqi_info(0, rnti, CARRIER_IDX, 15, 0);
+  }
+
+  for (uint32_t tti_rx = 0; tti_rx < nof_ttis; ++tti_rx) {
+    // the UEs never run out of data
+    for (uint32_t i = 0; i < nof_ues; ++i) {
+      sched.dl_rlc_buffer_state(70 + i, drb_lcid, buffer_bytes, 0);
+      sched.ul_bsr(70 + i, drb_lcid, buffer_bytes);
+    }
+
+    // HARQ feedback of the TTI scheduled ack_delay TTIs before
+    for (uint16_t rnti : dl_acks[tti_rx % ack_delay]) {
+      sched.dl_ack_info(tti_rx, rnti, CARRIER_IDX, 0, true);
+    }
+    for (uint16_t rnti : ul_crcs[tti_rx % ack_delay]) {
+      sched.ul_crc_info(tti_rx, rnti, CARRIER_IDX, true);
+    }
+    dl_acks[tti_rx % ack_delay].clear();
+    ul_crcs[tti_rx % ack_delay].clear();
+
+    auto tp_start = std::chrono::steady_clock::now();
+    sched.dl_sched(TTI_ADD(tti_rx, FDD_HARQ_DELAY_UL_MS), CARRIER_IDX, dl_res);
+    sched.ul_sched(TTI_ADD(tti_rx, ack_delay), CARRIER_IDX, ul_res);
+    tti_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tp_start).count());
+
+    for (uint32_t i = 0; i < dl_res.nof_data_elems; ++i) {
+      dl_acks[tti_rx % ack_delay].push_back(dl_res.data[i].dci.rnti);
+    }
+    for (uint32_t i = 0; i < ul_res.nof_dci_elems; ++i) {
+      ul_crcs[tti_rx % ack_delay].push_back(ul_res.pusch[i].dci.rnti);
+    }
+    stats.nof_dl_grants += dl_res.nof_data_elems;
+    stats.nof_ul_grants += ul_res.nof_dci_elems;
+  }
+  sched.get_metrics(stats.metrics);
+
+  std::sort(tti_us.begin(), tti_us.end());
+  stats.avg_us = std::accumulate(tti_us.begin(), tti_us.end(), 0.0) / nof_ttis;
+  stats.p99_us = tti_us[(nof_ttis * 99 + 99) / 100 - 1];
+  stats.max_us = tti_us.back();
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Scheduling latency with 100, 300 and 1000 UEs, with and without time budget. It takes several seconds, so it is not
+ * run by ctest
+ */
+int bench_sched_latency()
+{
+  using srsenb::mac_sched_metrics_t;
+  const uint32_t nof_ttis = 500;
+  const uint32_t budget   = 50;
+
+  // The scheduler log is too verbose with so many UEs
+  srslte::logmap::get("MAC ")->set_level(srslte::LOG_LEVEL_ERROR);
+
+  printf("Scheduling latency with 100 PRBs, %d TTIs per run:\n", nof_ttis);
+  for (uint32_t nof_ues : {100u, 300u, 1000u}) {
+    for (uint32_t max_sched_time_us : {0u, budget}) {
+      sched_latency_stats stats;
+      TESTASSERT(run_sched_latency(nof_ues, max_sched_time_us, nof_ttis, stats) == SRSLTE_SUCCESS);
+      printf("  %4d UEs, budget=%2d us: avg=%6.1f us, p99=%6.1f us, max=%6.1f us, grants/TTI={DL: %4.1f, UL: %4.1f}, "
+             "overruns=%d\n",
+             nof_ues,
+             max_sched_time_us,
+             stats.avg_us,
+             stats.p99_us,
+             stats.max_us,
+             (double)stats.nof_dl_grants / nof_ttis,
+             (double)stats.nof_ul_grants / nof_ttis,
+             stats.metrics.nof_budget_overruns);
+      printf("    phases avg/max us: BC=%.1f/%.1f, RAR=%.1f/%.1f, DL=%.1f/%.1f, UL=%.1f/%.1f, PDCCH=%.1f/%.1f\n",
+             stats.metrics.phase[mac_sched_metrics_t::BC].avg_us,
+             stats.metrics.phase[mac_sched_metrics_t::BC].max_us,
+             stats.metrics.phase[mac_sched_metrics_t::RAR].avg_us,
+             stats.metrics.phase[mac_sched_metrics_t::RAR].max_us,
+             stats.metrics.phase[mac_sched_metrics_t::DL_DATA].avg_us,
+             stats.metrics.phase[mac_sched_metrics_t::DL_DATA].max_us,
+             stats.metrics.phase[mac_sched_metrics_t::UL_DATA].avg_us,
+             stats.metrics.phase[mac_sched_metrics_t::UL_DATA].max_us,
+             stats.metrics.phase[mac_sched_metrics_t::PDCCH].avg_us,
+             stats.metrics.phase[mac_sched_metrics_t::PDCCH].max_us);
+      fflush(stdout);
+
+      // TEST: every TTI was profiled. Without budget, the UEs got allocated
+      TESTASSERT(stats.metrics.phase[mac_sched_metrics_t::TTI].nof_samples == nof_ttis);
+      if (max_sched_time_us == 0) {
+        TESTASSERT(stats.nof_dl_grants > 0 and stats.nof_ul_grants > 0);
+        TESTASSERT(stats.metrics.nof_budget_overruns == 0);
+      }
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(bench_sched_latency() == SRSLTE_SUCCESS);
+  return SRSLTE_SUCCESS;
+}
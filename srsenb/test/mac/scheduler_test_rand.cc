@@ -23,6 +23,7 @@
 #include "srsenb/hdr/stack/mac/scheduler_carrier.h"
 #include "srsenb/hdr/stack/mac/scheduler_ue.h"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <random>
 #include <set>
@@ -474,6 +475,102 @@ sched_sim_events rand_sim_params(uint32_t nof_ttis)
   return sim_gen;
 }
 
+/********************************************************
+ * Scheduling time budget
+ *******************************************************/
+
+/*
+ * UEs with pending data whose DL and UL transmissions all fail. Past a given TTI, the test clock makes the scheduler
+ * run out of time on its first check of the budget: no new transmission can be allocated, but the retxs still are.
+ */
+int test_sched_budget()
+{
+  const uint32_t nof_ues         = 20;
+  const uint32_t nof_ttis        = 40;
+  const uint32_t out_of_time_tti = 20;
+  const uint32_t ack_delay       = FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS;
+  const uint32_t drb_lcid        = 3;
+
+  srsenb::sched                                  sched;
+  srsenb::sched_interface::sched_args_t          sched_args{};
+  srsenb::sched_interface::dl_sched_res_t        dl_res;
+  srsenb::sched_interface::ul_sched_res_t        ul_res;
+  std::vector<std::vector<uint16_t> >            dl_nacks(ack_delay), ul_crcs(ack_delay);
+  std::map<std::pair<uint16_t, uint32_t>, bool>  dl_ndis; // last NDI of each DL HARQ
+
+  // Once out of time, every reading of the clock is past the deadline
+  std::atomic<bool>    out_of_time{false};
+  std::atomic<int64_t> clock_us{0};
+  sched.set_clock([&out_of_time, &clock_us]() {
+    if (out_of_time) {
+      clock_us += 1000;
+    }
+    return std::chrono::steady_clock::time_point(std::chrono::microseconds(clock_us));
+  });
+
+  // the exhaustive PDCCH alloc tree does not scale to tens of DCIs per TTI
+  sched_args.pdcch_max_search_nodes = 512;
+  sched_args.max_sched_time_us      = 50;
+  sched.init(nullptr);
+  sched.set_sched_cfg(&sched_args);
+  TESTASSERT(sched.cell_cfg({generate_default_cell_cfg(100)}) == SRSLTE_SUCCESS);
+  srsenb::sched_interface::ue_cfg_t ue_cfg = generate_default_ue_cfg();
+  ue_cfg.ue_bearers[drb_lcid].direction    = srsenb::sched_interface::ue_bearer_cfg_t::BOTH;
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    TESTASSERT(sched.ue_cfg(70 + i, ue_cfg) == SRSLTE_SUCCESS);
+    sched.dl_cqi_info(0, 70 + i, CARRIER_IDX, 15);
+    sched.ul_cqi_info(0, 70 + i, CARRIER_IDX, 15, 0);
+  }
+
+  uint32_t nof_dl_retxs = 0, nof_ul_grants = 0;
+  for (uint32_t tti_rx = 0; tti_rx < nof_ttis; ++tti_rx) {
+    out_of_time = tti_rx >= out_of_time_tti;
+    for (uint32_t i = 0; i < nof_ues; ++i) {
+      sched.dl_rlc_buffer_state(70 + i, drb_lcid, 200, 0);
+      sched.ul_bsr(70 + i, drb_lcid, 200);
+    }
+    for (uint16_t rnti : dl_nacks[tti_rx % ack_delay]) {
+      sched.dl_ack_info(tti_rx, rnti, CARRIER_IDX, 0, false);
+    }
+    for (uint16_t rnti : ul_crcs[tti_rx % ack_delay]) {
+      sched.ul_crc_info(tti_rx, rnti, CARRIER_IDX, false);
+    }
+    dl_nacks[tti_rx % ack_delay].clear();
+    ul_crcs[tti_rx % ack_delay].clear();
+
+    sched.dl_sched(TTI_ADD(tti_rx, FDD_HARQ_DELAY_UL_MS), CARRIER_IDX, dl_res);
+    sched.ul_sched(TTI_ADD(tti_rx, ack_delay), CARRIER_IDX, ul_res);
+    for (uint32_t i = 0; i < dl_res.nof_data_elems; ++i) {
+      dl_nacks[tti_rx % ack_delay].push_back(dl_res.data[i].dci.rnti);
+    }
+    for (uint32_t i = 0; i < ul_res.nof_dci_elems; ++i) {
+      ul_crcs[tti_rx % ack_delay].push_back(ul_res.pusch[i].dci.rnti);
+    }
+
+    for (uint32_t i = 0; i < dl_res.nof_data_elems; ++i) {
+      const srslte_dci_dl_t& dci = dl_res.data[i].dci;
+      auto                   it  = dl_ndis.find(std::make_pair(dci.rnti, dci.pid));
+      // TEST: out of time, only the retxs are allocated. They keep the NDI of the failed transmission
+      if (out_of_time) {
+        TESTASSERT(it != dl_ndis.end() and it->second == dci.tb[0].ndi);
+      }
+      dl_ndis[std::make_pair(dci.rnti, dci.pid)] = dci.tb[0].ndi;
+    }
+    if (out_of_time) {
+      nof_dl_retxs += dl_res.nof_data_elems;
+      nof_ul_grants += ul_res.nof_dci_elems;
+    }
+  }
+
+  // TEST: the budget ran out in every TTI past out_of_time_tti, and the DL and UL retxs were not skipped
+  srsenb::mac_sched_metrics_t metrics = {};
+  sched.get_metrics(metrics);
+  TESTASSERT(metrics.nof_budget_overruns == nof_ttis - out_of_time_tti);
+  TESTASSERT(nof_dl_retxs > 0);
+  TESTASSERT(nof_ul_grants > 0);
+  return SRSLTE_SUCCESS;
+}
+
 int main()
 {
   // Setup seed
@@ -481,6 +578,8 @@ int main()
   printf("This is the chosen seed: %u\n", seed);
 
   srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_INFO);
+
+  TESTASSERT(test_sched_budget() == SRSLTE_SUCCESS);
   uint32_t N_runs = 1, nof_ttis = 10240 + 10;
 
   for (uint32_t n = 0; n < N_runs; ++n) {
@@ -671,6 +671,7 @@ public:
     return SRSLTE_SUCCESS;
   }
   void set_sched_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs) override { notify_set_sched_dl_tti_mask(); }
+  void tti_done(uint32_t tti_rx) override {}
   void rl_failure(uint16_t rnti) override { notify_rl_failure(); }
   void rl_ok(uint16_t rnti) override { notify_rl_ok(); }
   void tti_clock() override { notify_tti_clock(); }
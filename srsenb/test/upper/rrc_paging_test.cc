@@ -0,0 +1,262 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/rrc/rrc_paging.h"
+#include "srslte/common/test_common.h"
+#include <algorithm>
+#include <ctime>
+#include <random>
+
+using namespace srsenb;
+using namespace asn1::rrc;
+
+const uint32_t nof_ueids = 1024;
+
+asn1::s1ap::ue_paging_id_c make_s1ap_paging_id(uint32_t ueid)
+{
+  asn1::s1ap::ue_paging_id_c id;
+  id.set_s_tmsi();
+  id.s_tmsi().mmec[0] = 0x12;
+  uint32_t m_tmsi     = 0xA0000000 + ueid;
+  for (uint32_t i = 0; i < 4; i++) {
+    id.s_tmsi().m_tmsi[i] = (m_tmsi >> (8u * (3u - i))) & 0xFFu;
+  }
+  return id;
+}
+
+/*
+ * Previous paging handling of the RRC, kept as reference: a single map of pending records that is scanned, and whose
+ * records of the current paging occasion are packed, at every TTI
+ */
+class legacy_paging
+{
+public:
+  legacy_paging(uint32_t T_, uint32_t Nb_) : T(T_), Nb(Nb_) {}
+
+  bool add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_paging_id)
+  {
+    if (pending.count(ueid) > 0) {
+      return false;
+    }
+    pending.insert(std::make_pair(ueid, make_paging_record(ue_paging_id)));
+    return true;
+  }
+
+  bool is_paging_opportunity(uint32_t tti, uint32_t* payload_len)
+  {
+    constexpr static int sf_pattern[4][4] = {{9, 4, -1, 0}, {-1, 9, -1, 4}, {-1, -1, -1, 5}, {-1, -1, -1, 9}};
+    if (pending.empty()) {
+      return false;
+    }
+    pcch_msg_s pcch_msg;
+    pcch_msg.msg.set_c1();
+    paging_s* paging_rec = &pcch_msg.msg.c1().paging();
+
+    uint32_t N   = T < Nb ? T : Nb;
+    uint32_t Ns  = Nb / T > 1 ? Nb / T : 1;
+    uint32_t sfn = tti / 10;
+
+    std::vector<uint32_t> ue_to_remove;
+    for (auto& item : pending) {
+      if (ue_to_remove.size() >= ASN1_RRC_MAX_PAGE_REC) {
+        break;
+      }
+      uint32_t ueid = item.first % 1024;
+      uint32_t i_s  = (ueid / N) % Ns;
+      if ((sfn % T) != (T / N) * (ueid % N)) {
+        continue;
+      }
+      int sf_idx = sf_pattern[i_s % 4][(Ns - 1) % 4];
+      if (sf_idx >= 0 and (uint32_t)sf_idx == (tti % 10)) {
+        paging_rec->paging_record_list_present = true;
+        paging_rec->paging_record_list.push_back(item.second);
+        ue_to_remove.push_back(item.first);
+      }
+    }
+    for (uint32_t ueid : ue_to_remove) {
+      pending.erase(ueid);
+    }
+    if (ue_to_remove.empty()) {
+      return false;
+    }
+    asn1::bit_ref bref(buffer, sizeof(buffer));
+    pcch_msg.pack(bref);
+    *payload_len = (uint32_t)bref.distance_bytes();
+    return true;
+  }
+
+  size_t         nof_pending_records() const { return pending.size(); }
+  const uint8_t* get_pdu() const { return buffer; }
+
+private:
+  uint32_t                            T, Nb;
+  std::map<uint32_t, paging_record_s> pending;
+  uint8_t                             buffer[512];
+};
+
+int test_paging_occasions(uint32_t T, uint32_t Nb)
+{
+  paging_manager pager(T, Nb);
+  legacy_paging  legacy(T, Nb);
+
+  for (uint32_t ueid = 0; ueid < nof_ueids; ++ueid) {
+    TESTASSERT(pager.add_paging_record(ueid, make_paging_record(make_s1ap_paging_id(ueid))));
+    TESTASSERT(legacy.add_paging_id(ueid, make_s1ap_paging_id(ueid)));
+  }
+  TESTASSERT(pager.nof_pending_records() == nof_ueids);
+  // UEs already paged are not paged twice
+  TESTASSERT(not pager.add_paging_record(5, make_paging_record(make_s1ap_paging_id(5))));
+
+  std::vector<uint32_t> nof_pages(nof_ueids, 0);
+  for (uint32_t tti = 0; not pager.empty(); tti = (tti + 1) % 10240) {
+    const paging_manager::pcch_pdu_t* pcch = pager.get_pcch(tti);
+
+    uint32_t legacy_len  = 0;
+    bool     legacy_page = legacy.is_paging_opportunity(tti, &legacy_len);
+    TESTASSERT(legacy_page == (pcch != nullptr));
+    if (pcch == nullptr) {
+      continue;
+    }
+    // Records appended to the cached PDU give the same PDU as packing the whole message
+    TESTASSERT(pcch->pdu.size() == legacy_len);
+    TESTASSERT(memcmp(pcch->pdu.data(), legacy.get_pdu(), legacy_len) == 0);
+    TESTASSERT(pcch->ueids.size() > 0 and pcch->ueids.size() <= ASN1_RRC_MAX_PAGE_REC);
+
+    pcch_msg_s     msg;
+    asn1::cbit_ref bref(pcch->pdu.data(), pcch->pdu.size());
+    TESTASSERT(msg.unpack(bref) == asn1::SRSASN_SUCCESS);
+    TESTASSERT(msg.msg.c1().paging().paging_record_list.size() == pcch->ueids.size());
+
+    for (uint32_t i = 0; i < pcch->ueids.size(); ++i) {
+      uint32_t               ueid = pcch->ueids[i];
+      const paging_record_s& rec  = msg.msg.c1().paging().paging_record_list[i];
+      TESTASSERT((uint32_t)rec.ue_id.s_tmsi().m_tmsi.to_number() == 0xA0000000 + ueid);
+      uint32_t pf_offset;
+      int      sf_idx = pager.get_paging_occasion(ueid, &pf_offset);
+      TESTASSERT((tti / 10) % T == pf_offset and tti % 10 == (uint32_t)sf_idx);
+      nof_pages[ueid]++;
+    }
+    pager.pop_pcch(tti);
+    TESTASSERT(pager.get_pcch(tti) == nullptr or pager.get_pcch(tti) != pcch);
+  }
+  TESTASSERT(legacy.nof_pending_records() == 0);
+  for (uint32_t n : nof_pages) {
+    TESTASSERT(n == 1);
+  }
+
+  // A UE can be paged again once its paging was transmitted
+  TESTASSERT(pager.add_paging_record(5, make_paging_record(make_s1ap_paging_id(5))));
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Paging storm: the MME pages random UEs at a high rate, while the MAC checks every TTI of every carrier for a paging
+ * occasion. Reports the CPU time spent by the RRC in the paging handling, with and without the bucketed PCCH messages
+ */
+template <typename Pager>
+double
+run_paging_storm(Pager& pager, uint32_t nof_ttis, uint32_t pages_per_tti, uint32_t nof_carriers, uint32_t* nof_pcch)
+{
+  std::minstd_rand rng(1);
+  clock_t          tic = clock();
+  for (uint32_t tti = 0; tti < nof_ttis; ++tti) {
+    for (uint32_t i = 0; i < pages_per_tti; ++i) {
+      uint32_t ueid = rng() % nof_ueids;
+      pager.add_paging_id(ueid, make_s1ap_paging_id(ueid));
+    }
+    for (uint32_t cc = 0; cc < nof_carriers; ++cc) {
+      uint32_t payload_len = 0;
+      if (pager.is_paging_opportunity(tti % 10240, &payload_len)) {
+        (*nof_pcch)++;
+      }
+    }
+  }
+  double cpu_ms = (clock() - tic) * 1000.0 / CLOCKS_PER_SEC;
+  printf("%u PCCH messages, %zd records pending, %.1f ms of CPU\n", *nof_pcch, pager.nof_pending_records(), cpu_ms);
+  return cpu_ms;
+}
+
+// Same calls the RRC does on the paging_manager
+class bucketed_paging
+{
+public:
+  bucketed_paging(uint32_t T, uint32_t Nb) : pager(T, Nb) {}
+
+  void add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_paging_id)
+  {
+    pager.add_paging_record(ueid, make_paging_record(ue_paging_id));
+  }
+
+  bool is_paging_opportunity(uint32_t tti, uint32_t* payload_len)
+  {
+    if (pager.empty()) {
+      return false;
+    }
+    const paging_manager::pcch_pdu_t* pcch = pager.get_pcch(tti);
+    if (pcch == nullptr) {
+      return false;
+    }
+    memcpy(buffer, pcch->pdu.data(), pcch->pdu.size());
+    *payload_len = pcch->pdu.size();
+    pager.pop_pcch(tti);
+    return true;
+  }
+
+  size_t nof_pending_records() const { return pager.nof_pending_records(); }
+
+private:
+  paging_manager pager;
+  uint8_t        buffer[512];
+};
+
+int test_paging_storm()
+{
+  const uint32_t T = 32, Nb = 4 * T, nof_ttis = 20000, pages_per_tti = 20, nof_carriers = 2;
+
+  printf("Paging storm of %u S1AP Paging/s over %u TTIs\n", pages_per_tti * 1000, nof_ttis);
+  printf("Legacy:   ");
+  legacy_paging legacy(T, Nb);
+  uint32_t      legacy_pcch = 0;
+  double        legacy_ms   = run_paging_storm(legacy, nof_ttis, pages_per_tti, nof_carriers, &legacy_pcch);
+
+  printf("Bucketed: ");
+  bucketed_paging bucketed(T, Nb);
+  uint32_t        bucketed_pcch = 0;
+  double          bucketed_ms   = run_paging_storm(bucketed, nof_ttis, pages_per_tti, nof_carriers, &bucketed_pcch);
+  printf("Speed-up: %.1fx\n", legacy_ms / std::max(bucketed_ms, 0.001));
+
+  // Both send a full PCCH message in every paging occasion of the storm
+  TESTASSERT(bucketed_pcch > 0 and bucketed_pcch == legacy_pcch);
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  srslte::logmap::get("RRC")->set_level(srslte::LOG_LEVEL_NONE);
+
+  TESTASSERT(test_paging_occasions(32, 4 * 32) == SRSLTE_SUCCESS);
+  TESTASSERT(test_paging_occasions(128, 128) == SRSLTE_SUCCESS);
+  TESTASSERT(test_paging_occasions(256, 256 / 32) == SRSLTE_SUCCESS);
+  TESTASSERT(test_paging_storm() == SRSLTE_SUCCESS);
+
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
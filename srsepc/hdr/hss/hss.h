@@ -32,10 +32,12 @@
 #include "srslte/common/log.h"
 #include "srslte/common/log_filter.h"
 #include "srslte/common/logger_file.h"
+#include "srslte/common/security.h"
 #include "srslte/interfaces/epc_interfaces.h"
 #include <cstddef>
 #include <fstream>
 #include <map>
+#include <mutex>
 
 #define LTE_FDD_ENB_IND_HE_N_BITS 5
 #define LTE_FDD_ENB_IND_HE_MASK 0x1FUL
@@ -64,13 +66,13 @@ typedef struct {
   uint8_t            amf[2];
   uint8_t            sqn[6];
   uint16_t           qci;
-  uint8_t            last_rand[16];
   std::string        static_ip_addr;
 
+  // Key schedule of K, expanded once when the user is loaded
+  srslte::security_aes_key aes_key;
+
   // Helper getters/setters
   void set_sqn(const uint8_t* sqn_);
-  void set_last_rand(const uint8_t* rand_);
-  void get_last_rand(uint8_t* rand_);
 } hss_ue_ctx_t;
 
 class hss : public hss_interface_nas
@@ -82,9 +84,10 @@ public:
   void        stop(void);
 
   virtual bool gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
+  virtual void gen_auth_info_answer_multi(hss_auth_vector_t* vectors, uint32_t nof_vectors);
   virtual bool gen_update_loc_answer(uint64_t imsi, uint8_t* qci);
 
-  virtual bool resync_sqn(uint64_t imsi, uint8_t* auts);
+  virtual bool resync_sqn(uint64_t imsi, uint8_t* rand, uint8_t* auts);
 
   std::map<std::string, uint64_t> get_ip_to_imsi() const;
 
@@ -94,15 +97,21 @@ private:
   static hss* m_instance;
 
   std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> > m_imsi_to_ue_ctx;
+  std::mutex                                         m_ue_ctx_mutex; // guards the SQN of the UEs
+
+  // Vectors computed per gen_auth_info_answer_multi() step
+  static const uint32_t AV_BATCH_SIZE = 32;
 
   void gen_rand(uint8_t rand_[16]);
 
-  void
-       gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
-  void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
+  void gen_auth_info_answer_milenage(hss_ue_ctx_t* const* ue_ctxs,
+                                     uint8_t (*sqns)[6],
+                                     hss_auth_vector_t* const* vectors,
+                                     uint32_t                  nof_vectors);
+  void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* sqn, hss_auth_vector_t* vector);
 
-  void resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
-  void resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
+  void resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* rand, uint8_t* auts);
+  void resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* rand, uint8_t* auts);
 
   std::vector<std::string> split_string(const std::string& str, char delimiter);
   void                     get_uint_vec_from_hex_str(const std::string& key_str, uint8_t* key, uint len);
@@ -133,15 +142,5 @@ inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
 {
   memcpy(sqn, sqn_, 6);
 }
-
-inline void hss_ue_ctx_t::set_last_rand(const uint8_t* last_rand_)
-{
-  memcpy(last_rand, last_rand_, 16);
-}
-
-inline void hss_ue_ctx_t::get_last_rand(uint8_t* last_rand_)
-{
-  memcpy(last_rand_, last_rand, 16);
-}
 } // namespace srsepc
 #endif // SRSEPC_HSS_H
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        loadgen.h
+ * Description: S1AP/NAS load generator. Emulates a number of eNBs and the UEs
+ *              camped on them towards a local EPC, and measures the latency
+ *              of the NAS procedures.
+ *****************************************************************************/
+
+#ifndef SRSEPC_LOADGEN_H
+#define SRSEPC_LOADGEN_H
+
+#include "srslte/asn1/liblte_mme.h"
+#include "srslte/asn1/s1ap_asn1.h"
+#include "srslte/common/log.h"
+#include "srslte/common/network_utils.h"
+#include "srslte/common/security.h"
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace srsepc {
+
+typedef struct {
+  std::string mme_addr;
+  std::string s1c_bind_addr;
+  std::string gtp_bind_addr;
+  std::string gtp_dst_addr;
+  uint16_t    mcc;
+  uint16_t    mnc;
+  uint16_t    tac;
+  uint32_t    enb_id;
+  uint32_t    nof_enbs;
+  uint32_t    nof_ues;
+  uint64_t    imsi_base;
+  uint8_t     k[16];
+  uint8_t     opc[16];
+  float       attach_rate;
+  float       detach_rate;
+  float       release_rate;
+  float       service_rate;
+  float       paging_rate;
+  float       gtpu_rate;
+  uint32_t    gtpu_size;
+  uint32_t    duration_secs;
+  uint32_t    report_period_secs;
+} loadgen_args_t;
+
+class loadgen
+{
+public:
+  loadgen();
+
+  bool init(const loadgen_args_t& args, srslte::log* log);
+  void stop();
+
+  // Waits for at most one millisecond of network events and starts the procedures that are due. Returns false once
+  // the configured duration has elapsed or the EPC dropped a connection.
+  bool run_once();
+
+  // Prints the procedure counters and latency percentiles gathered so far
+  void print_report(bool final_report);
+
+private:
+  static const uint32_t MAX_EVENTS       = 64;
+  static const uint32_t RX_BUFFER_SIZE   = 8192;
+  static const uint32_t GTPU_EVENT_ID    = 0xffffffff;
+  static const uint32_t S1AP_STREAM_ID   = 1;
+  static const int      S1AP_PORT        = 36412;
+  static const int      GTPU_PORT        = 2152;
+  static const int64_t  PROC_TIMEOUT_US  = 10000000;
+  static const int64_t  TIMEOUT_CHECK_US = 1000000;
+
+  enum ue_state_t {
+    UE_DEREGISTERED = 0,
+    UE_ATTACHING,
+    UE_CONNECTED,
+    UE_RELEASING,
+    UE_IDLE,
+    UE_PAGED,
+    UE_SERVICE_PENDING,
+    UE_DETACHING,
+    UE_NOF_STATES
+  };
+
+  // Procedures whose latency is measured, from the first uplink message to the message that completes them
+  enum proc_t { PROC_ATTACH = 0, PROC_SERVICE, PROC_PAGING, PROC_DETACH, PROC_RELEASE, PROC_NOF_PROCS };
+
+  typedef struct {
+    uint32_t idx;
+    uint64_t imsi;
+    uint32_t enb_idx;
+    uint32_t enb_ue_s1ap_id;
+    uint32_t mme_ue_s1ap_id;
+    bool     mme_ue_s1ap_id_present;
+    uint32_t ue_ip;
+    uint32_t sgw_addr;
+    uint32_t sgw_teid;
+    uint8_t  erab_id;
+
+    // GUTI assigned in the Attach Accept, m_tmsi is zero while none is assigned
+    LIBLTE_MME_EPS_MOBILE_ID_GUTI_STRUCT guti;
+
+    // NAS security context
+    uint8_t                             ksi;
+    uint8_t                             k_asme[32];
+    uint8_t                             k_nas_enc[32];
+    uint8_t                             k_nas_int[32];
+    srslte::CIPHERING_ALGORITHM_ID_ENUM cipher_algo;
+    srslte::INTEGRITY_ALGORITHM_ID_ENUM integ_algo;
+    uint32_t                            tx_count;
+    bool                                have_ctxt;
+
+    // Procedure in progress
+    proc_t  proc;
+    int64_t proc_start_us;
+  } ue_ctx_t;
+
+  typedef struct {
+    uint32_t                 enb_id;
+    srslte::socket_handler_t socket;
+    sockaddr_in              mme_addr;
+    bool                     setup_done;
+  } enb_ctx_t;
+
+  typedef struct {
+    uint64_t           nof_started;
+    uint64_t           nof_completed;
+    uint64_t           nof_failed;
+    std::vector<float> latency_ms;
+  } proc_stats_t;
+
+  // Event pacing
+  void    run_tti(int64_t now);
+  void    pace(float rate, float* credit, float elapsed_s, void (loadgen::*action)());
+  void    check_timeouts(int64_t now);
+  int64_t now_us();
+
+  // Actions started by the pacer
+  void start_attach();
+  void start_detach();
+  void start_release();
+  void start_service_request();
+  void start_paging();
+  void send_gtpu_packet();
+
+  // UE state bookkeeping, keeps for each state the set of UEs on it so that the pacer picks them in O(1)
+  void      set_state(ue_ctx_t* ue, ue_state_t state);
+  bool      pick_ue(ue_state_t state, ue_ctx_t** ue);
+  void      start_proc(ue_ctx_t* ue, proc_t proc);
+  void      complete_proc(ue_ctx_t* ue);
+  void      fail_proc(ue_ctx_t* ue);
+  void      reset_ue(ue_ctx_t* ue);
+  ue_ctx_t* find_ue(uint32_t enb_ue_s1ap_id, uint32_t mme_ue_s1ap_id);
+
+  // S1AP
+  bool connect_enb(uint32_t enb_idx);
+  bool send_s1_setup_request(uint32_t enb_idx);
+  bool send_s1ap_pdu(uint32_t enb_idx, const asn1::s1ap::s1ap_pdu_c& tx_pdu, const char* procedure_name);
+  bool send_initial_ue_message(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* nas_msg, bool has_tmsi);
+  bool send_ul_nas_transport(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* nas_msg);
+  bool send_ue_context_release_request(ue_ctx_t* ue);
+  bool send_ue_context_release_complete(ue_ctx_t* ue);
+  bool send_initial_context_setup_response(ue_ctx_t* ue);
+  void handle_enb_rx(uint32_t enb_idx);
+  void handle_s1ap_pdu(uint32_t enb_idx, const uint8_t* pdu, uint32_t len);
+  void handle_dl_nas_transport(const asn1::s1ap::dl_nas_transport_s& msg);
+  void handle_initial_context_setup_request(const asn1::s1ap::init_context_setup_request_s& msg);
+  void handle_ue_context_release_command(const asn1::s1ap::ue_context_release_cmd_s& msg);
+  void handle_paging(uint32_t enb_idx, const asn1::s1ap::paging_s& msg);
+
+  // NAS
+  void handle_nas_pdu(ue_ctx_t* ue, const uint8_t* pdu, uint32_t len);
+  void handle_authentication_request(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg);
+  void handle_security_mode_command(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg);
+  void handle_attach_accept(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg);
+  void gen_attach_request(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg);
+  void gen_service_request(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg);
+  void apply_security(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg, uint8_t sec_hdr_type);
+  void integrity_generate(ue_ctx_t* ue, uint8_t* msg, uint32_t msg_len, uint8_t* mac);
+  void cipher(ue_ctx_t* ue, uint32_t count, uint8_t direction, uint8_t* msg, uint32_t msg_len);
+
+  // GTP-U
+  void handle_gtpu_rx();
+  bool send_gtpu(ue_ctx_t* ue, uint32_t dst_addr, uint32_t payload_len);
+
+  loadgen_args_t m_args;
+  srslte::log*   m_log      = nullptr;
+  bool           m_running  = false;
+  int            m_epoll_fd = -1;
+
+  std::vector<enb_ctx_t>                 m_enbs;
+  std::vector<ue_ctx_t>                  m_ues;
+  std::vector<uint32_t>                  m_ue_state_pos;
+  std::vector<ue_state_t>                m_ue_state;
+  std::vector<uint32_t>                  m_state_members[UE_NOF_STATES];
+  std::unordered_map<uint32_t, uint32_t> m_tmsi_to_ue;
+  std::unordered_map<uint32_t, uint32_t> m_mme_ue_s1ap_id_to_ue;
+
+  srslte::socket_handler_t m_gtpu_socket;
+  uint32_t                 m_gtp_bind_addr = 0;
+  uint32_t                 m_gtp_dst_addr  = 0;
+
+  std::mt19937 m_rng;
+  int64_t      m_start_us         = 0;
+  int64_t      m_last_tti_us      = 0;
+  int64_t      m_last_report_us   = 0;
+  int64_t      m_last_timeouts_us = 0;
+  float        m_attach_credit    = 0;
+  float        m_detach_credit    = 0;
+  float        m_release_credit   = 0;
+  float        m_service_credit   = 0;
+  float        m_paging_credit    = 0;
+  float        m_gtpu_credit      = 0;
+
+  proc_stats_t m_stats[PROC_NOF_PROCS];
+  uint64_t     m_nof_paging_rx   = 0;
+  uint64_t     m_nof_gtpu_tx     = 0;
+  uint64_t     m_nof_gtpu_rx     = 0;
+  uint64_t     m_nof_gtpu_tx_err = 0;
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_LOADGEN_H
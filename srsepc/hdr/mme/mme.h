@@ -28,18 +28,26 @@
 #ifndef SRSEPC_MME_H
 #define SRSEPC_MME_H
 
+#include "mme_av_cache.h"
 #include "s1ap.h"
+#include "srslte/common/block_queue.h"
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/log.h"
 #include "srslte/common/log_filter.h"
 #include "srslte/common/logger_file.h"
 #include "srslte/common/threads.h"
 #include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace srsepc {
 
 typedef struct {
   s1ap_args_t s1ap_args;
+  uint32_t    nas_workers;
+  uint32_t    av_batch_size;
   // diameter_args_t diameter_args;
   // gtpc_args_t gtpc_args;
 } mme_args_t;
@@ -50,6 +58,13 @@ typedef struct {
   enum nas_timer_type type;
 } mme_timer_t;
 
+typedef struct {
+  uint64_t               nof_attach_requests;
+  uint64_t               nof_attach_completes;
+  uint32_t               nof_nas_tasks_pending;
+  mme_av_cache_metrics_t av_cache;
+} mme_metrics_t;
+
 class mme : public srslte::thread, public mme_interface_nas
 {
 public:
@@ -64,6 +79,14 @@ public:
   int  get_s1_mme();
   void run_thread();
 
+  // NAS workers
+  int           init_nas_workers(uint32_t nof_workers);
+  uint32_t      get_nof_nas_workers() const { return m_nas_workers.size(); }
+  void          push_nas_task(uint64_t key, const std::function<void()>& task, const std::function<void()>& done);
+  mme_av_cache* get_av_cache() { return &m_av_cache; }
+
+  void get_metrics(mme_metrics_t* metrics);
+
   // Timer Methods
   virtual bool add_nas_timer(int timer_fd, enum nas_timer_type type, uint64_t imsi);
   virtual bool is_nas_timer_running(enum nas_timer_type type, uint64_t imsi);
@@ -78,14 +101,41 @@ private:
 
   bool                      m_running;
   srslte::byte_buffer_pool* m_pool;
-  fd_set                    m_set;
+  int                       m_epoll_fd = -1;
 
-  // Timer map
-  std::vector<mme_timer_t> timers;
+  // Timer map, indexed by file descriptor
+  std::map<int, mme_timer_t> timers;
 
   // Timer Methods
   void handle_timer_expire(int timer_fd);
 
+  /*
+   * Runs the parts of the NAS procedures that do not touch the MME state, like generating the authentication vectors.
+   * The S1AP, NAS, GTP-C and timer state is only accessed by the MME thread, which handles every S1AP message in
+   * arrival order, so the messages of a UE are never reordered. Once a task is done, the rest of its procedure is
+   * queued back to the MME thread, which is woken up through m_nas_done_fd.
+   */
+  class nas_worker : public srslte::thread
+  {
+  public:
+    nas_worker() : thread("MME_NAS") {}
+    void     stop();
+    void     push_task(const std::function<void()>& task) { tasks.push(task); }
+    uint32_t nof_pending_tasks() { return tasks.size(); }
+
+  private:
+    void run_thread();
+
+    srslte::block_queue<std::function<void()> > tasks;
+  };
+  std::vector<std::unique_ptr<nas_worker> >    m_nas_workers;
+  srslte::block_queue<std::function<void()> > m_nas_done;
+  int                                          m_nas_done_fd = -1;
+  mme_av_cache                                 m_av_cache;
+
+  void handle_nas_tasks_done();
+  void stop_nas_workers();
+
   // Logs
   srslte::log_filter* m_nas_log;
   srslte::log_filter* m_s1ap_log;
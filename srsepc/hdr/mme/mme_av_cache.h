@@ -0,0 +1,86 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        mme_av_cache.h
+ * Description: Authentication vectors generated by the HSS ahead of the NAS
+ *              procedure that consumes them.
+ *****************************************************************************/
+
+#ifndef SRSEPC_MME_AV_CACHE_H
+#define SRSEPC_MME_AV_CACHE_H
+
+#include "srslte/common/log.h"
+#include "srslte/interfaces/epc_interfaces.h"
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace srsepc {
+
+typedef struct {
+  uint64_t nof_prefetched;
+  uint64_t nof_hits;
+  uint64_t nof_misses;
+} mme_av_cache_metrics_t;
+
+/*
+ * Sits between the NAS and the HSS. The NAS workers call prefetch() without holding the MME state lock, so that the
+ * Milenage computations of different UEs run in parallel, and the NAS procedure picks the vector up afterwards with
+ * gen_auth_info_answer(). Vectors that were not prefetched are requested to the HSS as before.
+ *
+ * The HSS is asked for batch_size vectors of the IMSI at a time. They are handed out in SQN order, so the spare ones
+ * serve the next authentications of the UE without going to the HSS.
+ */
+class mme_av_cache : public hss_interface_nas
+{
+public:
+  void init(hss_interface_nas* hss, uint32_t batch_size, srslte::log* nas_log);
+
+  bool prefetch(uint64_t imsi);
+  void get_metrics(mme_av_cache_metrics_t* metrics);
+
+  virtual bool gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
+  virtual void gen_auth_info_answer_multi(hss_auth_vector_t* vectors, uint32_t nof_vectors);
+  virtual bool gen_update_loc_answer(uint64_t imsi, uint8_t* qci);
+  virtual bool resync_sqn(uint64_t imsi, uint8_t* rand, uint8_t* auts);
+
+  static const uint32_t MAX_BATCH_SIZE = 32;
+
+private:
+  // Vectors prefetched for attaches that never completed are not kept forever
+  static const uint32_t MAX_CACHED_VECTORS = 4096;
+
+  bool fetch_batch(uint64_t imsi, hss_auth_vector_t* avs);
+  bool store_batch(uint64_t imsi, const hss_auth_vector_t* avs, uint32_t nof_avs);
+
+  hss_interface_nas* m_hss        = nullptr;
+  srslte::log*       m_nas_log    = nullptr;
+  uint32_t           m_batch_size = 1;
+
+  std::mutex                                          m_mutex;
+  std::map<uint64_t, std::deque<hss_auth_vector_t> > m_vectors;
+  uint32_t                                            m_nof_vectors = 0;
+  mme_av_cache_metrics_t                              m_metrics     = {};
+};
+
+} // namespace srsepc
+#endif // SRSEPC_MME_AV_CACHE_H
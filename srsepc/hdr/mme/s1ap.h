@@ -142,6 +142,9 @@ private:
   // PCAP
   bool              m_pcap_enable;
   srslte::s1ap_pcap m_pcap;
+
+  // Decoded RX PDU trees are allocated from here and released at once before the next PDU
+  asn1::arena m_rx_arena;
 };
 
 inline uint32_t s1ap::get_plmn()
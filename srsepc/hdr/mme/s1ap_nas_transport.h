@@ -27,9 +27,12 @@
 #include "srslte/asn1/gtpc.h"
 #include "srslte/asn1/s1ap_asn1.h"
 #include "srslte/common/buffer_pool.h"
+#include <atomic>
 
 namespace srsepc {
 
+class mme;
+
 class s1ap_nas_transport
 {
 public:
@@ -45,17 +48,34 @@ public:
                                    srslte::byte_buffer_t* nas_msg,
                                    struct sctp_sndrcvinfo enb_sri);
 
+  uint64_t get_nof_attach_requests() const { return m_nof_attach_requests; }
+  uint64_t get_nof_attach_completes() const { return m_nof_attach_completes; }
+
 private:
   s1ap_nas_transport();
   virtual ~s1ap_nas_transport();
 
+  // The NAS message is deallocated by these
+  bool handle_initial_ue_nas(uint32_t                enb_ue_s1ap_id,
+                             uint32_t                m_tmsi,
+                             srslte::byte_buffer_t*  nas_msg,
+                             struct sctp_sndrcvinfo* enb_sri);
+  bool handle_uplink_nas(uint32_t enb_ue_s1ap_id, uint32_t mme_ue_s1ap_id, srslte::byte_buffer_t* nas_msg);
+
+  bool get_attach_request_imsi(srslte::byte_buffer_t* nas_msg, uint64_t* imsi);
+
   srslte::log*              m_s1ap_log;
   srslte::byte_buffer_pool* m_pool;
 
   s1ap*              m_s1ap;
+  mme*               m_mme;
 
   nas_init_t m_nas_init;
   nas_if_t   m_nas_if;
+
+  // Read by the metrics thread
+  std::atomic<uint64_t> m_nof_attach_requests{0};
+  std::atomic<uint64_t> m_nof_attach_completes{0};
 };
 
 } // namespace srsepc
@@ -20,6 +20,7 @@
  */
 #include "srsepc/hdr/hss/hss.h"
 #include "srslte/common/security.h"
+#include <algorithm>
 #include <inttypes.h> // for printing uint64_t
 #include <iomanip>
 #include <sstream>
@@ -126,6 +127,9 @@ bool hss::read_db_file(std::string db_filename)
       }
       ue_ctx->imsi = strtoull(split[2].c_str(), nullptr, 10);
       get_uint_vec_from_hex_str(split[3], ue_ctx->key, 16);
+      if (ue_ctx->algo == HSS_ALGO_MILENAGE) {
+        ue_ctx->aes_key.set_key(ue_ctx->key);
+      }
       if (split[4] == std::string("op")) {
         ue_ctx->op_configured = true;
         get_uint_vec_from_hex_str(split[5], ue_ctx->op, 16);
@@ -256,92 +260,155 @@ bool hss::write_db_file(std::string db_filename)
 
 bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
 {
-
-  m_hss_log->debug("Generating AUTH info answer\n");
-  hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
-  if (ue_ctx == nullptr) {
-    m_hss_log->console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
-    m_hss_log->error("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
+  hss_auth_vector_t av = {};
+  av.imsi              = imsi;
+  gen_auth_info_answer_multi(&av, 1);
+  if (!av.valid) {
     return false;
   }
 
-  switch (ue_ctx->algo) {
-    case HSS_ALGO_XOR:
-      gen_auth_info_answer_xor(ue_ctx, k_asme, autn, rand, xres);
-      break;
-    case HSS_ALGO_MILENAGE:
-      gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
-      break;
-  }
-  increment_ue_sqn(ue_ctx);
+  memcpy(k_asme, av.k_asme, sizeof(av.k_asme));
+  memcpy(autn, av.autn, sizeof(av.autn));
+  memcpy(rand, av.rand, sizeof(av.rand));
+  memcpy(xres, av.xres, sizeof(av.xres));
   return true;
 }
 
-void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
-                                        uint8_t*      k_asme,
-                                        uint8_t*      autn,
-                                        uint8_t*      rand,
-                                        uint8_t*      xres)
+void hss::gen_auth_info_answer_multi(hss_auth_vector_t* vectors, uint32_t nof_vectors)
 {
-  // Get K, AMF, OPC and SQN
-  uint8_t* k   = ue_ctx->key;
-  uint8_t* amf = ue_ctx->amf;
-  uint8_t* opc = ue_ctx->opc;
-  uint8_t* sqn = ue_ctx->sqn;
-
-  // Temp variables
-  uint8_t ck[16];
-  uint8_t ik[16];
-  uint8_t ak[6];
-  uint8_t mac[8];
-
-  gen_rand(rand);
-
-  srslte::security_milenage_f2345(k, opc, rand, xres, ck, ik, ak);
-
-  m_hss_log->debug_hex(k, 16, "User Key : ");
-  m_hss_log->debug_hex(opc, 16, "User OPc : ");
-  m_hss_log->debug_hex(rand, 16, "User Rand : ");
-  m_hss_log->debug_hex(xres, 8, "User XRES: ");
-  m_hss_log->debug_hex(ck, 16, "User CK: ");
-  m_hss_log->debug_hex(ik, 16, "User IK: ");
-  m_hss_log->debug_hex(ak, 6, "User AK: ");
-
-  srslte::security_milenage_f1(k, opc, rand, sqn, amf, mac);
-
-  m_hss_log->debug_hex(sqn, 6, "User SQN : ");
-  m_hss_log->debug_hex(mac, 8, "User MAC : ");
+  m_hss_log->debug("Generating %d AUTH info answers\n", nof_vectors);
+
+  hss_ue_ctx_t*      ue_ctxs[AV_BATCH_SIZE];
+  uint8_t            sqns[AV_BATCH_SIZE][6];
+  hss_ue_ctx_t*      mil_ue_ctxs[AV_BATCH_SIZE];
+  uint8_t            mil_sqns[AV_BATCH_SIZE][6];
+  hss_auth_vector_t* mil_vectors[AV_BATCH_SIZE];
+
+  for (uint32_t i = 0; i < nof_vectors; i += AV_BATCH_SIZE) {
+    uint32_t n = std::min(AV_BATCH_SIZE, nof_vectors - i);
+
+    // The SQNs are taken and incremented at once, in the order of the vectors, so that several vectors of the same UE
+    // can be requested in one call. The vectors are computed afterwards without holding the lock. The UE contexts are
+    // never removed and only their SQN changes once they are loaded.
+    {
+      std::lock_guard<std::mutex> lock(m_ue_ctx_mutex);
+      for (uint32_t j = 0; j < n; j++) {
+        ue_ctxs[j]           = get_ue_ctx(vectors[i + j].imsi);
+        vectors[i + j].valid = ue_ctxs[j] != nullptr;
+        if (ue_ctxs[j] != nullptr) {
+          memcpy(sqns[j], ue_ctxs[j]->sqn, 6);
+          increment_ue_sqn(ue_ctxs[j]);
+        }
+      }
+    }
 
-  // Generate K_asme
-  srslte::security_generate_k_asme(ck, ik, ak, sqn, mcc, mnc, k_asme);
+    uint32_t nof_mil = 0;
+    for (uint32_t j = 0; j < n; j++) {
+      if (ue_ctxs[j] == nullptr) {
+        m_hss_log->console("User not found at HSS. IMSI: %015" PRIu64 "\n", vectors[i + j].imsi);
+        m_hss_log->error("User not found at HSS. IMSI: %015" PRIu64 "\n", vectors[i + j].imsi);
+        continue;
+      }
+      switch (ue_ctxs[j]->algo) {
+        case HSS_ALGO_XOR:
+          gen_auth_info_answer_xor(ue_ctxs[j], sqns[j], &vectors[i + j]);
+          break;
+        case HSS_ALGO_MILENAGE:
+          mil_ue_ctxs[nof_mil] = ue_ctxs[j];
+          mil_vectors[nof_mil] = &vectors[i + j];
+          memcpy(mil_sqns[nof_mil], sqns[j], 6);
+          nof_mil++;
+          break;
+      }
+    }
+    if (nof_mil > 0) {
+      gen_auth_info_answer_milenage(mil_ue_ctxs, mil_sqns, mil_vectors, nof_mil);
+    }
+  }
+}
 
-  m_hss_log->debug("User MCC : %x  MNC : %x \n", mcc, mnc);
-  m_hss_log->debug_hex(k_asme, 32, "User k_asme : ");
+void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* const*      ue_ctxs,
+                                        uint8_t (*sqns)[6],
+                                        hss_auth_vector_t* const* vectors,
+                                        uint32_t                  nof_vectors)
+{
+  srslte::security_milenage_t mil[AV_BATCH_SIZE];
 
-  // Generate AUTN (autn = sqn ^ ak |+| amf |+| mac)
-  for (int i = 0; i < 6; i++) {
-    autn[i] = sqn[i] ^ ak[i];
-  }
-  for (int i = 0; i < 2; i++) {
-    autn[6 + i] = amf[i];
-  }
-  for (int i = 0; i < 8; i++) {
-    autn[8 + i] = mac[i];
+  // Temp variables
+  uint8_t ck[AV_BATCH_SIZE][16];
+  uint8_t ik[AV_BATCH_SIZE][16];
+  uint8_t ak[AV_BATCH_SIZE][6];
+  uint8_t mac[AV_BATCH_SIZE][8];
+
+  // F1 to F5 of all the vectors in one go, with the key schedules expanded when the users were loaded
+  for (uint32_t i = 0; i < nof_vectors; i++) {
+    gen_rand(vectors[i]->rand);
+    mil[i].key   = &ue_ctxs[i]->aes_key;
+    mil[i].opc   = ue_ctxs[i]->opc;
+    mil[i].rand  = vectors[i]->rand;
+    mil[i].sqn   = sqns[i];
+    mil[i].amf   = ue_ctxs[i]->amf;
+    mil[i].mac_a = mac[i];
+    mil[i].res   = vectors[i]->xres;
+    mil[i].ck    = ck[i];
+    mil[i].ik    = ik[i];
+    mil[i].ak    = ak[i];
+  }
+  if (srslte::security_milenage_multi(mil, nof_vectors) != SRSLTE_SUCCESS) {
+    m_hss_log->error("Error generating %d Milenage authentication vectors\n", nof_vectors);
+    for (uint32_t i = 0; i < nof_vectors; i++) {
+      vectors[i]->valid = false;
+    }
+    return;
+  }
+
+  for (uint32_t i = 0; i < nof_vectors; i++) {
+    uint8_t* amf    = ue_ctxs[i]->amf;
+    uint8_t* sqn    = sqns[i];
+    uint8_t* k_asme = vectors[i]->k_asme;
+    uint8_t* autn   = vectors[i]->autn;
+
+    m_hss_log->debug_hex(ue_ctxs[i]->key, 16, "User Key : ");
+    m_hss_log->debug_hex(ue_ctxs[i]->opc, 16, "User OPc : ");
+    m_hss_log->debug_hex(vectors[i]->rand, 16, "User Rand : ");
+    m_hss_log->debug_hex(vectors[i]->xres, 8, "User XRES: ");
+    m_hss_log->debug_hex(ck[i], 16, "User CK: ");
+    m_hss_log->debug_hex(ik[i], 16, "User IK: ");
+    m_hss_log->debug_hex(ak[i], 6, "User AK: ");
+    m_hss_log->debug_hex(sqn, 6, "User SQN : ");
+    m_hss_log->debug_hex(mac[i], 8, "User MAC : ");
+
+    // Generate K_asme
+    srslte::security_generate_k_asme(ck[i], ik[i], ak[i], sqn, mcc, mnc, k_asme);
+
+    m_hss_log->debug("User MCC : %x  MNC : %x \n", mcc, mnc);
+    m_hss_log->debug_hex(k_asme, 32, "User k_asme : ");
+
+    // Generate AUTN (autn = sqn ^ ak |+| amf |+| mac)
+    for (int j = 0; j < 6; j++) {
+      autn[j] = sqn[j] ^ ak[i][j];
+    }
+    for (int j = 0; j < 2; j++) {
+      autn[6 + j] = amf[j];
+    }
+    for (int j = 0; j < 8; j++) {
+      autn[8 + j] = mac[i][j];
+    }
+    m_hss_log->debug_hex(autn, 16, "User AUTN: ");
   }
-  m_hss_log->debug_hex(autn, 16, "User AUTN: ");
-
-  // Set last RAND
-  ue_ctx->set_last_rand(rand);
-  return;
 }
 
-void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
+void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* sqn, hss_auth_vector_t* vector)
 {
-  // Get K, AMF, OPC and SQN
+  // Get K, AMF and OPC
   uint8_t* k   = ue_ctx->key;
   uint8_t* amf = ue_ctx->amf;
   uint8_t* opc = ue_ctx->opc;
-  uint8_t* sqn = ue_ctx->sqn;
+
+  uint8_t* k_asme = vector->k_asme;
+  uint8_t* autn   = vector->autn;
+  uint8_t* rand   = vector->rand;
+  uint8_t* xres   = vector->xres;
 
   // Temp variables
   uint8_t xdout[16];
@@ -424,9 +491,6 @@ void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_
   }
 
   m_hss_log->debug_hex(autn, 8, "User AUTN: ");
-
-  // Set last RAND
-  ue_ctx->set_last_rand(rand);
   return;
 }
 
@@ -444,10 +508,11 @@ bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
   return true;
 }
 
-bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
+bool hss::resync_sqn(uint64_t imsi, uint8_t* rand, uint8_t* auts)
 {
   m_hss_log->debug("Re-syncing SQN\n");
-  hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
+  std::lock_guard<std::mutex> lock(m_ue_ctx_mutex);
+  hss_ue_ctx_t*               ue_ctx = get_ue_ctx(imsi);
   if (ue_ctx == nullptr) {
     m_hss_log->console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
     m_hss_log->error("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
@@ -456,10 +521,10 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
 
   switch (ue_ctx->algo) {
     case HSS_ALGO_XOR:
-      resync_sqn_xor(ue_ctx, auts);
+      resync_sqn_xor(ue_ctx, rand, auts);
       break;
     case HSS_ALGO_MILENAGE:
-      resync_sqn_milenage(ue_ctx, auts);
+      resync_sqn_milenage(ue_ctx, rand, auts);
       break;
   }
 
@@ -467,14 +532,14 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
   return true;
 }
 
-void hss::resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* auts)
+void hss::resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* rand, uint8_t* auts)
 {
   m_hss_log->error("XOR SQN synchronization not supported yet\n");
   m_hss_log->console("XOR SQNs synchronization not supported yet\n");
   return;
 }
 
-void hss::resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts)
+void hss::resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* rand, uint8_t* auts)
 {
   // Get K, AMF, OPC and SQN
   uint8_t* k   = ue_ctx->key;
@@ -483,13 +548,10 @@ void hss::resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts)
   uint8_t* sqn = ue_ctx->sqn;
 
   // Temp variables
-  uint8_t last_rand[16];
   uint8_t ak[6];
   uint8_t mac_s[8];
   uint8_t sqn_ms_xor_ak[6];
 
-  ue_ctx->get_last_rand(last_rand);
-
   for (int i = 0; i < 6; i++) {
     sqn_ms_xor_ak[i] = auts[i];
   }
@@ -501,12 +563,12 @@ void hss::resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts)
   m_hss_log->debug_hex(k, 16, "User Key : ");
   m_hss_log->debug_hex(opc, 16, "User OPc : ");
   m_hss_log->debug_hex(amf, 2, "User AMF : ");
-  m_hss_log->debug_hex(last_rand, 16, "User Last Rand : ");
+  m_hss_log->debug_hex(rand, 16, "User Rand : ");
   m_hss_log->debug_hex(auts, 16, "AUTS : ");
   m_hss_log->debug_hex(sqn_ms_xor_ak, 6, "SQN xor AK : ");
   m_hss_log->debug_hex(mac_s, 8, "MAC : ");
 
-  srslte::security_milenage_f5_star(k, opc, last_rand, ak);
+  srslte::security_milenage_f5_star(k, opc, rand, ak);
   m_hss_log->debug_hex(ak, 6, "Resynch AK : ");
 
   uint8_t sqn_ms[6];
@@ -520,7 +582,7 @@ void hss::resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts)
 
   uint8_t dummy_amf[2] = {};
 
-  srslte::security_milenage_f1_star(k, opc, last_rand, sqn_ms, dummy_amf, mac_s_tmp);
+  srslte::security_milenage_f1_star(k, opc, rand, sqn_ms, dummy_amf, mac_s_tmp);
   m_hss_log->debug_hex(mac_s_tmp, 8, "MAC calc : ");
 
   ue_ctx->set_sqn(sqn_ms);
@@ -0,0 +1,1107 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/loadgen/loadgen.h"
+#include "srslte/common/bcd_helpers.h"
+#include "srslte/common/int_helpers.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <inttypes.h>
+#include <netinet/sctp.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+using namespace asn1::s1ap;
+
+namespace srsepc {
+
+static const char* proc_names[] = {"attach", "service", "paging", "detach", "release"};
+
+loadgen::loadgen() : m_rng(0x5eed) {}
+
+bool loadgen::init(const loadgen_args_t& args, srslte::log* log)
+{
+  m_args = args;
+  m_log  = log;
+
+  if (m_args.nof_enbs == 0 || m_args.nof_ues == 0) {
+    m_log->console("At least one eNB and one UE are required\n");
+    return false;
+  }
+  if (inet_pton(AF_INET, m_args.gtp_bind_addr.c_str(), &m_gtp_bind_addr) != 1 ||
+      inet_pton(AF_INET, m_args.gtp_dst_addr.c_str(), &m_gtp_dst_addr) != 1) {
+    m_log->console("Invalid GTP-U address\n");
+    return false;
+  }
+
+  // UEs are spread evenly over the eNBs. The eNB UE S1AP id and the eNB S1-U TEID of a UE are derived from its index
+  // and kept across connections, the previous connection is always released before a new one is set up.
+  m_ues.resize(m_args.nof_ues);
+  m_ue_state.resize(m_args.nof_ues);
+  m_ue_state_pos.resize(m_args.nof_ues);
+  for (uint32_t i = 0; i < m_args.nof_ues; i++) {
+    ue_ctx_t* ue       = &m_ues[i];
+    *ue                = {};
+    ue->idx            = i;
+    ue->imsi           = m_args.imsi_base + i;
+    ue->enb_idx        = i % m_args.nof_enbs;
+    ue->enb_ue_s1ap_id = i + 1;
+    m_ue_state[i]      = UE_DEREGISTERED;
+    m_ue_state_pos[i]  = m_state_members[UE_DEREGISTERED].size();
+    m_state_members[UE_DEREGISTERED].push_back(i);
+  }
+
+  m_epoll_fd = epoll_create1(0);
+  if (m_epoll_fd < 0) {
+    m_log->console("Could not create epoll instance: %s\n", strerror(errno));
+    return false;
+  }
+
+  m_enbs.resize(m_args.nof_enbs);
+  for (uint32_t i = 0; i < m_args.nof_enbs; i++) {
+    if (!connect_enb(i) || !send_s1_setup_request(i)) {
+      return false;
+    }
+  }
+
+  // The GTP-U socket is shared by all eNBs, the TEID identifies the UE
+  if (!m_gtpu_socket.open_socket(srslte::net_utils::addr_family::ipv4,
+                                 srslte::net_utils::socket_type::datagram,
+                                 srslte::net_utils::protocol_type::UDP) ||
+      !m_gtpu_socket.bind_addr(m_args.gtp_bind_addr.c_str(), GTPU_PORT)) {
+    m_log->console("Could not bind GTP-U socket to %s:%d\n", m_args.gtp_bind_addr.c_str(), GTPU_PORT);
+    return false;
+  }
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  ev.data.u32           = GTPU_EVENT_ID;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_gtpu_socket.fd(), &ev) != 0) {
+    m_log->console("Could not add GTP-U socket to epoll: %s\n", strerror(errno));
+    return false;
+  }
+
+  m_running = true;
+  return true;
+}
+
+void loadgen::stop()
+{
+  m_enbs.clear();
+  m_gtpu_socket.close();
+  if (m_epoll_fd >= 0) {
+    close(m_epoll_fd);
+    m_epoll_fd = -1;
+  }
+}
+
+int64_t loadgen::now_us()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool loadgen::run_once()
+{
+  struct epoll_event events[MAX_EVENTS];
+
+  int nof_events = epoll_wait(m_epoll_fd, events, MAX_EVENTS, 1);
+  if (nof_events < 0 && errno != EINTR) {
+    m_log->error("Error waiting for events: %s\n", strerror(errno));
+    return false;
+  }
+  for (int i = 0; i < nof_events && m_running; i++) {
+    if (events[i].data.u32 == GTPU_EVENT_ID) {
+      handle_gtpu_rx();
+    } else {
+      handle_enb_rx(events[i].data.u32);
+    }
+  }
+
+  run_tti(now_us());
+  return m_running;
+}
+
+/*******************************************************************************
+ * Event pacing
+ *******************************************************************************/
+void loadgen::run_tti(int64_t now)
+{
+  // Nothing is paced until all the eNBs are set up
+  for (const enb_ctx_t& enb : m_enbs) {
+    if (!enb.setup_done) {
+      return;
+    }
+  }
+  if (m_start_us == 0) {
+    m_log->console("S1 Setup completed for %d eNBs\n", m_args.nof_enbs);
+    m_start_us         = now;
+    m_last_tti_us      = now;
+    m_last_report_us   = now;
+    m_last_timeouts_us = now;
+    return;
+  }
+
+  float elapsed_s = (now - m_last_tti_us) * 1e-6f;
+  m_last_tti_us   = now;
+
+  pace(m_args.attach_rate, &m_attach_credit, elapsed_s, &loadgen::start_attach);
+  pace(m_args.release_rate, &m_release_credit, elapsed_s, &loadgen::start_release);
+  pace(m_args.service_rate, &m_service_credit, elapsed_s, &loadgen::start_service_request);
+  pace(m_args.paging_rate, &m_paging_credit, elapsed_s, &loadgen::start_paging);
+  pace(m_args.detach_rate, &m_detach_credit, elapsed_s, &loadgen::start_detach);
+  pace(m_args.gtpu_rate, &m_gtpu_credit, elapsed_s, &loadgen::send_gtpu_packet);
+
+  if (now - m_last_timeouts_us >= TIMEOUT_CHECK_US) {
+    check_timeouts(now);
+    m_last_timeouts_us = now;
+  }
+  if (m_args.report_period_secs > 0 && now - m_last_report_us >= m_args.report_period_secs * 1000000LL) {
+    print_report(false);
+    m_last_report_us = now;
+  }
+  if (m_args.duration_secs > 0 && now - m_start_us >= m_args.duration_secs * 1000000LL) {
+    m_running = false;
+  }
+}
+
+// Rates are offered loads: an action that finds no UE in the right state is dropped rather than postponed, so that a
+// slow EPC does not build up a burst that is released all at once when it catches up.
+void loadgen::pace(float rate, float* credit, float elapsed_s, void (loadgen::*action)())
+{
+  if (rate <= 0) {
+    return;
+  }
+  *credit += rate * elapsed_s;
+  while (*credit >= 1.0f) {
+    (this->*action)();
+    *credit -= 1.0f;
+  }
+}
+
+void loadgen::check_timeouts(int64_t now)
+{
+  static const ue_state_t pending_states[] = {UE_ATTACHING, UE_RELEASING, UE_PAGED, UE_SERVICE_PENDING, UE_DETACHING};
+
+  for (ue_state_t state : pending_states) {
+    // Iterate over a copy, failing a procedure moves the UE out of the set
+    std::vector<uint32_t> members = m_state_members[state];
+    for (uint32_t ue_idx : members) {
+      ue_ctx_t* ue = &m_ues[ue_idx];
+      if (now - ue->proc_start_us > PROC_TIMEOUT_US) {
+        m_log->warning("IMSI %015" PRIu64 " -- %s procedure timed out\n", ue->imsi, proc_names[ue->proc]);
+        fail_proc(ue);
+      }
+    }
+  }
+}
+
+/*******************************************************************************
+ * Actions
+ *******************************************************************************/
+void loadgen::start_attach()
+{
+  ue_ctx_t* ue = nullptr;
+  if (!pick_ue(UE_DEREGISTERED, &ue)) {
+    return;
+  }
+
+  reset_ue(ue);
+  set_state(ue, UE_ATTACHING);
+  start_proc(ue, PROC_ATTACH);
+
+  LIBLTE_BYTE_MSG_STRUCT nas_msg = {};
+  gen_attach_request(ue, &nas_msg);
+  send_initial_ue_message(ue, &nas_msg, false);
+}
+
+void loadgen::start_detach()
+{
+  ue_ctx_t* ue = nullptr;
+  if (!pick_ue(UE_CONNECTED, &ue)) {
+    return;
+  }
+
+  set_state(ue, UE_DETACHING);
+  start_proc(ue, PROC_DETACH);
+
+  LIBLTE_MME_DETACH_REQUEST_MSG_STRUCT detach_req = {};
+  detach_req.detach_type.switch_off               = 1;
+  detach_req.detach_type.type_of_detach           = LIBLTE_MME_SO_FLAG_SWITCH_OFF;
+  detach_req.eps_mobile_id.type_of_id             = LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI;
+  detach_req.eps_mobile_id.guti                   = ue->guti;
+  detach_req.nas_ksi.tsc_flag                     = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  detach_req.nas_ksi.nas_ksi                      = ue->ksi;
+
+  LIBLTE_BYTE_MSG_STRUCT nas_msg = {};
+  liblte_mme_pack_detach_request_msg(&detach_req, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY, ue->tx_count, &nas_msg);
+  apply_security(ue, &nas_msg, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY);
+  send_ul_nas_transport(ue, &nas_msg);
+  ue->tx_count++;
+}
+
+void loadgen::start_release()
+{
+  ue_ctx_t* ue = nullptr;
+  if (!pick_ue(UE_CONNECTED, &ue)) {
+    return;
+  }
+
+  set_state(ue, UE_RELEASING);
+  start_proc(ue, PROC_RELEASE);
+  send_ue_context_release_request(ue);
+}
+
+void loadgen::start_service_request()
+{
+  ue_ctx_t* ue = nullptr;
+  if (!pick_ue(UE_IDLE, &ue)) {
+    return;
+  }
+
+  set_state(ue, UE_SERVICE_PENDING);
+  start_proc(ue, PROC_SERVICE);
+
+  LIBLTE_BYTE_MSG_STRUCT nas_msg = {};
+  gen_service_request(ue, &nas_msg);
+  send_initial_ue_message(ue, &nas_msg, true);
+}
+
+// Downlink data for an idle UE is generated by a connected UE sending a packet to its address. The SP-GW host must
+// route packets received on the SGi interface back into it for the packet to reach the idle UE.
+void loadgen::start_paging()
+{
+  ue_ctx_t* src = nullptr;
+  ue_ctx_t* dst = nullptr;
+  if (!pick_ue(UE_CONNECTED, &src) || !pick_ue(UE_IDLE, &dst)) {
+    return;
+  }
+
+  set_state(dst, UE_PAGED);
+  start_proc(dst, PROC_PAGING);
+  send_gtpu(src, htonl(dst->ue_ip), m_args.gtpu_size);
+}
+
+void loadgen::send_gtpu_packet()
+{
+  ue_ctx_t* ue = nullptr;
+  if (!pick_ue(UE_CONNECTED, &ue)) {
+    return;
+  }
+  send_gtpu(ue, m_gtp_dst_addr, m_args.gtpu_size);
+}
+
+/*******************************************************************************
+ * UE state bookkeeping
+ *******************************************************************************/
+void loadgen::set_state(ue_ctx_t* ue, ue_state_t state)
+{
+  ue_state_t old_state = m_ue_state[ue->idx];
+  if (old_state == state) {
+    return;
+  }
+
+  // Remove from the old set by moving its last member into the freed position
+  std::vector<uint32_t>& old_members = m_state_members[old_state];
+  uint32_t               pos         = m_ue_state_pos[ue->idx];
+  old_members[pos]                   = old_members.back();
+  m_ue_state_pos[old_members[pos]]   = pos;
+  old_members.pop_back();
+
+  m_ue_state[ue->idx]     = state;
+  m_ue_state_pos[ue->idx] = m_state_members[state].size();
+  m_state_members[state].push_back(ue->idx);
+}
+
+bool loadgen::pick_ue(ue_state_t state, ue_ctx_t** ue)
+{
+  const std::vector<uint32_t>& members = m_state_members[state];
+  if (members.empty()) {
+    return false;
+  }
+  *ue = &m_ues[members[m_rng() % members.size()]];
+  return true;
+}
+
+void loadgen::start_proc(ue_ctx_t* ue, proc_t proc)
+{
+  ue->proc          = proc;
+  ue->proc_start_us = now_us();
+  m_stats[proc].nof_started++;
+}
+
+void loadgen::complete_proc(ue_ctx_t* ue)
+{
+  proc_stats_t* stats = &m_stats[ue->proc];
+  stats->nof_completed++;
+  stats->latency_ms.push_back((now_us() - ue->proc_start_us) / 1000.0f);
+}
+
+void loadgen::fail_proc(ue_ctx_t* ue)
+{
+  m_stats[ue->proc].nof_failed++;
+
+  // Whatever the EPC still keeps for the UE is overwritten by its next IMSI attach
+  reset_ue(ue);
+  set_state(ue, UE_DEREGISTERED);
+}
+
+void loadgen::reset_ue(ue_ctx_t* ue)
+{
+  if (ue->guti.m_tmsi != 0) {
+    m_tmsi_to_ue.erase(ue->guti.m_tmsi);
+    ue->guti.m_tmsi = 0;
+  }
+  if (ue->mme_ue_s1ap_id_present) {
+    m_mme_ue_s1ap_id_to_ue.erase(ue->mme_ue_s1ap_id);
+    ue->mme_ue_s1ap_id_present = false;
+  }
+  ue->have_ctxt = false;
+  ue->tx_count  = 0;
+}
+
+loadgen::ue_ctx_t* loadgen::find_ue(uint32_t enb_ue_s1ap_id, uint32_t mme_ue_s1ap_id)
+{
+  if (enb_ue_s1ap_id == 0 || enb_ue_s1ap_id > m_ues.size()) {
+    m_log->warning("eNB UE S1AP id %d not found\n", enb_ue_s1ap_id);
+    return nullptr;
+  }
+  ue_ctx_t* ue = &m_ues[enb_ue_s1ap_id - 1];
+  if (!ue->mme_ue_s1ap_id_present || ue->mme_ue_s1ap_id != mme_ue_s1ap_id) {
+    if (ue->mme_ue_s1ap_id_present) {
+      m_mme_ue_s1ap_id_to_ue.erase(ue->mme_ue_s1ap_id);
+    }
+    ue->mme_ue_s1ap_id                     = mme_ue_s1ap_id;
+    ue->mme_ue_s1ap_id_present             = true;
+    m_mme_ue_s1ap_id_to_ue[mme_ue_s1ap_id] = ue->idx;
+  }
+  return ue;
+}
+
+/*******************************************************************************
+ * S1AP
+ *******************************************************************************/
+bool loadgen::connect_enb(uint32_t enb_idx)
+{
+  enb_ctx_t* enb  = &m_enbs[enb_idx];
+  enb->enb_id     = m_args.enb_id + enb_idx;
+  enb->setup_done = false;
+
+  if (!srslte::net_utils::sctp_init_client(
+          &enb->socket, srslte::net_utils::socket_type::seqpacket, m_args.s1c_bind_addr.c_str())) {
+    m_log->console("Could not create SCTP socket for eNB 0x%x\n", enb->enb_id);
+    return false;
+  }
+  if (!enb->socket.connect_to(m_args.mme_addr.c_str(), S1AP_PORT, &enb->mme_addr)) {
+    m_log->console("Could not connect eNB 0x%x to MME %s\n", enb->enb_id, m_args.mme_addr.c_str());
+    return false;
+  }
+
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  ev.data.u32           = enb_idx;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, enb->socket.fd(), &ev) != 0) {
+    m_log->console("Could not add eNB socket to epoll: %s\n", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool loadgen::send_s1_setup_request(uint32_t enb_idx)
+{
+  enb_ctx_t* enb = &m_enbs[enb_idx];
+  uint32_t   plmn;
+  uint16_t   tmp16;
+  srslte::s1ap_mccmnc_to_plmn(m_args.mcc, m_args.mnc, &plmn);
+  plmn = htonl(plmn);
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_S1_SETUP);
+  s1_setup_request_ies_container& container = pdu.init_msg().value.s1_setup_request().protocol_ies;
+  container.global_enb_id.value.plm_nid[0]  = ((uint8_t*)&plmn)[1];
+  container.global_enb_id.value.plm_nid[1]  = ((uint8_t*)&plmn)[2];
+  container.global_enb_id.value.plm_nid[2]  = ((uint8_t*)&plmn)[3];
+  container.global_enb_id.value.enb_id.set_macro_enb_id().from_number(enb->enb_id);
+
+  char enb_name[32];
+  snprintf(enb_name, sizeof(enb_name), "srsloadgen%04d", enb_idx);
+  container.enbname_present = true;
+  container.enbname.value.from_string(enb_name);
+
+  container.supported_tas.value.resize(1);
+  tmp16 = htons(m_args.tac);
+  memcpy(container.supported_tas.value[0].tac.data(), (uint8_t*)&tmp16, 2);
+  container.supported_tas.value[0].broadcast_plmns.resize(1);
+  container.supported_tas.value[0].broadcast_plmns[0][0] = ((uint8_t*)&plmn)[1];
+  container.supported_tas.value[0].broadcast_plmns[0][1] = ((uint8_t*)&plmn)[2];
+  container.supported_tas.value[0].broadcast_plmns[0][2] = ((uint8_t*)&plmn)[3];
+
+  container.default_paging_drx.value.value = asn1::s1ap::paging_drx_opts::v128;
+
+  return send_s1ap_pdu(enb_idx, pdu, "S1SetupRequest");
+}
+
+bool loadgen::send_s1ap_pdu(uint32_t enb_idx, const s1ap_pdu_c& tx_pdu, const char* procedure_name)
+{
+  enb_ctx_t*    enb = &m_enbs[enb_idx];
+  uint8_t       buf[RX_BUFFER_SIZE];
+  asn1::bit_ref bref(buf, sizeof(buf));
+  if (tx_pdu.pack(bref) != asn1::SRSASN_SUCCESS) {
+    m_log->error("Failed to pack %s\n", procedure_name);
+    return false;
+  }
+
+  ssize_t n_sent = sctp_sendmsg(enb->socket.fd(),
+                                buf,
+                                bref.distance_bytes(),
+                                (struct sockaddr*)&enb->mme_addr,
+                                sizeof(struct sockaddr_in),
+                                htonl((uint32_t)srslte::net_utils::ppid_values::S1AP),
+                                0,
+                                S1AP_STREAM_ID,
+                                0,
+                                0);
+  if (n_sent == -1) {
+    m_log->error("Failed to send %s: %s\n", procedure_name, strerror(errno));
+    return false;
+  }
+  m_log->debug("Sent %s from eNB 0x%x\n", procedure_name, enb->enb_id);
+  return true;
+}
+
+bool loadgen::send_initial_ue_message(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* nas_msg, bool has_tmsi)
+{
+  uint32_t plmn;
+  srslte::s1ap_mccmnc_to_plmn(m_args.mcc, m_args.mnc, &plmn);
+
+  s1ap_pdu_c tx_pdu;
+  tx_pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+  init_ue_msg_ies_container& container = tx_pdu.init_msg().value.init_ue_msg().protocol_ies;
+
+  if (has_tmsi) {
+    container.s_tmsi_present = true;
+    srslte::uint32_to_uint8(ue->guti.m_tmsi, container.s_tmsi.value.m_tmsi.data());
+    container.s_tmsi.value.mmec[0] = ue->guti.mme_code;
+  }
+  container.enb_ue_s1ap_id.value = ue->enb_ue_s1ap_id;
+  container.nas_pdu.value.resize(nas_msg->N_bytes);
+  memcpy(container.nas_pdu.value.data(), nas_msg->msg, nas_msg->N_bytes);
+  container.tai.value.plm_nid.from_number(plmn);
+  container.tai.value.tac.from_number(m_args.tac);
+  container.eutran_cgi.value.plm_nid.from_number(plmn);
+  container.eutran_cgi.value.cell_id.from_number(m_enbs[ue->enb_idx].enb_id << 8u);
+  container.rrc_establishment_cause.value =
+      has_tmsi ? rrc_establishment_cause_opts::mo_data : rrc_establishment_cause_opts::mo_sig;
+
+  return send_s1ap_pdu(ue->enb_idx, tx_pdu, "InitialUEMessage");
+}
+
+bool loadgen::send_ul_nas_transport(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* nas_msg)
+{
+  uint32_t plmn;
+  srslte::s1ap_mccmnc_to_plmn(m_args.mcc, m_args.mnc, &plmn);
+
+  s1ap_pdu_c tx_pdu;
+  tx_pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UL_NAS_TRANSPORT);
+  ul_nas_transport_ies_container& container = tx_pdu.init_msg().value.ul_nas_transport().protocol_ies;
+  container.mme_ue_s1ap_id.value            = ue->mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value            = ue->enb_ue_s1ap_id;
+  container.nas_pdu.value.resize(nas_msg->N_bytes);
+  memcpy(container.nas_pdu.value.data(), nas_msg->msg, nas_msg->N_bytes);
+  container.eutran_cgi.value.plm_nid.from_number(plmn);
+  container.eutran_cgi.value.cell_id.from_number(m_enbs[ue->enb_idx].enb_id << 8u);
+  container.tai.value.plm_nid.from_number(plmn);
+  container.tai.value.tac.from_number(m_args.tac);
+
+  return send_s1ap_pdu(ue->enb_idx, tx_pdu, "UplinkNASTransport");
+}
+
+bool loadgen::send_ue_context_release_request(ue_ctx_t* ue)
+{
+  s1ap_pdu_c tx_pdu;
+  tx_pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE_REQUEST);
+  ue_context_release_request_ies_container& container =
+      tx_pdu.init_msg().value.ue_context_release_request().protocol_ies;
+  container.mme_ue_s1ap_id.value                  = ue->mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value                  = ue->enb_ue_s1ap_id;
+  container.cause.value.set_radio_network().value = cause_radio_network_opts::user_inactivity;
+
+  return send_s1ap_pdu(ue->enb_idx, tx_pdu, "UEContextReleaseRequest");
+}
+
+bool loadgen::send_ue_context_release_complete(ue_ctx_t* ue)
+{
+  s1ap_pdu_c tx_pdu;
+  tx_pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE);
+  auto& container                = tx_pdu.successful_outcome().value.ue_context_release_complete().protocol_ies;
+  container.enb_ue_s1ap_id.value = ue->enb_ue_s1ap_id;
+  container.mme_ue_s1ap_id.value = ue->mme_ue_s1ap_id;
+
+  return send_s1ap_pdu(ue->enb_idx, tx_pdu, "UEContextReleaseComplete");
+}
+
+bool loadgen::send_initial_context_setup_response(ue_ctx_t* ue)
+{
+  s1ap_pdu_c tx_pdu;
+  tx_pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_INIT_CONTEXT_SETUP);
+  auto& container                = tx_pdu.successful_outcome().value.init_context_setup_resp().protocol_ies;
+  container.mme_ue_s1ap_id.value = ue->mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value = ue->enb_ue_s1ap_id;
+
+  container.erab_setup_list_ctxt_su_res.value.resize(1);
+  container.erab_setup_list_ctxt_su_res.value[0].load_info_obj(ASN1_S1AP_ID_ERAB_SETUP_ITEM_CTXT_SU_RES);
+  auto& item   = container.erab_setup_list_ctxt_su_res.value[0].value.erab_setup_item_ctxt_su_res();
+  item.erab_id = ue->erab_id;
+  item.transport_layer_address.resize(32);
+  asn1::bitstring_utils::from_number(item.transport_layer_address.data(), ntohl(m_gtp_bind_addr), 32);
+  item.gtp_teid.from_number(ue->idx + 1);
+
+  return send_s1ap_pdu(ue->enb_idx, tx_pdu, "InitialContextSetupResponse");
+}
+
+void loadgen::handle_enb_rx(uint32_t enb_idx)
+{
+  enb_ctx_t*             enb = &m_enbs[enb_idx];
+  uint8_t                buf[RX_BUFFER_SIZE];
+  struct sockaddr_in     from     = {};
+  socklen_t              from_len = sizeof(from);
+  struct sctp_sndrcvinfo sri      = {};
+  int                    flags    = 0;
+
+  int rd_sz = sctp_recvmsg(enb->socket.fd(), buf, sizeof(buf), (struct sockaddr*)&from, &from_len, &sri, &flags);
+  if (rd_sz == -1 && errno != EAGAIN) {
+    m_log->error("Error reading from SCTP socket of eNB 0x%x: %s\n", enb->enb_id, strerror(errno));
+    m_running = false;
+    return;
+  }
+  if (rd_sz <= 0) {
+    return;
+  }
+
+  if (flags & MSG_NOTIFICATION) {
+    union sctp_notification* notification = (union sctp_notification*)buf;
+    if (notification->sn_header.sn_type == SCTP_SHUTDOWN_EVENT) {
+      m_log->console("MME closed the association of eNB 0x%x\n", enb->enb_id);
+      m_running = false;
+    }
+    return;
+  }
+  handle_s1ap_pdu(enb_idx, buf, rd_sz);
+}
+
+void loadgen::handle_s1ap_pdu(uint32_t enb_idx, const uint8_t* pdu, uint32_t len)
+{
+  s1ap_pdu_c     rx_pdu;
+  asn1::cbit_ref bref(pdu, len);
+  if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+    m_log->error("Failed to unpack received S1AP PDU\n");
+    return;
+  }
+
+  switch (rx_pdu.type().value) {
+    case s1ap_pdu_c::types_opts::init_msg:
+      switch (rx_pdu.init_msg().value.type().value) {
+        case s1ap_elem_procs_o::init_msg_c::types_opts::dl_nas_transport:
+          handle_dl_nas_transport(rx_pdu.init_msg().value.dl_nas_transport());
+          break;
+        case s1ap_elem_procs_o::init_msg_c::types_opts::init_context_setup_request:
+          handle_initial_context_setup_request(rx_pdu.init_msg().value.init_context_setup_request());
+          break;
+        case s1ap_elem_procs_o::init_msg_c::types_opts::ue_context_release_cmd:
+          handle_ue_context_release_command(rx_pdu.init_msg().value.ue_context_release_cmd());
+          break;
+        case s1ap_elem_procs_o::init_msg_c::types_opts::paging:
+          handle_paging(enb_idx, rx_pdu.init_msg().value.paging());
+          break;
+        default:
+          m_log->warning("Unhandled initiating message: %s\n", rx_pdu.init_msg().value.type().to_string().c_str());
+      }
+      break;
+    case s1ap_pdu_c::types_opts::successful_outcome:
+      if (rx_pdu.successful_outcome().value.type().value ==
+          s1ap_elem_procs_o::successful_outcome_c::types_opts::s1_setup_resp) {
+        m_enbs[enb_idx].setup_done = true;
+      }
+      break;
+    case s1ap_pdu_c::types_opts::unsuccessful_outcome:
+      if (rx_pdu.unsuccessful_outcome().value.type().value ==
+          s1ap_elem_procs_o::unsuccessful_outcome_c::types_opts::s1_setup_fail) {
+        m_log->console("S1 Setup Failure for eNB 0x%x\n", m_enbs[enb_idx].enb_id);
+        m_running = false;
+      }
+      break;
+    default:
+      m_log->error("Unhandled PDU type %d\n", rx_pdu.type().value);
+  }
+}
+
+void loadgen::handle_dl_nas_transport(const dl_nas_transport_s& msg)
+{
+  ue_ctx_t* ue = find_ue(msg.protocol_ies.enb_ue_s1ap_id.value.value, msg.protocol_ies.mme_ue_s1ap_id.value.value);
+  if (ue == nullptr) {
+    return;
+  }
+  handle_nas_pdu(ue, msg.protocol_ies.nas_pdu.value.data(), msg.protocol_ies.nas_pdu.value.size());
+}
+
+void loadgen::handle_initial_context_setup_request(const init_context_setup_request_s& msg)
+{
+  ue_ctx_t* ue = find_ue(msg.protocol_ies.enb_ue_s1ap_id.value.value, msg.protocol_ies.mme_ue_s1ap_id.value.value);
+  if (ue == nullptr) {
+    return;
+  }
+  if (msg.protocol_ies.erab_to_be_setup_list_ctxt_su_req.value.size() == 0) {
+    m_log->warning("IMSI %015" PRIu64 " -- Initial Context Setup Request without E-RABs\n", ue->imsi);
+    return;
+  }
+
+  const erab_to_be_setup_item_ctxt_su_req_s& erab =
+      msg.protocol_ies.erab_to_be_setup_list_ctxt_su_req.value[0].value.erab_to_be_setup_item_ctxt_su_req();
+  ue->erab_id  = erab.erab_id;
+  ue->sgw_addr = erab.transport_layer_address.to_number();
+  ue->sgw_teid = erab.gtp_teid.to_number();
+  send_initial_context_setup_response(ue);
+
+  if (erab.nas_pdu_present) {
+    // Attach Accept, the attach completes with the Attach Complete sent in response
+    handle_nas_pdu(ue, erab.nas_pdu.data(), erab.nas_pdu.size());
+  } else if (m_ue_state[ue->idx] == UE_SERVICE_PENDING) {
+    complete_proc(ue);
+    set_state(ue, UE_CONNECTED);
+  }
+}
+
+void loadgen::handle_ue_context_release_command(const ue_context_release_cmd_s& msg)
+{
+  ue_ctx_t* ue = nullptr;
+  if (msg.protocol_ies.ue_s1ap_ids.value.type().value == ue_s1ap_ids_c::types_opts::ue_s1ap_id_pair) {
+    const ue_s1ap_id_pair_s& idpair = msg.protocol_ies.ue_s1ap_ids.value.ue_s1ap_id_pair();
+    ue                              = find_ue(idpair.enb_ue_s1ap_id, idpair.mme_ue_s1ap_id);
+  } else {
+    auto it = m_mme_ue_s1ap_id_to_ue.find(msg.protocol_ies.ue_s1ap_ids.value.mme_ue_s1ap_id());
+    if (it != m_mme_ue_s1ap_id_to_ue.end()) {
+      ue = &m_ues[it->second];
+    }
+  }
+  if (ue == nullptr) {
+    m_log->warning("UE Context Release Command for unknown UE\n");
+    return;
+  }
+
+  send_ue_context_release_complete(ue);
+  m_mme_ue_s1ap_id_to_ue.erase(ue->mme_ue_s1ap_id);
+  ue->mme_ue_s1ap_id_present = false;
+
+  switch (m_ue_state[ue->idx]) {
+    case UE_RELEASING:
+      complete_proc(ue);
+      set_state(ue, UE_IDLE);
+      break;
+    case UE_DETACHING:
+      complete_proc(ue);
+      reset_ue(ue);
+      set_state(ue, UE_DEREGISTERED);
+      break;
+    case UE_CONNECTED:
+      // Released by the network, the UE stays registered
+      set_state(ue, UE_IDLE);
+      break;
+    case UE_IDLE:
+    case UE_DEREGISTERED:
+      break;
+    default:
+      // The procedure in progress was aborted by the network
+      fail_proc(ue);
+      break;
+  }
+}
+
+void loadgen::handle_paging(uint32_t enb_idx, const paging_s& msg)
+{
+  if (msg.protocol_ies.ue_paging_id.value.type().value != ue_paging_id_c::types_opts::s_tmsi) {
+    return;
+  }
+  uint32_t m_tmsi;
+  srslte::uint8_to_uint32(msg.protocol_ies.ue_paging_id.value.s_tmsi().m_tmsi.data(), &m_tmsi);
+
+  // The MME pages on all eNBs, only the one the UE is camped on answers
+  auto it = m_tmsi_to_ue.find(m_tmsi);
+  if (it == m_tmsi_to_ue.end() || m_ues[it->second].enb_idx != enb_idx) {
+    return;
+  }
+  ue_ctx_t*  ue    = &m_ues[it->second];
+  ue_state_t state = m_ue_state[ue->idx];
+  if (state != UE_PAGED && state != UE_IDLE) {
+    return;
+  }
+  m_nof_paging_rx++;
+
+  if (state == UE_IDLE) {
+    start_proc(ue, PROC_SERVICE);
+  }
+  set_state(ue, UE_SERVICE_PENDING);
+
+  LIBLTE_BYTE_MSG_STRUCT nas_msg = {};
+  gen_service_request(ue, &nas_msg);
+  send_initial_ue_message(ue, &nas_msg, true);
+}
+
+/*******************************************************************************
+ * NAS
+ *******************************************************************************/
+void loadgen::handle_nas_pdu(ue_ctx_t* ue, const uint8_t* pdu, uint32_t len)
+{
+  LIBLTE_BYTE_MSG_STRUCT msg;
+  uint8_t                pd, sec_hdr_type, msg_type;
+
+  if (len < 2 || len > LIBLTE_MAX_MSG_SIZE_BYTES) {
+    m_log->warning("IMSI %015" PRIu64 " -- Invalid NAS PDU size %d\n", ue->imsi, len);
+    return;
+  }
+  memcpy(msg.msg, pdu, len);
+  msg.N_bytes = len;
+
+  // Downlink integrity is not verified, the generator trusts the network it is loading
+  liblte_mme_parse_msg_sec_header(&msg, &pd, &sec_hdr_type);
+  if ((sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED ||
+       sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT) &&
+      len > 6) {
+    cipher(ue, msg.msg[5], srslte::SECURITY_DIRECTION_DOWNLINK, &msg.msg[6], len - 6);
+  }
+  liblte_mme_parse_msg_header(&msg, &pd, &msg_type);
+
+  switch (msg_type) {
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REQUEST:
+      handle_authentication_request(ue, &msg);
+      break;
+    case LIBLTE_MME_MSG_TYPE_SECURITY_MODE_COMMAND:
+      handle_security_mode_command(ue, &msg);
+      break;
+    case LIBLTE_MME_MSG_TYPE_ATTACH_ACCEPT:
+      handle_attach_accept(ue, &msg);
+      break;
+    case LIBLTE_MME_MSG_TYPE_ATTACH_REJECT:
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REJECT:
+    case LIBLTE_MME_MSG_TYPE_SERVICE_REJECT:
+      m_log->warning("IMSI %015" PRIu64 " -- Received %s\n", ue->imsi, liblte_nas_msg_type_to_string(msg_type));
+      if (m_ue_state[ue->idx] != UE_DEREGISTERED) {
+        fail_proc(ue);
+      }
+      break;
+    case LIBLTE_MME_MSG_TYPE_EMM_INFORMATION:
+    case LIBLTE_MME_MSG_TYPE_DETACH_ACCEPT:
+      break;
+    default:
+      m_log->warning(
+          "IMSI %015" PRIu64 " -- Unhandled NAS message %s\n", ue->imsi, liblte_nas_msg_type_to_string(msg_type));
+  }
+}
+
+void loadgen::handle_authentication_request(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req = {};
+  liblte_mme_unpack_authentication_request_msg(msg, &auth_req);
+
+  // Milenage as run by the USIM. The network is trusted, so the MAC in the AUTN is not checked against f1.
+  uint8_t res[8], ck[16], ik[16], ak[6], sqn[6];
+  srslte::security_milenage_f2345(m_args.k, m_args.opc, auth_req.rand, res, ck, ik, ak);
+  for (uint32_t i = 0; i < 6; i++) {
+    sqn[i] = auth_req.autn[i] ^ ak[i];
+  }
+  srslte::security_generate_k_asme(ck, ik, ak, sqn, m_args.mcc, m_args.mnc, ue->k_asme);
+  ue->ksi = auth_req.nas_ksi.nas_ksi;
+
+  LIBLTE_MME_AUTHENTICATION_RESPONSE_MSG_STRUCT auth_res = {};
+  memcpy(auth_res.res, res, sizeof(res));
+  auth_res.res_len = sizeof(res);
+
+  LIBLTE_BYTE_MSG_STRUCT nas_msg = {};
+  liblte_mme_pack_authentication_response_msg(&auth_res, LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS, 0, &nas_msg);
+  send_ul_nas_transport(ue, &nas_msg);
+}
+
+void loadgen::handle_security_mode_command(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT sec_mode_cmd = {};
+  liblte_mme_unpack_security_mode_command_msg(msg, &sec_mode_cmd);
+
+  ue->cipher_algo = (srslte::CIPHERING_ALGORITHM_ID_ENUM)sec_mode_cmd.selected_nas_sec_algs.type_of_eea;
+  ue->integ_algo  = (srslte::INTEGRITY_ALGORITHM_ID_ENUM)sec_mode_cmd.selected_nas_sec_algs.type_of_eia;
+  srslte::security_generate_k_nas(ue->k_asme, ue->cipher_algo, ue->integ_algo, ue->k_nas_enc, ue->k_nas_int);
+
+  // Counters restart with the new security context
+  ue->have_ctxt = true;
+  ue->tx_count  = 0;
+
+  LIBLTE_MME_SECURITY_MODE_COMPLETE_MSG_STRUCT sec_mode_comp = {};
+  LIBLTE_BYTE_MSG_STRUCT                       nas_msg       = {};
+  uint8_t sec_hdr_type = LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT;
+  liblte_mme_pack_security_mode_complete_msg(&sec_mode_comp, sec_hdr_type, ue->tx_count, &nas_msg);
+  apply_security(ue, &nas_msg, sec_hdr_type);
+  send_ul_nas_transport(ue, &nas_msg);
+  ue->tx_count++;
+}
+
+void loadgen::handle_attach_accept(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  LIBLTE_MME_ATTACH_ACCEPT_MSG_STRUCT                               attach_accept = {};
+  LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_REQUEST_MSG_STRUCT act_def_req   = {};
+  liblte_mme_unpack_attach_accept_msg(msg, &attach_accept);
+  liblte_mme_unpack_activate_default_eps_bearer_context_request_msg(&attach_accept.esm_msg, &act_def_req);
+
+  if (attach_accept.guti_present) {
+    if (ue->guti.m_tmsi != 0) {
+      m_tmsi_to_ue.erase(ue->guti.m_tmsi);
+    }
+    ue->guti                      = attach_accept.guti.guti;
+    m_tmsi_to_ue[ue->guti.m_tmsi] = ue->idx;
+  }
+  ue->ue_ip = ((uint32_t)act_def_req.pdn_addr.addr[0] << 24u) | ((uint32_t)act_def_req.pdn_addr.addr[1] << 16u) |
+              ((uint32_t)act_def_req.pdn_addr.addr[2] << 8u) | act_def_req.pdn_addr.addr[3];
+
+  LIBLTE_MME_ATTACH_COMPLETE_MSG_STRUCT                            attach_complete = {};
+  LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_ACCEPT_MSG_STRUCT act_def_accept  = {};
+  act_def_accept.eps_bearer_id       = act_def_req.eps_bearer_id;
+  act_def_accept.proc_transaction_id = act_def_req.proc_transaction_id;
+  liblte_mme_pack_activate_default_eps_bearer_context_accept_msg(&act_def_accept, &attach_complete.esm_msg);
+
+  LIBLTE_BYTE_MSG_STRUCT nas_msg = {};
+  liblte_mme_pack_attach_complete_msg(
+      &attach_complete, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED, ue->tx_count, &nas_msg);
+  apply_security(ue, &nas_msg, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED);
+  send_ul_nas_transport(ue, &nas_msg);
+  ue->tx_count++;
+
+  if (m_ue_state[ue->idx] == UE_ATTACHING) {
+    complete_proc(ue);
+  }
+  set_state(ue, UE_CONNECTED);
+}
+
+void loadgen::gen_attach_request(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req = {};
+  attach_req.eps_attach_type                      = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+
+  // EEA0-2 and EIA1-2, the MME picks among them according to its configuration
+  for (uint32_t i = 0; i < 3; i++) {
+    attach_req.ue_network_cap.eea[i] = true;
+    attach_req.ue_network_cap.eia[i] = i > 0;
+  }
+
+  // IMSI digits, most significant first
+  attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+  uint64_t imsi                       = ue->imsi;
+  for (int i = 14; i >= 0; i--) {
+    attach_req.eps_mobile_id.imsi[i] = imsi % 10;
+    imsi /= 10;
+  }
+  attach_req.nas_ksi.tsc_flag = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  attach_req.nas_ksi.nas_ksi  = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+
+  LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req = {};
+  pdn_con_req.eps_bearer_id                                  = 0x00;
+  pdn_con_req.proc_transaction_id                            = 0x01;
+  pdn_con_req.request_type                                   = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+  pdn_con_req.pdn_type                                       = LIBLTE_MME_PDN_TYPE_IPV4;
+  liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+
+  liblte_mme_pack_attach_request_msg(&attach_req, msg);
+}
+
+void loadgen::gen_service_request(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  msg->msg[0] = (LIBLTE_MME_SECURITY_HDR_TYPE_SERVICE_REQUEST << 4u) | (LIBLTE_MME_PD_EPS_MOBILITY_MANAGEMENT);
+  msg->msg[1] = ((ue->ksi & 0x07u) << 5u) | (ue->tx_count & 0x1Fu);
+
+  // Short MAC, the two least significant bytes of the MAC over the first two octets
+  uint8_t mac[4];
+  integrity_generate(ue, &msg->msg[0], 2, mac);
+  msg->msg[2]  = mac[2];
+  msg->msg[3]  = mac[3];
+  msg->N_bytes = 4;
+  ue->tx_count++;
+}
+
+void loadgen::apply_security(ue_ctx_t* ue, LIBLTE_BYTE_MSG_STRUCT* msg, uint8_t sec_hdr_type)
+{
+  if (msg->N_bytes <= 6) {
+    return;
+  }
+  if (sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED ||
+      sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT) {
+    cipher(ue, ue->tx_count, srslte::SECURITY_DIRECTION_UPLINK, &msg->msg[6], msg->N_bytes - 6);
+  }
+  integrity_generate(ue, &msg->msg[5], msg->N_bytes - 5, &msg->msg[1]);
+}
+
+void loadgen::integrity_generate(ue_ctx_t* ue, uint8_t* msg, uint32_t msg_len, uint8_t* mac)
+{
+  switch (ue->integ_algo) {
+    case srslte::INTEGRITY_ALGORITHM_ID_128_EIA1:
+      srslte::security_128_eia1(
+          &ue->k_nas_int[16], ue->tx_count, 0, srslte::SECURITY_DIRECTION_UPLINK, msg, msg_len, mac);
+      break;
+    case srslte::INTEGRITY_ALGORITHM_ID_128_EIA2:
+      srslte::security_128_eia2(
+          &ue->k_nas_int[16], ue->tx_count, 0, srslte::SECURITY_DIRECTION_UPLINK, msg, msg_len, mac);
+      break;
+    default:
+      memset(mac, 0, 4);
+      break;
+  }
+}
+
+void loadgen::cipher(ue_ctx_t* ue, uint32_t count, uint8_t direction, uint8_t* msg, uint32_t msg_len)
+{
+  uint8_t tmp[LIBLTE_MAX_MSG_SIZE_BYTES];
+  switch (ue->cipher_algo) {
+    case srslte::CIPHERING_ALGORITHM_ID_128_EEA1:
+      srslte::security_128_eea1(&ue->k_nas_enc[16], count, 0, direction, msg, msg_len, tmp);
+      memcpy(msg, tmp, msg_len);
+      break;
+    case srslte::CIPHERING_ALGORITHM_ID_128_EEA2:
+      srslte::security_128_eea2(&ue->k_nas_enc[16], count, 0, direction, msg, msg_len, tmp);
+      memcpy(msg, tmp, msg_len);
+      break;
+    default:
+      break;
+  }
+}
+
+/*******************************************************************************
+ * GTP-U
+ *******************************************************************************/
+void loadgen::handle_gtpu_rx()
+{
+  uint8_t buf[RX_BUFFER_SIZE];
+  while (recv(m_gtpu_socket.fd(), buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+    m_nof_gtpu_rx++;
+  }
+}
+
+// Sends an UDP/IPv4 packet from the UE to dst_addr (network order) over the S1-U bearer of the UE
+bool loadgen::send_gtpu(ue_ctx_t* ue, uint32_t dst_addr, uint32_t payload_len)
+{
+  uint8_t  buf[RX_BUFFER_SIZE];
+  uint32_t ip_len = 20 + 8 + std::min(payload_len, RX_BUFFER_SIZE - 36);
+
+  // GTP-U header, G-PDU without optional fields
+  buf[0] = 0x30;
+  buf[1] = 0xff;
+  srslte::uint16_to_uint8(ip_len, &buf[2]);
+  srslte::uint32_to_uint8(ue->sgw_teid, &buf[4]);
+
+  // IPv4 header
+  uint8_t* ip = &buf[8];
+  memset(ip, 0, ip_len);
+  ip[0] = 0x45;
+  srslte::uint16_to_uint8(ip_len, &ip[2]);
+  ip[8] = 64;
+  ip[9] = IPPROTO_UDP;
+  srslte::uint32_to_uint8(ue->ue_ip, &ip[12]);
+  memcpy(&ip[16], &dst_addr, 4);
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < 20; i += 2) {
+    sum += (ip[i] << 8u) | ip[i + 1];
+  }
+  while (sum >> 16u) {
+    sum = (sum & 0xffff) + (sum >> 16u);
+  }
+  srslte::uint16_to_uint8(~sum & 0xffff, &ip[10]);
+
+  // UDP header to the discard port, checksum not computed
+  srslte::uint16_to_uint8(9, &ip[20]);
+  srslte::uint16_to_uint8(9, &ip[22]);
+  srslte::uint16_to_uint8(ip_len - 20, &ip[24]);
+
+  struct sockaddr_in sgw = {};
+  sgw.sin_family         = AF_INET;
+  sgw.sin_addr.s_addr    = htonl(ue->sgw_addr);
+  sgw.sin_port           = htons(GTPU_PORT);
+  if (sendto(m_gtpu_socket.fd(), buf, 8 + ip_len, MSG_DONTWAIT, (struct sockaddr*)&sgw, sizeof(sgw)) < 0) {
+    m_nof_gtpu_tx_err++;
+    return false;
+  }
+  m_nof_gtpu_tx++;
+  return true;
+}
+
+/*******************************************************************************
+ * Report
+ *******************************************************************************/
+void loadgen::print_report(bool final_report)
+{
+  float elapsed_s = m_start_us == 0 ? 0 : (now_us() - m_start_us) * 1e-6f;
+
+  m_log->console("\n%s after %.1f s -- connected %zd, idle %zd, deregistered %zd\n",
+                 final_report ? "Final report" : "Report",
+                 elapsed_s,
+                 m_state_members[UE_CONNECTED].size(),
+                 m_state_members[UE_IDLE].size(),
+                 m_state_members[UE_DEREGISTERED].size());
+  m_log->console("%-9s %9s %9s %7s %8s %8s %8s %8s %8s\n",
+                 "proc",
+                 "started",
+                 "done",
+                 "failed",
+                 "done/s",
+                 "p50 ms",
+                 "p90 ms",
+                 "p99 ms",
+                 "max ms");
+  for (uint32_t p = 0; p < PROC_NOF_PROCS; p++) {
+    proc_stats_t* stats = &m_stats[p];
+    if (stats->nof_started == 0) {
+      continue;
+    }
+    float pct[4] = {};
+    if (!stats->latency_ms.empty()) {
+      std::vector<float> sorted = stats->latency_ms;
+      std::sort(sorted.begin(), sorted.end());
+      const float q[3] = {0.50f, 0.90f, 0.99f};
+      for (uint32_t i = 0; i < 3; i++) {
+        pct[i] = sorted[std::min((size_t)(q[i] * sorted.size()), sorted.size() - 1)];
+      }
+      pct[3] = sorted.back();
+    }
+    m_log->console("%-9s %9" PRIu64 " %9" PRIu64 " %7" PRIu64 " %8.1f %8.2f %8.2f %8.2f %8.2f\n",
+                   proc_names[p],
+                   stats->nof_started,
+                   stats->nof_completed,
+                   stats->nof_failed,
+                   elapsed_s > 0 ? stats->nof_completed / elapsed_s : 0,
+                   pct[0],
+                   pct[1],
+                   pct[2],
+                   pct[3]);
+  }
+  if (m_nof_gtpu_tx > 0 || m_nof_gtpu_rx > 0 || m_nof_paging_rx > 0) {
+    m_log->console("GTP-U tx %" PRIu64 " (errors %" PRIu64 "), rx %" PRIu64 ", paging rx %" PRIu64 "\n",
+                   m_nof_gtpu_tx,
+                   m_nof_gtpu_tx_err,
+                   m_nof_gtpu_rx,
+                   m_nof_paging_rx);
+  }
+}
+
+} // namespace srsepc
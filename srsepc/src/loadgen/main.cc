@@ -0,0 +1,195 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/loadgen/loadgen.h"
+#include "srslte/common/bcd_helpers.h"
+#include "srslte/common/log_filter.h"
+#include "srslte/common/logger_stdout.h"
+#include "srslte/common/signal_handler.h"
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <inttypes.h>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace srsepc;
+namespace bpo = boost::program_options;
+
+/**********************************************************************
+ *  Program arguments processing
+ ***********************************************************************/
+static bool hex_to_key(const string& str, uint8_t* key)
+{
+  if (str.size() != 32) {
+    return false;
+  }
+  for (uint32_t i = 0; i < 16; i++) {
+    key[i] = (uint8_t)strtoul(str.substr(2 * i, 2).c_str(), nullptr, 16);
+  }
+  return true;
+}
+
+void parse_args(loadgen_args_t* args, string* user_db, string* log_level, int argc, char* argv[])
+{
+  string mcc;
+  string mnc;
+  string tac;
+  string enb_id;
+  string k;
+  string opc;
+
+  // clang-format off
+  bpo::options_description options("Options");
+  options.add_options()
+    ("help,h", "Produce help message")
+    ("mme_addr",       bpo::value<string>(&args->mme_addr)->default_value("127.0.1.100"),     "IP address of the MME S1-MME interface")
+    ("s1c_bind_addr",  bpo::value<string>(&args->s1c_bind_addr)->default_value("127.0.1.1"),  "Local IP address the eNB SCTP associations are bound to")
+    ("gtp_bind_addr",  bpo::value<string>(&args->gtp_bind_addr)->default_value("127.0.1.1"),  "Local IP address of the eNB S1-U interface")
+    ("gtp_dst_addr",   bpo::value<string>(&args->gtp_dst_addr)->default_value("172.16.0.1"),  "Destination of the uplink user plane packets")
+    ("mcc",            bpo::value<string>(&mcc)->default_value("001"),                        "Mobile Country Code")
+    ("mnc",            bpo::value<string>(&mnc)->default_value("01"),                         "Mobile Network Code")
+    ("tac",            bpo::value<string>(&tac)->default_value("0x0007"),                     "Tracking Area Code")
+    ("enb_id",         bpo::value<string>(&enb_id)->default_value("0x19B"),                   "eNB ID of the first eNB, the others follow")
+    ("nof_enbs",       bpo::value<uint32_t>(&args->nof_enbs)->default_value(1),               "Number of emulated eNBs")
+    ("nof_ues",        bpo::value<uint32_t>(&args->nof_ues)->default_value(100),              "Number of emulated UEs")
+    ("imsi_base",      bpo::value<uint64_t>(&args->imsi_base)->default_value(1010000000001),  "IMSI of the first UE, the others follow")
+    ("k",              bpo::value<string>(&k)->default_value("00112233445566778899aabbccddeeff"),   "Milenage key K shared by all UEs")
+    ("opc",            bpo::value<string>(&opc)->default_value("63bfa50ee6523365ff14c1f45f88737d"), "Milenage OPc shared by all UEs")
+    ("attach_rate",    bpo::value<float>(&args->attach_rate)->default_value(10),              "Attaches per second")
+    ("detach_rate",    bpo::value<float>(&args->detach_rate)->default_value(0),               "Detaches of connected UEs per second")
+    ("release_rate",   bpo::value<float>(&args->release_rate)->default_value(0),              "Releases of connected UEs to idle per second")
+    ("service_rate",   bpo::value<float>(&args->service_rate)->default_value(0),              "Service requests of idle UEs per second")
+    ("paging_rate",    bpo::value<float>(&args->paging_rate)->default_value(0),               "Packets sent to idle UEs per second, the SP-GW must route SGi traffic back into its TUN interface")
+    ("gtpu_rate",      bpo::value<float>(&args->gtpu_rate)->default_value(0),                 "Uplink user plane packets per second")
+    ("gtpu_size",      bpo::value<uint32_t>(&args->gtpu_size)->default_value(64),             "UDP payload size of the user plane packets")
+    ("duration",       bpo::value<uint32_t>(&args->duration_secs)->default_value(10),         "Test duration in seconds (0 runs until interrupted)")
+    ("report_period",  bpo::value<uint32_t>(&args->report_period_secs)->default_value(1),     "Period in seconds of the intermediate reports (0 disables them)")
+    ("user_db",        bpo::value<string>(user_db)->default_value(""),                        "Write the HSS user database for the emulated UEs to this file and exit")
+    ("log_level",      bpo::value<string>(log_level)->default_value("warning"),               "Log level")
+    ;
+  // clang-format on
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    cerr << e.what() << endl;
+    exit(1);
+  }
+
+  if (vm.count("help")) {
+    cout << "Usage: " << argv[0] << " [OPTIONS]" << endl << endl;
+    cout << options << endl;
+    exit(0);
+  }
+
+  {
+    std::stringstream sstr;
+    sstr << std::hex << tac;
+    sstr >> args->tac;
+  }
+  {
+    std::stringstream sstr;
+    sstr << std::hex << enb_id;
+    sstr >> args->enb_id;
+  }
+  if (!srslte::string_to_mcc(mcc, &args->mcc)) {
+    cout << "Error parsing mcc:" << mcc << " - must be a 3-digit string." << endl;
+    exit(1);
+  }
+  if (!srslte::string_to_mnc(mnc, &args->mnc)) {
+    cout << "Error parsing mnc:" << mnc << " - must be a 2 or 3-digit string." << endl;
+    exit(1);
+  }
+  if (!hex_to_key(k, args->k) || !hex_to_key(opc, args->opc)) {
+    cout << "Error parsing k or opc - must be 32 hexadecimal digits." << endl;
+    exit(1);
+  }
+}
+
+// Milenage subscribers with the shared K/OPc and dynamic IPs, in the format read by the HSS
+static bool write_user_db(const loadgen_args_t& args, const string& k, const string& opc, const string& filename)
+{
+  std::ofstream db(filename.c_str());
+  if (!db.is_open()) {
+    return false;
+  }
+  db << "# Generated by srsepc_loadgen" << endl;
+  char line[256];
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    snprintf(line,
+             sizeof(line),
+             "ue%d,mil,%015" PRIu64 ",%s,opc,%s,8000,000000001234,7,dynamic",
+             i,
+             args.imsi_base + i,
+             k.c_str(),
+             opc.c_str());
+    db << line << endl;
+  }
+  return db.good();
+}
+
+static string key_to_hex(const uint8_t* key)
+{
+  char str[33];
+  for (uint32_t i = 0; i < 16; i++) {
+    snprintf(&str[2 * i], 3, "%02x", key[i]);
+  }
+  return string(str);
+}
+
+int main(int argc, char* argv[])
+{
+  srslte_register_signal_handler();
+
+  loadgen_args_t args = {};
+  string         user_db;
+  string         log_level;
+  parse_args(&args, &user_db, &log_level, argc, argv);
+
+  if (!user_db.empty()) {
+    if (!write_user_db(args, key_to_hex(args.k), key_to_hex(args.opc), user_db)) {
+      cout << "Could not write user database " << user_db << endl;
+      return SRSLTE_ERROR;
+    }
+    cout << "Wrote " << args.nof_ues << " UEs to " << user_db << endl;
+    return SRSLTE_SUCCESS;
+  }
+
+  srslte::logger_stdout logger;
+  srslte::log_filter    log("LOAD", &logger);
+  log.set_level(log_level);
+
+  loadgen lg;
+  if (!lg.init(args, &log)) {
+    lg.stop();
+    return SRSLTE_ERROR;
+  }
+
+  while (running && lg.run_once()) {
+  }
+
+  lg.print_report(true);
+  lg.stop();
+  return SRSLTE_SUCCESS;
+}
@@ -28,6 +28,7 @@
 #include "srslte/common/crash_handler.h"
 #include "srslte/common/signal_handler.h"
 #include <boost/program_options.hpp>
+#include <inttypes.h>
 #include <iostream>
 #include <signal.h>
 
@@ -60,6 +61,7 @@ typedef struct {
   hss_args_t  hss_args;
   spgw_args_t spgw_args;
   log_args_t  log_args;
+  uint32_t    metrics_period_secs;
 } all_args_t;
 
 /**********************************************************************
@@ -112,6 +114,9 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("mme.encryption_algo", bpo::value<string>(&encryption_algo)->default_value("EEA0"),     "Set preferred encryption algorithm for NAS layer ")
     ("mme.integrity_algo",  bpo::value<string>(&integrity_algo)->default_value("EIA1"),      "Set preferred integrity protection algorithm for NAS")
     ("mme.paging_timer",    bpo::value<uint16_t>(&paging_timer)->default_value(2),           "Set paging timer value in seconds (T3413)")
+    ("mme.nas_workers",     bpo::value<uint32_t>(&args->mme_args.nas_workers)->default_value(0), "Number of threads generating the authentication vectors (0 generates them in the MME thread)")
+    ("mme.av_batch_size",   bpo::value<uint32_t>(&args->mme_args.av_batch_size)->default_value(1), "Authentication vectors requested to the HSS at a time for each UE, the spare ones serve its next authentications")
+    ("mme.metrics_period",  bpo::value<uint32_t>(&args->metrics_period_secs)->default_value(0),  "Period in seconds of the MME metrics printed to the console (0 disables them)")
     ("hss.db_file",         bpo::value<string>(&hss_db_file)->default_value("ue_db.csv"),    ".csv file that stores UE's keys")
     ("spgw.gtpu_bind_addr", bpo::value<string>(&spgw_bind_addr)->default_value("127.0.0.1"), "IP address of SP-GW for the S1-U connection")
     ("spgw.sgi_if_addr",    bpo::value<string>(&sgi_if_addr)->default_value("176.16.0.1"),   "IP address of TUN interface for the SGi connection")
@@ -372,6 +377,22 @@ std::string get_build_string()
   return ss.str();
 }
 
+void print_mme_metrics(mme* mme, mme_metrics_t* last, uint32_t period_secs)
+{
+  mme_metrics_t m;
+  mme->get_metrics(&m);
+  printf("MME: attach req %6.1f/s, attach complete %6.1f/s, %" PRIu64 " completed"
+         ", NAS tasks pending %u, AV prefetched %" PRIu64 ", AV hits %" PRIu64 ", AV misses %" PRIu64 "\n",
+         (float)(m.nof_attach_requests - last->nof_attach_requests) / period_secs,
+         (float)(m.nof_attach_completes - last->nof_attach_completes) / period_secs,
+         m.nof_attach_completes,
+         m.nof_nas_tasks_pending,
+         m.av_cache.nof_prefetched,
+         m.av_cache.nof_hits,
+         m.av_cache.nof_misses);
+  *last = m;
+}
+
 int main(int argc, char* argv[])
 {
   srslte_register_signal_handler();
@@ -454,8 +475,13 @@ int main(int argc, char* argv[])
 
   mme->start();
   spgw->start();
+  mme_metrics_t last_metrics = {};
+  uint32_t      nof_secs     = 0;
   while (running) {
     sleep(1);
+    if (args.metrics_period_secs > 0 && ++nof_secs % args.metrics_period_secs == 0) {
+      print_mme_metrics(mme, &last_metrics, args.metrics_period_secs);
+    }
   }
 
   mme->stop();
@@ -23,6 +23,8 @@
 #include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
 #include <netinet/sctp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -72,6 +74,9 @@ int mme::init(mme_args_t*         args,
   m_s1ap_log     = s1ap_log;
   m_mme_gtpc_log = mme_gtpc_log;
 
+  /*Init the authentication vector cache, the NAS reaches the HSS through it*/
+  m_av_cache.init(hss::get_instance(), args->av_batch_size, m_nas_log);
+
   /*Init S1AP*/
   m_s1ap = s1ap::get_instance();
   if (m_s1ap->init(args->s1ap_args, nas_log, s1ap_log)) {
@@ -86,6 +91,29 @@ int mme::init(mme_args_t*         args,
     exit(-1);
   }
 
+  /*Init event loop*/
+  m_epoll_fd = epoll_create1(0);
+  if (m_epoll_fd == -1) {
+    m_s1ap_log->console("Error creating epoll instance: %s\n", strerror(errno));
+    exit(-1);
+  }
+  int fds[] = {m_s1ap->get_s1_mme(), m_mme_gtpc->get_s11()};
+  for (int fd : fds) {
+    struct epoll_event ev = {};
+    ev.events             = EPOLLIN;
+    ev.data.fd            = fd;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+      m_s1ap_log->console("Error adding fd %d to epoll: %s\n", fd, strerror(errno));
+      exit(-1);
+    }
+  }
+
+  /*Init NAS workers*/
+  if (init_nas_workers(args->nas_workers)) {
+    m_s1ap_log->console("Error initializing NAS workers\n");
+    exit(-1);
+  }
+
   /*Log successful initialization*/
   m_s1ap_log->info("MME Initialized. MCC: 0x%x, MNC: 0x%x\n", args->s1ap_args.mcc, args->s1ap_args.mnc);
   m_s1ap_log->console("MME Initialized. MCC: 0x%x, MNC: 0x%x\n", args->s1ap_args.mcc, args->s1ap_args.mnc);
@@ -94,13 +122,22 @@ int mme::init(mme_args_t*         args,
 
 void mme::stop()
 {
-  if (m_running) {
-    m_s1ap->stop();
-    m_s1ap->cleanup();
+  bool running = m_running;
+  if (running) {
+    // Stop the MME thread first, so that no more tasks are pushed to the NAS workers
     m_running = false;
     thread_cancel();
     wait_thread_finish();
   }
+  stop_nas_workers();
+  if (running) {
+    m_s1ap->stop();
+    m_s1ap->cleanup();
+  }
+  if (m_epoll_fd != -1) {
+    close(m_epoll_fd);
+    m_epoll_fd = -1;
+  }
   return;
 }
 
@@ -123,28 +160,23 @@ void mme::run_thread()
   int s1mme = m_s1ap->get_s1_mme();
   int s11   = m_mme_gtpc->get_s11();
 
-  while (m_running) {
-    pdu->clear();
-    int max_fd = std::max(s1mme, s11);
-
-    FD_ZERO(&m_set);
-    FD_SET(s1mme, &m_set);
-    FD_SET(s11, &m_set);
-
-    // Add timers to select
-    for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
-      FD_SET(it->fd, &m_set);
-      max_fd = std::max(max_fd, it->fd);
-      m_s1ap_log->debug("Adding Timer fd %d to fd_set\n", it->fd);
-    }
+  const int          max_events = 64;
+  struct epoll_event events[max_events];
 
+  while (m_running) {
     m_s1ap_log->debug("Waiting for S1-MME or S11 Message\n");
-    int n = select(max_fd + 1, &m_set, NULL, NULL, NULL);
+    int n = epoll_wait(m_epoll_fd, events, max_events, -1);
     if (n == -1) {
-      m_s1ap_log->error("Error from select\n");
-    } else if (n) {
-      // Handle S1-MME
-      if (FD_ISSET(s1mme, &m_set)) {
+      if (errno != EINTR) {
+        m_s1ap_log->error("Error from epoll_wait: %s\n", strerror(errno));
+      }
+      continue;
+    }
+    for (int i = 0; i < n; i++) {
+      int fd = events[i].data.fd;
+      pdu->clear();
+      if (fd == s1mme) {
+        // Handle S1-MME
         rd_sz = sctp_recvmsg(s1mme, pdu->msg, sz, (struct sockaddr*)&enb_addr, &fromlen, &sri, &msg_flags);
         if (rd_sz == -1 && errno != EAGAIN) {
           m_s1ap_log->error("Error reading from SCTP socket: %s", strerror(errno));
@@ -167,32 +199,126 @@ void mme::run_thread()
             m_s1ap->handle_s1ap_rx_pdu(pdu, &sri);
           }
         }
-      }
-      // Handle S11
-      if (FD_ISSET(s11, &m_set)) {
+      } else if (fd == s11) {
+        // Handle S11
         pdu->N_bytes = recvfrom(s11, pdu->msg, SRSLTE_MAX_BUFFER_SIZE_BYTES, 0, NULL, NULL);
         m_mme_gtpc->handle_s11_pdu(pdu);
+      } else if (fd == m_nas_done_fd) {
+        // Handle the procedures resumed by the NAS workers
+        handle_nas_tasks_done();
+      } else {
+        // Handle NAS Timers
+        handle_timer_expire(fd);
       }
-      // Handle NAS Timers
-      for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
-        if (FD_ISSET(it->fd, &m_set)) {
-          m_s1ap_log->info("Timer expired\n");
-          uint64_t exp;
-          rd_sz = read(it->fd, &exp, sizeof(uint64_t));
-          m_s1ap->expire_nas_timer(it->type, it->imsi);
-          close(it->fd);
-          timers.erase(it);
-        } else {
-          ++it;
-        }
-      }
-    } else {
-      m_s1ap_log->debug("No data from select.\n");
     }
   }
   return;
 }
 
+void mme::get_metrics(mme_metrics_t* metrics)
+{
+  metrics->nof_attach_requests   = m_s1ap->m_s1ap_nas_transport->get_nof_attach_requests();
+  metrics->nof_attach_completes  = m_s1ap->m_s1ap_nas_transport->get_nof_attach_completes();
+  metrics->nof_nas_tasks_pending = 0;
+  for (std::unique_ptr<nas_worker>& w : m_nas_workers) {
+    metrics->nof_nas_tasks_pending += w->nof_pending_tasks();
+  }
+  m_av_cache.get_metrics(&metrics->av_cache);
+}
+
+/*
+ * NAS workers
+ */
+int mme::init_nas_workers(uint32_t nof_workers)
+{
+  if (nof_workers == 0) {
+    return 0;
+  }
+  m_nas_done_fd = eventfd(0, EFD_NONBLOCK);
+  if (m_nas_done_fd == -1) {
+    m_s1ap_log->error("Error creating NAS workers eventfd: %s\n", strerror(errno));
+    return -1;
+  }
+  if (m_epoll_fd != -1) {
+    struct epoll_event ev = {};
+    ev.events             = EPOLLIN;
+    ev.data.fd            = m_nas_done_fd;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_nas_done_fd, &ev) == -1) {
+      m_s1ap_log->error("Error adding NAS workers eventfd to epoll: %s\n", strerror(errno));
+      return -1;
+    }
+  }
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    std::unique_ptr<nas_worker> w(new nas_worker());
+    w->start();
+    m_nas_workers.push_back(std::move(w));
+  }
+  return 0;
+}
+
+void mme::stop_nas_workers()
+{
+  // The workers finish the queued tasks, whose completions are then run by the calling thread
+  for (std::unique_ptr<nas_worker>& w : m_nas_workers) {
+    w->stop();
+  }
+  m_nas_workers.clear();
+  std::function<void()> done;
+  while (m_nas_done.try_pop(&done)) {
+    done();
+  }
+  if (m_nas_done_fd != -1) {
+    close(m_nas_done_fd);
+    m_nas_done_fd = -1;
+  }
+}
+
+/*
+ * Runs the task in the worker of the key, and then the done callback in the MME thread.
+ * Tasks with the same key run in the order they were pushed.
+ */
+void mme::push_nas_task(uint64_t key, const std::function<void()>& task, const std::function<void()>& done)
+{
+  m_nas_workers[key % m_nas_workers.size()]->push_task([this, task, done]() {
+    task();
+    m_nas_done.push(done);
+    uint64_t one = 1;
+    if (write(m_nas_done_fd, &one, sizeof(one)) == -1) {
+      m_s1ap_log->error("Error writing NAS workers eventfd: %s\n", strerror(errno));
+    }
+  });
+}
+
+void mme::handle_nas_tasks_done()
+{
+  uint64_t count;
+  if (read(m_nas_done_fd, &count, sizeof(count)) == -1 && errno != EAGAIN) {
+    m_s1ap_log->error("Error reading NAS workers eventfd: %s\n", strerror(errno));
+  }
+  std::function<void()> done;
+  while (m_nas_done.try_pop(&done)) {
+    done();
+  }
+}
+
+void mme::nas_worker::stop()
+{
+  // An empty task makes the worker exit once the queued ones are done
+  tasks.push(std::function<void()>());
+  wait_thread_finish();
+}
+
+void mme::nas_worker::run_thread()
+{
+  while (true) {
+    std::function<void()> task = tasks.wait_pop();
+    if (!task) {
+      break;
+    }
+    task();
+  }
+}
+
 /*
  * Timer Handling
  */
@@ -200,20 +326,28 @@ bool mme::add_nas_timer(int timer_fd, nas_timer_type type, uint64_t imsi)
 {
   m_s1ap_log->debug("Adding NAS timer to MME. IMSI %" PRIu64 ", Type %d, Fd: %d\n", imsi, type, timer_fd);
 
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  ev.data.fd            = timer_fd;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) == -1) {
+    m_s1ap_log->error("Error adding NAS timer fd %d to epoll: %s\n", timer_fd, strerror(errno));
+    return false;
+  }
+
   mme_timer_t timer;
   timer.fd   = timer_fd;
   timer.type = type;
   timer.imsi = imsi;
 
-  timers.push_back(timer);
+  timers[timer_fd] = timer;
   return true;
 }
 
 bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 {
-  std::vector<mme_timer_t>::iterator it;
+  std::map<int, mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
-    if (it->type == type && it->imsi == imsi) {
+    if (it->second.type == type && it->second.imsi == imsi) {
       return true; // found timer
     }
   }
@@ -222,9 +356,9 @@ bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 
 bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 {
-  std::vector<mme_timer_t>::iterator it;
+  std::map<int, mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
-    if (it->type == type && it->imsi == imsi) {
+    if (it->second.type == type && it->second.imsi == imsi) {
       break; // found timer to remove
     }
   }
@@ -234,11 +368,32 @@ bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
   }
 
   // removing timer
-  m_s1ap_log->debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d\n", imsi, type, it->fd);
-  FD_CLR(it->fd, &m_set);
-  close(it->fd);
+  m_s1ap_log->debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d\n", imsi, type, it->first);
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, it->first, NULL);
+  close(it->first);
   timers.erase(it);
   return true;
 }
 
+void mme::handle_timer_expire(int timer_fd)
+{
+  // The timer may have been removed by an event handled earlier in the same epoll_wait() batch
+  std::map<int, mme_timer_t>::iterator it = timers.find(timer_fd);
+  if (it == timers.end()) {
+    return;
+  }
+
+  uint64_t exp;
+  if (read(timer_fd, &exp, sizeof(uint64_t)) == -1) {
+    // A new timer reusing the fd of a removed one, which has not expired yet
+    return;
+  }
+  m_s1ap_log->info("Timer expired\n");
+  mme_timer_t timer = it->second;
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, timer_fd, NULL);
+  close(timer_fd);
+  timers.erase(it);
+  m_s1ap->expire_nas_timer(timer.type, timer.imsi);
+}
+
 } // namespace srsepc
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/mme/mme_av_cache.h"
+#include <algorithm>
+#include <inttypes.h> // for printing uint64_t
+#include <string.h>
+
+namespace srsepc {
+
+void mme_av_cache::init(hss_interface_nas* hss, uint32_t batch_size, srslte::log* nas_log)
+{
+  m_hss        = hss;
+  m_nas_log    = nas_log;
+  m_batch_size = std::max(1u, std::min(batch_size, MAX_BATCH_SIZE));
+}
+
+bool mme_av_cache::prefetch(uint64_t imsi)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_vectors.count(imsi) > 0 || m_nof_vectors + m_batch_size > MAX_CACHED_VECTORS) {
+      return false;
+    }
+  }
+
+  hss_auth_vector_t avs[MAX_BATCH_SIZE];
+  if (!fetch_batch(imsi, avs)) {
+    return false;
+  }
+  return store_batch(imsi, avs, m_batch_size);
+}
+
+bool mme_av_cache::fetch_batch(uint64_t imsi, hss_auth_vector_t* avs)
+{
+  for (uint32_t i = 0; i < m_batch_size; i++) {
+    avs[i].imsi = imsi;
+  }
+  m_hss->gen_auth_info_answer_multi(avs, m_batch_size);
+  return avs[0].valid;
+}
+
+bool mme_av_cache::store_batch(uint64_t imsi, const hss_auth_vector_t* avs, uint32_t nof_avs)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_nof_vectors + nof_avs > MAX_CACHED_VECTORS) {
+    return false;
+  }
+  // Vectors fetched concurrently for the same IMSI are dropped, as mixing the batches would break the SQN order
+  if (!m_vectors.insert(std::make_pair(imsi, std::deque<hss_auth_vector_t>(avs, avs + nof_avs))).second) {
+    return false;
+  }
+  m_nof_vectors += nof_avs;
+  m_metrics.nof_prefetched += nof_avs;
+  m_nas_log->debug("Prefetched %d authentication vectors. IMSI: %015" PRIu64 "\n", nof_avs, imsi);
+  return true;
+}
+
+void mme_av_cache::get_metrics(mme_av_cache_metrics_t* metrics)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  *metrics = m_metrics;
+}
+
+bool mme_av_cache::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<uint64_t, std::deque<hss_auth_vector_t> >::iterator it = m_vectors.find(imsi);
+    if (it != m_vectors.end()) {
+      const hss_auth_vector_t& av = it->second.front();
+      memcpy(k_asme, av.k_asme, sizeof(av.k_asme));
+      memcpy(autn, av.autn, sizeof(av.autn));
+      memcpy(rand, av.rand, sizeof(av.rand));
+      memcpy(xres, av.xres, sizeof(av.xres));
+      it->second.pop_front();
+      if (it->second.empty()) {
+        m_vectors.erase(it);
+      }
+      m_nof_vectors--;
+      m_metrics.nof_hits++;
+      return true;
+    }
+    m_metrics.nof_misses++;
+  }
+
+  // Nothing prefetched, fetch the vector now together with the spare ones of the batch
+  hss_auth_vector_t avs[MAX_BATCH_SIZE];
+  if (!fetch_batch(imsi, avs)) {
+    return false;
+  }
+  memcpy(k_asme, avs[0].k_asme, sizeof(avs[0].k_asme));
+  memcpy(autn, avs[0].autn, sizeof(avs[0].autn));
+  memcpy(rand, avs[0].rand, sizeof(avs[0].rand));
+  memcpy(xres, avs[0].xres, sizeof(avs[0].xres));
+  if (m_batch_size > 1) {
+    store_batch(imsi, &avs[1], m_batch_size - 1);
+  }
+  return true;
+}
+
+void mme_av_cache::gen_auth_info_answer_multi(hss_auth_vector_t* vectors, uint32_t nof_vectors)
+{
+  m_hss->gen_auth_info_answer_multi(vectors, nof_vectors);
+}
+
+bool mme_av_cache::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
+{
+  return m_hss->gen_update_loc_answer(imsi, qci);
+}
+
+bool mme_av_cache::resync_sqn(uint64_t imsi, uint8_t* rand, uint8_t* auts)
+{
+  // The cached vectors carry SQNs the UE is going to reject as well
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<uint64_t, std::deque<hss_auth_vector_t> >::iterator it = m_vectors.find(imsi);
+    if (it != m_vectors.end()) {
+      m_nof_vectors -= it->second.size();
+      m_vectors.erase(it);
+    }
+  }
+  return m_hss->resync_sqn(imsi, rand, auts);
+}
+
+} // namespace srsepc
@@ -1194,7 +1194,7 @@ bool nas::handle_authentication_failure(srslte::byte_buffer_t* nas_rx)
         m_nas_log->error("Missing fail parameter\n");
         return false;
       }
-      if (!m_hss->resync_sqn(m_emm_ctx.imsi, auth_fail.auth_fail_param)) {
+      if (!m_hss->resync_sqn(m_emm_ctx.imsi, m_sec_ctx.rand, auth_fail.auth_fail_param)) {
         m_nas_log->console("Resynchronization failed. IMSI %015" PRIu64 "\n", m_emm_ctx.imsi);
         m_nas_log->info("Resynchronization failed. IMSI %015" PRIu64 "\n", m_emm_ctx.imsi);
         return false;
@@ -1902,7 +1902,7 @@ bool nas::start_t3413()
     return false;
   }
 
-  int fdt = timerfd_create(CLOCK_MONOTONIC, 0);
+  int fdt = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
   if (fdt < 0) {
     m_nas_log->error("Error creating timer. %s\n", strerror(errno));
     return false;
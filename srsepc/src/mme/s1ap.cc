@@ -230,12 +230,16 @@ void s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo
     m_pcap.write_s1ap(pdu->msg, pdu->N_bytes);
   }
 
-  // Get PDU type
+  // Get PDU type. Only the unpack is bound to the arena, copies made by the handlers go to the heap
+  m_rx_arena.reset();
   s1ap_pdu_t     rx_pdu;
   asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
-  if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
-    m_s1ap_log->error("Failed to unpack received PDU\n");
-    return;
+  {
+    asn1::arena_scope scope(m_rx_arena);
+    if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+      m_s1ap_log->error("Failed to unpack received PDU\n");
+      return;
+    }
   }
 
   switch (rx_pdu.type().value) {
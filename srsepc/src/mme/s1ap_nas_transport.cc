@@ -84,35 +84,58 @@ void s1ap_nas_transport::init()
   // Init NAS interface
   m_nas_if.s1ap = s1ap::get_instance();
   m_nas_if.gtpc = mme_gtpc::get_instance();
-  m_nas_if.hss  = hss::get_instance();
+  m_nas_if.hss  = mme::get_instance()->get_av_cache();
   m_nas_if.mme  = mme::get_instance();
+
+  m_mme = mme::get_instance();
 }
 
 bool s1ap_nas_transport::handle_initial_ue_message(const asn1::s1ap::init_ue_msg_s& init_ue,
                                                    struct sctp_sndrcvinfo*          enb_sri)
 {
-  bool                   err, mac_valid;
-  uint8_t                pd, msg_type, sec_hdr_type;
   srslte::byte_buffer_t* nas_msg = m_pool->allocate();
   memcpy(nas_msg->msg, init_ue.protocol_ies.nas_pdu.value.data(), init_ue.protocol_ies.nas_pdu.value.size());
   nas_msg->N_bytes = init_ue.protocol_ies.nas_pdu.value.size();
 
-  uint64_t imsi           = 0;
   uint32_t m_tmsi         = 0;
   uint32_t enb_ue_s1ap_id = init_ue.protocol_ies.enb_ue_s1ap_id.value.value;
+  if (init_ue.protocol_ies.s_tmsi_present) {
+    srslte::uint8_to_uint32(init_ue.protocol_ies.s_tmsi.value.m_tmsi.data(), &m_tmsi);
+  }
+
+  uint64_t imsi = 0;
+  if (m_mme->get_nof_nas_workers() == 0 || !get_attach_request_imsi(nas_msg, &imsi)) {
+    return handle_initial_ue_nas(enb_ue_s1ap_id, m_tmsi, nas_msg, enb_sri);
+  }
+
+  // The AVs of an Attach Request with IMSI are generated by a NAS worker, and the attach resumed in the MME thread.
+  // No other message can reach the UE meanwhile, as the MME has not yet given it a MME UE S1AP Id.
+  struct sctp_sndrcvinfo sri = *enb_sri;
+  m_mme->push_nas_task(imsi,
+                       [this, imsi]() { m_mme->get_av_cache()->prefetch(imsi); },
+                       [this, enb_ue_s1ap_id, m_tmsi, nas_msg, sri]() mutable {
+                         handle_initial_ue_nas(enb_ue_s1ap_id, m_tmsi, nas_msg, &sri);
+                       });
+  return true;
+}
+
+bool s1ap_nas_transport::handle_initial_ue_nas(uint32_t                enb_ue_s1ap_id,
+                                               uint32_t                m_tmsi,
+                                               srslte::byte_buffer_t*  nas_msg,
+                                               struct sctp_sndrcvinfo* enb_sri)
+{
+  bool    err;
+  uint8_t pd, msg_type;
   liblte_mme_parse_msg_header((LIBLTE_BYTE_MSG_STRUCT*)nas_msg, &pd, &msg_type);
 
   m_s1ap_log->console("Initial UE message: %s\n", liblte_nas_msg_type_to_string(msg_type));
   m_s1ap_log->info("Initial UE message: %s\n", liblte_nas_msg_type_to_string(msg_type));
 
-  if (init_ue.protocol_ies.s_tmsi_present) {
-    srslte::uint8_to_uint32(init_ue.protocol_ies.s_tmsi.value.m_tmsi.data(), &m_tmsi);
-  }
-
   switch (msg_type) {
     case LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST:
       m_s1ap_log->console("Received Initial UE message -- Attach Request\n");
       m_s1ap_log->info("Received Initial UE message -- Attach Request\n");
+      m_nof_attach_requests++;
       err = nas::handle_attach_request(enb_ue_s1ap_id, enb_sri, nas_msg, m_nas_init, m_nas_if, m_s1ap->m_nas_log);
       break;
     case LIBLTE_MME_SECURITY_HDR_TYPE_SERVICE_REQUEST:
@@ -142,19 +165,51 @@ bool s1ap_nas_transport::handle_initial_ue_message(const asn1::s1ap::init_ue_msg
   return err;
 }
 
+bool s1ap_nas_transport::get_attach_request_imsi(srslte::byte_buffer_t* nas_msg, uint64_t* imsi)
+{
+  uint8_t pd, msg_type;
+  liblte_mme_parse_msg_header((LIBLTE_BYTE_MSG_STRUCT*)nas_msg, &pd, &msg_type);
+  if (msg_type != LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST) {
+    return false;
+  }
+
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req;
+  if (liblte_mme_unpack_attach_request_msg((LIBLTE_BYTE_MSG_STRUCT*)nas_msg, &attach_req) != LIBLTE_SUCCESS ||
+      attach_req.eps_mobile_id.type_of_id != LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI) {
+    return false;
+  }
+  *imsi = 0;
+  for (int i = 0; i <= 14; i++) {
+    *imsi += attach_req.eps_mobile_id.imsi[i] * std::pow(10, 14 - i);
+  }
+  return true;
+}
+
 bool s1ap_nas_transport::handle_uplink_nas_transport(const asn1::s1ap::ul_nas_transport_s& ul_xport,
                                                      struct sctp_sndrcvinfo*               enb_sri)
 {
-  uint8_t  pd, msg_type, sec_hdr_type;
-  uint32_t enb_ue_s1ap_id      = ul_xport.protocol_ies.enb_ue_s1ap_id.value.value;
-  uint32_t mme_ue_s1ap_id      = ul_xport.protocol_ies.mme_ue_s1ap_id.value.value;
-  bool     mac_valid           = false;
-  bool     increase_ul_nas_cnt = true;
+  uint32_t               enb_ue_s1ap_id = ul_xport.protocol_ies.enb_ue_s1ap_id.value.value;
+  uint32_t               mme_ue_s1ap_id = ul_xport.protocol_ies.mme_ue_s1ap_id.value.value;
+  srslte::byte_buffer_t* nas_msg        = m_pool->allocate();
+  memcpy(nas_msg->msg, ul_xport.protocol_ies.nas_pdu.value.data(), ul_xport.protocol_ies.nas_pdu.value.size());
+  nas_msg->N_bytes = ul_xport.protocol_ies.nas_pdu.value.size();
+
+  return handle_uplink_nas(enb_ue_s1ap_id, mme_ue_s1ap_id, nas_msg);
+}
+
+bool s1ap_nas_transport::handle_uplink_nas(uint32_t               enb_ue_s1ap_id,
+                                           uint32_t               mme_ue_s1ap_id,
+                                           srslte::byte_buffer_t* nas_msg)
+{
+  uint8_t pd, msg_type, sec_hdr_type;
+  bool    mac_valid           = false;
+  bool    increase_ul_nas_cnt = true;
 
   // Get UE NAS context
   nas* nas_ctx = m_s1ap->find_nas_ctx_from_mme_ue_s1ap_id(mme_ue_s1ap_id);
   if (nas_ctx == nullptr) {
     m_s1ap_log->warning("Received uplink NAS, but could not find UE NAS context. MME-UE S1AP id: %d\n", mme_ue_s1ap_id);
+    m_pool->deallocate(nas_msg);
     return false;
   }
 
@@ -163,10 +218,6 @@ bool s1ap_nas_transport::handle_uplink_nas_transport(const asn1::s1ap::ul_nas_tr
   ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
   sec_ctx_t* sec_ctx = &nas_ctx->m_sec_ctx;
 
-  // Parse NAS message header
-  srslte::byte_buffer_t* nas_msg = m_pool->allocate();
-  memcpy(nas_msg->msg, ul_xport.protocol_ies.nas_pdu.value.data(), ul_xport.protocol_ies.nas_pdu.value.size());
-  nas_msg->N_bytes   = ul_xport.protocol_ies.nas_pdu.value.size();
   bool msg_encrypted = false;
 
   // Parse the message security header
@@ -294,6 +345,7 @@ bool s1ap_nas_transport::handle_uplink_nas_transport(const asn1::s1ap::ul_nas_tr
       m_s1ap_log->info("UL NAS: Received Attach Complete\n");
       m_s1ap_log->console("UL NAS: Received Attach Complete\n");
       if (sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED && mac_valid == true) {
+        m_nof_attach_completes++;
         nas_ctx->handle_attach_complete(nas_msg);
       } else {
         // Attach Complete was not integrity protected
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/mme/mme.h"
+#include "srslte/common/test_common.h"
+#include <atomic>
+
+using namespace srsepc;
+
+const int32_t  enb_assoc_id = 10;
+const uint32_t nof_ues      = 8;
+
+srslte::log_filter s1ap_log("S1AP");
+srslte::log_filter nas_log("NAS");
+
+struct sctp_sndrcvinfo make_enb_sri()
+{
+  struct sctp_sndrcvinfo sri = {};
+  sri.sinfo_assoc_id         = enb_assoc_id;
+  return sri;
+}
+
+// Feeds a S1AP PDU to the MME, as the MME thread does when it reads it from the S1-MME socket
+void rx_s1ap_pdu(s1ap* s1ap_ptr, const asn1::s1ap::s1ap_pdu_c& pdu)
+{
+  srslte::byte_buffer_t  buf;
+  struct sctp_sndrcvinfo sri = make_enb_sri();
+  asn1::bit_ref          bref(buf.msg, SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET);
+  pdu.pack(bref);
+  buf.N_bytes = bref.distance_bytes();
+  s1ap_ptr->handle_s1ap_rx_pdu(&buf, &sri);
+}
+
+void rx_ul_nas_transport(s1ap* s1ap_ptr, uint32_t enb_ue_s1ap_id, uint32_t mme_ue_s1ap_id)
+{
+  asn1::s1ap::s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UL_NAS_TRANSPORT);
+  auto& ies                      = pdu.init_msg().value.ul_nas_transport().protocol_ies;
+  ies.enb_ue_s1ap_id.value.value = enb_ue_s1ap_id;
+  ies.mme_ue_s1ap_id.value.value = mme_ue_s1ap_id;
+  // Plain Tracking Area Update Request, answered with a TAU Reject
+  ies.nas_pdu.value.resize(2);
+  ies.nas_pdu.value[0] = 0x07;
+  ies.nas_pdu.value[1] = 0x48;
+  rx_s1ap_pdu(s1ap_ptr, pdu);
+}
+
+void rx_ue_context_release_request(s1ap* s1ap_ptr, uint32_t enb_ue_s1ap_id, uint32_t mme_ue_s1ap_id)
+{
+  asn1::s1ap::s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE_REQUEST);
+  auto& ies                                 = pdu.init_msg().value.ue_context_release_request().protocol_ies;
+  ies.enb_ue_s1ap_id.value.value            = enb_ue_s1ap_id;
+  ies.mme_ue_s1ap_id.value.value            = mme_ue_s1ap_id;
+  ies.cause.value.set_radio_network().value = asn1::s1ap::cause_radio_network_opts::user_inactivity;
+  rx_s1ap_pdu(s1ap_ptr, pdu);
+}
+
+void rx_ue_context_release_complete(s1ap* s1ap_ptr, uint32_t enb_ue_s1ap_id, uint32_t mme_ue_s1ap_id)
+{
+  asn1::s1ap::s1ap_pdu_c pdu;
+  pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE);
+  auto& ies                      = pdu.successful_outcome().value.ue_context_release_complete().protocol_ies;
+  ies.enb_ue_s1ap_id.value.value = enb_ue_s1ap_id;
+  ies.mme_ue_s1ap_id.value.value = mme_ue_s1ap_id;
+  rx_s1ap_pdu(s1ap_ptr, pdu);
+}
+
+/*
+ * UL NAS transports and UE context releases of several UEs, interleaved, with the NAS workers enabled. Each message
+ * must see the UE context left by the previous ones: the UL NAS before the release are handled, the one after the
+ * release complete finds no context.
+ */
+int test_nas_ordering(s1ap* s1ap_ptr)
+{
+  struct sctp_sndrcvinfo sri     = make_enb_sri();
+  enb_ctx_t              enb_ctx = {};
+  enb_ctx.enb_id                 = 1;
+  s1ap_ptr->add_new_enb_ctx(enb_ctx, &sri);
+
+  nas_init_t nas_init = {};
+  nas_if_t   nas_if   = {};
+  nas_if.s1ap         = s1ap_ptr;
+  nas_if.mme          = mme::get_instance();
+  std::vector<nas*> ues;
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    nas* nas_ctx = new nas(nas_init, nas_if, &nas_log);
+    nas_ctx->reset();
+    nas_ctx->m_emm_ctx.imsi           = 1010123456789 + i;
+    nas_ctx->m_emm_ctx.state          = EMM_STATE_REGISTERED;
+    nas_ctx->m_ecm_ctx.state          = ECM_STATE_IDLE;
+    nas_ctx->m_ecm_ctx.enb_ue_s1ap_id = 100 + i;
+    nas_ctx->m_ecm_ctx.mme_ue_s1ap_id = s1ap_ptr->get_next_mme_ue_s1ap_id();
+    nas_ctx->m_ecm_ctx.enb_sri        = sri;
+    nas_ctx->m_sec_ctx.ul_nas_count   = 0;
+    nas_ctx->m_sec_ctx.dl_nas_count   = 0;
+    TESTASSERT(s1ap_ptr->add_nas_ctx_to_imsi_map(nas_ctx));
+    TESTASSERT(s1ap_ptr->add_nas_ctx_to_mme_ue_s1ap_id_map(nas_ctx));
+    TESTASSERT(s1ap_ptr->add_ue_to_enb_set(enb_assoc_id, nas_ctx->m_ecm_ctx.mme_ue_s1ap_id));
+    ues.push_back(nas_ctx);
+  }
+
+  std::vector<uint32_t> enb_ids, mme_ids;
+  for (nas* nas_ctx : ues) {
+    enb_ids.push_back(nas_ctx->m_ecm_ctx.enb_ue_s1ap_id);
+    mme_ids.push_back(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    rx_ul_nas_transport(s1ap_ptr, enb_ids[i], mme_ids[i]);
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    rx_ue_context_release_request(s1ap_ptr, enb_ids[i], mme_ids[i]);
+    rx_ul_nas_transport(s1ap_ptr, enb_ids[i], mme_ids[i]);
+  }
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    rx_ue_context_release_complete(s1ap_ptr, enb_ids[i], mme_ids[i]);
+    rx_ul_nas_transport(s1ap_ptr, enb_ids[i], mme_ids[i]);
+  }
+
+  for (uint32_t i = 0; i < nof_ues; ++i) {
+    TESTASSERT(ues[i]->m_sec_ctx.ul_nas_count == 2);
+    TESTASSERT(ues[i]->m_ecm_ctx.state == ECM_STATE_IDLE);
+    TESTASSERT(ues[i]->m_ecm_ctx.mme_ue_s1ap_id == 0);
+    TESTASSERT(s1ap_ptr->find_nas_ctx_from_mme_ue_s1ap_id(mme_ids[i]) == nullptr);
+    TESTASSERT(s1ap_ptr->find_nas_ctx_from_imsi(1010123456789 + i) == ues[i]);
+  }
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Stopping the MME with NAS tasks still queued: every task and its completion runs before the workers are gone
+ */
+int test_stop_with_pending_tasks(mme* mme_ptr)
+{
+  const uint32_t        nof_tasks = 1000;
+  std::atomic<uint32_t> nof_run{0};
+  uint32_t              nof_done = 0;
+  for (uint32_t i = 0; i < nof_tasks; ++i) {
+    mme_ptr->push_nas_task(i, [&nof_run]() { nof_run++; }, [&nof_done]() { nof_done++; });
+  }
+  mme_ptr->stop();
+  TESTASSERT(nof_run == nof_tasks);
+  TESTASSERT(nof_done == nof_tasks);
+  TESTASSERT(mme_ptr->get_nof_nas_workers() == 0);
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  s1ap_log.set_level(srslte::LOG_LEVEL_WARNING);
+  nas_log.set_level(srslte::LOG_LEVEL_WARNING);
+
+  mme* mme_ptr = mme::get_instance();
+  TESTASSERT(mme_ptr->init_nas_workers(2) == 0);
+  TESTASSERT(mme_ptr->get_nof_nas_workers() == 2);
+
+  // Without an epoll loop, the S1AP messages are fed directly. The S1-MME socket may not open in the test environment
+  s1ap_args_t s1ap_args   = {};
+  s1ap_args.mcc           = 0xf001;
+  s1ap_args.mnc           = 0xff01;
+  s1ap_args.mme_bind_addr = "127.0.0.1";
+  s1ap* s1ap_ptr          = s1ap::get_instance();
+  TESTASSERT(s1ap_ptr->init(s1ap_args, &nas_log, &s1ap_log) == 0);
+
+  TESTASSERT(test_nas_ordering(s1ap_ptr) == SRSLTE_SUCCESS);
+  TESTASSERT(test_stop_with_pending_tasks(mme_ptr) == SRSLTE_SUCCESS);
+
+  s1ap_ptr->stop();
+  s1ap::cleanup();
+  mme::cleanup();
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
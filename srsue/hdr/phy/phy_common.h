@@ -25,6 +25,7 @@
 #include "phy_metrics.h"
 #include "srslte/common/gen_mch_tables.h"
 #include "srslte/common/log.h"
+#include "srslte/common/tti_deadline_tracker.h"
 #include "srslte/common/tti_sempahore.h"
 #include "srslte/interfaces/radio_interfaces.h"
 #include "srslte/interfaces/ue_interfaces.h"
@@ -89,6 +90,9 @@ public:
 
   srslte::tti_semaphore<void*> semaphore;
 
+  // Real-time deadline tracker, lock-free, timestamped by the sync thread and the workers
+  srslte::tti_deadline_tracker rt_tracker{std::chrono::milliseconds{FDD_HARQ_DELAY_DL_MS - 1}};
+
   // Time Aligment Controller, internal thread safe
   ta_control ta;
 
@@ -138,8 +142,12 @@ public:
                           srslte_pdsch_ack_resource_t resource);
   bool get_dl_pending_ack(srslte_ul_sf_cfg_t* sf, uint32_t cc_idx, srslte_pdsch_ack_cc_t* ack);
 
-  void
-  worker_end(void* h, bool tx_enable, srslte::rf_buffer_t& buffer, uint32_t nof_samples, srslte_timestamp_t tx_time);
+  void worker_end(void*                h,
+                  uint32_t             tti,
+                  bool                 tx_enable,
+                  srslte::rf_buffer_t& buffer,
+                  uint32_t             nof_samples,
+                  srslte_timestamp_t   tx_time);
 
   void set_cell(const srslte_cell_t& c);
   void set_nof_workers(uint32_t nof_workers);
@@ -22,6 +22,7 @@
 #ifndef SRSUE_PHY_METRICS_H
 #define SRSUE_PHY_METRICS_H
 
+#include "srslte/common/tti_deadline_tracker.h"
 #include "srslte/srslte.h"
 
 namespace srsue {
@@ -56,11 +57,12 @@ struct ul_metrics_t {
 };
 
 struct phy_metrics_t {
-  info_metrics_t info[SRSLTE_MAX_CARRIERS];
-  sync_metrics_t sync[SRSLTE_MAX_CARRIERS];
-  dl_metrics_t   dl[SRSLTE_MAX_CARRIERS];
-  ul_metrics_t   ul[SRSLTE_MAX_CARRIERS];
-  uint32_t       nof_active_cc;
+  info_metrics_t       info[SRSLTE_MAX_CARRIERS];
+  sync_metrics_t       sync[SRSLTE_MAX_CARRIERS];
+  dl_metrics_t         dl[SRSLTE_MAX_CARRIERS];
+  ul_metrics_t         ul[SRSLTE_MAX_CARRIERS];
+  srslte::rt_metrics_t rt;
+  uint32_t             nof_active_cc;
 };
 
 } // namespace srsue
@@ -85,6 +85,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("rf.device_args", bpo::value<string>(&args->rf.device_args)->default_value("auto"), "Front-end device arguments")
     ("rf.time_adv_nsamples", bpo::value<string>(&args->rf.time_adv_nsamples)->default_value("auto"), "Transmission time advance")
     ("rf.continuous_tx", bpo::value<string>(&args->rf.continuous_tx)->default_value("auto"), "Transmit samples continuously to the radio or on bursts (auto/yes/no). Default is auto (yes for UHD, no for rest)")
+    ("rf.srate", bpo::value<float>(&args->rf.srate_hz)->default_value(0), "Front-end sampling rate, scaled by powers of two and resampled to the cell rate (0 disables)")
 
     ("rf.bands.rx[0].min", bpo::value<float>(&args->rf.ch_rx_bands[0].min)->default_value(0), "Lower frequency boundary for CH0-RX")
     ("rf.bands.rx[0].max", bpo::value<float>(&args->rf.ch_rx_bands[0].max)->default_value(0), "Higher frequency boundary for CH0-RX")
@@ -191,6 +192,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("channel.dl.hst.period_s", bpo::value<float>(&args->phy.dl_channel_args.hst_period_s)->default_value(7.2f), "HST simulation period in seconds")
     ("channel.dl.hst.fd_hz", bpo::value<float>(&args->phy.dl_channel_args.hst_fd_hz)->default_value(+750.0f), "Doppler frequency in Hz")
     ("channel.dl.hst.init_time_s", bpo::value<float>(&args->phy.dl_channel_args.hst_init_time_s)->default_value(0), "Initial time in seconds")
+    ("channel.dl.nof_workers", bpo::value<uint32_t>(&args->phy.dl_channel_args.nof_workers)->default_value(0), "Threads emulating the RF channels in parallel, 0 emulates them serially")
 
     /* Uplink Channel emulator section */
     ("channel.ul.enable", bpo::value<bool>(&args->phy.ul_channel_args.enable)->default_value(false), "Enable/Disable internal Uplink channel emulator")
@@ -210,6 +212,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("channel.ul.hst.period_s", bpo::value<float>(&args->phy.ul_channel_args.hst_period_s)->default_value(7.2f), "HST simulation period in seconds")
     ("channel.ul.hst.fd_hz", bpo::value<float>(&args->phy.ul_channel_args.hst_fd_hz)->default_value(-750.0f), "Doppler frequency in Hz")
     ("channel.ul.hst.init_time_s", bpo::value<float>(&args->phy.ul_channel_args.hst_init_time_s)->default_value(0), "Initial time in seconds")
+    ("channel.ul.nof_workers", bpo::value<uint32_t>(&args->phy.ul_channel_args.nof_workers)->default_value(0), "Threads emulating the RF channels in parallel, 0 emulates them serially")
 
     /* PHY section */
     ("phy.worker_cpu_mask",
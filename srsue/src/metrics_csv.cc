@@ -85,7 +85,7 @@ void metrics_csv::set_metrics(const ue_metrics_t& metrics, const uint32_t period
       file << "time;cc;pci;earfcn;rsrp;pl;cfo;dl_mcs;dl_snr;dl_turbo;dl_brate;dl_bler;ul_ta;ul_mcs;ul_buff;ul_brate;ul_"
               "bler;"
               "rf_o;rf_"
-              "u;rf_l;is_attached\n";
+              "u;rf_l;is_attached;proc_p50;proc_p99;tx_p50;tx_p99;tx_max;nof_late\n";
     }
 
     for (uint32_t r = 0; r < metrics.phy.nof_active_cc; r++) {
@@ -140,7 +140,15 @@ void metrics_csv::set_metrics(const ue_metrics_t& metrics, const uint32_t period
       file << float_to_string(metrics.rf.rf_o, 2);
       file << float_to_string(metrics.rf.rf_u, 2);
       file << float_to_string(metrics.rf.rf_l, 2);
-      file << (metrics.stack.rrc.state == RRC_STATE_CONNECTED ? "1.0" : "0.0");
+      file << (metrics.stack.rrc.state == RRC_STATE_CONNECTED ? "1.0;" : "0.0;");
+
+      // PHY real-time processing latencies (usec), common to all CCs
+      file << float_to_string(metrics.phy.rt.proc.p50_us, 2);
+      file << float_to_string(metrics.phy.rt.proc.p99_us, 2);
+      file << float_to_string(metrics.phy.rt.tx.p50_us, 2);
+      file << float_to_string(metrics.phy.rt.tx.p99_us, 2);
+      file << float_to_string(metrics.phy.rt.tx.max_us, 2);
+      file << metrics.phy.rt.nof_late;
       file << "\n";
     }
 
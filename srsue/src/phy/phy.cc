@@ -250,6 +250,7 @@ void phy::get_metrics(phy_metrics_t* m)
   common.get_dl_metrics(m->dl);
   common.get_ul_metrics(m->ul);
   common.get_sync_metrics(m->sync);
+  common.rt_tracker.get_metrics(&m->rt);
   m->nof_active_cc = args.nof_carriers;
 }
 
@@ -525,14 +525,19 @@ bool phy_common::get_dl_pending_ack(srslte_ul_sf_cfg_t* sf, uint32_t cc_idx, srs
  * there is no transmission at all (tx_enable). In that case, the end of burst message will be sent to the radio
  */
 void phy_common::worker_end(void*                tx_sem_id,
+                            uint32_t             tti,
                             bool                 tx_enable,
                             srslte::rf_buffer_t& buffer,
                             uint32_t             nof_samples,
                             srslte_timestamp_t   tx_time)
 {
+  rt_tracker.worker_end(tti);
+
   // Wait for the green light to transmit in the current TTI
   semaphore.wait(tx_sem_id);
 
+  rt_tracker.tx_handoff(tti);
+
   // Add Time Alignment
   srslte_timestamp_sub(&tx_time, 0, ta.get_sec());
 
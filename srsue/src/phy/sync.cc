@@ -501,6 +501,7 @@ void sync::run_thread()
                 worker_com->avg_cfo_hz[cc] = srslte_ue_sync_get_cfo(&ue_sync);
               }
 
+              worker_com->rt_tracker.rx_done(tti);
               worker->set_tti(tti);
               worker->set_tx_time(tx_time);
 